@@ -0,0 +1,256 @@
+#include "BLEDeviceTable.h"
+#include <string.h>
+
+#define BLE_TABLE_FREE  0xFFFE   // newer link of a slot on the free list
+
+BLEDeviceTable::BLEDeviceTable() :
+    buckets(nullptr),
+    keys(nullptr),
+    newer(nullptr),
+    older(nullptr),
+    capacity(0),
+    bucketMask(0),
+    count(0),
+    newest(BLE_TABLE_NONE),
+    oldest(BLE_TABLE_NONE),
+    freeHead(BLE_TABLE_NONE)
+{
+    memset(&stats, 0, sizeof(stats));
+}
+
+BLEDeviceTable::~BLEDeviceTable() {
+    release();
+}
+
+bool BLEDeviceTable::begin(uint16_t slotCount) {
+    if (slotCount == 0 || slotCount > BLE_TABLE_MAX_SLOTS) return false;
+    release();
+
+    // At most half the buckets are ever used, which keeps probe runs short
+    uint32_t bucketCount = 1;
+    while (bucketCount < (uint32_t)slotCount * 2) bucketCount <<= 1;
+
+    buckets = new uint16_t[bucketCount];
+    keys = new uint64_t[slotCount];
+    newer = new uint16_t[slotCount];
+    older = new uint16_t[slotCount];
+    if (!buckets || !keys || !newer || !older) {
+        release();
+        return false;
+    }
+
+    capacity = slotCount;
+    bucketMask = (uint16_t)(bucketCount - 1);
+    clear();
+    return true;
+}
+
+void BLEDeviceTable::release() {
+    delete[] buckets;
+    delete[] keys;
+    delete[] newer;
+    delete[] older;
+    buckets = nullptr;
+    keys = nullptr;
+    newer = nullptr;
+    older = nullptr;
+    capacity = 0;
+    bucketMask = 0;
+    count = 0;
+    newest = oldest = freeHead = BLE_TABLE_NONE;
+}
+
+void BLEDeviceTable::clear() {
+    if (!keys) return;
+
+    memset(buckets, 0xFF, sizeof(uint16_t) * ((uint32_t)bucketMask + 1));
+    for (uint16_t slot = 0; slot < capacity; slot++) {
+        keys[slot] = 0;
+        newer[slot] = BLE_TABLE_FREE;
+        older[slot] = (slot + 1 < capacity) ? slot + 1 : BLE_TABLE_NONE;
+    }
+    freeHead = 0;
+    count = 0;
+    newest = oldest = BLE_TABLE_NONE;
+    memset(&stats, 0, sizeof(stats));
+}
+
+// ===== HASHING =====
+
+uint16_t BLEDeviceTable::home(uint64_t mac) const {
+    // Fold to 32 bits and mix; randomised MACs already vary in every
+    // octet, vendor MACs share their top three
+    uint32_t h = (uint32_t)mac ^ ((uint32_t)(mac >> 32) * 0x85EBCA6Bu);
+    h ^= h >> 16;
+    h *= 0x9E3779B1u;
+    return (uint16_t)((h >> 16) & bucketMask);
+}
+
+uint16_t BLEDeviceTable::findBucket(uint64_t mac) const {
+    uint16_t bucket = home(mac);
+    while (buckets[bucket] != BLE_TABLE_NONE) {
+        if (keys[buckets[bucket]] == mac) return bucket;
+        bucket = (bucket + 1) & bucketMask;
+    }
+    return BLE_TABLE_NONE;
+}
+
+uint16_t BLEDeviceTable::find(uint64_t mac) {
+    if (!keys) return BLE_TABLE_NONE;
+    stats.lookups++;
+
+    uint16_t bucket = home(mac);
+    while (true) {
+        stats.probes++;
+        uint16_t slot = buckets[bucket];
+        if (slot == BLE_TABLE_NONE) return BLE_TABLE_NONE;
+        if (keys[slot] == mac) return slot;
+        bucket = (bucket + 1) & bucketMask;
+    }
+}
+
+// Backward-shift deletion: later entries of the probe run move into the
+// hole unless their home lies cyclically after it
+void BLEDeviceTable::eraseBucket(uint16_t bucket) {
+    uint16_t hole = bucket;
+    uint16_t next = (bucket + 1) & bucketMask;
+    while (buckets[next] != BLE_TABLE_NONE) {
+        uint16_t want = home(keys[buckets[next]]);
+        bool stays = (next > hole) ? (want > hole && want <= next)
+                                   : (want > hole || want <= next);
+        if (!stays) {
+            buckets[hole] = buckets[next];
+            hole = next;
+        }
+        next = (next + 1) & bucketMask;
+    }
+    buckets[hole] = BLE_TABLE_NONE;
+}
+
+// ===== RECENCY LIST =====
+
+void BLEDeviceTable::unlink(uint16_t slot) {
+    if (newer[slot] != BLE_TABLE_NONE) {
+        older[newer[slot]] = older[slot];
+    } else {
+        newest = older[slot];
+    }
+    if (older[slot] != BLE_TABLE_NONE) {
+        newer[older[slot]] = newer[slot];
+    } else {
+        oldest = newer[slot];
+    }
+}
+
+void BLEDeviceTable::linkNewest(uint16_t slot) {
+    newer[slot] = BLE_TABLE_NONE;
+    older[slot] = newest;
+    if (newest != BLE_TABLE_NONE) {
+        newer[newest] = slot;
+    } else {
+        oldest = slot;
+    }
+    newest = slot;
+}
+
+// ===== UPDATES =====
+
+uint16_t BLEDeviceTable::insert(uint64_t mac, uint16_t* evicted) {
+    if (evicted) *evicted = BLE_TABLE_NONE;
+    if (!keys) return BLE_TABLE_NONE;
+
+    uint16_t slot;
+    if (freeHead != BLE_TABLE_NONE) {
+        slot = freeHead;
+        freeHead = older[slot];
+        count++;
+    } else {
+        // Full: the least recently seen device makes room
+        slot = oldest;
+        eraseBucket(findBucket(keys[slot]));
+        unlink(slot);
+        stats.evictions++;
+        if (evicted) *evicted = slot;
+    }
+
+    keys[slot] = mac;
+    linkNewest(slot);
+
+    uint16_t bucket = home(mac);
+    while (buckets[bucket] != BLE_TABLE_NONE) {
+        bucket = (bucket + 1) & bucketMask;
+    }
+    buckets[bucket] = slot;
+    stats.inserts++;
+    return slot;
+}
+
+void BLEDeviceTable::remove(uint16_t slot) {
+    if (!isUsed(slot)) return;
+
+    eraseBucket(findBucket(keys[slot]));
+    unlink(slot);
+    keys[slot] = 0;
+    newer[slot] = BLE_TABLE_FREE;
+    older[slot] = freeHead;
+    freeHead = slot;
+    count--;
+    stats.removals++;
+}
+
+void BLEDeviceTable::touch(uint16_t slot) {
+    if (slot == newest || !isUsed(slot)) return;
+    unlink(slot);
+    linkNewest(slot);
+}
+
+bool BLEDeviceTable::isUsed(uint16_t slot) const {
+    return keys && slot < capacity && newer[slot] != BLE_TABLE_FREE;
+}
+
+// ===== MAC HELPERS =====
+
+uint64_t BLEDeviceTable::packMac(const uint8_t* octets) {
+    uint64_t mac = 0;
+    for (uint8_t i = 0; i < 6; i++) {
+        mac = (mac << 8) | octets[i];
+    }
+    return mac;
+}
+
+void BLEDeviceTable::unpackMac(uint64_t mac, uint8_t* octets) {
+    for (int8_t i = 5; i >= 0; i--) {
+        octets[i] = (uint8_t)mac;
+        mac >>= 8;
+    }
+}
+
+void BLEDeviceTable::formatMac(uint64_t mac, char* out) {
+    static const char hex[] = "0123456789abcdef";
+    for (uint8_t i = 0; i < 6; i++) {
+        uint8_t octet = (uint8_t)(mac >> (40 - 8 * i));
+        out[i * 3] = hex[octet >> 4];
+        out[i * 3 + 1] = hex[octet & 0x0F];
+        out[i * 3 + 2] = (i < 5) ? ':' : '\0';
+    }
+}
+
+bool BLEDeviceTable::parseMac(const char* text, uint64_t& mac) {
+    uint64_t value = 0;
+    for (uint8_t i = 0; i < 17; i++) {
+        char c = text[i];
+        if (i % 3 == 2) {
+            if (c != ':' && c != '-') return false;
+            continue;
+        }
+        uint8_t nibble;
+        if (c >= '0' && c <= '9') nibble = c - '0';
+        else if (c >= 'a' && c <= 'f') nibble = c - 'a' + 10;
+        else if (c >= 'A' && c <= 'F') nibble = c - 'A' + 10;
+        else return false;
+        value = (value << 4) | nibble;
+    }
+    if (text[17] != '\0') return false;
+    mac = value;
+    return true;
+}
@@ -0,0 +1,89 @@
+#ifndef BLE_DEVICE_TABLE_H
+#define BLE_DEVICE_TABLE_H
+
+#include <stdint.h>
+
+// ========================================
+// BLEDeviceTable - Fixed-capacity index of BLE devices keyed by the
+// 48-bit MAC packed into a uint64_t. Slots are indices into a record pool
+// the caller allocates with the same capacity. Lookup is open addressing
+// with linear probing over twice as many buckets as slots, and removal
+// shifts the probe run back instead of leaving tombstones. An intrusive
+// list orders slots from most to least recently touched, so timeouts
+// scan only the stale end and a full table evicts its oldest device.
+// Nothing is allocated after begin(). Hardware independent.
+// ========================================
+
+#define BLE_TABLE_NONE          0xFFFF   // No slot
+#define BLE_TABLE_MAX_SLOTS     0x7FFF
+#define BLE_MAC_STRING_LENGTH   18       // "aa:bb:cc:dd:ee:ff" and terminator
+
+struct BLEDeviceTableStats {
+    uint32_t lookups;
+    uint32_t probes;             // Buckets examined by lookups
+    uint32_t inserts;
+    uint32_t evictions;          // Inserts that reused the oldest slot
+    uint32_t removals;
+};
+
+class BLEDeviceTable {
+private:
+    uint16_t* buckets;           // Slot per bucket, or BLE_TABLE_NONE
+    uint64_t* keys;              // MAC per slot
+    uint16_t* newer;             // LRU links; the free list runs through older
+    uint16_t* older;
+    uint16_t capacity;
+    uint16_t bucketMask;
+    uint16_t count;
+    uint16_t newest;
+    uint16_t oldest;
+    uint16_t freeHead;
+    BLEDeviceTableStats stats;
+
+    uint16_t home(uint64_t mac) const;
+    uint16_t findBucket(uint64_t mac) const;
+    void unlink(uint16_t slot);
+    void linkNewest(uint16_t slot);
+    void eraseBucket(uint16_t bucket);
+
+public:
+    BLEDeviceTable();
+    ~BLEDeviceTable();
+
+    bool begin(uint16_t slotCount);
+    void release();
+    void clear();
+
+    // Slot holding mac, or BLE_TABLE_NONE
+    uint16_t find(uint64_t mac);
+    // Adds mac as the newest slot; mac must not be present. When full the
+    // oldest slot is evicted and reused, and its index is also written to
+    // evicted (BLE_TABLE_NONE otherwise).
+    uint16_t insert(uint64_t mac, uint16_t* evicted = nullptr);
+    void remove(uint16_t slot);
+    // Marks slot as the most recently seen
+    void touch(uint16_t slot);
+
+    // Recency order: getNewest() then getOlder() until BLE_TABLE_NONE,
+    // or the other way round from getOldest()
+    uint16_t getNewest() const { return newest; }
+    uint16_t getOldest() const { return oldest; }
+    uint16_t getOlder(uint16_t slot) const { return older[slot]; }
+    uint16_t getNewer(uint16_t slot) const { return newer[slot]; }
+
+    bool isUsed(uint16_t slot) const;
+    uint64_t getMac(uint16_t slot) const { return keys[slot]; }
+    uint16_t size() const { return count; }
+    uint16_t getCapacity() const { return capacity; }
+    bool isFull() const { return count == capacity; }
+    bool isAllocated() const { return keys != nullptr; }
+    const BLEDeviceTableStats& getStats() const { return stats; }
+
+    // MAC helpers; octets in transmission order, first octet in bits 47-40
+    static uint64_t packMac(const uint8_t* octets);
+    static void unpackMac(uint64_t mac, uint8_t* octets);
+    static void formatMac(uint64_t mac, char* out);
+    static bool parseMac(const char* text, uint64_t& mac);
+};
+
+#endif // BLE_DEVICE_TABLE_H
@@ -3,6 +3,7 @@
 #include <ArduinoJson.h>
 #include <algorithm>
 #include <cmath>
+#include <string.h>
 
 // Icon data for BLE Scanner (16x16, 1-bit per pixel)
 const uint8_t ble_scanner_icon[32] = {
@@ -12,39 +13,10 @@ const uint8_t ble_scanner_icon[32] = {
     0x07, 0xE0, 0x03, 0xC0, 0x01, 0x80, 0x00, 0x00
 };
 
-// ========================================
-// RSSI History Implementation
-// ========================================
-
-void RSSIHistory::updateStatistics() {
-    if (values.empty()) return;
-    
-    // Calculate mean
-    float sum = 0;
-    for (int8_t val : values) {
-        sum += val;
-    }
-    mean = sum / values.size();
-    
-    // Calculate variance
-    float varianceSum = 0;
-    for (int8_t val : values) {
-        float diff = val - mean;
-        varianceSum += diff * diff;
-    }
-    variance = varianceSum / values.size();
-    standardDeviation = sqrt(variance);
-    
-    // Find min/max
-    min = *std::min_element(values.begin(), values.end());
-    max = *std::max_element(values.begin(), values.end());
-    
-    lastUpdated = millis();
-}
-
-bool RSSIHistory::isOutlier(int8_t rssi) const {
-    if (values.size() < 3) return false;
-    return abs(rssi - mean) > (2.0 * standardDeviation);
+// Bounded copy into a fixed char field, always terminated
+static void copyText(char* dest, const char* src, size_t size) {
+    strncpy(dest, src, size - 1);
+    dest[size - 1] = '\0';
 }
 
 // ========================================
@@ -75,6 +47,12 @@ String BLEDeviceInfo::getAnomalyString() const {
     return anomalyStr.isEmpty() ? "None" : anomalyStr;
 }
 
+String BLEDeviceInfo::getMacString() const {
+    char text[BLE_MAC_STRING_LENGTH];
+    BLEDeviceTable::formatMac(mac, text);
+    return String(text);
+}
+
 // ========================================
 // BLE Scanner Implementation
 // ========================================
@@ -86,10 +64,19 @@ BLEScanner::BLEScanner() : BaseApp() {
     scanning = false;
     lastScanTime = 0;
     scanStartTime = 0;
-    deviceCount = 0;
+    devicePool = nullptr;
+    deviceOrder = nullptr;
+    orderCount = 0;
     entropyIndex = 0;
     lastAnomalyCheck = 0;
     lastLogWrite = 0;
+    lastLogSync = 0;
+    recentLogHead = 0;
+    recentLogCount = 0;
+    startTime = 0;
+    fpsWindowStart = 0;
+    fpsFrames = 0;
+    framesPerSecond = 0.0f;
     
     // Initialize colors
     colorNormal = COLOR_WHITE;
@@ -106,7 +93,7 @@ BLEScanner::BLEScanner() : BaseApp() {
     metadata.description = "Advanced BLE device scanner with anomaly detection";
     metadata.category = CATEGORY_TOOLS;
     metadata.icon = ble_scanner_icon;
-    metadata.maxMemory = 65536; // 64KB
+    metadata.memoryRequirement = 65536; // 64KB
     metadata.requiresSD = true;
     metadata.requiresWiFi = false;
     metadata.requiresBLE = true;
@@ -117,7 +104,6 @@ BLEScanner::BLEScanner() : BaseApp() {
     }
     
     // Set file paths
-    logFilePath = BLE_SCAN_LOG_FILE;
     labelFilePath = BLE_DEVICE_LABELS_FILE;
     configFilePath = BLE_CONFIG_FILE;
 }
@@ -131,12 +117,15 @@ BLEScanner::~BLEScanner() {
 // ========================================
 
 bool BLEScanner::initialize() {
-    setState(APP_INITIALIZING);
+    setState(APP_LOADING);
+    startTime = millis();
+    fpsWindowStart = startTime;
+    fpsFrames = 0;
     
     debugLog("BLEScanner: Initializing...");
     
     // Create app data directory
-    if (!createAppDataDir()) {
+    if (!filesystem.ensureDirExists(BLE_SCANNER_DATA_DIR)) {
         debugLog("BLEScanner: Failed to create data directory");
         setState(APP_ERROR);
         return false;
@@ -148,6 +137,13 @@ bool BLEScanner::initialize() {
     // Load configuration
     loadConfiguration();
     
+    // Allocate the device table, record pool and sighting queue
+    if (!allocateDevices()) {
+        debugLog("BLEScanner: Failed to allocate device table");
+        setState(APP_ERROR);
+        return false;
+    }
+    
     // Load device labels
     loadDeviceLabels();
     
@@ -178,10 +174,9 @@ void BLEScanner::update() {
     
     unsigned long currentTime = millis();
     
-    // Process scan results if scanning
-    if (scanning) {
-        processScanResults();
-    }
+    // Take sightings queued by the scan callback, including any that
+    // arrived just before a scan stopped
+    processScanResults();
     
     // Perform periodic anomaly detection
     if (config.enableAnomalyDetection && 
@@ -201,28 +196,40 @@ void BLEScanner::update() {
     
     // Auto log to SD card
     if (config.logToSD && (currentTime - lastLogWrite) > 10000) { // Every 10 seconds
-        for (auto& devicePair : devices) {
-            if (devicePair.second.isActive()) {
-                logScanEvent(devicePair.second, "ACTIVE");
+        for (uint16_t i = 0; i < orderCount; i++) {
+            if (orderedDevice(i).isActive()) {
+                logScanEvent(orderedDevice(i), SIGHTING_EVENT_ACTIVE);
             }
         }
         lastLogWrite = currentTime;
     }
     
+    // Partial blocks only reach the card when they have waited long enough
+    if (sightingLog.hasPending() && (currentTime - lastLogSync) > BLE_LOG_SYNC_INTERVAL) {
+        sightingLog.sync();
+        lastLogSync = currentTime;
+    }
+    
     // Auto-restart scan if stopped
     if (!scanning && uiState.scanningActive && 
         (currentTime - scanStartTime) > config.scanDuration) {
         startScan();
     }
     
-    frameCount++;
+    // Frame rate over the last second, for the status bar
+    fpsFrames++;
+    if (currentTime - fpsWindowStart >= 1000) {
+        framesPerSecond = fpsFrames * 1000.0f / (currentTime - fpsWindowStart);
+        fpsFrames = 0;
+        fpsWindowStart = currentTime;
+    }
 }
 
 void BLEScanner::render() {
     if (currentState != APP_RUNNING) return;
     
     // Clear display
-    DisplayManager& display = DisplayManager::getInstance();
+    Adafruit_ILI9341& display = *displayManager.getTFT();
     display.fillScreen(colorBackground);
     
     // Render header
@@ -328,9 +335,8 @@ bool BLEScanner::handleTouch(TouchPoint touch) {
             return true;
             
         case ZONE_LOG_BUTTON:
-            if (uiState.selectedDevice >= 0) {
-                String macAddress = deviceOrder[uiState.selectedDevice];
-                logScanEvent(devices[macAddress], "USER_MARKED");
+            if (uiState.selectedDevice >= 0 && uiState.selectedDevice < orderCount) {
+                logScanEvent(orderedDevice(uiState.selectedDevice), SIGHTING_EVENT_USER_MARKED);
             }
             return true;
             
@@ -366,6 +372,7 @@ void BLEScanner::cleanup() {
     saveState();
     saveConfiguration();
     saveDeviceLabels();
+    closeLogging();
     
     // Cleanup BLE
     if (bleInitialized && pBLEScan) {
@@ -373,12 +380,12 @@ void BLEScanner::cleanup() {
         pBLEScan = nullptr;
     }
     
-    // Clear device list
-    devices.clear();
-    deviceOrder.clear();
+    // Release device list
+    releaseDevices();
     anomalyEvents.clear();
+    uiState.selectedDevice = -1;
     
-    setState(APP_INACTIVE);
+    setState(APP_UNLOADED);
 }
 
 String BLEScanner::getName() const {
@@ -406,6 +413,8 @@ bool BLEScanner::initializeBLE() {
         }
         
         // Set scan parameters
+        // Without duplicates each device is reported once per scan, which
+        // is the rate the appearance timing and statistics are built on
         pBLEScan->setAdvertisedDeviceCallbacks(new BLEScanCallback(this));
         pBLEScan->setActiveScan(true);
         pBLEScan->setInterval(config.scanInterval);
@@ -427,6 +436,9 @@ void BLEScanner::startScan() {
     debugLog("BLEScanner: Starting BLE scan...");
     
     try {
+        // The last scan's devices were queued as sightings when reported;
+        // dropping the stack's copies lets them report again in this one
+        pBLEScan->clearResults();
         pBLEScan->start(config.scanDuration / 1000, false);
         scanning = true;
         uiState.scanningActive = true;
@@ -448,6 +460,7 @@ void BLEScanner::stopScan() {
     
     try {
         pBLEScan->stop();
+        pBLEScan->clearResults();
         scanning = false;
         uiState.scanningActive = false;
         
@@ -457,101 +470,202 @@ void BLEScanner::stopScan() {
 }
 
 void BLEScanner::processScanResults() {
-    if (!pBLEScan) return;
-    
-    BLEScanResults foundDevices = pBLEScan->getResults();
-    int deviceCount = foundDevices.getCount();
-    
-    for (int i = 0; i < deviceCount; i++) {
-        BLEAdvertisedDevice device = foundDevices.getDevice(i);
-        updateDeviceInfo(device);
+    // Whole batches go back to the producer at once, and one update takes
+    // at most a ring's worth so a flood cannot stall the frame
+    uint32_t drained = 0;
+    while (drained < SIGHTING_QUEUE_SIZE) {
+        uint32_t batch = sightingQueue.beginBatch(SIGHTING_DRAIN_BATCH);
+        if (batch == 0) break;
+        
+        for (uint32_t i = 0; i < batch; i++) {
+            updateDeviceInfo(sightingQueue.batchItem(i));
+        }
+        sightingQueue.endBatch(batch);
+        drained += batch;
     }
+}
+
+void BLEScanner::queueSighting(BLEAdvertisedDevice& advertisedDevice) {
+    // Filter by RSSI threshold
+    bool haveRSSI = advertisedDevice.haveRSSI();
+    int rssi = haveRSSI ? advertisedDevice.getRSSI() : 0;
+    if (haveRSSI && rssi < config.rssiThreshold) return;
+    
+    SightingRecord* record = sightingQueue.reserve();
+    if (!record) return; // Counted as dropped
     
-    pBLEScan->clearResults();
+    // Counts drops too, so the consumer can see gaps
+    const SpscRingStats& queueStats = sightingQueue.getStats();
+    record->sequence = queueStats.produced + queueStats.dropped;
+    record->mac = BLEDeviceTable::packMac(*advertisedDevice.getAddress().getNative());
+    record->timestamp = millis();
+    record->rssi = (int8_t)rssi;
+    record->addressType = (uint8_t)advertisedDevice.getAddressType();
+    record->flags = haveRSSI ? SIGHTING_HAS_RSSI : 0;
+    copyAdvertisement(*record, advertisedDevice.getPayload(), advertisedDevice.getPayloadLength());
+    sightingQueue.commit();
 }
 
-void BLEScanner::updateDeviceInfo(BLEAdvertisedDevice advertisedDevice) {
-    String macAddress = String(advertisedDevice.getAddress().toString().c_str());
+void BLEScanner::updateDeviceInfo(const SightingRecord& sighting) {
+    uint64_t mac = sighting.mac;
     
     // Check if device already exists
-    bool isNewDevice = (devices.find(macAddress) == devices.end());
+    uint16_t slot = deviceTable.find(mac);
+    bool isNewDevice = (slot == BLE_TABLE_NONE);
     
     if (isNewDevice) {
+        uint16_t evicted;
+        slot = deviceTable.insert(mac, &evicted);
+        if (slot == BLE_TABLE_NONE) return; // Not allocated
+        
+        // A full table hands over the least recently seen device's slot
+        if (evicted != BLE_TABLE_NONE) {
+            removeFromOrder(evicted);
+            spoofIndex.remove(evicted);
+        }
+        
         // Create new device entry
-        BLEDeviceInfo newDevice;
-        newDevice.macAddress = macAddress;
-        newDevice.firstSeen = millis();
+        BLEDeviceInfo& newDevice = devicePool[slot];
+        newDevice = BLEDeviceInfo();
+        newDevice.mac = mac;
+        newDevice.firstSeen = sighting.timestamp;
         newDevice.statusFlags = DEVICE_NEW | DEVICE_ACTIVE;
         newDevice.anomalies = ANOMALY_NEW_DEVICE;
         
-        devices[macAddress] = newDevice;
-        deviceOrder.push_back(macAddress);
-        deviceCount++;
+        deviceOrder[orderCount++] = slot;
         
         stats.uniqueDevicesFound++;
         stats.totalDevicesFound++;
         
         // Log new device
-        logScanEvent(newDevice, "NEW_DEVICE");
+        logScanEvent(newDevice, SIGHTING_EVENT_NEW_DEVICE);
         
         // Create anomaly alert for new devices
-        addAnomalyEvent(macAddress, ANOMALY_NEW_DEVICE, 
+        addAnomalyEvent(newDevice, ANOMALY_NEW_DEVICE, 
                        "New device discovered", 0.5);
+    } else {
+        deviceTable.touch(slot);
     }
     
     // Update existing device info
-    BLEDeviceInfo& device = devices[macAddress];
+    BLEDeviceInfo& device = devicePool[slot];
     
     // Update basic info
-    if (advertisedDevice.haveName()) {
-        device.deviceName = String(advertisedDevice.getName().c_str());
+    if (sighting.flags & SIGHTING_HAS_NAME) {
+        copyText(device.deviceName, sighting.name, sizeof(device.deviceName));
+        spoofIndex.setKey(SPOOF_KEY_NAME, slot, SpoofIndex::hashName(device.deviceName));
+    }
+    
+    // Advertisements without identifying fields keep the last fingerprint
+    uint64_t fingerprint = SpoofIndex::fingerprint(sighting.payload, sighting.payloadLength);
+    if (fingerprint != 0) {
+        spoofIndex.setKey(SPOOF_KEY_PAYLOAD, slot, fingerprint);
     }
     
-    if (advertisedDevice.haveRSSI()) {
-        int8_t newRSSI = advertisedDevice.getRSSI();
+    if (sighting.flags & SIGHTING_HAS_RSSI) {
+        int8_t newRSSI = sighting.rssi;
         
         // Check for RSSI anomalies
         if (device.rssiHistory.isOutlier(newRSSI)) {
             device.anomalies |= ANOMALY_RSSI_OUTLIER;
-            addAnomalyEvent(macAddress, ANOMALY_RSSI_OUTLIER,
+            addAnomalyEvent(device, ANOMALY_RSSI_OUTLIER,
                            "RSSI outlier detected", 0.6);
         }
         
         // Check for sudden RSSI changes
         if (abs(newRSSI - device.rssi) > 20) {
             device.anomalies |= ANOMALY_RSSI_SUDDEN_CHANGE;
-            addAnomalyEvent(macAddress, ANOMALY_RSSI_SUDDEN_CHANGE,
+            addAnomalyEvent(device, ANOMALY_RSSI_SUDDEN_CHANGE,
                            "Sudden RSSI change", 0.7);
         }
         
         device.rssi = newRSSI;
-        device.rssiHistory.addValue(newRSSI);
+        device.rssiHistory.addValue(newRSSI, sighting.timestamp);
     }
     
     // Update timestamps and counters
-    device.lastSeen = millis();
+    device.lastSeen = sighting.timestamp;
     device.lastUpdate = millis();
     device.scanCount++;
     device.statusFlags |= DEVICE_ACTIVE;
     device.statusFlags &= ~DEVICE_TIMEOUT;
     
-    // Track appearance times for timing analysis
-    device.appearanceTimes.push_back(millis());
-    if (device.appearanceTimes.size() > 20) {
-        device.appearanceTimes.erase(device.appearanceTimes.begin());
-    }
+    // Track appearance timing for timing analysis
+    device.appearances.addAppearance(sighting.timestamp);
     
     // Update statistics
     stats.totalDevicesFound++;
 }
 
+bool BLEScanner::allocateDevices() {
+    if (devicePool) return true;
+    
+    devicePool = new BLEDeviceInfo[BLE_MAX_DEVICES];
+    deviceOrder = new uint16_t[BLE_MAX_DEVICES];
+    if (!devicePool || !deviceOrder || !deviceTable.begin(BLE_MAX_DEVICES) ||
+        !spoofIndex.begin(BLE_MAX_DEVICES) || !sightingQueue.allocate(SIGHTING_QUEUE_SIZE)) {
+        releaseDevices();
+        return false;
+    }
+    orderCount = 0;
+    return true;
+}
+
+void BLEScanner::releaseDevices() {
+    sightingQueue.release();
+    spoofIndex.release();
+    deviceTable.release();
+    delete[] devicePool;
+    delete[] deviceOrder;
+    devicePool = nullptr;
+    deviceOrder = nullptr;
+    orderCount = 0;
+}
+
+BLEDeviceInfo* BLEScanner::findDevice(uint64_t mac) {
+    uint16_t slot = deviceTable.find(mac);
+    return (slot == BLE_TABLE_NONE) ? nullptr : &devicePool[slot];
+}
+
+void BLEScanner::removeFromOrder(uint16_t slot) {
+    for (uint16_t i = 0; i < orderCount; i++) {
+        if (deviceOrder[i] != slot) continue;
+        
+        memmove(&deviceOrder[i], &deviceOrder[i + 1], sizeof(uint16_t) * (orderCount - i - 1));
+        orderCount--;
+        
+        // Keep the selection on the same device
+        if (uiState.selectedDevice == i) {
+            uiState.selectedDevice = -1;
+        } else if (uiState.selectedDevice > i) {
+            uiState.selectedDevice--;
+        }
+        return;
+    }
+}
+
+// Drops removed slots from deviceOrder in one pass
+void BLEScanner::compactDeviceOrder() {
+    int selected = -1;
+    uint16_t kept = 0;
+    
+    for (uint16_t i = 0; i < orderCount; i++) {
+        if (!deviceTable.isUsed(deviceOrder[i])) continue;
+        if (i == uiState.selectedDevice) selected = kept;
+        deviceOrder[kept++] = deviceOrder[i];
+    }
+    
+    orderCount = kept;
+    uiState.selectedDevice = selected;
+}
+
 // ========================================
 // Anomaly Detection Methods
 // ========================================
 
 void BLEScanner::performAnomalyDetection() {
-    for (auto& devicePair : devices) {
-        BLEDeviceInfo& device = devicePair.second;
+    for (uint16_t i = 0; i < orderCount; i++) {
+        BLEDeviceInfo& device = orderedDevice(i);
         
         if (!device.isActive()) continue;
         
@@ -573,109 +687,73 @@ void BLEScanner::performAnomalyDetection() {
 }
 
 void BLEScanner::analyzeRSSIAnomalies(BLEDeviceInfo& device) {
-    if (device.rssiHistory.values.size() < 5) return;
+    if (device.rssiHistory.size() < 5) return;
     
     // Check for consistent outliers
     int outlierCount = 0;
-    for (int8_t rssi : device.rssiHistory.values) {
-        if (device.rssiHistory.isOutlier(rssi)) {
+    for (uint8_t i = 0; i < device.rssiHistory.size(); i++) {
+        if (device.rssiHistory.isOutlier(device.rssiHistory.get(i))) {
             outlierCount++;
         }
     }
     
-    if (outlierCount > device.rssiHistory.values.size() / 2) {
+    if (outlierCount > device.rssiHistory.size() / 2) {
         device.anomalies |= ANOMALY_RSSI_OUTLIER;
-        addAnomalyEvent(device.macAddress, ANOMALY_RSSI_OUTLIER,
+        addAnomalyEvent(device, ANOMALY_RSSI_OUTLIER,
                        "Consistent RSSI anomalies detected", 0.8);
     }
     
     // Check for signal strength spoofing (unusually stable RSSI)
     if (device.rssiHistory.standardDeviation < 1.0 && 
-        device.rssiHistory.values.size() > 10) {
+        device.rssiHistory.size() > 10) {
         device.anomalies |= ANOMALY_SIGNAL_SPOOFING;
-        addAnomalyEvent(device.macAddress, ANOMALY_SIGNAL_SPOOFING,
+        addAnomalyEvent(device, ANOMALY_SIGNAL_SPOOFING,
                        "Possible signal spoofing (too stable)", 0.9);
     }
 }
 
 void BLEScanner::analyzeMACRandomization(BLEDeviceInfo& device) {
     // Calculate MAC address entropy
-    float macEntropy = calculateMACEntropy(device.macAddress);
+    float macEntropy = calculateMACEntropy(device.mac);
     device.entropyScore = macEntropy;
     
-    // Check for randomized MAC patterns
-    String mac = device.macAddress;
-    mac.replace(":", "");
-    
-    // Check for common randomization patterns
-    bool hasRandomPattern = false;
-    
-    // Check for locally administered bit (2nd bit of first octet)
-    if (mac.length() >= 2) {
-        int firstOctet = strtol(mac.substring(0, 2).c_str(), NULL, 16);
-        if (firstOctet & 0x02) {
-            hasRandomPattern = true;
-        }
-    }
-    
     // High entropy indicates randomization
     if (macEntropy > 0.85) {
         device.anomalies |= ANOMALY_MAC_RANDOMIZED;
         device.isMacRandomized = true;
-        addAnomalyEvent(device.macAddress, ANOMALY_MAC_RANDOMIZED,
+        addAnomalyEvent(device, ANOMALY_MAC_RANDOMIZED,
                        "Randomized MAC address detected", 0.4);
     }
     
     // Low entropy might indicate spoofing
     if (macEntropy < 0.3) {
         device.anomalies |= ANOMALY_ENTROPY_LOW;
-        addAnomalyEvent(device.macAddress, ANOMALY_ENTROPY_LOW,
+        addAnomalyEvent(device, ANOMALY_ENTROPY_LOW,
                        "Unusually low MAC entropy", 0.6);
     }
 }
 
 void BLEScanner::analyzeTimingAnomalies(BLEDeviceInfo& device) {
-    if (device.appearanceTimes.size() < 5) return;
-    
-    // Calculate intervals between appearances
-    std::vector<unsigned long> intervals;
-    for (size_t i = 1; i < device.appearanceTimes.size(); i++) {
-        intervals.push_back(device.appearanceTimes[i] - device.appearanceTimes[i-1]);
-    }
+    // Intervals between the last appearances, kept as running sums
+    const AppearanceHistory& timing = device.appearances;
+    if (timing.size() < 4) return;
     
-    // Calculate mean and variance of intervals
-    unsigned long sum = 0;
-    for (unsigned long interval : intervals) {
-        sum += interval;
-    }
-    float meanInterval = sum / (float)intervals.size();
-    
-    float varianceSum = 0;
-    for (unsigned long interval : intervals) {
-        float diff = interval - meanInterval;
-        varianceSum += diff * diff;
-    }
-    float variance = varianceSum / intervals.size();
-    float stdDev = sqrt(variance);
+    float meanInterval = timing.getMean();
+    float stdDev = timing.getStandardDeviation();
     
     // Check for timing irregularities
     if (stdDev > meanInterval * 0.5) { // High variance in timing
         device.anomalies |= ANOMALY_TIMING_IRREGULAR;
-        addAnomalyEvent(device.macAddress, ANOMALY_TIMING_IRREGULAR,
+        addAnomalyEvent(device, ANOMALY_TIMING_IRREGULAR,
                        "Irregular appearance timing", 0.5);
     }
     
     // Check for rapid appearing/disappearing
-    int rapidCount = 0;
-    for (unsigned long interval : intervals) {
-        if (interval < 1000) { // Less than 1 second
-            rapidCount++;
-        }
-    }
+    int rapidCount = timing.countBelow(1000); // Less than 1 second
     
-    if (rapidCount > intervals.size() / 2) {
+    if (rapidCount > timing.size() / 2) {
         device.anomalies |= ANOMALY_RAPID_APPEARING;
-        addAnomalyEvent(device.macAddress, ANOMALY_RAPID_APPEARING,
+        addAnomalyEvent(device, ANOMALY_RAPID_APPEARING,
                        "Rapid appearing/disappearing pattern", 0.7);
     }
 }
@@ -683,9 +761,7 @@ void BLEScanner::analyzeTimingAnomalies(BLEDeviceInfo& device) {
 void BLEScanner::analyzeEntropyPattern(BLEDeviceInfo& device) {
     // Update entropy pool with device data
     uint8_t macBytes[6];
-    sscanf(device.macAddress.c_str(), "%hhx:%hhx:%hhx:%hhx:%hhx:%hhx",
-           &macBytes[0], &macBytes[1], &macBytes[2], 
-           &macBytes[3], &macBytes[4], &macBytes[5]);
+    BLEDeviceTable::unpackMac(device.mac, macBytes);
     
     for (int i = 0; i < 6; i++) {
         entropyPool[entropyIndex] = macBytes[i] / 255.0;
@@ -704,11 +780,11 @@ void BLEScanner::analyzeEntropyPattern(BLEDeviceInfo& device) {
     // Check for entropy anomalies
     if (entropy > 0.95) {
         device.anomalies |= ANOMALY_ENTROPY_HIGH;
-        addAnomalyEvent(device.macAddress, ANOMALY_ENTROPY_HIGH,
+        addAnomalyEvent(device, ANOMALY_ENTROPY_HIGH,
                        "High entropy pattern detected", 0.6);
     } else if (entropy < 0.1) {
         device.anomalies |= ANOMALY_ENTROPY_LOW;
-        addAnomalyEvent(device.macAddress, ANOMALY_ENTROPY_LOW,
+        addAnomalyEvent(device, ANOMALY_ENTROPY_LOW,
                        "Low entropy pattern detected", 0.6);
     }
 }
@@ -736,51 +812,68 @@ float BLEScanner::calculateEntropy(const std::vector<uint8_t>& data) {
     return entropy / 8.0; // Normalize to 0-1 range
 }
 
-float BLEScanner::calculateMACEntropy(const String& macAddress) {
-    String cleanMAC = macAddress;
-    cleanMAC.replace(":", "");
-    
-    std::vector<uint8_t> macBytes;
-    for (int i = 0; i < cleanMAC.length(); i += 2) {
-        String byteStr = cleanMAC.substring(i, i + 2);
-        uint8_t byte = strtol(byteStr.c_str(), NULL, 16);
-        macBytes.push_back(byte);
-    }
+float BLEScanner::calculateMACEntropy(uint64_t mac) {
+    uint8_t octets[6];
+    BLEDeviceTable::unpackMac(mac, octets);
     
+    std::vector<uint8_t> macBytes(octets, octets + 6);
     return calculateEntropy(macBytes);
 }
 
 void BLEScanner::detectSignalSpoofing() {
-    // Look for devices with identical or suspiciously similar characteristics
-    for (auto& device1 : devices) {
-        for (auto& device2 : devices) {
-            if (device1.first == device2.first) continue;
-            
-            BLEDeviceInfo& dev1 = device1.second;
-            BLEDeviceInfo& dev2 = device2.second;
-            
-            // Check for identical device names but different MACs
-            if (!dev1.deviceName.isEmpty() && 
-                dev1.deviceName == dev2.deviceName &&
-                dev1.macAddress != dev2.macAddress) {
-                
-                // Check if RSSI values are suspiciously similar
-                if (abs(dev1.rssi - dev2.rssi) < 3) {
-                    dev1.anomalies |= ANOMALY_SIGNAL_SPOOFING;
-                    dev2.anomalies |= ANOMALY_SIGNAL_SPOOFING;
-                    
-                    addAnomalyEvent(dev1.macAddress, ANOMALY_SIGNAL_SPOOFING,
-                                   "Possible spoofing: identical name/RSSI", 0.9);
+    // Look for devices with identical or suspiciously similar characteristics.
+    // Only devices sharing a name or advertisement fingerprint are chained
+    // together, and each pair is visited once per chain.
+    for (uint8_t kind = 0; kind < SPOOF_KEY_COUNT; kind++) {
+        for (uint16_t bucket = 0; bucket < spoofIndex.getBucketCount(); bucket++) {
+            for (uint16_t a = spoofIndex.first(kind, bucket); a != SPOOF_NO_SLOT;
+                 a = spoofIndex.next(kind, a)) {
+                for (uint16_t b = spoofIndex.next(kind, a); b != SPOOF_NO_SLOT;
+                     b = spoofIndex.next(kind, b)) {
+                    if (spoofIndex.getKey(kind, a) == spoofIndex.getKey(kind, b)) {
+                        checkSpoofPair(kind, a, b);
+                    }
                 }
             }
         }
     }
 }
 
-void BLEScanner::addAnomalyEvent(const String& macAddress, AnomalyType type,
+void BLEScanner::checkSpoofPair(uint8_t kind, uint16_t slotA, uint16_t slotB) {
+    BLEDeviceInfo& dev1 = devicePool[slotA];
+    BLEDeviceInfo& dev2 = devicePool[slotB];
+    if (dev1.mac == dev2.mac) return;
+    
+    // A timed-out device has had its pairs forgotten; it pairs again once seen
+    if ((dev1.statusFlags | dev2.statusFlags) & DEVICE_TIMEOUT) return;
+    
+    bool sameName = dev1.hasName() && strcmp(dev1.deviceName, dev2.deviceName) == 0;
+    uint64_t fingerprint = spoofIndex.getKey(SPOOF_KEY_PAYLOAD, slotA);
+    bool samePayload = fingerprint != 0 && fingerprint == spoofIndex.getKey(SPOOF_KEY_PAYLOAD, slotB);
+    
+    // Name hashes can collide; pairs sharing both keys belong to the name pass
+    if (kind == SPOOF_KEY_NAME && !sameName) return;
+    if (kind == SPOOF_KEY_PAYLOAD && sameName) return;
+    
+    // Check if RSSI values are suspiciously similar
+    if (abs(dev1.rssi - dev2.rssi) >= 3) return;
+    
+    dev1.anomalies |= ANOMALY_SIGNAL_SPOOFING;
+    dev2.anomalies |= ANOMALY_SIGNAL_SPOOFING;
+    
+    // One event per pair, not one per pass and direction
+    if (!spoofIndex.markReported(slotA, slotB)) return;
+    
+    const char* description = !sameName ? "Possible spoofing: identical payload/RSSI" :
+                              samePayload ? "Possible spoofing: identical name/payload/RSSI" :
+                                            "Possible spoofing: identical name/RSSI";
+    addAnomalyEvent(dev1, ANOMALY_SIGNAL_SPOOFING, description, 0.9);
+}
+
+void BLEScanner::addAnomalyEvent(const BLEDeviceInfo& device, AnomalyType type,
                                 const String& description, float severity) {
-    AnomalyEvent event(macAddress, type, description, severity);
-    event.details = devices[macAddress].getStatusString();
+    AnomalyEvent event(device.mac, type, description, severity);
+    event.details = device.getStatusString();
     
     anomalyEvents.push_back(event);
     
@@ -790,12 +883,12 @@ void BLEScanner::addAnomalyEvent(const String& macAddress, AnomalyType type,
     }
     
     // Log anomaly event
-    logAnomalyEvent(event);
+    logAnomalyEvent(device, event);
     
     // Show alert for high severity anomalies
     if (severity > 0.7) {
         uiState.showAnomalyAlert = true;
-        uiState.alertMessage = description + " (" + macAddress + ")";
+        uiState.alertMessage = description + " (" + device.getMacString() + ")";
     }
     
     stats.anomaliesDetected++;
@@ -827,12 +920,13 @@ void BLEScanner::loadDeviceLabels() {
     
     JsonObject labels = doc.as<JsonObject>();
     for (JsonPair kv : labels) {
-        String macAddress = kv.key().c_str();
-        String label = kv.value().as<String>();
+        uint64_t mac;
+        if (!BLEDeviceTable::parseMac(kv.key().c_str(), mac)) continue;
         
-        if (devices.find(macAddress) != devices.end()) {
-            devices[macAddress].label = label;
-            devices[macAddress].statusFlags |= DEVICE_LABELED;
+        BLEDeviceInfo* device = findDevice(mac);
+        if (device) {
+            copyText(device->label, kv.value().as<const char*>(), sizeof(device->label));
+            device->statusFlags |= DEVICE_LABELED;
         }
     }
     
@@ -840,12 +934,18 @@ void BLEScanner::loadDeviceLabels() {
 }
 
 void BLEScanner::saveDeviceLabels() {
+    // Nothing to save once the pool is released; keep the file as it is
+    if (!devicePool) return;
+    
     DynamicJsonDocument doc(4096);
     JsonObject labels = doc.to<JsonObject>();
     
-    for (auto& devicePair : devices) {
-        if (!devicePair.second.label.isEmpty()) {
-            labels[devicePair.first] = devicePair.second.label;
+    for (uint16_t i = 0; i < orderCount; i++) {
+        const BLEDeviceInfo& device = orderedDevice(i);
+        if (device.isLabeled()) {
+            char macText[BLE_MAC_STRING_LENGTH];
+            BLEDeviceTable::formatMac(device.mac, macText);
+            labels[macText] = device.label;
         }
     }
     
@@ -859,40 +959,36 @@ void BLEScanner::saveDeviceLabels() {
     }
 }
 
-void BLEScanner::labelDevice(const String& macAddress, const String& label) {
-    if (devices.find(macAddress) != devices.end()) {
-        devices[macAddress].label = label;
-        devices[macAddress].statusFlags |= DEVICE_LABELED;
-        
-        logScanEvent(devices[macAddress], "LABELED");
-        saveDeviceLabels();
-        
-        stats.labeledDevices++;
-    }
+void BLEScanner::labelDevice(BLEDeviceInfo& device, const String& label) {
+    copyText(device.label, label.c_str(), sizeof(device.label));
+    device.statusFlags |= DEVICE_LABELED;
+    
+    logScanEvent(device, SIGHTING_EVENT_LABELED);
+    saveDeviceLabels();
+    
+    stats.labeledDevices++;
 }
 
-void BLEScanner::removeLabelFromDevice(const String& macAddress) {
-    if (devices.find(macAddress) != devices.end()) {
-        devices[macAddress].label = "";
-        devices[macAddress].statusFlags &= ~DEVICE_LABELED;
-        
-        logScanEvent(devices[macAddress], "LABEL_REMOVED");
-        saveDeviceLabels();
-        
-        if (stats.labeledDevices > 0) {
-            stats.labeledDevices--;
-        }
+void BLEScanner::removeLabelFromDevice(BLEDeviceInfo& device) {
+    device.label[0] = '\0';
+    device.statusFlags &= ~DEVICE_LABELED;
+    
+    logScanEvent(device, SIGHTING_EVENT_LABEL_REMOVED);
+    saveDeviceLabels();
+    
+    if (stats.labeledDevices > 0) {
+        stats.labeledDevices--;
     }
 }
 
 String BLEScanner::generateAutoLabel(const BLEDeviceInfo& device) {
     String autoLabel = "";
     
-    if (!device.deviceName.isEmpty()) {
+    if (device.hasName()) {
         autoLabel = device.deviceName;
     } else {
         // Generate label based on MAC address pattern
-        String mac = device.macAddress.substring(0, 8);
+        String mac = device.getMacString().substring(0, 8);
         autoLabel = "Device-" + mac;
     }
     
@@ -916,111 +1012,156 @@ void BLEScanner::initializeLogging() {
     // Rotate logs if needed
     rotateLogs();
     
-    debugLog("BLEScanner: Logging initialized");
-}
-
-void BLEScanner::logScanEvent(const BLEDeviceInfo& device, const String& event) {
-    if (!config.logToSD) return;
+    if (!sightingLog.allocate()) {
+        debugLog("BLEScanner: Failed to allocate sighting log");
+        return;
+    }
     
-    String logEntry = formatLogEntry(device, event);
-    filesystem.appendFile(logFilePath, logEntry + "\n");
-}
-
-void BLEScanner::logAnomalyEvent(const AnomalyEvent& event) {
-    if (!config.logToSD) return;
+    // Texts already in the dictionary keep their ids; a damaged one
+    // starts the log over so no record points at the wrong text
+    if (filesystem.fileExists(BLE_SIGHTING_DICT_FILE)) {
+        SdFileStream source;
+        source.file = SD.open(BLE_SIGHTING_DICT_FILE, FILE_READ);
+        bool loaded = source.file && sightingLog.loadDictionary(&source);
+        if (source.file) source.file.close();
+        if (!loaded || sightingLog.isDictionaryFull()) {
+            debugLog("BLEScanner: Sighting dictionary unusable, starting a new log");
+            archiveLogs();
+        }
+    } else if (filesystem.fileExists(BLE_SIGHTING_LOG_FILE)) {
+        archiveLogs();
+    }
     
-    String logEntry = String(event.timestamp) + "," +
-                     event.macAddress + "," +
-                     String((int)event.type) + "," +
-                     event.description + "," +
-                     String(event.severity, 2) + "," +
-                     event.details;
+    logStream.file = SD.open(BLE_SIGHTING_LOG_FILE, FILE_APPEND);
+    dictStream.file = SD.open(BLE_SIGHTING_DICT_FILE, FILE_APPEND);
+    if (!logStream.file || !dictStream.file || !sightingLog.begin(&logStream, &dictStream)) {
+        debugLog("BLEScanner: Failed to open sighting log");
+        closeLogging();
+        return;
+    }
+    lastLogSync = millis();
     
-    filesystem.appendFile(BLE_ANOMALY_LOG_FILE, logEntry + "\n");
+    debugLog("BLEScanner: Logging initialized");
 }
 
-void BLEScanner::exportLogData(const String& format) {
-    String exportPath = BLE_SCANNER_DATA_DIR "/export_" + String(millis()) + "." + format;
-    
-    if (format == "json") {
-        // Export as JSON
-        DynamicJsonDocument doc(8192);
-        JsonArray deviceArray = doc.createNestedArray("devices");
+void BLEScanner::closeLogging() {
+    if (sightingLog.isActive()) {
+        sightingLog.end();
         
-        for (auto& devicePair : devices) {
-            JsonObject deviceObj = deviceArray.createNestedObject();
-            const BLEDeviceInfo& device = devicePair.second;
-            
-            deviceObj["macAddress"] = device.macAddress;
-            deviceObj["deviceName"] = device.deviceName;
-            deviceObj["label"] = device.label;
-            deviceObj["rssi"] = device.rssi;
-            deviceObj["firstSeen"] = device.firstSeen;
-            deviceObj["lastSeen"] = device.lastSeen;
-            deviceObj["scanCount"] = device.scanCount;
-            deviceObj["anomalies"] = device.anomalies;
-            deviceObj["entropyScore"] = device.entropyScore;
-            deviceObj["isMacRandomized"] = device.isMacRandomized;
-        }
-        
-        JsonArray anomalyArray = doc.createNestedArray("anomalies");
-        for (const AnomalyEvent& event : anomalyEvents) {
-            JsonObject anomalyObj = anomalyArray.createNestedObject();
-            anomalyObj["timestamp"] = event.timestamp;
-            anomalyObj["macAddress"] = event.macAddress;
-            anomalyObj["type"] = (int)event.type;
-            anomalyObj["description"] = event.description;
-            anomalyObj["severity"] = event.severity;
-        }
-        
-        String content;
-        serializeJsonPretty(doc, content);
-        filesystem.writeFile(exportPath, content);
-        
-    } else if (format == "csv") {
-        // Export as CSV
-        String csvContent = "MAC Address,Device Name,Label,RSSI,First Seen,Last Seen,Scan Count,Anomalies,Entropy Score\n";
-        
-        for (auto& devicePair : devices) {
-            const BLEDeviceInfo& device = devicePair.second;
-            csvContent += device.macAddress + "," +
-                         device.deviceName + "," +
-                         device.label + "," +
-                         String(device.rssi) + "," +
-                         String(device.firstSeen) + "," +
-                         String(device.lastSeen) + "," +
-                         String(device.scanCount) + "," +
-                         String(device.anomalies) + "," +
-                         String(device.entropyScore, 3) + "\n";
+        const SightingLogStats& log = sightingLog.getStats();
+        if (log.records > 0) {
+            debugLog("BLEScanner: Logged " + String(log.records) + " sightings, " +
+                     String((float)(log.dataBytes + log.dictionaryBytes) / log.records, 1) +
+                     " bytes each");
         }
-        
-        filesystem.writeFile(exportPath, csvContent);
+    }
+    if (logStream.file) logStream.file.close();
+    if (dictStream.file) dictStream.file.close();
+    sightingLog.release();
+}
+
+void BLEScanner::logScanEvent(const BLEDeviceInfo& device, uint8_t event) {
+    if (!config.logToSD || !sightingLog.isActive()) return;
+    
+    SightingLogEntry entry;
+    entry.timestamp = millis();
+    entry.mac = device.mac;
+    entry.rssi = device.rssi;
+    entry.event = event;
+    entry.flags = (uint8_t)(device.statusFlags & SIGHTING_FLAG_STATUS_MASK);
+    if (device.isMacRandomized) entry.flags |= SIGHTING_FLAG_RANDOMIZED;
+    entry.level = SightingLogWriter::toLevel(device.entropyScore);
+    entry.anomalies = (uint16_t)device.anomalies;
+    entry.textId = sightingLog.textId(SIGHTING_TEXT_DEVICE, device.deviceName, device.label);
+    appendLogEntry(entry);
+}
+
+void BLEScanner::logAnomalyEvent(const BLEDeviceInfo& device, const AnomalyEvent& event) {
+    if (!config.logToSD || !sightingLog.isActive()) return;
+    
+    // The device's own text is in its other records; this one names the anomaly
+    SightingLogEntry entry;
+    entry.timestamp = event.timestamp;
+    entry.mac = event.mac;
+    entry.rssi = device.rssi;
+    entry.event = SIGHTING_EVENT_ANOMALY;
+    entry.flags = (uint8_t)(device.statusFlags & SIGHTING_FLAG_STATUS_MASK);
+    if (device.isMacRandomized) entry.flags |= SIGHTING_FLAG_RANDOMIZED;
+    entry.level = SightingLogWriter::toLevel(event.severity);
+    entry.anomalies = (uint16_t)event.type;
+    entry.textId = sightingLog.textId(SIGHTING_TEXT_NOTE, event.description.c_str(), nullptr);
+    appendLogEntry(entry);
+}
+
+void BLEScanner::appendLogEntry(const SightingLogEntry& entry) {
+    if (!sightingLog.append(entry) && sightingLog.hasFailed()) {
+        debugLog("BLEScanner: Sighting log write failed, logging stopped");
+        closeLogging();
+        return;
     }
     
-    debugLog("BLEScanner: Exported data to " + exportPath);
+    recentLog[recentLogHead] = entry;
+    recentLogHead = (recentLogHead + 1) % BLE_RECENT_LOG_ENTRIES;
+    if (recentLogCount < BLE_RECENT_LOG_ENTRIES) recentLogCount++;
 }
 
-void BLEScanner::rotateLogs() {
-    // Check log file sizes and rotate if needed
-    if (filesystem.getFileSize(logFilePath) > MAX_LOG_FILE_SIZE) {
-        String backupPath = logFilePath + ".old";
-        filesystem.renameFile(logFilePath, backupPath);
+void BLEScanner::exportLogData(const String& format) {
+    String exportPath = BLE_SCANNER_DATA_DIR "/export_" + String(millis()) + "." + format;
+    uint8_t exportFormat = (format == "csv") ? SIGHTING_EXPORT_CSV : SIGHTING_EXPORT_JSON;
+    
+    // Everything logged so far has to be on the card before it is read back
+    if (sightingLog.isActive()) sightingLog.sync();
+    lastLogSync = millis();
+    
+    // The log is streamed a block at a time, however long the survey ran
+    SdFileStream logSource, dictSource, target;
+    logSource.file = SD.open(BLE_SIGHTING_LOG_FILE, FILE_READ);
+    dictSource.file = SD.open(BLE_SIGHTING_DICT_FILE, FILE_READ);
+    target.file = SD.open(exportPath.c_str(), FILE_WRITE);
+    
+    SightingLogReader reader;
+    SightingLogExporter exporter;
+    unsigned long started = millis();
+    bool ok = logSource.file && target.file &&
+              reader.open(&logSource, dictSource.file ? &dictSource : nullptr) &&
+              exporter.begin(&reader, &target, exportFormat);
+    while (ok && exporter.next()) {}
+    ok = exporter.end() && ok;
+    reader.close();
+    
+    if (logSource.file) logSource.file.close();
+    if (dictSource.file) dictSource.file.close();
+    if (target.file) target.file.close();
+    
+    if (!ok) {
+        debugLog("BLEScanner: Export to " + exportPath + " failed");
+        return;
     }
-    
-    if (filesystem.getFileSize(BLE_ANOMALY_LOG_FILE) > MAX_LOG_FILE_SIZE) {
-        String backupPath = BLE_ANOMALY_LOG_FILE + ".old";
-        filesystem.renameFile(BLE_ANOMALY_LOG_FILE, backupPath);
+    debugLog("BLEScanner: Exported " + String(exporter.getRecords()) + " records to " +
+             exportPath + " in " + String(millis() - started) + " ms");
+}
+
+void BLEScanner::rotateLogs() {
+    // Check log file sizes and rotate if needed. A log that is not whole
+    // blocks was cut off mid-write; appending would misalign every block.
+    uint32_t logSize = filesystem.getFileSize(BLE_SIGHTING_LOG_FILE);
+    if (logSize > BLE_SIGHTING_LOG_MAX_SIZE || (logSize % SIGHTING_LOG_BLOCK_SIZE) != 0) {
+        archiveLogs();
     }
 }
 
-String BLEScanner::formatLogEntry(const BLEDeviceInfo& device, const String& event) {
-    return String(millis()) + "," +
-           device.macAddress + "," +
-           device.deviceName + "," +
-           device.label + "," +
-           String(device.rssi) + "," +
-           event + "," +
-           String(device.anomalies);
+void BLEScanner::archiveLogs() {
+    // The log and its dictionary only make sense together
+    String logBackup = BLE_SIGHTING_LOG_FILE ".old";
+    String dictBackup = BLE_SIGHTING_DICT_FILE ".old";
+    if (filesystem.fileExists(logBackup)) filesystem.deleteFile(logBackup);
+    if (filesystem.fileExists(dictBackup)) filesystem.deleteFile(dictBackup);
+    if (filesystem.fileExists(BLE_SIGHTING_LOG_FILE)) {
+        filesystem.renameFile(BLE_SIGHTING_LOG_FILE, logBackup);
+    }
+    if (filesystem.fileExists(BLE_SIGHTING_DICT_FILE)) {
+        filesystem.renameFile(BLE_SIGHTING_DICT_FILE, dictBackup);
+    }
 }
 
 // ========================================
@@ -1028,15 +1169,15 @@ String BLEScanner::formatLogEntry(const BLEDeviceInfo& device, const String& eve
 // ========================================
 
 void BLEScanner::updateStatistics() {
-    stats.uniqueDevicesFound = devices.size();
+    stats.uniqueDevicesFound = deviceTable.size();
     
     // Count labeled devices
     stats.labeledDevices = 0;
     float rssiSum = 0;
     int activeDevices = 0;
     
-    for (auto& devicePair : devices) {
-        const BLEDeviceInfo& device = devicePair.second;
+    for (uint16_t i = 0; i < orderCount; i++) {
+        const BLEDeviceInfo& device = orderedDevice(i);
         
         if (device.isLabeled()) {
             stats.labeledDevices++;
@@ -1081,6 +1222,9 @@ String BLEScanner::generateStatsReport() {
     report += "Average RSSI: " + String(stats.averageRSSI, 1) + " dBm\n";
     report += "Entropy Mean: " + String(stats.entropyMean, 3) + "\n";
     report += "Total Scan Time: " + formatDuration(stats.totalScanTime) + "\n";
+    report += "Sightings Queued: " + String(sightingQueue.getStats().produced) + "\n";
+    report += "Sightings Dropped: " + String(sightingQueue.getStats().dropped) + "\n";
+    report += "Queue Peak: " + String(sightingQueue.getStats().maxBacklog) + "\n";
     report += "Runtime: " + formatDuration(getRunTime()) + "\n";
     
     return report;
@@ -1091,7 +1235,7 @@ String BLEScanner::generateStatsReport() {
 // ========================================
 
 void BLEScanner::renderHeader() {
-    DisplayManager& display = DisplayManager::getInstance();
+    Adafruit_ILI9341& display = *displayManager.getTFT();
     
     // Draw header background
     display.fillRect(0, 0, SCREEN_WIDTH, HEADER_HEIGHT, COLOR_GRAY_DARK);
@@ -1126,7 +1270,7 @@ void BLEScanner::renderHeader() {
 }
 
 void BLEScanner::renderStatusBar() {
-    DisplayManager& display = DisplayManager::getInstance();
+    Adafruit_ILI9341& display = *displayManager.getTFT();
     
     int statusY = SCREEN_HEIGHT - STATUS_BAR_HEIGHT;
     display.fillRect(0, statusY, SCREEN_WIDTH, STATUS_BAR_HEIGHT, COLOR_GRAY_DARK);
@@ -1135,7 +1279,7 @@ void BLEScanner::renderStatusBar() {
     display.setTextColor(COLOR_WHITE);
     display.setTextSize(1);
     display.setCursor(5, statusY + 2);
-    display.print("Dev: " + String(deviceCount));
+    display.print("Dev: " + String(deviceTable.size()));
     
     // Anomaly count
     display.setCursor(60, statusY + 2);
@@ -1159,25 +1303,24 @@ void BLEScanner::renderStatusBar() {
 }
 
 void BLEScanner::renderDeviceList() {
-    DisplayManager& display = DisplayManager::getInstance();
+    Adafruit_ILI9341& display = *displayManager.getTFT();
     
     int listY = HEADER_HEIGHT + 5;
     int maxVisible = DEVICE_LIST_MAX_VISIBLE;
     int startIndex = uiState.scrollOffset;
-    int endIndex = min(startIndex + maxVisible, (int)deviceOrder.size());
+    int endIndex = min(startIndex + maxVisible, (int)orderCount);
     
     // Draw device entries
     for (int i = startIndex; i < endIndex; i++) {
         int y = listY + (i - startIndex) * DEVICE_LIST_ITEM_HEIGHT;
-        String macAddress = deviceOrder[i];
-        const BLEDeviceInfo& device = devices[macAddress];
+        const BLEDeviceInfo& device = orderedDevice(i);
         
         bool selected = (i == uiState.selectedDevice);
         drawDeviceEntry(y, device, selected);
     }
     
     // Draw scrollbar
-    if (deviceOrder.size() > maxVisible) {
+    if (orderCount > maxVisible) {
         renderScrollbar();
     }
     
@@ -1206,14 +1349,13 @@ void BLEScanner::renderDeviceList() {
 }
 
 void BLEScanner::renderDeviceDetails() {
-    if (uiState.selectedDevice < 0 || uiState.selectedDevice >= deviceOrder.size()) {
+    if (uiState.selectedDevice < 0 || uiState.selectedDevice >= orderCount) {
         uiState.currentView = VIEW_DEVICE_LIST;
         return;
     }
     
-    DisplayManager& display = DisplayManager::getInstance();
-    String macAddress = deviceOrder[uiState.selectedDevice];
-    const BLEDeviceInfo& device = devices[macAddress];
+    Adafruit_ILI9341& display = *displayManager.getTFT();
+    const BLEDeviceInfo& device = orderedDevice(uiState.selectedDevice);
     
     int y = HEADER_HEIGHT + 10;
     display.setTextColor(COLOR_WHITE);
@@ -1221,18 +1363,18 @@ void BLEScanner::renderDeviceDetails() {
     
     // MAC Address
     display.setCursor(5, y);
-    display.print("MAC: " + device.macAddress);
+    display.print("MAC: " + device.getMacString());
     y += 15;
     
     // Device Name
     display.setCursor(5, y);
-    display.print("Name: " + (device.deviceName.isEmpty() ? "Unknown" : device.deviceName));
+    display.print(String("Name: ") + (device.hasName() ? device.deviceName : "Unknown"));
     y += 15;
     
     // Label
     display.setCursor(5, y);
     display.setTextColor(device.isLabeled() ? COLOR_GREEN : COLOR_GRAY_LIGHT);
-    display.print("Label: " + (device.label.isEmpty() ? "None" : device.label));
+    display.print(String("Label: ") + (device.isLabeled() ? device.label : "None"));
     y += 15;
     
     // RSSI
@@ -1263,7 +1405,7 @@ void BLEScanner::renderDeviceDetails() {
     y += 15;
     
     // RSSI History
-    if (device.rssiHistory.values.size() > 1) {
+    if (device.rssiHistory.size() > 1) {
         display.setTextColor(COLOR_WHITE);
         display.setCursor(5, y);
         display.print("RSSI Stats:");
@@ -1307,7 +1449,7 @@ void BLEScanner::renderDeviceDetails() {
 }
 
 void BLEScanner::renderAnomalyAlerts() {
-    DisplayManager& display = DisplayManager::getInstance();
+    Adafruit_ILI9341& display = *displayManager.getTFT();
     
     int y = HEADER_HEIGHT + 10;
     display.setTextSize(1);
@@ -1321,7 +1463,7 @@ void BLEScanner::renderAnomalyAlerts() {
     
     // Show recent anomalies
     int maxShow = min(8, (int)anomalyEvents.size());
-    for (int i = anomalyEvents.size() - maxShow; i < anomalyEvents.size(); i++) {
+    for (int i = (int)anomalyEvents.size() - maxShow; i < (int)anomalyEvents.size(); i++) {
         const AnomalyEvent& event = anomalyEvents[i];
         
         // Color based on severity
@@ -1334,7 +1476,9 @@ void BLEScanner::renderAnomalyAlerts() {
         y += 12;
         
         display.setCursor(10, y);
-        display.print(event.macAddress.substring(0, 17)); // Show MAC
+        char macText[BLE_MAC_STRING_LENGTH];
+        BLEDeviceTable::formatMac(event.mac, macText);
+        display.print(macText); // Show MAC
         y += 12;
         
         display.setCursor(10, y);
@@ -1346,7 +1490,7 @@ void BLEScanner::renderAnomalyAlerts() {
 }
 
 void BLEScanner::renderStatistics() {
-    DisplayManager& display = DisplayManager::getInstance();
+    Adafruit_ILI9341& display = *displayManager.getTFT();
     
     int y = HEADER_HEIGHT + 10;
     display.setTextColor(COLOR_WHITE);
@@ -1407,20 +1551,27 @@ void BLEScanner::renderStatistics() {
     display.print("Memory: " + String(getMemoryUsage() / 1024) + "KB");
     y += 12;
     
+    const SpscRingStats& queueStats = sightingQueue.getStats();
+    display.setCursor(5, y);
+    display.setTextColor(queueStats.dropped > 0 ? COLOR_YELLOW : COLOR_WHITE);
+    display.print("Queue: peak " + String(queueStats.maxBacklog) + "/" + String(SIGHTING_QUEUE_SIZE) +
+                 ", lost " + String(queueStats.dropped));
+    display.setTextColor(COLOR_WHITE);
+    y += 12;
+    
     display.setCursor(5, y);
     display.print("FPS: " + String(getFPS(), 1));
 }
 
 void BLEScanner::renderLabelingInterface() {
-    DisplayManager& display = DisplayManager::getInstance();
+    Adafruit_ILI9341& display = *displayManager.getTFT();
     
-    if (uiState.selectedDevice < 0 || uiState.selectedDevice >= deviceOrder.size()) {
+    if (uiState.selectedDevice < 0 || uiState.selectedDevice >= orderCount) {
         uiState.currentView = VIEW_DEVICE_DETAILS;
         return;
     }
     
-    String macAddress = deviceOrder[uiState.selectedDevice];
-    const BLEDeviceInfo& device = devices[macAddress];
+    const BLEDeviceInfo& device = orderedDevice(uiState.selectedDevice);
     
     int y = HEADER_HEIGHT + 10;
     display.setTextColor(COLOR_WHITE);
@@ -1431,11 +1582,11 @@ void BLEScanner::renderLabelingInterface() {
     y += 15;
     
     display.setCursor(5, y);
-    display.print("MAC: " + device.macAddress);
+    display.print("MAC: " + device.getMacString());
     y += 15;
     
     display.setCursor(5, y);
-    display.print("Name: " + (device.deviceName.isEmpty() ? "Unknown" : device.deviceName));
+    display.print(String("Name: ") + (device.hasName() ? device.deviceName : "Unknown"));
     y += 20;
     
     display.setCursor(5, y);
@@ -1444,7 +1595,7 @@ void BLEScanner::renderLabelingInterface() {
     
     display.setTextColor(device.isLabeled() ? COLOR_GREEN : COLOR_GRAY_LIGHT);
     display.setCursor(10, y);
-    display.print(device.label.isEmpty() ? "None" : device.label);
+    display.print(device.isLabeled() ? device.label : "None");
     y += 20;
     
     // Suggested labels
@@ -1498,7 +1649,7 @@ void BLEScanner::renderLabelingInterface() {
 }
 
 void BLEScanner::renderLogView() {
-    DisplayManager& display = DisplayManager::getInstance();
+    Adafruit_ILI9341& display = *displayManager.getTFT();
     
     int y = HEADER_HEIGHT + 10;
     display.setTextColor(COLOR_WHITE);
@@ -1508,53 +1659,35 @@ void BLEScanner::renderLogView() {
     display.print("=== Recent Logs ===");
     y += 15;
     
-    // Show recent log entries
-    String logContent = filesystem.readFile(logFilePath);
-    if (logContent.isEmpty()) {
+    // Show recent log entries, newest first
+    if (recentLogCount == 0) {
         display.setTextColor(COLOR_GRAY_LIGHT);
         display.setCursor(5, y);
         display.print("No log entries");
         return;
     }
     
-    // Parse and show last few entries
-    int lineCount = 0;
-    int lastNewline = logContent.lastIndexOf('\n');
-    while (lastNewline > 0 && lineCount < 8) {
-        int prevNewline = logContent.lastIndexOf('\n', lastNewline - 1);
-        String line = logContent.substring(prevNewline + 1, lastNewline);
+    for (uint8_t i = 0; i < recentLogCount; i++) {
+        uint8_t index = (recentLogHead + BLE_RECENT_LOG_ENTRIES - 1 - i) % BLE_RECENT_LOG_ENTRIES;
+        const SightingLogEntry& entry = recentLog[index];
+        char macText[BLE_MAC_STRING_LENGTH];
+        BLEDeviceTable::formatMac(entry.mac, macText);
         
-        if (!line.isEmpty()) {
-            // Parse CSV line
-            int comma1 = line.indexOf(',');
-            int comma2 = line.indexOf(',', comma1 + 1);
-            int comma3 = line.indexOf(',', comma2 + 1);
-            
-            if (comma1 > 0 && comma2 > comma1 && comma3 > comma2) {
-                String timestamp = line.substring(0, comma1);
-                String mac = line.substring(comma1 + 1, comma2);
-                String event = line.substring(comma2 + 1, comma3);
-                
-                display.setTextColor(COLOR_WHITE);
-                display.setCursor(5, y);
-                display.print(formatTime(timestamp.toInt()));
-                y += 10;
-                
-                display.setTextColor(COLOR_CYAN);
-                display.setCursor(10, y);
-                display.print(mac.substring(0, 17));
-                y += 10;
-                
-                display.setTextColor(COLOR_YELLOW);
-                display.setCursor(10, y);
-                display.print(event);
-                y += 15;
-                
-                lineCount++;
-            }
-        }
+        display.setTextColor(COLOR_WHITE);
+        display.setCursor(5, y);
+        display.print(formatTime(entry.timestamp));
+        y += 10;
+        
+        display.setTextColor(COLOR_CYAN);
+        display.setCursor(10, y);
+        display.print(macText);
+        y += 10;
+        
+        display.setTextColor(COLOR_YELLOW);
+        display.setCursor(10, y);
+        display.print(SightingLogReader::eventName(entry.event));
+        y += 15;
         
-        lastNewline = prevNewline;
         if (y > SCREEN_HEIGHT - STATUS_BAR_HEIGHT - 30) break;
     }
     
@@ -1568,25 +1701,25 @@ void BLEScanner::renderLogView() {
 }
 
 void BLEScanner::renderScrollbar() {
-    if (deviceOrder.size() <= DEVICE_LIST_MAX_VISIBLE) return;
+    if (orderCount <= DEVICE_LIST_MAX_VISIBLE) return;
     
-    DisplayManager& display = DisplayManager::getInstance();
+    Adafruit_ILI9341& display = *displayManager.getTFT();
     
-    int scrollBarX = SCREEN_WIDTH - SCROLL_BAR_WIDTH - 2;
+    int scrollBarX = SCREEN_WIDTH - BLE_SCROLL_BAR_WIDTH - 2;
     int scrollBarY = HEADER_HEIGHT + 5;
     int scrollBarHeight = DEVICE_LIST_MAX_VISIBLE * DEVICE_LIST_ITEM_HEIGHT;
     
     // Draw scrollbar background
-    display.drawRect(scrollBarX, scrollBarY, SCROLL_BAR_WIDTH, scrollBarHeight, COLOR_GRAY_LIGHT);
+    display.drawRect(scrollBarX, scrollBarY, BLE_SCROLL_BAR_WIDTH, scrollBarHeight, COLOR_GRAY_LIGHT);
     
     // Calculate thumb position and size
-    int totalItems = deviceOrder.size();
+    int totalItems = orderCount;
     int thumbHeight = max(10, scrollBarHeight * DEVICE_LIST_MAX_VISIBLE / totalItems);
     int thumbY = scrollBarY + (scrollBarHeight - thumbHeight) * uiState.scrollOffset / 
                 (totalItems - DEVICE_LIST_MAX_VISIBLE);
     
     // Draw scrollbar thumb
-    display.fillRect(scrollBarX + 1, thumbY, SCROLL_BAR_WIDTH - 2, thumbHeight, COLOR_WHITE);
+    display.fillRect(scrollBarX + 1, thumbY, BLE_SCROLL_BAR_WIDTH - 2, thumbHeight, COLOR_WHITE);
 }
 
 // ========================================
@@ -1594,14 +1727,14 @@ void BLEScanner::renderScrollbar() {
 // ========================================
 
 void BLEScanner::drawDeviceEntry(int y, const BLEDeviceInfo& device, bool selected) {
-    DisplayManager& display = DisplayManager::getInstance();
+    Adafruit_ILI9341& display = *displayManager.getTFT();
     
     // Background
     uint16_t bgColor = selected ? COLOR_GRAY_DARK : colorBackground;
-    display.fillRect(0, y, SCREEN_WIDTH - SCROLL_BAR_WIDTH - 5, DEVICE_LIST_ITEM_HEIGHT, bgColor);
+    display.fillRect(0, y, SCREEN_WIDTH - BLE_SCROLL_BAR_WIDTH - 5, DEVICE_LIST_ITEM_HEIGHT, bgColor);
     
     if (selected) {
-        display.drawRect(0, y, SCREEN_WIDTH - SCROLL_BAR_WIDTH - 5, DEVICE_LIST_ITEM_HEIGHT, COLOR_WHITE);
+        display.drawRect(0, y, SCREEN_WIDTH - BLE_SCROLL_BAR_WIDTH - 5, DEVICE_LIST_ITEM_HEIGHT, COLOR_WHITE);
     }
     
     // Device color based on status
@@ -1612,16 +1745,16 @@ void BLEScanner::drawDeviceEntry(int y, const BLEDeviceInfo& device, bool select
     
     // Signal strength icon
     drawSignalStrengthIcon(iconX, y + 6, device.rssi);
-    iconX += ICON_SIZE + 2;
+    iconX += BLE_ICON_SIZE + 2;
     
     // Label icon
     drawLabelIcon(iconX, y + 6, device.isLabeled());
-    iconX += ICON_SIZE + 2;
+    iconX += BLE_ICON_SIZE + 2;
     
     // Anomaly icon
     if (device.hasAnomalies()) {
         drawAnomalyIcon(iconX, y + 6, device.anomalies);
-        iconX += ICON_SIZE + 2;
+        iconX += BLE_ICON_SIZE + 2;
     }
     
     // Device info text
@@ -1630,7 +1763,7 @@ void BLEScanner::drawDeviceEntry(int y, const BLEDeviceInfo& device, bool select
     display.setCursor(iconX + 5, y + 2);
     
     // Show label if available, otherwise MAC
-    String displayText = device.isLabeled() ? device.label : device.macAddress;
+    String displayText = device.isLabeled() ? String(device.label) : device.getMacString();
     if (displayText.length() > 18) {
         displayText = displayText.substring(0, 15) + "...";
     }
@@ -1649,7 +1782,7 @@ void BLEScanner::drawDeviceEntry(int y, const BLEDeviceInfo& device, bool select
 }
 
 void BLEScanner::drawSignalStrengthIcon(int x, int y, int8_t rssi) {
-    DisplayManager& display = DisplayManager::getInstance();
+    Adafruit_ILI9341& display = *displayManager.getTFT();
     
     uint16_t color = rssi > -50 ? COLOR_GREEN : 
                     rssi > -70 ? COLOR_YELLOW : COLOR_RED;
@@ -1666,7 +1799,7 @@ void BLEScanner::drawSignalStrengthIcon(int x, int y, int8_t rssi) {
 }
 
 void BLEScanner::drawLabelIcon(int x, int y, bool labeled) {
-    DisplayManager& display = DisplayManager::getInstance();
+    Adafruit_ILI9341& display = *displayManager.getTFT();
     
     uint16_t color = labeled ? COLOR_GREEN : COLOR_GRAY_DARK;
     
@@ -1679,7 +1812,7 @@ void BLEScanner::drawLabelIcon(int x, int y, bool labeled) {
 }
 
 void BLEScanner::drawAnomalyIcon(int x, int y, uint32_t anomalies) {
-    DisplayManager& display = DisplayManager::getInstance();
+    Adafruit_ILI9341& display = *displayManager.getTFT();
     
     // Determine color based on anomaly severity
     uint16_t color = COLOR_RED;
@@ -1796,7 +1929,7 @@ void BLEScanner::handleDeviceListTouch(TouchPoint touch) {
     int itemIndex = (touch.y - listY) / DEVICE_LIST_ITEM_HEIGHT;
     int deviceIndex = uiState.scrollOffset + itemIndex;
     
-    if (deviceIndex >= 0 && deviceIndex < deviceOrder.size()) {
+    if (deviceIndex >= 0 && deviceIndex < orderCount) {
         if (uiState.selectedDevice == deviceIndex) {
             // Double tap - show device details
             uiState.currentView = VIEW_DEVICE_DETAILS;
@@ -1813,11 +1946,11 @@ void BLEScanner::handleDeviceDetailsTouch(TouchPoint touch) {
 }
 
 void BLEScanner::handleLabelingTouch(TouchPoint touch) {
-    if (uiState.selectedDevice < 0 || uiState.selectedDevice >= deviceOrder.size()) {
+    if (uiState.selectedDevice < 0 || uiState.selectedDevice >= orderCount) {
         return;
     }
     
-    String macAddress = deviceOrder[uiState.selectedDevice];
+    BLEDeviceInfo& device = orderedDevice(uiState.selectedDevice);
     
     // Handle suggestion buttons
     int y = HEADER_HEIGHT + 100; // Position after suggestions
@@ -1829,7 +1962,7 @@ void BLEScanner::handleLabelingTouch(TouchPoint touch) {
             
             switch (suggestionIndex) {
                 case 0:
-                    newLabel = generateAutoLabel(devices[macAddress]);
+                    newLabel = generateAutoLabel(device);
                     break;
                 case 1:
                     newLabel = "My Device";
@@ -1843,7 +1976,7 @@ void BLEScanner::handleLabelingTouch(TouchPoint touch) {
             }
             
             if (!newLabel.isEmpty()) {
-                labelDevice(macAddress, newLabel);
+                labelDevice(device, newLabel);
                 uiState.currentView = VIEW_DEVICE_DETAILS;
             }
         }
@@ -1854,12 +1987,12 @@ void BLEScanner::handleLabelingTouch(TouchPoint touch) {
     if (touch.y >= buttonY && touch.y <= buttonY + 20) {
         if (touch.x >= 5 && touch.x <= 85) {
             // Auto label button
-            String autoLabel = generateAutoLabel(devices[macAddress]);
-            labelDevice(macAddress, autoLabel);
+            String autoLabel = generateAutoLabel(device);
+            labelDevice(device, autoLabel);
             uiState.currentView = VIEW_DEVICE_DETAILS;
         } else if (touch.x >= 95 && touch.x <= 175) {
             // Remove label button
-            removeLabelFromDevice(macAddress);
+            removeLabelFromDevice(device);
             uiState.currentView = VIEW_DEVICE_DETAILS;
         }
     }
@@ -1943,51 +2076,49 @@ void BLEScanner::resetConfiguration() {
 
 void BLEScanner::cleanupOldDevices() {
     unsigned long currentTime = millis();
-    std::vector<String> toRemove;
-    
-    for (auto& devicePair : devices) {
-        BLEDeviceInfo& device = devicePair.second;
+    uint16_t removed = 0;
+    
+    // Every sighting touches its slot, so the table's recency order is
+    // lastSeen order and the walk stops at the first device still in time
+    uint16_t slot = deviceTable.getOldest();
+    while (slot != BLE_TABLE_NONE) {
+        BLEDeviceInfo& device = devicePool[slot];
+        uint16_t next = deviceTable.getNewer(slot);
         
-        if ((currentTime - device.lastSeen) > config.deviceTimeout) {
-            device.statusFlags |= DEVICE_TIMEOUT;
-            device.statusFlags &= ~DEVICE_ACTIVE;
-            
-            // Remove very old devices (over 1 hour)
-            if ((currentTime - device.lastSeen) > 3600000) {
-                toRemove.push_back(devicePair.first);
-            }
-        }
-    }
-    
-    // Remove old devices
-    for (const String& macAddress : toRemove) {
-        devices.erase(macAddress);
+        if ((currentTime - device.lastSeen) <= config.deviceTimeout) break;
         
-        // Remove from device order
-        auto it = std::find(deviceOrder.begin(), deviceOrder.end(), macAddress);
-        if (it != deviceOrder.end()) {
-            deviceOrder.erase(it);
-        }
+        // Spoofing pairs are reported afresh if the device comes back
+        if (!(device.statusFlags & DEVICE_TIMEOUT)) spoofIndex.forgetPairs(slot);
+        device.statusFlags |= DEVICE_TIMEOUT;
+        device.statusFlags &= ~DEVICE_ACTIVE;
         
-        deviceCount--;
+        // Remove very old devices (over 1 hour)
+        if ((currentTime - device.lastSeen) > 3600000) {
+            deviceTable.remove(slot);
+            spoofIndex.remove(slot);
+            removed++;
+        }
+        slot = next;
     }
     
-    if (!toRemove.empty()) {
-        debugLog("BLEScanner: Cleaned up " + String(toRemove.size()) + " old devices");
+    // Remove old devices from the display order in one pass
+    if (removed > 0) {
+        compactDeviceOrder();
+        debugLog("BLEScanner: Cleaned up " + String(removed) + " old devices");
     }
 }
 
 void BLEScanner::sortDevicesByRSSI() {
-    std::sort(deviceOrder.begin(), deviceOrder.end(), 
-              [this](const String& a, const String& b) {
-                  return devices[a].rssi > devices[b].rssi;
+    std::sort(deviceOrder, deviceOrder + orderCount, 
+              [this](uint16_t a, uint16_t b) {
+                  return devicePool[a].rssi > devicePool[b].rssi;
               });
 }
 
 void BLEScanner::sortDevicesByTime() {
-    std::sort(deviceOrder.begin(), deviceOrder.end(), 
-              [this](const String& a, const String& b) {
-                  return devices[a].lastSeen > devices[b].lastSeen;
+    std::sort(deviceOrder, deviceOrder + orderCount, 
+              [this](uint16_t a, uint16_t b) {
+                  return devicePool[a].lastSeen > devicePool[b].lastSeen;
               });
 }
 
@@ -2022,9 +2153,12 @@ String BLEScanner::sanitizeDeviceName(const String& name) {
     return sanitized;
 }
 
-int BLEScanner::findDeviceIndex(const String& macAddress) {
-    for (int i = 0; i < deviceOrder.size(); i++) {
-        if (deviceOrder[i] == macAddress) {
+int BLEScanner::findDeviceIndex(uint64_t mac) {
+    uint16_t slot = deviceTable.find(mac);
+    if (slot == BLE_TABLE_NONE) return -1;
+    
+    for (int i = 0; i < orderCount; i++) {
+        if (deviceOrder[i] == slot) {
             return i;
         }
     }
@@ -2044,10 +2178,10 @@ void BLEScanner::toggleScanning() {
 }
 
 void BLEScanner::clearDeviceList() {
-    devices.clear();
-    deviceOrder.clear();
+    deviceTable.clear();
+    spoofIndex.clear();
+    orderCount = 0;
     anomalyEvents.clear();
-    deviceCount = 0;
     
     uiState.selectedDevice = -1;
     uiState.scrollOffset = 0;
@@ -2142,17 +2276,9 @@ bool BLEScanner::loadState() {
     return true;
 }
 
-bool BLEScanner::handleMessage(AppMessage message, void* data) {
-    switch (message) {
-        case MSG_PAUSE:
-            onPause();
-            return true;
-            
-        case MSG_RESUME:
-            onResume();
-            return true;
-            
-        case MSG_LOW_MEMORY:
+bool BLEScanner::handleMessage(AppMessage message) {
+    switch (message.type) {
+        case MSG_MEMORY_WARNING:
             // Reduce memory usage by clearing old devices
             cleanupOldDevices();
             
@@ -2163,12 +2289,12 @@ bool BLEScanner::handleMessage(AppMessage message, void* data) {
             }
             return true;
             
-        case MSG_SHUTDOWN:
+        case MSG_SYSTEM_SHUTDOWN:
             cleanup();
             return true;
             
         default:
-            return BaseApp::handleMessage(message, data);
+            return BaseApp::handleMessage(message);
     }
 }
 
@@ -2250,12 +2376,7 @@ void BLEScanner::handleSetting(uint8_t index) {
 void BLEScanCallback::onResult(BLEAdvertisedDevice advertisedDevice) {
     if (!scanner) return;
     
-    // Filter by RSSI threshold
-    if (advertisedDevice.haveRSSI() &&
-        advertisedDevice.getRSSI() < scanner->config.rssiThreshold) {
-        return;
-    }
-    
-    // Update device info through the scanner
-    scanner->updateDeviceInfo(advertisedDevice);
+    // Runs on the BLE task: only a record is queued here, and update()
+    // applies it on the app loop
+    scanner->queueSighting(advertisedDevice);
 }
\ No newline at end of file
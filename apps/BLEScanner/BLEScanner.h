@@ -4,18 +4,26 @@
 #include "../../core/AppManager/BaseApp.h"
 #include "../../core/FileSystem.h"
 #include "../../core/Config.h"
+#include "../../core/Streams/SdFileStream.h"
 #include <BLEDevice.h>
 #include <BLEUtils.h>
 #include <BLEScan.h>
 #include <BLEAdvertisedDevice.h>
 #include <vector>
-#include <map>
+#include "BLEDeviceTable.h"
+#include "SignalHistory.h"
+#include "SightingRecord.h"
+#include "SpoofIndex.h"
+#include "SightingLog.h"
 
 // ========================================
 // BLEScanner - Advanced BLE device scanning and analysis
 // Provides comprehensive BLE monitoring with anomaly detection
 // ========================================
 
+#define BLE_LABEL_MAX_LENGTH       24      // Longest user label kept per device
+#define BLE_RECENT_LOG_ENTRIES     8       // Log entries kept for the log view
+
 // Anomaly detection types
 enum AnomalyType {
     ANOMALY_NONE = 0,
@@ -63,33 +71,11 @@ enum TouchZone {
     ZONE_ALERT_DISMISS
 };
 
-// RSSI history for anomaly detection
-struct RSSIHistory {
-    std::vector<int8_t> values;
-    float mean;
-    float variance;
-    float standardDeviation;
-    int8_t min;
-    int8_t max;
-    unsigned long lastUpdated;
-    
-    void addValue(int8_t rssi) {
-        values.push_back(rssi);
-        if (values.size() > 20) { // Keep last 20 readings
-            values.erase(values.begin());
-        }
-        updateStatistics();
-    }
-    
-    void updateStatistics();
-    bool isOutlier(int8_t rssi) const;
-};
-
 // BLE device information with extended tracking
 struct BLEDeviceInfo {
-    String macAddress;
-    String deviceName;
-    String label;
+    uint64_t mac;                // Packed, see BLEDeviceTable
+    char deviceName[BLE_NAME_MAX_LENGTH + 1];
+    char label[BLE_LABEL_MAX_LENGTH + 1];
     int8_t rssi;
     RSSIHistory rssiHistory;
     unsigned long firstSeen;
@@ -100,33 +86,38 @@ struct BLEDeviceInfo {
     uint32_t anomalies;
     float entropyScore;
     bool isMacRandomized;
-    std::vector<unsigned long> appearanceTimes;
+    AppearanceHistory appearances;
     
     // Constructor
     BLEDeviceInfo() : 
-        rssi(-100), firstSeen(0), lastSeen(0), lastUpdate(0),
+        mac(0), rssi(-100), firstSeen(0), lastSeen(0), lastUpdate(0),
         scanCount(0), statusFlags(DEVICE_NEW), anomalies(ANOMALY_NONE),
-        entropyScore(0.0), isMacRandomized(false) {}
+        entropyScore(0.0), isMacRandomized(false) {
+        deviceName[0] = '\0';
+        label[0] = '\0';
+    }
     
     // Helper methods
     bool isActive() const { return (millis() - lastSeen) < BLE_DEVICE_TIMEOUT; }
-    bool isLabeled() const { return !label.isEmpty(); }
+    bool isLabeled() const { return label[0] != '\0'; }
+    bool hasName() const { return deviceName[0] != '\0'; }
     bool hasAnomalies() const { return anomalies != ANOMALY_NONE; }
     String getStatusString() const;
     String getAnomalyString() const;
+    String getMacString() const;
 };
 
 // Anomaly event logging
 struct AnomalyEvent {
     unsigned long timestamp;
-    String macAddress;
+    uint64_t mac;
     AnomalyType type;
     String description;
     float severity; // 0.0 - 1.0
     String details;
     
-    AnomalyEvent(const String& mac, AnomalyType t, const String& desc, float sev) :
-        timestamp(millis()), macAddress(mac), type(t), 
+    AnomalyEvent(uint64_t m, AnomalyType t, const String& desc, float sev) :
+        timestamp(millis()), mac(m), type(t), 
         description(desc), severity(sev) {}
 };
 
@@ -190,11 +181,15 @@ private:
     bool scanning;
     unsigned long lastScanTime;
     unsigned long scanStartTime;
+    SpscRing<SightingRecord> sightingQueue; // Filled by BLEScanCallback on the BLE task
     
-    // Device tracking
-    std::map<String, BLEDeviceInfo> devices;
-    std::vector<String> deviceOrder; // For consistent UI ordering
-    uint32_t deviceCount;
+    // Device tracking: records live in a pool indexed by table slot, and
+    // deviceOrder lists slots in first-seen order for the UI
+    BLEDeviceTable deviceTable;
+    BLEDeviceInfo* devicePool;
+    uint16_t* deviceOrder;
+    uint16_t orderCount;
+    SpoofIndex spoofIndex;          // Same slots as deviceTable
     
     // Anomaly detection
     std::vector<AnomalyEvent> anomalyEvents;
@@ -204,10 +199,18 @@ private:
     
     // Statistics and logging
     ScanStatistics stats;
-    String logFilePath;
     String labelFilePath;
     String configFilePath;
     unsigned long lastLogWrite;
+    unsigned long lastLogSync;
+    
+    // Binary sighting log, appended across sessions
+    SightingLogWriter sightingLog;
+    SdFileStream logStream;
+    SdFileStream dictStream;
+    SightingLogEntry recentLog[BLE_RECENT_LOG_ENTRIES]; // Ring for the log view
+    uint8_t recentLogHead;
+    uint8_t recentLogCount;
     
     // UI state
     UIState uiState;
@@ -221,12 +224,24 @@ private:
     uint16_t colorBackground;
     uint16_t colorText;
     
+    // Status bar figures
+    unsigned long startTime;
+    unsigned long fpsWindowStart;
+    uint16_t fpsFrames;
+    float framesPerSecond;
+    
     // ===== CORE BLE METHODS =====
     bool initializeBLE();
     void startScan();
     void stopScan();
     void processScanResults();
-    void updateDeviceInfo(BLEAdvertisedDevice advertisedDevice);
+    void updateDeviceInfo(const SightingRecord& sighting);
+    bool allocateDevices();
+    void releaseDevices();
+    BLEDeviceInfo* findDevice(uint64_t mac);
+    BLEDeviceInfo& orderedDevice(int index) { return devicePool[deviceOrder[index]]; }
+    void removeFromOrder(uint16_t slot);
+    void compactDeviceOrder();
     
     // ===== ANOMALY DETECTION METHODS =====
     void performAnomalyDetection();
@@ -235,25 +250,28 @@ private:
     void analyzeTimingAnomalies(BLEDeviceInfo& device);
     void analyzeEntropyPattern(BLEDeviceInfo& device);
     float calculateEntropy(const std::vector<uint8_t>& data);
-    float calculateMACEntropy(const String& macAddress);
+    float calculateMACEntropy(uint64_t mac);
     void detectSignalSpoofing();
-    void addAnomalyEvent(const String& macAddress, AnomalyType type, 
+    void checkSpoofPair(uint8_t kind, uint16_t slotA, uint16_t slotB);
+    void addAnomalyEvent(const BLEDeviceInfo& device, AnomalyType type, 
                         const String& description, float severity);
     
     // ===== DEVICE LABELING METHODS =====
     void loadDeviceLabels();
     void saveDeviceLabels();
-    void labelDevice(const String& macAddress, const String& label);
-    void removeLabelFromDevice(const String& macAddress);
+    void labelDevice(BLEDeviceInfo& device, const String& label);
+    void removeLabelFromDevice(BLEDeviceInfo& device);
     String generateAutoLabel(const BLEDeviceInfo& device);
     
     // ===== DATA LOGGING METHODS =====
     void initializeLogging();
-    void logScanEvent(const BLEDeviceInfo& device, const String& event);
-    void logAnomalyEvent(const AnomalyEvent& event);
+    void closeLogging();
+    void logScanEvent(const BLEDeviceInfo& device, uint8_t event);
+    void logAnomalyEvent(const BLEDeviceInfo& device, const AnomalyEvent& event);
+    void appendLogEntry(const SightingLogEntry& entry);
     void exportLogData(const String& format); // JSON or CSV
     void rotateLogs();
-    String formatLogEntry(const BLEDeviceInfo& device, const String& event);
+    void archiveLogs();
     
     // ===== STATISTICS METHODS =====
     void updateStatistics();
@@ -300,7 +318,10 @@ private:
     void sortDevicesByTime();
     bool isValidMACAddress(const String& mac);
     String sanitizeDeviceName(const String& name);
-    int findDeviceIndex(const String& macAddress);
+    int findDeviceIndex(uint64_t mac);
+    unsigned long getRunTime() const { return millis() - startTime; }
+    size_t getMemoryUsage() const { return ESP.getHeapSize() - ESP.getFreeHeap(); }
+    float getFPS() const { return framesPerSecond; }
     
 public:
     BLEScanner();
@@ -320,13 +341,15 @@ public:
     void onResume() override;
     bool saveState() override;
     bool loadState() override;
-    bool handleMessage(AppMessage message, void* data = nullptr) override;
+    bool handleMessage(AppMessage message) override;
     
     // ===== PUBLIC INTERFACE =====
     void toggleScanning();
     void clearDeviceList();
     void exportDeviceData();
-    uint32_t getDeviceCount() const { return deviceCount; }
+    // BLE task side of the sighting queue; touches nothing else
+    void queueSighting(BLEAdvertisedDevice& advertisedDevice);
+    uint32_t getDeviceCount() const { return deviceTable.size(); }
     uint32_t getAnomalyCount() const { return anomalyEvents.size(); }
     ScanStatistics getStatistics() const { return stats; }
     
@@ -351,15 +374,17 @@ public:
 #define DEVICE_LIST_MAX_VISIBLE     8
 #define HEADER_HEIGHT              20
 #define STATUS_BAR_HEIGHT          16
-#define SCROLL_BAR_WIDTH           8
-#define ICON_SIZE                  12
+#define BLE_SCROLL_BAR_WIDTH       8
+#define BLE_ICON_SIZE              12
 #define MARGIN                     4
 
 // File paths
 #define BLE_SCANNER_DATA_DIR       "/data/blescanner"
 #define BLE_DEVICE_LABELS_FILE     "/data/blescanner/labels.json"
-#define BLE_SCAN_LOG_FILE          "/logs/ble_scan.log"
-#define BLE_ANOMALY_LOG_FILE       "/logs/ble_anomalies.log"
+#define BLE_SIGHTING_LOG_FILE      "/logs/ble_sightings.bsl"
+#define BLE_SIGHTING_DICT_FILE     "/logs/ble_sightings.bsd"
+#define BLE_SIGHTING_LOG_MAX_SIZE  1048576 // Rotated at start-up beyond this
+#define BLE_LOG_SYNC_INTERVAL      60000   // Max ms a record waits in RAM
 #define BLE_CONFIG_FILE            "/settings/blescanner.cfg"
 
 // Icon data (16x16 pixels, 1-bit per pixel)
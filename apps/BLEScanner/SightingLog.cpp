@@ -0,0 +1,648 @@
+#include "SightingLog.h"
+#include "BLEDeviceTable.h"
+#include <stdio.h>
+#include <string.h>
+
+#define FNV_OFFSET              0xCBF29CE484222325ull
+#define FNV_PRIME               0x100000001B3ull
+
+#define DICT_ENTRY_HEAD         5        // id, kind, name length, label length
+#define DICT_BUCKET_MASK        (SIGHTING_DICT_BUCKETS - 1)
+
+static_assert(SIGHTING_DICT_CAPACITY < SIGHTING_DICT_BUCKETS, "Lookup table needs empty buckets");
+static_assert(DICT_ENTRY_HEAD + 2 * SIGHTING_TEXT_MAX <= SIGHTING_DICT_BUFFER, "Entry must fit the buffer");
+
+static const char* const eventNames[SIGHTING_EVENT_COUNT] = {
+    "NONE", "NEW_DEVICE", "ACTIVE", "USER_MARKED", "LABELED", "LABEL_REMOVED", "ANOMALY"
+};
+
+static uint8_t textLength(const char* text) {
+    if (!text) return 0;
+    size_t length = strlen(text);
+    return (uint8_t)(length > SIGHTING_TEXT_MAX ? SIGHTING_TEXT_MAX : length);
+}
+
+static uint64_t textKey(uint8_t kind, const char* name, uint8_t nameLength,
+                        const char* label, uint8_t labelLength) {
+    uint64_t hash = (FNV_OFFSET ^ kind) * FNV_PRIME;
+    for (uint8_t i = 0; i < nameLength; i++) hash = (hash ^ (uint8_t)name[i]) * FNV_PRIME;
+    // The separator keeps "ab"+"c" apart from "a"+"bc"
+    hash = (hash ^ 0xFF) * FNV_PRIME;
+    for (uint8_t i = 0; i < labelLength; i++) hash = (hash ^ (uint8_t)label[i]) * FNV_PRIME;
+    return hash ? hash : 1;
+}
+
+// ===== WRITER =====
+
+SightingLogWriter::SightingLogWriter() :
+    data(nullptr),
+    dictionary(nullptr),
+    blocks(nullptr),
+    blockFill(0),
+    recordFill(0),
+    lastTime(0),
+    sequence(0),
+    dictBuffer(nullptr),
+    dictFill(0),
+    textKeys(nullptr),
+    textIds(nullptr),
+    active(false),
+    failed(false)
+{
+    memset(&stats, 0, sizeof(stats));
+}
+
+SightingLogWriter::~SightingLogWriter() {
+    release();
+}
+
+bool SightingLogWriter::allocate() {
+    if (blocks && dictBuffer && textKeys && textIds) return true;
+
+    release();
+    blocks = new uint8_t[SIGHTING_LOG_BATCH_BLOCKS * SIGHTING_LOG_BLOCK_SIZE];
+    dictBuffer = new uint8_t[SIGHTING_DICT_BUFFER];
+    textKeys = new uint64_t[SIGHTING_DICT_BUCKETS];
+    textIds = new uint16_t[SIGHTING_DICT_BUCKETS];
+    if (!blocks || !dictBuffer || !textKeys || !textIds) {
+        release();
+        return false;
+    }
+    memset(textKeys, 0, sizeof(uint64_t) * SIGHTING_DICT_BUCKETS);
+    stats.texts = 0;
+    return true;
+}
+
+void SightingLogWriter::release() {
+    delete[] blocks;
+    delete[] dictBuffer;
+    delete[] textKeys;
+    delete[] textIds;
+    blocks = nullptr;
+    dictBuffer = nullptr;
+    textKeys = nullptr;
+    textIds = nullptr;
+    active = false;
+    data = nullptr;
+    dictionary = nullptr;
+}
+
+bool SightingLogWriter::loadDictionary(ByteStream* source) {
+    if (!source || !textKeys || active) return false;
+
+    memset(textKeys, 0, sizeof(uint64_t) * SIGHTING_DICT_BUCKETS);
+    stats.texts = 0;
+
+    SightingDictHeader header;
+    if (!source->seek(0) ||
+        source->read((uint8_t*)&header, sizeof(header)) != sizeof(header) ||
+        header.magic != SIGHTING_DICT_MAGIC || header.version != SIGHTING_LOG_VERSION) {
+        return false;
+    }
+
+    // Entries are read one at a time, straight into the lookup table
+    uint32_t end = source->size();
+    uint32_t position = sizeof(header);
+    char name[SIGHTING_TEXT_MAX];
+    char label[SIGHTING_TEXT_MAX];
+    while (position < end) {
+        uint8_t head[DICT_ENTRY_HEAD];
+        bool ok = source->read(head, sizeof(head)) == sizeof(head);
+        uint16_t id = (uint16_t)(head[0] | (head[1] << 8));
+        uint8_t nameLength = head[3];
+        uint8_t labelLength = head[4];
+        ok = ok && id == stats.texts + 1 && stats.texts < SIGHTING_DICT_CAPACITY &&
+             nameLength <= SIGHTING_TEXT_MAX && labelLength <= SIGHTING_TEXT_MAX;
+        ok = ok && source->read((uint8_t*)name, nameLength) == nameLength &&
+             source->read((uint8_t*)label, labelLength) == labelLength;
+        if (!ok) {
+            // A cut-off last entry would put every later id out of step
+            memset(textKeys, 0, sizeof(uint64_t) * SIGHTING_DICT_BUCKETS);
+            stats.texts = 0;
+            return false;
+        }
+
+        uint64_t key = textKey(head[2], name, nameLength, label, labelLength);
+        uint16_t bucket;
+        if (!findText(key, bucket)) {
+            textKeys[bucket] = key;
+            textIds[bucket] = id;
+        }
+        stats.texts = id;
+        position += DICT_ENTRY_HEAD + nameLength + labelLength;
+    }
+    return true;
+}
+
+bool SightingLogWriter::begin(ByteStream* logTarget, ByteStream* dictTarget) {
+    if (!logTarget || !dictTarget || !blocks) return false;
+
+    data = logTarget;
+    dictionary = dictTarget;
+    blockFill = 0;
+    recordFill = 0;
+    lastTime = 0;
+    sequence = 0;
+    dictFill = 0;
+
+    uint16_t texts = stats.texts;
+    memset(&stats, 0, sizeof(stats));
+    stats.texts = texts;
+    failed = false;
+    active = true;
+
+    if (dictionary->size() == 0) {
+        // A fresh dictionary; drop anything a failed load left behind
+        memset(textKeys, 0, sizeof(uint64_t) * SIGHTING_DICT_BUCKETS);
+        stats.texts = 0;
+
+        SightingDictHeader header;
+        header.magic = SIGHTING_DICT_MAGIC;
+        header.version = SIGHTING_LOG_VERSION;
+        header.reserved = 0;
+        memcpy(dictBuffer, &header, sizeof(header));
+        dictFill = sizeof(header);
+    }
+    return true;
+}
+
+bool SightingLogWriter::append(const SightingLogEntry& entry) {
+    if (!active || failed) return false;
+
+    // Deltas are 16 bits and never negative; anything else opens a block
+    if (recordFill > 0 && (entry.timestamp < lastTime || entry.timestamp - lastTime > 0xFFFF)) {
+        stats.blocksClosedEarly++;
+        closeBlock();
+        if (failed) return false;
+    }
+
+    uint8_t* block = blocks + (uint32_t)blockFill * SIGHTING_LOG_BLOCK_SIZE;
+    if (recordFill == 0) {
+        memset(block, 0, SIGHTING_LOG_BLOCK_SIZE);
+        SightingLogBlock header;
+        header.magic = SIGHTING_LOG_MAGIC;
+        header.baseTime = entry.timestamp;
+        header.sequence = sequence++;
+        header.version = SIGHTING_LOG_VERSION;
+        header.count = 0;
+        header.reserved = 0;
+        memcpy(block, &header, sizeof(header));
+        lastTime = entry.timestamp;
+    }
+
+    SightingLogRecord record;
+    record.delta = (uint16_t)(entry.timestamp - lastTime);
+    BLEDeviceTable::unpackMac(entry.mac, record.mac);
+    record.rssi = entry.rssi;
+    record.event = entry.event;
+    record.flags = entry.flags;
+    record.level = entry.level;
+    record.anomalies = entry.anomalies;
+    record.textId = entry.textId;
+    memcpy(block + sizeof(SightingLogBlock) + recordFill * sizeof(SightingLogRecord),
+           &record, sizeof(record));
+
+    recordFill++;
+    lastTime = entry.timestamp;
+    stats.records++;
+
+    if (recordFill == SIGHTING_LOG_BLOCK_RECORDS) closeBlock();
+    return !failed;
+}
+
+void SightingLogWriter::closeBlock() {
+    if (recordFill == 0) return;
+
+    uint8_t* block = blocks + (uint32_t)blockFill * SIGHTING_LOG_BLOCK_SIZE;
+    block[offsetof(SightingLogBlock, count)] = recordFill;
+    recordFill = 0;
+    blockFill++;
+    if (blockFill == SIGHTING_LOG_BATCH_BLOCKS) flush();
+}
+
+void SightingLogWriter::flush() {
+    // Texts go out before the blocks that refer to them
+    flushDictionary();
+    if (blockFill == 0 || failed) return;
+
+    uint32_t length = (uint32_t)blockFill * SIGHTING_LOG_BLOCK_SIZE;
+    if (data->write(blocks, length) != length) failed = true;
+
+    // One flush per batch, dictionary first: a power cut loses at most
+    // the batch being written
+    if (!failed && (!dictionary->flush() || !data->flush())) failed = true;
+    stats.blocks += blockFill;
+    stats.dataBytes += length;
+    stats.flushes++;
+    blockFill = 0;
+}
+
+void SightingLogWriter::flushDictionary() {
+    if (dictFill == 0 || failed) return;
+
+    if (dictionary->write(dictBuffer, dictFill) != dictFill) failed = true;
+    stats.dictionaryBytes += dictFill;
+    dictFill = 0;
+}
+
+bool SightingLogWriter::sync() {
+    if (!active) return false;
+    if (recordFill > 0) {
+        stats.blocksClosedEarly++;
+        closeBlock();
+    }
+    flush();
+    return !failed;
+}
+
+bool SightingLogWriter::end() {
+    if (!active) return false;
+    bool ok = sync();
+    active = false;
+    data = nullptr;
+    dictionary = nullptr;
+    return ok;
+}
+
+// ===== DICTIONARY =====
+
+bool SightingLogWriter::findText(uint64_t key, uint16_t& bucket) const {
+    uint16_t pos = (uint16_t)(key >> 48) & DICT_BUCKET_MASK;
+    while (textKeys[pos] != 0) {
+        if (textKeys[pos] == key) {
+            bucket = pos;
+            return true;
+        }
+        pos = (pos + 1) & DICT_BUCKET_MASK;
+    }
+    bucket = pos;
+    return false;
+}
+
+uint16_t SightingLogWriter::textId(uint8_t kind, const char* name, const char* label) {
+    if (!active) return 0;
+
+    uint8_t nameLength = textLength(name);
+    uint8_t labelLength = textLength(label);
+    if (nameLength == 0 && labelLength == 0) return 0;
+
+    uint64_t key = textKey(kind, name, nameLength, label, labelLength);
+    uint16_t bucket;
+    if (findText(key, bucket)) return textIds[bucket];
+
+    if (stats.texts >= SIGHTING_DICT_CAPACITY) {
+        stats.textsDropped++;
+        return 0;
+    }
+
+    uint16_t entryLength = DICT_ENTRY_HEAD + nameLength + labelLength;
+    if (dictFill + entryLength > SIGHTING_DICT_BUFFER) flushDictionary();
+
+    uint16_t id = ++stats.texts;
+    uint8_t* entry = dictBuffer + dictFill;
+    entry[0] = (uint8_t)id;
+    entry[1] = (uint8_t)(id >> 8);
+    entry[2] = kind;
+    entry[3] = nameLength;
+    entry[4] = labelLength;
+    if (nameLength > 0) memcpy(entry + DICT_ENTRY_HEAD, name, nameLength);
+    if (labelLength > 0) memcpy(entry + DICT_ENTRY_HEAD + nameLength, label, labelLength);
+    dictFill += entryLength;
+
+    textKeys[bucket] = key;
+    textIds[bucket] = id;
+    return id;
+}
+
+uint8_t SightingLogWriter::toLevel(float value) {
+    if (!(value > 0.0f)) return 0;
+    if (value >= 1.0f) return 255;
+    return (uint8_t)(value * 255.0f + 0.5f);
+}
+
+// ===== READER =====
+
+SightingLogReader::SightingLogReader() :
+    data(nullptr),
+    dictionary(nullptr),
+    block(nullptr),
+    textOffsets(nullptr),
+    cache(nullptr),
+    textCount(0),
+    blockCount(0),
+    nextBlock(0),
+    recordIndex(0),
+    recordCount(0),
+    time(0),
+    skippedBlocks(0)
+{
+}
+
+SightingLogReader::~SightingLogReader() {
+    close();
+}
+
+void SightingLogReader::releaseBuffers() {
+    delete[] block;
+    delete[] textOffsets;
+    delete[] cache;
+    block = nullptr;
+    textOffsets = nullptr;
+    cache = nullptr;
+}
+
+bool SightingLogReader::open(ByteStream* logSource, ByteStream* dictSource) {
+    close();
+    if (!logSource) return false;
+
+    block = new uint8_t[SIGHTING_LOG_BLOCK_SIZE];
+    textOffsets = new uint32_t[SIGHTING_DICT_CAPACITY];
+    cache = new SightingText[SIGHTING_TEXT_CACHE];
+    if (!block || !textOffsets || !cache) {
+        releaseBuffers();
+        return false;
+    }
+    for (uint8_t i = 0; i < SIGHTING_TEXT_CACHE; i++) cache[i].id = 0;
+
+    data = logSource;
+    dictionary = dictSource;
+    blockCount = data->size() / SIGHTING_LOG_BLOCK_SIZE;
+    skippedBlocks = 0;
+    textCount = 0;
+
+    // A damaged dictionary only costs the texts from the damage on
+    if (dictionary) indexDictionary();
+    return seekBlock(0);
+}
+
+void SightingLogReader::close() {
+    releaseBuffers();
+    data = nullptr;
+    dictionary = nullptr;
+    textCount = 0;
+    blockCount = 0;
+    nextBlock = 0;
+    recordIndex = 0;
+    recordCount = 0;
+}
+
+bool SightingLogReader::indexDictionary() {
+    SightingDictHeader header;
+    if (!dictionary->seek(0) ||
+        dictionary->read((uint8_t*)&header, sizeof(header)) != sizeof(header) ||
+        header.magic != SIGHTING_DICT_MAGIC || header.version != SIGHTING_LOG_VERSION) {
+        return false;
+    }
+
+    // Only offsets are kept; texts are read back when a record needs them
+    uint32_t end = dictionary->size();
+    uint32_t position = sizeof(header);
+    while (position + DICT_ENTRY_HEAD <= end && textCount < SIGHTING_DICT_CAPACITY) {
+        uint8_t head[DICT_ENTRY_HEAD];
+        if (!dictionary->seek(position) ||
+            dictionary->read(head, sizeof(head)) != sizeof(head)) return false;
+
+        uint16_t id = (uint16_t)(head[0] | (head[1] << 8));
+        uint32_t length = DICT_ENTRY_HEAD + head[3] + head[4];
+        if (id != textCount + 1 || head[3] > SIGHTING_TEXT_MAX || head[4] > SIGHTING_TEXT_MAX ||
+            position + length > end) return false;
+
+        textOffsets[textCount++] = position;
+        position += length;
+    }
+    return true;
+}
+
+bool SightingLogReader::seekBlock(uint32_t index) {
+    if (!data) return false;
+    nextBlock = index < blockCount ? index : blockCount;
+    recordIndex = 0;
+    recordCount = 0;
+    return true;
+}
+
+bool SightingLogReader::loadBlock() {
+    while (nextBlock < blockCount) {
+        uint32_t index = nextBlock++;
+        if (!data->seek(index * SIGHTING_LOG_BLOCK_SIZE) ||
+            data->read(block, SIGHTING_LOG_BLOCK_SIZE) != SIGHTING_LOG_BLOCK_SIZE) {
+            skippedBlocks += blockCount - index;
+            nextBlock = blockCount;
+            return false;
+        }
+
+        SightingLogBlock header;
+        memcpy(&header, block, sizeof(header));
+        if (header.magic != SIGHTING_LOG_MAGIC || header.version != SIGHTING_LOG_VERSION ||
+            header.count == 0 || header.count > SIGHTING_LOG_BLOCK_RECORDS) {
+            skippedBlocks++;
+            continue;
+        }
+
+        time = header.baseTime;
+        recordIndex = 0;
+        recordCount = header.count;
+        return true;
+    }
+    return false;
+}
+
+bool SightingLogReader::next(SightingLogEntry& entry) {
+    if (!data) return false;
+    if (recordIndex >= recordCount && !loadBlock()) return false;
+
+    SightingLogRecord record;
+    memcpy(&record, block + sizeof(SightingLogBlock) + recordIndex * sizeof(SightingLogRecord),
+           sizeof(record));
+    recordIndex++;
+
+    time += record.delta;
+    entry.timestamp = time;
+    entry.mac = BLEDeviceTable::packMac(record.mac);
+    entry.rssi = record.rssi;
+    entry.event = record.event;
+    entry.flags = record.flags;
+    entry.level = record.level;
+    entry.anomalies = record.anomalies;
+    entry.textId = record.textId;
+    return true;
+}
+
+const SightingText* SightingLogReader::text(uint16_t id) {
+    if (!dictionary || id == 0 || id > textCount) return nullptr;
+
+    SightingText& slot = cache[id & (SIGHTING_TEXT_CACHE - 1)];
+    if (slot.id == id) return &slot;
+
+    uint8_t head[DICT_ENTRY_HEAD];
+    slot.id = 0;
+    if (!dictionary->seek(textOffsets[id - 1]) ||
+        dictionary->read(head, sizeof(head)) != sizeof(head) ||
+        head[3] > SIGHTING_TEXT_MAX || head[4] > SIGHTING_TEXT_MAX ||
+        dictionary->read((uint8_t*)slot.name, head[3]) != head[3] ||
+        dictionary->read((uint8_t*)slot.label, head[4]) != head[4]) {
+        return nullptr;
+    }
+    slot.name[head[3]] = '\0';
+    slot.label[head[4]] = '\0';
+    slot.kind = head[2];
+    slot.id = id;
+    return &slot;
+}
+
+const char* SightingLogReader::eventName(uint8_t event) {
+    return event < SIGHTING_EVENT_COUNT ? eventNames[event] : "UNKNOWN";
+}
+
+// ===== EXPORTER =====
+
+SightingLogExporter::SightingLogExporter() :
+    reader(nullptr),
+    out(nullptr),
+    buffer(nullptr),
+    fill(0),
+    format(SIGHTING_EXPORT_JSON),
+    records(0),
+    bytes(0),
+    failed(false)
+{
+}
+
+SightingLogExporter::~SightingLogExporter() {
+    delete[] buffer;
+}
+
+bool SightingLogExporter::begin(SightingLogReader* source, ByteStream* target,
+                                uint8_t exportFormat) {
+    if (!source || !source->isOpen() || !target) return false;
+    if (!buffer) {
+        buffer = new char[SIGHTING_EXPORT_BUFFER];
+        if (!buffer) return false;
+    }
+
+    reader = source;
+    out = target;
+    format = exportFormat;
+    fill = 0;
+    records = 0;
+    bytes = 0;
+    failed = false;
+
+    if (format == SIGHTING_EXPORT_CSV) {
+        emit("timestamp,mac,event,rssi,flags,randomized,anomalies,entropy,severity,name,label,note\n");
+    } else {
+        emit("[\n");
+    }
+    return !failed;
+}
+
+bool SightingLogExporter::next() {
+    if (!reader || failed) return false;
+
+    SightingLogEntry entry;
+    if (!reader->next(entry)) return false;
+
+    char mac[BLE_MAC_STRING_LENGTH];
+    BLEDeviceTable::formatMac(entry.mac, mac);
+    const SightingText* text = reader->text(entry.textId);
+    const char* name = (text && text->kind == SIGHTING_TEXT_DEVICE) ? text->name : "";
+    const char* label = (text && text->kind == SIGHTING_TEXT_DEVICE) ? text->label : "";
+    const char* note = (text && text->kind == SIGHTING_TEXT_NOTE) ? text->name : "";
+    bool anomaly = (entry.event == SIGHTING_EVENT_ANOMALY);
+    float level = SightingLogReader::fromLevel(entry.level);
+    bool randomized = (entry.flags & SIGHTING_FLAG_RANDOMIZED) != 0;
+    uint8_t status = entry.flags & SIGHTING_FLAG_STATUS_MASK;
+
+    char line[160];
+    int length;
+    if (format == SIGHTING_EXPORT_CSV) {
+        length = snprintf(line, sizeof(line), "%lu,%s,%s,%d,%u,%u,%u,",
+                          (unsigned long)entry.timestamp, mac,
+                          SightingLogReader::eventName(entry.event), entry.rssi,
+                          status, randomized ? 1 : 0, entry.anomalies);
+        emit(line, length);
+        length = snprintf(line, sizeof(line), anomaly ? ",%.3f," : "%.3f,,", level);
+        emit(line, length);
+        emitQuoted(name);
+        emit(",");
+        emitQuoted(label);
+        emit(",");
+        emitQuoted(note);
+        emit("\n");
+    } else {
+        length = snprintf(line, sizeof(line),
+                          "%s{\"timestamp\":%lu,\"mac\":\"%s\",\"event\":\"%s\",\"rssi\":%d,"
+                          "\"flags\":%u,\"randomized\":%s,\"anomalies\":%u,\"%s\":%.3f",
+                          records > 0 ? ",\n" : "", (unsigned long)entry.timestamp, mac,
+                          SightingLogReader::eventName(entry.event), entry.rssi, status,
+                          randomized ? "true" : "false", entry.anomalies,
+                          anomaly ? "severity" : "entropy", level);
+        emit(line, length);
+        if (name[0]) { emit(",\"name\":"); emitQuoted(name); }
+        if (label[0]) { emit(",\"label\":"); emitQuoted(label); }
+        if (note[0]) { emit(",\"note\":"); emitQuoted(note); }
+        emit("}");
+    }
+
+    records++;
+    return !failed;
+}
+
+bool SightingLogExporter::end() {
+    if (!out) return false;
+    if (format != SIGHTING_EXPORT_CSV) emit(records > 0 ? "\n]\n" : "]\n");
+    flush();
+
+    delete[] buffer;
+    buffer = nullptr;
+    reader = nullptr;
+    out = nullptr;
+    return !failed;
+}
+
+void SightingLogExporter::emit(const char* text, size_t length) {
+    while (length > 0 && !failed) {
+        size_t space = SIGHTING_EXPORT_BUFFER - fill;
+        size_t n = length < space ? length : space;
+        memcpy(buffer + fill, text, n);
+        fill += n;
+        text += n;
+        length -= n;
+        if (fill == SIGHTING_EXPORT_BUFFER) flush();
+    }
+}
+
+void SightingLogExporter::emit(const char* text) {
+    emit(text, strlen(text));
+}
+
+void SightingLogExporter::emitQuoted(const char* text) {
+    // CSV fields are always quoted with quotes doubled; JSON strings escape
+    // quotes, backslashes and control characters
+    bool csv = (format == SIGHTING_EXPORT_CSV);
+    emit("\"", 1);
+    for (const char* c = text; *c; c++) {
+        uint8_t ch = (uint8_t)*c;
+        if (csv) {
+            if (ch == '"') emit("\"", 1);
+            emit(c, 1);
+        } else if (ch == '"' || ch == '\\') {
+            char escaped[2] = { '\\', (char)ch };
+            emit(escaped, 2);
+        } else if (ch < 0x20) {
+            char escaped[8];
+            int length = snprintf(escaped, sizeof(escaped), "\\u%04x", ch);
+            emit(escaped, length);
+        } else {
+            emit(c, 1);
+        }
+    }
+    emit("\"", 1);
+}
+
+void SightingLogExporter::flush() {
+    if (fill == 0 || failed) return;
+    if (out->write((const uint8_t*)buffer, fill) != fill) failed = true;
+    bytes += fill;
+    fill = 0;
+}
@@ -0,0 +1,251 @@
+#ifndef SIGHTING_LOG_H
+#define SIGHTING_LOG_H
+
+#include <stdint.h>
+#include <stddef.h>
+#include "../../core/Streams/ByteStream.h"
+
+// ========================================
+// SightingLog - Compact binary log of BLEScanner sightings and anomalies
+// Layout (little endian):
+//   log file      512-byte blocks, each SightingLogBlock header and up to
+//                 31 fixed 16-byte records; unused records are zero.
+//                 Record times are ms deltas from the previous record, so
+//                 a gap that does not fit 16 bits starts a new block.
+//   dictionary    SightingDictHeader, then entries appended as texts are
+//                 first used: uint16 id, uint8 kind, uint8 name length,
+//                 uint8 label length, name bytes, label bytes. Ids count
+//                 up from 1; records refer to them, 0 meaning none.
+// The writer buffers whole blocks and hands the stream a batch at a time,
+// dictionary entries first, and flushes both streams once per batch, so
+// a block never names a text that is not on the card. The reader and
+// exporter walk the log one block at a time and fetch texts by offset,
+// so neither loads a file into RAM.
+// Hardware independent: I/O goes through ByteStream.
+// ========================================
+
+#define SIGHTING_LOG_MAGIC          STREAM_FOURCC('B', 'S', 'L', 'B')
+#define SIGHTING_DICT_MAGIC         STREAM_FOURCC('B', 'S', 'L', 'D')
+#define SIGHTING_LOG_VERSION        1
+
+#define SIGHTING_LOG_BLOCK_SIZE     512
+#define SIGHTING_LOG_BLOCK_RECORDS  31
+#define SIGHTING_LOG_BATCH_BLOCKS   4        // Blocks buffered per write
+#define SIGHTING_DICT_CAPACITY      768      // Texts per dictionary
+#define SIGHTING_DICT_BUCKETS       1024     // Text lookup table, power of two
+#define SIGHTING_DICT_BUFFER        512      // Entries buffered per write
+#define SIGHTING_TEXT_MAX           48       // Longer names and labels are cut
+#define SIGHTING_TEXT_CACHE         8        // Texts the reader keeps, power of two
+#define SIGHTING_EXPORT_BUFFER      512      // Exporter output buffer
+
+// Record events
+enum SightingLogEvent : uint8_t {
+    SIGHTING_EVENT_NONE,
+    SIGHTING_EVENT_NEW_DEVICE,
+    SIGHTING_EVENT_ACTIVE,
+    SIGHTING_EVENT_USER_MARKED,
+    SIGHTING_EVENT_LABELED,
+    SIGHTING_EVENT_LABEL_REMOVED,
+    SIGHTING_EVENT_ANOMALY,      // anomalies holds the type, level the severity
+    SIGHTING_EVENT_COUNT
+};
+
+// Dictionary text kinds
+enum SightingTextKind : uint8_t {
+    SIGHTING_TEXT_DEVICE = 1,    // Device name and label
+    SIGHTING_TEXT_NOTE = 2       // Anomaly description, in name
+};
+
+// Record flags: the low bits carry the app's device status flags
+#define SIGHTING_FLAG_STATUS_MASK   0x7F
+#define SIGHTING_FLAG_RANDOMIZED    0x80     // MAC looked randomized
+
+enum SightingExportFormat : uint8_t {
+    SIGHTING_EXPORT_JSON,
+    SIGHTING_EXPORT_CSV
+};
+
+struct SightingLogBlock {
+    uint32_t magic;
+    uint32_t baseTime;            // ms, device clock of the first record
+    uint32_t sequence;            // Block number since the writer began
+    uint8_t version;
+    uint8_t count;                // Records used
+    uint16_t reserved;
+};
+
+struct SightingLogRecord {
+    uint16_t delta;               // ms after the previous record in the block
+    uint8_t mac[6];               // Most significant octet first
+    int8_t rssi;
+    uint8_t event;                // SightingLogEvent
+    uint8_t flags;
+    uint8_t level;                // 0..255 for 0..1: severity or entropy
+    uint16_t anomalies;
+    uint16_t textId;              // Dictionary entry, 0 for none
+};
+
+struct SightingDictHeader {
+    uint32_t magic;
+    uint16_t version;
+    uint16_t reserved;
+};
+
+static_assert(sizeof(SightingLogBlock) == 16, "Block header layout changed");
+static_assert(sizeof(SightingLogRecord) == 16, "Record layout changed");
+static_assert(sizeof(SightingLogBlock) + SIGHTING_LOG_BLOCK_RECORDS * sizeof(SightingLogRecord)
+              <= SIGHTING_LOG_BLOCK_SIZE, "Records must fit one block");
+
+// A record with its absolute time and MAC
+struct SightingLogEntry {
+    uint32_t timestamp;           // ms, device clock
+    uint64_t mac;                 // Packed, see BLEDeviceTable
+    int8_t rssi;
+    uint8_t event;
+    uint8_t flags;
+    uint8_t level;
+    uint16_t anomalies;
+    uint16_t textId;
+};
+
+struct SightingText {
+    uint16_t id;                  // 0: empty cache slot
+    uint8_t kind;
+    char name[SIGHTING_TEXT_MAX + 1];
+    char label[SIGHTING_TEXT_MAX + 1];
+};
+
+struct SightingLogStats {
+    uint32_t records;
+    uint32_t blocks;              // Written, including ones closed early
+    uint32_t flushes;
+    uint32_t dataBytes;
+    uint32_t dictionaryBytes;
+    uint32_t blocksClosedEarly;   // Time gap or sync
+    uint16_t texts;               // Entries in the dictionary
+    uint16_t textsDropped;        // New texts refused by a full dictionary
+};
+
+class SightingLogWriter {
+private:
+    ByteStream* data;
+    ByteStream* dictionary;
+    uint8_t* blocks;              // SIGHTING_LOG_BATCH_BLOCKS blocks
+    uint8_t blockFill;            // Complete blocks in the buffer
+    uint8_t recordFill;           // Records in the open block
+    uint32_t lastTime;
+    uint32_t sequence;
+    uint8_t* dictBuffer;          // SIGHTING_DICT_BUFFER
+    uint16_t dictFill;
+    uint64_t* textKeys;           // SIGHTING_DICT_BUCKETS, 0 empty
+    uint16_t* textIds;
+    SightingLogStats stats;
+    bool active;
+    bool failed;
+
+    void closeBlock();
+    void flush();
+    void flushDictionary();
+    bool findText(uint64_t key, uint16_t& bucket) const;
+
+public:
+    SightingLogWriter();
+    ~SightingLogWriter();
+
+    bool allocate();
+    void release();
+
+    // Rebuilds the text table from an existing dictionary so its ids stay
+    // valid. False, with an empty table, if the file is damaged; the
+    // caller then has to start a new dictionary.
+    bool loadDictionary(ByteStream* source);
+    // Both streams append; an empty dictionary gets its header here
+    bool begin(ByteStream* logTarget, ByteStream* dictTarget);
+    bool append(const SightingLogEntry& entry);
+    // Id for a text, adding it if new. 0 when empty or the dictionary is full.
+    uint16_t textId(uint8_t kind, const char* name, const char* label);
+    // Closes the open block and writes everything buffered
+    bool sync();
+    bool end();
+
+    bool isActive() const { return active; }
+    bool hasFailed() const { return failed; }
+    bool hasPending() const { return recordFill > 0 || blockFill > 0 || dictFill > 0; }
+    bool isDictionaryFull() const { return stats.texts >= SIGHTING_DICT_CAPACITY; }
+    const SightingLogStats& getStats() const { return stats; }
+
+    static uint8_t toLevel(float value);
+};
+
+class SightingLogReader {
+private:
+    ByteStream* data;
+    ByteStream* dictionary;
+    uint8_t* block;               // SIGHTING_LOG_BLOCK_SIZE
+    uint32_t* textOffsets;        // Per id, SIGHTING_DICT_CAPACITY
+    SightingText* cache;          // SIGHTING_TEXT_CACHE, by id
+    uint16_t textCount;
+    uint32_t blockCount;
+    uint32_t nextBlock;
+    uint8_t recordIndex;
+    uint8_t recordCount;
+    uint32_t time;
+    uint32_t skippedBlocks;
+
+    bool loadBlock();
+    bool indexDictionary();
+    void releaseBuffers();
+
+public:
+    SightingLogReader();
+    ~SightingLogReader();
+
+    // dictSource may be null; records then have no texts
+    bool open(ByteStream* logSource, ByteStream* dictSource);
+    void close();
+    bool seekBlock(uint32_t index);
+    bool next(SightingLogEntry& entry);
+    // Null for id 0, unknown ids and read errors; valid until the next call
+    const SightingText* text(uint16_t id);
+
+    bool isOpen() const { return data != nullptr; }
+    uint32_t getBlockCount() const { return blockCount; }
+    uint32_t getSkippedBlocks() const { return skippedBlocks; }
+    uint16_t getTextCount() const { return textCount; }
+
+    static const char* eventName(uint8_t event);
+    static float fromLevel(uint8_t level) { return level / 255.0f; }
+};
+
+// Streams a log as JSON (an array, one object per line) or CSV
+class SightingLogExporter {
+private:
+    SightingLogReader* reader;
+    ByteStream* out;
+    char* buffer;                 // SIGHTING_EXPORT_BUFFER
+    uint16_t fill;
+    uint8_t format;
+    uint32_t records;
+    uint32_t bytes;
+    bool failed;
+
+    void emit(const char* text, size_t length);
+    void emit(const char* text);
+    void emitQuoted(const char* text);
+    void flush();
+
+public:
+    SightingLogExporter();
+    ~SightingLogExporter();
+
+    bool begin(SightingLogReader* source, ByteStream* target, uint8_t exportFormat);
+    // Exports one record; false at the end of the log
+    bool next();
+    bool end();
+
+    uint32_t getRecords() const { return records; }
+    uint32_t getBytes() const { return bytes; }
+    bool hasFailed() const { return failed; }
+};
+
+#endif // SIGHTING_LOG_H
@@ -0,0 +1,43 @@
+#include "SightingRecord.h"
+#include <string.h>
+
+// AD types carrying the local name
+#define AD_TYPE_SHORT_NAME      0x08
+#define AD_TYPE_COMPLETE_NAME   0x09
+
+void copyAdvertisement(SightingRecord& record, const uint8_t* data, size_t length) {
+    record.flags &= ~(SIGHTING_HAS_NAME | SIGHTING_NAME_CUT | SIGHTING_PAYLOAD_CUT);
+    record.name[0] = '\0';
+
+    uint8_t kept = (length > SIGHTING_PAYLOAD_MAX) ? SIGHTING_PAYLOAD_MAX : (uint8_t)length;
+    if (data && kept > 0) memcpy(record.payload, data, kept);
+    record.payloadLength = data ? kept : 0;
+    if (data && length > SIGHTING_PAYLOAD_MAX) record.flags |= SIGHTING_PAYLOAD_CUT;
+    if (!data) return;
+
+    // The name may sit in the scan response past the kept payload, so
+    // walk the whole buffer. A complete name wins over a shortened one.
+    size_t pos = 0;
+    bool complete = false;
+    while (pos + 1 < length && !complete) {
+        uint8_t fieldLength = data[pos];
+        if (fieldLength == 0 || pos + 1 + fieldLength > length) break;
+
+        uint8_t type = data[pos + 1];
+        if (type == AD_TYPE_COMPLETE_NAME ||
+            (type == AD_TYPE_SHORT_NAME && !(record.flags & SIGHTING_HAS_NAME))) {
+            uint8_t nameLength = fieldLength - 1;
+            uint8_t copied = (nameLength > SIGHTING_NAME_LENGTH) ? SIGHTING_NAME_LENGTH : nameLength;
+            memcpy(record.name, &data[pos + 2], copied);
+            record.name[copied] = '\0';
+            record.flags |= SIGHTING_HAS_NAME;
+            if (nameLength > SIGHTING_NAME_LENGTH) {
+                record.flags |= SIGHTING_NAME_CUT;
+            } else {
+                record.flags &= ~SIGHTING_NAME_CUT;
+            }
+            complete = (type == AD_TYPE_COMPLETE_NAME);
+        }
+        pos += 1 + fieldLength;
+    }
+}
@@ -0,0 +1,42 @@
+#ifndef SIGHTING_RECORD_H
+#define SIGHTING_RECORD_H
+
+#include <stdint.h>
+#include <stddef.h>
+#include "../../core/Queues/SpscRing.h"
+
+// ========================================
+// SightingRecord - One advertisement as handed from the BLE stack's task
+// to the app loop through an SpscRing. The callback fills the record in
+// place in the reserved slot, so nothing is allocated per sighting; the
+// app loop drains committed records in batches. Hardware independent.
+// ========================================
+
+#define SIGHTING_QUEUE_SIZE     128      // Records in the ring, power of two
+#define SIGHTING_DRAIN_BATCH    32       // Records taken per batch
+#define SIGHTING_NAME_LENGTH    20       // Name bytes kept; longer names are cut
+#define SIGHTING_PAYLOAD_MAX    31       // Legacy advertising PDU data
+
+// Record flags
+#define SIGHTING_HAS_RSSI       0x01
+#define SIGHTING_HAS_NAME       0x02
+#define SIGHTING_NAME_CUT       0x04     // Name longer than SIGHTING_NAME_LENGTH
+#define SIGHTING_PAYLOAD_CUT    0x08     // Payload (with scan response) over SIGHTING_PAYLOAD_MAX
+
+struct SightingRecord {
+    uint64_t mac;                // Packed, see BLEDeviceTable
+    uint32_t timestamp;          // ms, when the stack reported it
+    uint32_t sequence;           // Producer count, including drops
+    int8_t rssi;
+    uint8_t addressType;         // As reported by the stack
+    uint8_t flags;
+    uint8_t payloadLength;
+    char name[SIGHTING_NAME_LENGTH + 1];
+    uint8_t payload[SIGHTING_PAYLOAD_MAX];
+};
+
+// Fills payload, payloadLength, name and the name/payload flags from a
+// raw advertisement (AD structures), without allocating
+void copyAdvertisement(SightingRecord& record, const uint8_t* data, size_t length);
+
+#endif // SIGHTING_RECORD_H
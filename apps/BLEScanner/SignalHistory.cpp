@@ -0,0 +1,153 @@
+#include "SignalHistory.h"
+#include <math.h>
+#include <string.h>
+
+// ===== RSSI HISTORY =====
+
+void RSSIHistory::reset() {
+    memset(values, 0, sizeof(values));
+    head = 0;
+    count = 0;
+    sum = 0;
+    sumSquares = 0;
+    minFront = minCount = 0;
+    maxFront = maxCount = 0;
+    mean = 0.0f;
+    variance = 0.0f;
+    standardDeviation = 0.0f;
+    min = 0;
+    max = 0;
+    lastUpdated = 0;
+}
+
+void RSSIHistory::addValue(int8_t rssi, unsigned long now) {
+    uint8_t pos = head;
+
+    if (count == RSSI_HISTORY_SIZE) {
+        // The oldest reading leaves; if it was an extreme it is at the front
+        int8_t old = values[pos];
+        sum -= old;
+        sumSquares -= (int32_t)old * old;
+        if (minCount > 0 && minQueue[minFront] == pos) {
+            minFront = (minFront + 1) % RSSI_HISTORY_SIZE;
+            minCount--;
+        }
+        if (maxCount > 0 && maxQueue[maxFront] == pos) {
+            maxFront = (maxFront + 1) % RSSI_HISTORY_SIZE;
+            maxCount--;
+        }
+    } else {
+        count++;
+    }
+
+    values[pos] = rssi;
+    sum += rssi;
+    sumSquares += (int32_t)rssi * rssi;
+    head = (head + 1) % RSSI_HISTORY_SIZE;
+
+    // Readings the new one dominates can never be the extreme again
+    while (minCount > 0 &&
+           values[minQueue[(minFront + minCount - 1) % RSSI_HISTORY_SIZE]] >= rssi) {
+        minCount--;
+    }
+    minQueue[(minFront + minCount) % RSSI_HISTORY_SIZE] = pos;
+    minCount++;
+
+    while (maxCount > 0 &&
+           values[maxQueue[(maxFront + maxCount - 1) % RSSI_HISTORY_SIZE]] <= rssi) {
+        maxCount--;
+    }
+    maxQueue[(maxFront + maxCount) % RSSI_HISTORY_SIZE] = pos;
+    maxCount++;
+
+    // n * sum(x^2) - sum(x)^2 is exact in integers, so the variance has
+    // no cancellation error however long the device is tracked
+    int32_t spread = (int32_t)count * sumSquares - (int32_t)sum * sum;
+    mean = (float)sum / count;
+    variance = (float)spread / ((float)count * count);
+    standardDeviation = sqrtf(variance);
+    min = values[minQueue[minFront]];
+    max = values[maxQueue[maxFront]];
+
+    lastUpdated = now;
+}
+
+bool RSSIHistory::isOutlier(int8_t rssi) const {
+    if (count < 3) return false;
+    return fabsf(rssi - mean) > (2.0f * standardDeviation);
+}
+
+int8_t RSSIHistory::get(uint8_t index) const {
+    uint8_t oldest = (count < RSSI_HISTORY_SIZE) ? 0 : head;
+    return values[(oldest + index) % RSSI_HISTORY_SIZE];
+}
+
+// ===== APPEARANCE HISTORY =====
+
+void AppearanceHistory::reset() {
+    memset(intervals, 0, sizeof(intervals));
+    memset(buckets, 0, sizeof(buckets));
+    head = 0;
+    count = 0;
+    sum = 0;
+    sumSquares = 0;
+    lastAppearance = 0;
+    seen = false;
+}
+
+void AppearanceHistory::addAppearance(unsigned long now) {
+    if (!seen) {
+        seen = true;
+        lastAppearance = now;
+        return;
+    }
+
+    uint32_t interval = now - lastAppearance;
+    if (interval > APPEARANCE_MAX_INTERVAL_MS) interval = APPEARANCE_MAX_INTERVAL_MS;
+    lastAppearance = now;
+
+    if (count == APPEARANCE_INTERVALS) {
+        uint32_t old = intervals[head];
+        sum -= old;
+        sumSquares -= (uint64_t)old * old;
+        buckets[bucketFor(old)]--;
+    } else {
+        count++;
+    }
+
+    intervals[head] = interval;
+    sum += interval;
+    sumSquares += (uint64_t)interval * interval;
+    buckets[bucketFor(interval)]++;
+    head = (head + 1) % APPEARANCE_INTERVALS;
+}
+
+float AppearanceHistory::getMean() const {
+    return count > 0 ? (float)sum / count : 0.0f;
+}
+
+float AppearanceHistory::getStandardDeviation() const {
+    if (count == 0) return 0.0f;
+    uint64_t spread = (uint64_t)count * sumSquares - (uint64_t)sum * sum;
+    return sqrtf((float)spread) / count;
+}
+
+uint8_t AppearanceHistory::countBelow(uint32_t ms) const {
+    uint8_t total = 0;
+    uint32_t bound = APPEARANCE_BUCKET_BASE_MS;
+    for (uint8_t b = 0; b < APPEARANCE_BUCKETS - 1 && bound <= ms; b++) {
+        total += buckets[b];
+        bound <<= 1;
+    }
+    return total;
+}
+
+uint8_t AppearanceHistory::bucketFor(uint32_t interval) {
+    uint8_t bucket = 0;
+    uint32_t bound = APPEARANCE_BUCKET_BASE_MS;
+    while (bucket < APPEARANCE_BUCKETS - 1 && interval >= bound) {
+        bucket++;
+        bound <<= 1;
+    }
+    return bucket;
+}
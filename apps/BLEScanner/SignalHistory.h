@@ -0,0 +1,80 @@
+#ifndef SIGNAL_HISTORY_H
+#define SIGNAL_HISTORY_H
+
+#include <stdint.h>
+
+// ========================================
+// SignalHistory - Fixed-size per-device sighting history. RSSIHistory
+// keeps the last RSSI_HISTORY_SIZE readings in an inline ring. Exact
+// integer running sums give the mean and variance, and monotonic queues
+// give the window min and max, so each reading costs O(1) and no heap.
+// AppearanceHistory does the same for the gaps between sightings and
+// also keeps a histogram of them, so the timing checks read counts
+// instead of walking timestamps. Hardware independent.
+// ========================================
+
+#define RSSI_HISTORY_SIZE           20       // Readings in the window
+#define APPEARANCE_INTERVALS        19       // Gaps between the last 20 sightings
+#define APPEARANCE_BUCKETS          8        // Gap histogram, doubling from the base
+#define APPEARANCE_BUCKET_BASE_MS   250      // Upper bound of the first bucket
+#define APPEARANCE_MAX_INTERVAL_MS  3600000  // Longer gaps are clamped; keeps sums exact
+
+// RSSI readings over a sliding window
+struct RSSIHistory {
+    int8_t values[RSSI_HISTORY_SIZE];   // Ring, oldest at head once full
+    uint8_t head;                       // Next position to write
+    uint8_t count;
+    int16_t sum;
+    int32_t sumSquares;
+
+    // Window positions with increasing (min) or decreasing (max) values;
+    // the front is the current extreme
+    uint8_t minQueue[RSSI_HISTORY_SIZE];
+    uint8_t maxQueue[RSSI_HISTORY_SIZE];
+    uint8_t minFront, minCount;
+    uint8_t maxFront, maxCount;
+
+    float mean;
+    float variance;
+    float standardDeviation;
+    int8_t min;
+    int8_t max;
+    unsigned long lastUpdated;
+
+    RSSIHistory() { reset(); }
+
+    void reset();
+    void addValue(int8_t rssi, unsigned long now);
+    bool isOutlier(int8_t rssi) const;
+
+    uint8_t size() const { return count; }
+    // index 0 is the oldest reading
+    int8_t get(uint8_t index) const;
+};
+
+// Gaps between sightings over a sliding window
+struct AppearanceHistory {
+    uint32_t intervals[APPEARANCE_INTERVALS];   // ms, ring
+    uint8_t head;
+    uint8_t count;
+    uint8_t buckets[APPEARANCE_BUCKETS];        // Gaps in the window per bucket
+    uint32_t sum;
+    uint64_t sumSquares;
+    unsigned long lastAppearance;
+    bool seen;
+
+    AppearanceHistory() { reset(); }
+
+    void reset();
+    void addAppearance(unsigned long now);
+
+    uint8_t size() const { return count; }
+    float getMean() const;
+    float getStandardDeviation() const;
+    // Gaps in the window shorter than ms, rounded down to a bucket boundary
+    uint8_t countBelow(uint32_t ms) const;
+
+    static uint8_t bucketFor(uint32_t interval);
+};
+
+#endif // SIGNAL_HISTORY_H
@@ -0,0 +1,277 @@
+#include "SpoofIndex.h"
+#include <string.h>
+
+#define FNV_OFFSET              0xCBF29CE484222325ull
+#define FNV_PRIME               0x100000001B3ull
+
+// AD types that identify what a device is rather than what it says now
+#define AD_TYPE_UUID_FIRST      0x02     // Incomplete 16-bit UUID list
+#define AD_TYPE_UUID_LAST       0x07     // Complete 128-bit UUID list
+#define AD_TYPE_MANUFACTURER    0xFF
+
+static inline uint64_t fnvByte(uint64_t hash, uint8_t byte) {
+    return (hash ^ byte) * FNV_PRIME;
+}
+
+SpoofIndex::SpoofIndex() :
+    generations(nullptr),
+    reported(nullptr),
+    reportedCount(0),
+    capacity(0),
+    bucketMask(0)
+{
+    for (uint8_t k = 0; k < SPOOF_KEY_COUNT; k++) {
+        heads[k] = nullptr;
+        nextSlot[k] = nullptr;
+        prevSlot[k] = nullptr;
+        keys[k] = nullptr;
+    }
+    memset(&stats, 0, sizeof(stats));
+}
+
+SpoofIndex::~SpoofIndex() {
+    release();
+}
+
+bool SpoofIndex::begin(uint16_t slotCount) {
+    if (slotCount == 0 || slotCount >= SPOOF_NO_SLOT / 2) return false;
+    release();
+
+    uint32_t bucketCount = 1;
+    while (bucketCount < (uint32_t)slotCount * 2) bucketCount <<= 1;
+
+    bool ok = true;
+    for (uint8_t k = 0; k < SPOOF_KEY_COUNT; k++) {
+        heads[k] = new uint16_t[bucketCount];
+        nextSlot[k] = new uint16_t[slotCount];
+        prevSlot[k] = new uint16_t[slotCount];
+        keys[k] = new uint64_t[slotCount];
+        ok = ok && heads[k] && nextSlot[k] && prevSlot[k] && keys[k];
+    }
+    generations = new uint16_t[slotCount];
+    reported = new uint64_t[bucketCount];
+    if (!ok || !generations || !reported) {
+        release();
+        return false;
+    }
+
+    capacity = slotCount;
+    bucketMask = (uint16_t)(bucketCount - 1);
+    clear();
+    return true;
+}
+
+void SpoofIndex::release() {
+    for (uint8_t k = 0; k < SPOOF_KEY_COUNT; k++) {
+        delete[] heads[k];
+        delete[] nextSlot[k];
+        delete[] prevSlot[k];
+        delete[] keys[k];
+        heads[k] = nullptr;
+        nextSlot[k] = nullptr;
+        prevSlot[k] = nullptr;
+        keys[k] = nullptr;
+    }
+    delete[] generations;
+    delete[] reported;
+    generations = nullptr;
+    reported = nullptr;
+    reportedCount = 0;
+    capacity = 0;
+    bucketMask = 0;
+}
+
+void SpoofIndex::clear() {
+    if (!reported) return;
+
+    for (uint8_t k = 0; k < SPOOF_KEY_COUNT; k++) {
+        memset(heads[k], 0xFF, sizeof(uint16_t) * ((uint32_t)bucketMask + 1));
+        memset(nextSlot[k], 0xFF, sizeof(uint16_t) * capacity);
+        memset(prevSlot[k], 0xFF, sizeof(uint16_t) * capacity);
+        memset(keys[k], 0, sizeof(uint64_t) * capacity);
+    }
+    memset(generations, 0, sizeof(uint16_t) * capacity);
+    memset(reported, 0, sizeof(uint64_t) * ((uint32_t)bucketMask + 1));
+    reportedCount = 0;
+    memset(&stats, 0, sizeof(stats));
+}
+
+// ===== CHAINS =====
+
+uint16_t SpoofIndex::bucketOf(uint64_t key) const {
+    uint32_t h = (uint32_t)key ^ (uint32_t)(key >> 32);
+    h *= 0x9E3779B1u;
+    return (uint16_t)((h >> 16) & bucketMask);
+}
+
+void SpoofIndex::link(uint8_t kind, uint16_t slot, uint64_t key) {
+    uint16_t bucket = bucketOf(key);
+    uint16_t head = heads[kind][bucket];
+    nextSlot[kind][slot] = head;
+    prevSlot[kind][slot] = SPOOF_NO_SLOT;
+    if (head != SPOOF_NO_SLOT) prevSlot[kind][head] = slot;
+    heads[kind][bucket] = slot;
+    keys[kind][slot] = key;
+}
+
+void SpoofIndex::unlink(uint8_t kind, uint16_t slot) {
+    uint64_t key = keys[kind][slot];
+    if (key == 0) return;
+
+    uint16_t prev = prevSlot[kind][slot];
+    uint16_t next = nextSlot[kind][slot];
+    if (prev != SPOOF_NO_SLOT) {
+        nextSlot[kind][prev] = next;
+    } else {
+        heads[kind][bucketOf(key)] = next;
+    }
+    if (next != SPOOF_NO_SLOT) prevSlot[kind][next] = prev;
+
+    nextSlot[kind][slot] = SPOOF_NO_SLOT;
+    prevSlot[kind][slot] = SPOOF_NO_SLOT;
+    keys[kind][slot] = 0;
+}
+
+void SpoofIndex::setKey(uint8_t kind, uint16_t slot, uint64_t key) {
+    if (!reported || kind >= SPOOF_KEY_COUNT || slot >= capacity) return;
+    if (keys[kind][slot] == key) return;
+
+    unlink(kind, slot);
+    if (key != 0) link(kind, slot, key);
+    stats.relinks++;
+}
+
+void SpoofIndex::remove(uint16_t slot) {
+    if (!reported || slot >= capacity) return;
+    for (uint8_t k = 0; k < SPOOF_KEY_COUNT; k++) {
+        unlink(k, slot);
+    }
+    // The next device in this slot starts with no reported pairs
+    forgetPairs(slot);
+}
+
+// ===== REPORTED PAIRS =====
+
+// A pair key packs both slots with their generations, lower slot first:
+// slot:16 generation:16 slot:16 generation:16. The higher slot is never
+// 0, so neither is the key.
+
+uint16_t SpoofIndex::pairBucket(uint64_t pair) const {
+    return (uint16_t)((pair * 0x9E3779B97F4A7C15ull) >> 48) & bucketMask;
+}
+
+bool SpoofIndex::isLive(uint64_t pair) const {
+    uint16_t low = (uint16_t)(pair >> 48);
+    uint16_t high = (uint16_t)(pair >> 16);
+    return generations[low] == (uint16_t)(pair >> 32) && generations[high] == (uint16_t)pair;
+}
+
+bool SpoofIndex::markReported(uint16_t slotA, uint16_t slotB) {
+    if (!reported || slotA >= capacity || slotB >= capacity || slotA == slotB) return true;
+
+    uint16_t low = slotA < slotB ? slotA : slotB;
+    uint16_t high = slotA < slotB ? slotB : slotA;
+    uint64_t pair = ((uint64_t)low << 48) | ((uint64_t)generations[low] << 32) |
+                    ((uint32_t)high << 16) | generations[high];
+
+    uint16_t mask = bucketMask;
+    uint16_t pos = pairBucket(pair);
+    while (reported[pos] != 0) {
+        if (reported[pos] == pair) {
+            stats.pairsSuppressed++;
+            return false;
+        }
+        pos = (pos + 1) & mask;
+    }
+
+    if (reportedCount >= ((uint32_t)mask + 1) * 3 / 4) {
+        sweepReported();
+        if (reportedCount >= ((uint32_t)mask + 1) * 3 / 4) {
+            // Live pairs alone fill it: start over rather than grow; old
+            // pairs may report again
+            memset(reported, 0, sizeof(uint64_t) * ((uint32_t)mask + 1));
+            reportedCount = 0;
+            stats.reportedResets++;
+        }
+        pos = pairBucket(pair);
+        while (reported[pos] != 0) pos = (pos + 1) & mask;
+    }
+
+    reported[pos] = pair;
+    reportedCount++;
+    stats.pairsReported++;
+    return true;
+}
+
+void SpoofIndex::forgetPairs(uint16_t slot) {
+    if (!reported || slot >= capacity) return;
+    // Keys holding the old generation no longer match anything
+    generations[slot]++;
+}
+
+void SpoofIndex::sweepReported() {
+    uint16_t mask = bucketMask;
+    for (uint32_t i = 0; i <= mask;) {
+        uint64_t pair = reported[i];
+        if (pair == 0 || isLive(pair)) {
+            i++;
+            continue;
+        }
+        // Delete by shifting later entries of the cluster back, so every
+        // probe still reaches its key; i is then checked again
+        uint16_t hole = (uint16_t)i;
+        uint16_t pos = hole;
+        reported[hole] = 0;
+        while (true) {
+            pos = (pos + 1) & mask;
+            if (reported[pos] == 0) break;
+            uint16_t home = pairBucket(reported[pos]);
+            bool stays = (hole <= pos) ? (hole < home && home <= pos) : (hole < home || home <= pos);
+            if (stays) continue;
+            reported[hole] = reported[pos];
+            reported[pos] = 0;
+            hole = pos;
+        }
+        reportedCount--;
+        stats.pairsExpired++;
+    }
+}
+
+// ===== KEYS =====
+
+uint64_t SpoofIndex::hashName(const char* name) {
+    if (!name || name[0] == '\0') return 0;
+
+    uint64_t hash = FNV_OFFSET;
+    for (const char* c = name; *c; c++) {
+        hash = fnvByte(hash, (uint8_t)*c);
+    }
+    return hash ? hash : 1;
+}
+
+uint64_t SpoofIndex::fingerprint(const uint8_t* payload, uint8_t length) {
+    if (!payload) return 0;
+
+    // Manufacturer data and service UUID lists, type byte included, in
+    // advertised order; flags, names and TX power are left out
+    uint64_t hash = FNV_OFFSET;
+    bool found = false;
+    uint8_t pos = 0;
+    while (pos + 1 < length) {
+        uint8_t fieldLength = payload[pos];
+        if (fieldLength == 0 || pos + 1 + fieldLength > length) break;
+
+        uint8_t type = payload[pos + 1];
+        if (type == AD_TYPE_MANUFACTURER ||
+            (type >= AD_TYPE_UUID_FIRST && type <= AD_TYPE_UUID_LAST)) {
+            for (uint8_t i = 0; i < fieldLength; i++) {
+                hash = fnvByte(hash, payload[pos + 1 + i]);
+            }
+            found = true;
+        }
+        pos += 1 + fieldLength;
+    }
+
+    if (!found) return 0;
+    return hash ? hash : 1;
+}
@@ -0,0 +1,90 @@
+#ifndef SPOOF_INDEX_H
+#define SPOOF_INDEX_H
+
+#include <stdint.h>
+
+// ========================================
+// SpoofIndex - Secondary index for spoofing checks over the slots of a
+// BLEDeviceTable. Each slot can carry two keys: a hash of the device
+// name and a fingerprint of its advertisement (manufacturer data and
+// service UUID lists). Slots that share a key hang off the same bucket in
+// doubly linked chains, so a key change relinks one slot in O(1). A check
+// then only compares slots within a chain, not every pair of devices.
+// A set of reported slot pairs, as large as the bucket array, lets each
+// pair raise one event. Every slot carries a generation that
+// forgetPairs() and remove() advance, which retires all of the slot's
+// pairs in O(1); retired entries are swept out when the set is 3/4 full,
+// and only a set still that full is forgotten all at once.
+// Hardware independent.
+// ========================================
+
+#define SPOOF_NO_SLOT           0xFFFF
+
+enum SpoofKey : uint8_t {
+    SPOOF_KEY_NAME,
+    SPOOF_KEY_PAYLOAD,
+    SPOOF_KEY_COUNT
+};
+
+struct SpoofIndexStats {
+    uint32_t relinks;            // Key changes
+    uint32_t pairsReported;
+    uint32_t pairsSuppressed;    // Already reported
+    uint32_t pairsExpired;       // Swept out after a device timed out or left
+    uint32_t reportedResets;     // Times the reported set was forgotten
+};
+
+class SpoofIndex {
+private:
+    uint16_t* heads[SPOOF_KEY_COUNT];    // First slot per bucket
+    uint16_t* nextSlot[SPOOF_KEY_COUNT];
+    uint16_t* prevSlot[SPOOF_KEY_COUNT];
+    uint64_t* keys[SPOOF_KEY_COUNT];     // 0: not indexed
+    uint16_t* generations;               // Per slot, advanced when its pairs are forgotten
+    uint64_t* reported;                  // Open-addressed pair keys, 0 empty; bucket count long
+    uint16_t reportedCount;              // Entries in reported, retired ones included
+    uint16_t capacity;
+    uint16_t bucketMask;
+    SpoofIndexStats stats;
+
+    uint16_t bucketOf(uint64_t key) const;
+    void link(uint8_t kind, uint16_t slot, uint64_t key);
+    void unlink(uint8_t kind, uint16_t slot);
+    uint16_t pairBucket(uint64_t pair) const;
+    bool isLive(uint64_t pair) const;
+    void sweepReported();
+
+public:
+    SpoofIndex();
+    ~SpoofIndex();
+
+    bool begin(uint16_t slotCount);
+    void release();
+    void clear();
+
+    // key 0 takes the slot out of that index
+    void setKey(uint8_t kind, uint16_t slot, uint64_t key);
+    void remove(uint16_t slot);
+
+    // Chain walk: first(kind, bucket), then next(kind, slot) until
+    // SPOOF_NO_SLOT. A chain can hold several keys; compare getKey().
+    uint16_t getBucketCount() const { return (uint16_t)(bucketMask + 1); }
+    uint16_t first(uint8_t kind, uint16_t bucket) const { return heads[kind][bucket]; }
+    uint16_t next(uint8_t kind, uint16_t slot) const { return nextSlot[kind][slot]; }
+    uint64_t getKey(uint8_t kind, uint16_t slot) const { return keys[kind][slot]; }
+
+    // True the first time a pair is seen, in either order, since either
+    // slot last had its pairs forgotten
+    bool markReported(uint16_t slotA, uint16_t slotB);
+    // The slot's device timed out: its pairs may report again
+    void forgetPairs(uint16_t slot);
+
+    const SpoofIndexStats& getStats() const { return stats; }
+    bool isAllocated() const { return reported != nullptr; }
+
+    // 0 for an empty name or an advertisement without the fields
+    static uint64_t hashName(const char* name);
+    static uint64_t fingerprint(const uint8_t* payload, uint8_t length);
+};
+
+#endif // SPOOF_INDEX_H
@@ -0,0 +1,304 @@
+#include "AnomalyEngine.h"
+#include <math.h>
+#include <string.h>
+
+#define ANOMALY_MIN_VARIANCE    1e-12f   // Below this the baseline is treated as constant
+
+static inline float positive(float v) {
+    return v > 0.0f ? v : 0.0f;
+}
+
+AnomalyEngine::AnomalyEngine() {
+    setDefaults();
+    reset();
+}
+
+void AnomalyEngine::setDefaults() {
+    config.enabled = ANOMALY_ALL_DETECTORS;
+    config.warmup = 256;
+    config.cooldown = 32;
+    config.baselineSamples = 4096;
+    config.ewmaAlpha = 0.01f;
+    config.zThreshold = 3.0f;
+    config.cusumSlack = 0.5f;
+    config.cusumLimit = 8.0f;
+    config.phDelta = 0.5f;
+    config.phLambda = 8.0f;
+    config.mahalanobisLimit = 18.4f;     // p = 0.0001
+    config.maxClusters = 4;
+    config.clusterMature = 16;
+    config.clusterSpawn = 4.0f;
+    config.clusterLimit = 16.0f;
+    config.clusterRate = 0.01f;
+    config.clusterMinSpread = 1e-4f;
+    config.eventsPerSecond = 2.0f;
+    config.eventBurst = 4;
+}
+
+void AnomalyEngine::reset() {
+    ewmaMean = 0.5f;
+    ewmaVariance = 0.0f;
+    ewmaInvSigma = 0.0f;
+
+    pairCount = 0;
+    pairWeight = 1.0f;
+    meanX = meanY = 0.0f;
+    varX = varY = covXY = 0.0f;
+    invSigma = 0.0f;
+    invXX = invXY = invYY = 0.0f;
+    previous = 0.0f;
+    hasPrevious = false;
+
+    cusumHigh = cusumLow = 0.0f;
+    phUp = phUpMin = 0.0f;
+    phDown = phDownMax = 0.0f;
+
+    clusterCount = 0;
+
+    memset(quiet, 0, sizeof(quiet));
+    memset(scores, 0, sizeof(scores));
+
+    eventHead = eventTail = 0;
+    tokens = config.eventBurst;
+    lastTokenTime = 0;
+
+    memset(&stats, 0, sizeof(stats));
+}
+
+// ===== UPDATE =====
+
+uint8_t AnomalyEngine::update(float value, uint32_t timestamp) {
+    bool armed = stats.samples >= config.warmup;
+    uint8_t candidates = 0;
+    stats.samples++;
+
+    // EWMA z-score against the estimate before this sample; compared
+    // squared, scored with the last refreshed scale
+    float deviation = value - ewmaMean;
+    float deviation2 = deviation * deviation;
+    if (deviation2 > config.zThreshold * config.zThreshold * ewmaVariance) {
+        candidates |= ANOMALY_BIT(ANOMALY_EWMA);
+    }
+    scores[ANOMALY_EWMA] = fabsf(deviation) * ewmaInvSigma;
+    ewmaMean += config.ewmaAlpha * deviation;
+    ewmaVariance = (1.0f - config.ewmaAlpha) * (ewmaVariance + config.ewmaAlpha * deviation2);
+
+    if (hasPrevious) {
+        float dx = previous - meanX;
+        float dy = value - meanY;
+
+        // Shift detectors, in baseline standard deviations
+        if (pairCount >= 2 && invSigma > 0.0f) {
+            float s = dy * invSigma;
+
+            if (armed) {
+                cusumHigh = positive(cusumHigh + s - config.cusumSlack);
+                cusumLow = positive(cusumLow - s - config.cusumSlack);
+                scores[ANOMALY_CUSUM] = cusumHigh > cusumLow ? cusumHigh : cusumLow;
+                if (scores[ANOMALY_CUSUM] > config.cusumLimit) {
+                    candidates |= ANOMALY_BIT(ANOMALY_CUSUM);
+                    cusumHigh = cusumLow = 0.0f;
+                }
+
+                phUp += s - config.phDelta;
+                if (phUp < phUpMin) phUpMin = phUp;
+                phDown += s + config.phDelta;
+                if (phDown > phDownMax) phDownMax = phDown;
+                float rise = phUp - phUpMin;
+                float fall = phDownMax - phDown;
+                scores[ANOMALY_PAGE_HINKLEY] = rise > fall ? rise : fall;
+                if (scores[ANOMALY_PAGE_HINKLEY] > config.phLambda) {
+                    candidates |= ANOMALY_BIT(ANOMALY_PAGE_HINKLEY);
+                    phUp = phUpMin = phDown = phDownMax = 0.0f;
+                }
+            }
+
+            // Mahalanobis distance of the pair, squared, through the
+            // inverse covariance kept with invSigma
+            float distance2 = invXX * dx * dx + 2.0f * invXY * dx * dy + invYY * dy * dy;
+            scores[ANOMALY_MAHALANOBIS] = distance2;
+            if (distance2 > config.mahalanobisLimit) {
+                candidates |= ANOMALY_BIT(ANOMALY_MAHALANOBIS);
+            }
+        }
+
+        // Welford mean and covariance; once the count limit is reached
+        // the weight stays fixed and old pairs fade exponentially
+        if (pairCount < config.baselineSamples) {
+            pairCount++;
+            pairWeight = 1.0f / pairCount;
+        }
+        meanX += dx * pairWeight;
+        meanY += dy * pairWeight;
+        float ex = previous - meanX;
+        float ey = value - meanY;
+        varX += (dx * ex - varX) * pairWeight;
+        varY += (dy * ey - varY) * pairWeight;
+        covXY += (dx * ey - covXY) * pairWeight;
+
+        scores[ANOMALY_CLUSTER] = updateClusters(previous, value);
+        if (scores[ANOMALY_CLUSTER] > config.clusterLimit) {
+            candidates |= ANOMALY_BIT(ANOMALY_CLUSTER);
+        }
+    }
+    previous = value;
+    hasPrevious = true;
+
+    if (stats.samples % ANOMALY_SCALE_REFRESH == 0) {
+        refreshScales();
+    }
+
+    // Warmup, enable mask and cooldowns decide which candidates fire
+    uint8_t fired = 0;
+    float score = 0.0f;
+    for (uint8_t id = 0; id < ANOMALY_DETECTOR_COUNT; id++) {
+        if (quiet[id] > 0) {
+            quiet[id]--;
+            continue;
+        }
+        if (!armed || !(candidates & config.enabled & ANOMALY_BIT(id))) continue;
+        fired |= ANOMALY_BIT(id);
+        quiet[id] = config.cooldown;
+        stats.fired[id]++;
+        float ratio = scores[id] / getLimit(id);
+        if (ratio > score) score = ratio;
+    }
+
+    if (fired) {
+        stats.anomalousSamples++;
+        emit(fired, value, score, timestamp);
+    }
+    return fired;
+}
+
+// Square roots and the covariance inverse change slowly, so they are
+// only recomputed every ANOMALY_SCALE_REFRESH samples
+void AnomalyEngine::refreshScales() {
+    if (varY > ANOMALY_MIN_VARIANCE) invSigma = 1.0f / sqrtf(varY);
+    if (ewmaVariance > ANOMALY_MIN_VARIANCE) ewmaInvSigma = 1.0f / sqrtf(ewmaVariance);
+
+    float det = varX * varY - covXY * covXY;
+    if (det > ANOMALY_MIN_VARIANCE) {
+        float invDet = 1.0f / det;
+        invXX = varY * invDet;
+        invXY = -covXY * invDet;
+        invYY = varX * invDet;
+    } else {
+        invXX = invXY = invYY = 0.0f;
+    }
+}
+
+// Bounded online k-means over (previous, current) pairs. Returns the
+// squared distance to the nearest mature cluster over its spread, taken
+// before the pair is learnt; 0 while the nearest cluster is immature.
+float AnomalyEngine::updateClusters(float x, float y) {
+    if (clusterCount == 0) {
+        clusters[0].x = x;
+        clusters[0].y = y;
+        clusters[0].spread = config.clusterMinSpread;
+        clusters[0].members = 1;
+        clusterCount = 1;
+        return 0.0f;
+    }
+
+    uint8_t nearest = 0;
+    float nearest2 = 0.0f;
+    for (uint8_t i = 0; i < clusterCount; i++) {
+        float dx = x - clusters[i].x;
+        float dy = y - clusters[i].y;
+        float distance2 = dx * dx + dy * dy;
+        if (i == 0 || distance2 < nearest2) {
+            nearest = i;
+            nearest2 = distance2;
+        }
+    }
+
+    AnomalyCluster& c = clusters[nearest];
+    float ratio = nearest2 / c.spread;
+    float result = c.members >= config.clusterMature ? ratio : 0.0f;
+
+    uint8_t limit = config.maxClusters < ANOMALY_MAX_CLUSTERS ? config.maxClusters : ANOMALY_MAX_CLUSTERS;
+    if (ratio > config.clusterSpawn && clusterCount < limit) {
+        // Far from everything and room left: seed a cluster here, sized
+        // to the gap it sits in
+        AnomalyCluster& seed = clusters[clusterCount++];
+        seed.x = x;
+        seed.y = y;
+        seed.spread = nearest2 / config.clusterSpawn;
+        if (seed.spread < config.clusterMinSpread) seed.spread = config.clusterMinSpread;
+        seed.members = 1;
+        return result;
+    }
+
+    if (c.members < 0xFFFF) c.members++;
+    float rate = c.members * config.clusterRate < 1.0f ? 1.0f / c.members : config.clusterRate;
+    c.x += (x - c.x) * rate;
+    c.y += (y - c.y) * rate;
+    c.spread += (nearest2 - c.spread) * rate;
+    if (c.spread < config.clusterMinSpread) c.spread = config.clusterMinSpread;
+    return result;
+}
+
+// ===== EVENTS =====
+
+void AnomalyEngine::emit(uint8_t detectors, float value, float score, uint32_t timestamp) {
+    // Token bucket, refilled only when something asks for a token
+    tokens += (timestamp - lastTokenTime) * config.eventsPerSecond * 0.001f;
+    if (tokens > config.eventBurst) tokens = config.eventBurst;
+    lastTokenTime = timestamp;
+
+    if (tokens < 1.0f) {
+        stats.eventsSuppressed++;
+        return;
+    }
+    if ((uint8_t)(eventHead - eventTail) >= ANOMALY_EVENT_QUEUE) {
+        stats.eventsDropped++;
+        return;
+    }
+    tokens -= 1.0f;
+
+    AnomalyEvent& event = events[eventHead & (ANOMALY_EVENT_QUEUE - 1)];
+    event.sample = stats.samples - 1;
+    event.timestamp = timestamp;
+    event.detectors = detectors;
+    event.value = value;
+    event.score = score;
+    eventHead++;
+    stats.events++;
+}
+
+bool AnomalyEngine::nextEvent(AnomalyEvent& event) {
+    if (eventHead == eventTail) return false;
+    event = events[eventTail & (ANOMALY_EVENT_QUEUE - 1)];
+    eventTail++;
+    return true;
+}
+
+// ===== QUERIES =====
+
+float AnomalyEngine::getCorrelation() const {
+    float denom = varX * varY;
+    return denom > ANOMALY_MIN_VARIANCE ? covXY / sqrtf(denom) : 0.0f;
+}
+
+float AnomalyEngine::getLimit(uint8_t id) const {
+    switch (id) {
+        case ANOMALY_EWMA:         return config.zThreshold;
+        case ANOMALY_CUSUM:        return config.cusumLimit;
+        case ANOMALY_PAGE_HINKLEY: return config.phLambda;
+        case ANOMALY_MAHALANOBIS:  return config.mahalanobisLimit;
+        case ANOMALY_CLUSTER:      return config.clusterLimit;
+        default:                   return 1.0f;
+    }
+}
+
+const char* AnomalyEngine::detectorName(uint8_t id) {
+    switch (id) {
+        case ANOMALY_EWMA:         return "EWMA";
+        case ANOMALY_CUSUM:        return "CUSUM";
+        case ANOMALY_PAGE_HINKLEY: return "Page-Hinkley";
+        case ANOMALY_MAHALANOBIS:  return "Mahalanobis";
+        case ANOMALY_CLUSTER:      return "Cluster";
+        default:                   return "Unknown";
+    }
+}
@@ -0,0 +1,159 @@
+#ifndef ANOMALY_ENGINE_H
+#define ANOMALY_ENGINE_H
+
+#include <stdint.h>
+
+// ========================================
+// AnomalyEngine - Streaming anomaly detectors sharing one update pass
+// per sample: EWMA z-score, two-sided CUSUM, Page-Hinkley, 2-D
+// Mahalanobis distance of (previous, current) pairs and bounded online
+// k-means over the same pairs. A Welford mean and covariance of the pairs
+// is the common baseline; CUSUM and Page-Hinkley work in its standard
+// deviations. Distances stay squared so the per-sample path has no sqrt.
+// Detectors stay quiet during warmup and for a cooldown after firing,
+// and anomalies become events through a token bucket. Hardware
+// independent.
+// ========================================
+
+#define ANOMALY_MAX_CLUSTERS    8
+#define ANOMALY_EVENT_QUEUE     16       // Power of two
+#define ANOMALY_SCALE_REFRESH   16       // Samples between 1/sigma updates
+
+enum AnomalyDetectorId : uint8_t {
+    ANOMALY_EWMA,                // |x - EWMA mean| in EWMA standard deviations
+    ANOMALY_CUSUM,               // Sustained shift up or down
+    ANOMALY_PAGE_HINKLEY,        // Cumulative departure from the running mean
+    ANOMALY_MAHALANOBIS,         // Unlikely (previous, current) pair
+    ANOMALY_CLUSTER,             // Pair outside every learnt cluster
+    ANOMALY_DETECTOR_COUNT
+};
+
+#define ANOMALY_BIT(id)         (1u << (id))
+#define ANOMALY_ALL_DETECTORS   ((1u << ANOMALY_DETECTOR_COUNT) - 1)
+
+// Tunable parameters; changes take effect from the next sample
+struct AnomalyConfig {
+    uint8_t enabled;             // ANOMALY_BIT mask of detectors that may fire
+    uint16_t warmup;             // Samples learnt before any detector fires
+    uint16_t cooldown;           // Samples a detector stays quiet after firing
+    uint16_t baselineSamples;    // Welford count limit; older samples then fade
+    float ewmaAlpha;
+    float zThreshold;            // EWMA z-score limit, standard deviations
+    float cusumSlack;            // k, baseline standard deviations
+    float cusumLimit;            // h, baseline standard deviations
+    float phDelta;               // Page-Hinkley tolerance, baseline standard deviations
+    float phLambda;              // Page-Hinkley limit, baseline standard deviations
+    float mahalanobisLimit;      // Squared distance; chi-square with 2 degrees of freedom
+    uint8_t maxClusters;         // Up to ANOMALY_MAX_CLUSTERS
+    uint16_t clusterMature;      // Members before a cluster can flag points
+    float clusterSpawn;          // Squared distance over spread that starts a new cluster
+    float clusterLimit;          // Squared distance over spread that is anomalous
+    float clusterRate;           // Slowest centroid learning rate
+    float clusterMinSpread;      // Floor on a cluster's mean squared distance
+    float eventsPerSecond;       // Token bucket refill
+    uint8_t eventBurst;          // Token bucket size
+};
+
+struct AnomalyCluster {
+    float x;                     // Previous value
+    float y;                     // Current value
+    float spread;                // Mean squared distance of members
+    uint16_t members;            // Saturates
+};
+
+struct AnomalyEvent {
+    uint32_t sample;             // Sample index since reset
+    uint32_t timestamp;          // ms
+    uint8_t detectors;           // ANOMALY_BIT mask of detectors that fired
+    float value;
+    float score;                 // Largest detector statistic over its limit
+};
+
+struct AnomalyEngineStats {
+    uint32_t samples;
+    uint32_t anomalousSamples;   // Samples with at least one detector firing
+    uint32_t fired[ANOMALY_DETECTOR_COUNT];
+    uint32_t events;             // Queued
+    uint32_t eventsSuppressed;   // Refused by the rate limit
+    uint32_t eventsDropped;      // Queue full
+};
+
+class AnomalyEngine {
+private:
+    // EWMA
+    float ewmaMean;
+    float ewmaVariance;
+    float ewmaInvSigma;          // Refreshed with invSigma, for scoring only
+
+    // Welford baseline of (previous, current) pairs
+    uint16_t pairCount;
+    float pairWeight;            // 1 / pairCount
+    float meanX, meanY;
+    float varX, varY, covXY;
+    float invSigma;              // 1 / sqrt(varY), refreshed every ANOMALY_SCALE_REFRESH samples
+    float invXX, invXY, invYY;   // Inverse covariance, refreshed with invSigma
+    float previous;
+    bool hasPrevious;
+
+    // CUSUM and Page-Hinkley, in baseline standard deviations
+    float cusumHigh;
+    float cusumLow;
+    float phUp, phUpMin;
+    float phDown, phDownMax;
+
+    AnomalyCluster clusters[ANOMALY_MAX_CLUSTERS];
+    uint8_t clusterCount;
+
+    uint16_t quiet[ANOMALY_DETECTOR_COUNT];         // Cooldown left
+    float scores[ANOMALY_DETECTOR_COUNT];           // Latest statistics
+
+    AnomalyEvent events[ANOMALY_EVENT_QUEUE];
+    uint8_t eventHead;
+    uint8_t eventTail;
+    float tokens;
+    uint32_t lastTokenTime;
+
+    AnomalyEngineStats stats;
+
+    void refreshScales();
+    float updateClusters(float x, float y);
+    void emit(uint8_t detectors, float value, float score, uint32_t timestamp);
+
+public:
+    AnomalyConfig config;
+
+    AnomalyEngine();
+
+    void setDefaults();
+    // Forgets everything learnt; config is kept
+    void reset();
+
+    // Feeds one value, normally 0.0-1.0. Returns the ANOMALY_BIT mask of
+    // detectors that fired on it.
+    uint8_t update(float value, uint32_t timestamp);
+
+    bool warmedUp() const { return stats.samples >= config.warmup; }
+    float getMean() const { return ewmaMean; }
+    float getVariance() const { return ewmaVariance; }
+    float getBaselineMean() const { return meanY; }
+    float getBaselineVariance() const { return varY; }
+    float getCorrelation() const;
+    // Statistic behind the latest decision: |z|, CUSUM sum, Page-Hinkley
+    // excursion, squared Mahalanobis distance, squared cluster distance
+    // over spread
+    float getScore(uint8_t id) const { return id < ANOMALY_DETECTOR_COUNT ? scores[id] : 0.0f; }
+    float getLimit(uint8_t id) const;
+
+    uint8_t getClusterCount() const { return clusterCount; }
+    const AnomalyCluster& getCluster(uint8_t index) const { return clusters[index]; }
+
+    // Takes the oldest queued event
+    bool nextEvent(AnomalyEvent& event);
+    uint8_t pendingEvents() const { return (uint8_t)(eventHead - eventTail); }
+
+    const AnomalyEngineStats& getStats() const { return stats; }
+
+    static const char* detectorName(uint8_t id);
+};
+
+#endif // ANOMALY_ENGINE_H
@@ -3,7 +3,19 @@
 
 #include "../../core/AppManager/BaseApp.h"
 #include "../../core/SystemCore/SystemCore.h"
+#include "../../core/Audio/DacOutput.h"
 #include <SD.h>
+#include <ArduinoJson.h>
+#include <esp_timer.h>
+#include "EntropyStats.h"
+#include "LZEstimator.h"
+#include "EntropySampleStore.h"
+#include "MinEntropyEstimator.h"
+#include "SampleBlockQueue.h"
+#include "EntropyGeneratorBank.h"
+#include "EntropySynth.h"
+#include "AnomalyEngine.h"
+#include "PlotLayers.h"
 
 // ========================================
 // EntropyBeacon - Real-time entropy visualization for remu.ii
@@ -13,7 +25,33 @@
 // Visualization modes
 enum VisualizationMode {
     VIZ_OSCILLOSCOPE,   // Time domain waveform
-    VIZ_SPECTRUM        // Frequency domain analysis
+    VIZ_SPECTRUM,       // Frequency domain analysis
+    VIZ_MIN_ENTROPY,    // SP 800-90B min-entropy estimates
+    VIZ_SCATTER,        // Lag-1 phase space
+    VIZ_HISTOGRAM,      // Value distribution
+    VIZ_ANOMALY         // Detector status and timeline
+};
+
+// Where samples come from; also the source bits stored with each sample
+enum EntropyGeneratorType {
+    ENTROPY_ADC_NOISE,      // Floating ADC pins mixed with the system pool
+    ENTROPY_LCG,
+    ENTROPY_MERSENNE,
+    ENTROPY_LOGISTIC_MAP,
+    ENTROPY_HENON_MAP,
+    ENTROPY_LORENZ,
+    ENTROPY_LFSR,
+    ENTROPY_CHAOS_COMBINED
+};
+
+// What the DAC plays
+enum DACMode {
+    DAC_OFF,
+    DAC_RAW,            // White noise
+    DAC_FILTERED,       // Noise through a resonant filter
+    DAC_TONE,           // Pitch follows the value
+    DAC_MODULATED,      // FM voice
+    DAC_PULSE           // Pulses on each sample
 };
 
 // Sample rates
@@ -28,7 +66,34 @@ enum SampleRate {
 
 // Buffer sizes
 #define ENTROPY_BUFFER_SIZE 256
-#define SPECTRUM_BINS 32
+#define FFT_SIZE 64                 // Samples behind each spectrum
+#define HISTOGRAM_BINS 256          // 8-bit symbols
+#define TOUCH_ZONE_COUNT 9          // Eight buttons and the graph
+#define ANALYSIS_WINDOW 64          // Samples behind the advanced analysis metrics
+#define SAMPLE_ENTROPY_WINDOW 32    // Samples behind each point's Shannon entropy
+#define MIN_ENTROPY_WINDOW 1024     // Symbols per min-entropy estimate
+
+// Acquisition: a timer fills sample blocks, update() analyses whole blocks
+#define ACQ_QUEUE_BLOCKS 8          // Power of two; a quarter second at any rate
+#define ACQ_BLOCKS_PER_SECOND 32    // Sets the samples per block for each rate
+#define ACQ_MAX_BLOCKS_PER_UPDATE 4 // Keeps a long backlog from stalling the UI
+#define ACQ_BEHIND_BLOCKS 4         // Backlog at which optional stages are shed
+#define ADVANCED_ANALYSIS_EVERY 4   // Blocks between advanced analysis runs
+#define GENERATED_BLOCK 64          // Generator words produced per refill
+
+// Audio output task
+#define AUDIO_DMA_BUFFERS 2         // Double buffered: render one while the other plays
+#define AUDIO_TASK_STACK 4096
+#define AUDIO_TASK_PRIORITY 5
+#define AUDIO_TASK_CORE 0           // Keep audio off the UI core
+#define AUDIO_STOP_TIMEOUT 100      // ms to wait for the task to exit
+
+// Sampling limits, microseconds between samples
+#define MIN_SAMPLE_INTERVAL 100
+#define MAX_SAMPLE_INTERVAL 100000
+
+// Data directory on the SD card
+#define ENTROPY_DATA_DIR "/sd/apps/entropybeacon"
 
 // Display configuration
 #define GRAPH_WIDTH 280
@@ -36,77 +101,262 @@ enum SampleRate {
 #define GRAPH_X 20
 #define GRAPH_Y 40
 
-// Simple anomaly detector
+// Incremental rendering: layers keep what is on screen and resend only
+// changes; the screen is cleared only when the layout changes
+#define SCATTER_POINTS 200          // Points kept on the phase-space plot
+#define OSC_SLOTS 8                 // Trigger, mean, +/-sigma, raw trace, source markers, two overlays
+#define VIEW_TEXT_FIELDS 16         // Cached text lines: status bar, then the view's
+#define TIMELINE_HALF_HEIGHT 10     // Anomaly timeline rows either side of its axis
+
+// One sample with its per-sample metrics, assembled from the sample store
+struct EntropyPoint {
+    uint32_t timestamp;
+    uint16_t value;               // 12-bit reading
+    float normalized;             // value / 4095
+    float shannonEntropy;         // Bits over the last SAMPLE_ENTROPY_WINDOW samples
+    float complexity;             // LZ bits per symbol of the latest block
+    uint8_t source;               // EntropyGeneratorType
+    bool anomaly;
+};
+
+// One spectrum bin
+struct FrequencyBin {
+    float frequency;
+    float magnitude;              // Normalized to the largest bin
+    float phase;
+};
+
+// Window metrics refreshed by the advanced analysis stage
+struct EntropyAnalysis {
+    float shannonEntropy;
+    float conditionalEntropy;
+    float mutualInformation;
+    float algorithmicComplexity;  // LZ bits per symbol
+    float compressionRatio;
+    float compressionEfficiency;
+    float chiSquareValue;
+    float serialCorrelation[ENTROPY_STATS_MAX_LAG];
+    float spectralEntropy;
+    float dominantFrequency;
+    float spectralFlatness;
+    float lyapunovExponent;
+    float fractalDimension;
+    uint16_t patternRepeats;
+    float predictability;
+};
+
+// Selected generator
+struct EntropyGenerators {
+    EntropyGeneratorType activeGenerator;
+    bool useMultipleSources;
+};
+
+// A touch button; function names the action
+struct InteractionZone {
+    int16_t x, y, w, h;
+    String function;
+    bool enabled;
+};
+
+// Pattern and timing detectors; the statistical ones live in AnomalyEngine
 struct AnomalyDetector {
-    float mean;            // Running mean
-    float variance;        // Running variance
-    float threshold;       // Anomaly threshold (stddev multiplier)
-    uint32_t anomalyCount; // Total anomalies detected
+    uint8_t patternBuffer[32];        // Recent samples, 8 bits each
+    uint8_t patternIndex;
+    uint32_t repeatedPatterns;        // Back-to-back repeats of 4 samples
+    unsigned long expectedInterval;   // Smoothed sample interval
+    float intervalVariance;
+    uint32_t timingAnomalies;
+    float crossCorrelationThreshold;
+    float maxCrossCorrelation;
+};
+
+// Cost of the last frames, SPI bytes as counted by DisplayManager
+struct ViewRenderStats {
+    uint32_t frames;
+    uint32_t fullRedraws;
+    uint32_t lastBytes;
+    uint32_t lastMicros;
+    uint32_t worstMicros;
+    uint32_t columnsPushed;       // Column updates from the layers
+    uint32_t pixelsPlotted;       // Point layer writes
 };
 
 // Visualization state
 struct EntropyVisualization {
     VisualizationMode mode;
     SampleRate sampleRate;
-    float amplitudeScale;  // Amplitude scaling
-    uint16_t traceColor;   // Trace color
+    DACMode dacMode;
+    float amplitudeScale;         // Amplitude scaling
+    float timeScale;
+    uint8_t triggerLevel;         // 0-255 across the graph height
+    float spectrumGain;
+    uint8_t spectrumBars;
+    uint8_t activeTraces;         // Bit per oscilloscope trace: raw, H(x), K(x)
+    uint16_t traceColors[3];
+    bool showGrid;
+    uint8_t persistence;          // Trace fade across the graph, 0 = none
+    bool recordingEnabled;
+    unsigned long recordStartTime;
+    uint32_t samplesRecorded;
 };
 
 class EntropyBeaconApp : public BaseApp {
 private:
     // Data buffers
-    uint16_t entropyBuffer[ENTROPY_BUFFER_SIZE];
-    float spectrumData[SPECTRUM_BINS];
+    EntropySampleStore samples;     // ENTROPY_BUFFER_SIZE samples, one array per field
+    FrequencyBin spectrumData[FFT_SIZE / 2];
+    uint16_t histogramBins[HISTOGRAM_BINS];
+    EntropyAnalysis analysis;
+    
+    // Sliding-window statistics, updated as samples arrive
+    EntropyStats analysisStats;
+    EntropyStats sampleStats;
+    
+    // LZ complexity: whole analysis window, and a block stream for per-point values
+    LZEstimator lzEstimator;
+    LZEstimator lzStream;
     
-    // Buffer management
-    uint16_t bufferIndex;
+    // Min-entropy estimates over tumbling windows
+    MinEntropyEstimator minEntropy;
     
     // Sampling control
-    unsigned long lastSampleTime;
     unsigned long sampleInterval; // Microseconds between samples
     
+    // Acquisition timer (producer) and block analysis (consumer)
+    SampleBlockQueue acquisitionQueue;
+    esp_timer_handle_t acquisitionTimer;
+    uint32_t blocksAnalysed;
+    AnalysisStage advancedStage;
+    AnalysisStage minEntropyStage;
+    
+    // Deterministic generators, consumed a block at a time by the producer
+    EntropyGenerators generators;
+    EntropyGeneratorBank generatorBank;
+    uint32_t generatedWords[GENERATED_BLOCK];
+    volatile uint16_t generatedIndex;   // GENERATED_BLOCK forces a refill
+    uint8_t generatedSource;
+    
     // Visualization state
     EntropyVisualization viz;
+    InteractionZone touchZones[TOUCH_ZONE_COUNT];
+    
+    // Retained view layers; graphLayer and stripLayer are set up for
+    // whichever view is showing
+    ColumnLayer graphLayer;
+    ColumnLayer stripLayer;
+    PointLayer scatterLayer;
+    uint32_t scatterWritten;          // Samples already plotted
+    uint32_t layoutKey;               // Settings the static layout was drawn for
+    bool layoutDirty;
+    String viewText[VIEW_TEXT_FIELDS];
+    uint16_t viewTextColor[VIEW_TEXT_FIELDS];
+    uint32_t histogramDirty[8];       // One bit per histogram bin
+    uint16_t histogramMax;
+    bool histogramRescale;
+    int16_t clusterShapes[ANOMALY_MAX_CLUSTERS][3];   // Drawn x, y, radius
+    uint8_t clusterShapeCount;
+    uint32_t minEntropyShown;         // Windows behind the drawn bars
+    ViewRenderStats renderStats;
     AnomalyDetector anomalyDetector;
+    AnomalyEngine anomalyEngine;      // Statistical detectors, one pass per sample
     
-    // DAC output
+    // DAC output: the output task renders synth blocks into the I2S DMA
+    // buffers. synth is only touched by the task while it runs; controls
+    // reach it through pendingControls at block boundaries.
+    EntropySynth synth;
+    DacOutput dacOutput;
+    portMUX_TYPE audioMux;
+    SynthControls pendingControls;
+    volatile bool controlsPending;
+    float* audioRender;               // One block of float samples
+    volatile uint32_t audioWorstMicros;
     bool dacEnabled;
     
     // Recording to SD card
-    bool recordingEnabled;
     File recordingFile;
-    String recordingPath;
     String configPath;
-    String logPath;
     
     // Private methods - Sampling
     void sampleEntropy();
-    bool detectAnomaly(float value);
-    void updateStatistics(float value);
+    bool startAcquisition();
+    void stopAcquisition();
+    static void acquisitionTimerCallback(void* arg);
+    void processSampleBlock(const SampleBlock& block);
+    void analyseSample(uint16_t value, uint8_t source, uint32_t timestamp);
+    void updateAdvancedAnalysis();
+    void processEntropyPoint(EntropyPoint& point);
     void calculateSampleInterval();
+    uint16_t readEntropySource(uint8_t source);
+    
+    // Private methods - Generators
+    void initializeEntropyGenerators();
+    void seedGenerators(uint32_t seed);
     
     // Private methods - Analysis
-    void performSimpleFFT();
+    void performFFT();
+    void normalizeSpectrum();
+    float calculateSpectralEntropy();
+    float calculateLyapunovExponent(float* trajectory, uint16_t length);
+    float calculateFractalDimension(uint16_t* data, uint16_t length);
+    void updateHistogram(uint16_t value);
+    
+    // Private methods - Anomaly detection
+    void initializeAnomalyDetector();
+    void initializeAdvancedAnomalyDetection();
+    bool detectPatternAnomalies(uint16_t value);
+    bool detectTemporalAnomalies(unsigned long timestamp);
+    void logAnomaly(const AnomalyEvent& event);
+    void setAnomalyThreshold(float threshold) { anomalyEngine.config.zThreshold = threshold; }
+    void resetStatistics();
+    void calibrateBaseline();
     
     // Private methods - Visualization
+    void setVisualizationMode(VisualizationMode mode);
     void drawOscilloscope();
     void drawSpectrum();
+    void drawMinEntropy();
+    void drawScatterPlot();
+    void drawHistogram();
+    void drawAnomalyView();
     void drawControls();
+    uint32_t currentLayoutKey() const;
+    void setupViewLayers();
+    void flushColumnLayer(ColumnLayer& layer);
+    void flushPointLayer(PointLayer& layer);
+    void drawTextField(uint8_t field, int16_t x, int16_t y, int16_t w, const String& text, uint16_t color);
+    
+    // Private methods - Controls
+    void setupTouchZones();
+    void handleControlTouch(TouchPoint touch);
+    void handleGraphTouch(TouchPoint touch);
+    void handleLongPress();
     
     // Private methods - DAC Output
     void updateDACOutput();
+    SynthControls buildSynthControls();
+    bool startAudioOutput();
+    void stopAudioOutput();
+    static void renderAudioBlock(void* context, uint16_t* out, uint16_t count);
+    void renderAudio(uint16_t* out, uint16_t count);
     
     // Private methods - SD Card Storage
-    void writeDataToSD(uint16_t value, float normalized, bool isAnomaly);
-    void logEventToSD(String eventType, float value);
-    bool startRecording();
-    void stopRecording();
+    bool startDataRecording(String filename = "");
+    bool stopDataRecording();
+    void writeDataPoint(EntropyPoint& point);
+    void logEntropyEvent(EntropyPoint& point);
+    bool exportData(String filename, String format);
+    bool exportAdvancedAnalysis(String filename);
     void loadConfiguration();
     void saveConfiguration();
     
     // Utility methods
     uint16_t getBufferSize() const;
+    EntropyPoint getRecentPoint(uint16_t age) const;
+    EntropyPoint getDataPoint(uint16_t index) const;
     float getCurrentEntropy() const;
+    float getStandardDeviation() const;
+    String formatFrequency(float frequency);
+    String getAppDataPath() const { return ENTROPY_DATA_DIR; }
 
 public:
     EntropyBeaconApp();
@@ -121,6 +371,13 @@ public:
     String getName() const override { return "EntropyBeacon"; }
     const uint8_t* getIcon() const override;
     
+    // Optional BaseApp methods
+    void onPause() override;
+    void onResume() override;
+    uint8_t getSettingsCount() const override { return 6; }
+    String getSettingName(uint8_t index) const override;
+    void handleSetting(uint8_t index) override;
+    
     // Icon data
     static const uint8_t ENTROPY_ICON[32];
 };
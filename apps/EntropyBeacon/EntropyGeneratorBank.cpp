@@ -0,0 +1,365 @@
+#include "EntropyGeneratorBank.h"
+#include <string.h>
+
+#define MT_UPPER_MASK    0x80000000u
+#define MT_LOWER_MASK    0x7FFFFFFFu
+#define MT_MATRIX        0x9908B0DFu
+
+// Word scaling of the float sources, as the generators have always used
+#define LOGISTIC_SCALE       ((float)0xFFFFFFFF)
+#define HENON_SCALE          ((float)0x7FFFFFFF)
+#define HENON_COMBINED_SCALE ((float)0x3FFFFFFF)
+#define HENON_OFFSET         2.0f
+#define LORENZ_SCALE         ((float)0x1FFFFFF)
+#define LORENZ_OFFSET        50.0f
+
+// Scaled values can pass 2^32; they wrap, keeping the low bits varied.
+// A diverged map gives 0 rather than an undefined conversion.
+static inline uint32_t wrapToWord(float v) {
+    if (!(v > -9.0e18f && v < 9.0e18f)) return 0;
+    return (uint32_t)(int64_t)v;
+}
+
+EntropyGeneratorBank::EntropyGeneratorBank() {
+    setDefaults(1);
+}
+
+void EntropyGeneratorBank::setDefaults(uint32_t seedValue) {
+    params.lcgA = 1664525;           // Numerical Recipes
+    params.lcgC = 1013904223;
+    params.logisticR = 3.9f;         // Chaotic regime
+    params.henonA = 1.4f;            // Standard parameters
+    params.henonB = 0.3f;
+    params.lorenzSigma = 10.0f;
+    params.lorenzRho = 28.0f;
+    params.lorenzBeta = 8.0f / 3.0f;
+    params.lorenzDt = 0.01f;
+    params.lfsrTaps = 0xB400u;       // x^16 + x^14 + x^13 + x^11 + 1
+
+    lcgState = lcgOrigin = seedValue;
+    seedMersenne(seedValue);
+    logisticX = 0.5f;
+    henonX = 0.1f;
+    henonY = 0.1f;
+    lorenzX = 1.0f;
+    lorenzY = 1.0f;
+    lorenzZ = 1.0f;
+    lfsrState = lfsrOrigin = 0xACE1u;
+    memset(positions, 0, sizeof(positions));
+}
+
+void EntropyGeneratorBank::seed(uint32_t seedValue) {
+    lcgState = lcgOrigin = seedValue;
+    seedMersenne(seedValue);
+    logisticX = (float)(seedValue % 1000) / 1000.0f;
+    henonX = (float)((seedValue >> 8) % 100) / 100.0f;
+    henonY = (float)((seedValue >> 16) % 100) / 100.0f;
+    lorenzX = (float)((seedValue >> 4) % 50) - 25.0f;
+    lorenzY = (float)((seedValue >> 12) % 50) - 25.0f;
+    lorenzZ = (float)((seedValue >> 20) % 50);
+    lfsrState = lfsrOrigin = seedValue | 1;   // Never zero
+    memset(positions, 0, sizeof(positions));
+}
+
+void EntropyGeneratorBank::fill(uint8_t id, uint32_t* out, uint16_t count) {
+    switch (id) {
+        case GENERATOR_LCG:      fillLCG(out, count); break;
+        case GENERATOR_MERSENNE: fillMersenne(out, count); break;
+        case GENERATOR_LOGISTIC: fillLogistic(out, count); break;
+        case GENERATOR_HENON:    fillHenon(out, count); break;
+        case GENERATOR_LORENZ:   fillLorenz(out, count); break;
+        case GENERATOR_LFSR:     fillLFSR(out, count); break;
+        case GENERATOR_COMBINED:
+        default:                 fillCombined(out, count); break;
+    }
+}
+
+// ===== LCG =====
+
+void EntropyGeneratorBank::fillLCG(uint32_t* out, uint16_t count) {
+    uint32_t a = params.lcgA, c = params.lcgC;
+    uint32_t state = lcgState;
+    for (uint16_t i = 0; i < count; i++) {
+        state = a * state + c;
+        out[i] = state;
+    }
+    lcgState = state;
+    positions[GENERATOR_LCG] += count;
+}
+
+// Composes the affine step with itself: after the loop, (multiplier,
+// increment) advance the state by steps
+void EntropyGeneratorBank::jumpLCG(uint64_t steps) {
+    uint32_t multiplier = 1, increment = 0;
+    uint32_t stepMultiplier = params.lcgA, stepIncrement = params.lcgC;
+    while (steps) {
+        if (steps & 1) {
+            multiplier *= stepMultiplier;
+            increment = increment * stepMultiplier + stepIncrement;
+        }
+        stepIncrement = (stepMultiplier + 1) * stepIncrement;
+        stepMultiplier *= stepMultiplier;
+        steps >>= 1;
+    }
+    lcgState = multiplier * lcgState + increment;
+}
+
+// ===== MERSENNE TWISTER =====
+
+void EntropyGeneratorBank::seedMersenne(uint32_t seedValue) {
+    mt[0] = seedValue;
+    for (uint16_t i = 1; i < GENERATOR_MT_SIZE; i++) {
+        mt[i] = 1812433253u * (mt[i - 1] ^ (mt[i - 1] >> 30)) + i;
+    }
+    mtIndex = GENERATOR_MT_SIZE;
+}
+
+// Regenerates the whole state. The index split removes the modulo from
+// every access.
+void EntropyGeneratorBank::twist() {
+    const uint16_t span = GENERATOR_MT_SIZE - GENERATOR_MT_SHIFT;
+    uint16_t i = 0;
+    for (; i < span; i++) {
+        uint32_t y = (mt[i] & MT_UPPER_MASK) | (mt[i + 1] & MT_LOWER_MASK);
+        mt[i] = mt[i + GENERATOR_MT_SHIFT] ^ (y >> 1) ^ (-(y & 1u) & MT_MATRIX);
+    }
+    for (; i < GENERATOR_MT_SIZE - 1; i++) {
+        uint32_t y = (mt[i] & MT_UPPER_MASK) | (mt[i + 1] & MT_LOWER_MASK);
+        mt[i] = mt[i - span] ^ (y >> 1) ^ (-(y & 1u) & MT_MATRIX);
+    }
+    uint32_t y = (mt[i] & MT_UPPER_MASK) | (mt[0] & MT_LOWER_MASK);
+    mt[i] = mt[GENERATOR_MT_SHIFT - 1] ^ (y >> 1) ^ (-(y & 1u) & MT_MATRIX);
+    mtIndex = 0;
+}
+
+void EntropyGeneratorBank::fillMersenne(uint32_t* out, uint16_t count) {
+    positions[GENERATOR_MERSENNE] += count;
+    while (count > 0) {
+        if (mtIndex >= GENERATOR_MT_SIZE) twist();
+
+        uint16_t run = GENERATOR_MT_SIZE - mtIndex;
+        if (run > count) run = count;
+        const uint32_t* words = mt + mtIndex;
+        for (uint16_t i = 0; i < run; i++) {
+            uint32_t y = words[i];
+            y ^= y >> 11;
+            y ^= (y << 7) & 0x9D2C5680u;
+            y ^= (y << 15) & 0xEFC60000u;
+            y ^= y >> 18;
+            out[i] = y;
+        }
+        mtIndex += run;
+        out += run;
+        count -= run;
+    }
+}
+
+// ===== CHAOTIC MAPS =====
+
+void EntropyGeneratorBank::fillLogistic(uint32_t* out, uint16_t count) {
+    float r = params.logisticR;
+    float x = logisticX;
+    for (uint16_t i = 0; i < count; i++) {
+        x = r * x * (1.0f - x);
+        if (x < 0.0f) x = 0.0f;
+        if (x > 1.0f) x = 1.0f;
+        out[i] = wrapToWord(x * LOGISTIC_SCALE);
+    }
+    logisticX = x;
+    positions[GENERATOR_LOGISTIC] += count;
+}
+
+void EntropyGeneratorBank::fillHenon(uint32_t* out, uint16_t count) {
+    float a = params.henonA, b = params.henonB;
+    float x = henonX, y = henonY;
+    for (uint16_t i = 0; i < count; i++) {
+        float nextX = 1.0f - a * x * x + y;
+        y = b * x;
+        x = nextX;
+        out[i] = wrapToWord((x + HENON_OFFSET) * HENON_SCALE);
+    }
+    henonX = x;
+    henonY = y;
+    positions[GENERATOR_HENON] += count;
+}
+
+void EntropyGeneratorBank::fillLorenz(uint32_t* out, uint16_t count) {
+    float sigma = params.lorenzSigma, rho = params.lorenzRho;
+    float beta = params.lorenzBeta, dt = params.lorenzDt;
+    float x = lorenzX, y = lorenzY, z = lorenzZ;
+    for (uint16_t i = 0; i < count; i++) {
+        float dx = sigma * (y - x);
+        float dy = x * (rho - z) - y;
+        float dz = x * y - beta * z;
+        x += dx * dt;
+        y += dy * dt;
+        z += dz * dt;
+        out[i] = wrapToWord((x + LORENZ_OFFSET) * LORENZ_SCALE);
+    }
+    lorenzX = x;
+    lorenzY = y;
+    lorenzZ = z;
+    positions[GENERATOR_LORENZ] += count;
+}
+
+// ===== LFSR =====
+
+void EntropyGeneratorBank::fillLFSR(uint32_t* out, uint16_t count) {
+    uint32_t taps = params.lfsrTaps;
+    uint32_t state = lfsrState;
+    for (uint16_t i = 0; i < count; i++) {
+        state = (state >> 1) ^ (-(state & 1u) & taps);
+        out[i] = state;
+    }
+    lfsrState = state;
+    positions[GENERATOR_LFSR] += count;
+}
+
+// The step is linear over GF(2); the matrix is kept as its 32 columns
+// and squared once per bit of steps
+static uint32_t applyColumns(const uint32_t* columns, uint32_t v) {
+    uint32_t result = 0;
+    for (uint8_t bit = 0; v; bit++, v >>= 1) {
+        if (v & 1) result ^= columns[bit];
+    }
+    return result;
+}
+
+void EntropyGeneratorBank::jumpLFSR(uint64_t steps) {
+    uint32_t power[32], squared[32];
+    for (uint8_t bit = 0; bit < 32; bit++) {
+        uint32_t v = 1u << bit;
+        power[bit] = (v >> 1) ^ (-(v & 1u) & params.lfsrTaps);
+    }
+
+    uint32_t state = lfsrState;
+    while (steps) {
+        if (steps & 1) state = applyColumns(power, state);
+        steps >>= 1;
+        if (!steps) break;
+        for (uint8_t bit = 0; bit < 32; bit++) {
+            squared[bit] = applyColumns(power, power[bit]);
+        }
+        memcpy(power, squared, sizeof(power));
+    }
+    lfsrState = state;
+}
+
+// ===== COMBINED =====
+
+void EntropyGeneratorBank::fillCombined(uint32_t* out, uint16_t count) {
+    // The twist has its own block structure; everything else advances
+    // together in one loop with its state in registers
+    fillMersenne(out, count);
+
+    uint32_t lcgMul = params.lcgA, lcgAdd = params.lcgC, lcg = lcgState;
+    uint32_t taps = params.lfsrTaps, lfsr = lfsrState;
+    float r = params.logisticR, lx = logisticX;
+    float a = params.henonA, b = params.henonB, hx = henonX, hy = henonY;
+    float sigma = params.lorenzSigma, rho = params.lorenzRho;
+    float beta = params.lorenzBeta, dt = params.lorenzDt;
+    float x = lorenzX, y = lorenzY, z = lorenzZ;
+
+    for (uint16_t i = 0; i < count; i++) {
+        lcg = lcgMul * lcg + lcgAdd;
+        lfsr = (lfsr >> 1) ^ (-(lfsr & 1u) & taps);
+
+        lx = r * lx * (1.0f - lx);
+        if (lx < 0.0f) lx = 0.0f;
+        if (lx > 1.0f) lx = 1.0f;
+
+        float nextX = 1.0f - a * hx * hx + hy;
+        hy = b * hx;
+        hx = nextX;
+
+        float dx = sigma * (y - x);
+        float dy = x * (rho - z) - y;
+        float dz = x * y - beta * z;
+        x += dx * dt;
+        y += dy * dt;
+        z += dz * dt;
+
+        // The combination has always scaled the Henon map by half
+        out[i] ^= lcg ^ lfsr ^ wrapToWord(lx * LOGISTIC_SCALE) ^
+                  wrapToWord((hx + HENON_OFFSET) * HENON_COMBINED_SCALE) ^
+                  wrapToWord((x + LORENZ_OFFSET) * LORENZ_SCALE);
+    }
+
+    lcgState = lcg;
+    lfsrState = lfsr;
+    logisticX = lx;
+    henonX = hx;
+    henonY = hy;
+    lorenzX = x;
+    lorenzY = y;
+    lorenzZ = z;
+    positions[GENERATOR_LCG] += count;
+    positions[GENERATOR_LFSR] += count;
+    positions[GENERATOR_LOGISTIC] += count;
+    positions[GENERATOR_HENON] += count;
+    positions[GENERATOR_LORENZ] += count;
+    positions[GENERATOR_COMBINED] += count;
+}
+
+// ===== SEEKING =====
+
+void EntropyGeneratorBank::discard(uint8_t id, uint64_t count) {
+    if (id >= GENERATOR_COUNT || count == 0) return;
+
+    switch (id) {
+        case GENERATOR_LCG:
+            jumpLCG(count);
+            positions[id] += count;
+            return;
+        case GENERATOR_LFSR:
+            jumpLFSR(count);
+            positions[id] += count;
+            return;
+        case GENERATOR_MERSENNE:
+            positions[id] += count;
+            while (count > 0) {
+                if (mtIndex >= GENERATOR_MT_SIZE) twist();
+                uint16_t run = GENERATOR_MT_SIZE - mtIndex;
+                if (run > count) run = (uint16_t)count;
+                mtIndex += run;
+                count -= run;
+            }
+            return;
+        default:
+            break;
+    }
+
+    uint32_t chunk[GENERATOR_CHUNK];
+    while (count > 0) {
+        uint16_t n = count < GENERATOR_CHUNK ? (uint16_t)count : GENERATOR_CHUNK;
+        fill(id, chunk, n);
+        count -= n;
+    }
+}
+
+bool EntropyGeneratorBank::seek(uint8_t id, uint64_t position) {
+    if (id == GENERATOR_LCG) {
+        lcgState = lcgOrigin;
+        jumpLCG(position);
+    } else if (id == GENERATOR_LFSR) {
+        lfsrState = lfsrOrigin;
+        jumpLFSR(position);
+    } else {
+        return false;
+    }
+    positions[id] = position;
+    return true;
+}
+
+const char* EntropyGeneratorBank::generatorName(uint8_t id) {
+    switch (id) {
+        case GENERATOR_LCG:      return "LCG";
+        case GENERATOR_MERSENNE: return "MT19937";
+        case GENERATOR_LOGISTIC: return "Logistic";
+        case GENERATOR_HENON:    return "Henon";
+        case GENERATOR_LORENZ:   return "Lorenz";
+        case GENERATOR_LFSR:     return "LFSR";
+        case GENERATOR_COMBINED: return "Combined";
+        default:                 return "Unknown";
+    }
+}
@@ -0,0 +1,107 @@
+#ifndef ENTROPY_GENERATOR_BANK_H
+#define ENTROPY_GENERATOR_BANK_H
+
+#include <stdint.h>
+
+// ========================================
+// EntropyGeneratorBank - The deterministic EntropyBeacon sources: LCG,
+// Mersenne Twister, logistic and Henon maps, Lorenz system, LFSR and
+// their XOR combination. Each fills a block of 32-bit words per call,
+// keeping its state in locals for the whole block; the Mersenne Twister
+// regenerates all 624 words in one pass. A fixed seed reproduces every
+// sequence exactly. The LCG and LFSR can jump ahead in O(log n) steps,
+// so their streams can also be seeked. Hardware independent.
+// ========================================
+
+#define GENERATOR_MT_SIZE       624
+#define GENERATOR_MT_SHIFT      397
+#define GENERATOR_CHUNK         64       // Words per pass when the maps are discarded
+
+enum GeneratorId {
+    GENERATOR_LCG,
+    GENERATOR_MERSENNE,
+    GENERATOR_LOGISTIC,
+    GENERATOR_HENON,
+    GENERATOR_LORENZ,
+    GENERATOR_LFSR,
+    GENERATOR_COMBINED,          // XOR of all of the above, advancing each
+    GENERATOR_COUNT
+};
+
+// Tunable parameters; changes take effect from the next fill
+struct GeneratorParams {
+    uint32_t lcgA;               // Multiplier, modulus 2^32
+    uint32_t lcgC;               // Increment
+    float logisticR;
+    float henonA;
+    float henonB;
+    float lorenzSigma;
+    float lorenzRho;
+    float lorenzBeta;
+    float lorenzDt;              // Euler step
+    uint16_t lfsrTaps;           // Galois feedback mask
+};
+
+class EntropyGeneratorBank {
+private:
+    // LCG
+    uint32_t lcgState;
+    uint32_t lcgOrigin;
+
+    // Mersenne Twister
+    uint32_t mt[GENERATOR_MT_SIZE];
+    uint16_t mtIndex;
+
+    // Chaotic maps
+    float logisticX;
+    float henonX;
+    float henonY;
+    float lorenzX;
+    float lorenzY;
+    float lorenzZ;
+
+    // Galois LFSR with 16-bit taps. The state keeps the seed's upper
+    // bits, which shift out over the first 16 steps.
+    uint32_t lfsrState;
+    uint32_t lfsrOrigin;
+
+    // Words produced since the last seed, per generator
+    uint64_t positions[GENERATOR_COUNT];
+
+    void seedMersenne(uint32_t seed);
+    void twist();
+    void jumpLCG(uint64_t steps);
+    void jumpLFSR(uint64_t steps);
+
+public:
+    GeneratorParams params;
+
+    EntropyGeneratorBank();
+
+    // Standard parameters and initial conditions, with the LCG and
+    // Mersenne Twister seeded from seed
+    void setDefaults(uint32_t seed);
+    // Derives every generator's state from seed; parameters are kept
+    void seed(uint32_t seed);
+
+    void fill(uint8_t id, uint32_t* out, uint16_t count);
+    void fillLCG(uint32_t* out, uint16_t count);
+    void fillMersenne(uint32_t* out, uint16_t count);
+    void fillLogistic(uint32_t* out, uint16_t count);
+    void fillHenon(uint32_t* out, uint16_t count);
+    void fillLorenz(uint32_t* out, uint16_t count);
+    void fillLFSR(uint32_t* out, uint16_t count);
+    void fillCombined(uint32_t* out, uint16_t count);
+
+    // Skips count words. O(log count) for the LCG and LFSR; the Mersenne
+    // Twister skips whole twists without tempering; the maps iterate.
+    void discard(uint8_t id, uint64_t count);
+    // Moves the LCG or LFSR to position words after the last seed, with
+    // the current parameters. Returns false for other generators.
+    bool seek(uint8_t id, uint64_t position);
+    uint64_t getPosition(uint8_t id) const { return id < GENERATOR_COUNT ? positions[id] : 0; }
+
+    static const char* generatorName(uint8_t id);
+};
+
+#endif // ENTROPY_GENERATOR_BANK_H
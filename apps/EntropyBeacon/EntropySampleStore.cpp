@@ -0,0 +1,193 @@
+#include "EntropySampleStore.h"
+#include <math.h>
+#include <string.h>
+
+EntropySampleStore::EntropySampleStore() :
+    values(nullptr),
+    timestamps(nullptr),
+    flags(nullptr),
+    shannon(nullptr),
+    complexity(nullptr),
+    scratch(nullptr),
+    otherScratch(nullptr),
+    capacity(0),
+    mask(0),
+    written(0)
+{
+}
+
+EntropySampleStore::~EntropySampleStore() {
+    release();
+}
+
+bool EntropySampleStore::allocate(uint16_t size) {
+    if (size < 2 || size > SAMPLE_STORE_MAX_CAPACITY || (size & (size - 1)) != 0) return false;
+    if (values && size == capacity) {
+        clear();
+        return true;
+    }
+
+    release();
+    values = new uint16_t[size];
+    timestamps = new uint32_t[size];
+    flags = new uint8_t[size];
+    shannon = new float[size];
+    complexity = new float[size];
+    scratch = new int16_t[SAMPLE_STORE_MAX_LAG + size];
+    otherScratch = new int16_t[size];
+    if (!values || !timestamps || !flags || !shannon || !complexity || !scratch || !otherScratch) {
+        release();
+        return false;
+    }
+
+    capacity = size;
+    mask = size - 1;
+    clear();
+    return true;
+}
+
+void EntropySampleStore::release() {
+    delete[] values;
+    delete[] timestamps;
+    delete[] flags;
+    delete[] shannon;
+    delete[] complexity;
+    delete[] scratch;
+    delete[] otherScratch;
+    values = nullptr;
+    timestamps = nullptr;
+    flags = nullptr;
+    shannon = nullptr;
+    complexity = nullptr;
+    scratch = nullptr;
+    otherScratch = nullptr;
+    capacity = 0;
+    mask = 0;
+    written = 0;
+}
+
+void EntropySampleStore::clear() {
+    written = 0;
+    if (!values) return;
+    memset(values, 0, capacity * sizeof(uint16_t));
+    memset(timestamps, 0, capacity * sizeof(uint32_t));
+    memset(flags, 0, capacity);
+    memset(shannon, 0, capacity * sizeof(float));
+    memset(complexity, 0, capacity * sizeof(float));
+    // Lag products read these leading zeros instead of branching
+    memset(scratch, 0, SAMPLE_STORE_MAX_LAG * sizeof(int16_t));
+}
+
+void EntropySampleStore::push(uint16_t value, uint32_t timestamp, uint8_t sampleFlags,
+                              float entropy, float complexityValue) {
+    if (!values) return;
+    uint16_t index = written & mask;
+    values[index] = value & 0x0FFF;
+    timestamps[index] = timestamp;
+    flags[index] = sampleFlags;
+    shannon[index] = entropy;
+    complexity[index] = complexityValue;
+    written++;
+}
+
+uint16_t EntropySampleStore::copyRecent(uint16_t* out, uint16_t count) const {
+    if (!values) return 0;
+    if (count > size()) count = size();
+
+    uint16_t start = (uint16_t)(written - count) & mask;
+    uint16_t first = capacity - start;
+    if (first >= count) {
+        memcpy(out, values + start, count * sizeof(uint16_t));
+    } else {
+        memcpy(out, values + start, first * sizeof(uint16_t));
+        memcpy(out + first, values, (count - first) * sizeof(uint16_t));
+    }
+    return count;
+}
+
+bool EntropySampleStore::computeMetrics(uint16_t count, WindowMetrics& metrics, const uint16_t* other) const {
+    if (!values) return false;
+    if (count > size()) count = size();
+    metrics.count = count;
+    if (count < 2) return false;
+
+    // Pass 1: linearize oldest first, centre, and histogram (the scatter
+    // is the one part that cannot vectorize)
+    int16_t* x = scratch + SAMPLE_STORE_MAX_LAG;
+    memset(metrics.histogram, 0, sizeof(metrics.histogram));
+    uint16_t start = (uint16_t)(written - count) & mask;
+    for (uint16_t i = 0; i < count; i++) {
+        uint16_t v = values[(start + i) & mask];
+        metrics.histogram[v >> 4]++;
+        x[i] = (int16_t)(v - SAMPLE_STORE_CENTER);
+    }
+    const int16_t* y = x;
+    if (other) {
+        for (uint16_t i = 0; i < count; i++) {
+            otherScratch[i] = (int16_t)(other[i] - SAMPLE_STORE_CENTER);
+        }
+        y = otherScratch;
+    }
+
+    // Pass 2: every running sum in one loop. Centred values keep each
+    // product under 2^22, so int32 sums hold SAMPLE_STORE_MAX_CAPACITY of them.
+    int32_t sum = 0, squares = 0, otherSum = 0, otherSquares = 0, cross = 0;
+    int32_t lag[SAMPLE_STORE_MAX_LAG] = {0};
+    for (uint16_t i = 0; i < count; i++) {
+        int32_t a = x[i], b = y[i];
+        sum += a;
+        squares += a * a;
+        otherSum += b;
+        otherSquares += b * b;
+        cross += a * b;
+        for (uint8_t k = 0; k < SAMPLE_STORE_MAX_LAG; k++) {
+            lag[k] += a * x[i - 1 - k];
+        }
+    }
+
+    double n = count;
+    double mean = sum / n;
+    metrics.mean = (float)(mean + SAMPLE_STORE_CENTER);
+    metrics.variance = (float)(squares / n - mean * mean);
+
+    // sum((c - E)^2 / E) = bins * sum(c^2) / N - N
+    uint32_t binSquares = 0;
+    for (uint16_t b = 0; b < SAMPLE_STORE_BINS; b++) {
+        binSquares += (uint32_t)metrics.histogram[b] * metrics.histogram[b];
+    }
+    metrics.chiSquare = (float)binSquares * SAMPLE_STORE_BINS / count - count;
+
+    // Pairs (x[i], x[i - lag]): the leading series drops the first lag
+    // samples, the lagging series drops the last lag samples
+    int32_t headSum = 0, headSquares = 0, tailSum = 0, tailSquares = 0;
+    for (uint8_t k = 0; k < SAMPLE_STORE_MAX_LAG; k++) {
+        uint8_t l = k + 1;
+        if (l >= count) {
+            metrics.serialCorrelation[k] = 0.0f;
+            continue;
+        }
+        int32_t h = x[k], t = x[count - 1 - k];
+        headSum += h;
+        headSquares += h * h;
+        tailSum += t;
+        tailSquares += t * t;
+
+        double pairs = count - l;
+        double s1 = sum - headSum, s2 = sum - tailSum;
+        double v1 = (double)(squares - headSquares) - s1 * s1 / pairs;
+        double v2 = (double)(squares - tailSquares) - s2 * s2 / pairs;
+        double c = (double)lag[k] - s1 * s2 / pairs;
+        double d = sqrt(v1 * v2);
+        metrics.serialCorrelation[k] = d > 0 ? (float)(c / d) : 0.0f;
+    }
+
+    metrics.crossCorrelation = 0.0f;
+    if (other) {
+        double v1 = (double)squares - (double)sum * sum / n;
+        double v2 = (double)otherSquares - (double)otherSum * otherSum / n;
+        double c = (double)cross - (double)sum * otherSum / n;
+        double d = sqrt(v1 * v2);
+        metrics.crossCorrelation = d > 0 ? (float)(c / d) : 0.0f;
+    }
+    return true;
+}
@@ -0,0 +1,88 @@
+#ifndef ENTROPY_SAMPLE_STORE_H
+#define ENTROPY_SAMPLE_STORE_H
+
+#include <stdint.h>
+
+// ========================================
+// EntropySampleStore - Sample ring kept as parallel arrays
+// Each field lives in its own array, so a pass over raw values touches
+// only 2 bytes per sample instead of a whole point record, and a
+// power-of-two capacity turns every ring index into a mask. Window
+// metrics come from one copy pass (which also fills the histogram) and
+// one fused arithmetic loop in int32 that compilers can vectorize.
+// Hardware independent.
+// ========================================
+
+#define SAMPLE_STORE_MAX_CAPACITY   256      // Keeps centred int32 sums from overflowing
+#define SAMPLE_STORE_MAX_LAG        10
+#define SAMPLE_STORE_BINS           256      // value >> 4
+#define SAMPLE_STORE_CENTER         2048     // 12-bit mid-scale
+
+// Flag bits stored per sample
+#define SAMPLE_FLAG_ANOMALY         0x80
+#define SAMPLE_SOURCE_MASK          0x0F
+
+struct WindowMetrics {
+    uint16_t count;
+    float mean;
+    float variance;
+    float chiSquare;                                  // Uniformity over SAMPLE_STORE_BINS
+    float serialCorrelation[SAMPLE_STORE_MAX_LAG];    // Lags 1..SAMPLE_STORE_MAX_LAG
+    float crossCorrelation;                           // Against the other series, if given
+    uint16_t histogram[SAMPLE_STORE_BINS];
+};
+
+class EntropySampleStore {
+private:
+    uint16_t* values;             // Raw 12-bit samples
+    uint32_t* timestamps;         // ms
+    uint8_t* flags;               // Source and anomaly bits
+    float* shannon;               // Per-sample entropy
+    float* complexity;            // Per-sample complexity
+    int16_t* scratch;             // Centred window, after SAMPLE_STORE_MAX_LAG zeros
+    int16_t* otherScratch;
+    uint16_t capacity;
+    uint16_t mask;
+    uint32_t written;             // Total pushes; the write slot is written & mask
+
+    uint16_t slot(uint16_t age) const { return (uint16_t)(written - 1 - age) & mask; }
+
+public:
+    EntropySampleStore();
+    ~EntropySampleStore();
+
+    // capacity must be a power of two up to SAMPLE_STORE_MAX_CAPACITY
+    bool allocate(uint16_t size);
+    void release();
+    void clear();
+
+    void push(uint16_t value, uint32_t timestamp, uint8_t sampleFlags, float entropy, float complexityValue);
+
+    // Accessors by age, 0 = newest; age must be below size()
+    uint16_t value(uint16_t age) const { return values[slot(age)]; }
+    float normalized(uint16_t age) const { return values[slot(age)] * (1.0f / 4095.0f); }
+    uint32_t timestamp(uint16_t age) const { return timestamps[slot(age)]; }
+    uint8_t sampleFlags(uint16_t age) const { return flags[slot(age)]; }
+    bool isAnomaly(uint16_t age) const { return (flags[slot(age)] & SAMPLE_FLAG_ANOMALY) != 0; }
+    uint8_t source(uint16_t age) const { return flags[slot(age)] & SAMPLE_SOURCE_MASK; }
+    float shannonEntropy(uint16_t age) const { return shannon[slot(age)]; }
+    float complexityAt(uint16_t age) const { return complexity[slot(age)]; }
+    void setAnomaly(uint16_t age) { flags[slot(age)] |= SAMPLE_FLAG_ANOMALY; }
+
+    // Newest count values, oldest first, in at most two block copies.
+    // Returns the number copied.
+    uint16_t copyRecent(uint16_t* out, uint16_t count) const;
+
+    // Mean, variance, chi-square, lag 1..10 serial correlation, histogram
+    // and (if other is given, oldest first, count long) cross-correlation
+    // of the newest count samples
+    bool computeMetrics(uint16_t count, WindowMetrics& metrics, const uint16_t* other = nullptr) const;
+
+    uint16_t size() const { return written < capacity ? (uint16_t)written : capacity; }
+    uint16_t getCapacity() const { return capacity; }
+    uint32_t getWritten() const { return written; }
+    bool isFull() const { return written >= capacity; }
+    bool isAllocated() const { return values != nullptr; }
+};
+
+#endif // ENTROPY_SAMPLE_STORE_H
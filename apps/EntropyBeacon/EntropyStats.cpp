@@ -0,0 +1,206 @@
+#include "EntropyStats.h"
+#include <math.h>
+#include <string.h>
+
+EntropyStats::EntropyStats() :
+    ring(nullptr),
+    nLog2n(nullptr),
+    window(0),
+    head(0),
+    count(0)
+{
+    reset();
+}
+
+EntropyStats::~EntropyStats() {
+    release();
+}
+
+bool EntropyStats::configure(uint16_t windowSize) {
+    if (windowSize < 2 || windowSize > ENTROPY_STATS_MAX_WINDOW) return false;
+
+    if (!ring || windowSize != window) {
+        release();
+        ring = new uint16_t[windowSize];
+        nLog2n = new uint32_t[windowSize + 1];
+        if (!ring || !nLog2n) {
+            release();
+            return false;
+        }
+        window = windowSize;
+
+        // No count can exceed the window, so the table stops there
+        nLog2n[0] = 0;
+        for (uint16_t n = 1; n <= window; n++) {
+            nLog2n[n] = (uint32_t)(n * log2((double)n) * ENTROPY_STATS_LOG_ONE + 0.5);
+        }
+    }
+
+    reset();
+    return true;
+}
+
+void EntropyStats::release() {
+    if (ring) {
+        delete[] ring;
+        ring = nullptr;
+    }
+    if (nLog2n) {
+        delete[] nLog2n;
+        nLog2n = nullptr;
+    }
+    window = 0;
+    head = 0;
+    count = 0;
+}
+
+void EntropyStats::reset() {
+    head = 0;
+    count = 0;
+    memset(bins, 0, sizeof(bins));
+    memset(pairs, 0, sizeof(pairs));
+    memset(newerSymbols, 0, sizeof(newerSymbols));
+    memset(olderSymbols, 0, sizeof(olderSymbols));
+    memset(lagProducts, 0, sizeof(lagProducts));
+    binLogSum = binSquareSum = 0;
+    pairLogSum = newerLogSum = olderLogSum = 0;
+    sum = sumSquares = 0;
+}
+
+uint16_t EntropyStats::at(uint16_t age) const {
+    int32_t index = (int32_t)head - 1 - age;
+    if (index < 0) index += window;
+    return ring[index];
+}
+
+// Unsigned wraparound is fine here: each sum only ever holds a true,
+// non-negative value once the delta is applied
+
+void EntropyStats::countBin(uint8_t bin, int8_t delta) {
+    uint16_t c = bins[bin];
+    uint16_t next = c + delta;
+    binLogSum += nLog2n[next] - nLog2n[c];
+    binSquareSum += (uint32_t)next * next - (uint32_t)c * c;
+    bins[bin] = next;
+}
+
+void EntropyStats::countPair(uint8_t newer, uint8_t older, int8_t delta) {
+    uint16_t c = pairs[newer][older];
+    pairLogSum += nLog2n[c + delta] - nLog2n[c];
+    pairs[newer][older] = c + delta;
+
+    c = newerSymbols[newer];
+    newerLogSum += nLog2n[c + delta] - nLog2n[c];
+    newerSymbols[newer] = c + delta;
+
+    c = olderSymbols[older];
+    olderLogSum += nLog2n[c + delta] - nLog2n[c];
+    olderSymbols[older] = c + delta;
+}
+
+void EntropyStats::removeOldest() {
+    // When full, the oldest sample sits where the next one will be written
+    uint16_t oldest = ring[head];
+    uint16_t age = count - 1;
+
+    countBin(oldest >> 4, -1);
+    if (count >= 2) {
+        countPair((at(age - 1) >> 8) & 0x0F, (oldest >> 8) & 0x0F, -1);
+    }
+    for (uint8_t lag = 1; lag <= ENTROPY_STATS_MAX_LAG && lag < count; lag++) {
+        lagProducts[lag - 1] -= (uint32_t)oldest * at(age - lag);
+    }
+    sum -= oldest;
+    sumSquares -= (uint32_t)oldest * oldest;
+    count--;
+}
+
+void EntropyStats::push(uint16_t value) {
+    if (!ring) return;
+    value &= 0x0FFF;
+
+    if (count == window) removeOldest();
+
+    countBin(value >> 4, +1);
+    if (count >= 1) {
+        countPair((value >> 8) & 0x0F, (at(0) >> 8) & 0x0F, +1);
+    }
+    for (uint8_t lag = 1; lag <= ENTROPY_STATS_MAX_LAG && lag <= count; lag++) {
+        lagProducts[lag - 1] += (uint32_t)value * at(lag - 1);
+    }
+    sum += value;
+    sumSquares += (uint32_t)value * value;
+
+    ring[head] = value;
+    head = (head + 1 == window) ? 0 : head + 1;
+    count++;
+}
+
+void EntropyStats::pushBlock(const uint16_t* values, uint16_t length) {
+    for (uint16_t i = 0; i < length; i++) {
+        push(values[i]);
+    }
+}
+
+float EntropyStats::shannonEntropy() const {
+    if (count == 0) return 0.0f;
+    // H = log2(N) - sum(c log2 c) / N
+    float h = log2f((float)count) - (float)binLogSum / ((float)count * ENTROPY_STATS_LOG_ONE);
+    return h > 0 ? h : 0.0f;
+}
+
+float EntropyStats::conditionalEntropy() const {
+    if (count < 2) return 0.0f;
+    // H(X,Y) - H(Y); the log2(P) terms cancel
+    uint32_t p = count - 1;
+    float h = ((float)olderLogSum - (float)pairLogSum) / ((float)p * ENTROPY_STATS_LOG_ONE);
+    return h > 0 ? h : 0.0f;
+}
+
+float EntropyStats::mutualInformation() const {
+    if (count < 2) return 0.0f;
+    // H(X) + H(Y) - H(X,Y)
+    uint32_t p = count - 1;
+    float i = log2f((float)p) -
+              ((float)newerLogSum + (float)olderLogSum - (float)pairLogSum) / ((float)p * ENTROPY_STATS_LOG_ONE);
+    return i > 0 ? i : 0.0f;
+}
+
+float EntropyStats::chiSquare() const {
+    if (count == 0) return 0.0f;
+    // sum((c - E)^2 / E) with E = N / 256 reduces to 256 * sum(c^2) / N - N
+    return (float)binSquareSum * ENTROPY_STATS_BINS / count - count;
+}
+
+float EntropyStats::serialCorrelation(uint8_t lag) const {
+    if (lag < 1 || lag > ENTROPY_STATS_MAX_LAG || lag >= count) return 0.0f;
+
+    // Pairs are (x[t], x[t - lag]); the leading series drops the oldest
+    // lag samples and the lagging one drops the newest lag samples
+    uint32_t n = count - lag;
+    uint64_t newestSum = 0, newestSquares = 0, oldestSum = 0, oldestSquares = 0;
+    for (uint8_t i = 0; i < lag; i++) {
+        uint32_t a = at(i), b = at(count - 1 - i);
+        newestSum += a;
+        newestSquares += a * a;
+        oldestSum += b;
+        oldestSquares += b * b;
+    }
+
+    double sum1 = (double)(sum - oldestSum), sum2 = (double)(sum - newestSum);
+    double var1 = (double)(sumSquares - oldestSquares) - sum1 * sum1 / n;
+    double var2 = (double)(sumSquares - newestSquares) - sum2 * sum2 / n;
+    double cov = (double)lagProducts[lag - 1] - sum1 * sum2 / n;
+    double denominator = sqrt(var1 * var2);
+    return denominator > 0 ? (float)(cov / denominator) : 0.0f;
+}
+
+float EntropyStats::mean() const {
+    return count ? (float)((double)sum / count) : 0.0f;
+}
+
+float EntropyStats::variance() const {
+    if (count == 0) return 0.0f;
+    double m = (double)sum / count;
+    return (float)((double)sumSquares / count - m * m);
+}
@@ -0,0 +1,78 @@
+#ifndef ENTROPY_STATS_H
+#define ENTROPY_STATS_H
+
+#include <stdint.h>
+
+// ========================================
+// EntropyStats - Sliding-window statistics updated per sample
+// Keeps the histograms, adjacent-pair table and running sums of the last
+// window samples, adjusting them as a value enters and the oldest leaves,
+// so every metric can be read at any time without rescanning the window.
+// Entropies are maintained as sums of c*log2(c) over the counts, looked
+// up in a fixed-point table; integer deltas keep them exact over any run
+// length. Matches the EntropyBeacon analysis functions on a newest-first
+// copy of the same window. Hardware independent.
+// ========================================
+
+#define ENTROPY_STATS_MAX_WINDOW   1024
+#define ENTROPY_STATS_BINS         256     // 12-bit value >> 4
+#define ENTROPY_STATS_SYMBOLS      16      // 12-bit value >> 8, for pair statistics
+#define ENTROPY_STATS_MAX_LAG      10
+#define ENTROPY_STATS_LOG_ONE      65536   // Q16 scale of the c*log2(c) table
+
+class EntropyStats {
+private:
+    uint16_t* ring;                  // Last window values, oldest at head when full
+    uint32_t* nLog2n;                // Q16 n*log2(n), window + 1 entries
+    uint16_t window;
+    uint16_t head;                   // Next write position
+    uint16_t count;
+
+    uint16_t bins[ENTROPY_STATS_BINS];
+    uint32_t binLogSum;              // Sum of nLog2n[bin count]
+    uint32_t binSquareSum;           // Sum of bin count^2, for chi-square
+
+    // Adjacent pairs as (newer, older) high nibbles
+    uint16_t pairs[ENTROPY_STATS_SYMBOLS][ENTROPY_STATS_SYMBOLS];
+    uint16_t newerSymbols[ENTROPY_STATS_SYMBOLS];
+    uint16_t olderSymbols[ENTROPY_STATS_SYMBOLS];
+    uint32_t pairLogSum;
+    uint32_t newerLogSum;
+    uint32_t olderLogSum;
+
+    uint64_t sum;
+    uint64_t sumSquares;
+    uint64_t lagProducts[ENTROPY_STATS_MAX_LAG];   // Sum of x[t] * x[t - lag] inside the window
+
+    uint16_t at(uint16_t age) const;              // 0 = newest
+    void countBin(uint8_t bin, int8_t delta);
+    void countPair(uint8_t newer, uint8_t older, int8_t delta);
+    void removeOldest();
+
+public:
+    EntropyStats();
+    ~EntropyStats();
+
+    bool configure(uint16_t windowSize);
+    void release();
+    void reset();
+
+    // O(1) per sample plus one multiply-add per lag; values are 12-bit
+    void push(uint16_t value);
+    void pushBlock(const uint16_t* values, uint16_t length);
+
+    // Metrics over the samples currently in the window
+    float shannonEntropy() const;        // Bits, 256 bins
+    float conditionalEntropy() const;    // H(newer | older) on high nibbles
+    float mutualInformation() const;     // I(newer; older) on high nibbles
+    float chiSquare() const;             // Uniformity over 256 bins
+    float serialCorrelation(uint8_t lag) const;
+    float mean() const;
+    float variance() const;
+
+    uint16_t getCount() const { return count; }
+    uint16_t getWindow() const { return window; }
+    bool isConfigured() const { return ring != nullptr; }
+};
+
+#endif // ENTROPY_STATS_H
@@ -0,0 +1,399 @@
+#include "EntropySynth.h"
+#include <math.h>
+
+#define SYNTH_PHASE_SCALE    4294967296.0f                 // 2^32, one cycle
+#define SYNTH_RADIANS_SCALE  (4294967296.0f / 6.2831853f)  // Phase units per radian
+#define SYNTH_FRAC_BITS      (32 - SYNTH_SINE_TABLE_BITS)
+#define SYNTH_FRAC_SCALE     (1.0f / (float)(1UL << SYNTH_FRAC_BITS))
+#define SYNTH_BUTTERWORTH_Q  0.7071f
+
+float EntropySynth::sineTable[SYNTH_SINE_TABLE_SIZE + 1];
+bool EntropySynth::sineTableReady = false;
+
+static inline float lerp(float a, float b, float t) {
+    return a + (b - a) * t;
+}
+
+static inline float clampUnit(float v) {
+    return v < 0.0f ? 0.0f : (v > 1.0f ? 1.0f : v);
+}
+
+// ===== BIQUAD =====
+
+void Biquad::reset() {
+    z1 = 0.0f;
+    z2 = 0.0f;
+}
+
+void Biquad::setLowpass(float cutoff, float q, float sampleRate) {
+    float w = 6.2831853f * cutoff / sampleRate;
+    float c = cosf(w);
+    float alpha = sinf(w) / (2.0f * q);
+    float norm = 1.0f / (1.0f + alpha);
+    b0 = (1.0f - c) * 0.5f * norm;
+    b1 = (1.0f - c) * norm;
+    b2 = b0;
+    a1 = -2.0f * c * norm;
+    a2 = (1.0f - alpha) * norm;
+}
+
+void Biquad::setHighpass(float cutoff, float q, float sampleRate) {
+    float w = 6.2831853f * cutoff / sampleRate;
+    float c = cosf(w);
+    float alpha = sinf(w) / (2.0f * q);
+    float norm = 1.0f / (1.0f + alpha);
+    b0 = (1.0f + c) * 0.5f * norm;
+    b1 = -(1.0f + c) * norm;
+    b2 = b0;
+    a1 = -2.0f * c * norm;
+    a2 = (1.0f - alpha) * norm;
+}
+
+void Biquad::process(float* data, uint16_t count) {
+    float s1 = z1, s2 = z2;
+    for (uint16_t i = 0; i < count; i++) {
+        float x = data[i];
+        float y = b0 * x + s1;
+        s1 = b1 * x - a1 * y + s2;
+        s2 = b2 * x - a2 * y;
+        data[i] = y;
+    }
+    z1 = s1;
+    z2 = s2;
+}
+
+void Biquad::processTo(float* data, uint16_t count, const Biquad& next) {
+    float step = 1.0f / count;
+    float db0 = (next.b0 - b0) * step, db1 = (next.b1 - b1) * step, db2 = (next.b2 - b2) * step;
+    float da1 = (next.a1 - a1) * step, da2 = (next.a2 - a2) * step;
+    float s1 = z1, s2 = z2;
+    for (uint16_t i = 0; i < count; i++) {
+        b0 += db0;
+        b1 += db1;
+        b2 += db2;
+        a1 += da1;
+        a2 += da2;
+        float x = data[i];
+        float y = b0 * x + s1;
+        s1 = b1 * x - a1 * y + s2;
+        s2 = b2 * x - a2 * y;
+        data[i] = y;
+    }
+    z1 = s1;
+    z2 = s2;
+    b0 = next.b0;
+    b1 = next.b1;
+    b2 = next.b2;
+    a1 = next.a1;
+    a2 = next.a2;
+}
+
+// ===== SYNTH =====
+
+EntropySynth::EntropySynth() :
+    sampleRate(SYNTH_SAMPLE_RATE),
+    glidePosition(SYNTH_GLIDE_SAMPLES),
+    phase(0),
+    modPhase(0),
+    pulsePhase(0),
+    holdPhase(0),
+    noiseState(0x2545F491),
+    heldNoise(0.0f)
+{
+    initSineTable();
+    reset();
+}
+
+void EntropySynth::initSineTable() {
+    if (sineTableReady) return;
+    for (uint16_t i = 0; i <= SYNTH_SINE_TABLE_SIZE; i++) {
+        sineTable[i] = (float)sin(2.0 * M_PI * i / SYNTH_SINE_TABLE_SIZE);
+    }
+    sineTableReady = true;
+}
+
+float EntropySynth::sine(uint32_t p) {
+    uint32_t index = p >> SYNTH_FRAC_BITS;
+    float frac = (float)(p & ((1UL << SYNTH_FRAC_BITS) - 1)) * SYNTH_FRAC_SCALE;
+    return lerp(sineTable[index], sineTable[index + 1], frac);
+}
+
+void EntropySynth::begin(uint32_t rate) {
+    sampleRate = rate ? rate : 1;
+    reset();
+}
+
+void EntropySynth::reset() {
+    phase = 0;
+    modPhase = 0;
+    pulsePhase = 0;
+    holdPhase = 0;
+    heldNoise = 0.0f;
+    from = silence();
+    target = from;
+    glidePosition = SYNTH_GLIDE_SAMPLES;
+    lowpass.reset();
+    lowpass.setLowpass(from.cutoff, from.resonance, (float)sampleRate);
+    dcBlock.reset();
+    dcBlock.setHighpass(SYNTH_DC_CUTOFF, SYNTH_BUTTERWORTH_Q, (float)sampleRate);
+}
+
+void EntropySynth::setControls(const SynthControls& controls) {
+    // Glide on from wherever the previous glide has got to
+    from = valuesAt(glidePosition);
+    target = controls;
+    glidePosition = 0;
+}
+
+SynthControls EntropySynth::valuesAt(uint16_t position) const {
+    if (position >= SYNTH_GLIDE_SAMPLES) return target;
+
+    float t = (float)position / SYNTH_GLIDE_SAMPLES;
+    SynthControls c = target;
+    c.pitch = lerp(from.pitch, target.pitch, t);
+    c.cutoff = lerp(from.cutoff, target.cutoff, t);
+    c.resonance = lerp(from.resonance, target.resonance, t);
+    c.fmRatio = lerp(from.fmRatio, target.fmRatio, t);
+    c.fmIndex = lerp(from.fmIndex, target.fmIndex, t);
+    c.pulseRate = lerp(from.pulseRate, target.pulseRate, t);
+    c.pulseWidth = lerp(from.pulseWidth, target.pulseWidth, t);
+    c.holdRate = lerp(from.holdRate, target.holdRate, t);
+    c.level = lerp(from.level, target.level, t);
+    return c;
+}
+
+float EntropySynth::nextNoise() {
+    noiseState ^= noiseState << 13;
+    noiseState ^= noiseState >> 17;
+    noiseState ^= noiseState << 5;
+    return (float)(int32_t)noiseState * (1.0f / 2147483648.0f);
+}
+
+uint32_t EntropySynth::frequencyToIncrement(float hz) const {
+    if (hz <= 0.0f) return 0;
+    float inc = hz / sampleRate * SYNTH_PHASE_SCALE;
+    return inc >= SYNTH_PHASE_SCALE * 0.5f ? 0x7FFFFFFFu : (uint32_t)inc;
+}
+
+void EntropySynth::render(float* out, uint32_t count) {
+    while (count > 0) {
+        uint16_t n = count < SYNTH_CONTROL_STEP ? (uint16_t)count : SYNTH_CONTROL_STEP;
+        renderSegment(out, n);
+        out += n;
+        count -= n;
+    }
+}
+
+// Output low-pass for one control step. Switching coefficients at once
+// would step the output at every segment edge while the cutoff glides,
+// so they ramp to the values for the segment's end instead.
+void EntropySynth::filterSegment(float* out, uint16_t count, const SynthControls& end) {
+    float cutoff = end.cutoff;
+    float nyquistLimit = 0.45f * sampleRate;
+    if (cutoff < SYNTH_MIN_CUTOFF) cutoff = SYNTH_MIN_CUTOFF;
+    if (cutoff > nyquistLimit) cutoff = nyquistLimit;
+    float q = end.resonance;
+    if (q < 0.5f) q = 0.5f;
+
+    Biquad next;
+    next.setLowpass(cutoff, q, (float)sampleRate);
+    lowpass.processTo(out, count, next);
+}
+
+// One control step: controls at both ends, per-sample ramps between them
+void EntropySynth::renderSegment(float* out, uint16_t count) {
+    SynthControls a = valuesAt(glidePosition);
+    uint16_t end = glidePosition + count;
+    if (end > SYNTH_GLIDE_SAMPLES) end = SYNTH_GLIDE_SAMPLES;
+    SynthControls b = valuesAt(end);
+    glidePosition = end;
+
+    if (target.voice == SYNTH_SILENT) {
+        for (uint16_t i = 0; i < count; i++) out[i] = 0.0f;
+        return;
+    }
+
+    float step = 1.0f / count;
+
+    switch (target.voice) {
+        case SYNTH_NOISE: {
+            uint32_t inc = frequencyToIncrement(a.holdRate);
+            int32_t incStep = ((int32_t)frequencyToIncrement(b.holdRate) - (int32_t)inc) / count;
+            uint32_t p = holdPhase;
+            float held = heldNoise;
+            for (uint16_t i = 0; i < count; i++) {
+                uint32_t next = p + inc;
+                if (next < p) held = nextNoise();
+                p = next;
+                inc += incStep;
+                out[i] = held;
+            }
+            holdPhase = p;
+            heldNoise = held;
+            break;
+        }
+
+        case SYNTH_FILTERED_NOISE:
+            for (uint16_t i = 0; i < count; i++) out[i] = nextNoise();
+            filterSegment(out, count, b);
+            break;
+
+        case SYNTH_TONE: {
+            uint32_t inc = frequencyToIncrement(a.pitch);
+            int32_t incStep = ((int32_t)frequencyToIncrement(b.pitch) - (int32_t)inc) / count;
+            uint32_t p = phase;
+            for (uint16_t i = 0; i < count; i++) {
+                float v;
+                switch (target.waveform) {
+                    case SYNTH_WAVE_SQUARE:   v = (p & 0x80000000u) ? -1.0f : 1.0f; break;
+                    case SYNTH_WAVE_SAW:      v = (float)p * (2.0f / SYNTH_PHASE_SCALE) - 1.0f; break;
+                    case SYNTH_WAVE_TRIANGLE: v = fabsf((float)p * (4.0f / SYNTH_PHASE_SCALE) - 2.0f) - 1.0f; break;
+                    default:                  v = sine(p); break;
+                }
+                out[i] = v;
+                p += inc;
+                inc += incStep;
+            }
+            phase = p;
+            filterSegment(out, count, b);
+            break;
+        }
+
+        case SYNTH_FM: {
+            uint32_t inc = frequencyToIncrement(a.pitch);
+            int32_t incStep = ((int32_t)frequencyToIncrement(b.pitch) - (int32_t)inc) / count;
+            uint32_t modInc = frequencyToIncrement(a.pitch * a.fmRatio);
+            int32_t modStep = ((int32_t)frequencyToIncrement(b.pitch * b.fmRatio) - (int32_t)modInc) / count;
+            float index = a.fmIndex * SYNTH_RADIANS_SCALE;
+            float indexStep = (b.fmIndex - a.fmIndex) * SYNTH_RADIANS_SCALE * step;
+            uint32_t p = phase, m = modPhase;
+            for (uint16_t i = 0; i < count; i++) {
+                // The deviation can pass half a cycle, so it wraps through int64
+                uint32_t deviation = (uint32_t)(int64_t)(index * sine(m));
+                out[i] = sine(p + deviation);
+                p += inc;
+                m += modInc;
+                inc += incStep;
+                modInc += modStep;
+                index += indexStep;
+            }
+            phase = p;
+            modPhase = m;
+            filterSegment(out, count, b);
+            break;
+        }
+
+        case SYNTH_PULSE: {
+            uint32_t inc = frequencyToIncrement(a.pulseRate);
+            int32_t incStep = ((int32_t)frequencyToIncrement(b.pulseRate) - (int32_t)inc) / count;
+            float width = clampUnit(a.pulseWidth) * SYNTH_PHASE_SCALE;
+            float widthStep = (clampUnit(b.pulseWidth) - clampUnit(a.pulseWidth)) * SYNTH_PHASE_SCALE * step;
+            uint32_t p = pulsePhase;
+            for (uint16_t i = 0; i < count; i++) {
+                out[i] = ((float)p < width) ? 1.0f : -1.0f;
+                p += inc;
+                inc += incStep;
+                width += widthStep;
+            }
+            pulsePhase = p;
+            filterSegment(out, count, b);
+            break;
+        }
+
+        default:
+            break;
+    }
+
+    // Offset removal, then the level ramp with a hard limit for resonant peaks
+    dcBlock.process(out, count);
+    float level = a.level;
+    float levelStep = (b.level - a.level) * step;
+    for (uint16_t i = 0; i < count; i++) {
+        float v = out[i] * level;
+        out[i] = v > 1.0f ? 1.0f : (v < -1.0f ? -1.0f : v);
+        level += levelStep;
+    }
+}
+
+// ===== CONTROL MAPPING =====
+
+SynthControls EntropySynth::silence() {
+    SynthControls c;
+    c.voice = SYNTH_SILENT;
+    c.waveform = SYNTH_WAVE_SINE;
+    c.pitch = 440.0f;
+    c.cutoff = 4000.0f;
+    c.resonance = SYNTH_BUTTERWORTH_Q;
+    c.fmRatio = 1.0f;
+    c.fmIndex = 0.0f;
+    c.pulseRate = 0.0f;
+    c.pulseWidth = 0.5f;
+    c.holdRate = 0.0f;
+    c.level = 0.0f;
+    return c;
+}
+
+SynthControls EntropySynth::controlsFor(SynthVoice voice, float normalized, float shannonEntropy,
+                                        float complexity, bool anomaly, uint8_t source) {
+    SynthControls c = silence();
+    c.voice = voice;
+
+    float value = clampUnit(normalized);
+    float order = clampUnit(shannonEntropy / 8.0f);     // 1 = uniform bytes
+    float structure = clampUnit(complexity / 9.0f);     // 1 = incompressible
+
+    switch (voice) {
+        case SYNTH_NOISE:
+            // Raw values: the hold rate follows the sample value
+            c.holdRate = 500.0f + value * 7500.0f;
+            c.level = 0.8f;
+            break;
+
+        case SYNTH_FILTERED_NOISE:
+            // Brighter for higher values, more resonant for predictable data
+            c.cutoff = 200.0f * powf(20.0f, value);          // 200 Hz - 4 kHz
+            c.resonance = SYNTH_BUTTERWORTH_Q + 6.0f * (1.0f - order);
+            c.level = 0.7f;
+            break;
+
+        case SYNTH_TONE:
+            c.waveform = (SynthWaveform)(source % 4);
+            c.pitch = (200.0f + order * 800.0f) * (1.0f + 0.3f * structure);
+            c.cutoff = c.pitch * 6.0f;
+            c.level = anomaly ? 0.8f : 0.5f;
+            break;
+
+        case SYNTH_FM:
+            c.pitch = 440.0f + value * 1000.0f;
+            c.fmRatio = 0.5f + 3.0f * structure;
+            c.fmIndex = (0.5f + 5.5f * order) * (anomaly ? 2.0f : 1.0f);
+            c.cutoff = 6000.0f;
+            c.level = 0.6f;
+            break;
+
+        case SYNTH_PULSE:
+            // 0.5 - 2.5 ms pulse spacing, stretched by complexity
+            c.pulseRate = 1.0f / ((0.0005f + value * 0.002f) * (1.0f + 0.5f * structure));
+            c.pulseWidth = 0.1f + 0.8f * order;
+            if (anomaly) {
+                c.pulseRate *= 2.0f;
+                c.pulseWidth = 0.95f;
+            }
+            c.cutoff = 5000.0f;
+            c.level = 0.6f;
+            break;
+
+        default:
+            break;
+    }
+    return c;
+}
+
+void EntropySynth::toDacSamples(const float* in, uint16_t* out, uint32_t count) {
+    for (uint32_t i = 0; i < count; i++) {
+        float v = in[i] * 127.5f + 128.0f;
+        if (v < 0.0f) v = 0.0f;
+        if (v > 255.0f) v = 255.0f;
+        out[i] = (uint16_t)v << 8;
+    }
+}
@@ -0,0 +1,122 @@
+#ifndef ENTROPY_SYNTH_H
+#define ENTROPY_SYNTH_H
+
+#include <stdint.h>
+
+// ========================================
+// EntropySynth - Block-rendered sonification of entropy measurements.
+// A handful of voices (sample-and-hold noise, resonant filtered noise,
+// tone, two-operator FM, pulse train) run through block-processed
+// biquads. Entropy readings arrive as control targets a few dozen times
+// a second; pitch, FM index, pulse rate, level and filter cutoff glide
+// to them so the output has no control-rate steps. Hardware independent
+// so blocks can be rendered and timed on a host.
+// ========================================
+
+#define SYNTH_SAMPLE_RATE       16000
+#define SYNTH_BLOCK_SIZE        256       // Samples per rendered block
+#define SYNTH_CONTROL_STEP      32        // Samples per control segment
+#define SYNTH_GLIDE_SAMPLES     512       // Time to reach new control targets
+#define SYNTH_SINE_TABLE_BITS   10
+#define SYNTH_SINE_TABLE_SIZE   (1 << SYNTH_SINE_TABLE_BITS)
+#define SYNTH_DC_CUTOFF         20.0f     // Hz, removes offset from unipolar voices
+#define SYNTH_MIN_CUTOFF        40.0f
+
+enum SynthVoice : uint8_t {
+    SYNTH_SILENT,
+    SYNTH_NOISE,              // Sample-and-hold noise, unfiltered
+    SYNTH_FILTERED_NOISE,     // White noise through the resonant low-pass
+    SYNTH_TONE,               // Oscillator through the low-pass
+    SYNTH_FM,                 // Sine carrier, sine modulator
+    SYNTH_PULSE               // Pulse train through the low-pass
+};
+
+enum SynthWaveform : uint8_t {
+    SYNTH_WAVE_SINE,
+    SYNTH_WAVE_SQUARE,
+    SYNTH_WAVE_SAW,
+    SYNTH_WAVE_TRIANGLE
+};
+
+// Control targets; voice and waveform switch at once, the rest glide
+struct SynthControls {
+    SynthVoice voice;
+    SynthWaveform waveform;
+    float pitch;              // Hz
+    float cutoff;             // Hz, output low-pass
+    float resonance;          // Low-pass Q
+    float fmRatio;            // Modulator / carrier frequency
+    float fmIndex;            // Peak phase deviation, radians
+    float pulseRate;          // Pulses per second
+    float pulseWidth;         // Fraction of each pulse period, 0.0-1.0
+    float holdRate;           // Noise values per second
+    float level;              // 0.0-1.0
+};
+
+// Transposed direct form II; coefficients from the RBJ cookbook
+struct Biquad {
+    float b0, b1, b2, a1, a2;
+    float z1, z2;
+
+    void reset();
+    void setLowpass(float cutoff, float q, float sampleRate);
+    void setHighpass(float cutoff, float q, float sampleRate);
+    void process(float* data, uint16_t count);
+    // Filters with the coefficients moving linearly to those of next,
+    // which they equal afterwards
+    void processTo(float* data, uint16_t count, const Biquad& next);
+};
+
+class EntropySynth {
+private:
+    SynthControls from;           // Values when the current glide began
+    SynthControls target;
+    uint32_t sampleRate;
+    uint16_t glidePosition;       // Samples into the glide, SYNTH_GLIDE_SAMPLES when done
+
+    uint32_t phase;               // Carrier / oscillator, full scale = one cycle
+    uint32_t modPhase;
+    uint32_t pulsePhase;
+    uint32_t holdPhase;
+    uint32_t noiseState;          // xorshift32
+    float heldNoise;
+
+    Biquad lowpass;
+    Biquad dcBlock;
+
+    static float sineTable[SYNTH_SINE_TABLE_SIZE + 1];
+    static bool sineTableReady;
+
+    float nextNoise();
+    uint32_t frequencyToIncrement(float hz) const;
+    SynthControls valuesAt(uint16_t position) const;
+    void filterSegment(float* out, uint16_t count, const SynthControls& end);
+    void renderSegment(float* out, uint16_t count);
+
+public:
+    EntropySynth();
+
+    void begin(uint32_t rate);
+    void reset();
+    // New targets, reached SYNTH_GLIDE_SAMPLES after the current sample
+    void setControls(const SynthControls& controls);
+    const SynthControls& getControls() const { return target; }
+    uint32_t getSampleRate() const { return sampleRate; }
+
+    // Renders count samples in [-1, 1]
+    void render(float* out, uint32_t count);
+
+    // Maps an entropy reading to controls for a voice. shannonEntropy is in
+    // bits (0-8), complexity in LZ bits per symbol (0-9).
+    static SynthControls controlsFor(SynthVoice voice, float normalized, float shannonEntropy,
+                                     float complexity, bool anomaly, uint8_t source);
+    static SynthControls silence();
+
+    static float sine(uint32_t phase);
+    static void initSineTable();
+
+    // Converts to the I2S built-in DAC format (unsigned, 8 bits in the high byte)
+    static void toDacSamples(const float* in, uint16_t* out, uint32_t count);
+};
+
+#endif // ENTROPY_SYNTH_H
@@ -0,0 +1,217 @@
+#include "LZEstimator.h"
+#include <string.h>
+
+LZEstimator::LZEstimator() :
+    head(nullptr),
+    chain(nullptr),
+    streamBuffer(nullptr),
+    capacity(0),
+    hashBits(0),
+    windowSize(LZ_DEFAULT_WINDOW),
+    offsetBits(10),
+    maxChain(LZ_DEFAULT_CHAIN),
+    nextInsert(0),
+    blockSize(0),
+    dictionaryFill(0),
+    blockFill(0),
+    streamBytes(0),
+    streamBits(0),
+    lastBlockBits(0)
+{
+}
+
+LZEstimator::~LZEstimator() {
+    release();
+}
+
+bool LZEstimator::configure(uint16_t maxLength, uint16_t window, uint8_t chainLimit) {
+    if (maxLength < LZ_MIN_MATCH || maxLength > LZ_MAX_CAPACITY) return false;
+    if (window < 16 || (window & (window - 1)) != 0 || chainLimit == 0) return false;
+
+    release();
+
+    // Hash table sized to the input: clearing it is part of every estimate
+    hashBits = 8;
+    while (hashBits < 12 && (1u << hashBits) < maxLength) hashBits++;
+
+    head = new uint16_t[1u << hashBits];
+    chain = new uint16_t[maxLength];
+    if (!head || !chain) {
+        release();
+        return false;
+    }
+
+    capacity = maxLength;
+    windowSize = window;
+    maxChain = chainLimit;
+    offsetBits = 0;
+    while ((1u << offsetBits) < window) offsetBits++;
+    return true;
+}
+
+void LZEstimator::release() {
+    if (head) {
+        delete[] head;
+        head = nullptr;
+    }
+    if (chain) {
+        delete[] chain;
+        chain = nullptr;
+    }
+    if (streamBuffer) {
+        delete[] streamBuffer;
+        streamBuffer = nullptr;
+    }
+    capacity = 0;
+    blockSize = 0;
+}
+
+uint16_t LZEstimator::hashAt(const uint8_t* data) const {
+    uint32_t key = ((uint32_t)data[0] << 16) | ((uint32_t)data[1] << 8) | data[2];
+    return (uint16_t)((key * 2654435761u) >> (32 - hashBits));
+}
+
+void LZEstimator::insertUpTo(const uint8_t* data, uint16_t limit, uint16_t end) {
+    // Only positions with a full minimum match ahead of them can be found
+    uint16_t last = (end >= LZ_MIN_MATCH) ? end - LZ_MIN_MATCH + 1 : 0;
+    if (limit > last) limit = last;
+
+    while (nextInsert < limit) {
+        uint16_t h = hashAt(data + nextInsert);
+        chain[nextInsert] = head[h];
+        head[h] = nextInsert;
+        nextInsert++;
+    }
+}
+
+uint16_t LZEstimator::findMatch(const uint8_t* data, uint16_t pos, uint16_t end, uint16_t& offset) const {
+    if (pos + LZ_MIN_MATCH > end) return 0;
+
+    uint16_t limit = end - pos;
+    if (limit > LZ_MAX_MATCH) limit = LZ_MAX_MATCH;
+
+    uint16_t best = 0;
+    uint16_t candidate = head[hashAt(data + pos)];
+    const uint8_t* target = data + pos;
+
+    for (uint8_t tries = 0; candidate != LZ_NO_POSITION && tries < maxChain; tries++) {
+        uint16_t distance = pos - candidate;
+        if (distance > windowSize) break;    // Chains run newest to oldest
+
+        // Check the byte that would extend the best match before anything else
+        const uint8_t* source = data + candidate;
+        if (source[best] == target[best] && source[0] == target[0]) {
+            uint16_t length = 0;
+            while (length < limit && source[length] == target[length]) length++;
+            if (length > best) {
+                best = length;
+                offset = distance;
+                if (best == limit) break;
+            }
+        }
+        candidate = chain[candidate];
+    }
+    return best >= LZ_MIN_MATCH ? best : 0;
+}
+
+uint32_t LZEstimator::compressedBits(const uint8_t* data, uint16_t length, uint16_t dictionary,
+                                     LZToken* tokens, uint16_t maxTokens, uint16_t* tokenCount) {
+    if (tokenCount) *tokenCount = 0;
+    if (!head || !data || length == 0) return 0;
+    if ((uint32_t)dictionary + length > capacity) return 0;
+
+    uint16_t end = dictionary + length;
+    uint32_t matchBits = 1 + offsetBits + LZ_LENGTH_BITS;
+    uint32_t bits = 0;
+    uint16_t count = 0;
+
+    memset(head, 0xFF, sizeof(uint16_t) << hashBits);
+    nextInsert = 0;
+
+    uint16_t pos = dictionary;
+    while (pos < end) {
+        insertUpTo(data, pos, end);
+
+        uint16_t offset = 0;
+        uint16_t matchLength = findMatch(data, pos, end, offset);
+
+        // Lazy matching: a literal is better if the next position matches longer
+        if (matchLength > 0 && matchLength < LZ_MAX_MATCH) {
+            insertUpTo(data, pos + 1, end);
+            uint16_t nextOffset = 0;
+            if (findMatch(data, pos + 1, end, nextOffset) > matchLength) matchLength = 0;
+        }
+
+        if (tokens && count < maxTokens) {
+            tokens[count].length = matchLength;
+            tokens[count].offset = matchLength ? offset : 0;
+            tokens[count].literal = data[pos];
+        }
+        count++;
+
+        if (matchLength > 0) {
+            bits += matchBits;
+            pos += matchLength;
+        } else {
+            bits += LZ_LITERAL_BITS;
+            pos++;
+        }
+    }
+
+    if (tokenCount) *tokenCount = count < maxTokens ? count : maxTokens;
+    return bits;
+}
+
+float LZEstimator::ratio(const uint8_t* data, uint16_t length) {
+    if (length == 0) return 0.0f;
+    return compressedBits(data, length) / (8.0f * length);
+}
+
+float LZEstimator::bitsPerSymbol(const uint8_t* data, uint16_t length) {
+    if (length == 0) return 0.0f;
+    return (float)compressedBits(data, length) / length;
+}
+
+bool LZEstimator::beginStream(uint16_t block) {
+    if (!head || block < LZ_MIN_MATCH || 2u * block > capacity) return false;
+
+    if (!streamBuffer || block != blockSize) {
+        if (streamBuffer) delete[] streamBuffer;
+        streamBuffer = new uint8_t[2 * block];
+        if (!streamBuffer) return false;
+    }
+    blockSize = block;
+    dictionaryFill = 0;
+    blockFill = 0;
+    streamBytes = 0;
+    streamBits = 0;
+    lastBlockBits = 0;
+    return true;
+}
+
+bool LZEstimator::push(uint8_t value) {
+    if (!streamBuffer) return false;
+
+    streamBuffer[dictionaryFill + blockFill++] = value;
+    if (blockFill < blockSize) return false;
+
+    lastBlockBits = compressedBits(streamBuffer, blockSize, dictionaryFill);
+    streamBits += lastBlockBits;
+    streamBytes += blockSize;
+
+    // The finished block becomes the history for the next one
+    if (dictionaryFill > 0) {
+        memmove(streamBuffer, streamBuffer + dictionaryFill, blockSize);
+    }
+    dictionaryFill = blockSize;
+    blockFill = 0;
+    return true;
+}
+
+float LZEstimator::getBlockBitsPerSymbol() const {
+    return blockSize ? (float)lastBlockBits / blockSize : 0.0f;
+}
+
+float LZEstimator::getStreamBitsPerSymbol() const {
+    return streamBytes ? (float)streamBits / streamBytes : 0.0f;
+}
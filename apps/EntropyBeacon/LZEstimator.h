@@ -0,0 +1,88 @@
+#ifndef LZ_ESTIMATOR_H
+#define LZ_ESTIMATOR_H
+
+#include <stdint.h>
+
+// ========================================
+// LZEstimator - LZ77 compressed-size estimate for complexity analysis
+// Parses the input the way an LZSS coder would (hash-chain match search
+// over a bounded window, one step of lazy matching) and counts the bits
+// the tokens would take, without producing any output. Compressed bits
+// per symbol approach the source entropy rate for long inputs and fall
+// quickly for repetitive or biased data. A streaming mode compresses
+// each block with the previous one as dictionary. Hardware independent.
+// ========================================
+
+#define LZ_MIN_MATCH         3
+#define LZ_MAX_MATCH         34      // 5-bit length code
+#define LZ_LITERAL_BITS      9       // Flag + byte
+#define LZ_LENGTH_BITS       5
+#define LZ_DEFAULT_WINDOW    1024
+#define LZ_DEFAULT_CHAIN     16      // Candidates tried per position
+#define LZ_MAX_CAPACITY      4096    // Largest input (plus dictionary) per estimate
+#define LZ_NO_POSITION       0xFFFF
+
+// One parsed token; length 0 means a literal
+struct LZToken {
+    uint16_t length;
+    uint16_t offset;      // Distance back to the match
+    uint8_t literal;
+};
+
+class LZEstimator {
+private:
+    uint16_t* head;               // Newest position per hash
+    uint16_t* chain;              // Previous position with the same hash
+    uint8_t* streamBuffer;        // Dictionary block + block being filled
+    uint16_t capacity;
+    uint8_t hashBits;
+    uint16_t windowSize;
+    uint8_t offsetBits;
+    uint8_t maxChain;
+    uint16_t nextInsert;
+
+    uint16_t blockSize;
+    uint16_t dictionaryFill;
+    uint16_t blockFill;
+    uint32_t streamBytes;
+    uint32_t streamBits;
+    uint32_t lastBlockBits;
+
+    uint16_t hashAt(const uint8_t* data) const;
+    void insertUpTo(const uint8_t* data, uint16_t limit, uint16_t end);
+    uint16_t findMatch(const uint8_t* data, uint16_t pos, uint16_t end, uint16_t& offset) const;
+
+public:
+    LZEstimator();
+    ~LZEstimator();
+
+    // maxLength bounds every estimate including its dictionary; window
+    // (power of two) sets the offset cost and how far back matches reach
+    bool configure(uint16_t maxLength, uint16_t window = LZ_DEFAULT_WINDOW,
+                   uint8_t chainLimit = LZ_DEFAULT_CHAIN);
+    void release();
+
+    // Bits an LZSS coding of data[dictionary, length) would take, with
+    // data[0, dictionary) available as history. Tokens are written when
+    // requested, up to maxTokens.
+    uint32_t compressedBits(const uint8_t* data, uint16_t length, uint16_t dictionary = 0,
+                            LZToken* tokens = nullptr, uint16_t maxTokens = 0,
+                            uint16_t* tokenCount = nullptr);
+    // Compressed / original size; 1.125 for incompressible bytes
+    float ratio(const uint8_t* data, uint16_t length);
+    // Compressed bits per input byte
+    float bitsPerSymbol(const uint8_t* data, uint16_t length);
+
+    // Streaming: bytes are coded in blocks, each with the previous block
+    // as history. Needs 2 * block <= maxLength.
+    bool beginStream(uint16_t block);
+    // Returns true when a block was completed
+    bool push(uint8_t value);
+    float getBlockBitsPerSymbol() const;
+    float getStreamBitsPerSymbol() const;
+
+    uint16_t getWindow() const { return windowSize; }
+    bool isConfigured() const { return head != nullptr; }
+};
+
+#endif // LZ_ESTIMATOR_H
@@ -0,0 +1,461 @@
+#include "MinEntropyEstimator.h"
+#include <math.h>
+#include <string.h>
+
+// 99% upper confidence bound on a proportion measured over n samples
+static float upperBound(float p, uint16_t n) {
+    float bound = p + (float)MIN_ENTROPY_CONFIDENCE_Z * sqrtf(p * (1.0f - p) / (n - 1));
+    return bound < 1.0f ? bound : 1.0f;
+}
+
+static float entropyBits(float p) {
+    return p < 1.0f ? -log2f(p) : 0.0f;
+}
+
+MinEntropyEstimator::MinEntropyEstimator() :
+    symbols(nullptr),
+    suffixes(nullptr),
+    ranks(nullptr),
+    work(nullptr),
+    lcp(nullptr),
+    log2Table(nullptr),
+    window(0),
+    fill(0),
+    windowBlocks(0),
+    dictionaryBlocks(0)
+{
+    reset();
+}
+
+MinEntropyEstimator::~MinEntropyEstimator() {
+    release();
+}
+
+bool MinEntropyEstimator::configure(uint16_t windowSize) {
+    if (windowSize < MIN_ENTROPY_MIN_WINDOW || windowSize > MIN_ENTROPY_MAX_WINDOW) return false;
+
+    if (!symbols || windowSize != window) {
+        release();
+        uint16_t blocks = (uint32_t)windowSize * MIN_ENTROPY_SYMBOL_BITS / MIN_ENTROPY_COMPRESS_BITS;
+        uint16_t bucketSize = windowSize > MIN_ENTROPY_ALPHABET ? windowSize : MIN_ENTROPY_ALPHABET;
+
+        symbols = new uint8_t[windowSize];
+        suffixes = new uint16_t[windowSize];
+        ranks = new uint16_t[windowSize];
+        work = new uint16_t[windowSize];
+        lcp = new uint16_t[bucketSize];
+        log2Table = new float[blocks + 1];
+        if (!symbols || !suffixes || !ranks || !work || !lcp || !log2Table) {
+            release();
+            return false;
+        }
+
+        window = windowSize;
+        windowBlocks = blocks;
+        dictionaryBlocks = blocks / 2 < MIN_ENTROPY_COMPRESS_DICT ? blocks / 2 : MIN_ENTROPY_COMPRESS_DICT;
+        log2Table[0] = 0.0f;
+        for (uint16_t n = 1; n <= blocks; n++) {
+            log2Table[n] = log2f((float)n);
+        }
+    }
+
+    reset();
+    return true;
+}
+
+void MinEntropyEstimator::release() {
+    delete[] symbols;
+    delete[] suffixes;
+    delete[] ranks;
+    delete[] work;
+    delete[] lcp;
+    delete[] log2Table;
+    symbols = nullptr;
+    suffixes = nullptr;
+    ranks = nullptr;
+    work = nullptr;
+    lcp = nullptr;
+    log2Table = nullptr;
+    window = 0;
+    windowBlocks = 0;
+    dictionaryBlocks = 0;
+}
+
+void MinEntropyEstimator::reset() {
+    memset(&result, 0, sizeof(result));
+    for (uint8_t i = 0; i < MIN_ENTROPY_ESTIMATOR_COUNT; i++) {
+        result.estimate[i] = MIN_ENTROPY_NOT_APPLICABLE;
+    }
+    result.minEntropy = MIN_ENTROPY_NOT_APPLICABLE;
+    beginWindow();
+}
+
+void MinEntropyEstimator::beginWindow() {
+    fill = 0;
+    memset(counts, 0, sizeof(counts));
+    maxCount = 0;
+
+    memset(bitCounts, 0, sizeof(bitCounts));
+    memset(transitions, 0, sizeof(transitions));
+    lastBit = 0xFF;
+
+    collisionState = 0;
+    collisionFirst = 0;
+    collisionCount = 0;
+    collisionSum = 0;
+    collisionSquares = 0;
+
+    memset(lastSeen, 0, sizeof(lastSeen));
+    blockBits = 0;
+    blockFill = 0;
+    blockIndex = 1;
+    distanceLogSum = 0.0f;
+    distanceLogSquares = 0.0f;
+}
+
+// ===== PER-SAMPLE FOLDING =====
+
+bool MinEntropyEstimator::push(uint8_t symbol) {
+    if (!symbols || fill == window) return false;
+
+    symbols[fill++] = symbol;
+    uint16_t c = ++counts[symbol];
+    if (c > maxCount) maxCount = c;
+
+    // The bitstring estimators see each symbol most significant bit first
+    for (int8_t b = MIN_ENTROPY_SYMBOL_BITS - 1; b >= 0; b--) {
+        foldBit((symbol >> b) & 1);
+    }
+
+    return fill == window;
+}
+
+void MinEntropyEstimator::pushBlock(const uint8_t* data, uint16_t length) {
+    for (uint16_t i = 0; i < length; i++) {
+        if (push(data[i])) finishWindow();
+    }
+}
+
+void MinEntropyEstimator::foldBit(uint8_t bit) {
+    // Markov
+    bitCounts[bit]++;
+    if (lastBit != 0xFF) transitions[lastBit][bit]++;
+    lastBit = bit;
+
+    // Collision: two equal bits collide at 2, otherwise the third bit always does
+    if (collisionState == 0) {
+        collisionFirst = bit;
+        collisionState = 1;
+    } else if (collisionState == 1 && bit == collisionFirst) {
+        collisionCount++;
+        collisionSum += 2;
+        collisionSquares += 4;
+        collisionState = 0;
+    } else if (collisionState == 1) {
+        collisionState = 2;
+    } else {
+        collisionCount++;
+        collisionSum += 3;
+        collisionSquares += 9;
+        collisionState = 0;
+    }
+
+    // Compression: distance back to the previous occurrence of each block
+    blockBits = (blockBits << 1) | bit;
+    if (++blockFill < MIN_ENTROPY_COMPRESS_BITS) return;
+
+    uint8_t block = blockBits & (MIN_ENTROPY_COMPRESS_SYMBOLS - 1);
+    if (blockIndex > dictionaryBlocks) {
+        uint16_t distance = lastSeen[block] ? blockIndex - lastSeen[block] : blockIndex;
+        float l = log2Table[distance];
+        distanceLogSum += l;
+        distanceLogSquares += l * l;
+    }
+    lastSeen[block] = blockIndex++;
+    blockBits = 0;
+    blockFill = 0;
+}
+
+// ===== WINDOW ESTIMATES =====
+
+void MinEntropyEstimator::finishWindow() {
+    if (!windowReady()) return;
+
+    result.samples = fill;
+    result.estimate[MIN_ENTROPY_MCV] = estimateMCV();
+    result.estimate[MIN_ENTROPY_COLLISION] = estimateCollision();
+    result.estimate[MIN_ENTROPY_MARKOV] = estimateMarkov();
+    result.estimate[MIN_ENTROPY_COMPRESSION] = estimateCompression();
+    estimateTuples(result.estimate[MIN_ENTROPY_TUPLE], result.estimate[MIN_ENTROPY_LRS]);
+
+    result.minEntropy = MIN_ENTROPY_NOT_APPLICABLE;
+    for (uint8_t i = 0; i < MIN_ENTROPY_ESTIMATOR_COUNT; i++) {
+        float h = result.estimate[i];
+        if (h < 0.0f) continue;
+        if (result.minEntropy < 0.0f || h < result.minEntropy) {
+            result.minEntropy = h;
+            result.limiting = i;
+        }
+    }
+    result.windows++;
+
+    beginWindow();
+}
+
+float MinEntropyEstimator::estimateMCV() const {
+    float p = upperBound((float)maxCount / fill, fill);
+    return entropyBits(p);
+}
+
+float MinEntropyEstimator::estimateCollision() const {
+    if (collisionCount < 2) return MIN_ENTROPY_NOT_APPLICABLE;
+
+    float v = collisionCount;
+    float mean = collisionSum / v;
+    float variance = (collisionSquares - v * mean * mean) / (v - 1.0f);
+    float bound = mean - (float)MIN_ENTROPY_CONFIDENCE_Z * sqrtf(variance > 0.0f ? variance : 0.0f) / sqrtf(v);
+
+    // For two symbols the 800-90B collision equation reduces to
+    // E[t] = 2 + 2p(1 - p), solved here for the larger probability p
+    float p;
+    if (bound <= 2.0f) {
+        p = 1.0f;
+    } else if (bound >= 2.5f) {
+        p = 0.5f;
+    } else {
+        p = 0.5f + 0.5f * sqrtf(1.0f - 2.0f * (bound - 2.0f));
+    }
+    return entropyBits(p) * MIN_ENTROPY_SYMBOL_BITS;
+}
+
+float MinEntropyEstimator::estimateMarkov() const {
+    float bits = (float)bitCounts[0] + bitCounts[1];
+    uint32_t from0 = transitions[0][0] + transitions[0][1];
+    uint32_t from1 = transitions[1][0] + transitions[1][1];
+
+    // Probabilities in log2; an unseen transition is -infinity
+    float l0 = log2f(bitCounts[0] / bits);
+    float l1 = log2f(bitCounts[1] / bits);
+    float l00 = from0 ? log2f((float)transitions[0][0] / from0) : -INFINITY;
+    float l01 = from0 ? log2f((float)transitions[0][1] / from0) : -INFINITY;
+    float l10 = from1 ? log2f((float)transitions[1][0] / from1) : -INFINITY;
+    float l11 = from1 ? log2f((float)transitions[1][1] / from1) : -INFINITY;
+
+    // Most likely MIN_ENTROPY_MARKOV_LENGTH-bit sequence among the six candidates
+    const float n = MIN_ENTROPY_MARKOV_LENGTH;
+    float candidates[6] = {
+        l0 + (n - 1) * l00,                         // 00...0
+        l0 + (n / 2) * l01 + (n / 2 - 1) * l10,     // 0101...
+        l0 + l01 + (n - 2) * l11,                   // 011...1
+        l1 + l10 + (n - 2) * l00,                   // 100...0
+        l1 + (n / 2) * l10 + (n / 2 - 1) * l01,     // 1010...
+        l1 + (n - 1) * l11                          // 11...1
+    };
+    float best = -INFINITY;
+    for (uint8_t i = 0; i < 6; i++) {
+        if (candidates[i] > best) best = candidates[i];
+    }
+
+    float h = best < 0.0f ? -best / n : 0.0f;
+    if (h > 1.0f) h = 1.0f;
+    return h * MIN_ENTROPY_SYMBOL_BITS;
+}
+
+float MinEntropyEstimator::compressionExpectation(float p, uint16_t blocks) const {
+    // G(p) + (2^b - 1) G(q) for blocks distances after the dictionary.
+    // The inner sum over u <= t is folded into one pass by counting how
+    // many t each u contributes to.
+    float q = (1.0f - p) / (MIN_ENTROPY_COMPRESS_SYMBOLS - 1);
+    float wp = 1.0f, wq = 1.0f;                     // (1 - z)^(u - 1)
+    float gp = 0.0f, gq = 0.0f;
+    for (uint16_t u = 2; u <= blocks; u++) {
+        // Flush vanishing weights rather than run on in denormals
+        wp = wp > 1e-30f ? wp * (1.0f - p) : 0.0f;
+        wq = wq > 1e-30f ? wq * (1.0f - q) : 0.0f;
+        float l = log2Table[u];
+        if (u < blocks) {
+            float later = blocks - (u > dictionaryBlocks ? u : dictionaryBlocks);
+            gp += l * p * p * wp * later;
+            gq += l * q * q * wq * later;
+        }
+        if (u > dictionaryBlocks) {
+            gp += l * p * wp;
+            gq += l * q * wq;
+        }
+    }
+    return (gp + (MIN_ENTROPY_COMPRESS_SYMBOLS - 1) * gq) / (blocks - dictionaryBlocks);
+}
+
+float MinEntropyEstimator::estimateCompression() const {
+    uint16_t blocks = blockIndex - 1;
+    if (blocks <= dictionaryBlocks + 1) return MIN_ENTROPY_NOT_APPLICABLE;
+
+    float v = blocks - dictionaryBlocks;
+    float mean = distanceLogSum / v;
+    // 800-90B divides the squares by v - 1 but takes the mean over v
+    float variance = distanceLogSquares / (v - 1.0f) - mean * mean;
+    float sigma = MIN_ENTROPY_COMPRESS_C * sqrtf(variance > 0.0f ? variance : 0.0f);
+    float bound = mean - (float)MIN_ENTROPY_CONFIDENCE_Z * sigma / sqrtf(v);
+
+    // The expectation falls as p rises from uniform to certain
+    float low = 1.0f / MIN_ENTROPY_COMPRESS_SYMBOLS, high = 1.0f;
+    float p;
+    if (bound >= compressionExpectation(low, blocks)) {
+        p = low;
+    } else if (bound <= 0.0f) {
+        p = 1.0f;
+    } else {
+        for (uint8_t i = 0; i < 24; i++) {
+            float mid = 0.5f * (low + high);
+            if (compressionExpectation(mid, blocks) > bound) {
+                low = mid;
+            } else {
+                high = mid;
+            }
+        }
+        p = 0.5f * (low + high);
+    }
+    return entropyBits(p) / MIN_ENTROPY_COMPRESS_BITS * MIN_ENTROPY_SYMBOL_BITS;
+}
+
+void MinEntropyEstimator::buildSuffixArray() {
+    uint16_t n = fill;
+    uint16_t* buckets = lcp;
+
+    // Order by first symbol
+    memset(buckets, 0, MIN_ENTROPY_ALPHABET * sizeof(uint16_t));
+    for (uint16_t i = 0; i < n; i++) buckets[symbols[i]]++;
+    uint16_t total = 0;
+    for (uint16_t b = 0; b < MIN_ENTROPY_ALPHABET; b++) {
+        uint16_t c = buckets[b];
+        buckets[b] = total;
+        total += c;
+    }
+    for (uint16_t i = 0; i < n; i++) suffixes[buckets[symbols[i]]++] = i;
+
+    uint16_t classes = 0;
+    for (uint16_t j = 0; j < n; j++) {
+        if (j > 0 && symbols[suffixes[j]] != symbols[suffixes[j - 1]]) classes++;
+        ranks[suffixes[j]] = classes;
+    }
+    classes++;
+
+    // Prefix doubling: sort by (rank[i], rank[i + k]) until every rank is distinct
+    for (uint16_t k = 1; classes < n; k <<= 1) {
+        // Second key order: suffixes with nothing at i + k come first
+        uint16_t p = 0;
+        for (uint16_t i = n - k; i < n; i++) work[p++] = i;
+        for (uint16_t j = 0; j < n; j++) {
+            if (suffixes[j] >= k) work[p++] = suffixes[j] - k;
+        }
+
+        // Stable counting sort on the first key
+        memset(buckets, 0, classes * sizeof(uint16_t));
+        for (uint16_t i = 0; i < n; i++) buckets[ranks[i]]++;
+        total = 0;
+        for (uint16_t r = 0; r < classes; r++) {
+            uint16_t c = buckets[r];
+            buckets[r] = total;
+            total += c;
+        }
+        for (uint16_t j = 0; j < n; j++) {
+            uint16_t i = work[j];
+            suffixes[buckets[ranks[i]]++] = i;
+        }
+
+        // New ranks go to work, which then becomes the rank array
+        work[suffixes[0]] = 0;
+        classes = 1;
+        for (uint16_t j = 1; j < n; j++) {
+            uint16_t a = suffixes[j - 1], b = suffixes[j];
+            int32_t secondA = a + k < n ? ranks[a + k] : -1;
+            int32_t secondB = b + k < n ? ranks[b + k] : -1;
+            if (ranks[a] != ranks[b] || secondA != secondB) classes++;
+            work[b] = classes - 1;
+        }
+        uint16_t* swap = ranks;
+        ranks = work;
+        work = swap;
+    }
+
+    // Kasai: lcp[j] is the prefix shared by suffixes[j] and suffixes[j - 1]
+    uint16_t h = 0;
+    for (uint16_t i = 0; i < n; i++) {
+        uint16_t r = ranks[i];
+        if (r == 0) {
+            lcp[0] = 0;
+            h = 0;
+            continue;
+        }
+        uint16_t j = suffixes[r - 1];
+        while (i + h < n && j + h < n && symbols[i + h] == symbols[j + h]) h++;
+        lcp[r] = h;
+        if (h > 0) h--;
+    }
+}
+
+void MinEntropyEstimator::estimateTuples(float& tupleEstimate, float& lrsEstimate) {
+    uint16_t n = fill;
+    buildSuffixArray();
+
+    // Suffixes sharing a t-symbol prefix sit in runs where lcp >= t
+    uint16_t longest = 0;
+    for (uint16_t j = 1; j < n; j++) {
+        if (lcp[j] > longest) longest = lcp[j];
+    }
+
+    // t-tuple: every length whose most common tuple occurs TUPLE_CUTOFF times
+    float pMax = 0.0f;
+    uint16_t t = 1;
+    for (; t <= n; t++) {
+        uint16_t best = 1, run = 1;
+        for (uint16_t j = 1; j < n; j++) {
+            run = lcp[j] >= t ? run + 1 : 1;
+            if (run > best) best = run;
+        }
+        if (best < MIN_ENTROPY_TUPLE_CUTOFF) break;
+        float p = powf((float)best / (n - t + 1), 1.0f / t);
+        if (p > pMax) pMax = p;
+    }
+    result.tupleLength = t - 1;
+    result.lrsLength = longest;
+    tupleEstimate = result.tupleLength ? entropyBits(upperBound(pMax, n)) : MIN_ENTROPY_NOT_APPLICABLE;
+
+    // LRS: collision probability of every length from the first one the
+    // t-tuple estimate stopped at, up to the longest repeat
+    if (longest < t) {
+        lrsEstimate = MIN_ENTROPY_NOT_APPLICABLE;
+        return;
+    }
+    pMax = 0.0f;
+    for (uint16_t length = t; length <= longest; length++) {
+        uint32_t pairs = 0;
+        uint32_t run = 1;
+        for (uint16_t j = 1; j < n; j++) {
+            if (lcp[j] >= length) {
+                run++;
+            } else {
+                pairs += run * (run - 1) / 2;
+                run = 1;
+            }
+        }
+        pairs += run * (run - 1) / 2;
+
+        float tuples = n - length + 1;
+        float p = powf(pairs / (tuples * (tuples - 1.0f) / 2.0f), 1.0f / length);
+        if (p > pMax) pMax = p;
+    }
+    lrsEstimate = entropyBits(upperBound(pMax, n));
+}
+
+const char* MinEntropyEstimator::estimatorName(uint8_t id) {
+    switch (id) {
+        case MIN_ENTROPY_MCV: return "MCV";
+        case MIN_ENTROPY_COLLISION: return "Collision";
+        case MIN_ENTROPY_MARKOV: return "Markov";
+        case MIN_ENTROPY_COMPRESSION: return "Compression";
+        case MIN_ENTROPY_TUPLE: return "t-Tuple";
+        case MIN_ENTROPY_LRS: return "LRS";
+        default: return "";
+    }
+}
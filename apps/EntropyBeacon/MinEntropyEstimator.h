@@ -0,0 +1,131 @@
+#ifndef MIN_ENTROPY_ESTIMATOR_H
+#define MIN_ENTROPY_ESTIMATOR_H
+
+#include <stdint.h>
+
+// ========================================
+// MinEntropyEstimator - Streaming min-entropy estimates for noise source
+// qualification, following the NIST SP 800-90B non-IID estimators:
+// most common value, collision, Markov, compression, t-tuple and LRS.
+// Samples are taken as 8-bit symbols over tumbling windows. Counts,
+// transitions, collision times and compression distances are folded in
+// as each symbol arrives; the tuple estimators run over the window's
+// suffix array when it is finished. Finishing is left to the caller so
+// it can run outside the sampling path. All memory is allocated in
+// configure(). Hardware independent.
+// ========================================
+
+#define MIN_ENTROPY_MAX_WINDOW       1024     // Symbols per window
+#define MIN_ENTROPY_MIN_WINDOW       64
+#define MIN_ENTROPY_SYMBOL_BITS      8
+#define MIN_ENTROPY_ALPHABET         256
+#define MIN_ENTROPY_TUPLE_CUTOFF     35       // Occurrences a t-tuple needs to count
+#define MIN_ENTROPY_CONFIDENCE_Z     2.576    // 99% upper bound
+#define MIN_ENTROPY_MARKOV_LENGTH    128      // Bits in the most likely sequence
+#define MIN_ENTROPY_COMPRESS_BITS    6        // Bits per compression block
+#define MIN_ENTROPY_COMPRESS_SYMBOLS 64
+#define MIN_ENTROPY_COMPRESS_DICT    1000     // Dictionary blocks, capped at half the window
+#define MIN_ENTROPY_COMPRESS_C       0.5907f  // Standard deviation correction for 6-bit blocks
+#define MIN_ENTROPY_NOT_APPLICABLE   -1.0f
+
+// Estimators, in the order results are stored
+enum MinEntropyEstimatorId {
+    MIN_ENTROPY_MCV,
+    MIN_ENTROPY_COLLISION,       // Bitstring
+    MIN_ENTROPY_MARKOV,          // Bitstring
+    MIN_ENTROPY_COMPRESSION,     // Bitstring
+    MIN_ENTROPY_TUPLE,
+    MIN_ENTROPY_LRS,
+    MIN_ENTROPY_ESTIMATOR_COUNT
+};
+
+// Estimates for the last completed window, in bits per 8-bit symbol.
+// Bitstring estimates are scaled by MIN_ENTROPY_SYMBOL_BITS, as 800-90B
+// does for non-binary sources.
+struct MinEntropyResult {
+    uint32_t windows;                                   // Windows completed so far
+    uint16_t samples;                                   // Symbols in the window
+    float estimate[MIN_ENTROPY_ESTIMATOR_COUNT];        // MIN_ENTROPY_NOT_APPLICABLE if unusable
+    float minEntropy;                                   // Lowest applicable estimate
+    uint8_t limiting;                                   // Estimator that set minEntropy
+    uint16_t tupleLength;                               // Longest t with a tuple seen TUPLE_CUTOFF times
+    uint16_t lrsLength;                                 // Longest repeated substring
+};
+
+class MinEntropyEstimator {
+private:
+    // Window symbols and suffix array workspace
+    uint8_t* symbols;
+    uint16_t* suffixes;
+    uint16_t* ranks;
+    uint16_t* work;
+    uint16_t* lcp;               // Also the bucket counts while sorting
+    float* log2Table;            // log2(n) for compression distances
+    uint16_t window;
+    uint16_t fill;
+
+    // Most common value: counts only grow within a window, so the maximum is kept as they do
+    uint16_t counts[MIN_ENTROPY_ALPHABET];
+    uint16_t maxCount;
+
+    // Markov: bit and transition counts, with the last bit of the previous symbol
+    uint32_t bitCounts[2];
+    uint32_t transitions[2][2];
+    uint8_t lastBit;             // 0xFF at the start of a window
+
+    // Collision: binary collision times are always 2 or 3
+    uint8_t collisionState;
+    uint8_t collisionFirst;
+    uint32_t collisionCount;
+    uint32_t collisionSum;
+    uint32_t collisionSquares;
+
+    // Compression: 6-bit blocks, Maurer-style distance to the last occurrence
+    uint16_t lastSeen[MIN_ENTROPY_COMPRESS_SYMBOLS];
+    uint16_t blockBits;
+    uint8_t blockFill;
+    uint16_t blockIndex;         // 1-based index of the next block
+    uint16_t windowBlocks;
+    uint16_t dictionaryBlocks;
+    float distanceLogSum;
+    float distanceLogSquares;
+
+    MinEntropyResult result;
+
+    void beginWindow();
+    void foldBit(uint8_t bit);
+    void buildSuffixArray();
+    float estimateMCV() const;
+    float estimateCollision() const;
+    float estimateMarkov() const;
+    float estimateCompression() const;
+    void estimateTuples(float& tupleEstimate, float& lrsEstimate);
+    float compressionExpectation(float p, uint16_t blocks) const;
+
+public:
+    MinEntropyEstimator();
+    ~MinEntropyEstimator();
+
+    // windowSize symbols per estimate, MIN_ENTROPY_MIN_WINDOW..MIN_ENTROPY_MAX_WINDOW
+    bool configure(uint16_t windowSize);
+    void release();
+    void reset();
+
+    // Returns true when the symbol filled the window. Symbols pushed
+    // after that are skipped until finishWindow() has run.
+    bool push(uint8_t symbol);
+    void pushBlock(const uint8_t* data, uint16_t length);
+    // Computes the estimates for a full window and starts the next one
+    void finishWindow();
+    bool windowReady() const { return symbols && fill == window; }
+
+    const MinEntropyResult& getResult() const { return result; }
+    bool hasResult() const { return result.windows > 0; }
+    uint16_t getWindow() const { return window; }
+    uint16_t getFill() const { return fill; }
+    bool isConfigured() const { return symbols != nullptr; }
+
+    static const char* estimatorName(uint8_t id);
+};
+
+#endif // MIN_ENTROPY_ESTIMATOR_H
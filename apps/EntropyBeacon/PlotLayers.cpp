@@ -0,0 +1,319 @@
+#include "PlotLayers.h"
+#include <string.h>
+
+#define PLOT_EMPTY_TOP  0xFF
+
+static inline int16_t clampRow(int16_t row, int16_t height) {
+    return row < 0 ? 0 : (row >= height ? height - 1 : row);
+}
+
+// Vertical lines win over horizontal ones, and centre lines use the axis
+// colour, matching the order the views used to draw them in
+uint16_t plotBackground(const PlotFrame& frame, int16_t column, int16_t row) {
+    for (uint8_t i = 1; i < frame.divisions; i++) {
+        if (column == i * frame.width / frame.divisions) {
+            return (i * 2 == frame.divisions) ? frame.axis : frame.grid;
+        }
+    }
+    for (uint8_t i = 1; i < frame.divisions; i++) {
+        if (row == i * frame.height / frame.divisions) {
+            return (i * 2 == frame.divisions) ? frame.axis : frame.grid;
+        }
+    }
+    return frame.background;
+}
+
+// ===== COLUMN LAYER =====
+
+ColumnLayer::ColumnLayer() :
+    slots(0),
+    shown(nullptr),
+    pending(nullptr),
+    columnPixels(nullptr),
+    scan(0),
+    repaint(false)
+{
+    memset(&frame, 0, sizeof(frame));
+}
+
+ColumnLayer::~ColumnLayer() {
+    release();
+}
+
+bool ColumnLayer::begin(const PlotFrame& layerFrame, uint8_t slotCount) {
+    if (layerFrame.width <= 0 || layerFrame.height <= 0 || layerFrame.height > PLOT_MAX_HEIGHT) return false;
+    if (slotCount == 0 || slotCount > PLOT_MAX_SLOTS) return false;
+
+    bool sameSize = shown && layerFrame.width == frame.width &&
+                    layerFrame.height == frame.height && slotCount == slots;
+    if (!sameSize) {
+        release();
+        uint32_t spans = (uint32_t)layerFrame.width * slotCount;
+        shown = new Span[spans];
+        pending = new Span[spans];
+        columnPixels = new uint16_t[layerFrame.height];
+        if (!shown || !pending || !columnPixels) {
+            release();
+            return false;
+        }
+    }
+
+    frame = layerFrame;
+    slots = slotCount;
+    clearAll();
+    invalidate();
+    return true;
+}
+
+void ColumnLayer::release() {
+    delete[] shown;
+    delete[] pending;
+    delete[] columnPixels;
+    shown = nullptr;
+    pending = nullptr;
+    columnPixels = nullptr;
+    slots = 0;
+}
+
+void ColumnLayer::invalidate() {
+    if (!shown) return;
+    // Whatever was shown is gone; the repaint pass draws pending in full
+    memcpy(shown, pending, sizeof(Span) * frame.width * slots);
+    scan = 0;
+    repaint = true;
+}
+
+void ColumnLayer::setSpan(int16_t column, uint8_t slot, int16_t row0, int16_t row1, uint16_t color) {
+    if (!pending || column < 0 || column >= frame.width || slot >= slots) return;
+    if (row0 > row1) {
+        int16_t t = row0;
+        row0 = row1;
+        row1 = t;
+    }
+    if (row1 < 0 || row0 >= frame.height) {
+        clearSpan(column, slot);
+        return;
+    }
+
+    Span& span = pending[column * slots + slot];
+    span.top = (uint8_t)clampRow(row0, frame.height);
+    span.bottom = (uint8_t)clampRow(row1, frame.height);
+    span.color = color;
+}
+
+void ColumnLayer::clearSpan(int16_t column, uint8_t slot) {
+    if (!pending || column < 0 || column >= frame.width || slot >= slots) return;
+
+    // Empty spans are stored one way so they compare equal
+    Span& span = pending[column * slots + slot];
+    span.top = PLOT_EMPTY_TOP;
+    span.bottom = 0;
+    span.color = 0;
+}
+
+void ColumnLayer::clearSlot(uint8_t slot) {
+    for (int16_t column = 0; column < frame.width; column++) {
+        clearSpan(column, slot);
+    }
+}
+
+void ColumnLayer::clearAll() {
+    if (!pending) return;
+    for (uint32_t i = 0; i < (uint32_t)frame.width * slots; i++) {
+        pending[i].top = PLOT_EMPTY_TOP;
+        pending[i].bottom = 0;
+        pending[i].color = 0;
+    }
+}
+
+uint16_t ColumnLayer::rasterise(int16_t column, int16_t top, int16_t bottom) {
+    uint16_t count = bottom - top + 1;
+
+    // Background: a vertical grid line fills the column, otherwise the
+    // horizontal lines cross it
+    uint16_t base = frame.background;
+    bool vertical = false;
+    for (uint8_t i = 1; i < frame.divisions; i++) {
+        if (column == i * frame.width / frame.divisions) {
+            base = (i * 2 == frame.divisions) ? frame.axis : frame.grid;
+            vertical = true;
+            break;
+        }
+    }
+    for (uint16_t i = 0; i < count; i++) {
+        columnPixels[i] = base;
+    }
+    if (!vertical) {
+        for (uint8_t i = 1; i < frame.divisions; i++) {
+            int16_t row = i * frame.height / frame.divisions;
+            if (row >= top && row <= bottom) {
+                columnPixels[row - top] = (i * 2 == frame.divisions) ? frame.axis : frame.grid;
+            }
+        }
+    }
+
+    // Spans in slot order
+    const Span* spans = &pending[column * slots];
+    for (uint8_t s = 0; s < slots; s++) {
+        if (spans[s].top > spans[s].bottom) continue;
+        int16_t from = spans[s].top > top ? spans[s].top : top;
+        int16_t to = spans[s].bottom < bottom ? spans[s].bottom : bottom;
+        for (int16_t row = from; row <= to; row++) {
+            columnPixels[row - top] = spans[s].color;
+        }
+    }
+    return count;
+}
+
+bool ColumnLayer::nextUpdate(PlotUpdate& update) {
+    if (!shown) return false;
+
+    while (scan < frame.width) {
+        int16_t column = scan++;
+        Span* was = &shown[column * slots];
+        const Span* now = &pending[column * slots];
+
+        int16_t top = 0;
+        int16_t bottom = frame.height - 1;
+        if (!repaint) {
+            // Rows covered by any span that moved, before or after
+            top = frame.height;
+            bottom = -1;
+            for (uint8_t s = 0; s < slots; s++) {
+                if (was[s].top == now[s].top && was[s].bottom == now[s].bottom &&
+                    was[s].color == now[s].color) continue;
+                if (was[s].top <= was[s].bottom) {
+                    if (was[s].top < top) top = was[s].top;
+                    if (was[s].bottom > bottom) bottom = was[s].bottom;
+                }
+                if (now[s].top <= now[s].bottom) {
+                    if (now[s].top < top) top = now[s].top;
+                    if (now[s].bottom > bottom) bottom = now[s].bottom;
+                }
+            }
+            if (bottom < top) continue;
+        }
+
+        uint16_t count = rasterise(column, top, bottom);
+        memcpy(was, now, sizeof(Span) * slots);
+
+        update.x = frame.x + column;
+        update.y = frame.y + top;
+        update.width = 1;
+        update.height = count;
+        update.pixels = columnPixels;
+        return true;
+    }
+
+    scan = 0;
+    repaint = false;
+    return false;
+}
+
+// ===== POINT LAYER =====
+
+PointLayer::PointLayer() :
+    points(nullptr),
+    writes(nullptr),
+    capacity(0),
+    count(0),
+    head(0),
+    writeCount(0),
+    writeRead(0)
+{
+    memset(&frame, 0, sizeof(frame));
+}
+
+PointLayer::~PointLayer() {
+    release();
+}
+
+bool PointLayer::begin(const PlotFrame& layerFrame, uint16_t pointCapacity) {
+    if (layerFrame.width <= 0 || layerFrame.height <= 0 || pointCapacity == 0) return false;
+
+    if (!points || pointCapacity != capacity) {
+        release();
+        points = new PlotPoint[pointCapacity];
+        // Each plot can expire one point and add one
+        writes = new PlotPoint[pointCapacity * 2];
+        if (!points || !writes) {
+            release();
+            return false;
+        }
+        capacity = pointCapacity;
+    }
+
+    frame = layerFrame;
+    clear();
+    return true;
+}
+
+void PointLayer::release() {
+    delete[] points;
+    delete[] writes;
+    points = nullptr;
+    writes = nullptr;
+    capacity = 0;
+    count = 0;
+    head = 0;
+    writeCount = 0;
+    writeRead = 0;
+}
+
+void PointLayer::clear() {
+    count = 0;
+    head = 0;
+    writeCount = 0;
+    writeRead = 0;
+}
+
+void PointLayer::queue(int16_t x, int16_t y, uint16_t color) {
+    // Callers drain at least every capacity plots, so this only guards
+    if (writeCount >= capacity * 2) return;
+    PlotPoint& write = writes[writeCount++];
+    write.x = frame.x + x;
+    write.y = frame.y + y;
+    write.color = color;
+}
+
+void PointLayer::plot(int16_t x, int16_t y, uint16_t color) {
+    if (!points) return;
+    x = x < 0 ? 0 : (x >= frame.width ? frame.width - 1 : x);
+    y = y < 0 ? 0 : (y >= frame.height ? frame.height - 1 : y);
+
+    if (count == capacity) {
+        // head holds the oldest point. Its pixel goes back to the newest
+        // other point still there, or to the background.
+        const PlotPoint& oldest = points[head];
+        if (oldest.x != x || oldest.y != y) {
+            uint16_t restore = plotBackground(frame, oldest.x, oldest.y);
+            for (uint16_t i = 1; i < count; i++) {
+                const PlotPoint& other = points[(head + count - i) % capacity];
+                if (other.x == oldest.x && other.y == oldest.y) {
+                    restore = other.color;
+                    break;
+                }
+            }
+            queue(oldest.x, oldest.y, restore);
+        }
+    } else {
+        count++;
+    }
+
+    PlotPoint& point = points[head];
+    point.x = x;
+    point.y = y;
+    point.color = color;
+    head = (head + 1) % capacity;
+    queue(x, y, color);
+}
+
+bool PointLayer::nextPixel(PlotPoint& pixel) {
+    if (writeRead < writeCount) {
+        pixel = writes[writeRead++];
+        return true;
+    }
+    writeCount = 0;
+    writeRead = 0;
+    return false;
+}
@@ -0,0 +1,119 @@
+#ifndef PLOT_LAYERS_H
+#define PLOT_LAYERS_H
+
+#include <stdint.h>
+
+// ========================================
+// PlotLayers - Retained plot layers that only resend what changed.
+// A ColumnLayer keeps a few vertical spans per screen column (trace
+// segments, bars, one-row overlays) over a gridded background. Columns
+// whose spans changed are rasterised over just the rows that changed,
+// ready for one pixel push each. A PointLayer remembers the last N
+// plotted points, so a new point costs one pixel write plus one to
+// restore the pixel of the point it expires. Hardware independent.
+// ========================================
+
+#define PLOT_MAX_SLOTS          8        // Spans per column; later slots draw on top
+#define PLOT_MAX_HEIGHT         255      // Rows are stored as 8 bits
+
+// Screen area and background of a layer
+struct PlotFrame {
+    int16_t x, y;                // Top-left pixel on screen
+    int16_t width, height;
+    uint16_t background;
+    uint16_t grid;               // Lines at multiples of width/divisions and height/divisions
+    uint16_t axis;               // Centre lines, when divisions is even
+    uint8_t divisions;           // 0 for no grid
+};
+
+// One rectangle of pixels to send, rows top to bottom
+struct PlotUpdate {
+    int16_t x, y;
+    int16_t width, height;
+    const uint16_t* pixels;
+};
+
+struct PlotPoint {
+    int16_t x, y;                // Screen coordinates
+    uint16_t color;
+};
+
+// Background pixel at frame-relative (column, row)
+uint16_t plotBackground(const PlotFrame& frame, int16_t column, int16_t row);
+
+class ColumnLayer {
+private:
+    struct Span {
+        uint8_t top;             // top > bottom: empty
+        uint8_t bottom;
+        uint16_t color;
+    };
+
+    PlotFrame frame;
+    uint8_t slots;
+    Span* shown;                 // What the screen holds, width * slots
+    Span* pending;               // What the next updates will show
+    uint16_t* columnPixels;      // One rasterised column
+    int16_t scan;                // Next column nextUpdate() examines
+    bool repaint;                // Every column, every row
+
+    uint16_t rasterise(int16_t column, int16_t top, int16_t bottom);
+
+public:
+    ColumnLayer();
+    ~ColumnLayer();
+
+    bool begin(const PlotFrame& layerFrame, uint8_t slotCount);
+    void release();
+    // The screen under the frame was lost; the next pass repaints it all
+    void invalidate();
+
+    // Rows are frame-relative and may come in either order; they are
+    // clipped to the frame
+    void setSpan(int16_t column, uint8_t slot, int16_t row0, int16_t row1, uint16_t color);
+    void clearSpan(int16_t column, uint8_t slot);
+    void clearSlot(uint8_t slot);
+    void clearAll();
+
+    // Next column whose content changed, rasterised over the changed rows.
+    // pixels stays valid until the next call. Returns false when done.
+    bool nextUpdate(PlotUpdate& update);
+
+    const PlotFrame& getFrame() const { return frame; }
+    bool isAllocated() const { return shown != nullptr; }
+};
+
+class PointLayer {
+private:
+    PlotFrame frame;
+    PlotPoint* points;           // Ring of live points, frame-relative
+    PlotPoint* writes;           // Pixel writes waiting to be sent
+    uint16_t capacity;
+    uint16_t count;
+    uint16_t head;               // Next slot to fill
+    uint16_t writeCount;
+    uint16_t writeRead;
+
+    void queue(int16_t x, int16_t y, uint16_t color);
+
+public:
+    PointLayer();
+    ~PointLayer();
+
+    bool begin(const PlotFrame& layerFrame, uint16_t pointCapacity);
+    void release();
+    // Forgets every point without erasing (the screen was cleared)
+    void clear();
+
+    // Frame-relative; clipped. Expires the oldest point once full.
+    void plot(int16_t x, int16_t y, uint16_t color);
+
+    // Next pixel write, in screen coordinates
+    bool nextPixel(PlotPoint& pixel);
+
+    uint16_t size() const { return count; }
+    uint16_t getCapacity() const { return capacity; }
+    bool isAllocated() const { return points != nullptr; }
+};
+
+#endif // PLOT_LAYERS_H
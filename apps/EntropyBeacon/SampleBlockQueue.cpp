@@ -0,0 +1,61 @@
+#include "SampleBlockQueue.h"
+
+SampleBlockQueue::SampleBlockQueue() :
+    blockLength(SAMPLE_BLOCK_CAPACITY),
+    filling(nullptr),
+    nextSequence(0),
+    samplesProduced(0)
+{
+}
+
+bool SampleBlockQueue::allocate(uint8_t count) {
+    if (count > SAMPLE_BLOCK_QUEUE_MAX || !ring.allocate(count)) return false;
+    clear();
+    return true;
+}
+
+void SampleBlockQueue::release() {
+    ring.release();
+    filling = nullptr;
+}
+
+void SampleBlockQueue::clear() {
+    ring.clear();
+    filling = nullptr;
+    nextSequence = 0;
+    samplesProduced = 0;
+}
+
+void SampleBlockQueue::setBlockLength(uint16_t length) {
+    if (length < 1) length = 1;
+    if (length > SAMPLE_BLOCK_CAPACITY) length = SAMPLE_BLOCK_CAPACITY;
+    blockLength = length;
+}
+
+// ===== PRODUCER =====
+
+bool SampleBlockQueue::put(uint16_t value, uint8_t source, uint32_t timestamp) {
+    // The sequence keeps counting through drops so the consumer can see gaps
+    uint32_t sequence = nextSequence++;
+
+    // A full ring refuses the reserve and counts the sample as dropped
+    SampleBlock* block = ring.reserve();
+    if (!block) return false;
+
+    if (block != filling) {
+        block->sequence = sequence;
+        block->timestamp = timestamp;
+        block->count = 0;
+        filling = block;
+    }
+    block->values[block->count] = value;
+    block->sources[block->count] = source;
+    block->count++;
+    samplesProduced++;
+
+    if (block->count >= blockLength) {
+        ring.commit();
+        filling = nullptr;
+    }
+    return true;
+}
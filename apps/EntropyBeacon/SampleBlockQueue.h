@@ -0,0 +1,85 @@
+#ifndef SAMPLE_BLOCK_QUEUE_H
+#define SAMPLE_BLOCK_QUEUE_H
+
+#include <stdint.h>
+#include "../../core/Queues/SpscRing.h"
+
+// ========================================
+// SampleBlockQueue - Blocks of samples handed from one producer to one
+// consumer over an SpscRing. The producer (a timer callback) fills the
+// block at the head and commits it once it holds blockLength samples;
+// the consumer takes committed blocks in order. When every block is
+// waiting, new samples are dropped and counted rather than overwriting
+// unread data. Hardware independent.
+// ========================================
+
+#define SAMPLE_BLOCK_CAPACITY   256      // Most samples per block
+#define SAMPLE_BLOCK_QUEUE_MAX  32       // Most blocks in the ring
+
+struct SampleBlock {
+    uint32_t sequence;                          // Index of the first sample since start
+    uint32_t timestamp;                         // Time of the first sample
+    uint16_t count;
+    uint16_t values[SAMPLE_BLOCK_CAPACITY];
+    uint8_t sources[SAMPLE_BLOCK_CAPACITY];
+};
+
+// Runs an analysis stage every few blocks; optional stages are skipped
+// while the consumer is behind
+struct AnalysisStage {
+    uint8_t every;                // Blocks between runs
+    bool optional;                // May be shed under backpressure
+    uint32_t runs;
+    uint32_t shed;
+
+    bool due(uint32_t block, bool behind) {
+        if (every > 1 && block % every != 0) return false;
+        if (behind && optional) {
+            shed++;
+            return false;
+        }
+        runs++;
+        return true;
+    }
+};
+
+class SampleBlockQueue {
+private:
+    SpscRing<SampleBlock> ring;
+    volatile uint16_t blockLength;
+
+    // Producer only
+    SampleBlock* filling;        // Head block while it is being filled
+    uint32_t nextSequence;
+    uint32_t samplesProduced;
+
+public:
+    SampleBlockQueue();
+
+    // count must be a power of two up to SAMPLE_BLOCK_QUEUE_MAX
+    bool allocate(uint8_t count);
+    void release();
+    // Only while the producer is stopped
+    void clear();
+
+    // Samples per committed block, 1..SAMPLE_BLOCK_CAPACITY; takes effect
+    // from the next block
+    void setBlockLength(uint16_t length);
+    uint16_t getBlockLength() const { return blockLength; }
+
+    // Producer side. Returns false if the sample was dropped.
+    bool put(uint16_t value, uint8_t source, uint32_t timestamp);
+
+    // Consumer side: the oldest committed block, or nullptr
+    const SampleBlock* peek() { return ring.peek(); }
+    void pop() { ring.pop(); }
+    uint8_t backlog() const { return (uint8_t)ring.backlog(); }
+
+    // Ring counts are per block, except dropped, which counts samples
+    const SpscRingStats& getStats() const { return ring.getStats(); }
+    uint32_t getSamplesProduced() const { return samplesProduced; }
+    uint8_t getBlockCount() const { return (uint8_t)ring.getCapacity(); }
+    bool isAllocated() const { return ring.isAllocated(); }
+};
+
+#endif // SAMPLE_BLOCK_QUEUE_H
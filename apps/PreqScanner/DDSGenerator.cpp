@@ -0,0 +1,258 @@
+#include "DDSGenerator.h"
+#include <math.h>
+
+#define DDS_PHASE_SCALE   4294967296.0          // 2^32, one cycle
+#define DDS_FRAC_BITS     (32 - DDS_SINE_TABLE_BITS)
+#define DDS_FRAC_SCALE    (1.0f / (float)(1UL << DDS_FRAC_BITS))
+#define DDS_PHASE_TO_UNIT (1.0f / 4294967296.0f)
+
+float DDSGenerator::sineTable[DDS_SINE_TABLE_SIZE + 1];
+bool DDSGenerator::sineTableReady = false;
+
+// Residual of a unit step smoothed over one sample either side (t in cycles)
+static inline float polyBlep(float t, float dt) {
+    if (t < dt) {
+        float x = t / dt;
+        return x + x - x * x - 1.0f;
+    }
+    if (t > 1.0f - dt) {
+        float x = (t - 1.0f) / dt;
+        return x * x + x + x + 1.0f;
+    }
+    return 0.0f;
+}
+
+// Integrated polyBlep: residual of a unit slope change, in samples
+static inline float polyBlamp(float t, float dt) {
+    if (t < dt) {
+        float x = 1.0f - t / dt;
+        return x * x * x * (1.0f / 6.0f);
+    }
+    if (t > 1.0f - dt) {
+        float x = (t - 1.0f) / dt + 1.0f;
+        return x * x * x * (1.0f / 6.0f);
+    }
+    return 0.0f;
+}
+
+static inline float wrapUnit(float t) {
+    return (t >= 1.0f) ? t - 1.0f : t;
+}
+
+DDSGenerator::DDSGenerator() :
+    params(defaultParams()),
+    sampleRate(22050),
+    phase(0),
+    lfoPhase(0),
+    noiseState(0x12345678),
+    sweepPosition(0),
+    lastGain(-1.0f)
+{
+    initSineTable();
+}
+
+void DDSGenerator::initSineTable() {
+    if (sineTableReady) return;
+    for (uint16_t i = 0; i <= DDS_SINE_TABLE_SIZE; i++) {
+        sineTable[i] = (float)sin(2.0 * M_PI * i / DDS_SINE_TABLE_SIZE);
+    }
+    sineTableReady = true;
+}
+
+DDSParams DDSGenerator::defaultParams() {
+    DDSParams p;
+    p.waveform = DDS_SINE;
+    p.modulation = DDS_MOD_NONE;
+    p.sweepShape = DDS_SWEEP_LINEAR;
+    p.frequency = 1000.0f;
+    p.amplitude = 0.5f;
+    p.dutyCycle = 0.5f;
+    p.modFrequency = 10.0f;
+    p.modDepth = 0.1f;
+    p.sweepStartFreq = 100.0f;
+    p.sweepEndFreq = 2000.0f;
+    p.sweepDuration = 1.0f;
+    return p;
+}
+
+void DDSGenerator::begin(uint32_t rate) {
+    sampleRate = rate ? rate : 1;
+    reset();
+}
+
+void DDSGenerator::reset() {
+    phase = 0;
+    lfoPhase = 0;
+    sweepPosition = 0;
+    lastGain = -1.0f;
+}
+
+void DDSGenerator::setParams(const DDSParams& newParams) {
+    bool sweepChanged = newParams.waveform != params.waveform ||
+                        newParams.sweepDuration != params.sweepDuration;
+    params = newParams;
+    if (sweepChanged) sweepPosition = 0;
+}
+
+uint32_t DDSGenerator::frequencyToIncrement(float hz) const {
+    double inc = (double)hz * DDS_PHASE_SCALE / sampleRate;
+    if (inc < 0.0) inc = 0.0;
+    if (inc > DDS_PHASE_SCALE / 2 - 1) inc = DDS_PHASE_SCALE / 2 - 1; // Nyquist, fits int32
+    return (uint32_t)inc;
+}
+
+float DDSGenerator::sweepFrequency(uint32_t position) const {
+    float length = params.sweepDuration * sampleRate;
+    float progress = (length > 0.0f) ? position / length : 0.0f;
+    if (progress > 1.0f) progress = 1.0f;
+
+    if (params.sweepShape == DDS_SWEEP_LOG && params.sweepStartFreq > 0.0f && params.sweepEndFreq > 0.0f) {
+        return params.sweepStartFreq * powf(params.sweepEndFreq / params.sweepStartFreq, progress);
+    }
+    return params.sweepStartFreq + progress * (params.sweepEndFreq - params.sweepStartFreq);
+}
+
+float DDSGenerator::sine(uint32_t p) {
+    uint32_t index = p >> DDS_FRAC_BITS;
+    float frac = (p & ((1UL << DDS_FRAC_BITS) - 1)) * DDS_FRAC_SCALE;
+    float a = sineTable[index];
+    return a + frac * (sineTable[index + 1] - a);
+}
+
+void DDSGenerator::render(float* out, uint32_t count) {
+    while (count > 0) {
+        uint16_t n = (count > DDS_BLOCK_SIZE) ? DDS_BLOCK_SIZE : count;
+        renderBlock(out, n);
+        out += n;
+        count -= n;
+    }
+}
+
+void DDSGenerator::renderBlock(float* out, uint16_t count) {
+    // ----- Control rate: values at block start and end, ramped in between -----
+    float freq0, freq1;
+    if (params.waveform == DDS_SWEEP) {
+        uint32_t length = (uint32_t)(params.sweepDuration * sampleRate);
+        if (length == 0) length = 1;
+        if (sweepPosition >= length) sweepPosition = 0;
+        freq0 = sweepFrequency(sweepPosition);
+        freq1 = sweepFrequency(sweepPosition + count);
+        sweepPosition += count;
+    } else {
+        freq0 = freq1 = params.frequency;
+    }
+
+    float mod0 = 0.0f, mod1 = 0.0f;
+    if (params.modulation != DDS_MOD_NONE) {
+        mod0 = sine(lfoPhase);
+        lfoPhase += frequencyToIncrement(params.modFrequency) * count;
+        mod1 = sine(lfoPhase);
+    }
+
+    float depth = params.modDepth;
+    if (depth < 0.0f) depth = 0.0f;
+    if (depth > 1.0f) depth = 1.0f;
+
+    if (params.modulation == DDS_MOD_FM) {
+        freq0 *= 1.0f + depth * mod0;
+        freq1 *= 1.0f + depth * mod1;
+    }
+
+    float gain1 = params.amplitude;
+    if (params.modulation == DDS_MOD_AM) {
+        // Normalized so full depth still peaks at the set amplitude
+        gain1 *= (1.0f + depth * mod1) / (1.0f + depth);
+    }
+    float gain0 = (lastGain < 0.0f) ? gain1 : lastGain;
+    if (params.modulation == DDS_MOD_AM && lastGain < 0.0f) {
+        gain0 = params.amplitude * (1.0f + depth * mod0) / (1.0f + depth);
+    }
+    lastGain = gain1;
+
+    float duty = params.dutyCycle;
+    if (params.modulation == DDS_MOD_PWM) duty += 0.5f * depth * mod1;
+    if (duty < DDS_MIN_DUTY) duty = DDS_MIN_DUTY;
+    if (duty > DDS_MAX_DUTY) duty = DDS_MAX_DUTY;
+
+    uint32_t inc = frequencyToIncrement(freq0);
+    int32_t incStep = ((int32_t)frequencyToIncrement(freq1) - (int32_t)inc) / (int32_t)count;
+    float gain = gain0;
+    float gainStep = (gain1 - gain0) / count;
+
+    // ----- Audio rate: one tight loop per waveform -----
+    uint32_t p = phase;
+
+    switch (params.waveform) {
+        case DDS_SINE:
+        case DDS_SWEEP:
+            for (uint16_t i = 0; i < count; i++) {
+                out[i] = gain * sine(p);
+                p += inc;
+                inc += incStep;
+                gain += gainStep;
+            }
+            break;
+
+        case DDS_SAWTOOTH:
+            for (uint16_t i = 0; i < count; i++) {
+                float t = p * DDS_PHASE_TO_UNIT;
+                float dt = inc * DDS_PHASE_TO_UNIT;
+                out[i] = gain * (2.0f * t - 1.0f - polyBlep(t, dt));
+                p += inc;
+                inc += incStep;
+                gain += gainStep;
+            }
+            break;
+
+        case DDS_SQUARE:
+            for (uint16_t i = 0; i < count; i++) {
+                float t = p * DDS_PHASE_TO_UNIT;
+                float dt = inc * DDS_PHASE_TO_UNIT;
+                float v = (t < duty) ? 1.0f : -1.0f;
+                v += polyBlep(t, dt) - polyBlep(wrapUnit(t + 1.0f - duty), dt);
+                out[i] = gain * v;
+                p += inc;
+                inc += incStep;
+                gain += gainStep;
+            }
+            break;
+
+        case DDS_TRIANGLE:
+            for (uint16_t i = 0; i < count; i++) {
+                float t = p * DDS_PHASE_TO_UNIT;
+                float dt = inc * DDS_PHASE_TO_UNIT;
+                float v = (t < 0.5f) ? 4.0f * t - 1.0f : 3.0f - 4.0f * t;
+                // Slope flips by +/-8 per cycle at the corners: 8 * dt per sample
+                v += 8.0f * dt * (polyBlamp(t, dt) - polyBlamp(wrapUnit(t + 0.5f), dt));
+                out[i] = gain * v;
+                p += inc;
+                inc += incStep;
+                gain += gainStep;
+            }
+            break;
+
+        case DDS_NOISE: {
+            uint32_t s = noiseState;
+            for (uint16_t i = 0; i < count; i++) {
+                s ^= s << 13;
+                s ^= s >> 17;
+                s ^= s << 5;
+                out[i] = gain * ((int32_t)s * (1.0f / 2147483648.0f));
+                gain += gainStep;
+            }
+            noiseState = s;
+            break;
+        }
+    }
+
+    phase = p;
+}
+
+void DDSGenerator::toDacSamples(const float* in, uint16_t* out, uint32_t count) {
+    for (uint32_t i = 0; i < count; i++) {
+        float v = in[i] * 127.5f + 128.0f;
+        if (v < 0.0f) v = 0.0f;
+        if (v > 255.0f) v = 255.0f;
+        out[i] = (uint16_t)v << 8;
+    }
+}
@@ -0,0 +1,95 @@
+#ifndef DDS_GENERATOR_H
+#define DDS_GENERATOR_H
+
+#include <stdint.h>
+
+// ========================================
+// DDSGenerator - Block-rendered direct digital synthesis
+// 32-bit phase accumulator, interpolated sine table, PolyBLEP/BLAMP
+// band-limited square, saw and triangle, LFSR noise and sweeps.
+// Modulation and sweeps run at block (control) rate.
+// Hardware independent so blocks can be rendered and checked on a host.
+// ========================================
+
+#define DDS_SINE_TABLE_BITS   10
+#define DDS_SINE_TABLE_SIZE   (1 << DDS_SINE_TABLE_BITS)
+#define DDS_BLOCK_SIZE        256       // Samples per control-rate block
+#define DDS_MIN_DUTY          0.05f
+#define DDS_MAX_DUTY          0.95f
+
+enum DDSWaveform : uint8_t {
+    DDS_SINE,
+    DDS_SQUARE,
+    DDS_TRIANGLE,
+    DDS_SAWTOOTH,
+    DDS_NOISE,
+    DDS_SWEEP             // Sine swept from sweepStartFreq to sweepEndFreq
+};
+
+enum DDSModulation : uint8_t {
+    DDS_MOD_NONE,
+    DDS_MOD_AM,
+    DDS_MOD_FM,
+    DDS_MOD_PWM           // Square duty cycle, other waveforms unaffected
+};
+
+enum DDSSweepShape : uint8_t {
+    DDS_SWEEP_LINEAR,
+    DDS_SWEEP_LOG
+};
+
+// Everything needed to describe the output; copied in at block boundaries
+struct DDSParams {
+    DDSWaveform waveform;
+    DDSModulation modulation;
+    DDSSweepShape sweepShape;
+    float frequency;              // Hz
+    float amplitude;              // 0.0-1.0
+    float dutyCycle;              // Square duty cycle (0.0-1.0)
+    float modFrequency;           // Hz
+    float modDepth;               // 0.0-1.0
+    float sweepStartFreq;         // Hz
+    float sweepEndFreq;           // Hz
+    float sweepDuration;          // Seconds
+};
+
+class DDSGenerator {
+private:
+    DDSParams params;
+    uint32_t sampleRate;
+    uint32_t phase;               // Carrier phase, full scale = one cycle
+    uint32_t lfoPhase;            // Modulator phase
+    uint32_t noiseState;          // xorshift32 LFSR state
+    uint32_t sweepPosition;       // Samples into the current sweep
+    float lastGain;               // Gain at the end of the previous block
+
+    static float sineTable[DDS_SINE_TABLE_SIZE + 1];
+    static bool sineTableReady;
+
+    uint32_t frequencyToIncrement(float hz) const;
+    float sweepFrequency(uint32_t position) const;
+    void renderBlock(float* out, uint16_t count);
+
+public:
+    DDSGenerator();
+
+    void begin(uint32_t rate);
+    void reset();
+    void setParams(const DDSParams& newParams);
+    const DDSParams& getParams() const { return params; }
+    uint32_t getSampleRate() const { return sampleRate; }
+
+    // Renders count samples in [-1, 1]; any count, split into control blocks
+    void render(float* out, uint32_t count);
+
+    // Interpolated table sine of a 32-bit phase (after initSineTable())
+    static float sine(uint32_t phase);
+    static void initSineTable();
+
+    // Converts to the I2S built-in DAC format (unsigned, 8 bits in the high byte)
+    static void toDacSamples(const float* in, uint16_t* out, uint32_t count);
+
+    static DDSParams defaultParams();
+};
+
+#endif // DDS_GENERATOR_H
@@ -21,7 +21,7 @@ FreqScanner::FreqScanner() {
     metadata.description = "Spectrum analyzer with FFT processing";
     metadata.category = CATEGORY_TOOLS;
     metadata.icon = freq_scanner_icon;
-    metadata.maxMemory = 65536; // 64KB for FFT buffers
+    metadata.memoryRequirement = 65536; // 64KB for FFT buffers
     metadata.requiresSD = true;
     metadata.requiresWiFi = false;
     metadata.requiresBLE = false;
@@ -32,9 +32,14 @@ FreqScanner::FreqScanner() {
     lastFFTTime = 0;
     lastDisplayUpdate = 0;
     adcSampleTimer = 0;
+    monitorLastMicros = 0;
     noiseFloor = -80.0;
-    averagingBuffer = nullptr;
-    averagingCount = 0;
+    noiseDensity = -80.0;
+    generatorMux = portMUX_INITIALIZER_UNLOCKED;
+    pendingParams = DDSGenerator::defaultParams();
+    paramsPending = false;
+    generatorRender = nullptr;
+    rawInput = nullptr;
     
     // Initialize colors
     colorBackground = COLOR_BLACK;
@@ -58,7 +63,7 @@ FreqScanner::~FreqScanner() {
 bool FreqScanner::initialize() {
     debugLog("FreqScanner: Initializing");
     
-    setState(APP_INITIALIZING);
+    setState(APP_LOADING);
     
     // Initialize directories
     if (!filesystem.ensureDirExists(FREQ_SCANNER_DATA_DIR)) {
@@ -97,19 +102,6 @@ bool FreqScanner::initialize() {
         return false;
     }
     
-    // Initialize averaging buffer
-    averagingBuffer = new float[config.fftSize / 2];
-    if (!averagingBuffer) {
-        debugLog("FreqScanner: Failed to allocate averaging buffer");
-        setState(APP_ERROR);
-        return false;
-    }
-    
-    // Clear averaging buffer
-    for (uint16_t i = 0; i < config.fftSize / 2; i++) {
-        averagingBuffer[i] = -120.0;
-    }
-    
     // Set initial view
     uiState.currentView = config.defaultView;
     
@@ -127,40 +119,47 @@ void FreqScanner::update() {
     
     unsigned long currentTime = millis();
     
-    // Process FFT at regular intervals
-    if (currentTime - lastFFTTime >= (1000 / 30)) { // 30 FPS processing
+    if (config.monitorEnabled) {
+        // Tone blocks run back to back; only a few multiply-adds per sample
+        if (processMonitor()) {
+            needsRedraw = true;
+        }
+    } else if (currentTime - lastFFTTime >= (1000 / 30)) { // 30 FPS processing
         if (processFFT()) {
             lastFFTTime = currentTime;
             needsRedraw = true;
+            
+            // One waterfall line per processed spectrum
+            if (uiState.currentView == VIEW_WATERFALL || uiState.currentView == VIEW_DUAL) {
+                updateWaterfall();
+            }
         }
     }
     
+    // Playback ran out during this update; restore live input
+    if (signalPlayback.finished) {
+        stopPlayback();
+    }
+    
     // Update signal generator
     if (signalGenerator.isEnabled) {
         updateGenerator();
     }
     
-    // Update waterfall display
-    if (uiState.currentView == VIEW_WATERFALL || uiState.currentView == VIEW_DUAL) {
-        updateWaterfall();
-    }
-    
     // Update statistics
     updateStatistics();
     
     // Check for auto-recording triggers
     if (config.autoRecord && !signalRecording.isRecording) {
         // Auto-record if signal exceeds threshold
-        for (const auto& peak : detectedPeaks) {
-            if (peak.magnitude > config.peakThreshold + 20) {
+        const SpectralPeak* peaks = peakTracker.getPeaks();
+        for (uint8_t i = 0; i < peakTracker.getPeakCount(); i++) {
+            if (peaks[i].magnitude > config.peakThreshold + 20) {
                 startRecording(generateRecordingFilename());
                 break;
             }
         }
     }
-    
-    // Update frame count
-    frameCount++;
 }
 
 void FreqScanner::render() {
@@ -169,29 +168,51 @@ void FreqScanner::render() {
     unsigned long currentTime = millis();
     if (currentTime - lastDisplayUpdate < 33) return; // Limit to 30 FPS
     
-    // Clear screen
-    displayManager.clearScreen(colorBackground);
+    bool monitorView = config.monitorEnabled &&
+                       (uiState.currentView == VIEW_SPECTRUM || uiState.currentView == VIEW_WATERFALL ||
+                        uiState.currentView == VIEW_DUAL);
+    bool waterfallView = !monitorView &&
+                         (uiState.currentView == VIEW_WATERFALL || uiState.currentView == VIEW_DUAL);
+    if (waterfallView && !waterfallDisplay.regionActive) {
+        configureWaterfallRegion();
+    } else if (!waterfallView && waterfallDisplay.regionActive) {
+        releaseWaterfallRegion();
+    }
+    
+    // Clear screen (the waterfall region keeps its content between frames)
+    if (waterfallView) {
+        displayManager.drawRetroRect(0, 0, SCREEN_WIDTH, WATERFALL_AREA_Y, colorBackground, true);
+        displayManager.drawRetroRect(0, WATERFALL_AREA_Y + WATERFALL_AREA_H, SCREEN_WIDTH,
+                                     SCREEN_HEIGHT - WATERFALL_AREA_Y - WATERFALL_AREA_H,
+                                     colorBackground, true);
+    } else {
+        displayManager.clearScreen(colorBackground);
+    }
     
-    // Render based on current view mode
-    switch (uiState.currentView) {
-        case VIEW_SPECTRUM:
-            renderSpectrum();
-            break;
-        case VIEW_WATERFALL:
-            renderWaterfall();
-            break;
-        case VIEW_DUAL:
-            renderDualView();
-            break;
-        case VIEW_RECORDING:
-            renderRecordingInterface();
-            break;
-        case VIEW_GENERATOR:
-            renderGeneratorInterface();
-            break;
-        case VIEW_SETTINGS:
-            renderSettingsPanel();
-            break;
+    // Render based on current view mode; the monitor replaces the analysis views
+    if (monitorView) {
+        renderMonitor();
+    } else {
+        switch (uiState.currentView) {
+            case VIEW_SPECTRUM:
+                renderSpectrum();
+                break;
+            case VIEW_WATERFALL:
+                renderWaterfall();
+                break;
+            case VIEW_DUAL:
+                renderDualView();
+                break;
+            case VIEW_RECORDING:
+                renderRecordingInterface();
+                break;
+            case VIEW_GENERATOR:
+                renderGeneratorInterface();
+                break;
+            case VIEW_SETTINGS:
+                renderSettingsPanel();
+                break;
+        }
     }
     
     // Always render status bar
@@ -263,26 +284,25 @@ bool FreqScanner::handleTouch(TouchPoint touch) {
 void FreqScanner::cleanup() {
     debugLog("FreqScanner: Cleaning up");
     
-    // Stop any active recording
+    // Stop any active recording or playback
     if (signalRecording.isRecording) {
         stopRecording();
     }
+    if (signalPlayback.isPlaying) {
+        stopPlayback();
+    }
+    signalRecording.writer.release();
     
     // Shutdown components
+    releaseWaterfallRegion();
     shutdownFFT();
     shutdownWaterfall();
     shutdownGenerator();
     
-    // Free memory
-    if (averagingBuffer) {
-        delete[] averagingBuffer;
-        averagingBuffer = nullptr;
-    }
-    
     // Save state
     saveConfiguration();
     
-    setState(APP_CLEANUP);
+    setState(APP_UNLOADED);
 }
 
 String FreqScanner::getName() const {
@@ -299,40 +319,55 @@ bool FreqScanner::initializeFFT() {
     debugLog("FreqScanner: Initializing FFT processor");
     
     // Allocate FFT buffers
-    fftProcessor.inputBuffer = new float[config.fftSize];
     fftProcessor.windowBuffer = new float[config.fftSize];
     fftProcessor.fftBuffer = new std::complex<float>[config.fftSize];
-    fftProcessor.magnitudeSpectrum = new float[config.fftSize / 2];
+    fftProcessor.powerSpectrum = new float[config.fftSize / 2];
     fftProcessor.phaseSpectrum = new float[config.fftSize / 2];
     fftProcessor.smoothedSpectrum = new float[config.fftSize / 2];
+    rawInput = new int16_t[config.fftSize];
     
-    if (!fftProcessor.inputBuffer || !fftProcessor.windowBuffer || 
-        !fftProcessor.fftBuffer || !fftProcessor.magnitudeSpectrum ||
-        !fftProcessor.phaseSpectrum || !fftProcessor.smoothedSpectrum) {
+    if (!fftProcessor.windowBuffer || !fftProcessor.fftBuffer || !fftProcessor.powerSpectrum ||
+        !fftProcessor.phaseSpectrum || !fftProcessor.smoothedSpectrum || !rawInput) {
         debugLog("FreqScanner: FFT buffer allocation failed");
         return false;
     }
     
     // Initialize buffers
     for (uint16_t i = 0; i < config.fftSize; i++) {
-        fftProcessor.inputBuffer[i] = 0.0;
+        rawInput[i] = 0;
         fftProcessor.windowBuffer[i] = 0.0;
         fftProcessor.fftBuffer[i] = std::complex<float>(0.0, 0.0);
     }
     
     for (uint16_t i = 0; i < config.fftSize / 2; i++) {
-        fftProcessor.magnitudeSpectrum[i] = -120.0;
+        fftProcessor.powerSpectrum[i] = 0.0;
         fftProcessor.phaseSpectrum[i] = 0.0;
-        fftProcessor.smoothedSpectrum[i] = -120.0;
+        fftProcessor.smoothedSpectrum[i] = SPECTRUM_FLOOR_DB;
+    }
+    
+    // Accumulators are sized with the FFT, never per frame
+    if (!accumulator.allocate(config.fftSize / 2)) {
+        debugLog("FreqScanner: Spectrum accumulator allocation failed");
+        return false;
+    }
+    accumulator.setMode(config.spectrumMode);
+    accumulator.setEmaAlpha(config.smoothingFactor);
+    accumulator.setAverageFrames(config.averagingCount);
+    accumulator.setPeakDecay(config.peakDecayDb);
+    
+    if (!toneMonitor.configure(config.sampleRate, config.monitorBlockSize)) {
+        debugLog("FreqScanner: Tone monitor configuration failed");
+        return false;
     }
+    monitorLastMicros = 0;
     
     // Set FFT parameters
     fftProcessor.size = config.fftSize;
     fftProcessor.sampleRate = config.sampleRate;
     fftProcessor.windowType = config.windowType;
-    fftProcessor.binWidth = (float)config.sampleRate / config.fftSize;
+    applyFrequencyScale();
     
-    // Generate window function
+    // Window comes from the flash tables; corrections feed the dB conversion
     generateWindow(config.windowType);
     
     fftProcessor.isInitialized = true;
@@ -346,11 +381,6 @@ void FreqScanner::shutdownFFT() {
     debugLog("FreqScanner: Shutting down FFT processor");
     
     // Free FFT buffers
-    if (fftProcessor.inputBuffer) {
-        delete[] fftProcessor.inputBuffer;
-        fftProcessor.inputBuffer = nullptr;
-    }
-    
     if (fftProcessor.windowBuffer) {
         delete[] fftProcessor.windowBuffer;
         fftProcessor.windowBuffer = nullptr;
@@ -361,9 +391,9 @@ void FreqScanner::shutdownFFT() {
         fftProcessor.fftBuffer = nullptr;
     }
     
-    if (fftProcessor.magnitudeSpectrum) {
-        delete[] fftProcessor.magnitudeSpectrum;
-        fftProcessor.magnitudeSpectrum = nullptr;
+    if (fftProcessor.powerSpectrum) {
+        delete[] fftProcessor.powerSpectrum;
+        fftProcessor.powerSpectrum = nullptr;
     }
     
     if (fftProcessor.phaseSpectrum) {
@@ -376,30 +406,64 @@ void FreqScanner::shutdownFFT() {
         fftProcessor.smoothedSpectrum = nullptr;
     }
     
+    if (rawInput) {
+        delete[] rawInput;
+        rawInput = nullptr;
+    }
+    
+    zoomFFT.release();
+    toneMonitor.release();
+    accumulator.release();
     fftProcessor.isInitialized = false;
 }
 
 bool FreqScanner::processFFT() {
     if (!fftProcessor.isInitialized || isProcessing) return false;
     
+    // Playback runs at the recorded rate, not as fast as the card reads
+    if (signalPlayback.isPlaying && !playbackDue()) return false;
+    
     isProcessing = true;
     unsigned long startTime = micros();
+    bool spectrumReady;
     
-    // Sample ADC data
-    sampleADC();
-    
-    // Apply window function
-    applyWindow();
-    
-    // Compute FFT
-    computeFFT();
-    
-    // Compute magnitude and phase spectra
-    computeMagnitudeSpectrum();
-    computePhaseSpectrum();
+    if (signalPlayback.isPlaying && !signalPlayback.timeData) {
+        // Spectrum-only recordings replace the whole FFT stage
+        spectrumReady = playbackSpectrumFrame();
+    } else {
+        if (config.zoomEnabled) {
+            // Decimated I/Q arrives slowly; keep sampling until a frame is due
+            if (!acquireZoomFrame()) {
+                isProcessing = false;
+                return false;
+            }
+        } else {
+            // Sample ADC data
+            sampleADC();
+            
+            // Apply window function
+            applyWindow();
+        }
+        
+        // Compute FFT
+        computeFFT();
+        
+        // Compute power and phase spectra
+        computePowerSpectrum();
+        computePhaseSpectrum();
+        
+        // Combine frames; block averaging only yields a spectrum every N frames
+        spectrumReady = smoothSpectrum();
+        
+        unsigned long processingTime = micros() - startTime;
+        stats.totalProcessingTime += processingTime / 1000; // Convert to milliseconds
+        stats.fftProcessedCount++;
+    }
     
-    // Apply smoothing
-    smoothSpectrum();
+    if (!spectrumReady) {
+        isProcessing = false;
+        return false;
+    }
     
     // Detect peaks
     if (config.enablePeakDetection) {
@@ -409,42 +473,127 @@ bool FreqScanner::processFFT() {
     // Estimate noise floor
     estimateNoiseFloor();
     
-    // Update statistics
-    unsigned long processingTime = micros() - startTime;
-    stats.totalProcessingTime += processingTime / 1000; // Convert to milliseconds
-    stats.fftProcessedCount++;
+    recordCurrentSpectrum();
     
     isProcessing = false;
     return true;
 }
 
 void FreqScanner::sampleADC() {
-    // Sample analog input (using entropy pin as signal source)
-    for (uint16_t i = 0; i < fftProcessor.size; i++) {
-        // Read ADC value and convert to voltage
-        uint16_t adcValue = analogRead(ENTROPY_PIN_1);
-        float voltage = (adcValue / 4095.0) * 3.3; // ESP32 12-bit ADC, 3.3V reference
-        
-        // Convert to centered signal (-1.65 to +1.65V)
-        fftProcessor.inputBuffer[i] = voltage - 1.65;
-        
-        // Add small delay for consistent sampling rate
-        delayMicroseconds(1000000 / config.sampleRate);
+    // With overlap, keep the tail of the previous frame and only sample the hop
+    uint16_t start = 0;
+    if (fftProcessor.inputPrimed && config.frameOverlap > 0) {
+        uint8_t overlap = config.frameOverlap > 75 ? 75 : config.frameOverlap;
+        uint16_t kept = (uint32_t)fftProcessor.size * overlap / 100;
+        memmove(rawInput, rawInput + fftProcessor.size - kept, kept * sizeof(int16_t));
+        start = kept;
+    }
+    
+    // Raw counts centred on mid-scale; the volts conversion is folded into the window
+    acquireSamples(rawInput + start, fftProcessor.size - start);
+    fftProcessor.inputPrimed = true;
+}
+
+uint16_t FreqScanner::acquireSamples(int16_t* samples, uint16_t count) {
+    if (signalPlayback.isPlaying) {
+        uint16_t got = signalPlayback.reader.readSamples(samples, count);
+        if (got < count && signalPlayback.loop) {
+            signalPlayback.reader.rewind();
+            got += signalPlayback.reader.readSamples(samples + got, count - got);
+        }
+        if (got < count) {
+            // Finish this frame on silence; playback stops at the end of the update
+            memset(samples + got, 0, (count - got) * sizeof(int16_t));
+            signalPlayback.finished = true;
+        }
+        signalPlayback.samplesPlayed += count;
+    } else {
+        // Sample analog input (using entropy pin as signal source)
+        for (uint16_t i = 0; i < count; i++) {
+            samples[i] = (int16_t)analogRead(ENTROPY_PIN_1) - FFT_ADC_MIDSCALE;
+            
+            // Add small delay for consistent sampling rate
+            delayMicroseconds(1000000 / config.sampleRate);
+        }
+    }
+    
+    if (signalRecording.isRecording && signalRecording.saveTimeData) {
+        recordTimeDomainData(samples, count);
     }
+    return count;
+}
+
+bool FreqScanner::acquireZoomFrame() {
+    // One frame's worth of raw samples per call keeps the UI as responsive
+    // as in normal mode; the decimated stream fills up over several calls
+    acquireSamples(rawInput, fftProcessor.size);
+    zoomFFT.process(rawInput, fftProcessor.size);
+    
+    uint8_t overlap = config.frameOverlap > 75 ? 75 : config.frameOverlap;
+    uint16_t hop = fftProcessor.size - (uint32_t)fftProcessor.size * overlap / 100;
+    if (!zoomFFT.frameReady(hop)) return false;
+    
+    // The window carries the volts scale, as in applyWindow()
+    zoomFFT.readFrame(reinterpret_cast<float*>(fftProcessor.fftBuffer),
+                      fftProcessor.windowBuffer, 1.0f);
+    return true;
+}
+
+void FreqScanner::applyFrequencyScale() {
+    // Everything that depends on what a bin means starts over
+    if (config.zoomEnabled &&
+        zoomFFT.configure(config.sampleRate, config.zoomCenterHz, config.zoomDecimation, config.fftSize)) {
+        config.zoomCenterHz = zoomFFT.getCenterFrequency();
+        fftProcessor.binWidth = zoomFFT.getBinWidth();
+        fftProcessor.startFrequency = zoomFFT.getStartFrequency();
+    } else {
+        config.zoomEnabled = false;
+        fftProcessor.binWidth = (float)config.sampleRate / config.fftSize;
+        fftProcessor.startFrequency = 0;
+    }
+    
+    fftProcessor.inputPrimed = false;
+    accumulator.reset();
+    peakTracker.reset();
+    waterfallDisplay.binMapValid = false;
+}
+
+bool FreqScanner::setZoomFFT(float centerHz, uint8_t decimation) {
+    config.zoomEnabled = true;
+    config.zoomCenterHz = centerHz;
+    config.zoomDecimation = decimation;
+    applyFrequencyScale();
+    needsRedraw = true;
+    
+    if (!config.zoomEnabled) {
+        debugLog("FreqScanner: Invalid zoom settings");
+        return false;
+    }
+    debugLog("FreqScanner: Zoom x" + String(decimation) + " at " + formatFrequency(config.zoomCenterHz) +
+             ", " + String(fftProcessor.binWidth, 3) + " Hz/bin");
+    return true;
+}
+
+void FreqScanner::disableZoomFFT() {
+    if (!config.zoomEnabled) return;
+    config.zoomEnabled = false;
+    applyFrequencyScale();
+    needsRedraw = true;
 }
 
 void FreqScanner::applyWindow() {
+    // Count-to-float conversion, volts scaling and windowing in one multiply;
+    // rawInput stays untouched for the next overlap
+    const int16_t* raw = rawInput;
+    const float* window = fftProcessor.windowBuffer;
+    float* out = reinterpret_cast<float*>(fftProcessor.fftBuffer);
     for (uint16_t i = 0; i < fftProcessor.size; i++) {
-        fftProcessor.inputBuffer[i] *= fftProcessor.windowBuffer[i];
+        out[2 * i] = raw[i] * window[i];
+        out[2 * i + 1] = 0.0f;
     }
 }
 
 void FreqScanner::computeFFT() {
-    // Copy windowed input to complex buffer
-    for (uint16_t i = 0; i < fftProcessor.size; i++) {
-        fftProcessor.fftBuffer[i] = std::complex<float>(fftProcessor.inputBuffer[i], 0.0);
-    }
-    
     // Bit-reversal reordering
     for (uint16_t i = 0; i < fftProcessor.size; i++) {
         uint16_t j = 0;
@@ -482,44 +631,51 @@ void FreqScanner::computeFFT() {
     }
 }
 
-void FreqScanner::computeMagnitudeSpectrum() {
+void FreqScanner::computePowerSpectrum() {
+    // |X|^2 without sqrt or log; dB conversion happens after accumulation.
+    // In zoom mode the complex FFT is centred on the zoom frequency.
     for (uint16_t i = 0; i < fftProcessor.size / 2; i++) {
-        float real = fftProcessor.fftBuffer[i].real();
-        float imag = fftProcessor.fftBuffer[i].imag();
-        float magnitude = sqrt(real * real + imag * imag);
-        
-        // Convert to dB
-        if (magnitude > 0.0) {
-            fftProcessor.magnitudeSpectrum[i] = 20.0 * log10(magnitude);
-        } else {
-            fftProcessor.magnitudeSpectrum[i] = -120.0; // Minimum dB value
-        }
+        uint16_t k = config.zoomEnabled ? zoomFFT.fftIndex(i) : i;
+        float real = fftProcessor.fftBuffer[k].real();
+        float imag = fftProcessor.fftBuffer[k].imag();
+        fftProcessor.powerSpectrum[i] = real * real + imag * imag;
+    }
+    
+    if (config.zoomEnabled) {
+        zoomFFT.correctDroop(fftProcessor.powerSpectrum);
     }
 }
 
 void FreqScanner::computePhaseSpectrum() {
     for (uint16_t i = 0; i < fftProcessor.size / 2; i++) {
-        float real = fftProcessor.fftBuffer[i].real();
-        float imag = fftProcessor.fftBuffer[i].imag();
+        uint16_t k = config.zoomEnabled ? zoomFFT.fftIndex(i) : i;
+        float real = fftProcessor.fftBuffer[k].real();
+        float imag = fftProcessor.fftBuffer[k].imag();
         fftProcessor.phaseSpectrum[i] = atan2(imag, real);
     }
 }
 
-void FreqScanner::smoothSpectrum() {
-    if (!config.enableAveraging) {
-        // Copy magnitude spectrum to smoothed spectrum
-        for (uint16_t i = 0; i < fftProcessor.size / 2; i++) {
-            fftProcessor.smoothedSpectrum[i] = fftProcessor.magnitudeSpectrum[i];
-        }
-        return;
-    }
+bool FreqScanner::smoothSpectrum() {
+    // Averaging power rather than dB keeps the noise floor unbiased
+    unsigned long startTime = micros();
+    bool ready = accumulator.accumulate(fftProcessor.powerSpectrum);
+    stats.accumulatorTime += micros() - startTime;
+    if (!ready) return false;
     
-    // Apply exponential moving average
-    float alpha = config.smoothingFactor;
-    for (uint16_t i = 0; i < fftProcessor.size / 2; i++) {
-        fftProcessor.smoothedSpectrum[i] = alpha * fftProcessor.magnitudeSpectrum[i] + 
-                                         (1.0 - alpha) * fftProcessor.smoothedSpectrum[i];
-    }
+    accumulator.toDb(fftProcessor.smoothedSpectrum);
+    return true;
+}
+
+void FreqScanner::setSpectrumMode(SpectrumMode mode) {
+    config.spectrumMode = mode;
+    accumulator.setMode(mode);
+    needsRedraw = true;
+    debugLog(String("FreqScanner: Spectrum mode ") + SpectrumAccumulator::modeName(mode));
+}
+
+void FreqScanner::resetSpectrumHold() {
+    accumulator.reset();
+    needsRedraw = true;
 }
 
 void FreqScanner::estimateNoiseFloor() {
@@ -535,142 +691,238 @@ void FreqScanner::estimateNoiseFloor() {
     uint16_t medianIndex = sortedMagnitudes.size() / 4; // 25th percentile
     noiseFloor = sortedMagnitudes[medianIndex];
     
+    // Bins are tone-calibrated, so a noise bin reads 10*log10(ENBW * binWidth)
+    // above the density; undoing that makes the floor comparable across windows
+    noiseDensity = noiseFloor - 10.0 * log10(fftProcessor.windowCorrection.enbw * fftProcessor.binWidth);
+    
     // Update statistics
     stats.averageNoiseFloor = 0.9 * stats.averageNoiseFloor + 0.1 * noiseFloor;
 }
 
-// ===== WINDOW FUNCTION IMPLEMENTATION =====
+// ===== TONE MONITOR IMPLEMENTATION =====
 
-void FreqScanner::generateWindow(WindowType type) {
-    switch (type) {
-        case WINDOW_RECTANGULAR:
-            for (uint16_t i = 0; i < fftProcessor.size; i++) {
-                fftProcessor.windowBuffer[i] = 1.0;
-            }
-            break;
-            
-        case WINDOW_HAMMING:
-            for (uint16_t i = 0; i < fftProcessor.size; i++) {
-                fftProcessor.windowBuffer[i] = hammingWindow(i, fftProcessor.size);
-            }
-            break;
-            
-        case WINDOW_BLACKMAN:
-            for (uint16_t i = 0; i < fftProcessor.size; i++) {
-                fftProcessor.windowBuffer[i] = blackmanWindow(i, fftProcessor.size);
-            }
-            break;
-            
-        case WINDOW_HANNING:
-            for (uint16_t i = 0; i < fftProcessor.size; i++) {
-                fftProcessor.windowBuffer[i] = hanningWindow(i, fftProcessor.size);
-            }
-            break;
-            
-        case WINDOW_KAISER:
-            for (uint16_t i = 0; i < fftProcessor.size; i++) {
-                fftProcessor.windowBuffer[i] = kaiserWindow(i, fftProcessor.size, 8.6);
-            }
-            break;
+bool FreqScanner::processMonitor() {
+    if (!toneMonitor.isConfigured() || isProcessing) return false;
+    if (signalPlayback.isPlaying && !playbackDue()) return false;
+    
+    isProcessing = true;
+    unsigned long startTime = micros();
+    
+    // Count the time spent rendering since the last block, so on/off
+    // durations follow the wall clock rather than only sampled time.
+    // Played-back samples are contiguous and need no correction.
+    if (monitorLastMicros != 0 && !signalPlayback.isPlaying) {
+        uint64_t gap = (uint64_t)(startTime - monitorLastMicros) * config.sampleRate / 1000000;
+        toneMonitor.skipSamples((uint32_t)gap);
     }
+    
+    // Sample exactly up to the end of the block; gaps only fall between blocks
+    uint16_t remaining = toneMonitor.samplesToBlockEnd();
+    while (remaining > 0) {
+        uint16_t chunk = remaining < fftProcessor.size ? remaining : fftProcessor.size;
+        acquireSamples(rawInput, chunk);
+        toneMonitor.process(rawInput, chunk);
+        remaining -= chunk;
+    }
+    monitorLastMicros = micros();
+    stats.monitorBlocks++;
+    
+    ToneEvent event;
+    while (toneMonitor.pollEvent(event)) {
+        stats.toneEvents++;
+        logToneEvent(event);
+    }
+    syncMonitorMarkers();
+    
+    stats.totalProcessingTime += (monitorLastMicros - startTime) / 1000;
+    isProcessing = false;
+    return true;
 }
 
-float FreqScanner::hammingWindow(int n, int N) {
-    return 0.54 - 0.46 * cos(2.0 * M_PI * n / (N - 1));
+void FreqScanner::logToneEvent(const ToneEvent& event) {
+    bool on = event.type == TONE_EVENT_ON;
+    debugLog("FreqScanner: Tone " + String(event.detector + 1) + " " + formatFrequency(event.frequency) +
+             (on ? " on after " : " off after ") + String(event.duration) + "ms at " +
+             String(event.levelDb, 1) + "dBFS");
+    
+    if (!config.logToneEvents) return;
+    
+    // timestamp_ms,detector,frequency_hz,state,previous_state_ms,level_dbfs
+    String line = String(event.timestamp) + "," + String(event.detector) + "," +
+                  String(event.frequency, 1) + "," + (on ? "on" : "off") + "," +
+                  String(event.duration) + "," + String(event.levelDb, 1) + "\n";
+    filesystem.appendFile(TONE_LOG_FILE, line);
 }
 
-float FreqScanner::blackmanWindow(int n, int N) {
-    return 0.42 - 0.5 * cos(2.0 * M_PI * n / (N - 1)) + 
-           0.08 * cos(4.0 * M_PI * n / (N - 1));
+void FreqScanner::syncMonitorMarkers() {
+    for (uint8_t i = 0; i < 2; i++) {
+        FrequencyMarker& marker = markers[i];
+        if (marker.detector < 0) continue;
+        
+        const ToneDetector* detector = toneMonitor.getDetector(marker.detector);
+        if (!detector) {
+            marker.detector = -1;
+            continue;
+        }
+        
+        marker.frequency = detector->frequency;
+        marker.magnitude = detector->levelDb;
+        marker.color = detector->active ? colorPeaks : colorMarkers;
+        marker.label = "T" + String(marker.detector + 1) + (detector->active ? " ON" : " off");
+    }
 }
 
-float FreqScanner::hanningWindow(int n, int N) {
-    return 0.5 - 0.5 * cos(2.0 * M_PI * n / (N - 1));
+bool FreqScanner::setMonitorMode(bool enabled) {
+    if (enabled && !toneMonitor.isConfigured()) return false;
+    
+    config.monitorEnabled = enabled;
+    toneMonitor.reset();
+    monitorLastMicros = 0;
+    fftProcessor.inputPrimed = false;     // rawInput no longer holds an FFT frame
+    needsRedraw = true;
+    
+    debugLog(String("FreqScanner: Tone monitor ") + (enabled ? "on, " : "off, ") +
+             String(toneMonitor.getDetectorCount()) + " detectors");
+    return true;
 }
 
-float FreqScanner::kaiserWindow(int n, int N, float beta) {
-    float arg = beta * sqrt(1.0 - pow(2.0 * n / (N - 1) - 1.0, 2));
-    // Simplified Bessel function approximation
-    float i0_beta = 1.0 + pow(arg / 2.0, 2) + pow(arg / 4.0, 4) / 9.0;
-    float i0_beta_0 = 1.0 + pow(beta / 2.0, 2) + pow(beta / 4.0, 4) / 9.0;
-    return i0_beta / i0_beta_0;
+int8_t FreqScanner::addToneDetector(float frequency, float onDb, float hysteresisDb) {
+    int8_t slot = toneMonitor.addDetector(frequency, onDb, hysteresisDb);
+    if (slot < 0) {
+        debugLog("FreqScanner: Cannot add tone detector at " + formatFrequency(frequency));
+    }
+    needsRedraw = true;
+    return slot;
 }
 
-// ===== PEAK DETECTION IMPLEMENTATION =====
-
-void FreqScanner::detectPeaks() {
-    detectedPeaks.clear();
-    
-    // Find local maxima above threshold
-    for (uint16_t i = 2; i < fftProcessor.size / 2 - 2; i++) {
-        if (isPeak(i) && fftProcessor.smoothedSpectrum[i] > config.peakThreshold) {
-            SpectralPeak peak;
-            peak.binIndex = i;
-            peak.frequency = interpolatePeakFrequency(i);
-            peak.magnitude = fftProcessor.smoothedSpectrum[i];
-            peak.phase = fftProcessor.phaseSpectrum[i];
-            peak.isValid = true;
-            peak.timestamp = millis();
-            
-            detectedPeaks.push_back(peak);
-        }
-    }
+void FreqScanner::removeToneDetector(uint8_t index) {
+    toneMonitor.removeDetector(index);
     
-    // Sort peaks by magnitude and keep only the strongest ones
-    sortPeaksByMagnitude();
+    // Pick up the closing off event before the slot can be reused
+    ToneEvent event;
+    while (toneMonitor.pollEvent(event)) {
+        stats.toneEvents++;
+        logToneEvent(event);
+    }
     
-    if (detectedPeaks.size() > config.maxPeaks) {
-        detectedPeaks.resize(config.maxPeaks);
+    for (uint8_t i = 0; i < 2; i++) {
+        if (markers[i].detector == (int8_t)index) {
+            markers[i].detector = -1;
+            markers[i].color = colorMarkers;
+        }
     }
+    needsRedraw = true;
+}
+
+bool FreqScanner::bindMarkerToDetector(uint8_t marker, int8_t detector) {
+    if (marker >= 2) return false;
     
-    // Update statistics
-    stats.peaksDetected += detectedPeaks.size();
+    if (detector < 0) {
+        markers[marker].detector = -1;
+        markers[marker].color = colorMarkers;
+        return true;
+    }
     
-    // Update peak signal level
-    if (!detectedPeaks.empty()) {
-        float maxMagnitude = detectedPeaks[0].magnitude;
-        if (maxMagnitude > stats.peakSignalLevel) {
-            stats.peakSignalLevel = maxMagnitude;
+    if (!toneMonitor.getDetector(detector)) return false;
+    markers[marker].detector = detector;
+    markers[marker].isEnabled = true;
+    syncMonitorMarkers();
+    needsRedraw = true;
+    return true;
+}
+
+void FreqScanner::addFrequencyMarker(float frequency) {
+    for (uint8_t i = 0; i < 2; i++) {
+        FrequencyMarker& marker = markers[i];
+        if (marker.isEnabled) continue;
+        
+        marker.frequency = frequency;
+        marker.isEnabled = true;
+        marker.detector = -1;
+        marker.color = colorMarkers;
+        marker.label = "M" + String(i + 1);
+        
+        // In monitor mode a marker is a detector with a cursor on it
+        if (config.monitorEnabled) {
+            int8_t slot = addToneDetector(frequency);
+            if (slot >= 0) bindMarkerToDetector(i, slot);
         }
+        needsRedraw = true;
+        return;
     }
 }
 
-bool FreqScanner::isPeak(uint16_t binIndex) {
-    float current = fftProcessor.smoothedSpectrum[binIndex];
-    float prev1 = fftProcessor.smoothedSpectrum[binIndex - 1];
-    float prev2 = fftProcessor.smoothedSpectrum[binIndex - 2];
-    float next1 = fftProcessor.smoothedSpectrum[binIndex + 1];
-    float next2 = fftProcessor.smoothedSpectrum[binIndex + 2];
+void FreqScanner::removeFrequencyMarker(uint8_t index) {
+    if (index >= 2) return;
     
-    // Peak must be higher than surrounding bins and significantly above noise floor
-    return (current > prev1 && current > prev2 && 
-            current > next1 && current > next2 &&
-            current > noiseFloor + 6.0); // 6dB above noise floor
+    if (markers[index].detector >= 0) {
+        removeToneDetector(markers[index].detector);
+    }
+    markers[index].isEnabled = false;
+    needsRedraw = true;
 }
 
-float FreqScanner::interpolatePeakFrequency(uint16_t binIndex) {
-    // Parabolic interpolation for more accurate frequency estimation
-    float y1 = fftProcessor.smoothedSpectrum[binIndex - 1];
-    float y2 = fftProcessor.smoothedSpectrum[binIndex];
-    float y3 = fftProcessor.smoothedSpectrum[binIndex + 1];
-    
-    float a = (y1 - 2*y2 + y3) / 2.0;
-    float b = (y3 - y1) / 2.0;
+// ===== WINDOW FUNCTION IMPLEMENTATION =====
+
+void FreqScanner::generateWindow(WindowShape shape) {
+    if (!buildWindow(shape, fftProcessor.size, config.kaiserBeta, FFT_ADC_VOLTS_PER_COUNT,
+                     fftProcessor.windowBuffer, fftProcessor.windowCorrection)) {
+        debugLog("FreqScanner: No window table for size " + String(fftProcessor.size));
+        return;
+    }
     
-    float peakOffset = 0.0;
-    if (a != 0.0) {
-        peakOffset = -b / (2.0 * a);
+    // Levels read as dB of the tone's peak volts whatever the window
+    accumulator.setDbOffset(10.0 * log10(fftProcessor.windowCorrection.toneScale));
+}
+
+void FreqScanner::setWindowType(WindowShape shape) {
+    config.windowType = shape;
+    updateWindowType();
+}
+
+void FreqScanner::setKaiserBeta(float beta) {
+    if (beta < 0.0) beta = 0.0;
+    config.kaiserBeta = beta;
+    if (config.windowType == WINDOW_SHAPE_KAISER) {
+        updateWindowType();
     }
+}
+
+void FreqScanner::updateWindowType() {
+    if (!fftProcessor.isInitialized) return;
     
-    float interpolatedBin = binIndex + peakOffset;
-    return interpolatedBin * fftProcessor.binWidth;
+    fftProcessor.windowType = config.windowType;
+    generateWindow(config.windowType);
+    accumulator.reset();
+    needsRedraw = true;
 }
 
-void FreqScanner::sortPeaksByMagnitude() {
-    std::sort(detectedPeaks.begin(), detectedPeaks.end(),
-              [](const SpectralPeak& a, const SpectralPeak& b) {
-                  return a.magnitude > b.magnitude;
-              });
+// ===== PEAK DETECTION IMPLEMENTATION =====
+
+void FreqScanner::detectPeaks() {
+    // Peaks must clear the threshold and sit 6dB above the noise floor
+    float floorDb = noiseFloor + 6.0;
+    if (config.peakThreshold > floorDb) floorDb = config.peakThreshold;
+    
+    uint8_t count = peakTracker.process(fftProcessor.smoothedSpectrum, fftProcessor.phaseSpectrum,
+                                        fftProcessor.size / 2, fftProcessor.startFrequency,
+                                        fftProcessor.binWidth, floorDb,
+                                        config.maxPeaks, millis());
+    
+    // Update statistics
+    stats.peaksDetected += count;
+    
+    // Update peak signal level (peaks are strongest first)
+    if (count > 0) {
+        float maxMagnitude = peakTracker.getPeaks()[0].magnitude;
+        if (maxMagnitude > stats.peakSignalLevel) {
+            stats.peakSignalLevel = maxMagnitude;
+        }
+    }
+    
+    if (uiState.selectedTrack && !peakTracker.findTrack(uiState.selectedTrack)) {
+        uiState.selectedTrack = 0;
+    }
 }
 
 // ===== WATERFALL DISPLAY IMPLEMENTATION =====
@@ -678,25 +930,21 @@ void FreqScanner::sortPeaksByMagnitude() {
 bool FreqScanner::initializeWaterfall() {
     debugLog("FreqScanner: Initializing waterfall display");
     
-    // Allocate waterfall history buffer
-    waterfallDisplay.historyBuffer = new uint16_t*[waterfallDisplay.historyDepth];
-    if (!waterfallDisplay.historyBuffer) {
+    uint16_t width = waterfallDisplay.width;
+    
+    // History holds one palette index per pixel in a single block; colors are
+    // only looked up when a line is sent to the display
+    if (!waterfallDisplay.ring.allocate(width, waterfallDisplay.historyDepth, WATERFALL_AREA_H)) {
         debugLog("FreqScanner: Failed to allocate waterfall history buffer");
         return false;
     }
     
-    for (uint16_t i = 0; i < waterfallDisplay.historyDepth; i++) {
-        waterfallDisplay.historyBuffer[i] = new uint16_t[waterfallDisplay.width];
-        if (!waterfallDisplay.historyBuffer[i]) {
-            debugLog("FreqScanner: Failed to allocate waterfall line buffer");
-            return false;
-        }
-        
-        // Initialize with minimum intensity
-        for (uint16_t j = 0; j < waterfallDisplay.width; j++) {
-            waterfallDisplay.historyBuffer[i][j] = 0;
-        }
+    waterfallDisplay.binStart = new uint16_t[width + 1];
+    if (!waterfallDisplay.binStart) {
+        debugLog("FreqScanner: Failed to allocate waterfall bin map");
+        return false;
     }
+    waterfallDisplay.binMapValid = false;
     
     // Allocate color palette
     waterfallDisplay.colorPalette = new uint16_t[waterfallDisplay.paletteSize];
@@ -708,7 +956,12 @@ bool FreqScanner::initializeWaterfall() {
     // Generate color palette
     generateColorPalette();
     
-    debugLog("FreqScanner: Waterfall display initialized");
+    waterfallDisplay.indexScale = (waterfallDisplay.paletteSize - 1) /
+                                  (waterfallDisplay.intensityMax - waterfallDisplay.intensityMin);
+    
+    debugLog("FreqScanner: Waterfall display initialized, history " +
+             String(waterfallDisplay.ring.historyBytes()) + " bytes (" + String(waterfallDisplay.historyDepth) +
+             " lines)");
     return true;
 }
 
@@ -716,15 +969,13 @@ void FreqScanner::shutdownWaterfall() {
     debugLog("FreqScanner: Shutting down waterfall display");
     
     // Free waterfall history buffer
-    if (waterfallDisplay.historyBuffer) {
-        for (uint16_t i = 0; i < waterfallDisplay.historyDepth; i++) {
-            if (waterfallDisplay.historyBuffer[i]) {
-                delete[] waterfallDisplay.historyBuffer[i];
-            }
-        }
-        delete[] waterfallDisplay.historyBuffer;
-        waterfallDisplay.historyBuffer = nullptr;
+    waterfallDisplay.ring.release();
+    
+    if (waterfallDisplay.binStart) {
+        delete[] waterfallDisplay.binStart;
+        waterfallDisplay.binStart = nullptr;
     }
+    waterfallDisplay.binMapValid = false;
     
     // Free color palette
     if (waterfallDisplay.colorPalette) {
@@ -734,52 +985,131 @@ void FreqScanner::shutdownWaterfall() {
 }
 
 void FreqScanner::updateWaterfall() {
-    if (!waterfallDisplay.historyBuffer || !fftProcessor.isInitialized) return;
+    if (!waterfallDisplay.ring.isAllocated() || !fftProcessor.isInitialized) return;
+    
+    uint16_t bins = fftProcessor.size / 2;
+    if (!waterfallDisplay.binMapValid ||
+        waterfallDisplay.mapZoom != uiState.zoomLevel ||
+        waterfallDisplay.mapPanHz != uiState.panOffsetHz ||
+        waterfallDisplay.mapBins != bins) {
+        rebuildBinMap();
+    }
+    
+    const float* spectrum = fftProcessor.smoothedSpectrum;
+    const uint16_t* binStart = waterfallDisplay.binStart;
+    uint8_t* currentLine = waterfallDisplay.ring.beginLine();
     
-    // Map spectrum data to waterfall pixels
-    uint16_t* currentLine = waterfallDisplay.historyBuffer[waterfallDisplay.currentLine];
+    bool useMax = waterfallDisplay.pooling == POOL_MAX;
     
     for (uint16_t x = 0; x < waterfallDisplay.width; x++) {
-        // Map pixel to frequency bin
-        uint16_t binIndex = (x * fftProcessor.size / 2) / waterfallDisplay.width;
-        if (binIndex >= fftProcessor.size / 2) binIndex = fftProcessor.size / 2 - 1;
-        
-        // Get magnitude and convert to color index
-        float magnitude = fftProcessor.smoothedSpectrum[binIndex];
-        currentLine[x] = intensityToColor(magnitude);
+        currentLine[x] = intensityToIndex(poolWaterfallPixel(spectrum, binStart, x, useMax));
     }
     
-    // Advance to next line
-    waterfallDisplay.currentLine = (waterfallDisplay.currentLine + 1) % waterfallDisplay.historyDepth;
+    waterfallDisplay.ring.commitLine();
+}
+
+void FreqScanner::rebuildBinMap() {
+    // Pixel x covers bins [binStart[x], binStart[x + 1]). The view spans the
+    // same 0..Nyquist range as the spectrum, narrowed by zoom and shifted by pan.
+    uint16_t bins = fftProcessor.size / 2;
+    float zoom = uiState.zoomLevel >= 1.0 ? uiState.zoomLevel : 1.0;
+    float nyquist = bins * fftProcessor.binWidth;
+    float span = nyquist / zoom;
+    float startHz = uiState.panOffsetHz;
+    if (startHz < 0) startHz = 0;
+    if (startHz > nyquist - span) startHz = nyquist - span;
+    
+    float binsPerPixel = span / fftProcessor.binWidth / waterfallDisplay.width;
+    float firstBin = startHz / fftProcessor.binWidth;
+    
+    buildWaterfallBinMap(waterfallDisplay.binStart, waterfallDisplay.width, bins,
+                         firstBin, binsPerPixel);
+    
+    waterfallDisplay.mapZoom = uiState.zoomLevel;
+    waterfallDisplay.mapPanHz = uiState.panOffsetHz;
+    waterfallDisplay.mapBins = bins;
+    waterfallDisplay.binMapValid = true;
+}
+
+void FreqScanner::setWaterfallPalette(WaterfallPalette palette) {
+    if (palette >= PALETTE_COUNT) palette = PALETTE_THERMAL;
+    waterfallDisplay.palette = palette;
+    
+    // History keeps indices, so a repaint is all that's needed
+    if (waterfallDisplay.colorPalette) {
+        generateColorPalette();
+        waterfallDisplay.ring.invalidate();
+    }
+}
+
+void FreqScanner::setWaterfallPooling(WaterfallPooling pooling) {
+    waterfallDisplay.pooling = pooling;
+}
+
+void FreqScanner::configureWaterfallRegion() {
+    // The ILI9341 scrolls along its native 320-line axis, which is screen X
+    // in the landscape rotation, so the area is kept as a ring in software
+    waterfallDisplay.ring.invalidate();
+    waterfallDisplay.regionActive = true;
+}
+
+void FreqScanner::releaseWaterfallRegion() {
+    waterfallDisplay.regionActive = false;
+}
+
+void WaterfallAreaSink::pushRow(uint16_t row, const uint16_t* pixels, uint16_t width) {
+    if (width > WATERFALL_AREA_W) width = WATERFALL_AREA_W;
+    displayManager.pushPixels(WATERFALL_AREA_X, WATERFALL_AREA_Y + row, width, 1, pixels);
 }
 
 void FreqScanner::generateColorPalette() {
-    // Generate blue-to-red intensity color palette
     for (uint8_t i = 0; i < waterfallDisplay.paletteSize; i++) {
         float intensity = (float)i / (waterfallDisplay.paletteSize - 1);
         
         uint8_t r, g, b;
         
-        if (intensity < 0.25) {
-            // Black to blue
-            r = 0;
-            g = 0;
-            b = (uint8_t)(intensity * 4 * 255);
-        } else if (intensity < 0.5) {
-            // Blue to cyan
-            r = 0;
-            g = (uint8_t)((intensity - 0.25) * 4 * 255);
-            b = 255;
-        } else if (intensity < 0.75) {
-            // Cyan to yellow
-            r = (uint8_t)((intensity - 0.5) * 4 * 255);
-            g = 255;
-            b = (uint8_t)(255 - (intensity - 0.5) * 4 * 255);
-        } else {
-            // Yellow to red
-            r = 255;
-            g = (uint8_t)(255 - (intensity - 0.75) * 4 * 255);
-            b = 0;
+        switch (waterfallDisplay.palette) {
+            case PALETTE_PHOSPHOR:
+                // Black to green, then green to white
+                if (intensity < 0.6) {
+                    r = 0;
+                    g = (uint8_t)(intensity / 0.6 * 255);
+                    b = 0;
+                } else {
+                    r = (uint8_t)((intensity - 0.6) / 0.4 * 255);
+                    g = 255;
+                    b = r;
+                }
+                break;
+                
+            case PALETTE_GRAYSCALE:
+                r = g = b = (uint8_t)(intensity * 255);
+                break;
+                
+            case PALETTE_THERMAL:
+            default:
+                if (intensity < 0.25) {
+                    // Black to blue
+                    r = 0;
+                    g = 0;
+                    b = (uint8_t)(intensity * 4 * 255);
+                } else if (intensity < 0.5) {
+                    // Blue to cyan
+                    r = 0;
+                    g = (uint8_t)((intensity - 0.25) * 4 * 255);
+                    b = 255;
+                } else if (intensity < 0.75) {
+                    // Cyan to yellow
+                    r = (uint8_t)((intensity - 0.5) * 4 * 255);
+                    g = 255;
+                    b = (uint8_t)(255 - (intensity - 0.5) * 4 * 255);
+                } else {
+                    // Yellow to red
+                    r = 255;
+                    g = (uint8_t)(255 - (intensity - 0.75) * 4 * 255);
+                    b = 0;
+                }
+                break;
         }
         
         // Convert to RGB565
@@ -787,17 +1117,15 @@ void FreqScanner::generateColorPalette() {
     }
 }
 
-uint16_t FreqScanner::intensityToColor(float intensity) {
+uint8_t FreqScanner::intensityToIndex(float intensity) {
     // Map intensity range to palette index
-    float normalizedIntensity = (intensity - waterfallDisplay.intensityMin) / 
-                               (waterfallDisplay.intensityMax - waterfallDisplay.intensityMin);
+    float index = (intensity - waterfallDisplay.intensityMin) * waterfallDisplay.indexScale;
     
     // Clamp to valid range
-    if (normalizedIntensity < 0.0) normalizedIntensity = 0.0;
-    if (normalizedIntensity > 1.0) normalizedIntensity = 1.0;
+    if (index <= 0.0) return 0;
+    if (index >= waterfallDisplay.paletteSize - 1) return waterfallDisplay.paletteSize - 1;
     
-    uint8_t paletteIndex = (uint8_t)(normalizedIntensity * (waterfallDisplay.paletteSize - 1));
-    return waterfallDisplay.colorPalette[paletteIndex];
+    return (uint8_t)index;
 }
 
 // ===== SIGNAL GENERATOR IMPLEMENTATION =====
@@ -805,11 +1133,14 @@ uint16_t FreqScanner::intensityToColor(float intensity) {
 bool FreqScanner::initializeGenerator() {
     debugLog("FreqScanner: Initializing signal generator");
     
-    // Configure DAC pin
-    signalGenerator.dacPin = DAC_OUT_LEFT;
+    generatorRender = new float[DDS_BLOCK_SIZE];
+    if (!generatorRender) {
+        debugLog("FreqScanner: Failed to allocate generator buffers");
+        return false;
+    }
     
-    // Calculate phase increment
-    signalGenerator.phaseIncrement = 2.0 * M_PI * signalGenerator.frequency / signalGenerator.sampleRate;
+    dds.begin(signalGenerator.sampleRate);
+    dds.setParams(buildGeneratorParams());
     
     debugLog("FreqScanner: Signal generator initialized");
     return true;
@@ -820,126 +1151,114 @@ void FreqScanner::shutdownGenerator() {
     
     // Stop generation
     signalGenerator.isEnabled = false;
+    stopGeneratorOutput();
+    dacOutput.release();
     
-    // Set DAC to zero
-    if (signalGenerator.useDac) {
-        dacWrite(signalGenerator.dacPin, 0);
+    if (generatorRender) {
+        delete[] generatorRender;
+        generatorRender = nullptr;
     }
 }
 
 void FreqScanner::updateGenerator() {
-    if (!signalGenerator.isEnabled) return;
-    
-    // Generate sample
-    float sample = generateSample();
-    
-    // Apply modulation
-    applyModulation(sample);
+    if (!signalGenerator.isEnabled || !dacOutput.isRunning()) return;
     
-    // Apply amplitude scaling
-    sample *= signalGenerator.amplitude;
+    // Samples are produced by the output task; here we only hand over
+    // settings that changed since the last frame
+    DDSParams params = buildGeneratorParams();
+    if (memcmp(&params, &pendingParams, sizeof(DDSParams)) == 0) return;
     
-    // Output to DAC
-    outputToDAC(sample);
-    
-    // Update phase
-    signalGenerator.phase += signalGenerator.phaseIncrement;
-    if (signalGenerator.phase >= 2.0 * M_PI) {
-        signalGenerator.phase -= 2.0 * M_PI;
-    }
+    portENTER_CRITICAL(&generatorMux);
+    pendingParams = params;
+    paramsPending = true;
+    portEXIT_CRITICAL(&generatorMux);
 }
 
-float FreqScanner::generateSample() {
+DDSParams FreqScanner::buildGeneratorParams() {
+    DDSParams params;
+    memset(&params, 0, sizeof(params)); // Padding too, so params can be memcmp'd
+    
     switch (signalGenerator.waveform) {
-        case SignalGenerator::WAVE_SINE:
-            return generateSineWave();
-            
-        case SignalGenerator::WAVE_SQUARE:
-            return generateSquareWave();
-            
-        case SignalGenerator::WAVE_TRIANGLE:
-            return generateTriangleWave();
-            
-        case SignalGenerator::WAVE_SAWTOOTH:
-            return generateSawtoothWave();
-            
-        case SignalGenerator::WAVE_NOISE:
-            return generateNoise();
-            
-        case SignalGenerator::WAVE_SWEEP:
-            return generateSweep();
-            
-        default:
-            return 0.0;
-    }
-}
-
-float FreqScanner::generateSineWave() {
-    return sin(signalGenerator.phase);
-}
-
-float FreqScanner::generateSquareWave() {
-    return (signalGenerator.phase < M_PI) ? 1.0 : -1.0;
-}
-
-float FreqScanner::generateTriangleWave() {
-    if (signalGenerator.phase < M_PI) {
-        return -1.0 + 2.0 * signalGenerator.phase / M_PI;
-    } else {
-        return 3.0 - 2.0 * signalGenerator.phase / M_PI;
+        case SignalGenerator::WAVE_SQUARE:   params.waveform = DDS_SQUARE; break;
+        case SignalGenerator::WAVE_TRIANGLE: params.waveform = DDS_TRIANGLE; break;
+        case SignalGenerator::WAVE_SAWTOOTH: params.waveform = DDS_SAWTOOTH; break;
+        case SignalGenerator::WAVE_NOISE:    params.waveform = DDS_NOISE; break;
+        case SignalGenerator::WAVE_SWEEP:    params.waveform = DDS_SWEEP; break;
+        default:                             params.waveform = DDS_SINE; break;
     }
-}
-
-float FreqScanner::generateSawtoothWave() {
-    return -1.0 + signalGenerator.phase / M_PI;
-}
-
-float FreqScanner::generateNoise() {
-    return 2.0 * ((float)random(0, 32767) / 32767.0) - 1.0;
-}
-
-float FreqScanner::generateSweep() {
-    // Linear frequency sweep
-    unsigned long currentTime = millis();
-    float sweepProgress = fmod((float)(currentTime) / 1000.0, signalGenerator.sweepDuration) / 
-                         signalGenerator.sweepDuration;
     
-    float currentFreq = signalGenerator.sweepStartFreq + 
-                       sweepProgress * (signalGenerator.sweepEndFreq - signalGenerator.sweepStartFreq);
+    switch (signalGenerator.modulation) {
+        case SignalGenerator::MOD_AM:  params.modulation = DDS_MOD_AM; break;
+        case SignalGenerator::MOD_FM:  params.modulation = DDS_MOD_FM; break;
+        case SignalGenerator::MOD_PWM: params.modulation = DDS_MOD_PWM; break;
+        default:                       params.modulation = DDS_MOD_NONE; break;
+    }
+    
+    params.sweepShape = signalGenerator.logSweep ? DDS_SWEEP_LOG : DDS_SWEEP_LINEAR;
+    params.frequency = signalGenerator.frequency;
+    params.amplitude = signalGenerator.amplitude;
+    params.dutyCycle = signalGenerator.dutyCycle;
+    params.modFrequency = signalGenerator.modFrequency;
+    params.modDepth = signalGenerator.modDepth;
+    params.sweepStartFreq = signalGenerator.sweepStartFreq;
+    params.sweepEndFreq = signalGenerator.sweepEndFreq;
+    params.sweepDuration = signalGenerator.sweepDuration;
+    return params;
+}
+
+bool FreqScanner::startGeneratorOutput() {
+    if (dacOutput.isRunning()) return true;
+    if (!signalGenerator.useDac || !generatorRender) return false;
+    
+    pendingParams = buildGeneratorParams();
+    paramsPending = false;
+    dds.begin(signalGenerator.sampleRate);
+    dds.setParams(pendingParams);
+    
+    DacOutputConfig config;
+    config.sampleRate = signalGenerator.sampleRate;
+    config.blockSize = DDS_BLOCK_SIZE;
+    config.dmaBuffers = GENERATOR_DMA_BUFFERS;
+    config.taskName = "freqgen";
+    config.taskStack = GENERATOR_TASK_STACK;
+    config.taskPriority = GENERATOR_TASK_PRIORITY;
+    config.taskCore = GENERATOR_TASK_CORE;
+    config.stopTimeout = GENERATOR_STOP_TIMEOUT;
+    if (!dacOutput.start(config, renderGeneratorBlock, this)) {
+        debugLog("FreqScanner: Failed to start generator output");
+        return false;
+    }
     
-    float instantPhaseIncrement = 2.0 * M_PI * currentFreq / signalGenerator.sampleRate;
-    return sin(signalGenerator.phase);
+    debugLog("FreqScanner: Generator output started at " + String(signalGenerator.sampleRate) + " Hz");
+    return true;
 }
 
-void FreqScanner::applyModulation(float& sample) {
-    if (signalGenerator.modulation == SignalGenerator::MOD_NONE) return;
-    
-    float modPhase = 2.0 * M_PI * signalGenerator.modFrequency * millis() / 1000.0;
-    float modSignal = sin(modPhase);
+void FreqScanner::stopGeneratorOutput() {
+    if (!dacOutput.isRunning()) return;
     
-    switch (signalGenerator.modulation) {
-        case SignalGenerator::MOD_AM:
-            sample *= (1.0 + signalGenerator.modDepth * modSignal);
-            break;
-            
-        case SignalGenerator::MOD_FM:
-            // Frequency modulation affects phase increment
-            signalGenerator.phaseIncrement = 2.0 * M_PI * 
-                (signalGenerator.frequency + signalGenerator.modDepth * signalGenerator.frequency * modSignal) /
-                signalGenerator.sampleRate;
-            break;
-            
-        default:
-            break;
+    stats.generatorBlocks += dacOutput.getBlocks();
+    if (!dacOutput.stop()) {
+        debugLog("FreqScanner: Generator task did not exit, deleted");
     }
+    debugLog("FreqScanner: Generator output stopped");
 }
 
-void FreqScanner::outputToDAC(float sample) {
-    if (signalGenerator.useDac) {
-        // Convert to DAC range (0-255 for 8-bit DAC)
-        uint8_t dacValue = (uint8_t)((sample + 1.0) * 127.5);
-        dacWrite(signalGenerator.dacPin, dacValue);
+void FreqScanner::renderGeneratorBlock(void* context, uint16_t* out, uint16_t count) {
+    static_cast<FreqScanner*>(context)->renderGenerator(out, count);
+}
+
+// Runs on the DAC output task
+void FreqScanner::renderGenerator(uint16_t* out, uint16_t count) {
+    if (paramsPending) {
+        portENTER_CRITICAL(&generatorMux);
+        DDSParams params = pendingParams;
+        paramsPending = false;
+        portEXIT_CRITICAL(&generatorMux);
+        dds.setParams(params);
     }
+    
+    dds.render(generatorRender, count);
+    DDSGenerator::toDacSamples(generatorRender, out, count);
 }
 
 // ===== TOUCH HANDLING IMPLEMENTATION =====
@@ -988,6 +1307,11 @@ void FreqScanner::handleSpectrumTouch(TouchPoint touch) {
         updateMeasurementCursor(touch);
     }
     
+    // In monitor mode a tap drops a marker, which adds a detector there
+    if (config.monitorEnabled && touch.isNewPress) {
+        addFrequencyMarker(frequency);
+    }
+    
     // Add frequency marker on double-tap
     // (This would need gesture detection from TouchInterface)
     
@@ -997,17 +1321,19 @@ void FreqScanner::handleSpectrumTouch(TouchPoint touch) {
 void FreqScanner::selectPeakNearTouch(TouchPoint touch) {
     float touchFreq = pixelToFrequency(touch.x);
     float minDistance = fftProcessor.binWidth * 5; // 5 bins tolerance
-    int nearestPeak = -1;
+    uint16_t nearestTrack = 0;
     
-    for (size_t i = 0; i < detectedPeaks.size(); i++) {
-        float distance = abs(detectedPeaks[i].frequency - touchFreq);
+    // Select by track so the choice follows the signal as it drifts
+    const SpectralPeak* peaks = peakTracker.getPeaks();
+    for (uint8_t i = 0; i < peakTracker.getPeakCount(); i++) {
+        float distance = fabs(peaks[i].frequency - touchFreq);
         if (distance < minDistance) {
             minDistance = distance;
-            nearestPeak = i;
+            nearestTrack = peaks[i].trackId;
         }
     }
     
-    uiState.selectedPeak = nearestPeak;
+    uiState.selectedTrack = nearestTrack;
 }
 
 // ===== RENDERING IMPLEMENTATION =====
@@ -1070,8 +1396,8 @@ void FreqScanner::renderGrid() {
 
 void FreqScanner::renderFrequencyAxis() {
     // Draw frequency labels
-    uint16_t freqMin = getFrequencyRangeMin();
-    uint16_t freqMax = getFrequencyRangeMax();
+    uint32_t freqMin = getFrequencyRangeMin();
+    uint32_t freqMax = getFrequencyRangeMax();
     
     for (uint16_t i = 0; i <= 4; i++) {
         uint16_t x = SPECTRUM_AREA_X + (i * SPECTRUM_AREA_W) / 4;
@@ -1103,8 +1429,9 @@ void FreqScanner::drawSpectrumLine(uint16_t x, float magnitude) {
 }
 
 void FreqScanner::renderPeaks() {
-    for (const auto& peak : detectedPeaks) {
-        drawPeakMarker(peak);
+    const SpectralPeak* peaks = peakTracker.getPeaks();
+    for (uint8_t i = 0; i < peakTracker.getPeakCount(); i++) {
+        drawPeakMarker(peaks[i]);
     }
 }
 
@@ -1112,14 +1439,25 @@ void FreqScanner::drawPeakMarker(const SpectralPeak& peak) {
     uint16_t x = frequencyToPixel(peak.frequency);
     uint16_t y = amplitudeToPixel(peak.magnitude);
     
+    bool selected = peak.trackId != 0 && peak.trackId == uiState.selectedTrack;
+    uint16_t color = selected ? colorMarkers : colorPeaks;
+    
     // Draw peak symbol
-    displayManager.drawRetroCircle(x, y, PEAK_MARKER_SIZE / 2, colorPeaks, false);
+    displayManager.drawRetroCircle(x, y, PEAK_MARKER_SIZE / 2, color, false);
     
     // Draw frequency label if enabled
     if (uiState.showPeakLabels) {
         String freqLabel = formatFrequency(peak.frequency);
         displayManager.setFont(FONT_SMALL);
-        displayManager.drawText(x - 15, y - 15, freqLabel, colorPeaks);
+        displayManager.drawText(x - 15, y - 15, freqLabel, color);
+        
+        // Selected track also shows how long it has lasted and how far it moved
+        const PeakTrack* track = selected ? peakTracker.findTrack(peak.trackId) : nullptr;
+        if (track) {
+            String trackLabel = "#" + String(track->id) + " " + String(track->duration() / 1000.0, 1) +
+                                "s " + (track->drift() >= 0 ? "+" : "") + String(track->drift(), 0) + "Hz";
+            displayManager.drawText(x - 15, y - 25, trackLabel, color);
+        }
     }
 }
 
@@ -1140,8 +1478,8 @@ String FreqScanner::formatAmplitude(float amplitude) {
 }
 
 uint16_t FreqScanner::frequencyToPixel(float frequency) {
-    uint16_t freqMin = getFrequencyRangeMin();
-    uint16_t freqMax = getFrequencyRangeMax();
+    uint32_t freqMin = getFrequencyRangeMin();
+    uint32_t freqMax = getFrequencyRangeMax();
     
     float normalizedFreq = (frequency - freqMin) / (freqMax - freqMin);
     return SPECTRUM_AREA_X + (uint16_t)(normalizedFreq * SPECTRUM_AREA_W);
@@ -1157,14 +1495,16 @@ uint16_t FreqScanner::amplitudeToPixel(float amplitude) {
 }
 
 float FreqScanner::pixelToFrequency(uint16_t pixel) {
-    uint16_t freqMin = getFrequencyRangeMin();
-    uint16_t freqMax = getFrequencyRangeMax();
+    uint32_t freqMin = getFrequencyRangeMin();
+    uint32_t freqMax = getFrequencyRangeMax();
     
     float normalizedPixel = (float)(pixel - SPECTRUM_AREA_X) / SPECTRUM_AREA_W;
     return freqMin + normalizedPixel * (freqMax - freqMin);
 }
 
-uint16_t FreqScanner::getFrequencyRangeMin() {
+uint32_t FreqScanner::getFrequencyRangeMin() {
+    if (config.zoomEnabled) return fftProcessor.startFrequency;
+    
     switch (config.freqRange) {
         case RANGE_AUDIO_LOW: return 20;
         case RANGE_AUDIO_MID: return 200;
@@ -1176,7 +1516,11 @@ uint16_t FreqScanner::getFrequencyRangeMin() {
     }
 }
 
-uint16_t FreqScanner::getFrequencyRangeMax() {
+uint32_t FreqScanner::getFrequencyRangeMax() {
+    if (config.zoomEnabled) {
+        return fftProcessor.startFrequency + fftProcessor.binWidth * (fftProcessor.size / 2);
+    }
+    
     switch (config.freqRange) {
         case RANGE_AUDIO_LOW: return 2000;
         case RANGE_AUDIO_MID: return 8000;
@@ -1192,18 +1536,83 @@ uint16_t FreqScanner::getFrequencyRangeMax() {
 // (Additional methods would be implemented similarly)
 
 void FreqScanner::renderWaterfall() {
-    // Waterfall rendering implementation
-    needsRedraw = true;
+    if (!waterfallDisplay.ring.isAllocated() || !waterfallDisplay.regionActive) return;
+    
+    // One address window and one row per new line; a full repaint only
+    // after the area was hidden or the palette changed
+    uint32_t bytesBefore = displayManager.getBytesPushed();
+    WaterfallAreaSink sink;
+    stats.waterfallLinesDrawn += waterfallDisplay.ring.render(sink, waterfallDisplay.colorPalette);
+    stats.waterfallBytesPushed += displayManager.getBytesPushed() - bytesBefore;
 }
 
 void FreqScanner::renderDualView() {
-    // Dual view rendering implementation  
-    needsRedraw = true;
+    renderSpectrum();
+    renderWaterfall();
+}
+
+void FreqScanner::renderMonitor() {
+    displayManager.drawRetroRect(SPECTRUM_AREA_X, SPECTRUM_AREA_Y,
+                                SPECTRUM_AREA_W, SPECTRUM_AREA_H,
+                                colorBackground, true);
+    if (uiState.showGrid) {
+        renderGrid();
+    }
+    renderFrequencyAxis();
+    renderAmplitudeAxis();
+    
+    uint16_t bottom = SPECTRUM_AREA_Y + SPECTRUM_AREA_H;
+    float freqMin = getFrequencyRangeMin();
+    float freqMax = getFrequencyRangeMax();
+    uint16_t row = 0;
+    
+    displayManager.setFont(FONT_SMALL);
+    for (uint8_t i = 0; i < toneMonitor.getDetectorCount(); i++) {
+        const ToneDetector* detector = toneMonitor.getDetector(i);
+        if (!detector) continue;
+        
+        uint16_t color = detector->active ? colorPeaks : colorSpectrum;
+        
+        // Level bar with a tick at the on threshold
+        if (detector->frequency >= freqMin && detector->frequency <= freqMax) {
+            uint16_t x = frequencyToPixel(detector->frequency);
+            uint16_t y = amplitudeToPixel(detector->levelDb);
+            displayManager.drawRetroRect(x - 2, y, 5, bottom - y, color, true);
+            uint16_t threshold = amplitudeToPixel(detector->onDb);
+            displayManager.drawRetroLine(x - 5, threshold, x + 5, threshold, colorMarkers);
+        }
+        
+        // On/off history below the bars
+        String summary = "T" + String(i + 1) + " " + formatFrequency(detector->frequency) + " " +
+                         String(detector->levelDb, 0) + "dB " + (detector->active ? "ON " : "off ") +
+                         String(detector->onCount) + "x last " + String(detector->lastOnMs) +
+                         "ms max " + String(detector->longestOnMs) + "ms";
+        displayManager.drawText(5, bottom + FREQUENCY_AXIS_H + row * 10, summary, color);
+        row++;
+    }
+    
+    if (uiState.showMarkers) {
+        renderMarkers();
+    }
 }
 
 void FreqScanner::renderRecordingInterface() {
-    // Recording interface implementation
-    needsRedraw = true;
+    displayManager.setFont(FONT_SMALL);
+    
+    String line;
+    if (signalRecording.isRecording) {
+        uint32_t elapsed = millis() - signalRecording.startTime;
+        line = "REC " + String(elapsed / 1000) + "s | " +
+               String(signalRecording.writer.getBytesWritten() / 1024) + "KB | " +
+               String(signalRecording.recordedFrames) + " spectra";
+    } else if (signalPlayback.isPlaying) {
+        line = "PLAY " + String((millis() - signalPlayback.startTime) / 1000) + "/" +
+               String(signalPlayback.reader.getHeader().durationMs / 1000) + "s";
+    } else {
+        line = String(stats.recordingsSaved) + " recordings";
+    }
+    displayManager.drawText(5, SPECTRUM_AREA_Y + 5, line,
+                            signalRecording.isRecording ? colorPeaks : colorText);
 }
 
 void FreqScanner::renderGeneratorInterface() {
@@ -1220,7 +1629,16 @@ void FreqScanner::renderStatusBar() {
     // Status bar implementation
     String status = "FFT: " + String(config.fftSize) + " | " + 
                    formatFrequency(config.sampleRate / 2) + " | " +
-                   String(stats.fftProcessedCount) + " processed";
+                   String(stats.fftProcessedCount) + " processed | " +
+                   SpectrumAccumulator::modeName(config.spectrumMode);
+    if (config.monitorEnabled) {
+        status = "Tones: " + String(toneMonitor.getDetectorCount()) + " | " +
+                 String(toneMonitor.getActiveCount()) + " on | " +
+                 String(toneMonitor.getBlockDuration() * 1000, 0) + "ms blocks | " +
+                 String(stats.toneEvents) + " events";
+    } else if (config.zoomEnabled) {
+        status += " | x" + String(config.zoomDecimation) + " " + String(fftProcessor.binWidth, 2) + "Hz/bin";
+    }
     
     displayManager.setFont(FONT_SMALL);
     displayManager.drawText(5, 5, status, colorText);
@@ -1249,6 +1667,250 @@ void FreqScanner::drawFrequencyMarker(const FrequencyMarker& marker) {
     displayManager.drawText(x + 2, SPECTRUM_AREA_Y + 10, marker.label, marker.color);
 }
 
+// ===== RECORDING IMPLEMENTATION =====
+
+bool FreqScanner::startRecording(const String& filename) {
+    if (signalRecording.isRecording || !fftProcessor.isInitialized) return false;
+    if (signalPlayback.isPlaying) {
+        debugLog("FreqScanner: Cannot record during playback");
+        return false;
+    }
+    
+    // Buffers stay allocated between recordings
+    if (!signalRecording.writer.allocate()) {
+        debugLog("FreqScanner: Failed to allocate recording buffers");
+        return false;
+    }
+    
+    signalRecording.stream.file = SD.open(filename.c_str(), FILE_WRITE);
+    if (!signalRecording.stream.file) {
+        debugLog("FreqScanner: Failed to create " + filename);
+        return false;
+    }
+    
+    RecordingHeader header = RecordingWriter::defaultHeader();
+    header.sampleRate = config.sampleRate;
+    header.fftSize = config.fftSize;
+    header.windowType = config.windowType;
+    header.contents = (signalRecording.saveTimeData ? RECORDING_HAS_TIME : 0) |
+                      (signalRecording.saveFreqData ? RECORDING_HAS_SPECTRUM : 0);
+    header.binWidth = fftProcessor.binWidth;
+    header.startFrequency = fftProcessor.startFrequency;
+    header.freqMin = getFrequencyRangeMin();
+    header.freqMax = getFrequencyRangeMax();
+    header.voltsPerCount = FFT_ADC_VOLTS_PER_COUNT;
+    header.spectrumBins = config.fftSize / 2;
+    header.zoomDecimation = config.zoomEnabled ? config.zoomDecimation : 0;
+    header.startMillis = millis();
+    
+    if (!signalRecording.writer.begin(&signalRecording.stream, header)) {
+        signalRecording.stream.file.close();
+        debugLog("FreqScanner: Failed to write recording header");
+        return false;
+    }
+    
+    signalRecording.filename = filename;
+    signalRecording.recordedSamples = 0;
+    signalRecording.recordedFrames = 0;
+    signalRecording.writeTime = 0;
+    signalRecording.startTime = millis();
+    signalRecording.isRecording = true;
+    needsRedraw = true;
+    
+    debugLog("FreqScanner: Recording to " + filename);
+    return true;
+}
+
+void FreqScanner::stopRecording() {
+    if (!signalRecording.isRecording) return;
+    signalRecording.isRecording = false;
+    
+    unsigned long writeStart = micros();
+    bool closed = signalRecording.writer.end();
+    signalRecording.writeTime += micros() - writeStart;
+    signalRecording.stream.file.close();
+    
+    // Card throughput while recording, including the index and header rewrite
+    uint32_t bytes = signalRecording.writer.getBytesWritten();
+    float seconds = signalRecording.writeTime / 1000000.0f;
+    float kbPerSecond = seconds > 0 ? bytes / 1024.0f / seconds : 0;
+    
+    debugLog("FreqScanner: Recording " + String(closed ? "saved, " : "failed, ") +
+             String(bytes / 1024) + "KB in " + String(signalRecording.writer.getFlushCount()) +
+             " writes, " + String(kbPerSecond, 0) + "KB/s");
+    
+    if (closed) {
+        stats.recordingsSaved++;
+        saveRecordingMetadata();
+    }
+    needsRedraw = true;
+}
+
+void FreqScanner::toggleRecording() {
+    if (signalRecording.isRecording) {
+        stopRecording();
+    } else {
+        startRecording(generateRecordingFilename());
+    }
+}
+
+void FreqScanner::recordCurrentSpectrum() {
+    if (!signalRecording.isRecording) return;
+    
+    if (signalRecording.saveFreqData) {
+        recordFrequencyDomainData();
+    }
+    
+    if (signalRecording.writer.hasFailed()) {
+        debugLog("FreqScanner: Recording write failed");
+        stopRecording();
+    } else if (signalRecording.maxDuration > 0 &&
+               millis() - signalRecording.startTime >= signalRecording.maxDuration) {
+        stopRecording();
+    }
+}
+
+void FreqScanner::recordTimeDomainData(const int16_t* samples, uint16_t count) {
+    unsigned long writeStart = micros();
+    signalRecording.writer.writeTime(samples, count, millis() - signalRecording.startTime);
+    signalRecording.writeTime += micros() - writeStart;
+    signalRecording.recordedSamples += count;
+}
+
+void FreqScanner::recordFrequencyDomainData() {
+    unsigned long writeStart = micros();
+    signalRecording.writer.writeSpectrum(fftProcessor.smoothedSpectrum, fftProcessor.size / 2,
+                                         millis() - signalRecording.startTime);
+    signalRecording.writeTime += micros() - writeStart;
+    signalRecording.recordedFrames++;
+}
+
+void FreqScanner::saveRecordingMetadata() {
+    // JSON sidecar for tools that do not parse the binary header
+    const RecordingHeader& header = signalRecording.writer.getHeader();
+    signalRecording.metadata = "{\"file\":\"" + signalRecording.filename + "\"," +
+        "\"sampleRate\":" + String(header.sampleRate) + "," +
+        "\"fftSize\":" + String(header.fftSize) + "," +
+        "\"binWidth\":" + String(header.binWidth, 4) + "," +
+        "\"startFrequency\":" + String(header.startFrequency, 1) + "," +
+        "\"durationMs\":" + String(header.durationMs) + "," +
+        "\"samples\":" + String(signalRecording.recordedSamples) + "," +
+        "\"spectra\":" + String(signalRecording.recordedFrames) + "," +
+        "\"bytes\":" + String(signalRecording.writer.getBytesWritten()) + "}";
+    
+    String path = signalRecording.filename;
+    int dot = path.lastIndexOf('.');
+    if (dot > 0) path = path.substring(0, dot);
+    filesystem.writeFile(path + ".json", signalRecording.metadata);
+}
+
+bool FreqScanner::startPlayback(const String& filename) {
+    if (signalRecording.isRecording || !fftProcessor.isInitialized) return false;
+    if (signalPlayback.isPlaying) stopPlayback();
+    
+    signalPlayback.stream.file = SD.open(filename.c_str(), FILE_READ);
+    if (!signalPlayback.stream.file) {
+        debugLog("FreqScanner: Cannot open " + filename);
+        return false;
+    }
+    if (!signalPlayback.reader.open(&signalPlayback.stream)) {
+        signalPlayback.stream.file.close();
+        debugLog("FreqScanner: Not a recording: " + filename);
+        return false;
+    }
+    
+    // Without time data the stored spectra must match the current frame size
+    const RecordingHeader& header = signalPlayback.reader.getHeader();
+    signalPlayback.timeData = (header.contents & RECORDING_HAS_TIME) != 0;
+    if (!signalPlayback.timeData &&
+        (header.spectrumBins != fftProcessor.size / 2 || config.monitorEnabled)) {
+        signalPlayback.reader.close();
+        signalPlayback.stream.file.close();
+        debugLog("FreqScanner: Spectrum recording does not match the current mode");
+        return false;
+    }
+    
+    // The pipeline runs at the recorded rate until playback stops
+    signalPlayback.savedSampleRate = config.sampleRate;
+    config.sampleRate = header.sampleRate;
+    updateSampleRate();
+    if (!signalPlayback.timeData) {
+        fftProcessor.binWidth = header.binWidth;
+        fftProcessor.startFrequency = header.startFrequency;
+    }
+    
+    signalPlayback.filename = filename;
+    signalPlayback.samplesPlayed = 0;
+    signalPlayback.frameTimestamp = 0;
+    signalPlayback.finished = false;
+    signalPlayback.startTime = millis();
+    signalPlayback.isPlaying = true;
+    
+    debugLog("FreqScanner: Playing " + filename + ", " + String(header.durationMs) + "ms at " +
+             String(header.sampleRate) + " Hz" + (signalPlayback.reader.hasIndex() ? "" : " (unindexed)"));
+    return true;
+}
+
+void FreqScanner::stopPlayback() {
+    if (!signalPlayback.isPlaying) return;
+    
+    signalPlayback.isPlaying = false;
+    signalPlayback.finished = false;
+    signalPlayback.reader.close();
+    signalPlayback.stream.file.close();
+    
+    config.sampleRate = signalPlayback.savedSampleRate;
+    updateSampleRate();
+    debugLog("FreqScanner: Playback stopped");
+}
+
+bool FreqScanner::playbackDue() {
+    uint32_t elapsed = millis() - signalPlayback.startTime;
+    if (signalPlayback.timeData) {
+        return signalPlayback.samplesPlayed * 1000 / config.sampleRate <= elapsed;
+    }
+    // The next frame is read once the clock reaches the one on screen
+    return signalPlayback.frameTimestamp <= elapsed;
+}
+
+bool FreqScanner::playbackSpectrumFrame() {
+    uint32_t timestamp;
+    if (!signalPlayback.reader.readSpectrum(fftProcessor.smoothedSpectrum, fftProcessor.size / 2, timestamp)) {
+        if (!signalPlayback.loop) {
+            signalPlayback.finished = true;
+            return false;
+        }
+        signalPlayback.reader.rewind();
+        signalPlayback.startTime = millis();
+        if (!signalPlayback.reader.readSpectrum(fftProcessor.smoothedSpectrum, fftProcessor.size / 2, timestamp)) {
+            signalPlayback.finished = true;
+            return false;
+        }
+    }
+    
+    // No phase is stored
+    memset(fftProcessor.phaseSpectrum, 0, (fftProcessor.size / 2) * sizeof(float));
+    signalPlayback.frameTimestamp = timestamp;
+    return true;
+}
+
+void FreqScanner::updateSampleRate() {
+    fftProcessor.sampleRate = config.sampleRate;
+    if (toneMonitor.isConfigured()) {
+        toneMonitor.configure(config.sampleRate, config.monitorBlockSize);
+    }
+    monitorLastMicros = 0;
+    applyFrequencyScale();
+    needsRedraw = true;
+}
+
+void FreqScanner::setSampleRate(uint32_t rate) {
+    if (rate == 0) return;
+    stopPlayback();
+    config.sampleRate = rate;
+    updateSampleRate();
+}
+
 // Additional placeholder methods for configuration, recording, etc.
 void FreqScanner::loadConfiguration() { /* Implementation */ }
 void FreqScanner::saveConfiguration() { /* Implementation */ }
@@ -1257,23 +1919,54 @@ void FreqScanner::applyConfiguration() { /* Implementation */ }
 void FreqScanner::updateStatistics() { /* Implementation */ }
 void FreqScanner::resetStatistics() { /* Implementation */ }
 
-bool FreqScanner::startRecording(const String& filename) { return false; }
-void FreqScanner::stopRecording() { /* Implementation */ }
-void FreqScanner::toggleRecording() { /* Implementation */ }
-void FreqScanner::toggleGenerator() { /* Implementation */ }
+void FreqScanner::toggleGenerator() {
+    if (signalGenerator.isEnabled) {
+        signalGenerator.isEnabled = false;
+        stopGeneratorOutput();
+    } else {
+        signalGenerator.isEnabled = startGeneratorOutput();
+    }
+    needsRedraw = true;
+}
 
-void FreqScanner::handleWaterfallTouch(TouchPoint touch) { /* Implementation */ }
-void FreqScanner::handleControlPanelTouch(TouchPoint touch) { /* Implementation */ }
+void FreqScanner::handleWaterfallTouch(TouchPoint touch) {
+    // Tap cycles the palette; history is index-based so nothing is recomputed
+    if (!touch.isNewPress) return;
+    setWaterfallPalette((WaterfallPalette)((waterfallDisplay.palette + 1) % PALETTE_COUNT));
+}
+void FreqScanner::handleControlPanelTouch(TouchPoint touch) {
+    if (!touch.isNewPress) return;
+    
+    if (touch.x >= SCREEN_WIDTH / 2) {
+        // Zoom in around the selected peak, or the current centre
+        const PeakTrack* track = peakTracker.findTrack(uiState.selectedTrack);
+        float center = track ? track->frequency :
+                       (config.zoomEnabled ? config.zoomCenterHz : config.sampleRate / 4.0);
+        uint8_t decimation = config.zoomEnabled ? config.zoomDecimation * 2 : ZOOM_MIN_DECIMATION;
+        if (decimation <= ZOOM_MAX_DECIMATION) {
+            setZoomFFT(center, decimation);
+        }
+    } else if (config.zoomEnabled) {
+        // Zoom out one step, back to the full band after x2
+        if (config.zoomDecimation > ZOOM_MIN_DECIMATION) {
+            setZoomFFT(config.zoomCenterHz, config.zoomDecimation / 2);
+        } else {
+            disableZoomFFT();
+        }
+    }
+}
 void FreqScanner::updateMeasurementCursor(TouchPoint touch) { /* Implementation */ }
 
 String FreqScanner::getSettingName(uint8_t index) const { return "Setting " + String(index); }
 void FreqScanner::handleSetting(uint8_t index) { /* Implementation */ }
 
 // BaseApp overrides
-void FreqScanner::onPause() { /* Implementation */ }
+void FreqScanner::onPause() { releaseWaterfallRegion(); }
 void FreqScanner::onResume() { /* Implementation */ }
 bool FreqScanner::saveState() { return true; }
 bool FreqScanner::loadState() { return true; }
-bool FreqScanner::handleMessage(AppMessage message, void* data) { return false; }
+bool FreqScanner::handleMessage(AppMessage message) { return false; }
 
-String FreqScanner::generateRecordingFilename() { return "/recordings/rec_" + String(millis()) + ".dat"; }
\ No newline at end of file
+String FreqScanner::generateRecordingFilename() {
+    return recordingsPath + "/rec_" + String(millis()) + RECORDING_EXTENSION;
+}
\ No newline at end of file
@@ -5,6 +5,16 @@
 #include "../../core/FileSystem.h"
 #include "../../core/Config.h"
 #include "../../core/Config/hardware_pins.h"
+#include "../../core/Streams/SdFileStream.h"
+#include "../../core/Audio/DacOutput.h"
+#include "SpectrumAccumulator.h"
+#include "DDSGenerator.h"
+#include "PeakTracker.h"
+#include "ZoomFFT.h"
+#include "ToneMonitor.h"
+#include "WindowTables.h"
+#include "RecordingFormat.h"
+#include "WaterfallRing.h"
 #include <vector>
 #include <complex>
 
@@ -27,14 +37,9 @@
 #define SAMPLE_RATE_44K  44100
 #define DEFAULT_SAMPLE_RATE SAMPLE_RATE_22K
 
-// Window function types
-enum WindowType {
-    WINDOW_RECTANGULAR,
-    WINDOW_HAMMING,
-    WINDOW_BLACKMAN,
-    WINDOW_HANNING,
-    WINDOW_KAISER
-};
+// ADC input scaling (ESP32 12-bit ADC, 3.3V reference)
+#define FFT_ADC_MIDSCALE        2048
+#define FFT_ADC_VOLTS_PER_COUNT (3.3f / 4095.0f)
 
 // Frequency range presets
 enum FrequencyRange {
@@ -56,6 +61,20 @@ enum ViewMode {
     VIEW_SETTINGS         // Configuration panel
 };
 
+// Waterfall color palettes (history stores indices, so these swap freely)
+enum WaterfallPalette {
+    PALETTE_THERMAL,      // Black-blue-cyan-yellow-red
+    PALETTE_PHOSPHOR,     // Black-green-white
+    PALETTE_GRAYSCALE,    // Black-white
+    PALETTE_COUNT
+};
+
+// How FFT bins sharing one waterfall pixel are combined
+enum WaterfallPooling {
+    POOL_MAX,             // Strongest bin wins (keeps narrow peaks visible)
+    POOL_AVERAGE          // Mean of the bins
+};
+
 // Touch interaction zones
 enum TouchZone {
     ZONE_NONE,
@@ -76,38 +95,28 @@ enum TouchZone {
     ZONE_MARKER_2
 };
 
-// Peak detection structure
-struct SpectralPeak {
-    float frequency;      // Peak frequency in Hz
-    float magnitude;      // Peak magnitude in dB
-    float phase;          // Peak phase in radians
-    uint16_t binIndex;    // FFT bin index
-    bool isValid;         // Peak validity flag
-    unsigned long timestamp; // When peak was detected
-    
-    SpectralPeak() : frequency(0), magnitude(-120), phase(0), 
-                    binIndex(0), isValid(false), timestamp(0) {}
-};
-
 // FFT processing structure
 struct FFTProcessor {
     uint16_t size;                    // Current FFT size
     uint32_t sampleRate;              // Sampling rate in Hz
-    WindowType windowType;            // Window function type
-    float* inputBuffer;               // Time domain input
-    float* windowBuffer;              // Window function coefficients
+    WindowShape windowType;           // Window function type
+    float* windowBuffer;              // Window coefficients prescaled to volts per ADC count
+    WindowCorrection windowCorrection; // Coherent gain / ENBW of the active window
     std::complex<float>* fftBuffer;   // Complex FFT buffer
-    float* magnitudeSpectrum;         // Magnitude spectrum (dB)
+    float* powerSpectrum;             // Power spectrum of the latest frame (|X|^2)
     float* phaseSpectrum;             // Phase spectrum (radians)
     float* smoothedSpectrum;          // Smoothed magnitude spectrum
     float binWidth;                   // Frequency resolution (Hz/bin)
+    float startFrequency;             // Frequency of bin 0 (Hz), nonzero when zoomed
+    bool inputPrimed;                 // rawInput holds a full previous frame
     bool isInitialized;               // Initialization status
     
     FFTProcessor() : size(FFT_SIZE_512), sampleRate(DEFAULT_SAMPLE_RATE),
-                    windowType(WINDOW_HAMMING), inputBuffer(nullptr),
-                    windowBuffer(nullptr), fftBuffer(nullptr),
-                    magnitudeSpectrum(nullptr), phaseSpectrum(nullptr),
-                    smoothedSpectrum(nullptr), binWidth(0), isInitialized(false) {}
+                    windowType(WINDOW_SHAPE_HAMMING), windowBuffer(nullptr),
+                    windowCorrection(), fftBuffer(nullptr),
+                    powerSpectrum(nullptr), phaseSpectrum(nullptr),
+                    smoothedSpectrum(nullptr), binWidth(0), startFrequency(0), inputPrimed(false),
+                    isInitialized(false) {}
 };
 
 // Waterfall display structure
@@ -115,41 +124,76 @@ struct WaterfallDisplay {
     uint16_t width;                   // Display width in pixels
     uint16_t height;                  // Display height in pixels
     uint16_t historyDepth;            // Number of time slices to store
-    uint16_t** historyBuffer;         // 2D buffer for waterfall data
-    uint16_t currentLine;             // Current line being written
+    WaterfallRing ring;               // History and on-screen ring
+    uint16_t* binStart;               // First FFT bin of each pixel (width + 1 entries)
     float intensityMin;               // Minimum intensity (dB)
     float intensityMax;               // Maximum intensity (dB)
+    float indexScale;                 // Palette indices per dB
     uint16_t* colorPalette;           // Color palette for intensity mapping
     uint8_t paletteSize;              // Number of colors in palette
+    WaterfallPalette palette;         // Active palette
+    WaterfallPooling pooling;         // Bin combining mode
+    bool binMapValid;                 // binStart matches the key below
+    float mapZoom;                    // Zoom level binStart was built for
+    float mapPanHz;                   // Pan offset binStart was built for
+    uint16_t mapBins;                 // Spectrum size binStart was built for
     bool scrollEnabled;               // Enable scrolling display
     float timePerLine;                // Time resolution per line (seconds)
+    bool regionActive;                // Waterfall region is on screen
     
     WaterfallDisplay() : width(320), height(120), historyDepth(120),
-                        historyBuffer(nullptr), currentLine(0),
-                        intensityMin(-100), intensityMax(-20),
-                        colorPalette(nullptr), paletteSize(64),
-                        scrollEnabled(true), timePerLine(0.1) {}
+                        binStart(nullptr), intensityMin(-100), intensityMax(-20),
+                        indexScale(0), colorPalette(nullptr), paletteSize(64),
+                        palette(PALETTE_THERMAL), pooling(POOL_MAX), binMapValid(false),
+                        mapZoom(0), mapPanHz(0), mapBins(0),
+                        scrollEnabled(true), timePerLine(0.1),
+                        regionActive(false) {}
+};
+
+// Sends waterfall rows to the waterfall screen area
+class WaterfallAreaSink : public WaterfallRowSink {
+public:
+    void pushRow(uint16_t row, const uint16_t* pixels, uint16_t width) override;
 };
 
 // Signal recording structure
 struct SignalRecording {
     String filename;                  // Recording filename
     bool isRecording;                 // Recording status
-    bool saveTimeData;                // Save time domain data
-    bool saveFreqData;                // Save frequency domain data
+    bool saveTimeData;                // Save raw ADC blocks
+    bool saveFreqData;                // Save quantized spectrum frames
     uint32_t maxDuration;             // Maximum recording duration (ms)
     uint32_t recordedSamples;         // Number of samples recorded
-    float* timeBuffer;                // Time domain buffer
-    float* freqBuffer;                // Frequency domain buffer
+    uint32_t recordedFrames;          // Number of spectrum frames recorded
     unsigned long startTime;          // Recording start timestamp
-    unsigned long lastSaveTime;       // Last file save timestamp
-    File dataFile;                    // SD card file handle
-    String metadata;                  // Recording metadata (JSON)
+    unsigned long writeTime;          // Time spent in the writer (us)
+    SdFileStream stream;         // SD card file
+    RecordingWriter writer;           // Chunked binary container
+    String metadata;                  // Recording metadata (JSON sidecar)
     
     SignalRecording() : isRecording(false), saveTimeData(true),
                        saveFreqData(true), maxDuration(60000),
-                       recordedSamples(0), timeBuffer(nullptr),
-                       freqBuffer(nullptr), startTime(0), lastSaveTime(0) {}
+                       recordedSamples(0), recordedFrames(0),
+                       startTime(0), writeTime(0) {}
+};
+
+// Recording playback structure
+struct SignalPlayback {
+    String filename;                  // File being played
+    bool isPlaying;                   // Playback replaces the ADC
+    bool loop;                        // Restart at the end instead of stopping
+    bool timeData;                    // Feeding samples (else spectrum frames)
+    bool finished;                    // Reached the end; stopped after this update
+    uint32_t savedSampleRate;         // Live sample rate to restore
+    uint64_t samplesPlayed;           // Samples fed to the pipeline
+    uint32_t frameTimestamp;          // Recording time of the last spectrum frame
+    unsigned long startTime;          // Playback start timestamp
+    SdFileStream stream;         // SD card file
+    RecordingReader reader;           // Container reader
+    
+    SignalPlayback() : isPlaying(false), loop(false), timeData(true), finished(false),
+                      savedSampleRate(DEFAULT_SAMPLE_RATE), samplesPlayed(0),
+                      frameTimestamp(0), startTime(0) {}
 };
 
 // Signal generator structure
@@ -175,25 +219,24 @@ struct SignalGenerator {
     ModulationType modulation;        // Modulation type
     float frequency;                  // Base frequency (Hz)
     float amplitude;                  // Output amplitude (0.0-1.0)
-    float phase;                      // Current phase (radians)
-    float phaseIncrement;             // Phase increment per sample
+    float dutyCycle;                  // Square wave duty cycle (0.0-1.0)
     float modFrequency;               // Modulation frequency (Hz)
     float modDepth;                   // Modulation depth (0.0-1.0)
     float sweepStartFreq;             // Sweep start frequency
     float sweepEndFreq;               // Sweep end frequency
     float sweepDuration;              // Sweep duration (seconds)
+    bool logSweep;                    // Logarithmic instead of linear sweep
     bool isEnabled;                   // Generator enable flag
-    bool useDac;                      // Use DAC vs PWM output
-    uint8_t dacPin;                   // DAC output pin
+    bool useDac;                      // Drive the built-in DAC (GPIO25) over I2S
     uint32_t sampleRate;              // Generation sample rate
     float* customWaveform;            // Custom waveform buffer
     uint16_t customWaveformSize;      // Custom waveform length
     
     SignalGenerator() : waveform(WAVE_SINE), modulation(MOD_NONE),
-                       frequency(1000), amplitude(0.5), phase(0),
-                       phaseIncrement(0), modFrequency(10), modDepth(0.1),
+                       frequency(1000), amplitude(0.5), dutyCycle(0.5),
+                       modFrequency(10), modDepth(0.1),
                        sweepStartFreq(100), sweepEndFreq(2000), sweepDuration(1.0),
-                       isEnabled(false), useDac(true), dacPin(DAC_OUT_LEFT),
+                       logSweep(false), isEnabled(false), useDac(true),
                        sampleRate(DEFAULT_SAMPLE_RATE), customWaveform(nullptr),
                        customWaveformSize(0) {}
 };
@@ -205,35 +248,49 @@ struct FrequencyMarker {
     uint16_t color;                   // Marker display color
     bool isEnabled;                   // Marker visibility
     bool isDragging;                  // User is dragging marker
+    int8_t detector;                  // Tone monitor slot it follows (-1 = none)
     String label;                     // Marker label text
     
     FrequencyMarker() : frequency(1000), magnitude(-60), color(COLOR_YELLOW),
-                       isEnabled(false), isDragging(false), label("") {}
+                       isEnabled(false), isDragging(false), detector(-1), label("") {}
 };
 
 // Configuration structure
 struct FreqScannerConfig {
     uint16_t fftSize;                 // FFT size
     uint32_t sampleRate;              // Sampling rate
-    WindowType windowType;            // Window function
+    WindowShape windowType;           // Window function
+    float kaiserBeta;                 // Kaiser shape (tabulated at KAISER_DEFAULT_BETA)
     FrequencyRange freqRange;         // Frequency range preset
     float customFreqMin;              // Custom range minimum (Hz)
     float customFreqMax;              // Custom range maximum (Hz)
-    float smoothingFactor;            // Spectrum smoothing (0.0-1.0)
+    float smoothingFactor;            // EMA weight of the newest frame (0.0-1.0)
     float peakThreshold;              // Peak detection threshold (dB)
     uint8_t maxPeaks;                 // Maximum peaks to detect
     bool enablePeakDetection;         // Enable automatic peak detection
-    bool enableAveraging;             // Enable spectrum averaging
-    uint8_t averagingCount;           // Number of spectra to average
+    SpectrumMode spectrumMode;        // Frame combining mode
+    uint8_t averagingCount;           // Frames per block average
+    uint8_t frameOverlap;             // Overlap between frames (percent, 0-75)
+    float peakDecayDb;                // Peak decay rate (dB per frame)
+    bool zoomEnabled;                 // Narrowband zoom-FFT analysis
+    float zoomCenterHz;               // Zoom centre frequency
+    uint8_t zoomDecimation;           // Zoom decimation factor (2-64)
+    bool monitorEnabled;              // Goertzel bank instead of the FFT
+    uint16_t monitorBlockSize;        // Samples per tone decision
+    bool logToneEvents;               // Append tone on/off events to SD
     ViewMode defaultView;             // Default view mode
     bool autoRecord;                  // Auto-record interesting signals
     String dataDirectory;             // Data storage directory
     
     FreqScannerConfig() : fftSize(FFT_SIZE_512), sampleRate(DEFAULT_SAMPLE_RATE),
-                         windowType(WINDOW_HAMMING), freqRange(RANGE_AUDIO_FULL),
+                         windowType(WINDOW_SHAPE_HAMMING), kaiserBeta(KAISER_DEFAULT_BETA),
+                         freqRange(RANGE_AUDIO_FULL),
                          customFreqMin(20), customFreqMax(20000), smoothingFactor(0.7),
                          peakThreshold(-40), maxPeaks(10), enablePeakDetection(true),
-                         enableAveraging(true), averagingCount(4), defaultView(VIEW_SPECTRUM),
+                         spectrumMode(SPECTRUM_EMA), averagingCount(4), frameOverlap(50),
+                         peakDecayDb(0.5), zoomEnabled(false), zoomCenterHz(1000),
+                         zoomDecimation(8), monitorEnabled(false), monitorBlockSize(256),
+                         logToneEvents(true), defaultView(VIEW_SPECTRUM),
                          autoRecord(false), dataDirectory("/data/freqscanner") {}
 };
 
@@ -245,11 +302,20 @@ struct FreqScannerStats {
     uint32_t recordingsSaved;         // Number of recordings saved
     float averageNoiseFloor;          // Average noise floor (dB)
     float peakSignalLevel;            // Highest signal detected (dB)
+    uint32_t waterfallLinesDrawn;     // Waterfall lines sent to the display
+    uint32_t waterfallBytesPushed;    // SPI bytes spent on the waterfall
+    uint32_t accumulatorTime;         // Time spent combining frames (us)
+    uint32_t generatorBlocks;         // DDS blocks written to the DAC
+    uint32_t monitorBlocks;           // Tone monitor blocks evaluated
+    uint32_t toneEvents;              // Tone on/off events seen
     unsigned long lastResetTime;      // Last statistics reset
     
     FreqScannerStats() : totalProcessingTime(0), fftProcessedCount(0),
                         peaksDetected(0), recordingsSaved(0), averageNoiseFloor(-80),
-                        peakSignalLevel(-120), lastResetTime(millis()) {}
+                        peakSignalLevel(-120), waterfallLinesDrawn(0),
+                        waterfallBytesPushed(0), accumulatorTime(0),
+                        generatorBlocks(0), monitorBlocks(0), toneEvents(0),
+                        lastResetTime(millis()) {}
 };
 
 // UI state structure
@@ -257,7 +323,7 @@ struct UIState {
     ViewMode currentView;             // Current display view
     TouchPoint lastTouch;             // Last touch coordinates
     unsigned long lastTouchTime;      // Last touch timestamp
-    int selectedPeak;                 // Selected peak index (-1 = none)
+    uint16_t selectedTrack;           // Selected peak track id (0 = none)
     bool showGrid;                    // Display frequency/amplitude grid
     bool showMarkers;                 // Display frequency markers
     bool showPeakLabels;              // Display peak frequency labels
@@ -266,7 +332,7 @@ struct UIState {
     uint16_t cursorX, cursorY;        // Measurement cursor position
     bool measurementMode;             // Measurement cursor active
     
-    UIState() : currentView(VIEW_SPECTRUM), lastTouchTime(0), selectedPeak(-1),
+    UIState() : currentView(VIEW_SPECTRUM), lastTouchTime(0), selectedTrack(0),
                showGrid(true), showMarkers(true), showPeakLabels(true),
                zoomLevel(1.0), panOffsetHz(0), cursorX(0), cursorY(0),
                measurementMode(false) {}
@@ -278,14 +344,28 @@ private:
     FFTProcessor fftProcessor;
     WaterfallDisplay waterfallDisplay;
     SignalRecording signalRecording;
+    SignalPlayback signalPlayback;
     SignalGenerator signalGenerator;
     
+    // Generator output: the DAC output task renders DDS blocks into the
+    // I2S DMA buffers. dds is only touched by the task while it runs;
+    // settings reach it through pendingParams at block boundaries.
+    DDSGenerator dds;
+    DacOutput dacOutput;
+    portMUX_TYPE generatorMux;
+    DDSParams pendingParams;
+    volatile bool paramsPending;
+    float* generatorRender;           // One block of float samples
+    
     // Detection and analysis
-    std::vector<SpectralPeak> detectedPeaks;
+    PeakTracker peakTracker;          // Top-K peaks and their tracks
+    ZoomFFT zoomFFT;                  // Mixer/decimator for zoom mode
+    ToneMonitor toneMonitor;          // Goertzel bank for monitor mode
+    int16_t* rawInput;                // Raw ADC block for zoom and monitor modes
     FrequencyMarker markers[2];       // Two frequency markers
-    float noiseFloor;                 // Current noise floor estimate
-    float* averagingBuffer;           // Spectrum averaging buffer
-    uint8_t averagingCount;           // Current averaging count
+    float noiseFloor;                 // Current noise floor estimate (dB per bin)
+    float noiseDensity;               // Same floor per Hz, independent of window and size
+    SpectrumAccumulator accumulator;  // Power-domain averaging and holds
     
     // Configuration and statistics
     FreqScannerConfig config;
@@ -296,6 +376,7 @@ private:
     unsigned long lastFFTTime;        // Last FFT processing time
     unsigned long lastDisplayUpdate;  // Last display update time
     unsigned long adcSampleTimer;     // ADC sampling timer
+    unsigned long monitorLastMicros;  // End of the previous monitor block (0 = none)
     bool isProcessing;                // FFT processing active
     bool needsRedraw;                 // Display needs update
     
@@ -318,25 +399,26 @@ private:
     void shutdownFFT();
     bool processFFT();
     void sampleADC();
+    uint16_t acquireSamples(int16_t* samples, uint16_t count);
+    bool acquireZoomFrame();
+    void applyFrequencyScale();
     void applyWindow();
     void computeFFT();
-    void computeMagnitudeSpectrum();
+    void computePowerSpectrum();
     void computePhaseSpectrum();
-    void smoothSpectrum();
+    bool smoothSpectrum();
     void estimateNoiseFloor();
     
+    // ===== TONE MONITOR METHODS =====
+    bool processMonitor();
+    void logToneEvent(const ToneEvent& event);
+    void syncMonitorMarkers();
+    
     // ===== WINDOW FUNCTION METHODS =====
-    void generateWindow(WindowType type);
-    float hammingWindow(int n, int N);
-    float blackmanWindow(int n, int N);
-    float hanningWindow(int n, int N);
-    float kaiserWindow(int n, int N, float beta);
+    void generateWindow(WindowShape shape);
     
     // ===== PEAK DETECTION METHODS =====
     void detectPeaks();
-    bool isPeak(uint16_t binIndex);
-    float interpolatePeakFrequency(uint16_t binIndex);
-    void sortPeaksByMagnitude();
     void updatePeakHistory();
     
     // ===== WATERFALL DISPLAY METHODS =====
@@ -344,31 +426,31 @@ private:
     void shutdownWaterfall();
     void updateWaterfall();
     void generateColorPalette();
-    uint16_t intensityToColor(float intensity);
-    void scrollWaterfallHistory();
+    void rebuildBinMap();
+    uint8_t intensityToIndex(float intensity);
+    void configureWaterfallRegion();
+    void releaseWaterfallRegion();
     
     // ===== SIGNAL RECORDING METHODS =====
     bool startRecording(const String& filename);
     void stopRecording();
     void recordCurrentSpectrum();
-    void recordTimeDomainData();
+    void recordTimeDomainData(const int16_t* samples, uint16_t count);
     void recordFrequencyDomainData();
     void saveRecordingMetadata();
     String generateRecordingFilename();
+    bool playbackDue();
+    bool playbackSpectrumFrame();
     
     // ===== SIGNAL GENERATION METHODS =====
     bool initializeGenerator();
     void shutdownGenerator();
     void updateGenerator();
-    float generateSample();
-    float generateSineWave();
-    float generateSquareWave();
-    float generateTriangleWave();
-    float generateSawtoothWave();
-    float generateNoise();
-    float generateSweep();
-    void applyModulation(float& sample);
-    void outputToDAC(float sample);
+    DDSParams buildGeneratorParams();
+    bool startGeneratorOutput();
+    void stopGeneratorOutput();
+    void renderGenerator(uint16_t* out, uint16_t count);
+    static void renderGeneratorBlock(void* context, uint16_t* out, uint16_t count);
     
     // ===== DISPLAY RENDERING METHODS =====
     void renderSpectrum();
@@ -384,10 +466,10 @@ private:
     void renderMarkers();
     void renderStatusBar();
     void renderMeasurementCursor();
+    void renderMonitor();
     
     // ===== UI HELPER METHODS =====
     void drawSpectrumLine(uint16_t x, float magnitude);
-    void drawWaterfallLine(uint16_t y, const float* spectrum);
     void drawPeakMarker(const SpectralPeak& peak);
     void drawFrequencyMarker(const FrequencyMarker& marker);
     void drawFrequencyLabel(float frequency, uint16_t x, uint16_t y);
@@ -427,8 +509,8 @@ private:
     void updateStatistics();
     void resetStatistics();
     bool validateFrequencyRange(float min, float max);
-    uint16_t getFrequencyRangeMin();
-    uint16_t getFrequencyRangeMax();
+    uint32_t getFrequencyRangeMin();
+    uint32_t getFrequencyRangeMax();
 
 public:
     FreqScanner();
@@ -448,18 +530,35 @@ public:
     void onResume() override;
     bool saveState() override;
     bool loadState() override;
-    bool handleMessage(AppMessage message, void* data = nullptr) override;
+    bool handleMessage(AppMessage message) override;
     
     // ===== PUBLIC INTERFACE =====
     void toggleRecording();
+    bool startPlayback(const String& filename);
+    void stopPlayback();
+    bool isPlayingBack() const { return signalPlayback.isPlaying; }
     void toggleGenerator();
     void setFrequencyRange(FrequencyRange range);
     void setFFTSize(uint16_t size);
     void setSampleRate(uint32_t rate);
-    void setWindowType(WindowType type);
+    void setWindowType(WindowShape shape);
+    void setKaiserBeta(float beta);
+    void setSpectrumMode(SpectrumMode mode);
+    bool setZoomFFT(float centerHz, uint8_t decimation);
+    void disableZoomFFT();
+    void resetSpectrumHold();
+    bool setMonitorMode(bool enabled);
+    int8_t addToneDetector(float frequency, float onDb = TONE_DEFAULT_ON_DB,
+                           float hysteresisDb = TONE_DEFAULT_HYST_DB);
+    void removeToneDetector(uint8_t index);
+    bool bindMarkerToDetector(uint8_t marker, int8_t detector);
+    const ToneMonitor& getToneMonitor() const { return toneMonitor; }
+    void setWaterfallPalette(WaterfallPalette palette);
+    void setWaterfallPooling(WaterfallPooling pooling);
     void addFrequencyMarker(float frequency);
     void removeFrequencyMarker(uint8_t index);
     SpectralPeak* getPeakAt(float frequency);
+    const PeakTracker& getPeakTracker() const { return peakTracker; }
     float getMagnitudeAt(float frequency);
     
     // ===== SETTINGS INTERFACE =====
@@ -484,11 +583,20 @@ public:
 #define MARKER_WIDTH            2
 #define PEAK_MARKER_SIZE        8
 
+// Generator output task
+#define GENERATOR_DMA_BUFFERS   2       // Double buffered: render one while the other plays
+#define GENERATOR_TASK_STACK    4096
+#define GENERATOR_TASK_PRIORITY 5
+#define GENERATOR_TASK_CORE     0       // Keep audio off the UI core
+#define GENERATOR_STOP_TIMEOUT  100     // ms to wait for the task to exit
+
 // File paths
 #define FREQ_SCANNER_DATA_DIR   "/data/freqscanner"
 #define FREQ_SCANNER_CONFIG     "/settings/freqscanner.cfg"
 #define RECORDINGS_DIR          "/data/freqscanner/recordings"
-#define SAMPLES_DIR             "/data/freqscanner/samples"
+#define RECORDING_EXTENSION     ".fsr"
+#define FREQ_SCANNER_SAMPLES_DIR "/data/freqscanner/samples"
+#define TONE_LOG_FILE           "/data/freqscanner/tones.csv"
 
 // Icon data (16x16 pixels, 1-bit per pixel)
 extern const uint8_t freq_scanner_icon[32];
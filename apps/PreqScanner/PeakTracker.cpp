@@ -0,0 +1,194 @@
+#include "PeakTracker.h"
+#include <math.h>
+
+PeakTracker::PeakTracker() :
+    heapSize(0),
+    peakCount(0),
+    nextTrackId(1),
+    tracksStarted(0)
+{
+    reset();
+}
+
+void PeakTracker::reset() {
+    heapSize = 0;
+    peakCount = 0;
+    for (uint8_t i = 0; i < PEAK_MAX_TRACKS; i++) {
+        tracks[i].active = false;
+        tracks[i].id = 0;
+    }
+}
+
+void PeakTracker::heapSiftDown(uint8_t index) {
+    while (true) {
+        uint8_t smallest = index;
+        uint8_t left = 2 * index + 1;
+        uint8_t right = left + 1;
+        if (left < heapSize && heap[left].magnitude < heap[smallest].magnitude) smallest = left;
+        if (right < heapSize && heap[right].magnitude < heap[smallest].magnitude) smallest = right;
+        if (smallest == index) return;
+
+        Candidate tmp = heap[index];
+        heap[index] = heap[smallest];
+        heap[smallest] = tmp;
+        index = smallest;
+    }
+}
+
+void PeakTracker::heapOffer(float magnitude, uint16_t bin, uint8_t capacity) {
+    if (heapSize < capacity) {
+        // Sift up
+        uint8_t i = heapSize++;
+        while (i > 0) {
+            uint8_t parent = (i - 1) / 2;
+            if (heap[parent].magnitude <= magnitude) break;
+            heap[i] = heap[parent];
+            i = parent;
+        }
+        heap[i].magnitude = magnitude;
+        heap[i].bin = bin;
+    } else if (magnitude > heap[0].magnitude) {
+        // Replace the weakest kept peak
+        heap[0].magnitude = magnitude;
+        heap[0].bin = bin;
+        heapSiftDown(0);
+    }
+}
+
+float PeakTracker::interpolate(float left, float centre, float right, float& level) {
+    float denom = left - 2.0f * centre + right;
+    float offset = 0.0f;
+    if (denom < 0.0f) {
+        offset = 0.5f * (left - right) / denom;
+        if (offset > 0.5f) offset = 0.5f;
+        if (offset < -0.5f) offset = -0.5f;
+    }
+    level = centre - 0.25f * (left - right) * offset;
+    return offset;
+}
+
+uint8_t PeakTracker::process(const float* spectrumDb, const float* phase, uint16_t bins,
+                             float startHz, float binWidth, float floorDb, uint8_t maxPeaks,
+                             uint32_t now) {
+    heapSize = 0;
+    peakCount = 0;
+    if (maxPeaks > PEAK_MAX_PEAKS) maxPeaks = PEAK_MAX_PEAKS;
+
+    // Single pass: the floor test rejects most bins before the neighbour checks.
+    // Ties count for the right-hand bin, so a tone midway between two bins
+    // (equal levels) is still found once.
+    if (spectrumDb && maxPeaks > 0 && bins > 2 * PEAK_NEIGHBOR_BINS) {
+        for (uint16_t i = PEAK_NEIGHBOR_BINS; i < bins - PEAK_NEIGHBOR_BINS; i++) {
+            float v = spectrumDb[i];
+            if (!(v > floorDb)) continue; // Also rejects NaN
+            if (v < spectrumDb[i - 1] || v <= spectrumDb[i + 1] ||
+                v < spectrumDb[i - 2] || v <= spectrumDb[i + 2]) continue;
+            heapOffer(v, i, maxPeaks);
+        }
+    }
+
+    // Drain the heap weakest first, filling the output from the back
+    peakCount = heapSize;
+    for (int8_t slot = peakCount - 1; slot >= 0; slot--) {
+        Candidate c = heap[0];
+        heap[0] = heap[--heapSize];
+        heapSiftDown(0);
+
+        float level;
+        float offset = interpolate(spectrumDb[c.bin - 1], spectrumDb[c.bin], spectrumDb[c.bin + 1], level);
+
+        SpectralPeak& peak = peaks[slot];
+        peak.binIndex = c.bin;
+        peak.frequency = startHz + (c.bin + offset) * binWidth;
+        peak.magnitude = level;
+        peak.phase = phase ? phase[c.bin] : 0.0f;
+        peak.trackId = 0;
+        peak.isValid = true;
+        peak.timestamp = now;
+    }
+
+    associate(binWidth, now);
+    return peakCount;
+}
+
+void PeakTracker::associate(float binWidth, uint32_t now) {
+    float gate = PEAK_TRACK_GATE_BINS * binWidth;
+    bool matched[PEAK_MAX_TRACKS] = {false};
+
+    // Strongest peaks claim their nearest track first
+    for (uint8_t p = 0; p < peakCount; p++) {
+        SpectralPeak& peak = peaks[p];
+
+        int8_t best = -1;
+        float bestDistance = gate;
+        for (uint8_t t = 0; t < PEAK_MAX_TRACKS; t++) {
+            if (!tracks[t].active || matched[t]) continue;
+            float distance = fabsf(tracks[t].frequency - peak.frequency);
+            if (distance <= bestDistance) {
+                bestDistance = distance;
+                best = t;
+            }
+        }
+
+        if (best < 0) {
+            // Start a track in a free slot, or take over the weakest stale one
+            for (uint8_t t = 0; t < PEAK_MAX_TRACKS; t++) {
+                if (!tracks[t].active) {
+                    best = t;
+                    break;
+                }
+            }
+            if (best < 0) {
+                for (uint8_t t = 0; t < PEAK_MAX_TRACKS; t++) {
+                    if (matched[t] || tracks[t].misses == 0) continue;
+                    if (best < 0 || tracks[t].magnitude < tracks[best].magnitude) best = t;
+                }
+            }
+            if (best < 0) continue; // Every track is live this frame
+
+            PeakTrack& track = tracks[best];
+            track.id = nextTrackId++;
+            if (nextTrackId == 0) nextTrackId = 1;
+            track.startFrequency = peak.frequency;
+            track.maxMagnitude = peak.magnitude;
+            track.firstSeen = now;
+            track.hits = 0;
+            track.active = true;
+            tracksStarted++;
+        }
+
+        PeakTrack& track = tracks[best];
+        track.frequency = peak.frequency;
+        track.magnitude = peak.magnitude;
+        if (peak.magnitude > track.maxMagnitude) track.maxMagnitude = peak.magnitude;
+        track.lastSeen = now;
+        if (track.hits < 0xFFFF) track.hits++;
+        track.misses = 0;
+        matched[best] = true;
+        peak.trackId = track.id;
+    }
+
+    // Age out tracks that were not seen this frame
+    for (uint8_t t = 0; t < PEAK_MAX_TRACKS; t++) {
+        if (!tracks[t].active || matched[t]) continue;
+        if (++tracks[t].misses > PEAK_TRACK_MAX_MISSES) {
+            tracks[t].active = false;
+        }
+    }
+}
+
+const PeakTrack* PeakTracker::findTrack(uint16_t id) const {
+    if (id == 0) return nullptr;
+    for (uint8_t t = 0; t < PEAK_MAX_TRACKS; t++) {
+        if (tracks[t].active && tracks[t].id == id) return &tracks[t];
+    }
+    return nullptr;
+}
+
+uint8_t PeakTracker::getActiveTrackCount() const {
+    uint8_t count = 0;
+    for (uint8_t t = 0; t < PEAK_MAX_TRACKS; t++) {
+        if (tracks[t].active) count++;
+    }
+    return count;
+}
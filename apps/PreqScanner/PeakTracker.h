@@ -0,0 +1,97 @@
+#ifndef PEAK_TRACKER_H
+#define PEAK_TRACKER_H
+
+#include <stdint.h>
+
+// ========================================
+// PeakTracker - Allocation-free spectral peak detection and tracking
+// One pass over the spectrum keeps the K strongest local maxima in a
+// min-heap; survivors are interpolated and associated with tracks that
+// persist across frames. Hardware independent.
+// ========================================
+
+#define PEAK_MAX_PEAKS         16     // Upper bound on peaks per frame (K)
+#define PEAK_MAX_TRACKS        16     // Concurrent tracks
+#define PEAK_TRACK_GATE_BINS   3.0f   // Max frame-to-frame movement in bins
+#define PEAK_TRACK_MAX_MISSES  3      // Frames a track may go unmatched
+#define PEAK_NEIGHBOR_BINS     2      // Bins each side a peak must exceed
+
+// Peak detection structure
+struct SpectralPeak {
+    float frequency;      // Peak frequency in Hz
+    float magnitude;      // Peak magnitude in dB
+    float phase;          // Peak phase in radians
+    uint16_t binIndex;    // FFT bin index
+    uint16_t trackId;     // Track this peak was assigned to (0 = none)
+    bool isValid;         // Peak validity flag
+    unsigned long timestamp; // When peak was detected
+    
+    SpectralPeak() : frequency(0), magnitude(-120), phase(0), 
+                    binIndex(0), trackId(0), isValid(false), timestamp(0) {}
+};
+
+// A peak followed across frames
+struct PeakTrack {
+    uint16_t id;                  // Unique while the tracker runs (never 0)
+    float frequency;              // Latest frequency (Hz)
+    float magnitude;              // Latest level (dB)
+    float startFrequency;         // Frequency when first seen (Hz)
+    float maxMagnitude;           // Strongest level seen (dB)
+    uint32_t firstSeen;           // Timestamp of first detection (ms)
+    uint32_t lastSeen;            // Timestamp of latest detection (ms)
+    uint16_t hits;                // Frames with a matching peak
+    uint8_t misses;               // Consecutive frames without a match
+    bool active;
+
+    uint32_t duration() const { return lastSeen - firstSeen; }
+    float drift() const { return frequency - startFrequency; }
+};
+
+class PeakTracker {
+private:
+    struct Candidate {
+        float magnitude;
+        uint16_t bin;
+    };
+
+    Candidate heap[PEAK_MAX_PEAKS];   // Min-heap on magnitude
+    uint8_t heapSize;
+
+    SpectralPeak peaks[PEAK_MAX_PEAKS];   // Current frame, strongest first
+    uint8_t peakCount;
+
+    PeakTrack tracks[PEAK_MAX_TRACKS];
+    uint16_t nextTrackId;
+    uint32_t tracksStarted;
+
+    void heapOffer(float magnitude, uint16_t bin, uint8_t capacity);
+    void heapSiftDown(uint8_t index);
+    void associate(float binWidth, uint32_t now);
+
+public:
+    PeakTracker();
+
+    void reset();
+
+    // Finds up to maxPeaks local maxima above floorDb in a dB spectrum whose
+    // bin 0 is at startHz, interpolates them and updates the tracks.
+    // phase may be null.
+    uint8_t process(const float* spectrumDb, const float* phase, uint16_t bins,
+                    float startHz, float binWidth, float floorDb, uint8_t maxPeaks,
+                    uint32_t now);
+
+    const SpectralPeak* getPeaks() const { return peaks; }
+    uint8_t getPeakCount() const { return peakCount; }
+
+    // Track slots; check PeakTrack::active
+    const PeakTrack* getTracks() const { return tracks; }
+    const PeakTrack* findTrack(uint16_t id) const;
+    uint8_t getActiveTrackCount() const;
+    uint32_t getTracksStarted() const { return tracksStarted; }
+
+    // Parabolic fit through three log-power (dB) samples.
+    // Returns the offset from the centre bin in [-0.5, 0.5] and the peak level.
+    static float interpolate(float left, float centre, float right, float& level);
+};
+
+#endif // PEAK_TRACKER_H
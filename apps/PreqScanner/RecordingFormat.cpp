@@ -0,0 +1,411 @@
+#include "RecordingFormat.h"
+#include <string.h>
+#include <math.h>
+
+#define RECORDING_QUANTIZE_CHUNK  64    // Spectrum bins quantized per append
+
+// ===== WRITER =====
+
+RecordingWriter::RecordingWriter() :
+    stream(nullptr),
+    header(defaultHeader()),
+    buffer(nullptr),
+    fill(0),
+    bufferOffset(0),
+    index(nullptr),
+    indexCount(0),
+    indexInterval(RECORDING_INDEX_INTERVAL),
+    lastIndexed(0),
+    sequence(0),
+    bytesFlushed(0),
+    flushCount(0),
+    active(false),
+    failed(false)
+{
+}
+
+RecordingWriter::~RecordingWriter() {
+    release();
+}
+
+bool RecordingWriter::allocate() {
+    if (buffer && index) return true;
+
+    release();
+    buffer = new uint8_t[RECORDING_BUFFER_SIZE];
+    index = new RecordingIndexEntry[RECORDING_INDEX_CAPACITY];
+    if (!buffer || !index) {
+        release();
+        return false;
+    }
+    return true;
+}
+
+void RecordingWriter::release() {
+    if (buffer) {
+        delete[] buffer;
+        buffer = nullptr;
+    }
+    if (index) {
+        delete[] index;
+        index = nullptr;
+    }
+    active = false;
+    stream = nullptr;
+}
+
+RecordingHeader RecordingWriter::defaultHeader() {
+    RecordingHeader h;
+    memset(&h, 0, sizeof(h));
+    h.magic = RECORDING_MAGIC;
+    h.version = RECORDING_VERSION;
+    h.headerSize = RECORDING_SECTOR;
+    h.dbMin = RECORDING_DB_MIN;
+    h.dbStep = RECORDING_DB_STEP;
+    return h;
+}
+
+bool RecordingWriter::begin(ByteStream* target, const RecordingHeader& settings) {
+    if (!target || !buffer || !index) return false;
+
+    stream = target;
+    header = settings;
+    header.magic = RECORDING_MAGIC;
+    header.version = RECORDING_VERSION;
+    header.headerSize = RECORDING_SECTOR;
+    header.durationMs = 0;
+    header.chunkCount = 0;
+    header.sampleCount = 0;
+    header.indexOffset = 0;
+    header.indexEntries = 0;
+    if (header.dbStep <= 0) {
+        header.dbMin = RECORDING_DB_MIN;
+        header.dbStep = RECORDING_DB_STEP;
+    }
+
+    fill = 0;
+    bufferOffset = 0;
+    indexCount = 0;
+    indexInterval = RECORDING_INDEX_INTERVAL;
+    lastIndexed = 0;
+    sequence = 0;
+    bytesFlushed = 0;
+    flushCount = 0;
+    failed = false;
+    active = true;
+
+    // Provisional header; it stays in the buffer until the first flush
+    append(&header, sizeof(header));
+    padToSector();
+    return true;
+}
+
+void RecordingWriter::append(const void* data, uint32_t length) {
+    const uint8_t* bytes = static_cast<const uint8_t*>(data);
+    while (length > 0) {
+        uint32_t space = RECORDING_BUFFER_SIZE - fill;
+        uint32_t n = length < space ? length : space;
+        if (bytes) {
+            memcpy(buffer + fill, bytes, n);
+            bytes += n;
+        } else {
+            memset(buffer + fill, 0, n);
+        }
+        fill += n;
+        length -= n;
+        if (fill == RECORDING_BUFFER_SIZE) flush();
+    }
+}
+
+void RecordingWriter::padToSector() {
+    uint32_t rem = (bufferOffset + fill) % RECORDING_SECTOR;
+    if (rem) append(nullptr, RECORDING_SECTOR - rem);
+}
+
+void RecordingWriter::flush() {
+    if (fill == 0) return;
+    if (!failed && stream->write(buffer, fill) != fill) {
+        failed = true;
+    }
+    bufferOffset += fill;
+    bytesFlushed += fill;
+    flushCount++;
+    fill = 0;
+}
+
+void RecordingWriter::addIndexEntry(uint32_t offset, uint32_t timestamp) {
+    if (indexCount == RECORDING_INDEX_CAPACITY) {
+        // Full: keep every other entry and halve the density from here on
+        for (uint16_t i = 0; i < RECORDING_INDEX_CAPACITY / 2; i++) {
+            index[i] = index[2 * i];
+        }
+        indexCount = RECORDING_INDEX_CAPACITY / 2;
+        indexInterval *= 2;
+    }
+    index[indexCount].offset = offset;
+    index[indexCount].timestamp = timestamp;
+    indexCount++;
+    lastIndexed = timestamp;
+}
+
+void RecordingWriter::beginChunk(uint32_t tag, uint32_t timestamp, uint32_t length) {
+    uint32_t offset = bufferOffset + fill;
+    if (indexCount == 0 || timestamp - lastIndexed >= indexInterval) {
+        addIndexEntry(offset, timestamp);
+    }
+
+    RecordingChunk chunk = {tag, length, timestamp, sequence++};
+    append(&chunk, sizeof(chunk));
+}
+
+void RecordingWriter::endChunk(uint32_t length) {
+    // Keep chunk headers 4-byte aligned so a zero word can only be padding
+    uint32_t pad = (4 - (length & 3)) & 3;
+    if (pad) append(nullptr, pad);
+
+    header.chunkCount++;
+}
+
+bool RecordingWriter::writeTime(const int16_t* samples, uint16_t count, uint32_t timestamp) {
+    if (!active || failed || !samples) return false;
+
+    uint32_t length = (uint32_t)count * sizeof(int16_t);
+    if (length == 0 || length > RECORDING_MAX_PAYLOAD) return false;
+
+    beginChunk(RECORDING_TAG_TIME, timestamp, length);
+    append(samples, length);
+    endChunk(length);
+
+    header.contents |= RECORDING_HAS_TIME;
+    header.sampleCount += count;
+    header.durationMs = timestamp;
+    return !failed;
+}
+
+bool RecordingWriter::writeSpectrum(const float* spectrumDb, uint16_t bins, uint32_t timestamp) {
+    if (!active || failed || !spectrumDb) return false;
+    if (bins == 0 || bins > RECORDING_MAX_PAYLOAD) return false;
+
+    beginChunk(RECORDING_TAG_SPECTRUM, timestamp, bins);
+
+    uint8_t levels[RECORDING_QUANTIZE_CHUNK];
+    for (uint16_t start = 0; start < bins; start += RECORDING_QUANTIZE_CHUNK) {
+        uint16_t n = bins - start;
+        if (n > RECORDING_QUANTIZE_CHUNK) n = RECORDING_QUANTIZE_CHUNK;
+        for (uint16_t i = 0; i < n; i++) {
+            levels[i] = quantizeDb(spectrumDb[start + i], header.dbMin, header.dbStep);
+        }
+        append(levels, n);
+    }
+    endChunk(bins);
+
+    header.contents |= RECORDING_HAS_SPECTRUM;
+    header.spectrumBins = bins;
+    header.durationMs = timestamp;
+    return !failed;
+}
+
+bool RecordingWriter::end() {
+    if (!active) return false;
+    active = false;
+
+    // Data ends on a sector boundary; the index starts a fresh sector
+    padToSector();
+    flush();
+
+    header.indexOffset = bufferOffset;
+    header.indexEntries = indexCount;
+    uint32_t length = (uint32_t)indexCount * sizeof(RecordingIndexEntry);
+    RecordingChunk chunk = {RECORDING_TAG_INDEX, length, header.durationMs, sequence};
+    append(&chunk, sizeof(chunk));
+    append(index, length);
+    padToSector();
+    flush();
+
+    // Final header over the provisional one
+    if (!failed && stream->seek(0)) {
+        memset(buffer, 0, RECORDING_SECTOR);
+        memcpy(buffer, &header, sizeof(header));
+        if (stream->write(buffer, RECORDING_SECTOR) != RECORDING_SECTOR) failed = true;
+    } else {
+        failed = true;
+    }
+
+    stream = nullptr;
+    return !failed;
+}
+
+uint8_t RecordingWriter::quantizeDb(float db, float dbMin, float dbStep) {
+    float level = (db - dbMin) / dbStep + 0.5f;
+    if (!(level > 0.0f)) return 0;      // Also catches NaN
+    if (level >= 255.0f) return 255;
+    return (uint8_t)level;
+}
+
+// ===== READER =====
+
+RecordingReader::RecordingReader() :
+    stream(nullptr),
+    header(RecordingWriter::defaultHeader()),
+    index(nullptr),
+    indexCount(0),
+    payload(nullptr),
+    payloadPos(0),
+    position(0),
+    dataEnd(0),
+    haveTime(false)
+{
+    memset(&chunk, 0, sizeof(chunk));
+}
+
+RecordingReader::~RecordingReader() {
+    close();
+}
+
+void RecordingReader::releaseBuffers() {
+    if (index) {
+        delete[] index;
+        index = nullptr;
+    }
+    if (payload) {
+        delete[] payload;
+        payload = nullptr;
+    }
+    indexCount = 0;
+}
+
+bool RecordingReader::open(ByteStream* source) {
+    close();
+    if (!source || !source->seek(0)) return false;
+
+    RecordingHeader h;
+    if (source->read(reinterpret_cast<uint8_t*>(&h), sizeof(h)) != sizeof(h)) return false;
+    if (h.magic != RECORDING_MAGIC || h.version != RECORDING_VERSION ||
+        h.headerSize < sizeof(h) || h.dbStep <= 0) {
+        return false;
+    }
+
+    payload = new uint8_t[RECORDING_MAX_PAYLOAD];
+    if (!payload) return false;
+
+    stream = source;
+    header = h;
+    uint32_t fileSize = source->size();
+    dataEnd = (h.indexOffset >= h.headerSize && h.indexOffset <= fileSize) ? h.indexOffset : fileSize;
+
+    // Index is optional: unclosed files are read sequentially
+    if (h.indexOffset != 0 && h.indexEntries > 0 && h.indexEntries <= RECORDING_INDEX_CAPACITY &&
+        source->seek(h.indexOffset)) {
+        RecordingChunk c;
+        uint32_t length = h.indexEntries * sizeof(RecordingIndexEntry);
+        index = new RecordingIndexEntry[h.indexEntries];
+        if (index &&
+            source->read(reinterpret_cast<uint8_t*>(&c), sizeof(c)) == sizeof(c) &&
+            c.tag == RECORDING_TAG_INDEX && c.length == length &&
+            source->read(reinterpret_cast<uint8_t*>(index), length) == length) {
+            indexCount = h.indexEntries;
+        } else if (index) {
+            delete[] index;
+            index = nullptr;
+        }
+    }
+
+    rewind();
+    return true;
+}
+
+void RecordingReader::close() {
+    releaseBuffers();
+    stream = nullptr;
+    haveTime = false;
+}
+
+void RecordingReader::rewind() {
+    position = header.headerSize;
+    payloadPos = 0;
+    haveTime = false;
+    memset(&chunk, 0, sizeof(chunk));
+}
+
+bool RecordingReader::nextChunk() {
+    if (!stream) return false;
+
+    while (position + sizeof(RecordingChunk) <= dataEnd) {
+        if (!stream->seek(position)) return false;
+
+        RecordingChunk c;
+        if (stream->read(reinterpret_cast<uint8_t*>(&c), sizeof(c)) != sizeof(c)) return false;
+
+        if (c.tag == 0) {
+            // Sector padding
+            position = (position / RECORDING_SECTOR + 1) * RECORDING_SECTOR;
+            continue;
+        }
+        if (c.length > RECORDING_MAX_PAYLOAD) return false;   // Corrupt
+
+        uint32_t padded = (c.length + 3) & ~3u;
+        if (stream->read(payload, c.length) != c.length) return false;
+
+        chunk = c;
+        position += sizeof(c) + padded;
+        return true;
+    }
+    return false;
+}
+
+uint16_t RecordingReader::readSamples(int16_t* out, uint16_t count) {
+    uint16_t done = 0;
+    while (done < count) {
+        if (!haveTime) {
+            if (!nextChunk()) break;
+            if (chunk.tag != RECORDING_TAG_TIME) continue;
+            haveTime = true;
+            payloadPos = 0;
+        }
+
+        uint32_t available = (chunk.length - payloadPos) / sizeof(int16_t);
+        uint32_t n = count - done;
+        if (n > available) n = available;
+        memcpy(out + done, payload + payloadPos, n * sizeof(int16_t));
+        done += n;
+        payloadPos += n * sizeof(int16_t);
+
+        if (payloadPos + sizeof(int16_t) > chunk.length) haveTime = false;
+    }
+    return done;
+}
+
+bool RecordingReader::readSpectrum(float* spectrumDb, uint16_t bins, uint32_t& timestamp) {
+    haveTime = false;
+    while (nextChunk()) {
+        if (chunk.tag != RECORDING_TAG_SPECTRUM) continue;
+
+        uint16_t n = chunk.length < bins ? chunk.length : bins;
+        for (uint16_t i = 0; i < n; i++) {
+            spectrumDb[i] = dequantizeDb(payload[i], header.dbMin, header.dbStep);
+        }
+        for (uint16_t i = n; i < bins; i++) {
+            spectrumDb[i] = header.dbMin;
+        }
+        timestamp = chunk.timestamp;
+        return true;
+    }
+    return false;
+}
+
+bool RecordingReader::seekTime(uint32_t timestamp) {
+    if (!stream) return false;
+
+    rewind();
+    if (indexCount == 0) return timestamp == 0;
+
+    // Last entry not after the target (entries are in file order)
+    uint16_t lo = 0, hi = indexCount;
+    while (hi - lo > 1) {
+        uint16_t mid = (lo + hi) / 2;
+        if (index[mid].timestamp <= timestamp) lo = mid;
+        else hi = mid;
+    }
+    position = index[lo].offset;
+    return true;
+}
@@ -0,0 +1,179 @@
+#ifndef RECORDING_FORMAT_H
+#define RECORDING_FORMAT_H
+
+#include <stdint.h>
+#include <stddef.h>
+#include "../../core/Streams/ByteStream.h"
+
+// ========================================
+// RecordingFormat - Chunked binary container for FreqScanner captures
+// Layout (little endian, 512-byte sectors):
+//   sector 0      RecordingHeader, zero padded
+//   data          chunks: RecordingChunk + payload (padded to 4 bytes)
+//                   TIME  int16 raw ADC counts (centred on mid-scale)
+//                   SPEC  uint8 quantized dB, one per bin
+//                 a zero tag means padding up to the next sector
+//   trailer       INDX chunk of RecordingIndexEntry, at header.indexOffset
+// The writer only hands whole buffers to the stream, so the card never
+// sees partial-sector writes; the header is rewritten on close. A file
+// that was not closed has indexOffset 0 and is still readable in order.
+// Hardware independent: I/O goes through ByteStream.
+// ========================================
+
+#define RECORDING_MAGIC          STREAM_FOURCC('F', 'S', 'R', 'C')
+#define RECORDING_VERSION        1
+#define RECORDING_TAG_TIME       STREAM_FOURCC('T', 'I', 'M', 'E')
+#define RECORDING_TAG_SPECTRUM   STREAM_FOURCC('S', 'P', 'E', 'C')
+#define RECORDING_TAG_INDEX      STREAM_FOURCC('I', 'N', 'D', 'X')
+
+#define RECORDING_SECTOR         512
+#define RECORDING_BUFFER_SIZE    4096    // Write buffer; a multiple of RECORDING_SECTOR
+#define RECORDING_MAX_PAYLOAD    4096    // Largest chunk payload (2048 samples)
+#define RECORDING_INDEX_CAPACITY 512     // Entries kept in RAM while writing
+#define RECORDING_INDEX_INTERVAL 250     // Initial ms between index entries
+
+// Spectrum quantization: 0.5 dB steps from the floor, 256 levels
+#define RECORDING_DB_MIN         -120.0f
+#define RECORDING_DB_STEP        0.5f
+
+// Contents flags
+#define RECORDING_HAS_TIME       0x01
+#define RECORDING_HAS_SPECTRUM   0x02
+
+struct RecordingHeader {
+    uint32_t magic;
+    uint16_t version;
+    uint16_t headerSize;          // Bytes reserved for the header (one sector)
+    uint32_t sampleRate;          // Hz
+    uint16_t fftSize;
+    uint8_t windowType;           // WindowShape
+    uint8_t contents;             // RECORDING_HAS_* flags
+    float binWidth;               // Hz per spectrum bin
+    float startFrequency;         // Frequency of spectrum bin 0 (Hz)
+    float freqMin;                // Display range when recorded (Hz)
+    float freqMax;
+    float voltsPerCount;          // Scale of TIME samples
+    float dbMin;                  // dB of quantized level 0
+    float dbStep;                 // dB per quantized level
+    uint16_t spectrumBins;
+    uint8_t zoomDecimation;       // 0 when not zoomed
+    uint8_t reserved;
+    uint32_t startMillis;         // Device clock when recording started
+    uint32_t durationMs;          // Timestamp of the last chunk
+    uint32_t chunkCount;          // Data chunks, excluding the index
+    uint32_t sampleCount;         // TIME samples in the file
+    uint32_t indexOffset;         // File offset of the INDX chunk (0 = not closed)
+    uint32_t indexEntries;
+};
+
+// Precedes every payload
+struct RecordingChunk {
+    uint32_t tag;
+    uint32_t length;              // Payload bytes before padding
+    uint32_t timestamp;           // ms since recording start
+    uint32_t sequence;            // Chunk number
+};
+
+struct RecordingIndexEntry {
+    uint32_t offset;              // File offset of a chunk header
+    uint32_t timestamp;           // Its timestamp
+};
+
+static_assert(sizeof(RecordingHeader) <= RECORDING_SECTOR, "Header must fit one sector");
+static_assert(sizeof(RecordingChunk) == 16, "Chunk header layout changed");
+static_assert(RECORDING_BUFFER_SIZE % RECORDING_SECTOR == 0, "Buffer must hold whole sectors");
+
+class RecordingWriter {
+private:
+    ByteStream* stream;
+    RecordingHeader header;
+    uint8_t* buffer;              // RECORDING_BUFFER_SIZE, allocated once
+    uint16_t fill;
+    uint32_t bufferOffset;        // File offset of buffer[0]
+    RecordingIndexEntry* index;   // RECORDING_INDEX_CAPACITY, allocated once
+    uint16_t indexCount;
+    uint32_t indexInterval;
+    uint32_t lastIndexed;
+    uint32_t sequence;
+    uint32_t bytesFlushed;
+    uint32_t flushCount;
+    bool active;
+    bool failed;
+
+    void beginChunk(uint32_t tag, uint32_t timestamp, uint32_t length);
+    void endChunk(uint32_t length);
+    void append(const void* data, uint32_t length);
+    void padToSector();
+    void flush();
+    void addIndexEntry(uint32_t offset, uint32_t timestamp);
+
+public:
+    RecordingWriter();
+    ~RecordingWriter();
+
+    // Buffers are allocated here, not per recording
+    bool allocate();
+    void release();
+
+    // Starts a file; header carries the capture settings
+    bool begin(ByteStream* target, const RecordingHeader& settings);
+    bool writeTime(const int16_t* samples, uint16_t count, uint32_t timestamp);
+    bool writeSpectrum(const float* spectrumDb, uint16_t bins, uint32_t timestamp);
+    // Flushes, appends the index and rewrites the header
+    bool end();
+
+    bool isActive() const { return active; }
+    bool hasFailed() const { return failed; }
+    uint32_t getBytesWritten() const { return bytesFlushed; }
+    uint32_t getFlushCount() const { return flushCount; }
+    const RecordingHeader& getHeader() const { return header; }
+
+    static uint8_t quantizeDb(float db, float dbMin, float dbStep);
+    // Header with format fields filled in and capture fields zeroed
+    static RecordingHeader defaultHeader();
+};
+
+class RecordingReader {
+private:
+    ByteStream* stream;
+    RecordingHeader header;
+    RecordingIndexEntry* index;
+    uint16_t indexCount;
+    uint8_t* payload;             // RECORDING_MAX_PAYLOAD
+    RecordingChunk chunk;         // Chunk currently in payload
+    uint32_t payloadPos;          // Consumed bytes of a TIME payload
+    uint32_t position;            // Next chunk header offset
+    uint32_t dataEnd;
+    bool haveTime;                // payload holds an unfinished TIME chunk
+
+    bool nextChunk();
+    void releaseBuffers();
+
+public:
+    RecordingReader();
+    ~RecordingReader();
+
+    // Validates the header and loads the index if the file was closed
+    bool open(ByteStream* source);
+    void close();
+    void rewind();
+
+    // Next raw samples across TIME chunks (SPEC chunks are skipped).
+    // Returns fewer than count at the end of the file.
+    uint16_t readSamples(int16_t* out, uint16_t count);
+    // Next SPEC chunk as dB; TIME chunks are skipped
+    bool readSpectrum(float* spectrumDb, uint16_t bins, uint32_t& timestamp);
+    // Positions at the last indexed chunk at or before timestamp
+    bool seekTime(uint32_t timestamp);
+
+    bool isOpen() const { return stream != nullptr; }
+    bool hasIndex() const { return indexCount > 0; }
+    const RecordingHeader& getHeader() const { return header; }
+    uint32_t getChunkTimestamp() const { return chunk.timestamp; }
+
+    static float dequantizeDb(uint8_t level, float dbMin, float dbStep) {
+        return dbMin + level * dbStep;
+    }
+};
+
+#endif // RECORDING_FORMAT_H
@@ -0,0 +1,181 @@
+#include "SpectrumAccumulator.h"
+#include <math.h>
+#include <string.h>
+
+SpectrumAccumulator::SpectrumAccumulator() :
+    accum(nullptr),
+    output(nullptr),
+    bins(0),
+    mode(SPECTRUM_EMA),
+    emaAlpha(0.7f),
+    averageFrames(4),
+    frameCount(0),
+    decayFactor(1.0f),
+    dbOffset(0.0f),
+    primed(false)
+{
+    setPeakDecay(0.5f);
+}
+
+SpectrumAccumulator::~SpectrumAccumulator() {
+    release();
+}
+
+bool SpectrumAccumulator::allocate(uint16_t binCount) {
+    if (accum && bins == binCount) {
+        reset();
+        return true;
+    }
+
+    release();
+    accum = new float[binCount];
+    output = new float[binCount];
+    if (!accum || !output) {
+        release();
+        return false;
+    }
+
+    bins = binCount;
+    reset();
+    return true;
+}
+
+void SpectrumAccumulator::release() {
+    if (accum) {
+        delete[] accum;
+        accum = nullptr;
+    }
+    if (output) {
+        delete[] output;
+        output = nullptr;
+    }
+    bins = 0;
+    primed = false;
+    frameCount = 0;
+}
+
+void SpectrumAccumulator::reset() {
+    if (!accum) return;
+
+    for (uint16_t i = 0; i < bins; i++) {
+        accum[i] = 0.0f;
+        output[i] = SPECTRUM_FLOOR_POWER;
+    }
+    frameCount = 0;
+    primed = false;
+}
+
+bool SpectrumAccumulator::accumulate(const float* power) {
+    if (!accum || !power) return false;
+
+    // Each loop is branch-free per bin so the compiler can vectorize it
+    float* __restrict a = accum;
+    const float* __restrict p = power;
+    const uint16_t n = bins;
+
+    if (!primed && mode != SPECTRUM_AVERAGE) {
+        memcpy(a, p, n * sizeof(float));
+        primed = true;
+        return true;
+    }
+
+    switch (mode) {
+        case SPECTRUM_LIVE:
+            memcpy(a, p, n * sizeof(float));
+            return true;
+
+        case SPECTRUM_EMA: {
+            const float alpha = emaAlpha;
+            for (uint16_t i = 0; i < n; i++) {
+                a[i] += alpha * (p[i] - a[i]);
+            }
+            return true;
+        }
+
+        case SPECTRUM_AVERAGE: {
+            for (uint16_t i = 0; i < n; i++) {
+                a[i] += p[i];
+            }
+            if (++frameCount < averageFrames) return false;
+
+            const float scale = 1.0f / frameCount;
+            float* __restrict o = output;
+            for (uint16_t i = 0; i < n; i++) {
+                o[i] = a[i] * scale;
+                a[i] = 0.0f;
+            }
+            frameCount = 0;
+            primed = true;
+            return true;
+        }
+
+        case SPECTRUM_MAX_HOLD:
+            for (uint16_t i = 0; i < n; i++) {
+                a[i] = fmaxf(a[i], p[i]);
+            }
+            return true;
+
+        case SPECTRUM_MIN_HOLD:
+            for (uint16_t i = 0; i < n; i++) {
+                a[i] = fminf(a[i], p[i]);
+            }
+            return true;
+
+        case SPECTRUM_PEAK_DECAY: {
+            const float decay = decayFactor;
+            for (uint16_t i = 0; i < n; i++) {
+                a[i] = fmaxf(a[i] * decay, p[i]);
+            }
+            return true;
+        }
+    }
+
+    return false;
+}
+
+void SpectrumAccumulator::toDb(float* outDb) const {
+    const float* power = getPower();
+    if (!power || !outDb) return;
+
+    const float offset = dbOffset;
+    for (uint16_t i = 0; i < bins; i++) {
+        float db = 10.0f * log10f(fmaxf(power[i], SPECTRUM_FLOOR_POWER)) + offset;
+        outDb[i] = fmaxf(db, SPECTRUM_FLOOR_DB);
+    }
+}
+
+void SpectrumAccumulator::setMode(SpectrumMode newMode) {
+    if (newMode == mode) return;
+    mode = newMode;
+    reset();
+}
+
+void SpectrumAccumulator::setEmaAlpha(float alpha) {
+    if (alpha < 0.01f) alpha = 0.01f;
+    if (alpha > 1.0f) alpha = 1.0f;
+    emaAlpha = alpha;
+}
+
+void SpectrumAccumulator::setAverageFrames(uint8_t frames) {
+    if (frames < 1) frames = 1;
+    if (frames > SPECTRUM_MAX_AVERAGE) frames = SPECTRUM_MAX_AVERAGE;
+    averageFrames = frames;
+    if (mode == SPECTRUM_AVERAGE) reset();
+}
+
+void SpectrumAccumulator::setPeakDecay(float dbPerFrame) {
+    if (dbPerFrame < 0.0f) dbPerFrame = 0.0f;
+    decayFactor = powf(10.0f, -dbPerFrame / 10.0f);
+}
+
+const char* SpectrumAccumulator::modeName(SpectrumMode mode) {
+    switch (mode) {
+        case SPECTRUM_LIVE:       return "LIVE";
+        case SPECTRUM_EMA:        return "EMA";
+        case SPECTRUM_AVERAGE:    return "AVG";
+        case SPECTRUM_MAX_HOLD:   return "MAX";
+        case SPECTRUM_MIN_HOLD:   return "MIN";
+        case SPECTRUM_PEAK_DECAY: return "PEAK";
+        default:                  return "?";
+    }
+}
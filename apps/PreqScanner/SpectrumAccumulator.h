@@ -0,0 +1,73 @@
+#ifndef SPECTRUM_ACCUMULATOR_H
+#define SPECTRUM_ACCUMULATOR_H
+
+#include <stdint.h>
+
+// ========================================
+// SpectrumAccumulator - Frame-to-frame spectrum combining
+// Works on linear power (|X|^2) so averages are unbiased; dB conversion
+// happens once per finished output. Hardware independent.
+// ========================================
+
+#define SPECTRUM_FLOOR_DB      -120.0f
+#define SPECTRUM_FLOOR_POWER   1e-12f   // SPECTRUM_FLOOR_DB as power
+#define SPECTRUM_MAX_AVERAGE   64       // Upper bound on frames per average
+
+// Accumulator modes
+enum SpectrumMode {
+    SPECTRUM_LIVE,        // Latest frame only
+    SPECTRUM_EMA,         // Exponential moving average
+    SPECTRUM_AVERAGE,     // Block average of N (overlapping) frames, Welch style
+    SPECTRUM_MAX_HOLD,    // Per-bin maximum since reset
+    SPECTRUM_MIN_HOLD,    // Per-bin minimum since reset
+    SPECTRUM_PEAK_DECAY   // Maximum that falls off at a fixed dB per frame
+};
+
+class SpectrumAccumulator {
+private:
+    float* accum;                 // Running state in power units
+    float* output;                // Last finished block average
+    uint16_t bins;
+    SpectrumMode mode;
+    float emaAlpha;               // Weight of the newest frame
+    uint8_t averageFrames;        // Frames per block average
+    uint8_t frameCount;           // Frames in the current block
+    float decayFactor;            // Per-frame multiplier for peak decay
+    float dbOffset;               // Added to every output level (scale corrections)
+    bool primed;                  // accum holds at least one frame
+
+public:
+    SpectrumAccumulator();
+    ~SpectrumAccumulator();
+
+    // Buffers are sized once per FFT size; reallocates only when bins changes
+    bool allocate(uint16_t binCount);
+    void release();
+    void reset();
+
+    // Adds one power frame. Returns true when a new output is available
+    // (every frame, except every averageFrames frames in SPECTRUM_AVERAGE).
+    bool accumulate(const float* power);
+
+    // Writes the current output as 10*log10(power) + dbOffset, floored at
+    // SPECTRUM_FLOOR_DB. Constant corrections ride along here once per output
+    // instead of scaling every bin of every frame.
+    void toDb(float* outDb) const;
+    const float* getPower() const { return (mode == SPECTRUM_AVERAGE) ? output : accum; }
+
+    void setMode(SpectrumMode newMode);
+    void setEmaAlpha(float alpha);
+    void setAverageFrames(uint8_t frames);
+    void setPeakDecay(float dbPerFrame);
+    void setDbOffset(float offsetDb) { dbOffset = offsetDb; }
+
+    SpectrumMode getMode() const { return mode; }
+    uint16_t getBins() const { return bins; }
+    uint8_t getFrameCount() const { return frameCount; }
+    float getDbOffset() const { return dbOffset; }
+    bool isAllocated() const { return accum != nullptr; }
+
+    static const char* modeName(SpectrumMode mode);
+};
+
+#endif // SPECTRUM_ACCUMULATOR_H
@@ -0,0 +1,285 @@
+#include "ToneMonitor.h"
+#include <math.h>
+
+#define TONE_CHUNK   64     // Samples conditioned at once before the detector pass
+
+ToneMonitor::ToneMonitor() :
+    detectorCount(0),
+    sampleRate(0),
+    blockSize(0),
+    blockPos(0),
+    window(nullptr),
+    levelOffsetDb(0),
+    debounce(TONE_DEFAULT_DEBOUNCE),
+    dcEstimate(0),
+    samplesSeen(0),
+    blocksDone(0),
+    eventHead(0),
+    eventTail(0),
+    eventsDropped(0)
+{
+}
+
+ToneMonitor::~ToneMonitor() {
+    release();
+}
+
+bool ToneMonitor::configure(uint32_t rate, uint16_t size) {
+    if (rate == 0 || size < TONE_MIN_BLOCK || size > TONE_MAX_BLOCK) return false;
+
+    if (!window || size != blockSize) {
+        release();
+        window = new float[size];
+        if (!window) return false;
+    }
+    sampleRate = rate;
+    blockSize = size;
+
+    float sum = 0;
+    for (uint16_t n = 0; n < size; n++) {
+        window[n] = 0.5f - 0.5f * cosf(2.0f * M_PI * n / size);
+        sum += window[n];
+    }
+    // A sine of amplitude A gives |X| = A * sum(w) / 2
+    levelOffsetDb = 20.0f * log10f(2.0f / (sum * TONE_FULL_SCALE));
+
+    for (uint8_t i = 0; i < detectorCount; i++) {
+        if (!detectors[i].enabled) continue;
+        if (detectors[i].frequency <= 0 || detectors[i].frequency >= rate / 2.0f) {
+            detectors[i].enabled = false;
+        } else {
+            detectors[i].coeff = coefficientFor(detectors[i].frequency);
+        }
+    }
+
+    reset();
+    return true;
+}
+
+void ToneMonitor::release() {
+    if (window) {
+        delete[] window;
+        window = nullptr;
+    }
+    blockSize = 0;
+    blockPos = 0;
+}
+
+void ToneMonitor::reset() {
+    for (uint8_t i = 0; i < detectorCount; i++) {
+        ToneDetector& d = detectors[i];
+        d.s1 = d.s2 = 0;
+        d.levelDb = TONE_FLOOR_DB;
+        d.active = false;
+        d.pending = 0;
+        d.pendingSince = 0;
+        d.stateSince = 0;
+        d.onCount = 0;
+        d.lastOnMs = 0;
+        d.longestOnMs = 0;
+        d.totalOnMs = 0;
+    }
+    blockPos = 0;
+    dcEstimate = 0;
+    samplesSeen = 0;
+    blocksDone = 0;
+    eventHead = eventTail = 0;
+    eventsDropped = 0;
+}
+
+float ToneMonitor::coefficientFor(float frequency) const {
+    return 2.0f * cosf(2.0f * M_PI * frequency / sampleRate);
+}
+
+int8_t ToneMonitor::addDetector(float frequency, float onDb, float hysteresisDb) {
+    uint8_t slot = 0;
+    while (slot < TONE_MAX_DETECTORS && detectors[slot].enabled) slot++;
+    if (slot == TONE_MAX_DETECTORS) return -1;
+
+    detectors[slot] = ToneDetector();
+    if (!setDetectorFrequency(slot, frequency)) return -1;
+    setThresholds(slot, onDb, hysteresisDb);
+    detectors[slot].stateSince = getElapsedMs();
+    if (slot >= detectorCount) detectorCount = slot + 1;
+    return slot;
+}
+
+bool ToneMonitor::setDetectorFrequency(uint8_t index, float frequency) {
+    if (index >= TONE_MAX_DETECTORS || sampleRate == 0) return false;
+    if (frequency <= 0 || frequency >= sampleRate / 2.0f) return false;
+
+    ToneDetector& d = detectors[index];
+    d.frequency = frequency;
+    d.coeff = coefficientFor(frequency);
+    d.s1 = d.s2 = 0;
+    d.enabled = true;
+    return true;
+}
+
+void ToneMonitor::setThresholds(uint8_t index, float onDb, float hysteresisDb) {
+    if (index >= TONE_MAX_DETECTORS) return;
+    detectors[index].onDb = onDb;
+    detectors[index].offDb = onDb - (hysteresisDb > 0 ? hysteresisDb : 0);
+}
+
+void ToneMonitor::removeDetector(uint8_t index) {
+    if (index >= detectorCount) return;
+
+    // A tone that is on when its detector goes away still gets its off event
+    ToneDetector& d = detectors[index];
+    if (d.enabled && d.active) {
+        uint32_t now = getElapsedMs();
+        pushEvent(index, d, TONE_EVENT_OFF, now, now - d.stateSince);
+    }
+    d.enabled = false;
+    d.active = false;
+
+    while (detectorCount > 0 && !detectors[detectorCount - 1].enabled) detectorCount--;
+}
+
+void ToneMonitor::clearDetectors() {
+    for (uint8_t i = TONE_MAX_DETECTORS; i > 0; i--) {
+        removeDetector(i - 1);
+    }
+}
+
+uint16_t ToneMonitor::process(const int16_t* samples, uint16_t count) {
+    if (!window || !samples) return 0;
+
+    uint16_t finished = 0;
+    float x[TONE_CHUNK];
+
+    // Start the DC tracker at the input level instead of ramping up from zero
+    if (samplesSeen == 0 && count > 0) dcEstimate = (int32_t)samples[0] << 8;
+
+    while (count > 0) {
+        // Never run a chunk across a block boundary
+        uint16_t span = blockSize - blockPos;
+        if (span > TONE_CHUNK) span = TONE_CHUNK;
+        if (span > count) span = count;
+
+        // DC removal (time constant 1024 samples) and windowing, once for all detectors
+        const float* w = window + blockPos;
+        for (uint16_t n = 0; n < span; n++) {
+            dcEstimate += (((int32_t)samples[n] << 8) - dcEstimate) >> 10;
+            x[n] = ((float)samples[n] - dcEstimate * (1.0f / 256.0f)) * w[n];
+        }
+
+        // Detector-major loop keeps each filter's state in registers
+        for (uint8_t i = 0; i < detectorCount; i++) {
+            ToneDetector& d = detectors[i];
+            if (!d.enabled) continue;
+
+            float coeff = d.coeff;
+            float s1 = d.s1, s2 = d.s2;
+            for (uint16_t n = 0; n < span; n++) {
+                float s0 = x[n] + coeff * s1 - s2;
+                s2 = s1;
+                s1 = s0;
+            }
+            d.s1 = s1;
+            d.s2 = s2;
+        }
+
+        samples += span;
+        count -= span;
+        blockPos += span;
+        samplesSeen += span;
+
+        if (blockPos == blockSize) {
+            finishBlock();
+            finished++;
+        }
+    }
+    return finished;
+}
+
+void ToneMonitor::finishBlock() {
+    uint32_t blockStart = (uint32_t)((samplesSeen - blockSize) * 1000 / sampleRate);
+
+    for (uint8_t i = 0; i < detectorCount; i++) {
+        ToneDetector& d = detectors[i];
+        if (!d.enabled) continue;
+
+        // |X|^2 for a non-integer k; the phase term is not needed for power
+        float power = d.s1 * d.s1 + d.s2 * d.s2 - d.coeff * d.s1 * d.s2;
+        d.s1 = d.s2 = 0;
+
+        d.levelDb = (power > 0) ? 10.0f * log10f(power) + levelOffsetDb : TONE_FLOOR_DB;
+        if (d.levelDb < TONE_FLOOR_DB) d.levelDb = TONE_FLOOR_DB;
+
+        decide(i, d, blockStart);
+    }
+
+    blockPos = 0;
+    blocksDone++;
+}
+
+void ToneMonitor::decide(uint8_t index, ToneDetector& d, uint32_t blockStart) {
+    bool vote = d.active ? (d.levelDb < d.offDb) : (d.levelDb >= d.onDb);
+    if (!vote) {
+        d.pending = 0;
+        return;
+    }
+
+    if (d.pending == 0) d.pendingSince = blockStart;
+    if (++d.pending < debounce) return;
+
+    // The change is dated from the first block that voted for it
+    uint32_t changed = d.pendingSince;
+    uint32_t duration = changed - d.stateSince;
+    d.pending = 0;
+    d.active = !d.active;
+    d.stateSince = changed;
+
+    if (d.active) {
+        pushEvent(index, d, TONE_EVENT_ON, changed, duration);
+    } else {
+        d.onCount++;
+        d.lastOnMs = duration;
+        d.totalOnMs += duration;
+        if (duration > d.longestOnMs) d.longestOnMs = duration;
+        pushEvent(index, d, TONE_EVENT_OFF, changed, duration);
+    }
+}
+
+void ToneMonitor::pushEvent(uint8_t index, const ToneDetector& d, ToneEventType type,
+                            uint32_t now, uint32_t duration) {
+    if ((uint16_t)(eventHead - eventTail) >= TONE_EVENT_QUEUE_SIZE) {
+        eventsDropped++;
+        return;
+    }
+
+    ToneEvent& e = events[eventHead & (TONE_EVENT_QUEUE_SIZE - 1)];
+    e.detector = index;
+    e.type = type;
+    e.frequency = d.frequency;
+    e.levelDb = d.levelDb;
+    e.timestamp = now;
+    e.duration = duration;
+    eventHead++;
+}
+
+bool ToneMonitor::pollEvent(ToneEvent& event) {
+    if (eventHead == eventTail) return false;
+    event = events[eventTail & (TONE_EVENT_QUEUE_SIZE - 1)];
+    eventTail++;
+    return true;
+}
+
+const ToneDetector* ToneMonitor::getDetector(uint8_t index) const {
+    if (index >= detectorCount || !detectors[index].enabled) return nullptr;
+    return &detectors[index];
+}
+
+uint8_t ToneMonitor::getActiveCount() const {
+    uint8_t active = 0;
+    for (uint8_t i = 0; i < detectorCount; i++) {
+        if (detectors[i].enabled && detectors[i].active) active++;
+    }
+    return active;
+}
+
+uint32_t ToneMonitor::getElapsedMs() const {
+    return sampleRate ? (uint32_t)(samplesSeen * 1000 / sampleRate) : 0;
+}
@@ -0,0 +1,133 @@
+#ifndef TONE_MONITOR_H
+#define TONE_MONITOR_H
+
+#include <stdint.h>
+
+// ========================================
+// ToneMonitor - Goertzel filter bank for fixed-frequency monitoring
+// Each detector evaluates one DFT term at an arbitrary (not bin-centred)
+// frequency over Hann-windowed blocks, so watching a few known tones
+// costs a multiply-add per detector per sample instead of a full FFT.
+// On/off decisions use separate thresholds plus a debounce count.
+// Hardware independent.
+// ========================================
+
+#define TONE_MAX_DETECTORS     8
+#define TONE_MIN_BLOCK         32
+#define TONE_MAX_BLOCK         2048
+#define TONE_EVENT_QUEUE_SIZE  32       // Must be a power of two
+#define TONE_DEFAULT_ON_DB     -40.0f   // dBFS that switches a detector on
+#define TONE_DEFAULT_HYST_DB   6.0f     // Off threshold sits this far below
+#define TONE_DEFAULT_DEBOUNCE  2        // Blocks a new state must persist
+#define TONE_FULL_SCALE        2048.0f  // Peak amplitude of 0 dBFS (12-bit ADC)
+#define TONE_FLOOR_DB          -120.0f
+
+enum ToneEventType : uint8_t {
+    TONE_EVENT_ON,
+    TONE_EVENT_OFF
+};
+
+// Detector state change, timed by the sample clock
+struct ToneEvent {
+    uint8_t detector;
+    ToneEventType type;
+    float frequency;      // Detector frequency (Hz)
+    float levelDb;        // Level of the block that confirmed the change
+    uint32_t timestamp;   // ms since the monitor was started
+    uint32_t duration;    // ms spent in the state that just ended
+};
+
+struct ToneDetector {
+    float frequency;      // Hz
+    float onDb;           // Level that turns the detector on (dBFS)
+    float offDb;          // Level below which it turns off (dBFS)
+    float levelDb;        // Latest block level (dBFS)
+    float coeff;          // 2 cos(w)
+    float s1, s2;         // Goertzel state
+    bool enabled;
+    bool active;          // Tone present
+    uint8_t pending;      // Consecutive blocks voting for the other state
+    uint32_t pendingSince; // ms when the first of those blocks started
+    uint32_t stateSince;  // ms when the current state began
+    uint32_t onCount;     // Completed on periods
+    uint32_t lastOnMs;
+    uint32_t longestOnMs;
+    uint32_t totalOnMs;
+
+    ToneDetector() : frequency(0), onDb(TONE_DEFAULT_ON_DB),
+                     offDb(TONE_DEFAULT_ON_DB - TONE_DEFAULT_HYST_DB),
+                     levelDb(TONE_FLOOR_DB), coeff(0), s1(0), s2(0),
+                     enabled(false), active(false), pending(0), pendingSince(0), stateSince(0),
+                     onCount(0), lastOnMs(0), longestOnMs(0), totalOnMs(0) {}
+};
+
+class ToneMonitor {
+private:
+    ToneDetector detectors[TONE_MAX_DETECTORS];
+    uint8_t detectorCount;        // Highest used slot + 1
+
+    uint32_t sampleRate;
+    uint16_t blockSize;
+    uint16_t blockPos;
+    float* window;                // Hann window of blockSize
+    float levelOffsetDb;          // Converts Goertzel power to dBFS
+    uint8_t debounce;
+
+    int32_t dcEstimate;           // Input DC in Q8, tracked with a one-pole filter
+    uint64_t samplesSeen;
+    uint32_t blocksDone;
+
+    ToneEvent events[TONE_EVENT_QUEUE_SIZE];
+    uint16_t eventHead, eventTail;
+    uint16_t eventsDropped;
+
+    void finishBlock();
+    void decide(uint8_t index, ToneDetector& d, uint32_t blockStart);
+    void pushEvent(uint8_t index, const ToneDetector& d, ToneEventType type, uint32_t now, uint32_t duration);
+    float coefficientFor(float frequency) const;
+
+public:
+    ToneMonitor();
+    ~ToneMonitor();
+
+    // Block length sets both resolution (Hann main lobe ~ 4 * rate / size wide)
+    // and decision latency (size / rate per block). Detectors keep their
+    // frequencies across a reconfigure.
+    bool configure(uint32_t rate, uint16_t size);
+    void release();
+    // Clears Goertzel state, statistics, events and the sample clock
+    void reset();
+
+    // Returns the slot used, or -1 when the bank is full or the
+    // frequency is outside (0, rate/2)
+    int8_t addDetector(float frequency, float onDb = TONE_DEFAULT_ON_DB,
+                       float hysteresisDb = TONE_DEFAULT_HYST_DB);
+    bool setDetectorFrequency(uint8_t index, float frequency);
+    void setThresholds(uint8_t index, float onDb, float hysteresisDb);
+    void removeDetector(uint8_t index);
+    void clearDetectors();
+    void setDebounce(uint8_t blocks) { debounce = blocks ? blocks : 1; }
+
+    // Feeds raw signed ADC samples (any count). Returns the number of
+    // blocks completed, each of which refreshes every level.
+    uint16_t process(const int16_t* samples, uint16_t count);
+    // Samples left until the current block completes
+    uint16_t samplesToBlockEnd() const { return blockSize - blockPos; }
+    // Advances the sample clock over time the input was not sampled, so
+    // durations stay in wall time when acquisition has gaps. Call between blocks.
+    void skipSamples(uint32_t count) { samplesSeen += count; }
+
+    bool pollEvent(ToneEvent& event);
+    uint16_t getDroppedEvents() const { return eventsDropped; }
+
+    const ToneDetector* getDetector(uint8_t index) const;
+    uint8_t getDetectorCount() const { return detectorCount; }
+    uint8_t getActiveCount() const;
+    uint16_t getBlockSize() const { return blockSize; }
+    uint32_t getBlocksProcessed() const { return blocksDone; }
+    float getBlockDuration() const { return sampleRate ? (float)blockSize / sampleRate : 0; }
+    uint32_t getElapsedMs() const;
+    bool isConfigured() const { return window != nullptr; }
+};
+
+#endif // TONE_MONITOR_H
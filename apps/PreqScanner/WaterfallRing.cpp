@@ -0,0 +1,108 @@
+#include "WaterfallRing.h"
+#include <string.h>
+
+void buildWaterfallBinMap(uint16_t* binStart, uint16_t width, uint16_t bins,
+                          float firstBin, float binsPerPixel) {
+    // Every pixel starts on a real bin; only the end entry may equal bins
+    for (uint16_t x = 0; x <= width; x++) {
+        uint16_t bin = (uint16_t)(firstBin + x * binsPerPixel);
+        if (bin > bins - 1 && x < width) bin = bins - 1;
+        if (bin > bins) bin = bins;
+        binStart[x] = bin;
+    }
+}
+
+WaterfallRing::WaterfallRing()
+    : history(nullptr), line(nullptr), width(0), depth(0), areaRows(0),
+      writeLine(0), writeRow(0), stored(0), pending(0), repaint(true) {}
+
+WaterfallRing::~WaterfallRing() {
+    release();
+}
+
+bool WaterfallRing::allocate(uint16_t lineWidth, uint16_t historyDepth, uint16_t screenRows) {
+    release();
+    if (lineWidth == 0 || historyDepth == 0 || screenRows == 0) return false;
+
+    width = lineWidth;
+    depth = historyDepth;
+    areaRows = screenRows < historyDepth ? screenRows : historyDepth;
+
+    history = new uint8_t[historyBytes()];
+    line = new uint16_t[width];
+    if (!history || !line) {
+        release();
+        return false;
+    }
+
+    clear();
+    return true;
+}
+
+void WaterfallRing::release() {
+    if (history) {
+        delete[] history;
+        history = nullptr;
+    }
+    if (line) {
+        delete[] line;
+        line = nullptr;
+    }
+    width = 0;
+    depth = 0;
+    areaRows = 0;
+}
+
+void WaterfallRing::clear() {
+    if (history) memset(history, 0, historyBytes());
+    writeLine = 0;
+    writeRow = 0;
+    stored = 0;
+    pending = 0;
+    repaint = true;
+}
+
+void WaterfallRing::commitLine() {
+    writeLine = (writeLine + 1) % depth;
+    if (stored < depth) stored++;
+    if (pending < depth) pending++;
+}
+
+const uint8_t* WaterfallRing::historyLine(uint16_t age) const {
+    if (!history || age >= depth) return nullptr;
+    uint16_t index = (writeLine + depth - 1 - age) % depth;
+    return history + (size_t)index * width;
+}
+
+const uint16_t* WaterfallRing::expand(const uint8_t* indices, const uint16_t* palette) {
+    for (uint16_t x = 0; x < width; x++) {
+        line[x] = palette[indices[x]];
+    }
+    return line;
+}
+
+uint16_t WaterfallRing::render(WaterfallRowSink& sink, const uint16_t* palette) {
+    if (!history || !palette) return 0;
+
+    uint16_t pushed = 0;
+    if (repaint) {
+        // Newest line just above the write row, older lines wrapping behind it
+        for (uint16_t age = 0; age < areaRows; age++) {
+            uint16_t row = (writeRow + areaRows - 1 - age) % areaRows;
+            sink.pushRow(row, expand(historyLine(age), palette), width);
+            pushed++;
+        }
+        repaint = false;
+    } else {
+        // One row per new line, oldest first, each at its ring position
+        uint16_t count = pending < areaRows ? pending : areaRows;
+        for (uint16_t age = count; age > 0; age--) {
+            sink.pushRow(writeRow, expand(historyLine(age - 1), palette), width);
+            writeRow = (writeRow + 1) % areaRows;
+            pushed++;
+        }
+    }
+
+    pending = 0;
+    return pushed;
+}
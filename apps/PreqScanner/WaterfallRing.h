@@ -0,0 +1,94 @@
+#ifndef WATERFALL_RING_H
+#define WATERFALL_RING_H
+
+#include <stdint.h>
+#include <stddef.h>
+
+// ========================================
+// WaterfallRing - Waterfall history and its on-screen ring
+// History keeps one palette index per pixel; colors are looked up only
+// when a line is sent. The screen area is a ring as well: each new line
+// goes to the row after the previous one through a single address
+// window, so nothing already on screen is sent again. A full repaint
+// from history happens only when the area is first shown or the palette
+// changes. The bin map and pooling that turn a spectrum into one line of
+// pixels live here too. Hardware independent: rows go out through
+// WaterfallRowSink.
+// ========================================
+
+// Pixel x covers FFT bins [binStart[x], binStart[x + 1]); the map has
+// width + 1 entries. A pixel narrower than a bin repeats the bin it falls in.
+void buildWaterfallBinMap(uint16_t* binStart, uint16_t width, uint16_t bins,
+                          float firstBin, float binsPerPixel);
+
+// Combines the bins under pixel x by maximum or mean
+inline float poolWaterfallPixel(const float* spectrum, const uint16_t* binStart,
+                                uint16_t x, bool useMax) {
+    uint16_t first = binStart[x];
+    uint16_t last = binStart[x + 1];
+    float value = spectrum[first];
+    if (last <= first + 1) return value;
+
+    if (useMax) {
+        for (uint16_t bin = first + 1; bin < last; bin++) {
+            if (spectrum[bin] > value) value = spectrum[bin];
+        }
+        return value;
+    }
+    for (uint16_t bin = first + 1; bin < last; bin++) {
+        value += spectrum[bin];
+    }
+    return value / (last - first);
+}
+
+// Receives finished RGB565 rows; row counts from the top of the area
+class WaterfallRowSink {
+public:
+    virtual ~WaterfallRowSink() {}
+    virtual void pushRow(uint16_t row, const uint16_t* pixels, uint16_t width) = 0;
+};
+
+class WaterfallRing {
+private:
+    uint8_t* history;             // depth x width palette indices
+    uint16_t* line;               // One line expanded to RGB565
+    uint16_t width;
+    uint16_t depth;               // Lines of history
+    uint16_t areaRows;            // Rows of the screen area
+    uint16_t writeLine;           // History line written next
+    uint16_t writeRow;            // Area row written next
+    uint16_t stored;              // History lines holding data
+    uint16_t pending;             // Lines in history not yet on screen
+    bool repaint;                 // Area must be repainted from history
+
+    const uint16_t* expand(const uint8_t* indices, const uint16_t* palette);
+
+public:
+    WaterfallRing();
+    ~WaterfallRing();
+
+    // Rows beyond depth are never painted; areaRows is clamped to depth
+    bool allocate(uint16_t lineWidth, uint16_t historyDepth, uint16_t screenRows);
+    void release();
+    void clear();
+
+    // Fill the returned row with palette indices, then commit it
+    uint8_t* beginLine() { return history + (size_t)writeLine * width; }
+    void commitLine();
+    const uint8_t* historyLine(uint16_t age) const;   // 0: newest
+
+    // Repaint everything on the next render (area shown, palette changed)
+    void invalidate() { repaint = true; }
+    // Sends whatever the area is missing; returns rows pushed
+    uint16_t render(WaterfallRowSink& sink, const uint16_t* palette);
+
+    bool isAllocated() const { return history != nullptr; }
+    uint16_t getWidth() const { return width; }
+    uint16_t getDepth() const { return depth; }
+    uint16_t getStored() const { return stored; }
+    uint16_t getPending() const { return pending; }
+    uint16_t getWriteRow() const { return writeRow; }
+    size_t historyBytes() const { return (size_t)depth * width; }
+};
+
+#endif // WATERFALL_RING_H
@@ -0,0 +1,343 @@
+#include "WindowTables.h"
+#include <math.h>
+
+// Tables were generated in double precision; windows are symmetric
+// (w[n] = w[N - n]) so only the first half is stored.
+
+// Hamming: 0.54 - 0.46 cos(2 pi n / N), n = 0..N/2 of N = WINDOW_TABLE_SIZE
+static const float hammingTable[WINDOW_TABLE_HALF] = {
+    0.08f, 0.0800086594f, 0.0800346372f, 0.0800779324f, 0.0801385434f, 0.0802164679f, 0.0803117031f, 0.0804242452f,
+    0.0805540901f, 0.0807012329f, 0.0808656681f, 0.0810473893f, 0.0812463899f, 0.0814626623f, 0.0816961984f, 0.0819469893f,
+    0.0822150257f, 0.0825002975f, 0.0828027938f, 0.0831225034f, 0.0834594141f, 0.0838135133f, 0.0841847877f, 0.0845732233f,
+    0.0849788054f, 0.0854015188f, 0.0858413476f, 0.0862982753f, 0.0867722845f, 0.0872633575f, 0.0877714758f, 0.0882966202f,
+    0.088838771f, 0.0893979078f, 0.0899740095f, 0.0905670544f, 0.0911770202f, 0.0918038839f, 0.092447622f, 0.0931082101f,
+    0.0937856235f, 0.0944798366f, 0.0951908233f, 0.0959185568f, 0.0966630097f, 0.097424154f, 0.0982019611f, 0.0989964015f,
+    0.0998074456f, 0.100635063f, 0.101479221f, 0.10233989f, 0.103217037f, 0.104110628f, 0.10502063f, 0.105947009f,
+    0.10688973f, 0.107848757f, 0.108824055f, 0.109815585f, 0.110823313f, 0.111847198f, 0.112887203f, 0.113943289f,
+    0.115015415f, 0.116103542f, 0.117207628f, 0.118327632f, 0.119463512f, 0.120615225f, 0.121782728f, 0.122965976f,
+    0.124164925f, 0.12537953f, 0.126609746f, 0.127855525f, 0.129116821f, 0.130393587f, 0.131685775f, 0.132993335f,
+    0.134316218f, 0.135654376f, 0.137007757f, 0.13837631f, 0.139759984f, 0.141158727f, 0.142572486f, 0.144001208f,
+    0.145444839f, 0.146903325f, 0.148376611f, 0.149864641f, 0.15136736f, 0.15288471f, 0.154416635f, 0.155963078f,
+    0.157523978f, 0.159099279f, 0.160688921f, 0.162292843f, 0.163910986f, 0.165543288f, 0.167189689f, 0.168850125f,
+    0.170524536f, 0.172212856f, 0.173915024f, 0.175630974f, 0.177360643f, 0.179103965f, 0.180860875f, 0.182631306f,
+    0.184415191f, 0.186212465f, 0.188023058f, 0.189846903f, 0.191683931f, 0.193534072f, 0.195397259f, 0.197273419f,
+    0.199162482f, 0.201064378f, 0.202979035f, 0.20490638f, 0.206846342f, 0.208798846f, 0.21076382f, 0.21274119f,
+    0.214730881f, 0.216732818f, 0.218746925f, 0.220773128f, 0.222811349f, 0.224861513f, 0.226923541f, 0.228997356f,
+    0.231082881f, 0.233180036f, 0.235288742f, 0.237408921f, 0.239540492f, 0.241683376f, 0.24383749f, 0.246002755f,
+    0.248179089f, 0.25036641f, 0.252564635f, 0.254773683f, 0.256993468f, 0.259223909f, 0.261464921f, 0.263716419f,
+    0.26597832f, 0.268250537f, 0.270532986f, 0.272825579f, 0.275128232f, 0.277440857f, 0.279763367f, 0.282095675f,
+    0.284437693f, 0.286789332f, 0.289150505f, 0.291521123f, 0.293901095f, 0.296290333f, 0.298688746f, 0.301096245f,
+    0.303512738f, 0.305938134f, 0.308372343f, 0.310815273f, 0.313266832f, 0.315726926f, 0.318195465f, 0.320672354f,
+    0.323157501f, 0.325650812f, 0.328152193f, 0.33066155f, 0.333178788f, 0.335703813f, 0.33823653f, 0.340776843f,
+    0.343324657f, 0.345879875f, 0.348442402f, 0.351012141f, 0.353588996f, 0.356172868f, 0.358763662f, 0.361361279f,
+    0.363965621f, 0.366576591f, 0.369194091f, 0.371818021f, 0.374448283f, 0.377084778f, 0.379727407f, 0.38237607f,
+    0.385030667f, 0.387691099f, 0.390357266f, 0.393029066f, 0.395706399f, 0.398389166f, 0.401077263f, 0.403770591f,
+    0.406469048f, 0.409172533f, 0.411880943f, 0.414594176f, 0.417312132f, 0.420034706f, 0.422761797f, 0.425493301f,
+    0.428229117f, 0.430969141f, 0.43371327f, 0.436461401f, 0.43921343f, 0.441969253f, 0.444728767f, 0.447491868f,
+    0.450258452f, 0.453028414f, 0.455801652f, 0.458578059f, 0.461357531f, 0.464139965f, 0.466925254f, 0.469713295f,
+    0.472503982f, 0.47529721f, 0.478092874f, 0.480890869f, 0.483691089f, 0.48649343f, 0.489297785f, 0.492104048f,
+    0.494912115f, 0.49772188f, 0.500533236f, 0.503346079f, 0.506160301f, 0.508975797f, 0.511792461f, 0.514610188f,
+    0.51742887f, 0.520248402f, 0.523068677f, 0.525889591f, 0.528711035f, 0.531532904f, 0.534355092f, 0.537177493f,
+    0.54f, 0.542822507f, 0.545644908f, 0.548467096f, 0.551288965f, 0.554110409f, 0.556931323f, 0.559751598f,
+    0.56257113f, 0.565389812f, 0.568207539f, 0.571024203f, 0.573839699f, 0.576653921f, 0.579466764f, 0.58227812f,
+    0.585087885f, 0.587895952f, 0.590702215f, 0.59350657f, 0.596308911f, 0.599109131f, 0.601907126f, 0.60470279f,
+    0.607496018f, 0.610286705f, 0.613074746f, 0.615860035f, 0.618642469f, 0.621421941f, 0.624198348f, 0.626971586f,
+    0.629741548f, 0.632508132f, 0.635271233f, 0.638030747f, 0.64078657f, 0.643538599f, 0.64628673f, 0.649030859f,
+    0.651770883f, 0.654506699f, 0.657238203f, 0.659965294f, 0.662687868f, 0.665405824f, 0.668119057f, 0.670827467f,
+    0.673530952f, 0.676229409f, 0.678922737f, 0.681610834f, 0.684293601f, 0.686970934f, 0.689642734f, 0.692308901f,
+    0.694969333f, 0.69762393f, 0.700272593f, 0.702915222f, 0.705551717f, 0.708181979f, 0.710805909f, 0.713423409f,
+    0.716034379f, 0.718638721f, 0.721236338f, 0.723827132f, 0.726411004f, 0.728987859f, 0.731557598f, 0.734120125f,
+    0.736675343f, 0.739223157f, 0.74176347f, 0.744296187f, 0.746821212f, 0.74933845f, 0.751847807f, 0.754349188f,
+    0.756842499f, 0.759327646f, 0.761804535f, 0.764273074f, 0.766733168f, 0.769184727f, 0.771627657f, 0.774061866f,
+    0.776487262f, 0.778903755f, 0.781311254f, 0.783709667f, 0.786098905f, 0.788478877f, 0.790849495f, 0.793210668f,
+    0.795562307f, 0.797904325f, 0.800236633f, 0.802559143f, 0.804871768f, 0.807174421f, 0.809467014f, 0.811749463f,
+    0.81402168f, 0.816283581f, 0.818535079f, 0.820776091f, 0.823006532f, 0.825226317f, 0.827435365f, 0.82963359f,
+    0.831820911f, 0.833997245f, 0.83616251f, 0.838316624f, 0.840459508f, 0.842591079f, 0.844711258f, 0.846819964f,
+    0.848917119f, 0.851002644f, 0.853076459f, 0.855138487f, 0.857188651f, 0.859226872f, 0.861253075f, 0.863267182f,
+    0.865269119f, 0.86725881f, 0.86923618f, 0.871201154f, 0.873153658f, 0.87509362f, 0.877020965f, 0.878935622f,
+    0.880837518f, 0.882726581f, 0.884602741f, 0.886465928f, 0.888316069f, 0.890153097f, 0.891976942f, 0.893787535f,
+    0.895584809f, 0.897368694f, 0.899139125f, 0.900896035f, 0.902639357f, 0.904369026f, 0.906084976f, 0.907787144f,
+    0.909475464f, 0.911149875f, 0.912810311f, 0.914456712f, 0.916089014f, 0.917707157f, 0.919311079f, 0.920900721f,
+    0.922476022f, 0.924036922f, 0.925583365f, 0.92711529f, 0.92863264f, 0.930135359f, 0.931623389f, 0.933096675f,
+    0.934555161f, 0.935998792f, 0.937427514f, 0.938841273f, 0.940240016f, 0.94162369f, 0.942992243f, 0.944345624f,
+    0.945683782f, 0.947006665f, 0.948314225f, 0.949606413f, 0.950883179f, 0.952144475f, 0.953390254f, 0.95462047f,
+    0.955835075f, 0.957034024f, 0.958217272f, 0.959384775f, 0.960536488f, 0.961672368f, 0.962792372f, 0.963896458f,
+    0.964984585f, 0.966056711f, 0.967112797f, 0.968152802f, 0.969176687f, 0.970184415f, 0.971175945f, 0.972151243f,
+    0.97311027f, 0.974052991f, 0.97497937f, 0.975889372f, 0.976782963f, 0.97766011f, 0.978520779f, 0.979364937f,
+    0.980192554f, 0.981003598f, 0.981798039f, 0.982575846f, 0.98333699f, 0.984081443f, 0.984809177f, 0.985520163f,
+    0.986214376f, 0.98689179f, 0.987552378f, 0.988196116f, 0.98882298f, 0.989432946f, 0.990025991f, 0.990602092f,
+    0.991161229f, 0.99170338f, 0.992228524f, 0.992736642f, 0.993227715f, 0.993701725f, 0.994158652f, 0.994598481f,
+    0.995021195f, 0.995426777f, 0.995815212f, 0.996186487f, 0.996540586f, 0.996877497f, 0.997197206f, 0.997499703f,
+    0.997784974f, 0.998053011f, 0.998303802f, 0.998537338f, 0.99875361f, 0.998952611f, 0.999134332f, 0.999298767f,
+    0.99944591f, 0.999575755f, 0.999688297f, 0.999783532f, 0.999861457f, 0.999922068f, 0.999965363f, 0.999991341f,
+    1.0f
+};
+
+// Blackman: 0.42 - 0.5 cos(2 pi n / N) + 0.08 cos(4 pi n / N), n = 0..N/2 of N = WINDOW_TABLE_SIZE
+static const float blackmanTable[WINDOW_TABLE_HALF] = {
+    -1.38777878e-17f, 3.38850583e-06f, 1.35545761e-05f, 3.04998692e-05f, 5.42271483e-05f, 8.47402815e-05f, 0.00012204424f, 0.000166145098f,
+    0.000217050031f, 0.000274767314f, 0.000339306318f, 0.000410677512f, 0.000488892458f, 0.000573963807f, 0.0006659053f, 0.000764731761f,
+    0.000870459096f, 0.00098310429f, 0.0011026854f, 0.00122922156f, 0.00136273296f, 0.00150324085f, 0.00165076755f, 0.00180533642f,
+    0.00196697188f, 0.00213569936f, 0.00231154537f, 0.00249453741f, 0.00268470402f, 0.00288207476f, 0.00308668019f, 0.00329855188f,
+    0.0035177224f, 0.00374422529f, 0.0039780951f, 0.00421936732f, 0.00446807843f, 0.00472426586f, 0.00498796799f, 0.00525922414f,
+    0.00553807455f, 0.0058245604f, 0.00611872377f, 0.00642060764f, 0.0067302559f, 0.00704771331f, 0.00737302551f, 0.007706239f,
+    0.00804740112f, 0.00839656007f, 0.00875376488f, 0.00911906538f, 0.00949251222f, 0.00987415686f, 0.0102640515f, 0.0106622492f,
+    0.0110688037f, 0.0114837694f, 0.0119072018f, 0.0123391566f, 0.0127796906f, 0.0132288612f, 0.0136867264f, 0.014153345f,
+    0.0146287762f, 0.0151130803f, 0.0156063177f, 0.0161085499f, 0.0166198385f, 0.0171402462f, 0.0176698359f, 0.0182086712f,
+    0.0187568162f, 0.0193143355f, 0.0198812944f, 0.0204577584f, 0.0210437938f, 0.021639467f, 0.0222448451f, 0.0228599956f,
+    0.0234849865f, 0.0241198859f, 0.0247647625f, 0.0254196854f, 0.026084724f, 0.0267599479f, 0.0274454273f, 0.0281412324f,
+    0.0288474339f, 0.0295641027f, 0.0302913098f, 0.0310291267f, 0.0317776248f, 0.0325368761f, 0.0333069523f, 0.0340879257f,
+    0.0348798684f, 0.0356828529f, 0.0364969515f, 0.0373222369f, 0.0381587817f, 0.0390066585f, 0.0398659401f, 0.0407366992f,
+    0.0416190084f, 0.0425129406f, 0.0434185683f, 0.0443359641f, 0.0452652006f, 0.0462063501f, 0.0471594849f, 0.0481246773f,
+    0.0491019991f, 0.0500915222f, 0.0510933183f, 0.0521074587f, 0.0531340147f, 0.0541730572f, 0.0552246568f, 0.0562888839f,
+    0.0573658085f, 0.0584555005f, 0.0595580293f, 0.0606734637f, 0.0618018725f, 0.0629433239f, 0.0640978856f, 0.0652656252f,
+    0.0664466094f, 0.0676409047f, 0.068848577f, 0.0700696917f, 0.0713043137f, 0.0725525072f, 0.073814336f, 0.0750898632f,
+    0.0763791514f, 0.0776822623f, 0.0789992572f, 0.0803301967f, 0.0816751406f, 0.083034148f, 0.0844072775f, 0.0857945865f,
+    0.0871961322f, 0.0886119704f, 0.0900421567f, 0.0914867455f, 0.0929457903f, 0.0944193441f, 0.0959074587f, 0.0974101852f,
+    0.0989275736f, 0.100459673f, 0.102006532f, 0.103568198f, 0.105144716f, 0.106736133f, 0.108342492f, 0.109963836f,
+    0.111600209f, 0.11325165f, 0.114918201f, 0.116599899f, 0.118296783f, 0.120008889f, 0.121736252f, 0.123478908f,
+    0.125236889f, 0.127010227f, 0.128798953f, 0.130603096f, 0.132422684f, 0.134257745f, 0.136108304f, 0.137974386f,
+    0.139856013f, 0.141753207f, 0.143665989f, 0.145594378f, 0.147538391f, 0.149498044f, 0.151473353f, 0.153464332f,
+    0.155470991f, 0.157493341f, 0.159531393f, 0.161585152f, 0.163654627f, 0.16573982f, 0.167840736f, 0.169957377f,
+    0.172089741f, 0.174237829f, 0.176401636f, 0.178581159f, 0.180776392f, 0.182987326f, 0.185213952f, 0.18745626f,
+    0.189714237f, 0.191987869f, 0.19427714f, 0.196582032f, 0.198902527f, 0.201238604f, 0.20359024f, 0.205957412f,
+    0.208340092f, 0.210738255f, 0.21315187f, 0.215580907f, 0.218025332f, 0.220485113f, 0.222960211f, 0.22545059f,
+    0.227956209f, 0.230477027f, 0.233013002f, 0.235564087f, 0.238130236f, 0.240711401f, 0.243307531f, 0.245918574f,
+    0.248544476f, 0.251185181f, 0.253840632f, 0.256510769f, 0.25919553f, 0.261894854f, 0.264608674f, 0.267336924f,
+    0.270079536f, 0.272836439f, 0.27560756f, 0.278392827f, 0.281192162f, 0.284005488f, 0.286832726f, 0.289673793f,
+    0.292528607f, 0.295397083f, 0.298279132f, 0.301174668f, 0.304083597f, 0.307005829f, 0.309941269f, 0.31288982f,
+    0.315851385f, 0.318825863f, 0.321813152f, 0.324813149f, 0.327825749f, 0.330850844f, 0.333888325f, 0.336938082f,
+    0.34f, 0.343073966f, 0.346159864f, 0.349257574f, 0.352366978f, 0.355487953f, 0.358620375f, 0.361764119f,
+    0.364919059f, 0.368085065f, 0.371262005f, 0.374449749f, 0.377648161f, 0.380857106f, 0.384076445f, 0.387306039f,
+    0.390545748f, 0.393795427f, 0.397054933f, 0.400324119f, 0.403602837f, 0.406890938f, 0.410188269f, 0.413494678f,
+    0.41681001f, 0.420134109f, 0.423466817f, 0.426807974f, 0.430157419f, 0.433514989f, 0.43688052f, 0.440253846f,
+    0.443634798f, 0.447023209f, 0.450418908f, 0.453821721f, 0.457231477f, 0.460647998f, 0.46407111f, 0.467500633f,
+    0.470936389f, 0.474378195f, 0.477825871f, 0.48127923f, 0.48473809f, 0.488202262f, 0.491671559f, 0.495145792f,
+    0.49862477f, 0.5021083f, 0.50559619f, 0.509088244f, 0.512584268f, 0.516084063f, 0.519587432f, 0.523094175f,
+    0.52660409f, 0.530116977f, 0.533632632f, 0.537150851f, 0.540671428f, 0.544194157f, 0.54771883f, 0.551245239f,
+    0.554773174f, 0.558302423f, 0.561832776f, 0.56536402f, 0.568895941f, 0.572428323f, 0.575960953f, 0.579493612f,
+    0.583026084f, 0.58655815f, 0.590089592f, 0.593620189f, 0.59714972f, 0.600677965f, 0.6042047f, 0.607729703f,
+    0.61125275f, 0.614773616f, 0.618292076f, 0.621807905f, 0.625320877f, 0.628830763f, 0.632337336f, 0.63584037f,
+    0.639339633f, 0.642834898f, 0.646325935f, 0.649812513f, 0.653294402f, 0.656771372f, 0.660243189f, 0.663709623f,
+    0.667170442f, 0.670625413f, 0.674074302f, 0.677516879f, 0.680952907f, 0.684382156f, 0.687804389f, 0.691219375f,
+    0.694626878f, 0.698026665f, 0.7014185f, 0.70480215f, 0.708177381f, 0.711543957f, 0.714901645f, 0.718250209f,
+    0.721589416f, 0.724919031f, 0.72823882f, 0.731548549f, 0.734847984f, 0.73813689f, 0.741415035f, 0.744682185f,
+    0.747938106f, 0.751182567f, 0.754415334f, 0.757636175f, 0.760844858f, 0.764041153f, 0.767224826f, 0.770395649f,
+    0.773553391f, 0.776697821f, 0.779828711f, 0.782945832f, 0.786048955f, 0.789137854f, 0.792212301f, 0.795272069f,
+    0.798316934f, 0.801346669f, 0.804361051f, 0.807359856f, 0.810342861f, 0.813309844f, 0.816260584f, 0.81919486f,
+    0.822112452f, 0.825013143f, 0.827896713f, 0.830762947f, 0.833611628f, 0.836442541f, 0.839255473f, 0.84205021f,
+    0.84482654f, 0.847584253f, 0.850323138f, 0.853042988f, 0.855743595f, 0.858424752f, 0.861086254f, 0.863727898f,
+    0.866349481f, 0.868950801f, 0.871531658f, 0.874091854f, 0.87663119f, 0.879149471f, 0.881646503f, 0.884122091f,
+    0.886576044f, 0.889008171f, 0.891418283f, 0.893806193f, 0.896171715f, 0.898514664f, 0.900834857f, 0.903132112f,
+    0.905406251f, 0.907657094f, 0.909884466f, 0.91208819f, 0.914268095f, 0.916424008f, 0.91855576f, 0.920663183f,
+    0.922746109f, 0.924804376f, 0.926837819f, 0.928846278f, 0.930829594f, 0.93278761f, 0.934720169f, 0.93662712f,
+    0.938508309f, 0.940363587f, 0.942192807f, 0.943995822f, 0.945772489f, 0.947522667f, 0.949246214f, 0.950942993f,
+    0.952612869f, 0.954255707f, 0.955871377f, 0.957459748f, 0.959020693f, 0.960554086f, 0.962059805f, 0.963537728f,
+    0.964987737f, 0.966409714f, 0.967803545f, 0.969169118f, 0.970506322f, 0.971815049f, 0.973095195f, 0.974346655f,
+    0.975569328f, 0.976763115f, 0.97792792f, 0.979063649f, 0.980170208f, 0.98124751f, 0.982295466f, 0.983313991f,
+    0.984303003f, 0.985262421f, 0.986192168f, 0.987092167f, 0.987962346f, 0.988802635f, 0.989612964f, 0.990393267f,
+    0.991143482f, 0.991863547f, 0.992553403f, 0.993212995f, 0.993842268f, 0.994441171f, 0.995009655f, 0.995547675f,
+    0.996055186f, 0.996532146f, 0.996978517f, 0.997394263f, 0.997779349f, 0.998133744f, 0.998457419f, 0.998750348f,
+    0.999012506f, 0.999243873f, 0.999444429f, 0.999614158f, 0.999753046f, 0.999861082f, 0.999938256f, 0.999984564f,
+    1.0f
+};
+
+// Hann: 0.5 - 0.5 cos(2 pi n / N), n = 0..N/2 of N = WINDOW_TABLE_SIZE
+static const float hannTable[WINDOW_TABLE_HALF] = {
+    0.0f, 9.4123587e-06f, 3.76490804e-05f, 8.47091021e-05f, 0.000150590652f, 0.000235291249f, 0.000338807706f, 0.000461136124f,
+    0.000602271897f, 0.000762209713f, 0.00094094355f, 0.00113846668f, 0.00135477166f, 0.00158985035f, 0.00184369391f, 0.00211629277f,
+    0.00240763666f, 0.00271771463f, 0.003046515f, 0.00339402538f, 0.0037602327f, 0.00414512317f, 0.00454868229f, 0.00497089487f,
+    0.00541174502f, 0.00587121613f, 0.00634929092f, 0.00684595138f, 0.00736117881f, 0.00789495381f, 0.00844725628f, 0.00901806545f,
+    0.0096073598f, 0.0102151172f, 0.0108413146f, 0.0114859287f, 0.012148935f, 0.0128303086f, 0.0135300239f, 0.0142480545f,
+    0.0149843734f, 0.0157389529f, 0.0165117645f, 0.0173027792f, 0.0181119671f, 0.0189392979f, 0.0197847403f, 0.0206482626f,
+    0.0215298321f, 0.0224294158f, 0.0233469798f, 0.0242824895f, 0.0252359097f, 0.0262072045f, 0.0271963373f, 0.0282032709f,
+    0.0292279674f, 0.0302703882f, 0.031330494f, 0.032408245f, 0.0335036006f, 0.0346165195f, 0.0357469598f, 0.0368948789f,
+    0.0380602337f, 0.0392429803f, 0.0404430742f, 0.04166047f, 0.0428951221f, 0.044146984f, 0.0454160085f, 0.0467021477f,
+    0.0480053534f, 0.0493255765f, 0.0506627672f, 0.0520168751f, 0.0533878494f, 0.0547756384f, 0.0561801898f, 0.0576014508f,
+    0.0590393678f, 0.0604938868f, 0.0619649529f, 0.0634525108f, 0.0649565044f, 0.0664768772f, 0.0680135719f, 0.0695665307f,
+    0.071135695f, 0.0727210058f, 0.0743224034f, 0.0759398276f, 0.0775732174f, 0.0792225113f, 0.0808876472f, 0.0825685625f,
+    0.0842651938f, 0.0859774774f, 0.0877053486f, 0.0894487425f, 0.0912075934f, 0.0929818351f, 0.0947714009f, 0.0965762232f,
+    0.0983962343f, 0.100231365f, 0.102081548f, 0.103946711f, 0.105826786f, 0.107721701f, 0.109631386f, 0.111555767f,
+    0.113494773f, 0.115448331f, 0.117416367f, 0.119398807f, 0.121395577f, 0.1234066f, 0.125431803f, 0.127471107f,
+    0.129524437f, 0.131591716f, 0.133672864f, 0.135767805f, 0.137876459f, 0.139998746f, 0.142134587f, 0.144283902f,
+    0.146446609f, 0.148622628f, 0.150811875f, 0.15301427f, 0.155229728f, 0.157458166f, 0.159699501f, 0.161953648f,
+    0.164220523f, 0.166500039f, 0.168792111f, 0.171096653f, 0.173413579f, 0.175742799f, 0.178084229f, 0.180437778f,
+    0.182803358f, 0.185180881f, 0.187570256f, 0.189971394f, 0.192384205f, 0.194808597f, 0.197244479f, 0.19969176f,
+    0.202150348f, 0.204620149f, 0.207101071f, 0.209593021f, 0.212095904f, 0.214609627f, 0.217134095f, 0.219669212f,
+    0.222214883f, 0.224771014f, 0.227337506f, 0.229914264f, 0.23250119f, 0.235098188f, 0.237705159f, 0.240322005f,
+    0.242948628f, 0.245584929f, 0.248230808f, 0.250886167f, 0.253550904f, 0.25622492f, 0.258908114f, 0.261600385f,
+    0.264301632f, 0.267011752f, 0.269730645f, 0.272458206f, 0.275194335f, 0.277938928f, 0.280691881f, 0.283453091f,
+    0.286222453f, 0.288999865f, 0.29178522f, 0.294578414f, 0.297379343f, 0.3001879f, 0.30300398f, 0.305827477f,
+    0.308658284f, 0.311496295f, 0.314341403f, 0.317193501f, 0.320052482f, 0.322918237f, 0.32579066f, 0.328669641f,
+    0.331555073f, 0.334446847f, 0.337344854f, 0.340248985f, 0.34315913f, 0.34607518f, 0.348997025f, 0.351924556f,
+    0.354857661f, 0.357796231f, 0.360740155f, 0.363689322f, 0.366643621f, 0.369602941f, 0.37256717f, 0.375536197f,
+    0.37850991f, 0.381488197f, 0.384470946f, 0.387458044f, 0.39044938f, 0.39344484f, 0.396444312f, 0.399447683f,
+    0.402454839f, 0.405465668f, 0.408480056f, 0.41149789f, 0.414519056f, 0.41754344f, 0.420570928f, 0.423601407f,
+    0.426634763f, 0.42967088f, 0.432709646f, 0.435750945f, 0.438794662f, 0.441840685f, 0.444888896f, 0.447939183f,
+    0.45099143f, 0.454045522f, 0.457101344f, 0.460158781f, 0.463217718f, 0.46627804f, 0.469339632f, 0.472402378f,
+    0.475466163f, 0.478530872f, 0.481596389f, 0.484662598f, 0.487729386f, 0.490796635f, 0.493864231f, 0.496932058f,
+    0.5f, 0.503067942f, 0.506135769f, 0.509203365f, 0.512270614f, 0.515337402f, 0.518403611f, 0.521469128f,
+    0.524533837f, 0.527597622f, 0.530660368f, 0.53372196f, 0.536782282f, 0.539841219f, 0.542898656f, 0.545954478f,
+    0.54900857f, 0.552060817f, 0.555111104f, 0.558159315f, 0.561205338f, 0.564249055f, 0.567290354f, 0.57032912f,
+    0.573365237f, 0.576398593f, 0.579429072f, 0.58245656f, 0.585480944f, 0.58850211f, 0.591519944f, 0.594534332f,
+    0.597545161f, 0.600552317f, 0.603555688f, 0.60655516f, 0.60955062f, 0.612541956f, 0.615529054f, 0.618511803f,
+    0.62149009f, 0.624463803f, 0.62743283f, 0.630397059f, 0.633356379f, 0.636310678f, 0.639259845f, 0.642203769f,
+    0.645142339f, 0.648075444f, 0.651002975f, 0.65392482f, 0.65684087f, 0.659751015f, 0.662655146f, 0.665553153f,
+    0.668444927f, 0.671330359f, 0.67420934f, 0.677081763f, 0.679947518f, 0.682806499f, 0.685658597f, 0.688503705f,
+    0.691341716f, 0.694172523f, 0.69699602f, 0.6998121f, 0.702620657f, 0.705421586f, 0.70821478f, 0.711000135f,
+    0.713777547f, 0.716546909f, 0.719308119f, 0.722061072f, 0.724805665f, 0.727541794f, 0.730269355f, 0.732988248f,
+    0.735698368f, 0.738399615f, 0.741091886f, 0.74377508f, 0.746449096f, 0.749113833f, 0.751769192f, 0.754415071f,
+    0.757051372f, 0.759677995f, 0.762294841f, 0.764901812f, 0.76749881f, 0.770085736f, 0.772662494f, 0.775228986f,
+    0.777785117f, 0.780330788f, 0.782865905f, 0.785390373f, 0.787904096f, 0.790406979f, 0.792898929f, 0.795379851f,
+    0.797849652f, 0.80030824f, 0.802755521f, 0.805191403f, 0.807615795f, 0.810028606f, 0.812429744f, 0.814819119f,
+    0.817196642f, 0.819562222f, 0.821915771f, 0.824257201f, 0.826586421f, 0.828903347f, 0.831207889f, 0.833499961f,
+    0.835779477f, 0.838046352f, 0.840300499f, 0.842541834f, 0.844770272f, 0.84698573f, 0.849188125f, 0.851377372f,
+    0.853553391f, 0.855716098f, 0.857865413f, 0.860001254f, 0.862123541f, 0.864232195f, 0.866327136f, 0.868408284f,
+    0.870475563f, 0.872528893f, 0.874568197f, 0.8765934f, 0.878604423f, 0.880601193f, 0.882583633f, 0.884551669f,
+    0.886505227f, 0.888444233f, 0.890368614f, 0.892278299f, 0.894173214f, 0.896053289f, 0.897918452f, 0.899768635f,
+    0.901603766f, 0.903423777f, 0.905228599f, 0.907018165f, 0.908792407f, 0.910551257f, 0.912294651f, 0.914022523f,
+    0.915734806f, 0.917431437f, 0.919112353f, 0.920777489f, 0.922426783f, 0.924060172f, 0.925677597f, 0.927278994f,
+    0.928864305f, 0.930433469f, 0.931986428f, 0.933523123f, 0.935043496f, 0.936547489f, 0.938035047f, 0.939506113f,
+    0.940960632f, 0.942398549f, 0.94381981f, 0.945224362f, 0.946612151f, 0.947983125f, 0.949337233f, 0.950674424f,
+    0.951994647f, 0.953297852f, 0.954583992f, 0.955853016f, 0.957104878f, 0.95833953f, 0.959556926f, 0.96075702f,
+    0.961939766f, 0.963105121f, 0.96425304f, 0.965383481f, 0.966496399f, 0.967591755f, 0.968669506f, 0.969729612f,
+    0.970772033f, 0.971796729f, 0.972803663f, 0.973792796f, 0.97476409f, 0.97571751f, 0.97665302f, 0.977570584f,
+    0.978470168f, 0.979351737f, 0.98021526f, 0.981060702f, 0.981888033f, 0.982697221f, 0.983488236f, 0.984261047f,
+    0.985015627f, 0.985751945f, 0.986469976f, 0.987169691f, 0.987851065f, 0.988514071f, 0.989158685f, 0.989784883f,
+    0.99039264f, 0.990981935f, 0.991552744f, 0.992105046f, 0.992638821f, 0.993154049f, 0.993650709f, 0.994128784f,
+    0.994588255f, 0.995029105f, 0.995451318f, 0.995854877f, 0.996239767f, 0.996605975f, 0.996953485f, 0.997282285f,
+    0.997592363f, 0.997883707f, 0.998156306f, 0.99841015f, 0.998645228f, 0.998861533f, 0.999059056f, 0.99923779f,
+    0.999397728f, 0.999538864f, 0.999661192f, 0.999764709f, 0.999849409f, 0.999915291f, 0.999962351f, 0.999990588f,
+    1.0f
+};
+
+// Kaiser, beta = 8.6: I0(beta sqrt(1 - (2n/N - 1)^2)) / I0(beta), n = 0..N/2 of N = WINDOW_TABLE_SIZE
+static const float kaiserTable[WINDOW_TABLE_HALF] = {
+    0.001332514f, 0.00143041132f, 0.00153165995f, 0.00163632407f, 0.0017444684f, 0.00185615822f, 0.00197145939f, 0.00209043831f,
+    0.00221316193f, 0.00233969775f, 0.0024701138f, 0.00260447866f, 0.00274286146f, 0.00288533183f, 0.00303195995f, 0.00318281651f,
+    0.00333797271f, 0.00349750028f, 0.00366147145f, 0.00382995895f, 0.00400303601f, 0.00418077634f, 0.00436325416f, 0.00455054415f,
+    0.00474272146f, 0.00493986174f, 0.00514204108f, 0.00534933602f, 0.00556182357f, 0.00577958118f, 0.00600268673f, 0.00623121854f,
+    0.00646525535f, 0.00670487632f, 0.00695016101f, 0.0072011894f, 0.00745804186f, 0.00772079915f, 0.00798954241f, 0.00826435315f,
+    0.00854531325f, 0.00883250494f, 0.00912601082f, 0.00942591381f, 0.00973229718f, 0.0100452445f, 0.0103648397f, 0.010691167f,
+    0.0110243108f, 0.0113643561f, 0.0117113878f, 0.0120654913f, 0.0124267522f, 0.0127952565f, 0.0131710902f, 0.0135543396f,
+    0.0139450913f, 0.0143434322f, 0.0147494491f, 0.0151632293f, 0.0155848602f, 0.0160144292f, 0.016452024f, 0.0168977326f,
+    0.0173516429f, 0.017813843f, 0.0182844212f, 0.0187634658f, 0.0192510653f, 0.0197473081f, 0.020252283f, 0.0207660785f,
+    0.0212887834f, 0.0218204865f, 0.0223612765f, 0.0229112422f, 0.0234704725f, 0.0240390561f, 0.0246170818f, 0.0252046384f,
+    0.0258018146f, 0.026408699f, 0.0270253802f, 0.0276519466f, 0.0282884867f, 0.0289350888f, 0.029591841f, 0.0302588313f,
+    0.0309361477f, 0.0316238778f, 0.0323221092f, 0.0330309293f, 0.0337504252f, 0.0344806839f, 0.0352217921f, 0.0359738362f,
+    0.0367369025f, 0.037511077f, 0.0382964453f, 0.0390930928f, 0.0399011046f, 0.0407205654f, 0.0415515595f, 0.0423941712f,
+    0.043248484f, 0.0441145812f, 0.0449925458f, 0.0458824603f, 0.0467844067f, 0.0476984668f, 0.0486247215f, 0.0495632518f,
+    0.0505141378f, 0.0514774593f, 0.0524532955f, 0.0534417252f, 0.0544428264f, 0.0554566768f, 0.0564833535f, 0.0575229329f,
+    0.058575491f, 0.0596411028f, 0.0607198431f, 0.0618117859f, 0.0629170045f, 0.0640355715f, 0.0651675589f, 0.0663130379f,
+    0.0674720792f, 0.0686447525f, 0.069831127f, 0.0710312708f, 0.0722452516f, 0.0734731362f, 0.0747149904f, 0.0759708793f,
+    0.0772408674f, 0.078525018f, 0.0798233936f, 0.081136056f, 0.0824630661f, 0.0838044836f, 0.0851603676f, 0.0865307762f,
+    0.0879157663f, 0.0893153942f, 0.090729715f, 0.0921587828f, 0.0936026508f, 0.0950613711f, 0.0965349948f, 0.0980235719f,
+    0.0995271514f, 0.101045781f, 0.102579508f, 0.104128378f, 0.105692435f, 0.107271723f, 0.108866284f, 0.110476159f,
+    0.112101388f, 0.113742011f, 0.115398063f, 0.117069583f, 0.118756605f, 0.120459162f, 0.122177288f, 0.123911014f,
+    0.12566037f, 0.127425384f, 0.129206085f, 0.131002498f, 0.132814649f, 0.13464256f, 0.136486253f, 0.138345751f,
+    0.140221071f, 0.142112233f, 0.144019252f, 0.145942144f, 0.147880922f, 0.1498356f, 0.151806187f, 0.153792693f,
+    0.155795127f, 0.157813494f, 0.1598478f, 0.161898048f, 0.16396424f, 0.166046376f, 0.168144456f, 0.170258477f,
+    0.172388434f, 0.174534322f, 0.176696134f, 0.178873861f, 0.181067491f, 0.183277014f, 0.185502416f, 0.18774368f,
+    0.190000791f, 0.19227373f, 0.194562476f, 0.196867008f, 0.199187302f, 0.201523333f, 0.203875075f, 0.206242498f,
+    0.208625573f, 0.211024268f, 0.213438548f, 0.21586838f, 0.218313725f, 0.220774546f, 0.223250801f, 0.225742449f,
+    0.228249446f, 0.230771746f, 0.233309302f, 0.235862064f, 0.238429982f, 0.241013003f, 0.243611074f, 0.246224136f,
+    0.248852134f, 0.251495007f, 0.254152693f, 0.256825129f, 0.259512252f, 0.262213992f, 0.264930283f, 0.267661053f,
+    0.270406231f, 0.273165742f, 0.275939511f, 0.27872746f, 0.28152951f, 0.28434558f, 0.287175587f, 0.290019445f,
+    0.29287707f, 0.295748371f, 0.29863326f, 0.301531644f, 0.30444343f, 0.307368521f, 0.310306822f, 0.313258232f,
+    0.31622265f, 0.319199975f, 0.322190102f, 0.325192924f, 0.328208333f, 0.33123622f, 0.334276473f, 0.337328979f,
+    0.340393622f, 0.343470287f, 0.346558853f, 0.349659202f, 0.35277121f, 0.355894754f, 0.359029708f, 0.362175945f,
+    0.365333336f, 0.36850175f, 0.371681055f, 0.374871116f, 0.378071797f, 0.381282962f, 0.38450447f, 0.387736181f,
+    0.390977952f, 0.394229638f, 0.397491095f, 0.400762173f, 0.404042725f, 0.407332598f, 0.410631642f, 0.4139397f,
+    0.417256619f, 0.42058224f, 0.423916404f, 0.427258952f, 0.430609721f, 0.433968547f, 0.437335266f, 0.440709711f,
+    0.444091714f, 0.447481105f, 0.450877713f, 0.454281365f, 0.457691887f, 0.461109105f, 0.46453284f, 0.467962915f,
+    0.471399149f, 0.474841362f, 0.47828937f, 0.481742991f, 0.485202038f, 0.488666325f, 0.492135663f, 0.495609865f,
+    0.499088738f, 0.502572092f, 0.506059732f, 0.509551465f, 0.513047095f, 0.516546425f, 0.520049257f, 0.523555392f,
+    0.527064629f, 0.530576767f, 0.534091603f, 0.537608933f, 0.541128553f, 0.544650256f, 0.548173836f, 0.551699083f,
+    0.555225791f, 0.558753747f, 0.562282741f, 0.565812561f, 0.569342994f, 0.572873826f, 0.576404841f, 0.579935826f,
+    0.583466562f, 0.586996832f, 0.590526418f, 0.594055101f, 0.597582661f, 0.601108877f, 0.604633528f, 0.608156392f,
+    0.611677245f, 0.615195865f, 0.618712028f, 0.622225508f, 0.625736079f, 0.629243517f, 0.632747594f, 0.636248083f,
+    0.639744757f, 0.643237387f, 0.646725745f, 0.650209601f, 0.653688727f, 0.657162891f, 0.660631864f, 0.664095415f,
+    0.667553313f, 0.671005326f, 0.674451223f, 0.677890772f, 0.68132374f, 0.684749895f, 0.688169005f, 0.691580837f,
+    0.694985157f, 0.698381732f, 0.70177033f, 0.705150717f, 0.70852266f, 0.711885925f, 0.715240278f, 0.718585487f,
+    0.721921319f, 0.725247539f, 0.728563915f, 0.731870214f, 0.735166202f, 0.738451648f, 0.741726318f, 0.744989979f,
+    0.748242401f, 0.751483351f, 0.754712598f, 0.75792991f, 0.761135056f, 0.764327806f, 0.76750793f, 0.770675198f,
+    0.773829381f, 0.77697025f, 0.780097576f, 0.783211132f, 0.786310691f, 0.789396025f, 0.79246691f, 0.795523118f,
+    0.798564426f, 0.801590609f, 0.804601444f, 0.807596708f, 0.810576179f, 0.813539635f, 0.816486856f, 0.819417623f,
+    0.822331717f, 0.825228919f, 0.828109013f, 0.830971783f, 0.833817013f, 0.836644489f, 0.839453997f, 0.842245326f,
+    0.845018265f, 0.847772602f, 0.85050813f, 0.853224639f, 0.855921924f, 0.858599778f, 0.861257998f, 0.863896379f,
+    0.86651472f, 0.869112819f, 0.871690478f, 0.874247498f, 0.876783682f, 0.879298834f, 0.881792761f, 0.884265268f,
+    0.886716166f, 0.889145263f, 0.891552372f, 0.893937304f, 0.896299876f, 0.898639901f, 0.900957199f, 0.903251587f,
+    0.905522887f, 0.90777092f, 0.90999551f, 0.912196484f, 0.914373667f, 0.91652689f, 0.918655981f, 0.920760774f,
+    0.922841102f, 0.924896802f, 0.92692771f, 0.928933666f, 0.930914511f, 0.932870088f, 0.934800242f, 0.93670482f,
+    0.938583669f, 0.940436642f, 0.942263589f, 0.944064366f, 0.945838829f, 0.947586835f, 0.949308247f, 0.951002924f,
+    0.952670734f, 0.95431154f, 0.955925213f, 0.957511622f, 0.95907064f, 0.960602143f, 0.962106006f, 0.963582109f,
+    0.965030333f, 0.966450562f, 0.96784268f, 0.969206576f, 0.97054214f, 0.971849263f, 0.97312784f, 0.974377768f,
+    0.975598946f, 0.976791274f, 0.977954657f, 0.979088999f, 0.980194209f, 0.981270198f, 0.982316878f, 0.983334164f,
+    0.984321973f, 0.985280225f, 0.986208843f, 0.98710775f, 0.987976874f, 0.988816143f, 0.989625491f, 0.99040485f,
+    0.991154157f, 0.991873351f, 0.992562373f, 0.993221168f, 0.993849682f, 0.994447862f, 0.995015661f, 0.995553032f,
+    0.996059931f, 0.996536317f, 0.996982151f, 0.997397396f, 0.997782019f, 0.998135987f, 0.998459273f, 0.998751849f,
+    0.999013693f, 0.999244781f, 0.999445096f, 0.999614621f, 0.999753342f, 0.999861249f, 0.999938331f, 0.999984582f,
+    1.0f
+};
+const float* windowTable(WindowShape shape) {
+    switch (shape) {
+        case WINDOW_SHAPE_HAMMING:  return hammingTable;
+        case WINDOW_SHAPE_BLACKMAN: return blackmanTable;
+        case WINDOW_SHAPE_HANN:     return hannTable;
+        case WINDOW_SHAPE_KAISER:   return kaiserTable;
+        default:                    return nullptr;
+    }
+}
+
+float besselI0(float x) {
+    // Abramowitz & Stegun 9.8.1 / 9.8.2: fixed cost instead of a series
+    float ax = fabsf(x);
+    if (ax <= 3.75f) {
+        float t = (x / 3.75f) * (x / 3.75f);
+        return 1.0f + t * (3.5156229f + t * (3.0899424f + t * (1.2067492f +
+               t * (0.2659732f + t * (0.0360768f + t * 0.0045813f)))));
+    }
+
+    float t = 3.75f / ax;
+    float poly = 0.39894228f + t * (0.01328592f + t * (0.00225319f + t * (-0.00157565f +
+                 t * (0.00916281f + t * (-0.02057706f + t * (0.02635537f +
+                 t * (-0.01647633f + t * 0.00392377f)))))));
+    return expf(ax) / sqrtf(ax) * poly;
+}
+
+bool buildWindow(WindowShape shape, uint16_t size, float beta, float gain,
+                 float* out, WindowCorrection& correction) {
+    if (!out || size < 2 || size > WINDOW_TABLE_SIZE || (size & (size - 1))) return false;
+
+    const float* table = windowTable(shape);
+    bool customKaiser = shape == WINDOW_SHAPE_KAISER && fabsf(beta - KAISER_DEFAULT_BETA) > 1e-3f;
+    float invI0 = customKaiser ? 1.0f / besselI0(beta) : 0.0f;
+    uint16_t stride = WINDOW_TABLE_SIZE / size;
+    uint16_t half = size / 2;
+
+    // Corrections describe the unscaled window
+    float sum = 0.0f, sumSquares = 0.0f;
+    for (uint16_t n = 0; n <= half; n++) {
+        float w;
+        if (customKaiser) {
+            float r = 2.0f * n / size - 1.0f;
+            w = besselI0(beta * sqrtf(fmaxf(0.0f, 1.0f - r * r))) * invI0;
+        } else {
+            w = table ? table[n * stride] : 1.0f;
+        }
+
+        out[n] = w * gain;
+        float copies = 1.0f;
+        if (n > 0 && n < half) {
+            out[size - n] = w * gain;
+            copies = 2.0f;
+        }
+        sum += copies * w;
+        sumSquares += copies * w * w;
+    }
+
+    correction.coherentGain = sum / size;
+    correction.enbw = size * sumSquares / (sum * sum);
+    correction.toneScale = (2.0f / sum) * (2.0f / sum);
+    return true;
+}
@@ -0,0 +1,50 @@
+#ifndef WINDOW_TABLES_H
+#define WINDOW_TABLES_H
+
+#include <stdint.h>
+
+// ========================================
+// WindowTables - Precomputed analysis windows and their corrections
+// Periodic (DFT-even) windows are tabulated once in flash at the largest
+// FFT size; every smaller power-of-two size strides through the same
+// half table, so changing size or type never evaluates cos() or I0()
+// on the device. Only a Kaiser with a non-default beta is computed, with
+// a polynomial I0. Hardware independent.
+// ========================================
+
+#define WINDOW_TABLE_SIZE      1024                      // Largest supported frame
+#define WINDOW_TABLE_HALF      (WINDOW_TABLE_SIZE / 2 + 1)
+#define KAISER_DEFAULT_BETA    8.6f                      // Tabulated Kaiser (~-90 dB sidelobes)
+
+// Window shapes available as tables
+enum WindowShape : uint8_t {
+    WINDOW_SHAPE_RECTANGULAR,
+    WINDOW_SHAPE_HAMMING,
+    WINDOW_SHAPE_BLACKMAN,
+    WINDOW_SHAPE_HANN,
+    WINDOW_SHAPE_KAISER
+};
+
+// Scale factors that make levels independent of the window.
+// A sine of amplitude A gives |X|^2 = (A * sum(w) / 2)^2 at its bin, and
+// white noise of variance s^2 gives s^2 * sum(w^2) per bin.
+struct WindowCorrection {
+    float coherentGain;   // sum(w) / N
+    float enbw;           // Equivalent noise bandwidth in bins: N * sum(w^2) / sum(w)^2
+    float toneScale;      // (2 / sum(w))^2: |X|^2 -> squared peak amplitude of a tone
+};
+
+// Writes a periodic window of size (power of two, 2..WINDOW_TABLE_SIZE)
+// scaled by gain, and its corrections. beta only matters for Kaiser; the
+// default comes straight from the table. Returns false for unsupported sizes.
+bool buildWindow(WindowShape shape, uint16_t size, float beta, float gain,
+                 float* out, WindowCorrection& correction);
+
+// Zeroth-order modified Bessel function of the first kind; polynomial
+// approximation, about 1e-6 relative error in float
+float besselI0(float x);
+
+// Flash table for a shape (WINDOW_TABLE_HALF entries), null for rectangular
+const float* windowTable(WindowShape shape);
+
+#endif // WINDOW_TABLES_H
@@ -0,0 +1,224 @@
+#include "ZoomFFT.h"
+#include "DDSGenerator.h"
+#include <math.h>
+
+ZoomFFT::ZoomFFT() :
+    sampleRate(0),
+    centerFrequency(0),
+    decimation(ZOOM_MIN_DECIMATION),
+    cicRatio(1),
+    frameSize(0),
+    configured(false),
+    ncoPhase(0),
+    ncoIncrement(0),
+    cicPhase(0),
+    cicScale(1.0f),
+    firIndex(0),
+    firPhase(false),
+    ringI(nullptr),
+    ringQ(nullptr),
+    ringHead(0),
+    ringFilled(0),
+    newSamples(0),
+    droop(nullptr)
+{
+    DDSGenerator::initSineTable();   // NCO shares the generator's sine table
+    designFir();
+}
+
+ZoomFFT::~ZoomFFT() {
+    release();
+}
+
+bool ZoomFFT::configure(uint32_t rate, float centerHz, uint8_t factor, uint16_t size) {
+    if (rate == 0 || size < 8 || size > ZOOM_MAX_FRAME || (size & (size - 1))) return false;
+    if (factor < ZOOM_MIN_DECIMATION || factor > ZOOM_MAX_DECIMATION || (factor & (factor - 1))) return false;
+
+    // Buffers only change with the frame size
+    if (size != frameSize || !ringI) {
+        release();
+        ringI = new float[size];
+        ringQ = new float[size];
+        droop = new float[size / 2];
+        if (!ringI || !ringQ || !droop) {
+            release();
+            return false;
+        }
+    }
+
+    sampleRate = rate;
+    frameSize = size;
+    decimation = factor;
+    cicRatio = factor / 2;
+
+    // Keep the displayed span inside 0..Nyquist
+    float halfSpan = getOutputRate() / 4;
+    if (centerHz < halfSpan) centerHz = halfSpan;
+    if (centerHz > rate / 2.0f - halfSpan) centerHz = rate / 2.0f - halfSpan;
+    centerFrequency = centerHz;
+    ncoIncrement = (uint32_t)((double)centerHz * 4294967296.0 / rate);
+
+    float gain = 1.0f;
+    for (uint8_t s = 0; s < ZOOM_CIC_ORDER; s++) gain *= cicRatio;
+    cicScale = 1.0f / (gain * ZOOM_MIXER_GAIN);
+
+    buildDroopTable();
+    configured = true;
+    reset();
+    return true;
+}
+
+void ZoomFFT::release() {
+    if (ringI) {
+        delete[] ringI;
+        ringI = nullptr;
+    }
+    if (ringQ) {
+        delete[] ringQ;
+        ringQ = nullptr;
+    }
+    if (droop) {
+        delete[] droop;
+        droop = nullptr;
+    }
+    frameSize = 0;
+    configured = false;
+}
+
+void ZoomFFT::reset() {
+    ncoPhase = 0;
+    for (uint8_t s = 0; s < ZOOM_CIC_ORDER; s++) {
+        integrI[s] = integrQ[s] = 0;
+        combI[s] = combQ[s] = 0;
+    }
+    cicPhase = 0;
+    for (uint8_t t = 0; t < ZOOM_FIR_TAPS; t++) {
+        firI[t] = firQ[t] = 0.0f;
+    }
+    firIndex = 0;
+    firPhase = false;
+    ringHead = 0;
+    ringFilled = 0;
+    newSamples = 0;
+}
+
+void ZoomFFT::designFir() {
+    // Blackman-windowed sinc, cutoff at a quarter of the FIR input rate.
+    // Passband is the central half of the output band, so the wide
+    // transition region never reaches the display.
+    const int16_t mid = ZOOM_FIR_TAPS / 2;
+    float sum = 0.0f;
+    for (int16_t n = 0; n < ZOOM_FIR_TAPS; n++) {
+        int16_t k = n - mid;
+        float sinc = (k == 0) ? 0.5f : sinf(0.5f * M_PI * k) / (M_PI * k);
+        float w = 0.42f - 0.5f * cosf(2.0f * M_PI * n / (ZOOM_FIR_TAPS - 1)) +
+                  0.08f * cosf(4.0f * M_PI * n / (ZOOM_FIR_TAPS - 1));
+        firTaps[n] = sinc * w;
+        sum += firTaps[n];
+    }
+    for (int16_t n = 0; n < ZOOM_FIR_TAPS; n++) {
+        firTaps[n] /= sum;
+    }
+}
+
+void ZoomFFT::buildDroopTable() {
+    // CIC magnitude |sin(pi f R / fs) / (R sin(pi f / fs))|^N at each bin offset
+    uint16_t bins = frameSize / 2;
+    float binWidth = getBinWidth();
+    for (uint16_t j = 0; j < bins; j++) {
+        float f = ((int32_t)j - (int32_t)(frameSize / 4)) * binWidth;
+        float x = M_PI * f / sampleRate;
+        float h = 1.0f;
+        if (cicRatio > 1 && fabsf(x) > 1e-9f) {
+            h = sinf(x * cicRatio) / (cicRatio * sinf(x));
+        }
+        float h2 = 1.0f;
+        for (uint8_t s = 0; s < ZOOM_CIC_ORDER; s++) h2 *= h * h;
+        droop[j] = (h2 > 1e-6f) ? 1.0f / h2 : 1e6f;
+    }
+}
+
+bool ZoomFFT::pushFir(float i, float q) {
+    firI[firIndex] = i;
+    firQ[firIndex] = q;
+    firIndex = (firIndex + 1 == ZOOM_FIR_TAPS) ? 0 : firIndex + 1;
+
+    // Only every second output is needed
+    firPhase = !firPhase;
+    if (firPhase) return false;
+
+    float accI = 0.0f, accQ = 0.0f;
+    uint8_t idx = firIndex;
+    for (uint8_t t = 0; t < ZOOM_FIR_TAPS; t++) {
+        accI += firTaps[t] * firI[idx];
+        accQ += firTaps[t] * firQ[idx];
+        idx = (idx + 1 == ZOOM_FIR_TAPS) ? 0 : idx + 1;
+    }
+
+    ringI[ringHead] = accI;
+    ringQ[ringHead] = accQ;
+    ringHead = (ringHead + 1) & (frameSize - 1);
+    if (ringFilled < frameSize) ringFilled++;
+    if (newSamples < frameSize) newSamples++;
+    return true;
+}
+
+uint32_t ZoomFFT::process(const int16_t* input, uint32_t count) {
+    if (!configured || !input) return 0;
+
+    uint32_t produced = 0;
+
+    for (uint32_t n = 0; n < count; n++) {
+        // Mix to baseband: x * e^(-j w n)
+        float x = input[n] * ZOOM_MIXER_GAIN;
+        float c = DDSGenerator::sine(ncoPhase + 0x40000000UL);
+        float s = DDSGenerator::sine(ncoPhase);
+        ncoPhase += ncoIncrement;
+
+        int32_t i = (int32_t)lrintf(x * c);
+        int32_t q = (int32_t)lrintf(-x * s);
+
+        // CIC integrators at the input rate
+        for (uint8_t st = 0; st < ZOOM_CIC_ORDER; st++) {
+            i = integrI[st] = (int32_t)((uint32_t)integrI[st] + (uint32_t)i);
+            q = integrQ[st] = (int32_t)((uint32_t)integrQ[st] + (uint32_t)q);
+        }
+
+        if (++cicPhase < cicRatio) continue;
+        cicPhase = 0;
+
+        // Combs at the CIC output rate
+        for (uint8_t st = 0; st < ZOOM_CIC_ORDER; st++) {
+            int32_t di = (int32_t)((uint32_t)i - (uint32_t)combI[st]);
+            int32_t dq = (int32_t)((uint32_t)q - (uint32_t)combQ[st]);
+            combI[st] = i;
+            combQ[st] = q;
+            i = di;
+            q = dq;
+        }
+
+        if (pushFir(i * cicScale, q * cicScale)) produced++;
+    }
+
+    return produced;
+}
+
+void ZoomFFT::readFrame(float* iq, const float* window, float gain) {
+    // ringHead is the oldest sample once the ring is full
+    uint16_t idx = ringHead;
+    for (uint16_t n = 0; n < frameSize; n++) {
+        float w = window ? window[n] * gain : gain;
+        iq[2 * n] = ringI[idx] * w;
+        iq[2 * n + 1] = ringQ[idx] * w;
+        idx = (idx + 1) & (frameSize - 1);
+    }
+    newSamples = 0;
+}
+
+void ZoomFFT::correctDroop(float* power) const {
+    if (!droop) return;
+    uint16_t bins = frameSize / 2;
+    for (uint16_t j = 0; j < bins; j++) {
+        power[j] *= droop[j];
+    }
+}
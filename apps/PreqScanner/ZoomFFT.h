@@ -0,0 +1,92 @@
+#ifndef ZOOM_FFT_H
+#define ZOOM_FFT_H
+
+#include <stdint.h>
+
+// ========================================
+// ZoomFFT - Narrowband front end for zoomed spectrum analysis
+// Mixes real input down to complex baseband with an NCO, decimates
+// through a 3-stage CIC and a half-band FIR, and collects frames of
+// decimated I/Q for the regular FFT. Hardware independent.
+// ========================================
+
+#define ZOOM_MIN_DECIMATION   2
+#define ZOOM_MAX_DECIMATION   64
+#define ZOOM_CIC_ORDER        3         // 15-bit mixer output + 3*log2(32) growth fits int32
+#define ZOOM_FIR_TAPS         23        // Decimate-by-2 anti-alias filter
+#define ZOOM_MIXER_GAIN       8.0f      // Fraction bits kept in the integer mixer output
+#define ZOOM_MAX_FRAME        1024
+
+class ZoomFFT {
+private:
+    // Configuration
+    uint32_t sampleRate;
+    float centerFrequency;
+    uint8_t decimation;           // Total factor: CIC ratio * 2
+    uint8_t cicRatio;
+    uint16_t frameSize;
+    bool configured;
+
+    // NCO
+    uint32_t ncoPhase;
+    uint32_t ncoIncrement;
+
+    // CIC state per channel (wrapping integer arithmetic)
+    int32_t integrI[ZOOM_CIC_ORDER], integrQ[ZOOM_CIC_ORDER];
+    int32_t combI[ZOOM_CIC_ORDER], combQ[ZOOM_CIC_ORDER];
+    uint8_t cicPhase;
+    float cicScale;               // 1 / (R^N * mixer gain)
+
+    // Half-band FIR, circular delay line
+    float firTaps[ZOOM_FIR_TAPS];
+    float firI[ZOOM_FIR_TAPS], firQ[ZOOM_FIR_TAPS];
+    uint8_t firIndex;
+    bool firPhase;
+
+    // Decimated I/Q ring of one frame
+    float* ringI;
+    float* ringQ;
+    uint16_t ringHead;
+    uint16_t ringFilled;
+    uint16_t newSamples;
+
+    float* droop;                 // Per display bin power correction
+
+    void designFir();
+    void buildDroopTable();
+    bool pushFir(float i, float q);
+
+public:
+    ZoomFFT();
+    ~ZoomFFT();
+
+    // decimation must be a power of two in [ZOOM_MIN_DECIMATION, ZOOM_MAX_DECIMATION]
+    bool configure(uint32_t rate, float centerHz, uint8_t factor, uint16_t size);
+    void release();
+    void reset();
+
+    // Feeds real samples (centered ADC counts); returns decimated samples produced
+    uint32_t process(const int16_t* input, uint32_t count);
+
+    // A full frame with at least hop samples not yet analysed
+    bool frameReady(uint16_t hop) const { return ringFilled == frameSize && newSamples >= hop; }
+    // Writes the latest frame oldest-first as interleaved I/Q, times window
+    // (may be null) and gain, and marks it analysed
+    void readFrame(float* iq, const float* window, float gain);
+
+    // The display keeps the central half of the complex FFT, where the
+    // FIR is flat: frameSize / 2 bins starting at getStartFrequency()
+    float getOutputRate() const { return (float)sampleRate / decimation; }
+    float getBinWidth() const { return getOutputRate() / frameSize; }
+    float getStartFrequency() const { return centerFrequency - getOutputRate() / 4; }
+    float getCenterFrequency() const { return centerFrequency; }
+    uint8_t getDecimation() const { return decimation; }
+    bool isConfigured() const { return configured; }
+
+    // FFT index holding display bin j (negative frequencies wrap)
+    uint16_t fftIndex(uint16_t j) const { return (j + frameSize - frameSize / 4) & (frameSize - 1); }
+    // Multiplies display-bin powers by the CIC passband droop correction
+    void correctDroop(float* power) const;
+};
+
+#endif // ZOOM_FFT_H
@@ -1076,6 +1076,7 @@ void WiFiToolsApp::showLegalWarning() {
         if (touch.isNewPress) break;
         delay(10);
     }
+    touchInterface.flushEvents();
 }
 
 void WiFiToolsApp::logActivity(String activity) {
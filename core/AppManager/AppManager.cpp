@@ -144,6 +144,11 @@ bool AppManager::initialize() {
 void AppManager::update() {
     unsigned long currentTime = millis();
     
+    // An app that asked to exit goes back to the launcher
+    if (currentApp && currentApp->getState() == APP_EXITING) {
+        exitCurrentApp();
+    }
+    
     // Update current app if running
     if (currentApp && currentApp->isRunning()) {
         currentApp->update();
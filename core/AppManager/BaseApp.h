@@ -75,8 +75,16 @@ protected:
     unsigned long lastUpdateTime;
     bool needsRedraw;
     
+    // Screen defaults; apps set these in their constructors
+    uint16_t backgroundColor;
+    uint16_t foregroundColor;
+    bool showBackButton;
+    bool showStatusBar;
+    
 public:
-    BaseApp() : currentState(APP_UNLOADED), lastUpdateTime(0), needsRedraw(true) {}
+    BaseApp() : currentState(APP_UNLOADED), lastUpdateTime(0), needsRedraw(true),
+                backgroundColor(COLOR_BLACK), foregroundColor(COLOR_WHITE),
+                showBackButton(true), showStatusBar(true) {}
     virtual ~BaseApp() {}
     
     // Pure virtual methods - must be implemented by derived classes
@@ -108,7 +116,7 @@ public:
     // Getters
     AppMetadata getMetadata() const { return metadata; }
     AppState getState() const { return currentState; }
-    String getName() const { return metadata.name; }
+    virtual String getName() const { return metadata.name; }
     size_t getMemoryRequirement() const { return metadata.memoryRequirement; }
     bool getNeedsRedraw() const { return needsRedraw; }
     
@@ -146,6 +154,14 @@ protected:
     void setIcon(const uint8_t* iconData) {
         metadata.icon = iconData;
     }
+    
+    // Asks AppManager to return to the launcher after this frame
+    void exitApp() { currentState = APP_EXITING; }
+    
+    // Serial log line tagged with the app name
+    void debugLog(const String& message) const {
+        Serial.println("[" + metadata.name + "] " + message);
+    }
 };
 
 #endif // BASE_APP_H
\ No newline at end of file
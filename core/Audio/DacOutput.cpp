@@ -0,0 +1,110 @@
+#include "DacOutput.h"
+#include <driver/i2s.h>
+
+DacOutput::DacOutput() :
+    render(nullptr),
+    context(nullptr),
+    block(nullptr),
+    blockCapacity(0),
+    task(nullptr),
+    done(nullptr),
+    running(false),
+    blocks(0) {
+    memset(&config, 0, sizeof(config));
+}
+
+DacOutput::~DacOutput() {
+    release();
+}
+
+bool DacOutput::start(const DacOutputConfig& outputConfig, DacRenderCallback callback, void* callbackContext) {
+    if (task) return true;
+    if (!callback || outputConfig.blockSize == 0) return false;
+
+    if (!block || blockCapacity < outputConfig.blockSize) {
+        if (block) delete[] block;
+        block = new uint16_t[outputConfig.blockSize];
+        blockCapacity = block ? outputConfig.blockSize : 0;
+        if (!block) return false;
+    }
+    if (!done) {
+        done = xSemaphoreCreateBinary();
+        if (!done) return false;
+    }
+    xSemaphoreTake(done, 0);   // Drop a stale exit signal
+
+    i2s_config_t i2sConfig = {};
+    i2sConfig.mode = (i2s_mode_t)(I2S_MODE_MASTER | I2S_MODE_TX | I2S_MODE_DAC_BUILT_IN);
+    i2sConfig.sample_rate = outputConfig.sampleRate;
+    i2sConfig.bits_per_sample = I2S_BITS_PER_SAMPLE_16BIT;
+    i2sConfig.channel_format = I2S_CHANNEL_FMT_ONLY_RIGHT;
+    i2sConfig.communication_format = I2S_COMM_FORMAT_STAND_MSB;
+    i2sConfig.intr_alloc_flags = 0;
+    i2sConfig.dma_buf_count = outputConfig.dmaBuffers;
+    i2sConfig.dma_buf_len = outputConfig.blockSize;
+    i2sConfig.use_apll = false;
+
+    if (i2s_driver_install(I2S_NUM_0, &i2sConfig, 0, nullptr) != ESP_OK) return false;
+    i2s_set_pin(I2S_NUM_0, nullptr);
+    i2s_set_dac_mode(I2S_DAC_CHANNEL_RIGHT_EN); // GPIO25
+
+    config = outputConfig;
+    render = callback;
+    context = callbackContext;
+    blocks = 0;
+
+    running = true;
+    if (xTaskCreatePinnedToCore(taskEntry, config.taskName, config.taskStack, this,
+                                config.taskPriority, &task, config.taskCore) != pdPASS) {
+        running = false;
+        task = nullptr;
+        i2s_driver_uninstall(I2S_NUM_0);
+        return false;
+    }
+    return true;
+}
+
+bool DacOutput::stop() {
+    if (!task) return true;
+
+    // The task finishes its current block, signals and deletes itself
+    running = false;
+    bool exited = xSemaphoreTake(done, pdMS_TO_TICKS(config.stopTimeout)) == pdTRUE;
+    if (!exited) vTaskDelete(task);
+    task = nullptr;
+
+    i2s_zero_dma_buffer(I2S_NUM_0);
+    i2s_driver_uninstall(I2S_NUM_0);
+    return exited;
+}
+
+void DacOutput::release() {
+    stop();
+    if (block) {
+        delete[] block;
+        block = nullptr;
+    }
+    blockCapacity = 0;
+    if (done) {
+        vSemaphoreDelete(done);
+        done = nullptr;
+    }
+}
+
+void DacOutput::taskEntry(void* arg) {
+    static_cast<DacOutput*>(arg)->loop();
+}
+
+void DacOutput::loop() {
+    while (running) {
+        render(context, block, config.blockSize);
+
+        size_t written = 0;
+        i2s_write(I2S_NUM_0, block, config.blockSize * sizeof(uint16_t), &written, portMAX_DELAY);
+        blocks++;
+    }
+
+    // Last touch of shared state; the stopping task may free it after this
+    xSemaphoreGive(done);
+    vTaskDelete(nullptr);
+}
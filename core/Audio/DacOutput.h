@@ -0,0 +1,64 @@
+#ifndef DAC_OUTPUT_H
+#define DAC_OUTPUT_H
+
+#include <Arduino.h>
+
+// ========================================
+// DacOutput - Streams rendered blocks to the built-in DAC (GPIO25)
+// I2S0 feeds the DAC from DMA; the driver's buffers form the double
+// buffer and the output task blocks in i2s_write() until one is free, so
+// the render callback runs once per block on the task's core. Only the
+// task that calls start() and stop() writes the task handle; the output
+// task signals a semaphore as its last act and deletes itself, and stop()
+// waits on it with a timeout before freeing anything the callback uses.
+// ========================================
+
+// Fills count DAC samples (level in the top byte); runs on the output task
+typedef void (*DacRenderCallback)(void* context, uint16_t* out, uint16_t count);
+
+struct DacOutputConfig {
+    uint32_t sampleRate;
+    uint16_t blockSize;          // Samples per render call and per DMA buffer
+    uint8_t dmaBuffers;          // 2: render one while the other plays
+    const char* taskName;
+    uint32_t taskStack;
+    uint8_t taskPriority;
+    uint8_t taskCore;
+    uint32_t stopTimeout;        // ms to wait for the task to exit
+};
+
+class DacOutput {
+private:
+    DacOutputConfig config;
+    DacRenderCallback render;
+    void* context;
+    uint16_t* block;
+    uint16_t blockCapacity;
+
+    TaskHandle_t task;
+    SemaphoreHandle_t done;
+    volatile bool running;
+    volatile uint32_t blocks;
+
+    static void taskEntry(void* arg);
+    void loop();
+
+public:
+    DacOutput();
+    ~DacOutput();
+
+    // Installs the I2S driver and starts the output task; true if already
+    // running. The callback and context must stay valid until stop().
+    bool start(const DacOutputConfig& outputConfig, DacRenderCallback callback, void* callbackContext);
+    // Waits for the task to finish its block, then silences the DAC and
+    // removes the driver. False if the task had to be deleted.
+    bool stop();
+    // stop() and free the block and semaphore
+    void release();
+
+    bool isRunning() const { return task != nullptr; }
+    uint32_t getBlocks() const { return blocks; }
+    uint32_t getSampleRate() const { return config.sampleRate; }
+};
+
+#endif // DAC_OUTPUT_H
@@ -105,7 +105,7 @@
 #define BLE_SCAN_INTERVAL       0x50    // BLE scan interval (50ms)
 #define BLE_SCAN_WINDOW         0x30    // BLE scan window (30ms)
 #define BLE_RSSI_THRESHOLD      -70     // Minimum RSSI to report (dBm)
-#define BLE_MAX_DEVICES         32      // Maximum devices to track
+#define BLE_MAX_DEVICES         128     // Maximum devices to track
 #define BLE_DEVICE_TIMEOUT      30000   // Device timeout (ms)
 #define BLE_NAME_MAX_LENGTH     32      // Maximum BLE device name length
 
@@ -1,6 +1,9 @@
 #include "DisplayManager.h"
 #include "../SystemCore/SystemCore.h"
 
+// Approximate SPI cost of CASET/PASET/RAMWR with their parameters
+#define ADDR_WINDOW_BYTES 11
+
 // Global instance
 DisplayManager displayManager;
 
@@ -12,7 +15,8 @@ DisplayManager::DisplayManager() :
     screenBuffer(nullptr),
     bufferEnabled(false),
     backgroundColor(COLOR_BLACK),
-    foregroundColor(COLOR_WHITE)
+    foregroundColor(COLOR_WHITE),
+    bytesPushed(0)
 {
 }
 
@@ -82,6 +86,7 @@ void DisplayManager::clearScreen(uint16_t color) {
     if (!initialized || !tft) return;
     tft->fillScreen(color);
     backgroundColor = color;
+    bytesPushed += ADDR_WINDOW_BYTES + (uint32_t)tft->width() * tft->height() * 2;
 }
 
 void DisplayManager::setBrightness(uint8_t level) {
@@ -226,6 +231,7 @@ void DisplayManager::drawRetroRect(int16_t x, int16_t y, int16_t w, int16_t h, u
     
     if (filled) {
         tft->fillRect(x, y, w, h, color);
+        if (w > 0 && h > 0) bytesPushed += ADDR_WINDOW_BYTES + (uint32_t)w * h * 2;
     } else {
         tft->drawRect(x, y, w, h, color);
     }
@@ -330,17 +336,39 @@ void DisplayManager::enableBuffer(bool enable) {
 void DisplayManager::drawPixel(int16_t x, int16_t y, uint16_t color) {
     if (!initialized || !tft) return;
     tft->drawPixel(x, y, color);
+    bytesPushed += ADDR_WINDOW_BYTES + 2;
 }
 
 void DisplayManager::drawLine(int16_t x0, int16_t y0, int16_t x1, int16_t y1, uint16_t color) {
     if (!initialized || !tft) return;
     tft->drawLine(x0, y0, x1, y1, color);
+    
+    // Straight lines are one window; others go out a pixel at a time
+    int16_t dx = abs(x1 - x0);
+    int16_t dy = abs(y1 - y0);
+    if (dx == 0 || dy == 0) {
+        bytesPushed += ADDR_WINDOW_BYTES + (uint32_t)(dx + dy + 1) * 2;
+    } else {
+        bytesPushed += (uint32_t)(max(dx, dy) + 1) * (ADDR_WINDOW_BYTES + 2);
+    }
 }
 
 Adafruit_ILI9341* DisplayManager::getTFT() {
     return tft;
 }
 
+void DisplayManager::pushPixels(int16_t x, int16_t y, int16_t w, int16_t h, const uint16_t* pixels) {
+    if (!initialized || !tft || !pixels || w <= 0 || h <= 0) return;
+    
+    uint32_t count = (uint32_t)w * h;
+    tft->startWrite();
+    tft->setAddrWindow(x, y, w, h);
+    tft->writePixels((uint16_t*)pixels, count);
+    tft->endWrite();
+    
+    bytesPushed += ADDR_WINDOW_BYTES + count * 2;
+}
+
 void DisplayManager::drawTerminalText(int16_t x, int16_t y, String text, uint16_t color) {
     if (!initialized || !tft) return;
     
@@ -23,6 +23,8 @@
 #define COLOR_LIGHT_GRAY    0x8410  // #808080 - Disabled elements
 #define COLOR_BLUE_CYBER    0x001F  // #0000FF - Info accents
 #define COLOR_YELLOW        0xFFE0  // #FFFF00 - Warning/attention color
+#define COLOR_ORANGE_GLOW   0xFC00  // #FF8000 - Tertiary highlight
+#define COLOR_VERY_DARK_GRAY 0x1082 // #101010 - Faint grid lines
 
 // UI element dimensions
 #define BUTTON_HEIGHT       24
@@ -94,6 +96,9 @@ private:
     uint16_t backgroundColor;
     uint16_t foregroundColor;
     
+    // Transfer accounting
+    uint32_t bytesPushed;
+    
     // Private drawing methods
     void drawBorder3D(int16_t x, int16_t y, int16_t w, int16_t h, bool inset);
     void drawPixelPattern(int16_t x, int16_t y, int16_t w, int16_t h, uint8_t pattern);
@@ -184,6 +189,14 @@ public:
     void drawPixel(int16_t x, int16_t y, uint16_t color);
     void drawLine(int16_t x0, int16_t y0, int16_t x1, int16_t y1, uint16_t color);
     
+    // Bulk pixel transfer (one address window, streamed RGB565)
+    void pushPixels(int16_t x, int16_t y, int16_t w, int16_t h, const uint16_t* pixels);
+    
+    // SPI bytes sent by pixel, line, fill, clear and pushPixels calls
+    // (for profiling); text and circles are not counted
+    uint32_t getBytesPushed() const { return bytesPushed; }
+    void resetBytesPushed() { bytesPushed = 0; }
+    
     // Direct TFT access (use carefully)
     Adafruit_ILI9341* getTFT() { return tft; }
     
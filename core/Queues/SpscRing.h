@@ -0,0 +1,147 @@
+#ifndef SPSC_RING_H
+#define SPSC_RING_H
+
+#include <stdint.h>
+#include <stddef.h>
+
+// ========================================
+// SpscRing - Fixed-size slots handed from one producer to one consumer
+// The producer reserves the slot at the head, fills it in place (over as
+// many calls as it likes) and commits it. The consumer reads committed
+// slots one at a time or in batches and hands them back. Neither side
+// locks: head is written only by the producer and tail only by the
+// consumer, each published with release/acquire ordering, so a slot is
+// complete before the other side can see it. When every slot is waiting,
+// reserve() fails and the drop is counted; unread slots are never
+// overwritten. Shared by the sample acquisition and BLE sighting paths.
+// Hardware independent.
+// ========================================
+
+// Producer and consumer each own their fields
+struct SpscRingStats {
+    uint32_t produced;           // Producer: slots committed
+    uint32_t dropped;            // Producer: reserves refused by a full ring
+    uint32_t overruns;           // Producer: times the ring became full
+    uint32_t consumed;           // Consumer: slots released
+    uint32_t batches;            // Consumer: non-empty releases
+    uint32_t maxBacklog;         // Consumer: most slots waiting at once
+};
+
+template <typename T>
+class SpscRing {
+private:
+    T* slots;
+    uint32_t capacity;
+    uint32_t mask;
+    uint32_t head;               // Slots committed by the producer
+    uint32_t tail;               // Slots released by the consumer
+    bool dropping;
+
+    SpscRingStats stats;
+
+    void resetStats() {
+        stats.produced = 0;
+        stats.dropped = 0;
+        stats.overruns = 0;
+        stats.consumed = 0;
+        stats.batches = 0;
+        stats.maxBacklog = 0;
+    }
+
+    uint32_t published() const { return __atomic_load_n(&head, __ATOMIC_ACQUIRE); }
+
+public:
+    SpscRing() : slots(nullptr), capacity(0), mask(0), head(0), tail(0), dropping(false) {
+        resetStats();
+    }
+    ~SpscRing() { release(); }
+
+    // count must be a power of two, at least 2
+    bool allocate(uint32_t count) {
+        if (count < 2 || (count & (count - 1)) != 0) return false;
+        if (!slots || count != capacity) {
+            release();
+            slots = new T[count];
+            if (!slots) return false;
+            capacity = count;
+            mask = count - 1;
+        }
+        clear();
+        return true;
+    }
+
+    void release() {
+        if (slots) {
+            delete[] slots;
+            slots = nullptr;
+        }
+        capacity = 0;
+        mask = 0;
+    }
+
+    // Only while the producer is stopped
+    void clear() {
+        head = 0;
+        tail = 0;
+        dropping = false;
+        resetStats();
+    }
+
+    // ===== PRODUCER =====
+
+    // The slot at the head, or nullptr when the ring is full. Calling it
+    // again before commit() returns the same slot.
+    T* reserve() {
+        if (!slots) return nullptr;
+        if (head - __atomic_load_n(&tail, __ATOMIC_ACQUIRE) >= capacity) {
+            if (!dropping) {
+                stats.overruns++;
+                dropping = true;
+            }
+            stats.dropped++;
+            return nullptr;
+        }
+        dropping = false;
+        return &slots[head & mask];
+    }
+
+    // Publishes the reserved slot; only after a successful reserve()
+    void commit() {
+        stats.produced++;
+        __atomic_store_n(&head, head + 1, __ATOMIC_RELEASE);
+    }
+
+    // ===== CONSUMER =====
+
+    // The oldest committed slot, or nullptr
+    const T* peek() {
+        return beginBatch(1) ? &slots[tail & mask] : nullptr;
+    }
+    void pop() {
+        if (slots && published() != tail) endBatch(1);
+    }
+
+    // How many committed slots, up to max, can be read with batchItem()
+    uint32_t beginBatch(uint32_t max) {
+        if (!slots) return 0;
+        uint32_t waiting = published() - tail;
+        if (waiting > stats.maxBacklog) stats.maxBacklog = waiting;
+        return waiting < max ? waiting : max;
+    }
+    const T& batchItem(uint32_t index) const { return slots[(tail + index) & mask]; }
+    // Hands count slots back to the producer
+    void endBatch(uint32_t count) {
+        if (!slots || count == 0) return;
+        stats.consumed += count;
+        stats.batches++;
+        __atomic_store_n(&tail, tail + count, __ATOMIC_RELEASE);
+    }
+
+    uint32_t backlog() const { return published() - tail; }
+
+    const SpscRingStats& getStats() const { return stats; }
+    uint32_t getCapacity() const { return capacity; }
+    bool isAllocated() const { return slots != nullptr; }
+};
+
+#endif // SPSC_RING_H
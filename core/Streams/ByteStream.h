@@ -0,0 +1,30 @@
+#ifndef BYTE_STREAM_H
+#define BYTE_STREAM_H
+
+#include <stdint.h>
+#include <stddef.h>
+
+// ========================================
+// ByteStream - Seekable byte stream behind the binary file formats
+// Recording and log writers/readers only see this interface, so the same
+// code runs against an SD card file on the device (SdFileStream) and a
+// stdio file on the host (HostFileStream). Hardware independent.
+// ========================================
+
+// Four-character tag, first character in the lowest byte
+#define STREAM_FOURCC(a, b, c, d) \
+    ((uint32_t)(a) | ((uint32_t)(b) << 8) | ((uint32_t)(c) << 16) | ((uint32_t)(d) << 24))
+
+class ByteStream {
+public:
+    virtual ~ByteStream() {}
+    virtual size_t write(const uint8_t* data, size_t length) = 0;
+    virtual size_t read(uint8_t* data, size_t length) = 0;
+    virtual bool seek(uint32_t position) = 0;
+    virtual uint32_t size() = 0;
+    // Pushes buffered writes to the medium; writers call it at their own
+    // batch boundaries rather than per write
+    virtual bool flush() { return true; }
+};
+
+#endif // BYTE_STREAM_H
@@ -0,0 +1,34 @@
+#ifndef HOST_FILE_STREAM_H
+#define HOST_FILE_STREAM_H
+
+// ========================================
+// HostFileStream - ByteStream over a stdio FILE, for host tools and tests
+// The caller opens and closes the file.
+// ========================================
+
+#ifndef ARDUINO
+
+#include <stdio.h>
+#include "ByteStream.h"
+
+class HostFileStream : public ByteStream {
+public:
+    FILE* file;
+
+    explicit HostFileStream(FILE* f = nullptr) : file(f) {}
+    size_t write(const uint8_t* data, size_t length) override { return fwrite(data, 1, length, file); }
+    size_t read(uint8_t* data, size_t length) override { return fread(data, 1, length, file); }
+    bool seek(uint32_t position) override { return fseek(file, position, SEEK_SET) == 0; }
+    uint32_t size() override {
+        long here = ftell(file);
+        fseek(file, 0, SEEK_END);
+        long end = ftell(file);
+        fseek(file, here, SEEK_SET);
+        return (uint32_t)end;
+    }
+    bool flush() override { return fflush(file) == 0; }
+};
+
+#endif // ARDUINO
+
+#endif // HOST_FILE_STREAM_H
@@ -0,0 +1,26 @@
+#ifndef SD_FILE_STREAM_H
+#define SD_FILE_STREAM_H
+
+#include <FS.h>
+#include "ByteStream.h"
+
+// ========================================
+// SdFileStream - ByteStream over an SD card File
+// The caller opens and closes file; closing also flushes it.
+// ========================================
+
+class SdFileStream : public ByteStream {
+public:
+    File file;
+
+    size_t write(const uint8_t* data, size_t length) override { return file.write(data, length); }
+    size_t read(uint8_t* data, size_t length) override { return file.read(data, length); }
+    bool seek(uint32_t position) override { return file.seek(position); }
+    uint32_t size() override { return file.size(); }
+    bool flush() override {
+        file.flush();
+        return true;
+    }
+};
+
+#endif // SD_FILE_STREAM_H
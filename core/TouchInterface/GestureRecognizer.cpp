@@ -0,0 +1,195 @@
+#include "GestureRecognizer.h"
+#include <math.h>
+#include <stdlib.h>
+
+GestureRecognizer::GestureRecognizer() :
+    state(STATE_IDLE),
+    secondTap(false),
+    hasPreviousTap(false),
+    previousTapX(0),
+    previousTapY(0),
+    previousTapTime(0),
+    historyCount(0),
+    historyIndex(0)
+{
+    config = {
+        LONG_PRESS_TIME,
+        DOUBLE_TAP_TIME,
+        DOUBLE_TAP_SLOP,
+        DRAG_THRESHOLD,
+        SWIPE_THRESHOLD,
+        SWIPE_MIN_VELOCITY
+    };
+    pressEvent = {TOUCH_EVENT_UP, 0, 0, 0, 0};
+    lastEvent = pressEvent;
+}
+
+void GestureRecognizer::feed(const TouchEvent& event) {
+    switch (event.type) {
+        case TOUCH_EVENT_DOWN:
+            onDown(event);
+            break;
+        case TOUCH_EVENT_MOVE:
+            onMove(event);
+            break;
+        case TOUCH_EVENT_UP:
+            onUp(event);
+            break;
+    }
+}
+
+void GestureRecognizer::tick(uint32_t now) {
+    if (state == STATE_PRESSED && now - pressEvent.timestamp >= config.longPressTime) {
+        TouchEvent at = lastEvent;
+        at.timestamp = now;
+        emit(GESTURE_LONG_PRESS, at, lastEvent.x - pressEvent.x, lastEvent.y - pressEvent.y, 0.0f);
+        state = STATE_LONG_PRESSED;
+        hasPreviousTap = false;
+    }
+}
+
+void GestureRecognizer::reset() {
+    state = STATE_IDLE;
+    secondTap = false;
+    hasPreviousTap = false;
+    historyCount = 0;
+    historyIndex = 0;
+    output.clear();
+}
+
+void GestureRecognizer::onDown(const TouchEvent& event) {
+    // A down without a preceding up means the up was lost; start over
+    pressEvent = event;
+    lastEvent = event;
+    historyCount = 0;
+    historyIndex = 0;
+    recordSample(event);
+
+    uint32_t slop = config.doubleTapSlop;
+    secondTap = hasPreviousTap &&
+                event.timestamp - previousTapTime <= config.doubleTapTime &&
+                touchDistanceSquared(event.x, event.y, previousTapX, previousTapY) <= (int32_t)(slop * slop);
+
+    state = STATE_PRESSED;
+}
+
+void GestureRecognizer::onMove(const TouchEvent& event) {
+    if (state == STATE_IDLE) return;
+
+    // Long press can expire between samples
+    tick(event.timestamp);
+    recordSample(event);
+
+    uint32_t threshold = config.dragThreshold;
+    int32_t moved = touchDistanceSquared(event.x, event.y, pressEvent.x, pressEvent.y);
+
+    if (state == STATE_PRESSED || state == STATE_LONG_PRESSED) {
+        if (moved > (int32_t)(threshold * threshold)) {
+            state = STATE_DRAGGING;
+            hasPreviousTap = false;
+            emit(GESTURE_DRAG_START, event, event.x - pressEvent.x, event.y - pressEvent.y, 0.0f);
+        }
+    } else if (state == STATE_DRAGGING) {
+        if (event.x != lastEvent.x || event.y != lastEvent.y) {
+            emit(GESTURE_DRAG_MOVE, event, event.x - lastEvent.x, event.y - lastEvent.y, 0.0f);
+        }
+    }
+
+    lastEvent = event;
+}
+
+void GestureRecognizer::onUp(const TouchEvent& event) {
+    if (state == STATE_IDLE) return;
+
+    tick(event.timestamp);
+    recordSample(event);
+
+    int16_t deltaX = event.x - pressEvent.x;
+    int16_t deltaY = event.y - pressEvent.y;
+    float velocity = releaseVelocity(event);
+
+    if (state == STATE_DRAGGING) {
+        emit(GESTURE_DRAG_END, event, deltaX, deltaY, velocity);
+
+        uint32_t threshold = config.swipeThreshold;
+        if (touchDistanceSquared(event.x, event.y, pressEvent.x, pressEvent.y) >= (int32_t)(threshold * threshold) &&
+            velocity >= config.swipeMinVelocity) {
+            emit(swipeDirection(deltaX, deltaY), event, deltaX, deltaY, velocity);
+        }
+    } else if (state == STATE_PRESSED) {
+        if (secondTap) {
+            emit(GESTURE_DOUBLE_TAP, event, deltaX, deltaY, 0.0f);
+            hasPreviousTap = false;
+        } else {
+            emit(GESTURE_TAP, event, deltaX, deltaY, 0.0f);
+            hasPreviousTap = true;
+            previousTapX = event.x;
+            previousTapY = event.y;
+            previousTapTime = event.timestamp;
+        }
+    }
+
+    secondTap = false;
+    state = STATE_IDLE;
+    lastEvent = event;
+}
+
+void GestureRecognizer::emit(TouchGesture type, const TouchEvent& at, int16_t dx, int16_t dy, float velocity) {
+    GestureEvent gesture;
+    gesture.type = type;
+    gesture.x = at.x;
+    gesture.y = at.y;
+    gesture.startX = pressEvent.x;
+    gesture.startY = pressEvent.y;
+    gesture.deltaX = dx;
+    gesture.deltaY = dy;
+    gesture.timestamp = at.timestamp;
+    gesture.duration = at.timestamp - pressEvent.timestamp;
+    gesture.velocity = velocity;
+    output.push(gesture);
+}
+
+void GestureRecognizer::recordSample(const TouchEvent& event) {
+    history[historyIndex] = {event.x, event.y, event.timestamp};
+    historyIndex = (historyIndex + 1) & (VELOCITY_HISTORY_SIZE - 1);
+    if (historyCount < VELOCITY_HISTORY_SIZE) historyCount++;
+}
+
+float GestureRecognizer::releaseVelocity(const TouchEvent& up) {
+    // Oldest sample still inside the trailing window, using real sample times
+    const Sample* oldest = nullptr;
+    for (uint8_t i = 1; i <= historyCount; i++) {
+        const Sample& s = history[(historyIndex - i) & (VELOCITY_HISTORY_SIZE - 1)];
+        if (up.timestamp - s.timestamp > VELOCITY_WINDOW_MS) break;
+        oldest = &s;
+    }
+
+    if (!oldest || oldest->timestamp == up.timestamp) return 0.0f;
+
+    float distance = sqrtf((float)touchDistanceSquared(up.x, up.y, oldest->x, oldest->y));
+    return distance * 1000.0f / (float)(up.timestamp - oldest->timestamp);
+}
+
+TouchGesture GestureRecognizer::swipeDirection(int16_t deltaX, int16_t deltaY) const {
+    if (abs(deltaX) > abs(deltaY)) {
+        return (deltaX > 0) ? GESTURE_SWIPE_RIGHT : GESTURE_SWIPE_LEFT;
+    } else {
+        return (deltaY > 0) ? GESTURE_SWIPE_DOWN : GESTURE_SWIPE_UP;
+    }
+}
+
+const char* GestureRecognizer::gestureName(TouchGesture type) {
+    switch (type) {
+        case GESTURE_TAP:         return "TAP";
+        case GESTURE_DOUBLE_TAP:  return "DOUBLE_TAP";
+        case GESTURE_LONG_PRESS:  return "LONG_PRESS";
+        case GESTURE_DRAG_START:  return "DRAG_START";
+        case GESTURE_DRAG_MOVE:   return "DRAG_MOVE";
+        case GESTURE_DRAG_END:    return "DRAG_END";
+        case GESTURE_SWIPE_LEFT:  return "SWIPE_LEFT";
+        case GESTURE_SWIPE_RIGHT: return "SWIPE_RIGHT";
+        case GESTURE_SWIPE_UP:    return "SWIPE_UP";
+        case GESTURE_SWIPE_DOWN:  return "SWIPE_DOWN";
+        default:                  return "NONE";
+    }
+}
@@ -0,0 +1,187 @@
+#ifndef GESTURE_RECOGNIZER_H
+#define GESTURE_RECOGNIZER_H
+
+#include <stdint.h>
+#include <stddef.h>
+#include "TouchFilter.h"
+
+// ========================================
+// GestureRecognizer - Touch event stream to gesture events
+// Hardware independent: consumes timestamped down/move/up events
+// so recorded raw traces can be replayed on a host
+// (tests/test_gesture_recognizer.cpp).
+// A tap is reported on release, without waiting out the double tap
+// window, so a double tap arrives as TAP then DOUBLE_TAP. Consumers that
+// give both a meaning should treat DOUBLE_TAP as following up the TAP.
+// ========================================
+
+// Touch gesture types
+enum TouchGesture {
+    GESTURE_NONE,
+    GESTURE_TAP,
+    GESTURE_DOUBLE_TAP,
+    GESTURE_LONG_PRESS,
+    GESTURE_DRAG_START,
+    GESTURE_DRAG_MOVE,
+    GESTURE_DRAG_END,
+    GESTURE_SWIPE_LEFT,
+    GESTURE_SWIPE_RIGHT,
+    GESTURE_SWIPE_UP,
+    GESTURE_SWIPE_DOWN
+};
+
+// Raw touch event types produced by the sampler
+enum TouchEventType : uint8_t {
+    TOUCH_EVENT_DOWN,
+    TOUCH_EVENT_MOVE,
+    TOUCH_EVENT_UP
+};
+
+// Timestamped raw touch event (screen coordinates)
+struct TouchEvent {
+    TouchEventType type;
+    int16_t x, y;
+    uint16_t pressure;
+    uint32_t timestamp;     // Sample time in ms
+};
+
+// Recognized gesture event
+struct GestureEvent {
+    TouchGesture type;
+    int16_t x, y;           // Position at emission
+    int16_t startX, startY; // Position of the initiating press
+    int16_t deltaX, deltaY; // Movement since press (drag move: since last move)
+    uint32_t timestamp;     // Time of emission in ms
+    uint32_t duration;      // Time since press in ms
+    float velocity;         // Release velocity in pixels per second
+};
+
+// Gesture timing and distance configuration
+#define LONG_PRESS_TIME     800      // Long press threshold in ms
+#define DOUBLE_TAP_TIME     300      // Double tap window in ms
+#define DOUBLE_TAP_SLOP      20      // Max distance between taps of a double tap in pixels
+#define DRAG_THRESHOLD       10      // Minimum movement for drag in pixels
+#define SWIPE_THRESHOLD      50      // Minimum movement for swipe in pixels
+#define SWIPE_MIN_VELOCITY   200     // Minimum velocity for swipe detection (px/s)
+#define VELOCITY_WINDOW_MS   100     // Trailing window used for release velocity
+
+// Queue sizes (must be powers of two)
+#define TOUCH_EVENT_QUEUE_SIZE   32
+#define GESTURE_EVENT_QUEUE_SIZE 16
+#define VELOCITY_HISTORY_SIZE    8
+
+// Fixed-size single-producer/single-consumer event ring
+template <typename T, uint16_t N>
+class EventRing {
+    static_assert((N & (N - 1)) == 0, "EventRing size must be a power of two");
+
+private:
+    T items[N];
+    volatile uint16_t head;     // Next write slot
+    volatile uint16_t tail;     // Next read slot
+    uint16_t dropped;
+
+public:
+    EventRing() : head(0), tail(0), dropped(0) {}
+
+    bool push(const T& item) {
+        if ((uint16_t)(head - tail) >= N) {
+            dropped++;
+            return false;
+        }
+        items[head & (N - 1)] = item;
+        head = head + 1;
+        return true;
+    }
+
+    bool pop(T& item) {
+        if (head == tail) return false;
+        item = items[tail & (N - 1)];
+        tail = tail + 1;
+        return true;
+    }
+
+    // Most recently pushed item that has not been consumed yet
+    T* back() { return (head == tail) ? nullptr : &items[(head - 1) & (N - 1)]; }
+
+    void clear() { tail = head; }
+    bool isEmpty() const { return head == tail; }
+    uint16_t size() const { return head - tail; }
+    uint16_t getDroppedCount() const { return dropped; }
+};
+
+// Gesture configuration (defaults from the constants above)
+struct GestureConfig {
+    uint16_t longPressTime;
+    uint16_t doubleTapTime;
+    uint16_t doubleTapSlop;
+    uint16_t dragThreshold;
+    uint16_t swipeThreshold;
+    uint16_t swipeMinVelocity;
+};
+
+class GestureRecognizer {
+private:
+    enum RecognizerState : uint8_t {
+        STATE_IDLE,
+        STATE_PRESSED,      // Down, not yet moved past drag threshold
+        STATE_LONG_PRESSED, // Long press emitted, waiting for release or drag
+        STATE_DRAGGING
+    };
+
+    struct Sample {
+        int16_t x, y;
+        uint32_t timestamp;
+    };
+
+    GestureConfig config;
+    RecognizerState state;
+
+    // Current press
+    TouchEvent pressEvent;
+    TouchEvent lastEvent;
+    bool secondTap;
+
+    // Previous tap for double tap detection
+    bool hasPreviousTap;
+    int16_t previousTapX, previousTapY;
+    uint32_t previousTapTime;
+
+    // Recent samples for release velocity
+    Sample history[VELOCITY_HISTORY_SIZE];
+    uint8_t historyCount;
+    uint8_t historyIndex;
+
+    EventRing<GestureEvent, GESTURE_EVENT_QUEUE_SIZE> output;
+
+    void onDown(const TouchEvent& event);
+    void onMove(const TouchEvent& event);
+    void onUp(const TouchEvent& event);
+    void emit(TouchGesture type, const TouchEvent& at, int16_t dx, int16_t dy, float velocity);
+    void recordSample(const TouchEvent& event);
+    float releaseVelocity(const TouchEvent& up);
+    TouchGesture swipeDirection(int16_t deltaX, int16_t deltaY) const;
+
+public:
+    GestureRecognizer();
+
+    // Feed raw events in timestamp order
+    void feed(const TouchEvent& event);
+    // Advance time without input (long press while stationary)
+    void tick(uint32_t now);
+    void reset();
+
+    // Drain recognized gestures
+    bool poll(GestureEvent& event) { return output.pop(event); }
+    bool hasEvents() const { return !output.isEmpty(); }
+    uint16_t getDroppedCount() const { return output.getDroppedCount(); }
+
+    // Configuration
+    GestureConfig getConfig() const { return config; }
+    void setConfig(const GestureConfig& newConfig) { config = newConfig; }
+    void setLongPressTime(uint16_t timeMs) { config.longPressTime = timeMs; }
+
+    static const char* gestureName(TouchGesture type);
+};
+
+#endif // GESTURE_RECOGNIZER_H
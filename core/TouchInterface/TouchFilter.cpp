@@ -0,0 +1,192 @@
+#include "TouchFilter.h"
+#include <math.h>
+#include <stdlib.h>
+#include <stddef.h>
+
+static int32_t toQ16(double value) {
+    return (int32_t)lround(value * (double)AFFINE_Q16_ONE);
+}
+
+static double determinant3(const double m[3][3]) {
+    return m[0][0] * (m[1][1] * m[2][2] - m[1][2] * m[2][1])
+         - m[0][1] * (m[1][0] * m[2][2] - m[1][2] * m[2][0])
+         + m[0][2] * (m[1][0] * m[2][1] - m[1][1] * m[2][0]);
+}
+
+// Solves m * [p0 p1 p2]^T = rhs with Cramer's rule
+static void solve3(const double m[3][3], double det, const double rhs[3], double out[3]) {
+    for (uint8_t col = 0; col < 3; col++) {
+        double t[3][3];
+        for (uint8_t r = 0; r < 3; r++) {
+            for (uint8_t c = 0; c < 3; c++) {
+                t[r][c] = (c == col) ? rhs[r] : m[r][c];
+            }
+        }
+        out[col] = determinant3(t) / det;
+    }
+}
+
+bool solveAffineCalibration(const CalibrationSample* samples, uint8_t count, AffineQ16& out) {
+    if (!samples || count < 3) return false;
+
+    // Center raw values for numerical stability of the normal equations
+    double meanX = 0.0, meanY = 0.0;
+    for (uint8_t i = 0; i < count; i++) {
+        meanX += samples[i].rawX;
+        meanY += samples[i].rawY;
+    }
+    meanX /= count;
+    meanY /= count;
+
+    double normal[3][3] = {{0}};
+    double rhsX[3] = {0};
+    double rhsY[3] = {0};
+
+    for (uint8_t i = 0; i < count; i++) {
+        double rx = samples[i].rawX - meanX;
+        double ry = samples[i].rawY - meanY;
+        double v[3] = {rx, ry, 1.0};
+
+        for (uint8_t r = 0; r < 3; r++) {
+            for (uint8_t c = 0; c < 3; c++) {
+                normal[r][c] += v[r] * v[c];
+            }
+            rhsX[r] += v[r] * samples[i].screenX;
+            rhsY[r] += v[r] * samples[i].screenY;
+        }
+    }
+
+    double det = determinant3(normal);
+    if (fabs(det) < 1e-6) return false; // Collinear points
+
+    double px[3], py[3];
+    solve3(normal, det, rhsX, px);
+    solve3(normal, det, rhsY, py);
+
+    // Undo centering: s = p0 * (raw - mean) + p1 * (raw - mean) + p2
+    double offsetX = px[2] - px[0] * meanX - px[1] * meanY;
+    double offsetY = py[2] - py[0] * meanX - py[1] * meanY;
+
+    if (fabs(px[0]) >= 2.0 || fabs(px[1]) >= 2.0 || fabs(py[0]) >= 2.0 || fabs(py[1]) >= 2.0 ||
+        fabs(offsetX) >= AFFINE_MAX_OFFSET_PX || fabs(offsetY) >= AFFINE_MAX_OFFSET_PX) {
+        return false;
+    }
+
+    out.a = toQ16(px[0]);
+    out.b = toQ16(px[1]);
+    out.c = toQ16(offsetX);
+    out.d = toQ16(py[0]);
+    out.e = toQ16(py[1]);
+    out.f = toQ16(offsetY);
+    return true;
+}
+
+uint16_t calibrationChecksum(const CalibrationRecord& record) {
+    const uint8_t* bytes = (const uint8_t*)&record;
+    uint16_t sum1 = 0, sum2 = 0;
+    for (size_t i = 0; i < sizeof(CalibrationRecord) - sizeof(record.checksum); i++) {
+        sum1 = (sum1 + bytes[i]) % 255;
+        sum2 = (sum2 + sum1) % 255;
+    }
+    return (sum2 << 8) | sum1;
+}
+
+void packCalibrationRecord(const AffineQ16& m, uint8_t pointCount, CalibrationRecord& record) {
+    record.magic = CALIBRATION_MAGIC_NUMBER;
+    record.version = CALIBRATION_VERSION;
+    record.pointCount = pointCount;
+    record.matrix[0] = m.a;
+    record.matrix[1] = m.b;
+    record.matrix[2] = m.c;
+    record.matrix[3] = m.d;
+    record.matrix[4] = m.e;
+    record.matrix[5] = m.f;
+    record.checksum = calibrationChecksum(record);
+}
+
+bool unpackCalibrationRecord(const CalibrationRecord& record, AffineQ16& m, uint8_t& pointCount) {
+    if (record.magic != CALIBRATION_MAGIC_NUMBER ||
+        record.version != CALIBRATION_VERSION ||
+        record.checksum != calibrationChecksum(record)) {
+        return false;
+    }
+    m = {record.matrix[0], record.matrix[1], record.matrix[2],
+         record.matrix[3], record.matrix[4], record.matrix[5]};
+    pointCount = record.pointCount;
+    return true;
+}
+
+AffineQ16 affineFromRanges(int16_t xMin, int16_t xMax, int16_t yMin, int16_t yMax,
+                           int16_t width, int16_t height) {
+    AffineQ16 m = {0, 0, 0, 0, 0, 0};
+    if (xMax != xMin) {
+        m.a = ((int32_t)width << 16) / (xMax - xMin);
+        m.c = -m.a * xMin;
+    }
+    if (yMax != yMin) {
+        m.e = ((int32_t)height << 16) / (yMax - yMin);
+        m.f = -m.e * yMin;
+    }
+    return m;
+}
+
+uint16_t affineMaxError(const AffineQ16& m, const CalibrationSample* samples, uint8_t count) {
+    int32_t worst = 0;
+    for (uint8_t i = 0; i < count; i++) {
+        int16_t x, y;
+        applyAffine(m, samples[i].rawX, samples[i].rawY, x, y);
+        int32_t d2 = touchDistanceSquared(x, y, samples[i].screenX, samples[i].screenY);
+        if (d2 > worst) worst = d2;
+    }
+    return (uint16_t)ceil(sqrt((double)worst));
+}
+
+uint16_t medianOf(const uint16_t* values, uint8_t count) {
+    if (count == 0) return 0;
+    if (count > TOUCH_FILTER_MAX_SAMPLES) count = TOUCH_FILTER_MAX_SAMPLES;
+
+    // Insertion sort is cheapest for a handful of samples
+    uint16_t sorted[TOUCH_FILTER_MAX_SAMPLES];
+    for (uint8_t i = 0; i < count; i++) {
+        uint16_t v = values[i];
+        int8_t j = i - 1;
+        while (j >= 0 && sorted[j] > v) {
+            sorted[j + 1] = sorted[j];
+            j--;
+        }
+        sorted[j + 1] = v;
+    }
+
+    return sorted[count / 2];
+}
+
+uint8_t rejectOutliers(const uint16_t* rawX, const uint16_t* rawY, uint8_t count,
+                       uint16_t& outX, uint16_t& outY) {
+    if (count == 0) return 0;
+    if (count > TOUCH_FILTER_MAX_SAMPLES) count = TOUCH_FILTER_MAX_SAMPLES;
+
+    uint16_t medianX = medianOf(rawX, count);
+    uint16_t medianY = medianOf(rawY, count);
+
+    uint32_t sumX = 0, sumY = 0;
+    uint8_t inliers = 0;
+    for (uint8_t i = 0; i < count; i++) {
+        if (abs((int32_t)rawX[i] - medianX) <= TOUCH_OUTLIER_RAW &&
+            abs((int32_t)rawY[i] - medianY) <= TOUCH_OUTLIER_RAW) {
+            sumX += rawX[i];
+            sumY += rawY[i];
+            inliers++;
+        }
+    }
+
+    if (inliers == 0) {
+        // Every sample disagrees; the median is still the best estimate
+        outX = medianX;
+        outY = medianY;
+        return 1;
+    }
+
+    outX = (uint16_t)((sumX + inliers / 2) / inliers);
+    outY = (uint16_t)((sumY + inliers / 2) / inliers);
+    return inliers;
+}
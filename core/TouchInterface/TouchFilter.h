@@ -0,0 +1,117 @@
+#ifndef TOUCH_FILTER_H
+#define TOUCH_FILTER_H
+
+#include <stdint.h>
+
+// ========================================
+// TouchFilter - Fixed-point touch coordinate pipeline
+// Affine calibration, median outlier rejection and drag smoothing
+// Hardware independent so it can be exercised on a host
+// ========================================
+
+#define AFFINE_Q16_ONE        65536L  // 1.0 in Q16
+#define AFFINE_MAX_GAIN       (2 * AFFINE_Q16_ONE) // Keeps a*raw + b*raw inside int32
+#define AFFINE_MAX_OFFSET_PX  4096    // Largest accepted translation in pixels
+
+#define TOUCH_OUTLIER_RAW     64      // Max raw distance from median to count as inlier
+#define TOUCH_IIR_SHIFT       2       // Drag smoother: alpha = 1 / (1 << shift)
+#define TOUCH_FILTER_MAX_SAMPLES 8
+
+// Raw ADC to screen transform, Q16 fixed-point:
+//   x = (a * rawX + b * rawY + c) >> 16
+//   y = (d * rawX + e * rawY + f) >> 16
+// Handles scale, offset, rotation and skew of the panel in one step.
+struct AffineQ16 {
+    int32_t a, b, c;
+    int32_t d, e, f;
+};
+
+// Calibration sample: where the target was drawn and what the panel read
+struct CalibrationSample {
+    int16_t screenX, screenY;
+    uint16_t rawX, rawY;
+};
+
+// Persisted calibration (30 bytes), checked with Fletcher-16
+#define CALIBRATION_MAGIC_NUMBER 0xCA1B  // Affine Q16 record (replaces 0xCAFE float layout)
+#define CALIBRATION_VERSION      1
+
+struct __attribute__((packed)) CalibrationRecord {
+    uint16_t magic;
+    uint8_t version;
+    uint8_t pointCount;
+    int32_t matrix[6];
+    uint16_t checksum;
+};
+
+// Fletcher-16 over everything but the checksum itself
+uint16_t calibrationChecksum(const CalibrationRecord& record);
+void packCalibrationRecord(const AffineQ16& m, uint8_t pointCount, CalibrationRecord& record);
+// False for a wrong magic, version or checksum
+bool unpackCalibrationRecord(const CalibrationRecord& record, AffineQ16& m, uint8_t& pointCount);
+
+// Least-squares fit over count >= 3 samples (exact for 3). Returns false when
+// the points are degenerate (collinear) or the result is out of range.
+bool solveAffineCalibration(const CalibrationSample* samples, uint8_t count, AffineQ16& out);
+
+// Axis-aligned mapping of a raw range onto the screen (uncalibrated default)
+AffineQ16 affineFromRanges(int16_t xMin, int16_t xMax, int16_t yMin, int16_t yMax,
+                           int16_t width, int16_t height);
+
+// Largest residual in pixels of a matrix against its calibration samples
+uint16_t affineMaxError(const AffineQ16& m, const CalibrationSample* samples, uint8_t count);
+
+inline void applyAffine(const AffineQ16& m, uint16_t rawX, uint16_t rawY, int16_t& x, int16_t& y) {
+    // Gains are bounded by AFFINE_MAX_GAIN, so 12-bit products stay below 2^30
+    int32_t rx = rawX;
+    int32_t ry = rawY;
+    x = (int16_t)((m.a * rx + m.b * ry + m.c + 0x8000) >> 16);
+    y = (int16_t)((m.d * rx + m.e * ry + m.f + 0x8000) >> 16);
+}
+
+inline int32_t touchDistanceSquared(int16_t x1, int16_t y1, int16_t x2, int16_t y2) {
+    int32_t dx = (int32_t)x2 - x1;
+    int32_t dy = (int32_t)y2 - y1;
+    return dx * dx + dy * dy;
+}
+
+// Median of up to TOUCH_FILTER_MAX_SAMPLES values (input is not modified)
+uint16_t medianOf(const uint16_t* values, uint8_t count);
+
+// Averages the samples lying within TOUCH_OUTLIER_RAW of the per-axis median.
+// Returns the number of inliers used (0 if count is 0).
+uint8_t rejectOutliers(const uint16_t* rawX, const uint16_t* rawY, uint8_t count,
+                       uint16_t& outX, uint16_t& outY);
+
+// Single-pole integer IIR for screen coordinates during drags.
+// State is kept in Q4 so slow movement is not swallowed by truncation.
+class TouchSmoother {
+private:
+    int32_t stateX, stateY;
+    uint8_t shift;
+    bool primed;
+
+public:
+    TouchSmoother(uint8_t alphaShift = TOUCH_IIR_SHIFT) :
+        stateX(0), stateY(0), shift(alphaShift), primed(false) {}
+
+    void reset() { primed = false; }
+    void setShift(uint8_t alphaShift) { shift = alphaShift; }
+
+    void apply(int16_t& x, int16_t& y) {
+        int32_t inX = (int32_t)x << 4;
+        int32_t inY = (int32_t)y << 4;
+        if (!primed) {
+            stateX = inX;
+            stateY = inY;
+            primed = true;
+        } else {
+            stateX += (inX - stateX) >> shift;
+            stateY += (inY - stateY) >> shift;
+        }
+        x = (int16_t)((stateX + 8) >> 4);
+        y = (int16_t)((stateY + 8) >> 4);
+    }
+};
+
+#endif // TOUCH_FILTER_H
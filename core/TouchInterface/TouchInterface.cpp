@@ -8,16 +8,15 @@ TouchInterface touchInterface;
 
 // EEPROM addresses for calibration data
 #define EEPROM_CALIBRATION_ADDR 100
-#define CALIBRATION_MAGIC_NUMBER 0xCAFE
 
 TouchInterface::TouchInterface() :
     lastReadTime(0),
     lastPressTime(0),
     lastReleaseTime(0),
     gestureStartTime(0),
-    touchActive(false),
-    gestureActive(false),
-    tapCount(0)
+    calibrationSampleCount(0),
+    newGesture(false),
+    touchActive(false)
 {
     // Initialize touch point
     currentTouch = {0, 0, 0, 0, 0, false, false, false, false, 0};
@@ -27,13 +26,12 @@ TouchInterface::TouchInterface() :
     currentGesture = {GESTURE_NONE, {0}, {0}, {0}, 0, 0, 0, 0.0f};
     
     // Initialize calibration with default values
-    calibration = {
-        200, 3800,    // xMin, xMax (typical 4-wire resistive values)
-        300, 3700,    // yMin, yMax
-        0, 0,         // offsetX, offsetY
-        1.0f, 1.0f,   // scaleX, scaleY
-        false         // isCalibrated
-    };
+    calibration.matrix = affineFromRanges(TOUCH_DEFAULT_X_MIN, TOUCH_DEFAULT_X_MAX,
+                                          TOUCH_DEFAULT_Y_MIN, TOUCH_DEFAULT_Y_MAX,
+                                          SCREEN_WIDTH, SCREEN_HEIGHT);
+    calibration.pointCount = 0;
+    calibration.maxErrorPx = 0;
+    calibration.isCalibrated = false;
 }
 
 TouchInterface::~TouchInterface() {
@@ -66,12 +64,16 @@ void TouchInterface::update() {
     unsigned long currentTime = millis();
     
     // Sample touch at regular intervals
-    if (currentTime - lastReadTime >= 10) { // 100Hz sampling
+    if (currentTime - lastReadTime >= TOUCH_SAMPLE_INTERVAL) { // 100Hz sampling
         sampleTouch();
         processTouch();
-        detectGestures();
+        queueTouchEvents();
         lastReadTime = currentTime;
     }
+    
+    // Long press can fire while the stylus is held still
+    gestureRecognizer.tick(currentTime);
+    detectGestures();
 }
 
 void TouchInterface::shutdown() {
@@ -150,17 +152,17 @@ bool TouchInterface::isTouchPressed() {
 }
 
 void TouchInterface::sampleTouch() {
-    TouchPoint samples[TOUCH_SAMPLES];
+    uint16_t rawX[TOUCH_SAMPLES];
+    uint16_t rawY[TOUCH_SAMPLES];
+    uint16_t pressure[TOUCH_SAMPLES];
     uint8_t validSamples = 0;
     
     // Take multiple samples for noise reduction
     for (uint8_t i = 0; i < TOUCH_SAMPLES; i++) {
         if (isTouchPressed()) {
-            samples[validSamples].rawX = readTouchX();
-            samples[validSamples].rawY = readTouchY();
-            samples[validSamples].pressure = readTouchPressure();
-            samples[validSamples].isPressed = true;
-            samples[validSamples].timestamp = millis();
+            rawX[validSamples] = readTouchX();
+            rawY[validSamples] = readTouchY();
+            pressure[validSamples] = readTouchPressure();
             validSamples++;
         }
         delayMicroseconds(100); // Small delay between samples
@@ -168,15 +170,21 @@ void TouchInterface::sampleTouch() {
     
     // Store previous state
     lastTouch = currentTouch;
-    currentTouch.wasPressed = currentTouch.isPressed;
+    bool wasPressed = currentTouch.isPressed;
     
     if (validSamples >= TOUCH_SAMPLES / 2) {
-        // Average the valid samples
-        currentTouch = averageReadings(samples, validSamples);
+        // Median-filter the valid samples
+        currentTouch = filterReadings(rawX, rawY, pressure, validSamples);
         currentTouch.isPressed = true;
         
         // Apply calibration
         applyCalibration(currentTouch);
+        
+        // Smooth drags; the first sample of a press passes through untouched
+        if (!wasPressed) {
+            dragSmoother.reset();
+        }
+        dragSmoother.apply(currentTouch.x, currentTouch.y);
     } else {
         // No valid touch detected
         currentTouch.isPressed = false;
@@ -185,28 +193,20 @@ void TouchInterface::sampleTouch() {
     }
     
     // Detect touch state changes
+    currentTouch.wasPressed = wasPressed;
     currentTouch.isNewPress = (!currentTouch.wasPressed && currentTouch.isPressed);
     currentTouch.isNewRelease = (currentTouch.wasPressed && !currentTouch.isPressed);
 }
 
-TouchPoint TouchInterface::averageReadings(TouchPoint* samples, uint8_t count) {
-    if (count == 0) return {0, 0, 0, 0, 0, false, false, false, false, 0};
-    
-    uint32_t sumX = 0, sumY = 0, sumPressure = 0;
-    
-    for (uint8_t i = 0; i < count; i++) {
-        sumX += samples[i].rawX;
-        sumY += samples[i].rawY;
-        sumPressure += samples[i].pressure;
-    }
+TouchPoint TouchInterface::filterReadings(uint16_t* rawX, uint16_t* rawY, uint16_t* pressure, uint8_t count) {
+    TouchPoint filtered = {0, 0, 0, 0, 0, false, false, false, false, millis()};
+    if (count == 0) return filtered;
     
-    TouchPoint averaged;
-    averaged.rawX = sumX / count;
-    averaged.rawY = sumY / count;
-    averaged.pressure = sumPressure / count;
-    averaged.timestamp = millis();
+    // Reject samples far from the median (contact bounce, plate settling)
+    rejectOutliers(rawX, rawY, count, filtered.rawX, filtered.rawY);
+    filtered.pressure = medianOf(pressure, count);
     
-    return averaged;
+    return filtered;
 }
 
 void TouchInterface::processTouch() {
@@ -236,136 +236,106 @@ void TouchInterface::processTouch() {
     }
 }
 
-void TouchInterface::detectGestures() {
-    unsigned long currentTime = millis();
-    
+void TouchInterface::queueTouchEvents() {
     if (currentTouch.isNewPress) {
-        // Start new gesture
-        gestureStartTime = currentTime;
-        currentGesture.startPoint = currentTouch;
-        currentGesture.currentPoint = currentTouch;
-        currentGesture.type = GESTURE_NONE;
-        gestureActive = true;
-        
-        // Check for double tap
-        if (currentTime - lastReleaseTime < DOUBLE_TAP_TIME) {
-            tapCount++;
-            if (tapCount >= 2) {
-                currentGesture.type = GESTURE_DOUBLE_TAP;
-                tapCount = 0;
-            }
-        } else {
-            tapCount = 1;
-        }
+        pushTouchEvent(TOUCH_EVENT_DOWN);
+    } else if (currentTouch.isNewRelease) {
+        // Release keeps the last pressed coordinates
+        pushTouchEvent(TOUCH_EVENT_UP);
+    } else if (currentTouch.isPressed &&
+               (currentTouch.x != lastTouch.x || currentTouch.y != lastTouch.y)) {
+        pushTouchEvent(TOUCH_EVENT_MOVE);
     }
+}
+
+void TouchInterface::pushTouchEvent(TouchEventType type) {
+    TouchEvent event = {type, currentTouch.x, currentTouch.y, currentTouch.pressure,
+                        (uint32_t)currentTouch.timestamp};
     
-    if (touchActive && gestureActive) {
-        currentGesture.currentPoint = currentTouch;
-        currentGesture.duration = currentTime - gestureStartTime;
-        
-        // Calculate movement
-        currentGesture.deltaX = currentTouch.x - currentGesture.startPoint.x;
-        currentGesture.deltaY = currentTouch.y - currentGesture.startPoint.y;
-        
-        float distance = calculateDistance(currentGesture.startPoint, currentTouch);
-        
-        // Detect gesture types
-        if (currentGesture.duration > LONG_PRESS_TIME && distance < DRAG_THRESHOLD) {
-            currentGesture.type = GESTURE_LONG_PRESS;
-        } else if (distance > DRAG_THRESHOLD) {
-            if (currentGesture.type == GESTURE_NONE || currentGesture.type == GESTURE_DRAG_START) {
-                currentGesture.type = GESTURE_DRAG_START;
-            } else {
-                currentGesture.type = GESTURE_DRAG_MOVE;
-            }
-        }
+    // Recognizer sees every sample for accurate timing
+    gestureRecognizer.feed(event);
+    
+    // Coalesce consecutive moves the app has not consumed yet
+    TouchEvent* pending = touchEvents.back();
+    if (type == TOUCH_EVENT_MOVE && pending && pending->type == TOUCH_EVENT_MOVE) {
+        *pending = event;
+        return;
     }
     
-    if (currentTouch.isNewRelease && gestureActive) {
-        currentGesture.endPoint = currentTouch;
-        currentGesture.duration = currentTime - gestureStartTime;
-        
-        float distance = calculateDistance(currentGesture.startPoint, currentGesture.endPoint);
-        currentGesture.velocity = calculateVelocity(currentGesture.startPoint, currentGesture.endPoint, currentGesture.duration);
-        
-        // Finalize gesture type
-        if (currentGesture.type == GESTURE_DRAG_START || currentGesture.type == GESTURE_DRAG_MOVE) {
-            currentGesture.type = GESTURE_DRAG_END;
-        } else if (distance > SWIPE_THRESHOLD && currentGesture.velocity > SWIPE_MIN_VELOCITY) {
-            currentGesture.type = detectSwipeDirection(currentGesture.deltaX, currentGesture.deltaY);
-        } else if (currentGesture.type == GESTURE_NONE && tapCount == 1) {
-            currentGesture.type = GESTURE_TAP;
-        }
-        
-        gestureActive = false;
+    if (!touchEvents.push(event)) {
+        Serial.println("[TouchInterface] Touch event queue full, event dropped");
     }
 }
 
-int16_t TouchInterface::mapX(uint16_t rawX) {
-    if (!calibration.isCalibrated) {
-        // Default mapping without calibration
-        return map(rawX, calibration.xMin, calibration.xMax, 0, SCREEN_WIDTH);
-    }
+void TouchInterface::detectGestures() {
+    GestureEvent event;
     
-    float x = (rawX - calibration.xMin) * calibration.scaleX + calibration.offsetX;
-    return constrain((int16_t)x, 0, SCREEN_WIDTH - 1);
-}
-
-int16_t TouchInterface::mapY(uint16_t rawY) {
-    if (!calibration.isCalibrated) {
-        // Default mapping without calibration
-        return map(rawY, calibration.yMin, calibration.yMax, 0, SCREEN_HEIGHT);
+    while (gestureRecognizer.poll(event)) {
+        gestureEvents.push(event);
+        
+        // Mirror into the legacy single-gesture state
+        currentGesture.type = event.type;
+        currentGesture.startPoint.x = event.startX;
+        currentGesture.startPoint.y = event.startY;
+        currentGesture.currentPoint.x = event.x;
+        currentGesture.currentPoint.y = event.y;
+        currentGesture.endPoint = currentGesture.currentPoint;
+        currentGesture.deltaX = event.deltaX;
+        currentGesture.deltaY = event.deltaY;
+        currentGesture.duration = event.duration;
+        currentGesture.velocity = event.velocity;
+        newGesture = true;
     }
-    
-    float y = (rawY - calibration.yMin) * calibration.scaleY + calibration.offsetY;
-    return constrain((int16_t)y, 0, SCREEN_HEIGHT - 1);
 }
 
-void TouchInterface::applyCalibration(TouchPoint& point) {
-    point.x = mapX(point.rawX);
-    point.y = mapY(point.rawY);
-}
-
-float TouchInterface::calculateVelocity(TouchPoint start, TouchPoint end, unsigned long timeMs) {
-    if (timeMs == 0) return 0.0f;
-    
-    float distance = calculateDistance(start, end);
-    return distance / (timeMs / 1000.0f); // pixels per second
+void TouchInterface::flushEvents() {
+    touchEvents.clear();
+    gestureEvents.clear();
+    gestureRecognizer.reset();
+    newGesture = false;
 }
 
-float TouchInterface::calculateDistance(TouchPoint p1, TouchPoint p2) {
-    int16_t dx = p2.x - p1.x;
-    int16_t dy = p2.y - p1.y;
-    return sqrt(dx * dx + dy * dy);
+TouchPoint TouchInterface::eventToTouchPoint(const TouchEvent& event) const {
+    TouchPoint point = currentTouch;
+    point.x = event.x;
+    point.y = event.y;
+    point.pressure = event.pressure;
+    point.timestamp = event.timestamp;
+    point.isPressed = (event.type != TOUCH_EVENT_UP);
+    point.wasPressed = (event.type != TOUCH_EVENT_DOWN);
+    point.isNewPress = (event.type == TOUCH_EVENT_DOWN);
+    point.isNewRelease = (event.type == TOUCH_EVENT_UP);
+    return point;
 }
 
-TouchGesture TouchInterface::detectSwipeDirection(int16_t deltaX, int16_t deltaY) {
-    if (abs(deltaX) > abs(deltaY)) {
-        return (deltaX > 0) ? GESTURE_SWIPE_RIGHT : GESTURE_SWIPE_LEFT;
-    } else {
-        return (deltaY > 0) ? GESTURE_SWIPE_DOWN : GESTURE_SWIPE_UP;
-    }
+void TouchInterface::applyCalibration(TouchPoint& point) {
+    int16_t x, y;
+    applyAffine(calibration.matrix, point.rawX, point.rawY, x, y);
+    point.x = constrain(x, 0, SCREEN_WIDTH - 1);
+    point.y = constrain(y, 0, SCREEN_HEIGHT - 1);
 }
 
 TouchPoint TouchInterface::getCurrentTouch() {
     return currentTouch;
 }
 
-bool TouchInterface::hasNewGesture() const {
-    return (currentGesture.type != GESTURE_NONE && !gestureActive);
-}
-
 void TouchInterface::clearGesture() {
     currentGesture.type = GESTURE_NONE;
+    newGesture = false;
 }
 
 bool TouchInterface::startCalibration() {
     Serial.println("[TouchInterface] Starting calibration...");
-    calibration.isCalibrated = false;
+    calibrationSampleCount = 0;
     return true;
 }
 
 bool TouchInterface::calibratePoint(int16_t screenX, int16_t screenY) {
+    if (calibrationSampleCount >= TOUCH_CALIBRATION_POINTS) {
+        Serial.println("[TouchInterface] Calibration point limit reached");
+        return false;
+    }
+    
     // Wait for touch
     Serial.printf("[TouchInterface] Touch calibration point at (%d, %d)\n", screenX, screenY);
     
@@ -373,19 +343,26 @@ bool TouchInterface::calibratePoint(int16_t screenX, int16_t screenY) {
     while (millis() - startTime < 10000) { // 10 second timeout
         update();
         if (currentTouch.isNewPress) {
-            // Store calibration point
-            if (screenX == 0 && screenY == 0) {
-                // Top-left corner
-                calibration.xMin = currentTouch.rawX;
-                calibration.yMin = currentTouch.rawY;
-            } else if (screenX == SCREEN_WIDTH - 1 && screenY == SCREEN_HEIGHT - 1) {
-                // Bottom-right corner
-                calibration.xMax = currentTouch.rawX;
-                calibration.yMax = currentTouch.rawY;
+            // Average the filtered raw readings for as long as the stylus is held
+            uint32_t sumX = 0, sumY = 0;
+            uint16_t count = 0;
+            while (currentTouch.isPressed && count < 100) {
+                sumX += currentTouch.rawX;
+                sumY += currentTouch.rawY;
+                count++;
+                delay(TOUCH_SAMPLE_INTERVAL);
+                update();
             }
             
+            CalibrationSample& sample = calibrationSamples[calibrationSampleCount++];
+            sample.screenX = screenX;
+            sample.screenY = screenY;
+            sample.rawX = sumX / count;
+            sample.rawY = sumY / count;
+            
             Serial.printf("[TouchInterface] Calibration point recorded: raw(%d, %d)\n", 
-                         currentTouch.rawX, currentTouch.rawY);
+                         sample.rawX, sample.rawY);
+            flushEvents();
             return true;
         }
         delay(10);
@@ -396,11 +373,16 @@ bool TouchInterface::calibratePoint(int16_t screenX, int16_t screenY) {
 }
 
 bool TouchInterface::finishCalibration() {
-    // Calculate scaling factors
-    calibration.scaleX = (float)SCREEN_WIDTH / (calibration.xMax - calibration.xMin);
-    calibration.scaleY = (float)SCREEN_HEIGHT / (calibration.yMax - calibration.yMin);
-    calibration.offsetX = 0;
-    calibration.offsetY = 0;
+    AffineQ16 matrix;
+    if (!solveAffineCalibration(calibrationSamples, calibrationSampleCount, matrix)) {
+        Serial.printf("[TouchInterface] Calibration failed (%d points, need 3 non-collinear)\n",
+                     calibrationSampleCount);
+        return false;
+    }
+    
+    calibration.matrix = matrix;
+    calibration.pointCount = calibrationSampleCount;
+    calibration.maxErrorPx = affineMaxError(matrix, calibrationSamples, calibrationSampleCount);
     calibration.isCalibrated = true;
     
     // Save calibration
@@ -413,11 +395,12 @@ bool TouchInterface::finishCalibration() {
 }
 
 void TouchInterface::loadCalibration() {
-    uint16_t magic;
-    EEPROM.get(EEPROM_CALIBRATION_ADDR, magic);
+    CalibrationRecord record;
+    EEPROM.get(EEPROM_CALIBRATION_ADDR, record);
     
-    if (magic == CALIBRATION_MAGIC_NUMBER) {
-        EEPROM.get(EEPROM_CALIBRATION_ADDR + 2, calibration);
+    if (unpackCalibrationRecord(record, calibration.matrix, calibration.pointCount)) {
+        calibration.maxErrorPx = 0;
+        calibration.isCalibrated = true;
         Serial.println("[TouchInterface] Calibration loaded from EEPROM");
     } else {
         Serial.println("[TouchInterface] No valid calibration found, using defaults");
@@ -425,21 +408,22 @@ void TouchInterface::loadCalibration() {
 }
 
 void TouchInterface::saveCalibration() {
-    uint16_t magic = CALIBRATION_MAGIC_NUMBER;
-    EEPROM.put(EEPROM_CALIBRATION_ADDR, magic);
-    EEPROM.put(EEPROM_CALIBRATION_ADDR + 2, calibration);
+    CalibrationRecord record;
+    packCalibrationRecord(calibration.matrix, calibration.pointCount, record);
+    
+    EEPROM.put(EEPROM_CALIBRATION_ADDR, record);
     EEPROM.commit();
     Serial.println("[TouchInterface] Calibration saved to EEPROM");
 }
 
 void TouchInterface::resetCalibration() {
+    calibration.matrix = affineFromRanges(TOUCH_DEFAULT_X_MIN, TOUCH_DEFAULT_X_MAX,
+                                          TOUCH_DEFAULT_Y_MIN, TOUCH_DEFAULT_Y_MAX,
+                                          SCREEN_WIDTH, SCREEN_HEIGHT);
+    calibration.pointCount = 0;
+    calibration.maxErrorPx = 0;
     calibration.isCalibrated = false;
-    calibration.xMin = 200;
-    calibration.xMax = 3800;
-    calibration.yMin = 300;
-    calibration.yMax = 3700;
-    calibration.scaleX = calibration.scaleY = 1.0f;
-    calibration.offsetX = calibration.offsetY = 0;
+    calibrationSampleCount = 0;
     
     Serial.println("[TouchInterface] Calibration reset to defaults");
 }
@@ -475,6 +459,10 @@ void TouchInterface::setPressureThreshold(uint16_t threshold) {
     Serial.printf("[TouchInterface] Pressure threshold set to %d\n", threshold);
 }
 
+void TouchInterface::setLongPressTime(unsigned long timeMs) {
+    gestureRecognizer.setLongPressTime((uint16_t)timeMs);
+}
+
 uint16_t TouchInterface::getPressureThreshold() const {
     return PRESSURE_THRESHOLD;
 }
@@ -486,11 +474,11 @@ void TouchInterface::printTouchInfo() {
 }
 
 void TouchInterface::printCalibrationInfo() {
+    const AffineQ16& m = calibration.matrix;
     Serial.println("[TouchInterface] Calibration Data:");
-    Serial.printf("  X Range: %d - %d\n", calibration.xMin, calibration.xMax);
-    Serial.printf("  Y Range: %d - %d\n", calibration.yMin, calibration.yMax);
-    Serial.printf("  Scale: %.3f, %.3f\n", calibration.scaleX, calibration.scaleY);
-    Serial.printf("  Offset: %d, %d\n", calibration.offsetX, calibration.offsetY);
+    Serial.printf("  X = %.5f*rx + %.5f*ry + %.2f\n", m.a / 65536.0f, m.b / 65536.0f, m.c / 65536.0f);
+    Serial.printf("  Y = %.5f*rx + %.5f*ry + %.2f\n", m.d / 65536.0f, m.e / 65536.0f, m.f / 65536.0f);
+    Serial.printf("  Points: %d, Max error: %d px\n", calibration.pointCount, calibration.maxErrorPx);
     Serial.printf("  Calibrated: %s\n", calibration.isCalibrated ? "YES" : "NO");
 }
 
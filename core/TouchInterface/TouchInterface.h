@@ -3,6 +3,9 @@
 
 #include <Arduino.h>
 #include "../Config/hardware_pins.h"
+#include "../Config.h"
+#include "GestureRecognizer.h"
+#include "TouchFilter.h"
 
 // ========================================
 // TouchInterface - 4-wire resistive touch for remu.ii
@@ -21,21 +24,6 @@ struct TouchPoint {
     unsigned long timestamp; // When touch occurred
 };
 
-// Touch gesture types
-enum TouchGesture {
-    GESTURE_NONE,
-    GESTURE_TAP,
-    GESTURE_DOUBLE_TAP,
-    GESTURE_LONG_PRESS,
-    GESTURE_DRAG_START,
-    GESTURE_DRAG_MOVE,
-    GESTURE_DRAG_END,
-    GESTURE_SWIPE_LEFT,
-    GESTURE_SWIPE_RIGHT,
-    GESTURE_SWIPE_UP,
-    GESTURE_SWIPE_DOWN
-};
-
 // Touch gesture data
 struct TouchGesture_t {
     TouchGesture type;
@@ -49,21 +37,20 @@ struct TouchGesture_t {
 
 // Calibration data structure
 struct TouchCalibration {
-    int16_t xMin, xMax;     // Raw X range
-    int16_t yMin, yMax;     // Raw Y range
-    int16_t offsetX, offsetY; // Screen offset correction
-    float scaleX, scaleY;   // Scaling factors
+    AffineQ16 matrix;       // Raw -> screen transform (Q16)
+    uint8_t pointCount;     // Points used to solve the matrix
+    uint16_t maxErrorPx;    // Worst residual at the calibration points
     bool isCalibrated;      // Calibration status
 };
 
 // Touch configuration constants
-#define TOUCH_SAMPLES         4      // Number of samples to average
+#define TOUCH_SAMPLES         5      // Samples per reading (median filtered)
+#define TOUCH_DEFAULT_X_MIN 200      // Typical 4-wire resistive raw ranges
+#define TOUCH_DEFAULT_X_MAX 3800
+#define TOUCH_DEFAULT_Y_MIN 300
+#define TOUCH_DEFAULT_Y_MAX 3700
 #define DEBOUNCE_DELAY       50      // Debounce time in milliseconds
-#define LONG_PRESS_TIME     800      // Long press threshold in ms
-#define DOUBLE_TAP_TIME     300      // Double tap window in ms
-#define DRAG_THRESHOLD       10      // Minimum movement for drag in pixels
-#define SWIPE_THRESHOLD      50      // Minimum movement for swipe in pixels
-#define SWIPE_MIN_VELOCITY   200     // Minimum velocity for swipe detection
+#define TOUCH_SAMPLE_INTERVAL 10     // Sampling period in ms (100Hz)
 
 class TouchInterface {
 private:
@@ -80,11 +67,18 @@ private:
     
     // Calibration data
     TouchCalibration calibration;
+    CalibrationSample calibrationSamples[TOUCH_CALIBRATION_POINTS];
+    uint8_t calibrationSampleCount;
+    TouchSmoother dragSmoother;
+    
+    // Event stream
+    EventRing<TouchEvent, TOUCH_EVENT_QUEUE_SIZE> touchEvents;
+    EventRing<GestureEvent, GESTURE_EVENT_QUEUE_SIZE> gestureEvents;
+    GestureRecognizer gestureRecognizer;
+    bool newGesture;
     
     // State tracking
     bool touchActive;
-    bool gestureActive;
-    uint8_t tapCount;
     
     // Private methods - 4-wire resistive touch reading
     uint16_t readTouchX();
@@ -94,19 +88,14 @@ private:
     
     // Touch processing
     void sampleTouch();
-    TouchPoint averageReadings(TouchPoint* samples, uint8_t count);
+    TouchPoint filterReadings(uint16_t* rawX, uint16_t* rawY, uint16_t* pressure, uint8_t count);
     void processTouch();
+    void queueTouchEvents();
     void detectGestures();
+    void pushTouchEvent(TouchEventType type);
     
     // Coordinate transformation
-    int16_t mapX(uint16_t rawX);
-    int16_t mapY(uint16_t rawY);
     void applyCalibration(TouchPoint& point);
-    
-    // Gesture detection helpers
-    float calculateVelocity(TouchPoint start, TouchPoint end, unsigned long timeMs);
-    float calculateDistance(TouchPoint p1, TouchPoint p2);
-    TouchGesture detectSwipeDirection(int16_t deltaX, int16_t deltaY);
 
 public:
     TouchInterface();
@@ -126,13 +115,22 @@ public:
     
     // Gesture recognition
     TouchGesture_t getCurrentGesture() const { return currentGesture; }
-    bool hasNewGesture() const;
+    bool hasNewGesture() const { return newGesture; }
     TouchGesture getLastGestureType() const { return currentGesture.type; }
     void clearGesture();
     
-    // Calibration
+    // Event queues - drain these instead of polling touch state
+    bool pollTouchEvent(TouchEvent& event) { return touchEvents.pop(event); }
+    bool pollGesture(GestureEvent& event) { return gestureEvents.pop(event); }
+    void flushEvents();
+    uint16_t getDroppedEventCount() const { return touchEvents.getDroppedCount(); }
+    TouchPoint eventToTouchPoint(const TouchEvent& event) const;
+    GestureRecognizer& getGestureRecognizer() { return gestureRecognizer; }
+    
+    // Calibration (3 to TOUCH_CALIBRATION_POINTS points, least-squares affine)
     bool startCalibration();
     bool calibratePoint(int16_t screenX, int16_t screenY);
+    uint8_t getCalibrationPointCount() const { return calibrationSampleCount; }
     bool finishCalibration();
     void loadCalibration();
     void saveCalibration();
@@ -141,6 +139,9 @@ public:
     TouchCalibration getCalibration() const { return calibration; }
     
     // Coordinate utilities
+    static int32_t distanceSquared(TouchPoint p1, TouchPoint p2) {
+        return touchDistanceSquared(p1.x, p1.y, p2.x, p2.y);
+    }
     bool isPointInRect(TouchPoint point, int16_t x, int16_t y, int16_t w, int16_t h);
     bool isPointInCircle(TouchPoint point, int16_t centerX, int16_t centerY, int16_t radius);
     
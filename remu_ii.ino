@@ -178,6 +178,10 @@ void loop() {
   
   // Frame rate control
   if (currentTime - lastFrameTime < TARGET_FRAME_TIME) {
+    // Keep sampling touch between frames so short taps are not lost
+    if (systemInitialized) {
+      touchInterface.update();
+    }
     delay(1); // Small delay to prevent tight looping
     return;
   }
@@ -215,10 +219,10 @@ void loop() {
     // Update app manager (handles current app and launcher)
     appManager.update();
     
-    // Handle touch input
-    TouchPoint currentTouch = touchInterface.getCurrentTouch();
-    if (currentTouch.isPressed || currentTouch.isNewPress || currentTouch.isNewRelease) {
-      appManager.handleTouch(currentTouch);
+    // Handle touch input - one call per queued down/move/up event
+    TouchEvent touchEvent;
+    while (touchInterface.pollTouchEvent(touchEvent)) {
+      appManager.handleTouch(touchInterface.eventToTouchPoint(touchEvent));
     }
     
     // Render current screen (launcher or current app)
@@ -434,39 +438,39 @@ void runTouchCalibration() {
     return;
   }
   
-  // Calibration point 1: Top-left corner
-  displayManager.clearScreen(COLOR_BLACK);
-  displayManager.setFont(FONT_MEDIUM);
-  displayManager.drawTextCentered(0, 50, SCREEN_WIDTH, "Touch Calibration", COLOR_RED_GLOW);
-  displayManager.drawTextCentered(0, 80, SCREEN_WIDTH, "Step 1/2", COLOR_WHITE);
-  displayManager.drawTextCentered(0, 110, SCREEN_WIDTH, "Touch TOP-LEFT", COLOR_WHITE);
-  displayManager.drawTextCentered(0, 130, SCREEN_WIDTH, "corner with stylus", COLOR_WHITE);
-  
-  // Draw target crosshair
-  displayManager.drawLine(5, 20, 15, 20, COLOR_RED_GLOW);
-  displayManager.drawLine(10, 15, 10, 25, COLOR_RED_GLOW);
-  
-  if (!touchInterface.calibratePoint(0, 0)) {
-    handleSystemError("Touch calibration point 1 failed");
-    return;
-  }
-  
-  delay(1000);
-  
-  // Calibration point 2: Bottom-right corner
-  displayManager.clearScreen(COLOR_BLACK);
-  displayManager.drawTextCentered(0, 50, SCREEN_WIDTH, "Touch Calibration", COLOR_RED_GLOW);
-  displayManager.drawTextCentered(0, 80, SCREEN_WIDTH, "Step 2/2", COLOR_WHITE);
-  displayManager.drawTextCentered(0, 110, SCREEN_WIDTH, "Touch BOTTOM-RIGHT", COLOR_WHITE);
-  displayManager.drawTextCentered(0, 130, SCREEN_WIDTH, "corner with stylus", COLOR_WHITE);
-  
-  // Draw target crosshair
-  displayManager.drawLine(SCREEN_WIDTH-15, SCREEN_HEIGHT-20, SCREEN_WIDTH-5, SCREEN_HEIGHT-20, COLOR_RED_GLOW);
-  displayManager.drawLine(SCREEN_WIDTH-10, SCREEN_HEIGHT-25, SCREEN_WIDTH-10, SCREEN_HEIGHT-15, COLOR_RED_GLOW);
-  
-  if (!touchInterface.calibratePoint(SCREEN_WIDTH-1, SCREEN_HEIGHT-1)) {
-    handleSystemError("Touch calibration point 2 failed");
-    return;
+  // Targets inset from the edges (the panel is unreliable at the border);
+  // four corners plus center give a least-squares affine fit
+  const int16_t inset = 20;
+  const int16_t targets[TOUCH_CALIBRATION_POINTS][2] = {
+    {inset, inset},
+    {SCREEN_WIDTH - 1 - inset, inset},
+    {SCREEN_WIDTH - 1 - inset, SCREEN_HEIGHT - 1 - inset},
+    {inset, SCREEN_HEIGHT - 1 - inset},
+    {SCREEN_WIDTH / 2, SCREEN_HEIGHT / 2}
+  };
+  
+  for (uint8_t i = 0; i < TOUCH_CALIBRATION_POINTS; i++) {
+    int16_t tx = targets[i][0];
+    int16_t ty = targets[i][1];
+    
+    displayManager.clearScreen(COLOR_BLACK);
+    displayManager.setFont(FONT_MEDIUM);
+    displayManager.drawTextCentered(0, 50, SCREEN_WIDTH, "Touch Calibration", COLOR_RED_GLOW);
+    displayManager.drawTextCentered(0, 80, SCREEN_WIDTH,
+                                    "Step " + String(i + 1) + "/" + String(TOUCH_CALIBRATION_POINTS), COLOR_WHITE);
+    displayManager.drawTextCentered(0, 150, SCREEN_WIDTH, "Touch the cross", COLOR_WHITE);
+    displayManager.drawTextCentered(0, 170, SCREEN_WIDTH, "with stylus", COLOR_WHITE);
+    
+    // Draw target crosshair
+    displayManager.drawLine(tx - 5, ty, tx + 5, ty, COLOR_RED_GLOW);
+    displayManager.drawLine(tx, ty - 5, tx, ty + 5, COLOR_RED_GLOW);
+    
+    if (!touchInterface.calibratePoint(tx, ty)) {
+      handleSystemError("Touch calibration point " + String(i + 1) + " failed");
+      return;
+    }
+    
+    delay(500);
   }
   
   // Finish calibration
@@ -479,7 +483,7 @@ void runTouchCalibration() {
     
     Serial.println("[MAIN] Touch calibration successful");
   } else {
-    handleSystemError("Failed to save calibration");
+    handleSystemError("Touch calibration solve failed");
   }
 }
 
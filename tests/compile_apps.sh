@@ -0,0 +1,29 @@
+#!/bin/sh
+# ========================================
+# compile_apps - Syntax-checks the app translation units on the host
+# against the declaration-only Arduino/ESP32 headers in tests/stubs.
+# Nothing is linked; this catches what the real toolchain would reject.
+# Run from the repository root:
+#   sh tests/compile_apps.sh
+# CXX can be overridden from the environment.
+# ========================================
+
+CXX=${CXX:-g++}
+FLAGS="-std=gnu++17 -fsyntax-only -Wall -Itests/stubs"
+failed=0
+
+check() {
+    if ! $CXX $FLAGS "$@"; then
+        echo "$1: compile check failed"
+        failed=1
+    else
+        echo "$1: ok"
+    fi
+}
+
+check core/Audio/DacOutput.cpp
+check apps/EntropyBeacon/EntropyBeacon.cpp
+check apps/PreqScanner/FreqScanner.cpp
+check apps/BLEScanner/BLEScanner.cpp
+
+exit $failed
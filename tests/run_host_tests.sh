@@ -0,0 +1,81 @@
+#!/bin/sh
+# ========================================
+# run_host_tests - Builds and runs the host tests in tests/
+# Run from the repository root:
+#   sh tests/run_host_tests.sh
+# CXX and OUT (build directory, also where tests write WAV files) can be
+# overridden from the environment.
+# ========================================
+
+CXX=${CXX:-g++}
+OUT=${OUT:-/tmp/remu_host_tests}
+FLAGS="-std=gnu++17 -O2 -Wall -Wextra -Itests"
+mkdir -p "$OUT"
+export OUT                      # Tests that write files put them here
+failed=0
+
+run() {
+    name=$1
+    shift
+    if ! $CXX $FLAGS -o "$OUT/$name" "$@"; then
+        echo "$name: build failed"
+        failed=1
+    elif ! "$OUT/$name"; then
+        failed=1
+    fi
+}
+
+run test_gesture_recognizer -Icore/TouchInterface tests/test_gesture_recognizer.cpp \
+    core/TouchInterface/GestureRecognizer.cpp core/TouchInterface/TouchFilter.cpp
+run test_touch_filter -Icore/TouchInterface tests/test_touch_filter.cpp \
+    core/TouchInterface/TouchFilter.cpp
+run test_waterfall_ring -Iapps/PreqScanner tests/test_waterfall_ring.cpp \
+    apps/PreqScanner/WaterfallRing.cpp
+run test_waterfall_binmap -Iapps/PreqScanner tests/test_waterfall_binmap.cpp \
+    apps/PreqScanner/WaterfallRing.cpp
+run test_spectrum_accumulator -Iapps/PreqScanner tests/test_spectrum_accumulator.cpp \
+    apps/PreqScanner/SpectrumAccumulator.cpp
+run test_peak_tracker -Iapps/PreqScanner tests/test_peak_tracker.cpp \
+    apps/PreqScanner/PeakTracker.cpp
+run test_dds_generator -Iapps/PreqScanner tests/test_dds_generator.cpp \
+    apps/PreqScanner/DDSGenerator.cpp
+run test_zoom_fft -Iapps/PreqScanner tests/test_zoom_fft.cpp \
+    apps/PreqScanner/ZoomFFT.cpp apps/PreqScanner/DDSGenerator.cpp
+run test_tone_monitor -Iapps/PreqScanner tests/test_tone_monitor.cpp \
+    apps/PreqScanner/ToneMonitor.cpp
+run test_window_tables -Iapps/PreqScanner tests/test_window_tables.cpp \
+    apps/PreqScanner/WindowTables.cpp
+run test_recording_format -Iapps/PreqScanner tests/test_recording_format.cpp \
+    apps/PreqScanner/RecordingFormat.cpp
+run test_lz_estimator -Iapps/EntropyBeacon tests/test_lz_estimator.cpp \
+    apps/EntropyBeacon/LZEstimator.cpp
+run test_sample_store -Iapps/EntropyBeacon tests/test_sample_store.cpp \
+    apps/EntropyBeacon/EntropySampleStore.cpp
+run test_min_entropy -Iapps/EntropyBeacon tests/test_min_entropy.cpp \
+    apps/EntropyBeacon/MinEntropyEstimator.cpp
+run test_spsc_ring -pthread -Iapps/EntropyBeacon -Iapps/BLEScanner tests/test_spsc_ring.cpp \
+    apps/EntropyBeacon/SampleBlockQueue.cpp apps/BLEScanner/SightingRecord.cpp
+run test_acquisition_rates -pthread -Iapps/EntropyBeacon tests/test_acquisition_rates.cpp \
+    apps/EntropyBeacon/SampleBlockQueue.cpp apps/EntropyBeacon/EntropyStats.cpp \
+    apps/EntropyBeacon/LZEstimator.cpp apps/EntropyBeacon/MinEntropyEstimator.cpp \
+    apps/EntropyBeacon/AnomalyEngine.cpp apps/EntropyBeacon/EntropySampleStore.cpp
+run test_generator_bank -Iapps/EntropyBeacon tests/test_generator_bank.cpp \
+    apps/EntropyBeacon/EntropyGeneratorBank.cpp
+run test_entropy_stats -Iapps/EntropyBeacon tests/test_entropy_stats.cpp \
+    apps/EntropyBeacon/EntropyStats.cpp
+run test_entropy_synth -Iapps/EntropyBeacon tests/test_entropy_synth.cpp \
+    apps/EntropyBeacon/EntropySynth.cpp
+run test_anomaly_engine -Iapps/EntropyBeacon tests/test_anomaly_engine.cpp \
+    apps/EntropyBeacon/AnomalyEngine.cpp
+run test_plot_layers -Iapps/EntropyBeacon tests/test_plot_layers.cpp \
+    apps/EntropyBeacon/PlotLayers.cpp
+run test_signal_history -Iapps/BLEScanner tests/test_signal_history.cpp \
+    apps/BLEScanner/SignalHistory.cpp
+run test_sighting_log -Iapps/BLEScanner tests/test_sighting_log.cpp \
+    apps/BLEScanner/SightingLog.cpp apps/BLEScanner/BLEDeviceTable.cpp
+run test_device_table -Iapps/BLEScanner tests/test_device_table.cpp \
+    apps/BLEScanner/BLEDeviceTable.cpp
+run test_spoof_index -Iapps/BLEScanner tests/test_spoof_index.cpp \
+    apps/BLEScanner/SpoofIndex.cpp
+
+exit $failed
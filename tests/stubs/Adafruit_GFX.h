@@ -0,0 +1,44 @@
+#ifndef STUB_ADAFRUIT_GFX_H
+#define STUB_ADAFRUIT_GFX_H
+
+// Adafruit_GFX.h stub - declarations only, see Arduino.h
+
+#include <Arduino.h>
+
+class Adafruit_GFX : public Print {
+public:
+    Adafruit_GFX(int16_t w, int16_t h);
+    virtual void drawPixel(int16_t x, int16_t y, uint16_t color) = 0;
+    virtual void startWrite();
+    virtual void endWrite();
+    virtual void fillScreen(uint16_t color);
+    virtual void fillRect(int16_t x, int16_t y, int16_t w, int16_t h, uint16_t color);
+    virtual void drawRect(int16_t x, int16_t y, int16_t w, int16_t h, uint16_t color);
+    virtual void drawFastHLine(int16_t x, int16_t y, int16_t w, uint16_t color);
+    virtual void drawFastVLine(int16_t x, int16_t y, int16_t h, uint16_t color);
+    virtual void drawLine(int16_t x0, int16_t y0, int16_t x1, int16_t y1, uint16_t color);
+    virtual void setRotation(uint8_t r);
+    void drawCircle(int16_t x, int16_t y, int16_t r, uint16_t color);
+    void fillCircle(int16_t x, int16_t y, int16_t r, uint16_t color);
+    void drawRoundRect(int16_t x, int16_t y, int16_t w, int16_t h, int16_t r, uint16_t color);
+    void fillRoundRect(int16_t x, int16_t y, int16_t w, int16_t h, int16_t r, uint16_t color);
+    void drawTriangle(int16_t x0, int16_t y0, int16_t x1, int16_t y1, int16_t x2, int16_t y2, uint16_t color);
+    void fillTriangle(int16_t x0, int16_t y0, int16_t x1, int16_t y1, int16_t x2, int16_t y2, uint16_t color);
+    void drawBitmap(int16_t x, int16_t y, const uint8_t* bitmap, int16_t w, int16_t h, uint16_t color);
+    void drawRGBBitmap(int16_t x, int16_t y, const uint16_t* bitmap, int16_t w, int16_t h);
+    void setCursor(int16_t x, int16_t y);
+    void setTextColor(uint16_t color);
+    void setTextColor(uint16_t color, uint16_t background);
+    void setTextSize(uint8_t size);
+    void setTextWrap(bool wrap);
+    void getTextBounds(const char* s, int16_t x, int16_t y, int16_t* x1, int16_t* y1, uint16_t* w, uint16_t* h);
+    void getTextBounds(const String& s, int16_t x, int16_t y, int16_t* x1, int16_t* y1, uint16_t* w, uint16_t* h);
+    int16_t width() const;
+    int16_t height() const;
+    int16_t getCursorX() const;
+    int16_t getCursorY() const;
+    size_t write(uint8_t c) override;
+    using Print::write;
+};
+
+#endif // STUB_ADAFRUIT_GFX_H
@@ -0,0 +1,36 @@
+#ifndef STUB_ADAFRUIT_ILI9341_H
+#define STUB_ADAFRUIT_ILI9341_H
+
+// Adafruit_ILI9341.h stub - declarations only, see Arduino.h
+
+#include <Adafruit_GFX.h>
+#include <SPI.h>
+
+#define ILI9341_TFTWIDTH    240
+#define ILI9341_TFTHEIGHT   320
+#define ILI9341_BLACK       0x0000
+#define ILI9341_WHITE       0xFFFF
+#define ILI9341_VSCRDEF     0x33
+#define ILI9341_VSCRSADD    0x37
+
+class Adafruit_ILI9341 : public Adafruit_GFX {
+public:
+    Adafruit_ILI9341(int8_t cs, int8_t dc, int8_t rst = -1);
+    Adafruit_ILI9341(int8_t cs, int8_t dc, int8_t mosi, int8_t sclk, int8_t rst = -1, int8_t miso = -1);
+    Adafruit_ILI9341(SPIClass* spi, int8_t dc, int8_t cs = -1, int8_t rst = -1);
+    void begin(uint32_t freq = 0);
+    void drawPixel(int16_t x, int16_t y, uint16_t color) override;
+    void setRotation(uint8_t r) override;
+    void invertDisplay(bool invert);
+    void scrollTo(uint16_t y);
+    void setScrollMargins(uint16_t top, uint16_t bottom);
+    void setAddrWindow(uint16_t x, uint16_t y, uint16_t w, uint16_t h);
+    void writePixels(uint16_t* colors, uint32_t len, bool block = true, bool bigEndian = false);
+    void writeColor(uint16_t color, uint32_t len);
+    void pushColor(uint16_t color);
+    void sendCommand(uint8_t command, const uint8_t* data = nullptr, uint8_t bytes = 0);
+    uint8_t readcommand8(uint8_t command, uint8_t index = 0);
+    uint16_t color565(uint8_t r, uint8_t g, uint8_t b);
+};
+
+#endif // STUB_ADAFRUIT_ILI9341_H
@@ -0,0 +1,290 @@
+#ifndef STUB_ARDUINO_H
+#define STUB_ARDUINO_H
+
+// ========================================
+// Arduino.h stub - Declarations only, for compile-checking app
+// translation units on the host (tests/compile_apps.sh). Nothing here
+// links; it covers the subset of the Arduino-ESP32 and FreeRTOS API
+// the apps use.
+// ========================================
+
+#include <stdint.h>
+#include <stddef.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <math.h>
+#include <algorithm>
+
+using std::min;
+using std::max;
+
+typedef uint8_t byte;
+typedef bool boolean;
+
+#define HIGH                0x1
+#define LOW                 0x0
+#define INPUT               0x01
+#define OUTPUT              0x03
+#define INPUT_PULLUP        0x05
+#define INPUT_PULLDOWN      0x09
+#define DEC                 10
+#define HEX                 16
+#define BIN                 2
+#define PI                  3.1415926535897932384626433832795
+#define TWO_PI              6.283185307179586476925286766559
+#define DEG_TO_RAD          0.017453292519943295769236907684886
+#define RAD_TO_DEG          57.295779513082320876798154814105
+#define IRAM_ATTR
+#define ADC_11db            3
+#define ADC_0db             0
+#define A0                  36
+#define A1                  39
+
+#define constrain(amt, low, high) ((amt) < (low) ? (low) : ((amt) > (high) ? (high) : (amt)))
+#define bitRead(value, bit) (((value) >> (bit)) & 0x01)
+
+class __FlashStringHelper;
+#define F(s) (s)
+
+class String {
+public:
+    String(const char* s = "");
+    String(const String& s);
+    String(char c);
+    String(int value, unsigned char base = 10);
+    String(unsigned int value, unsigned char base = 10);
+    String(long value, unsigned char base = 10);
+    String(unsigned long value, unsigned char base = 10);
+    String(long long value, unsigned char base = 10);
+    String(unsigned long long value, unsigned char base = 10);
+    String(float value, unsigned char decimals = 2);
+    String(double value, unsigned char decimals = 2);
+    ~String();
+
+    String& operator=(const String& rhs);
+    String& operator=(const char* rhs);
+    String& operator+=(const String& rhs);
+    String& operator+=(const char* rhs);
+    String& operator+=(char c);
+    String& operator+=(int value);
+    String& operator+=(unsigned int value);
+    String& operator+=(long value);
+    String& operator+=(unsigned long value);
+    String& operator+=(float value);
+    String& operator+=(double value);
+    bool concat(const String& s);
+    bool concat(const char* s);
+    bool concat(char c);
+
+    bool operator==(const String& rhs) const;
+    bool operator==(const char* rhs) const;
+    bool operator!=(const String& rhs) const;
+    bool operator!=(const char* rhs) const;
+    bool operator<(const String& rhs) const;
+    char operator[](unsigned int index) const;
+    char& operator[](unsigned int index);
+
+    const char* c_str() const;
+    unsigned int length() const;
+    bool isEmpty() const;
+    bool equals(const String& s) const;
+    bool equalsIgnoreCase(const String& s) const;
+    bool startsWith(const String& s) const;
+    bool endsWith(const String& s) const;
+    int indexOf(char c, unsigned int from = 0) const;
+    int indexOf(const String& s, unsigned int from = 0) const;
+    int lastIndexOf(char c) const;
+    int lastIndexOf(const String& s) const;
+    String substring(unsigned int from) const;
+    String substring(unsigned int from, unsigned int to) const;
+    char charAt(unsigned int index) const;
+    void setCharAt(unsigned int index, char c);
+    void toUpperCase();
+    void toLowerCase();
+    void trim();
+    void replace(const String& find, const String& with);
+    void remove(unsigned int index);
+    void remove(unsigned int index, unsigned int count);
+    void reserve(unsigned int size);
+    long toInt() const;
+    float toFloat() const;
+    void toCharArray(char* buf, unsigned int size, unsigned int index = 0) const;
+    void getBytes(unsigned char* buf, unsigned int size, unsigned int index = 0) const;
+};
+
+String operator+(const String& lhs, const String& rhs);
+String operator+(const String& lhs, const char* rhs);
+String operator+(const char* lhs, const String& rhs);
+String operator+(const String& lhs, char rhs);
+String operator+(const String& lhs, int rhs);
+String operator+(const String& lhs, unsigned int rhs);
+String operator+(const String& lhs, long rhs);
+String operator+(const String& lhs, unsigned long rhs);
+String operator+(const String& lhs, float rhs);
+String operator+(const String& lhs, double rhs);
+
+class Print {
+public:
+    virtual ~Print() {}
+    virtual size_t write(uint8_t c) = 0;
+    virtual size_t write(const uint8_t* buffer, size_t size);
+    size_t write(const char* s);
+    size_t print(const String& s);
+    size_t print(const char* s);
+    size_t print(char c);
+    size_t print(int value, int base = DEC);
+    size_t print(unsigned int value, int base = DEC);
+    size_t print(long value, int base = DEC);
+    size_t print(unsigned long value, int base = DEC);
+    size_t print(double value, int digits = 2);
+    size_t println(const String& s);
+    size_t println(const char* s);
+    size_t println(char c);
+    size_t println(int value, int base = DEC);
+    size_t println(unsigned int value, int base = DEC);
+    size_t println(long value, int base = DEC);
+    size_t println(unsigned long value, int base = DEC);
+    size_t println(double value, int digits = 2);
+    size_t println();
+    size_t printf(const char* format, ...) __attribute__((format(printf, 2, 3)));
+};
+
+class Stream : public Print {
+public:
+    virtual int available() = 0;
+    virtual int read() = 0;
+    virtual int peek() = 0;
+    size_t readBytes(uint8_t* buffer, size_t length);
+    size_t readBytes(char* buffer, size_t length);
+    String readString();
+    String readStringUntil(char terminator);
+};
+
+class HardwareSerial : public Stream {
+public:
+    void begin(unsigned long baud);
+    void end();
+    void flush();
+    int available() override;
+    int read() override;
+    int peek() override;
+    size_t write(uint8_t c) override;
+    using Print::write;
+    operator bool() const;
+};
+extern HardwareSerial Serial;
+
+unsigned long millis();
+unsigned long micros();
+void delay(uint32_t ms);
+void delayMicroseconds(uint32_t us);
+void yield();
+
+void pinMode(uint8_t pin, uint8_t mode);
+void digitalWrite(uint8_t pin, uint8_t value);
+int digitalRead(uint8_t pin);
+uint16_t analogRead(uint8_t pin);
+void analogWrite(uint8_t pin, int value);
+void analogReadResolution(uint8_t bits);
+void analogSetAttenuation(uint8_t attenuation);
+void analogSetPinAttenuation(uint8_t pin, uint8_t attenuation);
+void dacWrite(uint8_t pin, uint8_t value);
+void ledcSetup(uint8_t channel, double freq, uint8_t resolution);
+void ledcAttachPin(uint8_t pin, uint8_t channel);
+void ledcWrite(uint8_t channel, uint32_t duty);
+void ledcWriteTone(uint8_t channel, double freq);
+void attachInterrupt(uint8_t pin, void (*handler)(void), int mode);
+void detachInterrupt(uint8_t pin);
+uint8_t digitalPinToInterrupt(uint8_t pin);
+#define RISING              0x01
+#define FALLING             0x02
+#define CHANGE              0x03
+
+long random(long max);
+long random(long min, long max);
+void randomSeed(unsigned long seed);
+long map(long x, long inMin, long inMax, long outMin, long outMax);
+uint32_t esp_random();
+
+// FreeRTOS
+typedef int BaseType_t;
+typedef unsigned int UBaseType_t;
+typedef uint32_t TickType_t;
+typedef void* TaskHandle_t;
+typedef void* SemaphoreHandle_t;
+typedef void* QueueHandle_t;
+typedef void (*TaskFunction_t)(void*);
+typedef struct { volatile uint32_t owner; volatile uint32_t count; } portMUX_TYPE;
+
+#define pdTRUE              1
+#define pdFALSE             0
+#define pdPASS              1
+#define pdFAIL              0
+#define portMAX_DELAY       0xFFFFFFFFu
+#define portTICK_PERIOD_MS  1
+#define portMUX_INITIALIZER_UNLOCKED {0, 0}
+#define pdMS_TO_TICKS(ms)   ((TickType_t)(ms))
+#define tskIDLE_PRIORITY    0
+#define configMAX_PRIORITIES 25
+
+void portENTER_CRITICAL(portMUX_TYPE* mux);
+void portEXIT_CRITICAL(portMUX_TYPE* mux);
+void portENTER_CRITICAL_ISR(portMUX_TYPE* mux);
+void portEXIT_CRITICAL_ISR(portMUX_TYPE* mux);
+void taskENTER_CRITICAL(portMUX_TYPE* mux);
+void taskEXIT_CRITICAL(portMUX_TYPE* mux);
+
+BaseType_t xTaskCreate(TaskFunction_t fn, const char* name, uint32_t stack, void* param,
+                       UBaseType_t priority, TaskHandle_t* handle);
+BaseType_t xTaskCreatePinnedToCore(TaskFunction_t fn, const char* name, uint32_t stack, void* param,
+                                   UBaseType_t priority, TaskHandle_t* handle, BaseType_t core);
+void vTaskDelete(TaskHandle_t task);
+void vTaskDelay(TickType_t ticks);
+void vTaskSuspend(TaskHandle_t task);
+void vTaskResume(TaskHandle_t task);
+TickType_t xTaskGetTickCount();
+TaskHandle_t xTaskGetCurrentTaskHandle();
+UBaseType_t uxTaskGetStackHighWaterMark(TaskHandle_t task);
+BaseType_t xPortGetCoreID();
+uint32_t ulTaskNotifyTake(BaseType_t clearOnExit, TickType_t wait);
+BaseType_t xTaskNotifyGive(TaskHandle_t task);
+
+SemaphoreHandle_t xSemaphoreCreateMutex();
+SemaphoreHandle_t xSemaphoreCreateBinary();
+SemaphoreHandle_t xSemaphoreCreateCounting(UBaseType_t max, UBaseType_t initial);
+BaseType_t xSemaphoreTake(SemaphoreHandle_t sem, TickType_t wait);
+BaseType_t xSemaphoreGive(SemaphoreHandle_t sem);
+BaseType_t xSemaphoreGiveFromISR(SemaphoreHandle_t sem, BaseType_t* woken);
+void vSemaphoreDelete(SemaphoreHandle_t sem);
+
+QueueHandle_t xQueueCreate(UBaseType_t length, UBaseType_t itemSize);
+BaseType_t xQueueSend(QueueHandle_t queue, const void* item, TickType_t wait);
+BaseType_t xQueueReceive(QueueHandle_t queue, void* item, TickType_t wait);
+UBaseType_t uxQueueMessagesWaiting(QueueHandle_t queue);
+void vQueueDelete(QueueHandle_t queue);
+
+class EspClass {
+public:
+    uint32_t getFreeHeap();
+    uint32_t getMinFreeHeap();
+    uint32_t getHeapSize();
+    uint32_t getMaxAllocHeap();
+    uint32_t getFreePsram();
+    uint32_t getPsramSize();
+    uint32_t getCpuFreqMHz();
+    uint32_t getFlashChipSize();
+    uint32_t getCycleCount();
+    uint64_t getEfuseMac();
+    const char* getChipModel();
+    const char* getSdkVersion();
+    void restart();
+};
+extern EspClass ESP;
+
+void* ps_malloc(size_t size);
+uint32_t getCpuFrequencyMhz();
+bool setCpuFrequencyMhz(uint32_t mhz);
+float temperatureRead();
+
+#endif // STUB_ARDUINO_H
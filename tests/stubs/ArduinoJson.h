@@ -0,0 +1,111 @@
+#ifndef STUB_ARDUINO_JSON_H
+#define STUB_ARDUINO_JSON_H
+
+// ArduinoJson.h stub - ArduinoJson 6 declarations only, see Arduino.h
+
+#include <Arduino.h>
+
+class JsonObject;
+class JsonArray;
+
+class JsonVariant {
+public:
+    template <typename T> JsonVariant& operator=(const T& value);
+    template <typename T> T as() const;
+    template <typename T> bool is() const;
+    template <typename T> operator T() const;
+    JsonVariant operator[](const char* key) const;
+    JsonVariant operator[](const String& key) const;
+    JsonVariant operator[](int index) const;
+    JsonObject createNestedObject(const char* key) const;
+    JsonArray createNestedArray(const char* key) const;
+    bool containsKey(const char* key) const;
+    bool isNull() const;
+    size_t size() const;
+    template <typename T> bool set(const T& value);
+    template <typename T> bool operator==(const T& value) const;
+    template <typename T> bool operator!=(const T& value) const;
+};
+
+template <typename T> T operator|(const JsonVariant& variant, const T& fallback);
+String operator|(const JsonVariant& variant, const char* fallback);
+
+class JsonPair {
+public:
+    struct Key { const char* c_str() const; };
+    Key key() const;
+    JsonVariant value() const;
+};
+
+class JsonObject : public JsonVariant {
+public:
+    JsonVariant operator[](const char* key) const;
+    JsonVariant operator[](const String& key) const;
+    JsonObject createNestedObject(const char* key) const;
+    JsonObject createNestedObject(const String& key) const;
+    JsonArray createNestedArray(const char* key) const;
+    JsonArray createNestedArray(const String& key) const;
+    bool containsKey(const char* key) const;
+    void remove(const char* key);
+    JsonPair* begin() const;
+    JsonPair* end() const;
+};
+
+class JsonArray : public JsonVariant {
+public:
+    template <typename T> bool add(const T& value);
+    JsonObject createNestedObject() const;
+    JsonArray createNestedArray() const;
+    JsonVariant operator[](int index) const;
+    JsonVariant* begin() const;
+    JsonVariant* end() const;
+};
+
+class JsonDocument {
+public:
+    JsonVariant operator[](const char* key);
+    JsonVariant operator[](const String& key);
+    JsonVariant operator[](int index);
+    JsonObject createNestedObject(const char* key);
+    JsonObject createNestedObject(const String& key);
+    JsonObject createNestedObject();
+    JsonArray createNestedArray(const char* key);
+    JsonArray createNestedArray(const String& key);
+    JsonArray createNestedArray();
+    template <typename T> T as();
+    template <typename T> T to();
+    bool containsKey(const char* key) const;
+    void clear();
+    size_t memoryUsage() const;
+    bool overflowed() const;
+};
+
+class DynamicJsonDocument : public JsonDocument {
+public:
+    explicit DynamicJsonDocument(size_t capacity);
+};
+
+template <size_t N>
+class StaticJsonDocument : public JsonDocument {};
+
+class DeserializationError {
+public:
+    enum Code { Ok, EmptyInput, IncompleteInput, InvalidInput, NoMemory, TooDeep };
+    operator bool() const;
+    bool operator==(Code code) const;
+    bool operator!=(Code code) const;
+    const char* c_str() const;
+    Code code() const;
+};
+
+size_t serializeJson(const JsonDocument& doc, Print& out);
+size_t serializeJson(const JsonDocument& doc, String& out);
+size_t serializeJson(const JsonDocument& doc, char* out, size_t size);
+size_t serializeJsonPretty(const JsonDocument& doc, Print& out);
+size_t serializeJsonPretty(const JsonDocument& doc, String& out);
+size_t measureJson(const JsonDocument& doc);
+DeserializationError deserializeJson(JsonDocument& doc, const String& input);
+DeserializationError deserializeJson(JsonDocument& doc, const char* input);
+DeserializationError deserializeJson(JsonDocument& doc, Stream& input);
+
+#endif // STUB_ARDUINO_JSON_H
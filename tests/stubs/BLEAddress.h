@@ -0,0 +1,27 @@
+#ifndef STUB_BLE_ADDRESS_H
+#define STUB_BLE_ADDRESS_H
+
+// BLEAddress.h stub - declarations only, see Arduino.h
+
+#include <Arduino.h>
+#include <string>
+
+typedef uint8_t esp_bd_addr_t[6];
+
+typedef enum {
+    BLE_ADDR_TYPE_PUBLIC = 0x00,
+    BLE_ADDR_TYPE_RANDOM = 0x01,
+    BLE_ADDR_TYPE_RPA_PUBLIC = 0x02,
+    BLE_ADDR_TYPE_RPA_RANDOM = 0x03
+} esp_ble_addr_type_t;
+
+class BLEAddress {
+public:
+    BLEAddress(esp_bd_addr_t address);
+    BLEAddress(std::string stringAddress);
+    bool equals(BLEAddress otherAddress);
+    esp_bd_addr_t* getNative();
+    std::string toString();
+};
+
+#endif // STUB_BLE_ADDRESS_H
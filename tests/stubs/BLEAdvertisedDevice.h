@@ -0,0 +1,40 @@
+#ifndef STUB_BLE_ADVERTISED_DEVICE_H
+#define STUB_BLE_ADVERTISED_DEVICE_H
+
+// BLEAdvertisedDevice.h stub - declarations only, see Arduino.h
+
+#include "BLEAddress.h"
+#include "BLEUUID.h"
+
+class BLEAdvertisedDevice {
+public:
+    BLEAddress getAddress();
+    esp_ble_addr_type_t getAddressType();
+    uint16_t getAppearance();
+    std::string getManufacturerData();
+    std::string getName();
+    int getRSSI();
+    BLEUUID getServiceUUID();
+    int8_t getTXPower();
+    uint8_t* getPayload();
+    size_t getPayloadLength();
+
+    bool haveAppearance();
+    bool haveManufacturerData();
+    bool haveName();
+    bool haveRSSI();
+    bool haveServiceUUID();
+    bool haveTXPower();
+    bool isAdvertisingService(BLEUUID uuid);
+
+    std::string toString();
+};
+
+class BLEAdvertisedDeviceCallbacks {
+public:
+    virtual ~BLEAdvertisedDeviceCallbacks() {}
+    // Called on the BLE task for each advertisement received
+    virtual void onResult(BLEAdvertisedDevice advertisedDevice) = 0;
+};
+
+#endif // STUB_BLE_ADVERTISED_DEVICE_H
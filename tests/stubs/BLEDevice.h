@@ -0,0 +1,18 @@
+#ifndef STUB_BLE_DEVICE_H
+#define STUB_BLE_DEVICE_H
+
+// BLEDevice.h stub - declarations only, see Arduino.h
+
+#include "BLEScan.h"
+#include "BLEUtils.h"
+
+class BLEDevice {
+public:
+    static void init(std::string deviceName);
+    static void deinit(bool releaseMemory = false);
+    static BLEScan* getScan();
+    static BLEAddress getAddress();
+    static bool getInitialized();
+};
+
+#endif // STUB_BLE_DEVICE_H
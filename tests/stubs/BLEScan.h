@@ -0,0 +1,30 @@
+#ifndef STUB_BLE_SCAN_H
+#define STUB_BLE_SCAN_H
+
+// BLEScan.h stub - declarations only, see Arduino.h
+
+#include "BLEAdvertisedDevice.h"
+
+class BLEScanResults {
+public:
+    int getCount();
+    BLEAdvertisedDevice getDevice(uint32_t i);
+};
+
+class BLEScan {
+public:
+    void setActiveScan(bool active);
+    // wantDuplicates reports every advertisement, not just the first per device
+    void setAdvertisedDeviceCallbacks(BLEAdvertisedDeviceCallbacks* callbacks,
+                                      bool wantDuplicates = false, bool shouldParse = true);
+    void setInterval(uint16_t intervalMSecs);
+    void setWindow(uint16_t windowMSecs);
+    bool start(uint32_t duration, void (*scanCompleteCB)(BLEScanResults), bool isContinue = false);
+    BLEScanResults start(uint32_t duration, bool isContinue = false);
+    void stop();
+    void erase(BLEAddress address);
+    BLEScanResults getResults();
+    void clearResults();
+};
+
+#endif // STUB_BLE_SCAN_H
@@ -0,0 +1,19 @@
+#ifndef STUB_BLE_UUID_H
+#define STUB_BLE_UUID_H
+
+// BLEUUID.h stub - declarations only, see Arduino.h
+
+#include <Arduino.h>
+#include <string>
+
+class BLEUUID {
+public:
+    BLEUUID();
+    BLEUUID(std::string uuid);
+    BLEUUID(uint16_t uuid);
+    bool equals(BLEUUID uuid);
+    uint8_t bitSize();
+    std::string toString();
+};
+
+#endif // STUB_BLE_UUID_H
@@ -0,0 +1,14 @@
+#ifndef STUB_BLE_UTILS_H
+#define STUB_BLE_UTILS_H
+
+// BLEUtils.h stub - declarations only, see Arduino.h
+
+#include "BLEAddress.h"
+
+class BLEUtils {
+public:
+    static const char* addressTypeToString(esp_ble_addr_type_t type);
+    static std::string buildHexData(uint8_t* target, uint8_t* source, uint8_t length);
+};
+
+#endif // STUB_BLE_UTILS_H
@@ -0,0 +1,19 @@
+#ifndef STUB_EEPROM_H
+#define STUB_EEPROM_H
+
+// EEPROM.h stub - declarations only, see Arduino.h
+
+#include <Arduino.h>
+
+class EEPROMClass {
+public:
+    bool begin(size_t size);
+    uint8_t read(int address);
+    void write(int address, uint8_t value);
+    bool commit();
+    template <typename T> T& get(int address, T& value);
+    template <typename T> const T& put(int address, const T& value);
+};
+extern EEPROMClass EEPROM;
+
+#endif // STUB_EEPROM_H
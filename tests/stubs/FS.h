@@ -0,0 +1,65 @@
+#ifndef STUB_FS_H
+#define STUB_FS_H
+
+// FS.h stub - declarations only, see Arduino.h
+
+#include <Arduino.h>
+
+#define FILE_READ           "r"
+#define FILE_WRITE          "w"
+#define FILE_APPEND         "a"
+
+namespace fs {
+
+enum SeekMode { SeekSet = 0, SeekCur = 1, SeekEnd = 2 };
+
+class File : public Stream {
+public:
+    File();
+    size_t write(uint8_t c) override;
+    size_t write(const uint8_t* buffer, size_t size) override;
+    using Print::write;
+    int available() override;
+    int read() override;
+    int peek() override;
+    size_t read(uint8_t* buffer, size_t size);
+    void flush();
+    bool seek(uint32_t pos, SeekMode mode = SeekSet);
+    size_t position() const;
+    size_t size() const;
+    void close();
+    operator bool() const;
+    const char* name() const;
+    const char* path() const;
+    bool isDirectory();
+    File openNextFile(const char* mode = FILE_READ);
+    void rewindDirectory();
+    time_t getLastWrite();
+};
+
+class FS {
+public:
+    File open(const char* path, const char* mode = FILE_READ, bool create = false);
+    File open(const String& path, const char* mode = FILE_READ, bool create = false);
+    bool exists(const char* path);
+    bool exists(const String& path);
+    bool remove(const char* path);
+    bool remove(const String& path);
+    bool rename(const char* from, const char* to);
+    bool rename(const String& from, const String& to);
+    bool mkdir(const char* path);
+    bool mkdir(const String& path);
+    bool rmdir(const char* path);
+    bool rmdir(const String& path);
+};
+
+} // namespace fs
+
+using fs::File;
+using fs::FS;
+using fs::SeekMode;
+using fs::SeekSet;
+using fs::SeekCur;
+using fs::SeekEnd;
+
+#endif // STUB_FS_H
@@ -0,0 +1,21 @@
+#ifndef STUB_SPI_H
+#define STUB_SPI_H
+
+// SPI.h stub - declarations only, see Arduino.h
+
+#include <Arduino.h>
+
+class SPIClass {
+public:
+    explicit SPIClass(uint8_t bus = 0);
+    void begin(int8_t sck = -1, int8_t miso = -1, int8_t mosi = -1, int8_t ss = -1);
+    void end();
+    void setFrequency(uint32_t freq);
+    uint8_t transfer(uint8_t data);
+};
+extern SPIClass SPI;
+
+#define VSPI                3
+#define HSPI                2
+
+#endif // STUB_SPI_H
@@ -0,0 +1,69 @@
+#ifndef STUB_DRIVER_I2S_H
+#define STUB_DRIVER_I2S_H
+
+// driver/i2s.h stub - declarations only, see Arduino.h
+
+#include <Arduino.h>
+#include <esp_timer.h>
+
+typedef enum { I2S_NUM_0 = 0, I2S_NUM_1 = 1 } i2s_port_t;
+
+typedef enum {
+    I2S_MODE_MASTER = 1, I2S_MODE_SLAVE = 2, I2S_MODE_TX = 4, I2S_MODE_RX = 8,
+    I2S_MODE_DAC_BUILT_IN = 16, I2S_MODE_ADC_BUILT_IN = 32
+} i2s_mode_t;
+
+typedef enum {
+    I2S_BITS_PER_SAMPLE_8BIT = 8, I2S_BITS_PER_SAMPLE_16BIT = 16,
+    I2S_BITS_PER_SAMPLE_24BIT = 24, I2S_BITS_PER_SAMPLE_32BIT = 32
+} i2s_bits_per_sample_t;
+
+typedef enum {
+    I2S_CHANNEL_FMT_RIGHT_LEFT, I2S_CHANNEL_FMT_ALL_RIGHT, I2S_CHANNEL_FMT_ALL_LEFT,
+    I2S_CHANNEL_FMT_ONLY_RIGHT, I2S_CHANNEL_FMT_ONLY_LEFT
+} i2s_channel_fmt_t;
+
+typedef enum {
+    I2S_COMM_FORMAT_STAND_I2S = 1, I2S_COMM_FORMAT_STAND_MSB = 3,
+    I2S_COMM_FORMAT_I2S_MSB = 3
+} i2s_comm_format_t;
+
+typedef enum {
+    I2S_DAC_CHANNEL_DISABLE = 0, I2S_DAC_CHANNEL_RIGHT_EN = 1,
+    I2S_DAC_CHANNEL_LEFT_EN = 2, I2S_DAC_CHANNEL_BOTH_EN = 3
+} i2s_dac_mode_t;
+
+typedef struct {
+    i2s_mode_t mode;
+    uint32_t sample_rate;
+    i2s_bits_per_sample_t bits_per_sample;
+    i2s_channel_fmt_t channel_format;
+    i2s_comm_format_t communication_format;
+    int intr_alloc_flags;
+    int dma_buf_count;
+    int dma_buf_len;
+    bool use_apll;
+    bool tx_desc_auto_clear;
+    int fixed_mclk;
+} i2s_config_t;
+
+typedef struct {
+    int bck_io_num;
+    int ws_io_num;
+    int data_out_num;
+    int data_in_num;
+} i2s_pin_config_t;
+
+#define I2S_PIN_NO_CHANGE   -1
+
+esp_err_t i2s_driver_install(i2s_port_t port, const i2s_config_t* config, int queueSize, void* queue);
+esp_err_t i2s_driver_uninstall(i2s_port_t port);
+esp_err_t i2s_set_pin(i2s_port_t port, const i2s_pin_config_t* pins);
+esp_err_t i2s_set_dac_mode(i2s_dac_mode_t mode);
+esp_err_t i2s_set_sample_rates(i2s_port_t port, uint32_t rate);
+esp_err_t i2s_write(i2s_port_t port, const void* src, size_t size, size_t* written, TickType_t wait);
+esp_err_t i2s_zero_dma_buffer(i2s_port_t port);
+esp_err_t i2s_start(i2s_port_t port);
+esp_err_t i2s_stop(i2s_port_t port);
+
+#endif // STUB_DRIVER_I2S_H
@@ -0,0 +1,23 @@
+#ifndef STUB_ESP_SYSTEM_H
+#define STUB_ESP_SYSTEM_H
+
+// esp_system.h stub - declarations only, see Arduino.h
+
+#include <esp_timer.h>
+
+typedef enum {
+    ESP_RST_UNKNOWN, ESP_RST_POWERON, ESP_RST_EXT, ESP_RST_SW, ESP_RST_PANIC,
+    ESP_RST_INT_WDT, ESP_RST_TASK_WDT, ESP_RST_WDT, ESP_RST_DEEPSLEEP,
+    ESP_RST_BROWNOUT, ESP_RST_SDIO
+} esp_reset_reason_t;
+
+esp_reset_reason_t esp_reset_reason();
+void esp_restart();
+void esp_deep_sleep(uint64_t us);
+void esp_deep_sleep_start();
+uint32_t esp_get_free_heap_size();
+uint32_t esp_get_minimum_free_heap_size();
+uint32_t esp_random();
+const char* esp_err_to_name(esp_err_t code);
+
+#endif // STUB_ESP_SYSTEM_H
@@ -0,0 +1,14 @@
+#ifndef STUB_ESP_TASK_WDT_H
+#define STUB_ESP_TASK_WDT_H
+
+// esp_task_wdt.h stub - declarations only, see Arduino.h
+
+#include <Arduino.h>
+#include <esp_timer.h>
+
+esp_err_t esp_task_wdt_init(uint32_t timeoutSeconds, bool panic);
+esp_err_t esp_task_wdt_add(TaskHandle_t task);
+esp_err_t esp_task_wdt_delete(TaskHandle_t task);
+esp_err_t esp_task_wdt_reset();
+
+#endif // STUB_ESP_TASK_WDT_H
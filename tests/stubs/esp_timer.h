@@ -0,0 +1,31 @@
+#ifndef STUB_ESP_TIMER_H
+#define STUB_ESP_TIMER_H
+
+// esp_timer.h stub - declarations only, see Arduino.h
+
+#include <stdint.h>
+
+typedef int esp_err_t;
+#define ESP_OK              0
+#define ESP_FAIL            -1
+
+typedef struct esp_timer* esp_timer_handle_t;
+typedef void (*esp_timer_cb_t)(void* arg);
+typedef enum { ESP_TIMER_TASK } esp_timer_dispatch_t;
+
+typedef struct {
+    esp_timer_cb_t callback;
+    void* arg;
+    esp_timer_dispatch_t dispatch_method;
+    const char* name;
+    bool skip_unhandled_events;
+} esp_timer_create_args_t;
+
+esp_err_t esp_timer_create(const esp_timer_create_args_t* args, esp_timer_handle_t* handle);
+esp_err_t esp_timer_start_periodic(esp_timer_handle_t timer, uint64_t period);
+esp_err_t esp_timer_start_once(esp_timer_handle_t timer, uint64_t timeout);
+esp_err_t esp_timer_stop(esp_timer_handle_t timer);
+esp_err_t esp_timer_delete(esp_timer_handle_t timer);
+int64_t esp_timer_get_time();
+
+#endif // STUB_ESP_TIMER_H
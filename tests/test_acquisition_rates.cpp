@@ -0,0 +1,253 @@
+// ========================================
+// test_acquisition_rates - Runs EntropyBeacon's acquisition at every
+// SampleRate on the host: a paced producer thread stands in for the
+// esp_timer callback and puts samples into a SampleBlockQueue, and the
+// main thread drains it every frame the way update() does, through the
+// per-sample EntropyStats, LZ, min-entropy and AnomalyEngine path and the
+// per-block stages. Reports samples/sec analysed, dropped samples and
+// the deepest backlog at each rate, then how many samples/sec the
+// analysis path takes when it never waits.
+// Build on the host (or run tests/run_host_tests.sh):
+//   g++ -O2 -pthread -Itests -Iapps/EntropyBeacon -o test_acquisition_rates
+//       tests/test_acquisition_rates.cpp apps/EntropyBeacon/SampleBlockQueue.cpp
+//       apps/EntropyBeacon/EntropyStats.cpp apps/EntropyBeacon/LZEstimator.cpp
+//       apps/EntropyBeacon/MinEntropyEstimator.cpp apps/EntropyBeacon/AnomalyEngine.cpp
+//       apps/EntropyBeacon/EntropySampleStore.cpp
+// ========================================
+
+#include "test_support.h"
+#include "SampleBlockQueue.h"
+#include "EntropyStats.h"
+#include "LZEstimator.h"
+#include "MinEntropyEstimator.h"
+#include "AnomalyEngine.h"
+#include "EntropySampleStore.h"
+#include <atomic>
+#include <chrono>
+#include <thread>
+
+// As in EntropyBeacon.h
+#define ENTROPY_BUFFER_SIZE         256
+#define ANALYSIS_WINDOW             64
+#define SAMPLE_ENTROPY_WINDOW       32
+#define MIN_ENTROPY_WINDOW          1024
+#define ACQ_QUEUE_BLOCKS            8
+#define ACQ_BLOCKS_PER_SECOND       32
+#define ACQ_MAX_BLOCKS_PER_UPDATE   4
+#define ACQ_BEHIND_BLOCKS           4
+#define ADVANCED_ANALYSIS_EVERY     4
+
+#define FRAME_MS                    50       // TARGET_FRAME_TIME in remu_ii.ino
+#define RUN_MS                      1000     // Per rate
+#define CAPACITY_SAMPLES            200000
+
+static const uint32_t sampleRates[] = {100, 500, 1000, 2000, 5000, 8000};   // SampleRate
+
+// ===== ANALYSIS PATH =====
+
+// The consumer half of EntropyBeaconApp: analyseSample() per sample,
+// then the decimated stages of processSampleBlock()
+struct Analysis {
+    EntropyStats sampleStats;
+    EntropyStats analysisStats;
+    LZEstimator lzStream;
+    LZEstimator lzEstimator;
+    MinEntropyEstimator minEntropy;
+    AnomalyEngine anomalyEngine;
+    EntropySampleStore samples;
+    AnalysisStage advancedStage;
+    AnalysisStage minEntropyStage;
+    uint32_t blocksAnalysed;
+    uint32_t samplesAnalysed;
+    uint32_t anomalies;
+    uint32_t events;
+    uint32_t gaps;               // Blocks whose sequence skipped samples
+    uint32_t nextSequence;
+    volatile float sink;
+
+    bool begin() {
+        advancedStage = {ADVANCED_ANALYSIS_EVERY, true, 0, 0};
+        minEntropyStage = {1, true, 0, 0};
+        blocksAnalysed = samplesAnalysed = anomalies = events = gaps = nextSequence = 0;
+        anomalyEngine.config.zThreshold = 2.0f;
+        return samples.allocate(ENTROPY_BUFFER_SIZE) &&
+               analysisStats.configure(ANALYSIS_WINDOW) && sampleStats.configure(SAMPLE_ENTROPY_WINDOW) &&
+               lzEstimator.configure(ENTROPY_BUFFER_SIZE * 2) &&
+               lzStream.configure(SAMPLE_ENTROPY_WINDOW * 2) && lzStream.beginStream(SAMPLE_ENTROPY_WINDOW) &&
+               minEntropy.configure(MIN_ENTROPY_WINDOW);
+    }
+
+    void analyseSample(uint16_t value, uint8_t source, uint32_t timestamp) {
+        sampleStats.push(value);
+        analysisStats.push(value);
+        float entropy = sampleStats.shannonEntropy();
+        lzStream.push(value >> 4);
+        float complexity = lzStream.getBlockBitsPerSymbol();
+        bool anomaly = anomalyEngine.update(value / 4095.0f, timestamp) != 0;
+        if (anomaly) anomalies++;
+        samples.push(value, timestamp, (source & SAMPLE_SOURCE_MASK) | (anomaly ? SAMPLE_FLAG_ANOMALY : 0),
+                     entropy, complexity);
+        minEntropy.push(value >> 4);
+        samplesAnalysed++;
+    }
+
+    // The statistics and LZ parts of updateAdvancedAnalysis()
+    void advancedAnalysis() {
+        float total = analysisStats.shannonEntropy() + analysisStats.conditionalEntropy() +
+                      analysisStats.mutualInformation() + analysisStats.chiSquare();
+        for (uint8_t lag = 1; lag <= ENTROPY_STATS_MAX_LAG; lag++) total += analysisStats.serialCorrelation(lag);
+
+        uint16_t recent[ANALYSIS_WINDOW];
+        uint8_t symbols[ANALYSIS_WINDOW];
+        uint16_t size = samples.copyRecent(recent, ANALYSIS_WINDOW);
+        for (uint16_t i = 0; i < size; i++) symbols[i] = recent[i] >> 4;
+        if (size > 0) total += lzEstimator.compressedBits(symbols, size) / (8.0f * size);
+        sink = total;
+    }
+
+    void processBlock(const SampleBlock& block, uint8_t backlog, uint32_t sampleInterval) {
+        if (block.sequence != nextSequence) gaps++;
+        nextSequence = block.sequence + block.count;
+        for (uint16_t i = 0; i < block.count; i++) {
+            analyseSample(block.values[i], block.sources[i], (block.timestamp + i * sampleInterval) / 1000);
+        }
+
+        bool behind = backlog >= ACQ_BEHIND_BLOCKS;
+        blocksAnalysed++;
+        if (advancedStage.due(blocksAnalysed, behind)) advancedAnalysis();
+        if (minEntropy.windowReady() && minEntropyStage.due(blocksAnalysed, behind)) {
+            minEntropy.finishWindow();
+        }
+        AnomalyEvent event;
+        while (anomalyEngine.nextEvent(event)) events++;
+    }
+};
+
+// 12-bit noise with a level shift every few seconds for the detectors
+static uint16_t sampleValue(uint32_t index, uint32_t& rng) {
+    rng = rng * 1664525u + 1013904223u;
+    uint16_t noise = (uint16_t)((rng >> 8) & 0x3FF);
+    return (uint16_t)(((index / 3000) % 2 ? 2500 : 1200) + noise);
+}
+
+// ===== PACED RUNS =====
+
+struct RateRun {
+    uint32_t produced;
+    uint32_t analysed;
+    uint32_t dropped;
+    uint32_t maxBacklog;
+    uint32_t gaps;
+    uint32_t shed;
+    double samplesPerSecond;     // Analysed over the run's wall time
+    double busyMicrosPerBlock;   // Consumer time per block
+};
+
+static RateRun runAtRate(uint32_t rate) {
+    SampleBlockQueue queue;
+    queue.allocate(ACQ_QUEUE_BLOCKS);
+    queue.setBlockLength((uint16_t)(rate / ACQ_BLOCKS_PER_SECOND));
+    const uint32_t sampleInterval = 1000000 / rate;
+
+    Analysis analysis;
+    CHECK(analysis.begin());
+
+    // The acquisition timer: samples at rate, put in millisecond bursts
+    std::atomic<bool> stop(false);
+    std::thread producer([&queue, &stop, rate, sampleInterval]() {
+        uint32_t rng = rate, index = 0;
+        auto start = std::chrono::steady_clock::now();
+        for (uint32_t ms = 1; !stop; ms++) {
+            std::this_thread::sleep_until(start + std::chrono::milliseconds(ms));
+            uint32_t due = (uint32_t)((uint64_t)ms * rate / 1000);
+            for (; index < due; index++) {
+                queue.put(sampleValue(index, rng), (uint8_t)(index & 3), index * sampleInterval);
+            }
+        }
+    });
+
+    // The main loop: update() once per frame, the rest of the frame idle
+    auto start = std::chrono::steady_clock::now();
+    auto end = start + std::chrono::milliseconds(RUN_MS);
+    double busy = 0;
+    uint32_t frame = 0;
+    while (std::chrono::steady_clock::now() < end) {
+        std::this_thread::sleep_until(start + std::chrono::milliseconds(FRAME_MS * ++frame));
+        auto updateStart = std::chrono::steady_clock::now();
+        for (uint8_t i = 0; i < ACQ_MAX_BLOCKS_PER_UPDATE; i++) {
+            const SampleBlock* block = queue.peek();
+            if (!block) break;
+            analysis.processBlock(*block, queue.backlog(), sampleInterval);
+            queue.pop();
+        }
+        busy += std::chrono::duration<double>(std::chrono::steady_clock::now() - updateStart).count();
+    }
+    stop = true;
+    producer.join();
+    double seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+
+    const SpscRingStats& stats = queue.getStats();
+    RateRun run;
+    run.produced = queue.getSamplesProduced();
+    run.analysed = analysis.samplesAnalysed;
+    run.dropped = stats.dropped;
+    run.maxBacklog = stats.maxBacklog;
+    run.gaps = analysis.gaps;
+    run.shed = analysis.advancedStage.shed + analysis.minEntropyStage.shed;
+    run.samplesPerSecond = analysis.samplesAnalysed / seconds;
+    run.busyMicrosPerBlock = analysis.blocksAnalysed ? busy * 1e6 / analysis.blocksAnalysed : 0;
+    return run;
+}
+
+static void testEveryRate() {
+    for (uint32_t rate : sampleRates) {
+        RateRun run = runAtRate(rate);
+        printf("  %4u Hz: %7.0f samples/s analysed, %u dropped, max backlog %u of %u, "
+               "%u stages shed, %.1f us per block\n",
+               (unsigned)rate, run.samplesPerSecond, (unsigned)run.dropped, (unsigned)run.maxBacklog,
+               (unsigned)ACQ_QUEUE_BLOCKS, (unsigned)run.shed, run.busyMicrosPerBlock);
+        CHECK(run.dropped == 0);
+        CHECK(run.gaps == 0);
+        CHECK(run.maxBacklog < ACQ_QUEUE_BLOCKS);
+        // All but the block still filling when the run stopped
+        CHECK(run.produced - run.analysed <= (uint32_t)ACQ_QUEUE_BLOCKS * (rate / ACQ_BLOCKS_PER_SECOND));
+        // Each frame's blocks are analysed in the frame, so the rate holds
+        CHECK(run.samplesPerSecond > 0.8 * rate);
+    }
+}
+
+// ===== CAPACITY =====
+
+static void benchmarkCapacity() {
+    // Full blocks analysed back to back: what the path could sustain
+    static const uint32_t rates[] = {1000, 8000};
+    for (uint32_t rate : rates) {
+        SampleBlockQueue queue;
+        queue.allocate(ACQ_QUEUE_BLOCKS);
+        queue.setBlockLength((uint16_t)(rate / ACQ_BLOCKS_PER_SECOND));
+        Analysis analysis;
+        analysis.begin();
+
+        uint32_t rng = rate, index = 0;
+        double busy = 0;
+        while (analysis.samplesAnalysed < CAPACITY_SAMPLES) {
+            while (queue.put(sampleValue(index, rng), 0, index)) index++;
+            auto start = std::chrono::steady_clock::now();
+            while (const SampleBlock* block = queue.peek()) {
+                analysis.processBlock(*block, 0, 1);
+                queue.pop();
+            }
+            busy += std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+        }
+        double capacity = analysis.samplesAnalysed / busy;
+        printf("  %4u-sample blocks: analysis takes %.0f samples/s, %.2f%% of a core at %u Hz\n",
+               (unsigned)(rate / ACQ_BLOCKS_PER_SECOND), capacity, 100.0 * rate / capacity, (unsigned)rate);
+        CHECK(capacity > rate);
+    }
+}
+
+int main() {
+    testEveryRate();
+    benchmarkCapacity();
+    return testSummary("test_acquisition_rates");
+}
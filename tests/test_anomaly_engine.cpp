@@ -0,0 +1,203 @@
+// ========================================
+// test_anomaly_engine - Feeds AnomalyEngine noise with injected steps and
+// outliers: the EWMA follows its recursion and flags outliers, CUSUM
+// catches steps within its expected mean delay in either direction,
+// and the Mahalanobis distance matches a double-precision reference and
+// flags pairs that break the serial correlation. Nothing fires during
+// warmup or inside a cooldown.
+// Build on the host (or run tests/run_host_tests.sh):
+//   g++ -O2 -Itests -Iapps/EntropyBeacon -o test_anomaly_engine
+//       tests/test_anomaly_engine.cpp apps/EntropyBeacon/AnomalyEngine.cpp
+// ========================================
+
+#include "test_support.h"
+#include "AnomalyEngine.h"
+#include <math.h>
+
+#define NOISE_HALF_WIDTH    0.1f    // Uniform noise around 0.5
+#define NOISE_SIGMA         0.057735f   // Half width / sqrt(3)
+#define CLEAN_SAMPLES       2000
+
+static uint32_t rngState = 7;
+static float uniform() {
+    rngState = rngState * 1664525u + 1013904223u;
+    return (float)(rngState >> 8) / 16777216.0f;
+}
+
+static float noise() {
+    return 0.5f + (2.0f * uniform() - 1.0f) * NOISE_HALF_WIDTH;
+}
+
+// Feeds clean noise and returns how often detector id fired
+static uint32_t feedNoise(AnomalyEngine& engine, uint32_t count, uint8_t id, uint32_t& time) {
+    uint32_t fired = 0;
+    for (uint32_t i = 0; i < count; i++) {
+        if (engine.update(noise(), time++) & ANOMALY_BIT(id)) fired++;
+    }
+    return fired;
+}
+
+// ===== EWMA =====
+
+static void testEwma() {
+    AnomalyEngine engine;
+    double mean = 0.5, variance = 0.0;
+    double alpha = engine.config.ewmaAlpha;
+    uint32_t time = 0, fired = 0;
+
+    // The running estimates follow the recursion
+    double worstMean = 0, worstVariance = 0;
+    for (uint32_t i = 0; i < CLEAN_SAMPLES; i++) {
+        float value = noise();
+        if (engine.update(value, time++) & ANOMALY_BIT(ANOMALY_EWMA)) fired++;
+        double deviation = value - mean;
+        mean += alpha * deviation;
+        variance = (1.0 - alpha) * (variance + alpha * deviation * deviation);
+        worstMean = fmax(worstMean, fabs(engine.getMean() - mean));
+        worstVariance = fmax(worstVariance, fabs(engine.getVariance() - variance));
+    }
+    CHECK(worstMean < 1e-5);
+    CHECK(worstVariance < 1e-6);
+    CHECK_NEAR(sqrt(engine.getVariance()), NOISE_SIGMA, NOISE_SIGMA * 0.3);
+
+    // Uniform noise never leaves sqrt(3) sigma, so a 3-sigma limit is silent
+    CHECK(fired == 0);
+
+    // An outlier fires, scored in EWMA standard deviations
+    float outlier = 0.5f + 8.0f * NOISE_SIGMA;
+    double expectedZ = (outlier - engine.getMean()) / sqrt(engine.getVariance());
+    CHECK(engine.update(outlier, time++) & ANOMALY_BIT(ANOMALY_EWMA));
+    CHECK_NEAR(engine.getScore(ANOMALY_EWMA), expectedZ, expectedZ * 0.15);
+
+    // A second outlier inside the cooldown is held back, one after it is not
+    for (uint16_t i = 0; i < engine.config.cooldown - 1; i++) engine.update(noise(), time++);
+    CHECK(!(engine.update(outlier, time++) & ANOMALY_BIT(ANOMALY_EWMA)));
+    feedNoise(engine, 200, ANOMALY_EWMA, time);
+    CHECK(engine.update(1.0f - outlier, time++) & ANOMALY_BIT(ANOMALY_EWMA));
+    CHECK(engine.getStats().fired[ANOMALY_EWMA] == 2);
+}
+
+// ===== CUSUM =====
+
+#define STEP_TRIALS         40
+#define STEP_CLEAN          1000
+
+// Steps the mean by shift baseline standard deviations after clean noise,
+// over fresh engines; returns the mean samples from the step to the first
+// CUSUM alarm. Trials with an alarm before the step count as false alarms.
+static double stepDelay(float shift, uint32_t& falseAlarms, uint32_t& missed) {
+    uint32_t total = 0, detected = 0;
+    for (uint32_t trial = 0; trial < STEP_TRIALS; trial++) {
+        AnomalyEngine engine;
+        uint32_t time = 0;
+        if (feedNoise(engine, STEP_CLEAN, ANOMALY_CUSUM, time) > 0) {
+            falseAlarms++;
+            continue;
+        }
+        CHECK_NEAR(sqrt(engine.getBaselineVariance()), NOISE_SIGMA, NOISE_SIGMA * 0.15);
+
+        uint32_t delay = 0;
+        for (uint32_t i = 1; i <= 100 && delay == 0; i++) {
+            float value = noise() + shift * NOISE_SIGMA;
+            if (engine.update(value, time++) & ANOMALY_BIT(ANOMALY_CUSUM)) delay = i;
+        }
+        if (delay == 0) {
+            missed++;
+            continue;
+        }
+        total += delay;
+        detected++;
+    }
+    return detected ? (double)total / detected : 0.0;
+}
+
+static void testCusum() {
+    uint32_t falseAlarms = 0, missed = 0;
+
+    // With slack k = 0.5 and limit h = 8 a step of d sigma adds d - k a
+    // sample: about h / (d - k) + 1 samples, 6 for 2 sigma and 17 for 1
+    double up = stepDelay(2.0f, falseAlarms, missed);
+    double down = stepDelay(-2.0f, falseAlarms, missed);
+    double small = stepDelay(1.0f, falseAlarms, missed);
+    CHECK(up >= 4.0 && up <= 8.0);
+    CHECK(down >= 4.0 && down <= 8.0);
+    CHECK(small >= 10.0 && small <= 25.0);
+    CHECK(missed == 0);
+
+    // In-control run length is thousands of samples, so few of the clean
+    // stretches alarm
+    CHECK(falseAlarms <= 3 * STEP_TRIALS / 10);
+    printf("  CUSUM mean delay: +2 sigma %.1f, -2 sigma %.1f, +1 sigma %.1f samples; "
+           "%u of %u clean stretches alarmed\n",
+           up, down, small, (unsigned)falseAlarms, (unsigned)(3 * STEP_TRIALS));
+}
+
+// ===== MAHALANOBIS =====
+
+static void testMahalanobis() {
+    // AR(1) input: consecutive values are strongly correlated, so a jump
+    // that stays inside the marginal range is still an unlikely pair
+    AnomalyEngine engine;
+    const double phi = 0.9;
+    double sx = 0, sy = 0, sxx = 0, syy = 0, sxy = 0;
+    uint32_t n = 0, time = 0, fired = 0;
+    float previous = 0.5f, value = 0.5f;
+
+    for (uint32_t i = 0; i < 4000; i++) {
+        value = (float)(0.5 + phi * (previous - 0.5) + (uniform() - 0.5) * 0.04);
+        if (engine.update(value, time++) & ANOMALY_BIT(ANOMALY_MAHALANOBIS)) fired++;
+        if (i > 0) {
+            sx += previous; sy += value;
+            sxx += previous * previous; syy += value * value; sxy += previous * value;
+            n++;
+        }
+        previous = value;
+    }
+    CHECK(fired == 0);
+    CHECK_NEAR(engine.getCorrelation(), phi, 0.02);
+
+    // A jump the marginal distribution allows but the pairs do not
+    double meanX = sx / n, meanY = sy / n;
+    double varX = sxx / n - meanX * meanX;
+    double varY = syy / n - meanY * meanY;
+    double cov = sxy / n - meanX * meanY;
+    float jump = (float)(previous < 0.5f ? meanY + 2.0 * sqrt(varY) : meanY - 2.0 * sqrt(varY));
+
+    double dx = previous - meanX, dy = jump - meanY;
+    double det = varX * varY - cov * cov;
+    double reference = (varY * dx * dx - 2.0 * cov * dx * dy + varX * dy * dy) / det;
+    CHECK(reference > engine.config.mahalanobisLimit);
+
+    uint8_t detectors = engine.update(jump, time++);
+    CHECK(detectors & ANOMALY_BIT(ANOMALY_MAHALANOBIS));
+    CHECK(!(detectors & ANOMALY_BIT(ANOMALY_EWMA)));
+    CHECK_NEAR(engine.getScore(ANOMALY_MAHALANOBIS), reference, reference * 0.05);
+    printf("  Mahalanobis: 2-sigma jump scores %.1f (reference %.1f), EWMA |z| %.2f\n",
+           engine.getScore(ANOMALY_MAHALANOBIS), reference, engine.getScore(ANOMALY_EWMA));
+}
+
+// ===== WARMUP =====
+
+static void testWarmup() {
+    AnomalyEngine engine;
+    uint32_t time = 0;
+    for (uint16_t i = 0; i < engine.config.warmup; i++) {
+        float value = (i % 50 == 49) ? 1.0f : noise();
+        CHECK(engine.update(value, time++) == 0);
+    }
+    CHECK(engine.warmedUp());
+    CHECK(engine.getStats().anomalousSamples == 0);
+    CHECK(engine.pendingEvents() == 0);
+
+    // Disabled detectors never fire
+    engine.config.enabled = ANOMALY_ALL_DETECTORS & ~ANOMALY_BIT(ANOMALY_EWMA);
+    CHECK(!(engine.update(1.0f, time++) & ANOMALY_BIT(ANOMALY_EWMA)));
+}
+
+int main() {
+    testEwma();
+    testCusum();
+    testMahalanobis();
+    testWarmup();
+    return testSummary("test_anomaly_engine");
+}
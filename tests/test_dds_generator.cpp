@@ -0,0 +1,322 @@
+// ========================================
+// test_dds_generator - Renders every DDSGenerator waveform to a WAV file
+// and checks the spectra: sine harmonic distortion, the aliases left by
+// the PolyBLEP square and saw against naive ones at the same frequency,
+// and the linear and log sweep frequencies at both ends. Prints the
+// render rate per waveform.
+// The WAV files go to $OUT (default /tmp) as dds_<waveform>.wav.
+// Build on the host (or run tests/run_host_tests.sh):
+//   g++ -O2 -Itests -Iapps/PreqScanner -o test_dds_generator
+//       tests/test_dds_generator.cpp apps/PreqScanner/DDSGenerator.cpp
+// ========================================
+
+#include "test_support.h"
+#include "DDSGenerator.h"
+#include <math.h>
+#include <stdlib.h>
+#include <string.h>
+#include <chrono>
+#include <vector>
+
+#define RATE            22050
+#define FRAME           16384     // Samples per spectrum
+#define ALIAS_TONE      1234.5f   // Harmonics fold back between the partials
+#define ALIAS_HARMONICS 400       // Harmonics above Nyquist summed as aliases
+#define LOW_ALIAS_LIMIT_DB 40.0  // Below RATE / 4, relative to the fundamental
+#define BENCH_SAMPLES   (RATE * 20)
+
+static const char* const waveformNames[] = {"sine", "square", "triangle", "sawtooth", "noise", "sweep"};
+
+static DDSParams toneParams(DDSWaveform waveform, float hz) {
+    DDSParams p = DDSGenerator::defaultParams();
+    p.waveform = waveform;
+    p.frequency = hz;
+    p.amplitude = 0.8f;
+    return p;
+}
+
+static std::vector<float> renderTone(const DDSParams& params, uint32_t count) {
+    DDSGenerator dds;
+    dds.begin(RATE);
+    dds.setParams(params);
+    std::vector<float> out(count);
+    dds.render(out.data(), count);
+    return out;
+}
+
+// The frequency the phase accumulator actually runs at
+static double actualFrequency(float hz) {
+    return floor((double)hz * 4294967296.0 / RATE) * RATE / 4294967296.0;
+}
+
+// ===== SPECTRUM =====
+
+// Blackman-Harris windowed DTFT power at one frequency, relative to a
+// full-scale sine at that frequency
+static double tonePower(const std::vector<float>& x, double hz) {
+    static std::vector<double> window;
+    static double windowSum = 0;
+    if (window.empty()) {
+        window.resize(FRAME);
+        for (uint32_t n = 0; n < FRAME; n++) {
+            double a = 2.0 * M_PI * n / (FRAME - 1);
+            window[n] = 0.35875 - 0.48829 * cos(a) + 0.14128 * cos(2 * a) - 0.01168 * cos(3 * a);
+            windowSum += window[n];
+        }
+    }
+    double w = 2.0 * M_PI * hz / RATE;
+    double re = 0, im = 0;
+    for (uint32_t n = 0; n < FRAME; n++) {
+        re += window[n] * x[n] * cos(w * n);
+        im -= window[n] * x[n] * sin(w * n);
+    }
+    double amplitude = 2.0 * sqrt(re * re + im * im) / windowSum;
+    return amplitude * amplitude;
+}
+
+static double toDb(double power) {
+    return 10.0 * log10(power > 1e-30 ? power : 1e-30);
+}
+
+// Where harmonic k of f lands after folding at Nyquist
+static double foldedFrequency(double f, uint32_t k) {
+    double h = fmod(k * f, (double)RATE);
+    return (h > RATE / 2.0) ? RATE - h : h;
+}
+
+// Worst alias below maxHz relative to the fundamental. Folded harmonics
+// that land within 25 Hz of a true partial or of DC are skipped; the
+// window cannot tell them apart.
+static double worstAliasDb(const std::vector<float>& x, double f, double maxHz) {
+    uint32_t partials = (uint32_t)(RATE / 2.0 / f);
+    double fundamental = tonePower(x, f);
+    double worst = -400.0;
+    for (uint32_t k = partials + 1; k <= ALIAS_HARMONICS; k++) {
+        double alias = foldedFrequency(f, k);
+        double nearestPartial = fabs(alias - f * floor(alias / f + 0.5));
+        if (nearestPartial < 25.0 || alias < 25.0 || alias > maxHz - 25.0) continue;
+        double db = toDb(tonePower(x, alias) / fundamental);
+        if (db > worst) worst = db;
+    }
+    return worst;
+}
+
+// ===== WAV =====
+
+static bool writeWav(const char* path, const std::vector<float>& samples) {
+    FILE* f = fopen(path, "wb");
+    if (!f) return false;
+    uint32_t dataBytes = (uint32_t)samples.size() * 2;
+    uint8_t header[44];
+    memcpy(header, "RIFF", 4);
+    uint32_t riffSize = 36 + dataBytes;
+    memcpy(header + 4, &riffSize, 4);
+    memcpy(header + 8, "WAVEfmt ", 8);
+    uint32_t fmtSize = 16, rate = RATE, byteRate = RATE * 2;
+    uint16_t format = 1, channels = 1, blockAlign = 2, bits = 16;
+    memcpy(header + 16, &fmtSize, 4);
+    memcpy(header + 20, &format, 2);
+    memcpy(header + 22, &channels, 2);
+    memcpy(header + 24, &rate, 4);
+    memcpy(header + 28, &byteRate, 4);
+    memcpy(header + 32, &blockAlign, 2);
+    memcpy(header + 34, &bits, 2);
+    memcpy(header + 36, "data", 4);
+    memcpy(header + 40, &dataBytes, 4);
+    bool ok = fwrite(header, 1, sizeof(header), f) == sizeof(header);
+    for (float v : samples) {
+        int16_t s = (int16_t)lrintf((v > 1.0f ? 1.0f : v < -1.0f ? -1.0f : v) * 32767.0f);
+        ok = ok && fwrite(&s, 2, 1, f) == 1;
+    }
+    return fclose(f) == 0 && ok;
+}
+
+// Reads the samples back through the header's own sizes
+static bool readWav(const char* path, std::vector<int16_t>& samples) {
+    FILE* f = fopen(path, "rb");
+    if (!f) return false;
+    uint8_t header[44];
+    uint32_t rate = 0, dataBytes = 0;
+    bool ok = fread(header, 1, sizeof(header), f) == sizeof(header) &&
+              memcmp(header, "RIFF", 4) == 0 && memcmp(header + 8, "WAVE", 4) == 0 &&
+              memcmp(header + 36, "data", 4) == 0;
+    if (ok) {
+        memcpy(&rate, header + 24, 4);
+        memcpy(&dataBytes, header + 40, 4);
+        samples.resize(dataBytes / 2);
+        ok = rate == RATE && fread(samples.data(), 2, samples.size(), f) == samples.size();
+    }
+    fclose(f);
+    return ok;
+}
+
+// ===== TESTS =====
+
+static void testWavFiles() {
+    const char* dir = getenv("OUT");
+    if (!dir || !dir[0]) dir = "/tmp";
+
+    for (uint8_t w = DDS_SINE; w <= DDS_SWEEP; w++) {
+        DDSParams p = toneParams((DDSWaveform)w, 440.0f);
+        std::vector<float> samples = renderTone(p, RATE);
+
+        // Every waveform stays inside its amplitude; the PolyBLEP
+        // corrections may overshoot by a little
+        float peak = 0;
+        for (float v : samples) peak = fmaxf(peak, fabsf(v));
+        CHECK(peak > 0.5f * p.amplitude);
+        CHECK(peak <= 1.1f * p.amplitude);
+
+        char path[256];
+        snprintf(path, sizeof(path), "%s/dds_%s.wav", dir, waveformNames[w]);
+        CHECK(writeWav(path, samples));
+        std::vector<int16_t> back;
+        CHECK(readWav(path, back));
+        CHECK(back.size() == samples.size());
+        bool same = back.size() == samples.size();
+        for (uint32_t i = 0; same && i < back.size(); i++) {
+            same = abs(back[i] - (int)lrintf(samples[i] * 32767.0f)) <= 1;
+        }
+        CHECK(same);
+    }
+    printf("  WAV files written to %s/dds_*.wav\n", dir);
+}
+
+static void testSineDistortion() {
+    static const float tones[] = {100.0f, 1000.0f, 5000.0f};
+    for (float hz : tones) {
+        std::vector<float> x = renderTone(toneParams(DDS_SINE, hz), FRAME);
+        double f = actualFrequency(hz);
+        double fundamental = tonePower(x, f);
+        double harmonics = 0;
+        for (uint32_t k = 2; k * f < RATE / 2.0; k++) harmonics += tonePower(x, k * f);
+        double thdDb = toDb(harmonics / fundamental);
+        printf("  sine %5.0f Hz: THD %.1f dB\n", hz, thdDb);
+        CHECK_NEAR(sqrt(fundamental), 0.8, 0.01);
+        // Linear interpolation over 1024 entries is good to about -110 dB
+        CHECK(thdDb < -90.0);
+    }
+}
+
+static void testBandLimitedAliases() {
+    double f = actualFrequency(ALIAS_TONE);
+    const uint32_t count = FRAME;
+
+    // The same phase accumulator without the PolyBLEP corrections
+    std::vector<float> naiveSaw(count), naiveSquare(count);
+    uint32_t inc = (uint32_t)floor((double)ALIAS_TONE * 4294967296.0 / RATE);
+    uint32_t phase = 0;
+    for (uint32_t i = 0; i < count; i++) {
+        float t = phase * (1.0f / 4294967296.0f);
+        naiveSaw[i] = 0.8f * (2.0f * t - 1.0f);
+        naiveSquare[i] = (t < 0.5f) ? 0.8f : -0.8f;
+        phase += inc;
+    }
+
+    // Two-sample PolyBLEP does most for the aliases that land low, where
+    // they sit far from the partials' own harmonic series; near Nyquist
+    // it gains only a few dB
+    const std::vector<float>* naive[] = {&naiveSaw, &naiveSquare};
+    const DDSWaveform waveforms[] = {DDS_SAWTOOTH, DDS_SQUARE};
+    for (uint8_t i = 0; i < 2; i++) {
+        std::vector<float> x = renderTone(toneParams(waveforms[i], ALIAS_TONE), count);
+        double low = worstAliasDb(x, f, RATE / 4.0);
+        double full = worstAliasDb(x, f, RATE / 2.0);
+        double naiveLow = worstAliasDb(*naive[i], f, RATE / 4.0);
+        double naiveFull = worstAliasDb(*naive[i], f, RATE / 2.0);
+        printf("  %-8s %.1f Hz: worst alias %.1f dBc below %u Hz, %.1f dBc overall "
+               "(naive %.1f, %.1f)\n", waveformNames[waveforms[i]], ALIAS_TONE, low,
+               (unsigned)(RATE / 4), full, naiveLow, naiveFull);
+        CHECK(low < -LOW_ALIAS_LIMIT_DB);
+        CHECK(low < naiveLow - 15.0);
+        CHECK(full < naiveFull - 5.0);
+    }
+}
+
+// Rising zero crossings, interpolated between samples
+static std::vector<double> risingCrossings(const std::vector<float>& x) {
+    std::vector<double> times;
+    for (uint32_t i = 1; i < x.size(); i++) {
+        if (x[i - 1] < 0.0f && x[i] >= 0.0f) {
+            times.push_back((i - 1 + x[i - 1] / (x[i - 1] - x[i])) / RATE);
+        }
+    }
+    return times;
+}
+
+static void testSweepEndpoints() {
+    const float startHz = 100.0f, endHz = 2000.0f, seconds = 1.0f;
+    for (uint8_t shape = DDS_SWEEP_LINEAR; shape <= DDS_SWEEP_LOG; shape++) {
+        DDSParams p = toneParams(DDS_SWEEP, 0.0f);
+        p.sweepShape = (DDSSweepShape)shape;
+        p.sweepStartFreq = startHz;
+        p.sweepEndFreq = endHz;
+        p.sweepDuration = seconds;
+        std::vector<float> x = renderTone(p, (uint32_t)(seconds * RATE));
+        std::vector<double> crossings = risingCrossings(x);
+        CHECK(crossings.size() > 10);
+        if (crossings.size() < 10) continue;
+
+        // Sweep frequency at time t, as the closed form gives it
+        auto expected = [&](double t) {
+            double progress = t / seconds;
+            return shape == DDS_SWEEP_LOG ? startHz * pow(endHz / startHz, progress)
+                                          : startHz + progress * (endHz - startHz);
+        };
+
+        // One period at each end: its inverse is the frequency at its middle
+        double t0 = crossings[0], t1 = crossings[1];
+        double tn = crossings[crossings.size() - 1], tm = crossings[crossings.size() - 2];
+        double first = 1.0 / (t1 - t0), last = 1.0 / (tn - tm);
+        double firstExpected = expected(0.5 * (t0 + t1));
+        double lastExpected = expected(0.5 * (tm + tn));
+        printf("  %s sweep: %.1f Hz at %.1f ms (expected %.1f), %.1f Hz at %.1f ms (expected %.1f)\n",
+               shape == DDS_SWEEP_LOG ? "log   " : "linear", first, 500 * (t0 + t1), firstExpected,
+               last, 500 * (tm + tn), lastExpected);
+        CHECK_NEAR(first, firstExpected, 0.01 * firstExpected);
+        CHECK_NEAR(last, lastExpected, 0.01 * lastExpected);
+        CHECK(fabs(last - endHz) < 0.02 * endHz);
+
+        // At the next block boundary the sweep starts again from the bottom
+        DDSGenerator dds;
+        dds.begin(RATE);
+        dds.setParams(p);
+        std::vector<float> wrapped((uint32_t)(seconds * RATE) + RATE / 10);
+        dds.render(wrapped.data(), wrapped.size());
+        std::vector<double> again = risingCrossings(wrapped);
+        double lowest = endHz;
+        for (uint32_t i = 1; i < again.size(); i++) {
+            if (again[i - 1] > seconds - 0.005) lowest = fmin(lowest, 1.0 / (again[i] - again[i - 1]));
+        }
+        CHECK(lowest < 1.2 * startHz);
+    }
+}
+
+static void benchmark() {
+    std::vector<float> out(BENCH_SAMPLES);
+    for (uint8_t w = DDS_SINE; w <= DDS_SWEEP; w++) {
+        DDSGenerator dds;
+        dds.begin(RATE);
+        DDSParams p = toneParams((DDSWaveform)w, 1000.0f);
+        p.modulation = DDS_MOD_NONE;
+        dds.setParams(p);
+        auto start = std::chrono::steady_clock::now();
+        dds.render(out.data(), BENCH_SAMPLES);
+        double seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+        volatile float sink = out[BENCH_SAMPLES - 1];
+        (void)sink;
+        double rate = BENCH_SAMPLES / seconds;
+        printf("  %-8s %6.1f Msamples/s (%.0fx real time at %u Hz)\n",
+               waveformNames[w], rate / 1e6, rate / RATE, (unsigned)RATE);
+        CHECK(rate > RATE);
+    }
+}
+
+int main() {
+    testWavFiles();
+    testSineDistortion();
+    testBandLimitedAliases();
+    testSweepEndpoints();
+    benchmark();
+    return testSummary("test_dds_generator");
+}
@@ -0,0 +1,310 @@
+// ========================================
+// test_device_table - Drives BLEDeviceTable with random inserts, touches
+// and removals and checks it after every step against a std::unordered_map
+// and a recency stamp per device: the same MACs are found, the recency
+// list runs in stamp order and a full table evicts the oldest. Clusters
+// placed on the last buckets check backward-shift deletion where probe
+// runs wrap round to bucket 0. Ends with a replay of 100k advertisements
+// from 2,000 devices against the map-and-list it replaced.
+// Build on the host (or run tests/run_host_tests.sh):
+//   g++ -O2 -Itests -Iapps/BLEScanner -o test_device_table
+//       tests/test_device_table.cpp apps/BLEScanner/BLEDeviceTable.cpp
+// ========================================
+
+#include "test_support.h"
+#include "BLEDeviceTable.h"
+#include <chrono>
+#include <list>
+#include <unordered_map>
+#include <vector>
+
+#define STRESS_SLOTS    64
+#define STRESS_STEPS    40000
+#define MAC_POOL        200       // Draws from a small pool so MACs return
+#define REPLAY_ADVERTS  100000
+#define REPLAY_DEVICES  2000
+
+static uint32_t rngState = 21;
+static uint32_t nextRandom() {
+    rngState = rngState * 1664525u + 1013904223u;
+    return rngState >> 8;
+}
+
+static uint64_t randomMac() {
+    return (((uint64_t)nextRandom() << 24) ^ nextRandom()) & 0xFFFFFFFFFFFFull;
+}
+
+// BLEDeviceTable::home(), repeated here to place keys on chosen buckets
+static uint16_t homeBucket(uint64_t mac, uint16_t bucketMask) {
+    uint32_t h = (uint32_t)mac ^ ((uint32_t)(mac >> 32) * 0x85EBCA6Bu);
+    h ^= h >> 16;
+    h *= 0x9E3779B1u;
+    return (uint16_t)((h >> 16) & bucketMask);
+}
+
+// ===== REFERENCE =====
+
+struct Reference {
+    std::unordered_map<uint64_t, uint16_t> slots;    // MAC to slot
+    std::vector<uint64_t> stamps;                    // Last touch per slot
+    uint64_t clock;
+
+    explicit Reference(uint16_t capacity) : stamps(capacity, 0), clock(0) {}
+
+    void touch(uint16_t slot) { stamps[slot] = ++clock; }
+
+    uint64_t oldestMac() const {
+        uint64_t mac = 0, best = UINT64_MAX;
+        for (const auto& entry : slots) {
+            if (stamps[entry.second] < best) {
+                best = stamps[entry.second];
+                mac = entry.first;
+            }
+        }
+        return mac;
+    }
+};
+
+// Every live MAC found in its slot, the list in stamp order both ways
+static bool matches(BLEDeviceTable& table, const Reference& reference) {
+    if (table.size() != reference.slots.size()) return false;
+    for (const auto& entry : reference.slots) {
+        if (table.find(entry.first) != entry.second) return false;
+        if (table.getMac(entry.second) != entry.first || !table.isUsed(entry.second)) return false;
+    }
+
+    uint16_t walked = 0;
+    uint64_t previous = UINT64_MAX;
+    for (uint16_t slot = table.getNewest(); slot != BLE_TABLE_NONE; slot = table.getOlder(slot)) {
+        if (reference.stamps[slot] >= previous) return false;
+        previous = reference.stamps[slot];
+        if (++walked > table.size()) return false;
+    }
+    if (walked != table.size()) return false;
+
+    walked = 0;
+    previous = 0;
+    for (uint16_t slot = table.getOldest(); slot != BLE_TABLE_NONE; slot = table.getNewer(slot)) {
+        if (reference.stamps[slot] <= previous) return false;
+        previous = reference.stamps[slot];
+        walked++;
+    }
+    return walked == table.size();
+}
+
+// ===== TESTS =====
+
+static void testAgainstMap() {
+    BLEDeviceTable table;
+    CHECK(table.begin(STRESS_SLOTS));
+    Reference reference(STRESS_SLOTS);
+
+    std::vector<uint64_t> pool(MAC_POOL);
+    for (uint16_t i = 0; i < MAC_POOL; i++) pool[i] = randomMac();
+
+    uint32_t mismatches = 0, wrongEvictions = 0, wrongFinds = 0, evictions = 0;
+    for (uint32_t step = 0; step < STRESS_STEPS; step++) {
+        uint32_t action = nextRandom() % 8;
+        if (action < 5) {
+            // A sighting, as the scanner's updateDeviceInfo() handles it
+            uint64_t mac = pool[nextRandom() % MAC_POOL];
+            uint16_t slot = table.find(mac);
+            auto known = reference.slots.find(mac);
+            if ((slot == BLE_TABLE_NONE) != (known == reference.slots.end())) wrongFinds++;
+
+            if (slot == BLE_TABLE_NONE) {
+                uint64_t expectedVictim = table.isFull() ? reference.oldestMac() : 0;
+                uint16_t evicted;
+                slot = table.insert(mac, &evicted);
+                if (evicted != BLE_TABLE_NONE) {
+                    evictions++;
+                    auto victim = reference.slots.find(expectedVictim);
+                    if (victim == reference.slots.end() || victim->second != evicted || evicted != slot) {
+                        wrongEvictions++;
+                    }
+                    reference.slots.erase(expectedVictim);
+                } else if (expectedVictim != 0) {
+                    wrongEvictions++;
+                }
+                reference.slots[mac] = slot;
+            } else {
+                table.touch(slot);
+            }
+            reference.touch(slot);
+        } else if (!reference.slots.empty()) {
+            // A timeout or clear of one device, anywhere in the list
+            auto entry = reference.slots.begin();
+            std::advance(entry, nextRandom() % reference.slots.size());
+            table.remove(entry->second);
+            if (table.find(entry->first) != BLE_TABLE_NONE) wrongFinds++;
+            reference.slots.erase(entry);
+        }
+        if (!matches(table, reference)) mismatches++;
+    }
+    CHECK(mismatches == 0);
+    CHECK(wrongFinds == 0);
+    CHECK(wrongEvictions == 0);
+    CHECK(evictions > 0);
+    CHECK(table.getStats().evictions == evictions);
+
+    // Removal left no tombstones: lookups stay short after the churn
+    const BLEDeviceTableStats& stats = table.getStats();
+    double probesPerLookup = (double)stats.probes / stats.lookups;
+    CHECK(probesPerLookup < 2.0);
+    printf("  %u steps: %u evictions, %u removals, %.2f probes per lookup\n",
+           (unsigned)STRESS_STEPS, (unsigned)evictions, (unsigned)stats.removals, probesPerLookup);
+
+    table.clear();
+    CHECK(table.size() == 0 && table.getNewest() == BLE_TABLE_NONE && table.getOldest() == BLE_TABLE_NONE);
+    CHECK(table.find(pool[0]) == BLE_TABLE_NONE);
+}
+
+static void testWrapAround() {
+    // 16 slots over 32 buckets; every key's home is one of the last two
+    // buckets or bucket 0, so each run crosses the end of the table
+    const uint16_t slots = 16, bucketMask = 31;
+    uint32_t failures = 0;
+    for (uint32_t round = 0; round < 400; round++) {
+        BLEDeviceTable table;
+        table.begin(slots);
+        Reference reference(slots);
+
+        while (reference.slots.size() < 12) {
+            uint64_t mac = randomMac();
+            uint16_t home = homeBucket(mac, bucketMask);
+            if (home < bucketMask - 1 && home != 0) continue;
+            if (reference.slots.count(mac)) continue;
+            uint16_t slot = table.insert(mac);
+            reference.slots[mac] = slot;
+            reference.touch(slot);
+        }
+        if (!matches(table, reference)) failures++;
+
+        // Remove in random order; each backward shift must keep every
+        // remaining key reachable from its home
+        while (!reference.slots.empty()) {
+            auto entry = reference.slots.begin();
+            std::advance(entry, nextRandom() % reference.slots.size());
+            uint64_t mac = entry->first;
+            table.remove(entry->second);
+            reference.slots.erase(entry);
+            if (table.find(mac) != BLE_TABLE_NONE || !matches(table, reference)) failures++;
+
+            // Sometimes refill the hole from the same cluster
+            if (nextRandom() % 3 == 0) {
+                uint64_t fresh;
+                do {
+                    fresh = randomMac();
+                } while ((homeBucket(fresh, bucketMask) < bucketMask - 1 && homeBucket(fresh, bucketMask) != 0) ||
+                         reference.slots.count(fresh));
+                uint16_t slot = table.insert(fresh);
+                reference.slots[fresh] = slot;
+                reference.touch(slot);
+                if (!matches(table, reference)) failures++;
+            }
+        }
+        if (table.size() != 0) failures++;
+    }
+    CHECK(failures == 0);
+}
+
+static void testMacHelpers() {
+    const uint8_t octets[6] = {0xA4, 0xC1, 0x38, 0x0F, 0x5E, 0x01};
+    uint64_t mac = BLEDeviceTable::packMac(octets);
+    CHECK(mac == 0xA4C1380F5E01ull);
+
+    uint8_t back[6];
+    BLEDeviceTable::unpackMac(mac, back);
+    bool same = true;
+    for (uint8_t i = 0; i < 6; i++) same = same && back[i] == octets[i];
+    CHECK(same);
+
+    char text[BLE_MAC_STRING_LENGTH];
+    BLEDeviceTable::formatMac(mac, text);
+    uint64_t parsed = 0;
+    CHECK(BLEDeviceTable::parseMac(text, parsed) && parsed == mac);
+    CHECK(BLEDeviceTable::parseMac("A4-C1-38-0F-5E-01", parsed) && parsed == mac);
+    CHECK(!BLEDeviceTable::parseMac("a4:c1:38:0f:5e", parsed));
+    CHECK(!BLEDeviceTable::parseMac("a4:c1:38:0f:5e:0g", parsed));
+}
+
+// ===== REPLAY BENCHMARK =====
+
+// The scanner's per-advertisement lookup, insert-or-touch and eviction,
+// against an unordered_map of list iterators kept in recency order
+static void replay(uint16_t capacity, const std::vector<uint64_t>& adverts) {
+    BLEDeviceTable table;
+    table.begin(capacity);
+    uint32_t tableEvictions = 0;
+    auto start = std::chrono::steady_clock::now();
+    for (uint64_t mac : adverts) {
+        uint16_t slot = table.find(mac);
+        if (slot == BLE_TABLE_NONE) {
+            uint16_t evicted;
+            table.insert(mac, &evicted);
+            if (evicted != BLE_TABLE_NONE) tableEvictions++;
+        } else {
+            table.touch(slot);
+        }
+    }
+    double tableSeconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+
+    std::list<uint64_t> order;
+    std::unordered_map<uint64_t, std::list<uint64_t>::iterator> index;
+    uint32_t mapEvictions = 0;
+    start = std::chrono::steady_clock::now();
+    for (uint64_t mac : adverts) {
+        auto found = index.find(mac);
+        if (found == index.end()) {
+            if (index.size() == capacity) {
+                index.erase(order.back());
+                order.pop_back();
+                mapEvictions++;
+            }
+            order.push_front(mac);
+            index[mac] = order.begin();
+        } else {
+            order.splice(order.begin(), order, found->second);
+        }
+    }
+    double mapSeconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+
+    CHECK(tableEvictions == mapEvictions);
+    CHECK(table.size() == index.size());
+    // Same survivors, newest first
+    bool sameOrder = true;
+    uint16_t slot = table.getNewest();
+    for (uint64_t mac : order) {
+        sameOrder = sameOrder && slot != BLE_TABLE_NONE && table.getMac(slot) == mac;
+        if (slot != BLE_TABLE_NONE) slot = table.getOlder(slot);
+    }
+    CHECK(sameOrder);
+
+    const BLEDeviceTableStats& stats = table.getStats();
+    printf("  %4u slots: %5.1f ns/advert table, %5.1f ns unordered_map+list; "
+           "%u evictions, %.2f probes per lookup\n",
+           (unsigned)capacity, tableSeconds * 1e9 / adverts.size(), mapSeconds * 1e9 / adverts.size(),
+           (unsigned)tableEvictions, (double)stats.probes / stats.lookups);
+}
+
+static void benchmarkReplay() {
+    // 2,000 devices, a fifth of them chatty, the rest seen now and then
+    std::vector<uint64_t> devices(REPLAY_DEVICES);
+    for (uint16_t i = 0; i < REPLAY_DEVICES; i++) devices[i] = randomMac();
+    std::vector<uint64_t> adverts(REPLAY_ADVERTS);
+    for (uint32_t i = 0; i < REPLAY_ADVERTS; i++) {
+        uint32_t pick = nextRandom();
+        adverts[i] = (pick & 3) ? devices[(pick >> 2) % (REPLAY_DEVICES / 5)]
+                                : devices[(pick >> 2) % REPLAY_DEVICES];
+    }
+    replay(128, adverts);        // BLE_MAX_DEVICES
+    replay(2048, adverts);       // Room for every device
+}
+
+int main() {
+    testAgainstMap();
+    testWrapAround();
+    testMacHelpers();
+    benchmarkReplay();
+    return testSummary("test_device_table");
+}
@@ -0,0 +1,297 @@
+// ========================================
+// test_entropy_stats - Checks EntropyStats after every push, eviction
+// included, against the full-rescan analysis functions EntropyBeacon used
+// before (Shannon, conditional entropy, chi-square, serial correlation)
+// and an adjacent-pair mutual information, run on a newest-first copy of
+// the same window, over several inputs and window sizes; then times both
+// per sample against the 8 kHz acquisition rate
+// Build on the host (or run tests/run_host_tests.sh):
+//   g++ -O2 -Itests -Iapps/EntropyBeacon -o test_entropy_stats
+//       tests/test_entropy_stats.cpp apps/EntropyBeacon/EntropyStats.cpp
+// ========================================
+
+#include "test_support.h"
+#include "EntropyStats.h"
+#include <math.h>
+#include <chrono>
+#include <deque>
+#include <vector>
+
+#define SAMPLES         6000
+#define SAMPLE_RATE     8000     // Fastest acquisition rate
+
+static uint32_t rngState = 17;
+static uint32_t nextRandom() {
+    rngState = rngState * 1664525u + 1013904223u;
+    return rngState >> 8;
+}
+
+// ===== FULL-RESCAN REFERENCE =====
+
+// The old EntropyBeaconApp functions, data newest first
+static float calculateShannonEntropy(const uint16_t* data, uint16_t length) {
+    if (length == 0) return 0.0f;
+    uint16_t freq[256] = {0};
+    for (uint16_t i = 0; i < length; i++) freq[data[i] >> 4]++;
+
+    float entropy = 0.0f;
+    for (uint16_t i = 0; i < 256; i++) {
+        if (freq[i] > 0) {
+            float probability = (float)freq[i] / length;
+            entropy -= probability * log2f(probability);
+        }
+    }
+    return entropy;
+}
+
+static float calculateConditionalEntropy(const uint16_t* data, uint16_t length) {
+    if (length < 2) return 0.0f;
+    uint16_t jointFreq[16][16] = {{0}};
+    uint16_t marginalFreq[16] = {0};
+    uint16_t validPairs = 0;
+    for (uint16_t i = 0; i < length - 1; i++) {
+        uint8_t x = (data[i] >> 8) & 0x0F;
+        uint8_t y = (data[i + 1] >> 8) & 0x0F;
+        jointFreq[x][y]++;
+        marginalFreq[y]++;
+        validPairs++;
+    }
+
+    float jointEntropy = 0.0f;
+    for (int x = 0; x < 16; x++) {
+        for (int y = 0; y < 16; y++) {
+            if (jointFreq[x][y] > 0) {
+                float prob = (float)jointFreq[x][y] / validPairs;
+                jointEntropy -= prob * log2f(prob);
+            }
+        }
+    }
+    float marginalEntropy = 0.0f;
+    for (int y = 0; y < 16; y++) {
+        if (marginalFreq[y] > 0) {
+            float prob = (float)marginalFreq[y] / validPairs;
+            marginalEntropy -= prob * log2f(prob);
+        }
+    }
+    return jointEntropy - marginalEntropy;
+}
+
+// The old calculateMutualInformation() took two series and was never
+// called; EntropyStats reports I(newer; older) over adjacent high
+// nibbles, so the reference is that, from the same pair table
+static float adjacentMutualInformation(const uint16_t* data, uint16_t length) {
+    if (length < 2) return 0.0f;
+    uint16_t joint[16][16] = {{0}};
+    uint16_t newer[16] = {0}, older[16] = {0};
+    uint16_t pairs = length - 1;
+    for (uint16_t i = 0; i < pairs; i++) {
+        uint8_t x = (data[i] >> 8) & 0x0F;
+        uint8_t y = (data[i + 1] >> 8) & 0x0F;
+        joint[x][y]++;
+        newer[x]++;
+        older[y]++;
+    }
+    double info = 0.0;
+    for (int x = 0; x < 16; x++) {
+        for (int y = 0; y < 16; y++) {
+            if (joint[x][y] == 0) continue;
+            double pxy = (double)joint[x][y] / pairs;
+            info += pxy * log2(pxy * pairs * pairs / ((double)newer[x] * older[y]));
+        }
+    }
+    return (float)info;
+}
+
+static float performChiSquareTest(const uint16_t* data, uint16_t length) {
+    if (length == 0) return 0.0f;
+    uint16_t freq[256] = {0};
+    for (uint16_t i = 0; i < length; i++) freq[data[i] >> 4]++;
+
+    float expected = (float)length / 256.0f;
+    float chiSquare = 0.0f;
+    for (uint16_t i = 0; i < 256; i++) {
+        float diff = freq[i] - expected;
+        chiSquare += (diff * diff) / expected;
+    }
+    return chiSquare;
+}
+
+// The old float version, and the same formula in double: the float sums
+// cancel badly on offset inputs, so the double one is the reference
+template <typename Real>
+static void calculateSerialCorrelation(const uint16_t* data, uint16_t length, float* out) {
+    for (int lag = 1; lag <= ENTROPY_STATS_MAX_LAG; lag++) {
+        out[lag - 1] = 0.0f;
+        if (lag >= length) continue;
+        Real sum1 = 0, sum2 = 0, sum12 = 0, sum1sq = 0, sum2sq = 0;
+        uint16_t validSamples = length - lag;
+        for (uint16_t i = 0; i < validSamples; i++) {
+            Real x1 = (Real)data[i];
+            Real x2 = (Real)data[i + lag];
+            sum1 += x1;
+            sum2 += x2;
+            sum12 += x1 * x2;
+            sum1sq += x1 * x1;
+            sum2sq += x2 * x2;
+        }
+        Real mean1 = sum1 / validSamples;
+        Real mean2 = sum2 / validSamples;
+        Real numerator = sum12 - validSamples * mean1 * mean2;
+        Real denominator = sqrt((sum1sq - validSamples * mean1 * mean1) *
+                                (sum2sq - validSamples * mean2 * mean2));
+        out[lag - 1] = (denominator > 0) ? (float)(numerator / denominator) : 0.0f;
+    }
+}
+
+// ===== INPUTS =====
+
+enum InputKind { INPUT_UNIFORM, INPUT_BIASED, INPUT_PERIODIC, INPUT_WALK, INPUT_COUNT };
+static const char* const inputNames[INPUT_COUNT] = {"uniform", "biased", "periodic", "walk"};
+
+static uint16_t nextInput(uint8_t kind, uint32_t i) {
+    static int32_t walk = 2048;
+    switch (kind) {
+        case INPUT_UNIFORM:  return (uint16_t)(nextRandom() & 0x0FFF);
+        case INPUT_BIASED:   return (uint16_t)(3000 + nextRandom() % 200);   // Narrow and offset
+        case INPUT_PERIODIC: return (uint16_t)((i * 37) % 4096);
+        default:
+            walk += (int32_t)(nextRandom() % 129) - 64;
+            if (walk < 0) walk = 0;
+            if (walk > 4095) walk = 4095;
+            return (uint16_t)walk;
+    }
+}
+
+// ===== TESTS =====
+
+struct Errors {
+    double shannon, conditional, mutual, chiRelative, correlation, floatCorrelation;
+};
+
+static void compareWindow(uint8_t kind, uint16_t windowSize) {
+    EntropyStats stats;
+    CHECK(stats.configure(windowSize));
+    std::deque<uint16_t> window;
+    std::vector<uint16_t> recent(windowSize);
+    Errors worst = {0, 0, 0, 0, 0, 0};
+    uint32_t countErrors = 0;
+
+    for (uint32_t i = 0; i < SAMPLES; i++) {
+        uint16_t value = nextInput(kind, i);
+        stats.push(value);
+        window.push_front(value);
+        if (window.size() > windowSize) window.pop_back();
+
+        uint16_t length = (uint16_t)window.size();
+        for (uint16_t k = 0; k < length; k++) recent[k] = window[k];
+        if (stats.getCount() != length) countErrors++;
+
+        worst.shannon = fmax(worst.shannon,
+                             fabs(stats.shannonEntropy() - calculateShannonEntropy(recent.data(), length)));
+        worst.conditional = fmax(worst.conditional,
+                                 fabs(stats.conditionalEntropy() - calculateConditionalEntropy(recent.data(), length)));
+        worst.mutual = fmax(worst.mutual,
+                            fabs(stats.mutualInformation() - adjacentMutualInformation(recent.data(), length)));
+        float chi = performChiSquareTest(recent.data(), length);
+        worst.chiRelative = fmax(worst.chiRelative, fabs(stats.chiSquare() - chi) / fmax(chi, 1.0));
+
+        float exact[ENTROPY_STATS_MAX_LAG], old[ENTROPY_STATS_MAX_LAG];
+        calculateSerialCorrelation<double>(recent.data(), length, exact);
+        calculateSerialCorrelation<float>(recent.data(), length, old);
+        for (uint8_t lag = 1; lag <= ENTROPY_STATS_MAX_LAG; lag++) {
+            worst.correlation = fmax(worst.correlation, fabs(stats.serialCorrelation(lag) - exact[lag - 1]));
+            worst.floatCorrelation = fmax(worst.floatCorrelation, fabs(old[lag - 1] - exact[lag - 1]));
+        }
+    }
+
+    CHECK(countErrors == 0);
+    CHECK(worst.shannon < 1e-4);
+    CHECK(worst.conditional < 1e-4);
+    CHECK(worst.mutual < 1e-4);
+    CHECK(worst.chiRelative < 1e-5);
+    CHECK(worst.correlation < 1e-5);
+    if (worst.shannon >= 1e-4 || worst.conditional >= 1e-4 || worst.mutual >= 1e-4 ||
+        worst.chiRelative >= 1e-5 || worst.correlation >= 1e-5) {
+        fprintf(stderr, "  %s/%u: H %.2e, H(X|Y) %.2e, I %.2e, chi %.2e, r %.2e\n",
+                inputNames[kind], (unsigned)windowSize, worst.shannon, worst.conditional,
+                worst.mutual, worst.chiRelative, worst.correlation);
+    }
+    if (windowSize == 256) {
+        printf("  %-8s window 256: serial correlation off by %.1e (old float rescan %.1e)\n",
+               inputNames[kind], worst.correlation, worst.floatCorrelation);
+    }
+}
+
+static void testEmptyAndReset() {
+    EntropyStats stats;
+    CHECK(!stats.configure(1));
+    CHECK(!stats.configure(ENTROPY_STATS_MAX_WINDOW + 1));
+    CHECK(stats.configure(16));
+    CHECK(stats.shannonEntropy() == 0.0f && stats.chiSquare() == 0.0f);
+    stats.push(100);
+    CHECK(stats.conditionalEntropy() == 0.0f && stats.serialCorrelation(1) == 0.0f);
+
+    // A constant window has no entropy and no defined correlation
+    for (uint8_t i = 0; i < 40; i++) stats.push(1234);
+    CHECK(stats.getCount() == 16);
+    CHECK(stats.shannonEntropy() == 0.0f && stats.conditionalEntropy() == 0.0f);
+    CHECK(stats.serialCorrelation(1) == 0.0f);
+    CHECK_NEAR(stats.mean(), 1234.0, 1e-3);
+    CHECK_NEAR(stats.variance(), 0.0, 1e-3);
+
+    stats.reset();
+    CHECK(stats.getCount() == 0 && stats.mean() == 0.0f);
+}
+
+static void benchmark(uint16_t windowSize) {
+    const uint32_t samples = 20000;
+    std::vector<uint16_t> input(samples);
+    for (uint32_t i = 0; i < samples; i++) input[i] = (uint16_t)(nextRandom() & 0x0FFF);
+
+    // Incremental: one push and every metric read per sample
+    EntropyStats stats;
+    stats.configure(windowSize);
+    volatile float sink = 0;
+    auto start = std::chrono::steady_clock::now();
+    for (uint32_t i = 0; i < samples; i++) {
+        stats.push(input[i]);
+        float total = stats.shannonEntropy() + stats.conditionalEntropy() +
+                      stats.mutualInformation() + stats.chiSquare();
+        for (uint8_t lag = 1; lag <= ENTROPY_STATS_MAX_LAG; lag++) total += stats.serialCorrelation(lag);
+        sink = sink + total;
+    }
+    double incremental = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+
+    // Rescan: the old functions over a newest-first copy per sample
+    std::vector<uint16_t> recent(windowSize);
+    float correlation[ENTROPY_STATS_MAX_LAG];
+    start = std::chrono::steady_clock::now();
+    for (uint32_t i = windowSize; i < samples; i++) {
+        for (uint16_t k = 0; k < windowSize; k++) recent[k] = input[i - k];
+        float total = calculateShannonEntropy(recent.data(), windowSize) +
+                      calculateConditionalEntropy(recent.data(), windowSize) +
+                      adjacentMutualInformation(recent.data(), windowSize) +
+                      performChiSquareTest(recent.data(), windowSize);
+        calculateSerialCorrelation<float>(recent.data(), windowSize, correlation);
+        sink = sink + total + correlation[0];
+    }
+    double rescan = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+
+    double incrementalNs = incremental * 1e9 / samples;
+    double rescanNs = rescan * 1e9 / (samples - windowSize);
+    printf("  window %4u: %6.0f ns/sample incremental, %7.0f ns rescan; at %u Hz %.2f%% vs %.1f%% of a core\n",
+           (unsigned)windowSize, incrementalNs, rescanNs, (unsigned)SAMPLE_RATE,
+           incrementalNs * SAMPLE_RATE / 1e7, rescanNs * SAMPLE_RATE / 1e7);
+    CHECK(incrementalNs < rescanNs);
+}
+
+int main() {
+    static const uint16_t windows[] = {16, 64, 256};
+    for (uint8_t kind = 0; kind < INPUT_COUNT; kind++) {
+        for (uint16_t w : windows) compareWindow(kind, w);
+    }
+    testEmptyAndReset();
+    benchmark(64);
+    benchmark(256);
+    return testSummary("test_entropy_stats");
+}
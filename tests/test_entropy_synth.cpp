@@ -0,0 +1,311 @@
+// ========================================
+// test_entropy_synth - Renders EntropySynth the way the audio task does,
+// a block at a time with new controls from a fixed entropy sequence, and
+// writes each voice to a WAV file. Checks the biquads against the
+// magnitude of the analog prototypes they are bilinear transforms of,
+// and that gliding controls leave no step where blocks and control
+// segments meet. Prints the render time per block for every voice.
+// The WAV files go to $OUT (default /tmp) as entropy_synth_<voice>.wav.
+// Build on the host (or run tests/run_host_tests.sh):
+//   g++ -O2 -Itests -Iapps/EntropyBeacon -o test_entropy_synth
+//       tests/test_entropy_synth.cpp apps/EntropyBeacon/EntropySynth.cpp
+// ========================================
+
+#include "test_support.h"
+#include "EntropySynth.h"
+#include <math.h>
+#include <stdlib.h>
+#include <string.h>
+#include <chrono>
+#include <vector>
+
+#define RATE            SYNTH_SAMPLE_RATE
+#define SEQUENCE_BLOCKS 250       // Four seconds of blocks
+#define CONTROL_BLOCKS  2         // Blocks per new reading, about 31 a second
+#define BENCH_BLOCKS    4000
+
+static const char* const voiceNames[] = {"silent", "noise", "filtered_noise", "tone", "fm", "pulse"};
+
+static uint32_t rngState = 43;
+static uint32_t nextRandom() {
+    rngState = rngState * 1664525u + 1013904223u;
+    return rngState >> 8;
+}
+
+// One entropy reading, as EntropyBeacon hands it to controlsFor()
+struct Reading {
+    float normalized;
+    float shannonEntropy;
+    float complexity;
+    bool anomaly;
+    uint8_t source;
+};
+
+// A slow drift through the whole range with noise, and an anomaly burst
+static Reading readingAt(uint32_t index) {
+    Reading r;
+    float drift = 0.5f + 0.5f * sinf(index * 0.05f);
+    r.normalized = fminf(1.0f, fmaxf(0.0f, drift + ((nextRandom() & 0xFF) / 255.0f - 0.5f) * 0.2f));
+    r.shannonEntropy = 8.0f * drift;
+    r.complexity = 9.0f * (1.0f - 0.5f * drift);
+    r.anomaly = (index % 40) >= 36;
+    r.source = (uint8_t)(index / 30);
+    return r;
+}
+
+// The audio task's loop: controls at a block boundary, then one block
+static std::vector<float> renderSequence(SynthVoice voice) {
+    EntropySynth synth;
+    synth.begin(RATE);
+    rngState = 43;
+    std::vector<float> out((uint32_t)SEQUENCE_BLOCKS * SYNTH_BLOCK_SIZE);
+    for (uint32_t block = 0; block < SEQUENCE_BLOCKS; block++) {
+        if (block % CONTROL_BLOCKS == 0) {
+            Reading r = readingAt(block / CONTROL_BLOCKS);
+            synth.setControls(EntropySynth::controlsFor(voice, r.normalized, r.shannonEntropy,
+                                                        r.complexity, r.anomaly, r.source));
+        }
+        synth.render(&out[block * SYNTH_BLOCK_SIZE], SYNTH_BLOCK_SIZE);
+    }
+    return out;
+}
+
+static bool writeWav(const char* path, const std::vector<float>& samples) {
+    FILE* f = fopen(path, "wb");
+    if (!f) return false;
+    uint32_t dataBytes = (uint32_t)samples.size() * 2;
+    uint8_t header[44];
+    uint32_t riffSize = 36 + dataBytes, fmtSize = 16, rate = RATE, byteRate = RATE * 2;
+    uint16_t format = 1, channels = 1, blockAlign = 2, bits = 16;
+    memcpy(header, "RIFF", 4);
+    memcpy(header + 4, &riffSize, 4);
+    memcpy(header + 8, "WAVEfmt ", 8);
+    memcpy(header + 16, &fmtSize, 4);
+    memcpy(header + 20, &format, 2);
+    memcpy(header + 22, &channels, 2);
+    memcpy(header + 24, &rate, 4);
+    memcpy(header + 28, &byteRate, 4);
+    memcpy(header + 32, &blockAlign, 2);
+    memcpy(header + 34, &bits, 2);
+    memcpy(header + 36, "data", 4);
+    memcpy(header + 40, &dataBytes, 4);
+    bool ok = fwrite(header, 1, sizeof(header), f) == sizeof(header);
+    for (float v : samples) {
+        int16_t s = (int16_t)lrintf(v * 32767.0f);
+        ok = ok && fwrite(&s, 2, 1, f) == 1;
+    }
+    return fclose(f) == 0 && ok;
+}
+
+// ===== TESTS =====
+
+static void testSequenceToWav() {
+    const char* dir = getenv("OUT");
+    if (!dir || !dir[0]) dir = "/tmp";
+
+    for (uint8_t v = SYNTH_NOISE; v <= SYNTH_PULSE; v++) {
+        std::vector<float> out = renderSequence((SynthVoice)v);
+        bool finite = true, inRange = true;
+        double energy = 0;
+        for (float s : out) {
+            finite = finite && isfinite(s);
+            inRange = inRange && s >= -1.0f && s <= 1.0f;
+            energy += (double)s * s;
+        }
+        double rms = sqrt(energy / out.size());
+        CHECK(finite);
+        CHECK(inRange);
+        CHECK(rms > 0.05);
+
+        // Identical readings give identical audio
+        std::vector<float> again = renderSequence((SynthVoice)v);
+        CHECK(again == out);
+
+        char path[256];
+        snprintf(path, sizeof(path), "%s/entropy_synth_%s.wav", dir, voiceNames[v]);
+        CHECK(writeWav(path, out));
+        printf("  %-15s rms %.3f\n", voiceNames[v], rms);
+    }
+
+    std::vector<float> silent = renderSequence(SYNTH_SILENT);
+    bool zero = true;
+    for (float s : silent) zero = zero && s == 0.0f;
+    CHECK(zero);
+    printf("  WAV files written to %s/entropy_synth_*.wav\n", dir);
+}
+
+// Steady-state gain of the biquad for a sine at hz, fed in control steps
+static double measuredGain(Biquad& filter, double hz) {
+    filter.reset();
+    const uint32_t settle = RATE / 2, measure = RATE / 2;
+    std::vector<float> x(settle + measure);
+    for (uint32_t n = 0; n < x.size(); n++) x[n] = (float)sin(2.0 * M_PI * hz * n / RATE);
+    for (uint32_t n = 0; n < x.size(); n += SYNTH_CONTROL_STEP) {
+        filter.process(&x[n], SYNTH_CONTROL_STEP);
+    }
+    double re = 0, im = 0;
+    for (uint32_t n = settle; n < x.size(); n++) {
+        re += x[n] * sin(2.0 * M_PI * hz * n / RATE);
+        im += x[n] * cos(2.0 * M_PI * hz * n / RATE);
+    }
+    return 2.0 * sqrt(re * re + im * im) / measure;
+}
+
+// The analog second-order sections through the prewarped bilinear
+// transform: the gain at hz is the analog gain at the warped frequency
+static double closedFormGain(bool lowpass, double hz, double cutoff, double q) {
+    double w = tan(M_PI * hz / RATE) / tan(M_PI * cutoff / RATE);
+    double denominator = sqrt((1.0 - w * w) * (1.0 - w * w) + (w / q) * (w / q));
+    return (lowpass ? 1.0 : w * w) / denominator;
+}
+
+static void testBiquadResponse() {
+    struct Case {
+        bool lowpass;
+        float cutoff;
+        float q;
+    };
+    const Case cases[] = {
+        {true, 1000.0f, 0.7071f},
+        {true, 2500.0f, 4.0f},
+        {true, 200.0f, 6.7f},
+        {false, SYNTH_DC_CUTOFF, 0.7071f},
+        {false, 800.0f, 2.0f},
+    };
+    static const double probes[] = {0.25, 0.5, 1.0, 2.0, 4.0};
+    double worstDb = 0;
+    for (const Case& c : cases) {
+        Biquad filter;
+        if (c.lowpass) {
+            filter.setLowpass(c.cutoff, c.q, (float)RATE);
+        } else {
+            filter.setHighpass(c.cutoff, c.q, (float)RATE);
+        }
+        for (double ratio : probes) {
+            double hz = c.cutoff * ratio;
+            if (hz >= 0.45 * RATE || hz < 10.0) continue;
+            double measured = measuredGain(filter, hz);
+            double expected = closedFormGain(c.lowpass, hz, c.cutoff, c.q);
+            double errorDb = fabs(20.0 * log10(measured / expected));
+            if (errorDb > worstDb) worstDb = errorDb;
+            // Float coefficients; far in the stopband the gain is tiny,
+            // so allow a little more there
+            CHECK(errorDb < (expected > 0.01 ? 0.05 : 0.5));
+        }
+    }
+    printf("  biquads: worst error against the closed form %.4f dB\n", worstDb);
+}
+
+// Largest second difference at the given sample offsets within each
+// period, and elsewhere
+static void curvature(const std::vector<float>& x, uint32_t period, double& atEdges, double& inside) {
+    atEdges = 0;
+    inside = 0;
+    for (uint32_t n = 1; n + 1 < x.size(); n++) {
+        double d = fabs((double)x[n + 1] - 2.0 * x[n] + x[n - 1]);
+        // A step between n - 1 and n shows at n - 1 and n
+        bool edge = (n % period) == 0 || ((n + 1) % period) == 0;
+        if (edge) {
+            atEdges = fmax(atEdges, d);
+        } else {
+            inside = fmax(inside, d);
+        }
+    }
+}
+
+static void testNoControlSteps() {
+    // A sine tone whose pitch, cutoff and level all glide across every
+    // block and segment edge, retargeted mid-glide
+    EntropySynth synth;
+    synth.begin(RATE);
+    SynthControls c = EntropySynth::silence();
+    c.voice = SYNTH_TONE;
+    c.waveform = SYNTH_WAVE_SINE;
+    std::vector<float> out((uint32_t)SEQUENCE_BLOCKS * SYNTH_BLOCK_SIZE);
+    for (uint32_t block = 0; block < SEQUENCE_BLOCKS; block++) {
+        if (block % CONTROL_BLOCKS == 0) {
+            bool high = (block / CONTROL_BLOCKS) % 2;
+            c.pitch = high ? 600.0f : 250.0f;
+            c.cutoff = high ? 3000.0f : 1200.0f;
+            c.level = high ? 0.9f : 0.2f;
+            synth.setControls(c);
+        }
+        synth.render(&out[block * SYNTH_BLOCK_SIZE], SYNTH_BLOCK_SIZE);
+    }
+    // Skip the first glide up from silence
+    std::vector<float> steady(out.begin() + SYNTH_GLIDE_SAMPLES, out.end());
+
+    double atBlocks, insideBlocks, atSegments, insideSegments;
+    curvature(steady, SYNTH_BLOCK_SIZE, atBlocks, insideBlocks);
+    curvature(steady, SYNTH_CONTROL_STEP, atSegments, insideSegments);
+    printf("  glides: largest second difference %.4f at block edges, %.4f at segment edges, "
+           "%.4f inside\n", atBlocks, atSegments, insideSegments);
+    CHECK(atBlocks <= 1.1 * insideBlocks);
+    CHECK(atSegments <= 1.1 * insideSegments);
+
+    // The same controls applied at once step the level at block edges,
+    // which this check must see
+    std::vector<float> stepped(out.size());
+    for (uint32_t n = 0; n < stepped.size(); n++) {
+        bool high = (n / (SYNTH_BLOCK_SIZE * CONTROL_BLOCKS)) % 2;
+        stepped[n] = (high ? 0.9f : 0.2f) * (float)sin(2.0 * M_PI * 400.0 * n / RATE);
+    }
+    double steppedEdges, steppedInside;
+    curvature(stepped, SYNTH_BLOCK_SIZE * CONTROL_BLOCKS, steppedEdges, steppedInside);
+    CHECK(steppedEdges > 1.1 * steppedInside);
+
+    // A glide reaches its target after SYNTH_GLIDE_SAMPLES wherever the
+    // render calls split it
+    EntropySynth split, whole;
+    split.begin(RATE);
+    whole.begin(RATE);
+    c.level = 0.7f;
+    split.setControls(c);
+    whole.setControls(c);
+    std::vector<float> a(2048), b(2048);
+    whole.render(b.data(), b.size());
+    uint32_t done = 0;
+    while (done < a.size()) {
+        uint32_t n = 1 + nextRandom() % 100;
+        if (n > a.size() - done) n = a.size() - done;
+        split.render(&a[done], n);
+        done += n;
+    }
+    double worst = 0;
+    for (uint32_t n = 0; n < a.size(); n++) worst = fmax(worst, fabs((double)a[n] - b[n]));
+    printf("  uneven render calls differ from whole blocks by at most %.5f\n", worst);
+    CHECK(worst < 0.02);
+}
+
+static void benchmark() {
+    const double blockMicros = 1e6 * SYNTH_BLOCK_SIZE / RATE;
+    float block[SYNTH_BLOCK_SIZE];
+    for (uint8_t v = SYNTH_NOISE; v <= SYNTH_PULSE; v++) {
+        EntropySynth synth;
+        synth.begin(RATE);
+        auto start = std::chrono::steady_clock::now();
+        for (uint32_t i = 0; i < BENCH_BLOCKS; i++) {
+            if (i % CONTROL_BLOCKS == 0) {
+                Reading r = readingAt(i / CONTROL_BLOCKS);
+                synth.setControls(EntropySynth::controlsFor((SynthVoice)v, r.normalized, r.shannonEntropy,
+                                                            r.complexity, r.anomaly, r.source));
+            }
+            synth.render(block, SYNTH_BLOCK_SIZE);
+        }
+        double micros = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count() * 1e6 /
+                        BENCH_BLOCKS;
+        volatile float sink = block[SYNTH_BLOCK_SIZE - 1];
+        (void)sink;
+        printf("  %-15s %6.2f us per %u-sample block (%.2f%% of its %.0f us)\n",
+               voiceNames[v], micros, (unsigned)SYNTH_BLOCK_SIZE, 100.0 * micros / blockMicros, blockMicros);
+        CHECK(micros < blockMicros);
+    }
+}
+
+int main() {
+    testSequenceToWav();
+    testBiquadResponse();
+    testNoControlSteps();
+    benchmark();
+    return testSummary("test_entropy_synth");
+}
@@ -0,0 +1,257 @@
+// ========================================
+// test_generator_bank - Checks EntropyGeneratorBank's block fills against
+// the per-sample generators EntropyBeacon used before, and that seeking
+// or discarding n words lands where generating n words does
+// Build on the host (or run tests/run_host_tests.sh):
+//   g++ -O2 -Itests -Iapps/EntropyBeacon -o test_generator_bank
+//       tests/test_generator_bank.cpp apps/EntropyBeacon/EntropyGeneratorBank.cpp
+// ========================================
+
+#include "test_support.h"
+#include "EntropyGeneratorBank.h"
+#include <string.h>
+#include <vector>
+
+#define WORDS       5000
+#define SEED        0x1234ABCDu
+
+// ===== PER-SAMPLE REFERENCE =====
+
+// The old generators, one word per call, state in a struct. Two changes:
+// float words go through int64 as the bank does (the old direct uint32_t
+// cast was undefined past 2^32), and the Mersenne Twister twists before
+// its first word like MT19937 (the old one first emitted the tempered
+// seed array; see testMersenneLegacy).
+struct PerSampleGenerators {
+    uint32_t lcgSeed;
+    uint32_t mt[624];
+    int mtIndex;
+    float logisticX, henonX, henonY, lorenzX, lorenzY, lorenzZ;
+    uint32_t lfsrState;
+
+    void seed(uint32_t s, bool legacy = false) {
+        lcgSeed = s;
+        mt[0] = s;
+        for (int i = 1; i < 624; i++) mt[i] = 1812433253u * (mt[i - 1] ^ (mt[i - 1] >> 30)) + i;
+        mtIndex = legacy ? 0 : 624;
+        logisticX = (float)(s % 1000) / 1000.0f;
+        henonX = (float)((s >> 8) % 100) / 100.0f;
+        henonY = (float)((s >> 16) % 100) / 100.0f;
+        lorenzX = (float)((s >> 4) % 50) - 25.0f;
+        lorenzY = (float)((s >> 12) % 50) - 25.0f;
+        lorenzZ = (float)((s >> 20) % 50);
+        lfsrState = s | 1;
+    }
+
+    static uint32_t word(float v) {
+        return (uint32_t)(int64_t)v;
+    }
+
+    uint32_t lcg() {
+        // The old modulus 0xFFFFFFFF differs from 2^32 only on a result of
+        // exactly 0xFFFFFFFF, which these runs never produce
+        lcgSeed = (1664525u * lcgSeed + 1013904223u) % 0xFFFFFFFFu;
+        return lcgSeed;
+    }
+
+    uint32_t mersenne() {
+        if (mtIndex >= 624) {
+            for (int i = 0; i < 624; i++) {
+                uint32_t y = (mt[i] & 0x80000000u) + (mt[(i + 1) % 624] & 0x7FFFFFFFu);
+                mt[i] = mt[(i + 397) % 624] ^ (y >> 1);
+                if (y % 2 != 0) mt[i] ^= 0x9908B0DFu;
+            }
+            mtIndex = 0;
+        }
+        uint32_t y = mt[mtIndex++];
+        y ^= y >> 11;
+        y ^= (y << 7) & 0x9D2C5680u;
+        y ^= (y << 15) & 0xEFC60000u;
+        y ^= y >> 18;
+        return y;
+    }
+
+    float logistic() {
+        logisticX = 3.9f * logisticX * (1.0f - logisticX);
+        if (logisticX < 0.0f) logisticX = 0.0f;
+        if (logisticX > 1.0f) logisticX = 1.0f;
+        return logisticX;
+    }
+
+    float henon() {
+        float newX = 1.0f - 1.4f * henonX * henonX + henonY;
+        henonY = 0.3f * henonX;
+        henonX = newX;
+        return newX;
+    }
+
+    float lorenz() {
+        float dx = 10.0f * (lorenzY - lorenzX);
+        float dy = lorenzX * (28.0f - lorenzZ) - lorenzY;
+        float dz = lorenzX * lorenzY - (8.0f / 3.0f) * lorenzZ;
+        lorenzX += dx * 0.01f;
+        lorenzY += dy * 0.01f;
+        lorenzZ += dz * 0.01f;
+        return lorenzX;
+    }
+
+    uint32_t lfsr() {
+        uint32_t lsb = lfsrState & 1;
+        lfsrState >>= 1;
+        if (lsb) lfsrState ^= 0xB400u;
+        return lfsrState;
+    }
+
+    uint32_t next(uint8_t id) {
+        switch (id) {
+            case GENERATOR_LCG:      return lcg();
+            case GENERATOR_MERSENNE: return mersenne();
+            case GENERATOR_LOGISTIC: return word(logistic() * (float)0xFFFFFFFF);
+            case GENERATOR_HENON:    return word((henon() + 2.0f) * (float)0x7FFFFFFF);
+            case GENERATOR_LORENZ:   return word((lorenz() + 50.0f) * (float)0x1FFFFFF);
+            case GENERATOR_LFSR:     return lfsr();
+            default: {
+                uint32_t a = lcg(), m = mersenne(), l = lfsr();
+                float lx = logistic();
+                float hx = henon();
+                float zx = lorenz();
+                return a ^ m ^ l ^ word(lx * (float)0xFFFFFFFF) ^
+                       word((hx + 2.0f) * (float)0x3FFFFFFF) ^ word((zx + 50.0f) * (float)0x1FFFFFF);
+            }
+        }
+    }
+};
+
+// ===== TESTS =====
+
+// Fills in uneven blocks so block edges land everywhere, including
+// inside a Mersenne twist
+static void fillUneven(EntropyGeneratorBank& bank, uint8_t id, uint32_t* out, uint32_t count) {
+    static const uint16_t sizes[] = {1, 7, 64, 3, 600, 31, 1000, 2};
+    uint32_t done = 0;
+    for (uint8_t k = 0; done < count; k = (k + 1) % 8) {
+        uint16_t n = sizes[k];
+        if (n > count - done) n = (uint16_t)(count - done);
+        bank.fill(id, out + done, n);
+        done += n;
+    }
+}
+
+static void testMatchesPerSample() {
+    std::vector<uint32_t> batch(WORDS);
+    for (uint8_t id = 0; id < GENERATOR_COUNT; id++) {
+        EntropyGeneratorBank bank;
+        bank.seed(SEED);
+        fillUneven(bank, id, batch.data(), WORDS);
+
+        PerSampleGenerators reference;
+        reference.seed(SEED);
+        uint32_t mismatches = 0;
+        for (uint32_t i = 0; i < WORDS; i++) {
+            if (batch[i] != reference.next(id)) mismatches++;
+        }
+        CHECK(mismatches == 0);
+        CHECK(bank.getPosition(id) == WORDS);
+        if (mismatches) fprintf(stderr, "  %s: %u of %u words differ\n",
+                                EntropyGeneratorBank::generatorName(id), (unsigned)mismatches, WORDS);
+    }
+}
+
+static void testMersenneLegacy() {
+    // The old generator's words after its untwisted first block are the
+    // bank's from the start
+    EntropyGeneratorBank bank;
+    bank.seed(SEED);
+    std::vector<uint32_t> batch(WORDS);
+    bank.fillMersenne(batch.data(), WORDS);
+
+    PerSampleGenerators legacy;
+    legacy.seed(SEED, true);
+    for (int i = 0; i < 624; i++) legacy.mersenne();
+    uint32_t mismatches = 0;
+    for (uint32_t i = 0; i < WORDS; i++) {
+        if (batch[i] != legacy.mersenne()) mismatches++;
+    }
+    CHECK(mismatches == 0);
+
+    // And it is MT19937: the reference 10000th word for seed 5489
+    bank.seed(5489);
+    uint32_t first;
+    bank.fillMersenne(&first, 1);
+    CHECK(first == 3499211612u);
+    bank.discard(GENERATOR_MERSENNE, 9998);
+    uint32_t tenThousandth;
+    bank.fillMersenne(&tenThousandth, 1);
+    CHECK(tenThousandth == 4123659995u);
+}
+
+static void testSeekAndDiscard() {
+    static const uint64_t offsets[] = {0, 1, 623, 624, 625, 1000, 12345, 65535, 65536, 200001};
+    uint32_t expected[16], got[16];
+
+    for (uint8_t id = 0; id < GENERATOR_COUNT; id++) {
+        for (uint64_t n : offsets) {
+            // Generating n words and throwing them away
+            EntropyGeneratorBank generated;
+            generated.seed(SEED);
+            std::vector<uint32_t> skipped(n ? n : 1);
+            uint64_t done = 0;
+            while (done < n) {
+                uint16_t chunk = n - done < 1000 ? (uint16_t)(n - done) : 1000;
+                generated.fill(id, skipped.data() + done, chunk);
+                done += chunk;
+            }
+            generated.fill(id, expected, 16);
+
+            // discard(n) gets there for every generator
+            EntropyGeneratorBank discarded;
+            discarded.seed(SEED);
+            discarded.discard(id, n);
+            discarded.fill(id, got, 16);
+            CHECK(memcmp(got, expected, sizeof(got)) == 0);
+            CHECK(discarded.getPosition(id) == n + 16);
+
+            // seek(n) does for the LCG and LFSR, from any current position
+            EntropyGeneratorBank sought;
+            sought.seed(SEED);
+            sought.fill(id, got, 16);
+            bool seekable = id == GENERATOR_LCG || id == GENERATOR_LFSR;
+            CHECK(sought.seek(id, n) == seekable);
+            if (seekable) {
+                sought.fill(id, got, 16);
+                CHECK(memcmp(got, expected, sizeof(got)) == 0);
+                CHECK(sought.getPosition(id) == n + 16);
+            }
+        }
+    }
+
+    // Jumps far beyond what can be generated compose: 2^40 = 2^39 + 2^39
+    EntropyGeneratorBank once, twice;
+    once.seed(SEED);
+    twice.seed(SEED);
+    for (uint8_t id : {(uint8_t)GENERATOR_LCG, (uint8_t)GENERATOR_LFSR}) {
+        once.seek(id, 1ull << 40);
+        twice.discard(id, 1ull << 39);
+        twice.discard(id, 1ull << 39);
+        once.fill(id, expected, 16);
+        twice.fill(id, got, 16);
+        CHECK(memcmp(got, expected, sizeof(got)) == 0);
+    }
+
+    // The LFSR taps are maximal: once the seed's upper bits have shifted
+    // out, the sequence repeats every 65535 words
+    EntropyGeneratorBank lfsr;
+    lfsr.seed(SEED);
+    lfsr.seek(GENERATOR_LFSR, 16);
+    lfsr.fillLFSR(expected, 16);
+    lfsr.seek(GENERATOR_LFSR, 16 + 65535);
+    lfsr.fillLFSR(got, 16);
+    CHECK(memcmp(got, expected, sizeof(got)) == 0);
+}
+
+int main() {
+    testMatchesPerSample();
+    testMersenneLegacy();
+    testSeekAndDiscard();
+    return testSummary("test_generator_bank");
+}
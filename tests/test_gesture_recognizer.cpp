@@ -0,0 +1,152 @@
+// ========================================
+// test_gesture_recognizer - Replays recorded touch traces through
+// GestureRecognizer::feed/tick and checks the emitted gesture sequence
+// Build on the host (or run tests/run_host_tests.sh):
+//   g++ -O2 -Itests -Icore/TouchInterface -o test_gesture_recognizer
+//       tests/test_gesture_recognizer.cpp core/TouchInterface/GestureRecognizer.cpp
+//       core/TouchInterface/TouchFilter.cpp
+// ========================================
+
+#include "test_support.h"
+#include "GestureRecognizer.h"
+#include <stdlib.h>
+#include <string.h>
+#include <string>
+#include <vector>
+
+// Trace steps, separated by ';':
+//   D|M|U <ms> <x> <y>   down, move or up sample
+//   T <ms>               tick without input
+static std::vector<GestureEvent> replay(GestureRecognizer& recognizer, const char* trace) {
+    std::vector<GestureEvent> out;
+    const char* p = trace;
+    while (*p) {
+        while (*p == ' ' || *p == ';') p++;
+        if (!*p) break;
+
+        char kind = *p++;
+        char* end;
+        uint32_t ms = (uint32_t)strtoul(p, &end, 10);
+        p = end;
+        if (kind == 'T') {
+            recognizer.tick(ms);
+        } else {
+            TouchEvent event;
+            event.type = kind == 'D' ? TOUCH_EVENT_DOWN : kind == 'M' ? TOUCH_EVENT_MOVE : TOUCH_EVENT_UP;
+            event.x = (int16_t)strtol(p, &end, 10);
+            p = end;
+            event.y = (int16_t)strtol(p, &end, 10);
+            p = end;
+            event.pressure = 400;
+            event.timestamp = ms;
+            recognizer.feed(event);
+        }
+
+        GestureEvent gesture;
+        while (recognizer.poll(gesture)) out.push_back(gesture);
+    }
+    return out;
+}
+
+static std::string names(const std::vector<GestureEvent>& events) {
+    std::string s;
+    for (size_t i = 0; i < events.size(); i++) {
+        if (i) s += ' ';
+        s += GestureRecognizer::gestureName(events[i].type);
+    }
+    return s;
+}
+
+static std::vector<GestureEvent> expectTrace(const char* trace, const char* expected) {
+    GestureRecognizer recognizer;
+    std::vector<GestureEvent> events = replay(recognizer, trace);
+    std::string got = names(events);
+    CHECK(got == expected);
+    if (got != expected) fprintf(stderr, "  trace \"%s\"\n  got \"%s\", expected \"%s\"\n",
+                                 trace, got.c_str(), expected);
+    return events;
+}
+
+static void testTaps() {
+    std::vector<GestureEvent> e = expectTrace("D 0 100 100; U 80 101 100", "TAP");
+    CHECK(e[0].duration == 80);
+
+    // The first tap is reported at once, so a double tap reads TAP DOUBLE_TAP
+    e = expectTrace("D 0 100 100; U 80 100 100; D 200 105 104; U 260 105 104", "TAP DOUBLE_TAP");
+    CHECK(e[1].timestamp == 260);
+
+    // Outside the time window or the slop radius it is two taps
+    expectTrace("D 0 100 100; U 80 100 100; D 400 100 100; U 460 100 100", "TAP TAP");
+    expectTrace("D 0 100 100; U 80 100 100; D 200 130 100; U 260 130 100", "TAP TAP");
+
+    // A third quick tap starts a new pair
+    expectTrace("D 0 50 50; U 50 50 50; D 150 50 50; U 200 50 50; D 300 50 50; U 350 50 50",
+                "TAP DOUBLE_TAP TAP");
+}
+
+static void testLongPress() {
+    std::vector<GestureEvent> e = expectTrace("D 0 60 60; T 500; T 799; T 800; T 900; U 1000 60 60",
+                                              "LONG_PRESS");
+    CHECK(e[0].timestamp == 800);
+
+    // Expiry noticed on the next sample rather than a tick
+    expectTrace("D 0 60 60; M 850 62 60; U 900 62 60", "LONG_PRESS");
+
+    // A tap after a long press is not the second half of a double tap
+    expectTrace("D 0 60 60; T 800; U 850 60 60; D 950 60 60; U 1000 60 60", "LONG_PRESS TAP");
+
+    // Moving after the long press turns it into a drag
+    expectTrace("D 0 60 60; T 800; M 900 90 60; U 1400 90 60", "LONG_PRESS DRAG_START DRAG_END");
+}
+
+static void testDrags() {
+    // 5 px stays a press; 20 px starts the drag; slow release is no swipe
+    std::vector<GestureEvent> e =
+        expectTrace("D 0 50 50; M 20 55 50; M 40 70 50; M 60 80 50; M 80 80 50; U 400 80 50",
+                    "DRAG_START DRAG_MOVE DRAG_END");
+    CHECK(e[0].deltaX == 20 && e[0].deltaY == 0);
+    CHECK(e[1].deltaX == 10);           // Since the previous move
+    CHECK(e[2].deltaX == 30);           // Since the press
+    CHECK(e[2].velocity == 0.0f);       // No sample inside the release window
+}
+
+static void testSwipes() {
+    std::vector<GestureEvent> e =
+        expectTrace("D 0 20 100; M 10 40 100; M 20 80 100; M 30 120 100; U 40 140 100",
+                    "DRAG_START DRAG_MOVE DRAG_MOVE DRAG_END SWIPE_RIGHT");
+    CHECK_NEAR(e.back().velocity, 3000.0, 1.0);  // 120 px over 40 ms
+    CHECK(e.back().deltaX == 120);
+
+    expectTrace("D 0 200 100; M 10 170 100; M 20 120 100; U 30 100 100",
+                "DRAG_START DRAG_MOVE DRAG_END SWIPE_LEFT");
+    expectTrace("D 0 100 200; M 10 100 170; M 20 100 120; U 30 100 100",
+                "DRAG_START DRAG_MOVE DRAG_END SWIPE_UP");
+    expectTrace("D 0 100 20; M 10 100 50; M 20 100 100; U 30 100 120",
+                "DRAG_START DRAG_MOVE DRAG_END SWIPE_DOWN");
+
+    // Far enough but too slow: only the early samples of a long drag are fast
+    expectTrace("D 0 20 100; M 100 60 100; M 600 100 100; M 900 100 100; U 1000 100 100",
+                "DRAG_START DRAG_MOVE DRAG_END");
+}
+
+static void testRobustness() {
+    // Moves and ups without a press are ignored
+    expectTrace("M 0 10 10; U 10 10 10", "");
+    // A lost up: the second down starts a fresh press
+    expectTrace("D 0 10 10; D 100 200 200; U 150 200 200", "TAP");
+
+    // reset() drops pending output and the previous tap
+    GestureRecognizer recognizer;
+    replay(recognizer, "D 0 100 100; U 80 100 100");
+    recognizer.reset();
+    CHECK(names(replay(recognizer, "D 150 100 100; U 200 100 100")) == "TAP");
+}
+
+int main() {
+    testTaps();
+    testLongPress();
+    testDrags();
+    testSwipes();
+    testRobustness();
+    return testSummary("test_gesture_recognizer");
+}
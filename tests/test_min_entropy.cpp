@@ -0,0 +1,325 @@
+// ========================================
+// test_min_entropy - Checks MinEntropyEstimator against a literal
+// double-precision reading of the SP 800-90B non-IID estimators (brute
+// force tuple counts, the O(L^2) compression sum, bisection for the
+// collision and compression equations) on uniform and biased sources,
+// and against the known min-entropy of those sources
+// Build on the host (or run tests/run_host_tests.sh):
+//   g++ -O2 -Itests -Iapps/EntropyBeacon -o test_min_entropy
+//       tests/test_min_entropy.cpp apps/EntropyBeacon/MinEntropyEstimator.cpp
+// ========================================
+
+#include "test_support.h"
+#include "MinEntropyEstimator.h"
+#include <math.h>
+#include <map>
+#include <string>
+#include <vector>
+
+#define WINDOW      1024
+#define Z           2.576
+
+static uint32_t rngState = 1;
+static uint32_t nextRandom() {
+    rngState = rngState * 1664525u + 1013904223u;
+    return rngState >> 8;
+}
+
+// ===== 800-90B REFERENCE =====
+
+static double upperBound(double p, size_t n) {
+    double bound = p + Z * sqrt(p * (1.0 - p) / (n - 1));
+    return bound < 1.0 ? bound : 1.0;
+}
+
+static double bitsOf(double p) {
+    return p < 1.0 ? -log2(p) : 0.0;
+}
+
+static std::vector<uint8_t> toBits(const std::vector<uint8_t>& s) {
+    std::vector<uint8_t> bits;
+    for (uint8_t v : s) {
+        for (int b = 7; b >= 0; b--) bits.push_back((v >> b) & 1);
+    }
+    return bits;
+}
+
+// 6.3.1
+static double referenceMCV(const std::vector<uint8_t>& s) {
+    size_t counts[256] = {0};
+    size_t best = 0;
+    for (uint8_t v : s) {
+        if (++counts[v] > best) best = counts[v];
+    }
+    return bitsOf(upperBound((double)best / s.size(), s.size()));
+}
+
+// 6.3.2, binary: the first repeat comes at the second or third bit
+static double referenceCollision(const std::vector<uint8_t>& bits) {
+    std::vector<double> t;
+    size_t index = 0;
+    while (index + 1 < bits.size()) {
+        if (bits[index] == bits[index + 1]) {
+            t.push_back(2);
+            index += 2;
+        } else if (index + 2 < bits.size()) {
+            t.push_back(3);
+            index += 3;
+        } else {
+            break;
+        }
+    }
+    double v = t.size(), mean = 0, squares = 0;
+    for (double x : t) mean += x;
+    mean /= v;
+    for (double x : t) squares += (x - mean) * (x - mean);
+    double bound = mean - Z * sqrt(squares / (v - 1)) / sqrt(v);
+
+    // E[t] = 2(p^2 + q^2) + 3(2pq) falls from 2.5 at p = 1/2 to 2 at p = 1
+    double p;
+    if (bound >= 2.5) {
+        p = 0.5;
+    } else if (bound <= 2.0) {
+        p = 1.0;
+    } else {
+        double low = 0.5, high = 1.0;
+        for (int i = 0; i < 60; i++) {
+            double mid = 0.5 * (low + high);
+            double q = 1.0 - mid;
+            double expected = 2 * (mid * mid + q * q) + 6 * mid * q;
+            if (expected > bound) low = mid; else high = mid;
+        }
+        p = 0.5 * (low + high);
+    }
+    return bitsOf(p) * 8;
+}
+
+// 6.3.3
+static double referenceMarkov(const std::vector<uint8_t>& bits) {
+    double c[2] = {0, 0}, tr[2][2] = {{0, 0}, {0, 0}};
+    for (size_t i = 0; i < bits.size(); i++) {
+        c[bits[i]]++;
+        if (i + 1 < bits.size()) tr[bits[i]][bits[i + 1]]++;
+    }
+    double p0 = c[0] / bits.size(), p1 = c[1] / bits.size();
+    double f0 = tr[0][0] + tr[0][1], f1 = tr[1][0] + tr[1][1];
+    double p00 = f0 ? tr[0][0] / f0 : 0, p01 = f0 ? tr[0][1] / f0 : 0;
+    double p10 = f1 ? tr[1][0] / f1 : 0, p11 = f1 ? tr[1][1] / f1 : 0;
+
+    double candidates[6] = {
+        p0 * pow(p00, 127),
+        p0 * pow(p01, 64) * pow(p10, 63),
+        p0 * p01 * pow(p11, 126),
+        p1 * p10 * pow(p00, 126),
+        p1 * pow(p10, 64) * pow(p01, 63),
+        p1 * pow(p11, 127)
+    };
+    double best = 0;
+    for (double x : candidates) {
+        if (x > best) best = x;
+    }
+    double h = -log2(best) / 128;
+    return (h < 1.0 ? h : 1.0) * 8;
+}
+
+// G(z) of 6.3.4 with the double sum written out
+static double compressionG(double z, size_t blocks, size_t d) {
+    double sum = 0;
+    for (size_t t = d + 1; t <= blocks; t++) {
+        double w = 1;                               // (1 - z)^(u - 1)
+        for (size_t u = 1; u <= t; u++) {
+            double f = u < t ? z * z * w : z * w;
+            sum += log2((double)u) * f;
+            w *= 1 - z;
+        }
+    }
+    return sum / (blocks - d);
+}
+
+// 6.3.4, with the dictionary capped at half the blocks as the estimator does
+static double referenceCompression(const std::vector<uint8_t>& bits) {
+    const size_t b = 6;
+    size_t blocks = bits.size() / b;
+    size_t d = blocks / 2 < 1000 ? blocks / 2 : 1000;
+    size_t v = blocks - d;
+
+    std::vector<size_t> dict(64, 0);
+    double sum = 0, squares = 0;
+    for (size_t i = 1; i <= blocks; i++) {
+        size_t block = 0;
+        for (size_t k = 0; k < b; k++) block = (block << 1) | bits[(i - 1) * b + k];
+        if (i > d) {
+            double l = log2((double)(dict[block] ? i - dict[block] : i));
+            sum += l;
+            squares += l * l;
+        }
+        dict[block] = i;
+    }
+    double mean = sum / v;
+    double sigma = 0.5907 * sqrt(squares / (v - 1) - mean * mean);
+    double bound = mean - Z * sigma / sqrt((double)v);
+
+    auto expectation = [&](double p) {
+        double q = (1 - p) / 63;
+        return compressionG(p, blocks, d) + 63 * compressionG(q, blocks, d);
+    };
+    double low = 1.0 / 64, high = 1.0, p;
+    if (bound >= expectation(low)) {
+        p = low;
+    } else {
+        for (int i = 0; i < 30; i++) {
+            double mid = 0.5 * (low + high);
+            if (expectation(mid) > bound) low = mid; else high = mid;
+        }
+        p = 0.5 * (low + high);
+    }
+    return bitsOf(p) / b * 8;
+}
+
+static std::map<std::string, size_t> tupleCounts(const std::vector<uint8_t>& s, size_t t) {
+    std::map<std::string, size_t> counts;
+    for (size_t i = 0; i + t <= s.size(); i++) {
+        counts[std::string(s.begin() + i, s.begin() + i + t)]++;
+    }
+    return counts;
+}
+
+// 6.3.5 and 6.3.6
+static void referenceTuples(const std::vector<uint8_t>& s, double& tuple, double& lrs,
+                            size_t& tupleLength, size_t& lrsLength) {
+    size_t n = s.size();
+    double pMax = 0;
+    size_t t = 1;
+    for (;; t++) {
+        size_t best = 0;
+        for (auto& entry : tupleCounts(s, t)) {
+            if (entry.second > best) best = entry.second;
+        }
+        if (best < 35) break;
+        double p = pow((double)best / (n - t + 1), 1.0 / t);
+        if (p > pMax) pMax = p;
+    }
+    tupleLength = t - 1;
+    tuple = tupleLength ? bitsOf(upperBound(pMax, n)) : MIN_ENTROPY_NOT_APPLICABLE;
+
+    lrsLength = 0;
+    for (size_t w = 1;; w++) {
+        bool repeated = false;
+        for (auto& entry : tupleCounts(s, w)) {
+            if (entry.second > 1) repeated = true;
+        }
+        if (!repeated) break;
+        lrsLength = w;
+    }
+    if (lrsLength < t) {
+        lrs = MIN_ENTROPY_NOT_APPLICABLE;
+        return;
+    }
+    pMax = 0;
+    for (size_t w = t; w <= lrsLength; w++) {
+        double pairs = 0;
+        for (auto& entry : tupleCounts(s, w)) pairs += entry.second * (entry.second - 1.0) / 2;
+        double tuples = n - w + 1;
+        double p = pow(pairs / (tuples * (tuples - 1) / 2), 1.0 / w);
+        if (p > pMax) pMax = p;
+    }
+    lrs = bitsOf(upperBound(pMax, n));
+}
+
+// ===== COMPARISON =====
+
+static const MinEntropyResult& estimate(MinEntropyEstimator& estimator, const std::vector<uint8_t>& s) {
+    for (uint8_t v : s) estimator.push(v);
+    CHECK(estimator.windowReady());
+    estimator.finishWindow();
+    return estimator.getResult();
+}
+
+static void compareSource(const char* name, uint8_t (*source)(), double trueMinEntropy) {
+    MinEntropyEstimator estimator;
+    CHECK(estimator.configure(WINDOW));
+
+    // Two windows: the second starts from state left by the first
+    for (int w = 0; w < 2; w++) {
+        std::vector<uint8_t> s(WINDOW);
+        for (uint8_t& v : s) v = source();
+        std::vector<uint8_t> bits = toBits(s);
+        const MinEntropyResult& r = estimate(estimator, s);
+        CHECK(r.windows == (uint32_t)w + 1 && r.samples == WINDOW);
+
+        double tuple, lrs;
+        size_t tupleLength, lrsLength;
+        referenceTuples(s, tuple, lrs, tupleLength, lrsLength);
+        double reference[MIN_ENTROPY_ESTIMATOR_COUNT] = {
+            referenceMCV(s), referenceCollision(bits), referenceMarkov(bits),
+            referenceCompression(bits), tuple, lrs
+        };
+
+        CHECK_NEAR(r.estimate[MIN_ENTROPY_MCV], reference[MIN_ENTROPY_MCV], 1e-5);
+        CHECK_NEAR(r.estimate[MIN_ENTROPY_COLLISION], reference[MIN_ENTROPY_COLLISION], 1e-4);
+        CHECK_NEAR(r.estimate[MIN_ENTROPY_MARKOV], reference[MIN_ENTROPY_MARKOV], 1e-4);
+        CHECK_NEAR(r.estimate[MIN_ENTROPY_COMPRESSION], reference[MIN_ENTROPY_COMPRESSION], 2e-3);
+        CHECK_NEAR(r.estimate[MIN_ENTROPY_TUPLE], reference[MIN_ENTROPY_TUPLE], 1e-4);
+        CHECK_NEAR(r.estimate[MIN_ENTROPY_LRS], reference[MIN_ENTROPY_LRS], 1e-4);
+        CHECK(r.tupleLength == tupleLength && r.lrsLength == lrsLength);
+
+        // The overall figure is the lowest applicable estimate
+        double lowest = -1;
+        for (double h : reference) {
+            if (h >= 0 && (lowest < 0 || h < lowest)) lowest = h;
+        }
+        CHECK_NEAR(r.minEntropy, lowest, 2e-3);
+
+        // The overall figure does not overstate the source, and MCV sits
+        // just under the truth once the bias is visible in one window
+        CHECK(r.minEntropy < trueMinEntropy + 0.1);
+        if (trueMinEntropy < 4.0) {
+            CHECK(r.estimate[MIN_ENTROPY_MCV] <= trueMinEntropy + 0.05);
+            CHECK(r.estimate[MIN_ENTROPY_MCV] > trueMinEntropy - 0.3);
+        }
+
+        if (w == 1) {
+            printf("  %-8s true %.2f:", name, trueMinEntropy);
+            for (uint8_t i = 0; i < MIN_ENTROPY_ESTIMATOR_COUNT; i++) {
+                printf(" %s %.2f", MinEntropyEstimator::estimatorName(i), r.estimate[i]);
+            }
+            printf("\n");
+        }
+    }
+}
+
+static uint8_t uniformSource() {
+    return (uint8_t)nextRandom();
+}
+
+// Each bit is 1 with probability 0.8: 8 * -log2(0.8) = 2.58 bits per symbol
+static uint8_t biasedBitSource() {
+    uint8_t v = 0;
+    for (int b = 0; b < 8; b++) v = (uint8_t)((v << 1) | ((nextRandom() % 10) < 8));
+    return v;
+}
+
+// Symbol 0 half the time, otherwise uniform: -log2(0.5 + 0.5 / 256)
+static uint8_t biasedSymbolSource() {
+    return (nextRandom() & 1) ? 0 : (uint8_t)nextRandom();
+}
+
+int main() {
+    rngState = 5;
+    compareSource("uniform", uniformSource, 8.0);
+    compareSource("bits 0.8", biasedBitSource, -8 * log2(0.8));
+    compareSource("mode 0.5", biasedSymbolSource, -log2(0.5 + 0.5 / 256));
+
+    // A stuck source has no min-entropy
+    MinEntropyEstimator estimator;
+    CHECK(estimator.configure(WINDOW));
+    std::vector<uint8_t> constant(WINDOW, 0x00);
+    const MinEntropyResult& r = estimate(estimator, constant);
+    CHECK(r.minEntropy == 0.0f);
+    CHECK(r.estimate[MIN_ENTROPY_MCV] == 0.0f && r.estimate[MIN_ENTROPY_MARKOV] == 0.0f);
+
+    CHECK(!estimator.configure(MIN_ENTROPY_MIN_WINDOW - 1));
+    CHECK(!estimator.configure(MIN_ENTROPY_MAX_WINDOW + 1));
+
+    return testSummary("test_min_entropy");
+}
@@ -0,0 +1,169 @@
+// ========================================
+// test_peak_tracker - Top-K peak selection against a brute-force sort and
+// track identity across frames with synthetic drifting tones
+// Build on the host (or run tests/run_host_tests.sh):
+//   g++ -O2 -Itests -Iapps/PreqScanner -o test_peak_tracker
+//       tests/test_peak_tracker.cpp apps/PreqScanner/PeakTracker.cpp
+// ========================================
+
+#include "test_support.h"
+#include "PeakTracker.h"
+#include <math.h>
+#include <algorithm>
+#include <vector>
+
+#define BINS        512
+#define BIN_WIDTH   20.0f
+#define FLOOR_DB    -90.0f
+
+static uint32_t rngState = 99;
+static float uniform() {
+    rngState = rngState * 1664525u + 1013904223u;
+    return (rngState >> 8) / 16777216.0f;
+}
+
+static float spectrum[BINS];
+
+// Noise around -100 dB with parabolic (in dB) main lobes, so interpolation is exact
+static void buildSpectrum(const float* bins, const float* levels, int count) {
+    for (int i = 0; i < BINS; i++) spectrum[i] = -100.0f + 3.0f * uniform();
+    for (int t = 0; t < count; t++) {
+        int centre = (int)lroundf(bins[t]);
+        for (int i = centre - 3; i <= centre + 3; i++) {
+            if (i < 0 || i >= BINS) continue;
+            float d = i - bins[t];
+            float v = levels[t] - 6.0f * d * d;
+            if (v > spectrum[i]) spectrum[i] = v;
+        }
+    }
+}
+
+// Every bin the tracker would accept, strongest first; a tie goes right
+static std::vector<std::pair<float, uint16_t> > bruteForcePeaks() {
+    std::vector<std::pair<float, uint16_t> > all;
+    for (int i = PEAK_NEIGHBOR_BINS; i < BINS - PEAK_NEIGHBOR_BINS; i++) {
+        float v = spectrum[i];
+        bool isPeak = v > FLOOR_DB;
+        for (int k = 1; k <= PEAK_NEIGHBOR_BINS; k++) {
+            if (v < spectrum[i - k] || v <= spectrum[i + k]) isPeak = false;
+        }
+        if (isPeak) all.push_back(std::make_pair(v, (uint16_t)i));
+    }
+    std::sort(all.begin(), all.end(), std::greater<std::pair<float, uint16_t> >());
+    return all;
+}
+
+static void testTopK() {
+    PeakTracker tracker;
+    int mismatches = 0;
+
+    for (int trial = 0; trial < 300; trial++) {
+        float bins[24], levels[24];
+        int count = 1 + (int)(uniform() * 24);
+        for (int t = 0; t < count; t++) {
+            bins[t] = 4 + uniform() * (BINS - 8);
+            levels[t] = -80.0f + uniform() * 70.0f;
+        }
+        buildSpectrum(bins, levels, count);
+
+        uint8_t k = (uint8_t)(1 + trial % PEAK_MAX_PEAKS);
+        tracker.reset();
+        uint8_t found = tracker.process(spectrum, nullptr, BINS, 0.0f, BIN_WIDTH, FLOOR_DB, k, trial);
+
+        std::vector<std::pair<float, uint16_t> > expected = bruteForcePeaks();
+        size_t want = std::min<size_t>(k, expected.size());
+        if (found != want) {
+            mismatches++;
+            continue;
+        }
+        for (uint8_t p = 0; p < found; p++) {
+            if (tracker.getPeaks()[p].binIndex != expected[p].second) mismatches++;
+        }
+    }
+    CHECK(mismatches == 0);
+
+    // Interpolated frequency and level of an off-bin tone
+    float bin = 100.3f, level = -20.0f;
+    buildSpectrum(&bin, &level, 1);
+    tracker.reset();
+    CHECK(tracker.process(spectrum, nullptr, BINS, 1000.0f, BIN_WIDTH, FLOOR_DB, 4, 0) == 1);
+    CHECK_NEAR(tracker.getPeaks()[0].frequency, 1000.0f + 100.3f * BIN_WIDTH, 0.05f * BIN_WIDTH);
+    CHECK_NEAR(tracker.getPeaks()[0].magnitude, -20.0, 0.05);
+
+    // A tone midway between bins gives two equal bins and one peak
+    bin = 200.5f;
+    buildSpectrum(&bin, &level, 1);
+    CHECK(spectrum[200] == spectrum[201]);
+    tracker.reset();
+    CHECK(tracker.process(spectrum, nullptr, BINS, 0.0f, BIN_WIDTH, FLOOR_DB, 4, 0) == 1);
+    CHECK_NEAR(tracker.getPeaks()[0].frequency, 200.5f * BIN_WIDTH, 0.01f);
+
+    // Nothing above the floor, and NaN bins, yield no peaks
+    for (int i = 0; i < BINS; i++) spectrum[i] = -100.0f;
+    spectrum[50] = NAN;
+    CHECK(tracker.process(spectrum, nullptr, BINS, 0.0f, BIN_WIDTH, FLOOR_DB, 8, 0) == 0);
+}
+
+static void testDriftingTones() {
+    PeakTracker tracker;
+    float bins[3] = {60.0f, 200.0f, 380.0f};
+    const float drift[3] = {0.6f, -0.4f, 0.25f};     // Bins per frame, under the gate
+    float levels[3] = {-30.0f, -40.0f, -50.0f};
+    uint16_t ids[3] = {0, 0, 0};
+    bool stable = true;
+
+    for (int frame = 0; frame < 80; frame++) {
+        buildSpectrum(bins, levels, 3);
+        CHECK(tracker.process(spectrum, nullptr, BINS, 0.0f, BIN_WIDTH, FLOOR_DB, 8, frame * 50) == 3);
+        for (int t = 0; t < 3; t++) {
+            // Peaks come out strongest first, which is the tone order here
+            uint16_t id = tracker.getPeaks()[t].trackId;
+            if (frame == 0) ids[t] = id;
+            else if (id != ids[t]) stable = false;
+            bins[t] += drift[t];
+        }
+    }
+    CHECK(stable);
+    CHECK(ids[0] != 0 && ids[0] != ids[1] && ids[1] != ids[2]);
+    CHECK(tracker.getTracksStarted() == 3);
+
+    const PeakTrack* track = tracker.findTrack(ids[0]);
+    CHECK(track != nullptr);
+    CHECK_NEAR(track->drift(), 79 * 0.6 * BIN_WIDTH, 0.1 * BIN_WIDTH);
+    CHECK(track->hits == 80);
+    CHECK(track->duration() == 79 * 50);
+
+    // A tone missing for a few frames keeps its track
+    float two[2] = {bins[0], bins[2]};
+    float twoLevels[2] = {levels[0], levels[2]};
+    for (int frame = 0; frame < PEAK_TRACK_MAX_MISSES; frame++) {
+        buildSpectrum(two, twoLevels, 2);
+        tracker.process(spectrum, nullptr, BINS, 0.0f, BIN_WIDTH, FLOOR_DB, 8, 5000 + frame);
+    }
+    buildSpectrum(bins, levels, 3);
+    tracker.process(spectrum, nullptr, BINS, 0.0f, BIN_WIDTH, FLOOR_DB, 8, 6000);
+    CHECK(tracker.getPeaks()[1].trackId == ids[1]);
+
+    // Missing for longer, it comes back as a new track
+    for (int frame = 0; frame <= PEAK_TRACK_MAX_MISSES; frame++) {
+        buildSpectrum(two, twoLevels, 2);
+        tracker.process(spectrum, nullptr, BINS, 0.0f, BIN_WIDTH, FLOOR_DB, 8, 7000 + frame);
+    }
+    CHECK(tracker.findTrack(ids[1]) == nullptr);
+    buildSpectrum(bins, levels, 3);
+    tracker.process(spectrum, nullptr, BINS, 0.0f, BIN_WIDTH, FLOOR_DB, 8, 8000);
+    CHECK(tracker.getPeaks()[1].trackId != ids[1] && tracker.getPeaks()[1].trackId != 0);
+    CHECK(tracker.getPeaks()[0].trackId == ids[0]);
+
+    // A jump beyond the gate is a different signal
+    bins[2] += PEAK_TRACK_GATE_BINS + 2.0f;
+    buildSpectrum(bins, levels, 3);
+    tracker.process(spectrum, nullptr, BINS, 0.0f, BIN_WIDTH, FLOOR_DB, 8, 8050);
+    CHECK(tracker.getPeaks()[2].trackId != ids[2]);
+}
+
+int main() {
+    testTopK();
+    testDriftingTones();
+    return testSummary("test_peak_tracker");
+}
@@ -0,0 +1,295 @@
+// ========================================
+// test_plot_layers - Draws scrolling traces, a sweeping trace, bars and a
+// scatter through ColumnLayer and PointLayer onto a counting mock display
+// and checks every frame against a full redraw of the same picture, and
+// that the incremental updates touch fewer pixels than full redraws do
+// Build on the host (or run tests/run_host_tests.sh):
+//   g++ -O2 -Itests -Iapps/EntropyBeacon -o test_plot_layers
+//       tests/test_plot_layers.cpp apps/EntropyBeacon/PlotLayers.cpp
+// ========================================
+
+#include "test_support.h"
+#include "PlotLayers.h"
+#include <string.h>
+#include <vector>
+
+#define SCREEN_W    320
+#define SCREEN_H    240
+#define FRAMES      200
+
+#define COLOR_TRACE     0x07E0
+#define COLOR_MARKER    0xF800
+#define COLOR_BAR       0x001F
+
+static uint32_t rngState = 11;
+static uint32_t nextRandom() {
+    rngState = rngState * 1664525u + 1013904223u;
+    return rngState >> 8;
+}
+
+// ===== MOCK DISPLAY =====
+
+// Framebuffer that counts every pixel written to it
+struct CountingDisplay {
+    std::vector<uint16_t> pixels;
+    uint32_t written;
+
+    CountingDisplay() : pixels(SCREEN_W * SCREEN_H, 0), written(0) {}
+
+    void drawPixel(int16_t x, int16_t y, uint16_t color) {
+        pixels[y * SCREEN_W + x] = color;
+        written++;
+    }
+
+    // What the app's column push does: one address window, rows in order
+    void pushUpdate(const PlotUpdate& update) {
+        for (int16_t row = 0; row < update.height; row++) {
+            for (int16_t col = 0; col < update.width; col++) {
+                drawPixel(update.x + col, update.y + row, update.pixels[row * update.width + col]);
+            }
+        }
+    }
+
+    uint32_t flush(ColumnLayer& layer) {
+        uint32_t before = written;
+        PlotUpdate update;
+        while (layer.nextUpdate(update)) pushUpdate(update);
+        return written - before;
+    }
+
+    uint32_t flush(PointLayer& layer) {
+        uint32_t before = written;
+        PlotPoint pixel;
+        while (layer.nextPixel(pixel)) drawPixel(pixel.x, pixel.y, pixel.color);
+        return written - before;
+    }
+};
+
+// ===== FULL REDRAW REFERENCE =====
+
+// The picture a full redraw produces: spans per column, slot order
+struct ColumnPicture {
+    struct Span {
+        int16_t top, bottom;     // top > bottom: empty
+        uint16_t color;
+    };
+    PlotFrame frame;
+    uint8_t slots;
+    std::vector<Span> spans;
+
+    ColumnPicture(const PlotFrame& f, uint8_t s) : frame(f), slots(s), spans(f.width * s) { clearAll(); }
+
+    void clearAll() {
+        for (Span& span : spans) span = {1, 0, 0};
+    }
+    void set(int16_t column, uint8_t slot, int16_t row0, int16_t row1, uint16_t color) {
+        if (row0 > row1) {
+            int16_t t = row0;
+            row0 = row1;
+            row1 = t;
+        }
+        if (row0 < 0) row0 = 0;
+        if (row1 >= frame.height) row1 = frame.height - 1;
+        spans[column * slots + slot] = {row0, row1, color};
+    }
+
+    // Draws every pixel of the frame; returns how many
+    uint32_t redraw(std::vector<uint16_t>& out) const {
+        for (int16_t row = 0; row < frame.height; row++) {
+            for (int16_t column = 0; column < frame.width; column++) {
+                out[(frame.y + row) * SCREEN_W + frame.x + column] = plotBackground(frame, column, row);
+            }
+        }
+        for (int16_t column = 0; column < frame.width; column++) {
+            for (uint8_t s = 0; s < slots; s++) {
+                const Span& span = spans[column * slots + s];
+                for (int16_t row = span.top; row <= span.bottom; row++) {
+                    out[(frame.y + row) * SCREEN_W + frame.x + column] = span.color;
+                }
+            }
+        }
+        return (uint32_t)frame.width * frame.height;
+    }
+};
+
+// Sets the same span on the layer and the reference
+static void setBoth(ColumnLayer& layer, ColumnPicture& picture, int16_t column, uint8_t slot,
+                    int16_t row0, int16_t row1, uint16_t color) {
+    layer.setSpan(column, slot, row0, row1, color);
+    picture.set(column, slot, row0, row1, color);
+}
+
+static bool sameFrame(const CountingDisplay& display, const std::vector<uint16_t>& reference,
+                      const PlotFrame& frame) {
+    for (int16_t row = 0; row < frame.height; row++) {
+        for (int16_t column = 0; column < frame.width; column++) {
+            uint32_t i = (frame.y + row) * SCREEN_W + frame.x + column;
+            if (display.pixels[i] != reference[i]) return false;
+        }
+    }
+    return true;
+}
+
+static PlotFrame graphFrame() {
+    PlotFrame frame;
+    frame.x = 40;
+    frame.y = 30;
+    frame.width = 240;
+    frame.height = 160;
+    frame.background = 0x0000;
+    frame.grid = 0x2104;
+    frame.axis = 0x4208;
+    frame.divisions = 4;
+    return frame;
+}
+
+// ===== TESTS =====
+
+// Trace of a random walk, one segment per column joining each sample to
+// the next, plus a one-row marker over the newest sample. scroll moves
+// every sample one column per frame; otherwise a sweep overwrites one
+// column per frame like an oscilloscope.
+static void runTrace(const char* name, bool scroll, double maxRatio) {
+    PlotFrame frame = graphFrame();
+    ColumnLayer layer;
+    CHECK(layer.begin(frame, 2));
+    ColumnPicture picture(frame, 2);
+    CountingDisplay display;
+    std::vector<uint16_t> reference(SCREEN_W * SCREEN_H, 0);
+
+    std::vector<int16_t> samples(frame.width, frame.height / 2);
+    int16_t walk = frame.height / 2;
+    uint32_t incremental = 0, full = 0, mismatches = 0;
+
+    for (uint32_t f = 0; f < FRAMES; f++) {
+        walk += (int16_t)(nextRandom() % 13) - 6;
+        if (walk < 2) walk = 2;
+        if (walk > frame.height - 3) walk = frame.height - 3;
+
+        int16_t newest;
+        if (scroll) {
+            samples.erase(samples.begin());
+            samples.push_back(walk);
+            newest = frame.width - 1;
+        } else {
+            newest = (int16_t)(f % frame.width);
+            samples[newest] = walk;
+        }
+
+        for (int16_t x = 0; x < frame.width; x++) {
+            int16_t from = x > 0 ? samples[x - 1] : samples[x];
+            setBoth(layer, picture, x, 0, from, samples[x], COLOR_TRACE);
+            layer.clearSpan(x, 1);
+            picture.spans[x * 2 + 1] = {1, 0, 0};
+        }
+        setBoth(layer, picture, newest, 1, samples[newest] - 1, samples[newest] - 1, COLOR_MARKER);
+
+        uint32_t sent = display.flush(layer);
+        // The first pass paints the whole frame
+        if (f == 0) CHECK(sent == (uint32_t)frame.width * frame.height);
+        incremental += sent;
+        full += picture.redraw(reference);
+        if (!sameFrame(display, reference, frame)) mismatches++;
+    }
+    CHECK(mismatches == 0);
+
+    double ratio = (double)incremental / full;
+    CHECK(ratio < maxRatio);
+    printf("  %-8s %7u pixels incremental, %7u full redraw (%.1f%%)\n",
+           name, (unsigned)incremental, (unsigned)full, 100.0 * ratio);
+
+    // After invalidate() the whole frame is sent again, and still matches
+    layer.invalidate();
+    CHECK(display.flush(layer) == (uint32_t)frame.width * frame.height);
+    CHECK(sameFrame(display, reference, frame));
+    CHECK(display.flush(layer) == 0);
+}
+
+static void testBars() {
+    PlotFrame frame = graphFrame();
+    frame.divisions = 0;
+    ColumnLayer layer;
+    CHECK(layer.begin(frame, 1));
+    ColumnPicture picture(frame, 1);
+    CountingDisplay display;
+    std::vector<uint16_t> reference(SCREEN_W * SCREEN_H, 0);
+
+    // 60 bars, 4 columns wide, each nudged a little per frame
+    std::vector<int16_t> heights(60, 40);
+    uint32_t incremental = 0, full = 0, mismatches = 0;
+    for (uint32_t f = 0; f < FRAMES; f++) {
+        for (int16_t& h : heights) {
+            h += (int16_t)(nextRandom() % 5) - 2;
+            if (h < 0) h = 0;
+            if (h > frame.height) h = frame.height;
+        }
+        for (int16_t x = 0; x < frame.width; x++) {
+            int16_t h = heights[x / 4];
+            if (h > 0) {
+                setBoth(layer, picture, x, 0, frame.height - h, frame.height - 1, COLOR_BAR);
+            } else {
+                layer.clearSpan(x, 0);
+                picture.spans[x] = {1, 0, 0};
+            }
+        }
+        incremental += display.flush(layer);
+        full += picture.redraw(reference);
+        if (!sameFrame(display, reference, frame)) mismatches++;
+    }
+    CHECK(mismatches == 0);
+    // A bar that moved is resent over its old and new extent, not just
+    // the difference, so this saves less than the traces do
+    CHECK((double)incremental / full < 0.5);
+    printf("  %-8s %7u pixels incremental, %7u full redraw (%.1f%%)\n",
+           "bars", (unsigned)incremental, (unsigned)full, 100.0 * incremental / full);
+}
+
+static void testScatter() {
+    const uint16_t capacity = 200;
+    PlotFrame frame = graphFrame();
+    PointLayer layer;
+    CHECK(layer.begin(frame, capacity));
+    CountingDisplay display;
+    std::vector<uint16_t> reference(SCREEN_W * SCREEN_H, 0);
+
+    // Background first, as the view draws it when the layer starts
+    ColumnPicture background(frame, 1);
+    background.redraw(display.pixels);
+
+    // Points crowd a small area so expiring points often sit under newer ones
+    std::vector<PlotPoint> live;
+    uint32_t incremental = 0, full = 0, mismatches = 0;
+    for (uint32_t f = 0; f < 5 * capacity; f++) {
+        PlotPoint point;
+        point.x = (int16_t)(100 + nextRandom() % 24);
+        point.y = (int16_t)(60 + nextRandom() % 24);
+        point.color = (uint16_t)(nextRandom() & 0xFFFF) | 1;
+        layer.plot(point.x, point.y, point.color);
+        live.push_back(point);
+        if (live.size() > capacity) live.erase(live.begin());
+
+        uint32_t sent = display.flush(layer);
+        CHECK(sent <= 2);
+        incremental += sent;
+
+        // Full redraw: background, then every live point oldest first
+        full += background.redraw(reference) + (uint32_t)live.size();
+        for (const PlotPoint& p : live) {
+            reference[(frame.y + p.y) * SCREEN_W + frame.x + p.x] = p.color;
+        }
+        if (!sameFrame(display, reference, frame)) mismatches++;
+    }
+    CHECK(mismatches == 0);
+    CHECK(layer.size() == capacity);
+    CHECK(incremental * 100 < full);
+    printf("  %-8s %7u pixels incremental, %7u full redraw\n",
+           "scatter", (unsigned)incremental, (unsigned)full);
+}
+
+int main() {
+    runTrace("scroll", true, 0.05);
+    runTrace("sweep", false, 0.02);
+    testBars();
+    testScatter();
+    return testSummary("test_plot_layers");
+}
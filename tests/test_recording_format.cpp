@@ -0,0 +1,115 @@
+// ========================================
+// test_recording_format - FreqScanner recordings written and read back
+// through the shared HostFileStream, closed and unclosed
+// Build on the host (or run tests/run_host_tests.sh):
+//   g++ -O2 -Itests -Iapps/PreqScanner -o test_recording_format
+//       tests/test_recording_format.cpp apps/PreqScanner/RecordingFormat.cpp
+// ========================================
+
+#include "test_support.h"
+#include "RecordingFormat.h"
+#include "../core/Streams/HostFileStream.h"
+#include <vector>
+
+#define HOP     256
+#define BINS    128
+#define FRAMES  200
+
+static int16_t sampleAt(uint32_t n) {
+    return (int16_t)((n * 37u) % 4001u) - 2000;
+}
+
+static float levelAt(uint32_t frame, uint16_t bin) {
+    return -110.0f + (float)((frame + bin) % 200) * 0.5f;
+}
+
+// Writes FRAMES frames; end() only when closed
+static void writeRecording(FILE* f, bool closed) {
+    HostFileStream stream(f);
+    RecordingWriter writer;
+    CHECK(writer.allocate());
+
+    RecordingHeader header = RecordingWriter::defaultHeader();
+    header.sampleRate = 22050;
+    header.fftSize = 2 * BINS;
+    header.spectrumBins = BINS;
+    header.contents = RECORDING_HAS_TIME | RECORDING_HAS_SPECTRUM;
+    CHECK(writer.begin(&stream, header));
+
+    int16_t samples[HOP];
+    float spectrum[BINS];
+    for (uint32_t frame = 0; frame < FRAMES; frame++) {
+        for (uint16_t i = 0; i < HOP; i++) samples[i] = sampleAt(frame * HOP + i);
+        for (uint16_t b = 0; b < BINS; b++) spectrum[b] = levelAt(frame, b);
+        uint32_t timestamp = frame * 12;
+        CHECK(writer.writeTime(samples, HOP, timestamp));
+        CHECK(writer.writeSpectrum(spectrum, BINS, timestamp));
+    }
+    if (closed) CHECK(writer.end());
+    else stream.flush();
+}
+
+static void readBack(FILE* f, bool closed) {
+    HostFileStream stream(f);
+    RecordingReader reader;
+    CHECK(reader.open(&stream));
+    CHECK(reader.hasIndex() == closed);
+    if (closed) CHECK(reader.getHeader().sampleCount == FRAMES * HOP);
+
+    // An unclosed file lacks what was still buffered, but the rest reads in order
+    std::vector<int16_t> samples(FRAMES * HOP);
+    uint32_t got = reader.readSamples(samples.data(), 1000);
+    got += reader.readSamples(samples.data() + got, FRAMES * HOP - got);
+    if (closed) CHECK(got == FRAMES * HOP);
+    else CHECK(got > FRAMES * HOP - RECORDING_BUFFER_SIZE && got < FRAMES * HOP);
+    bool same = true;
+    for (uint32_t n = 0; n < got; n++) {
+        if (samples[n] != sampleAt(n)) same = false;
+    }
+    CHECK(same);
+    CHECK(reader.readSamples(samples.data(), 1) == 0);
+
+    reader.rewind();
+    float spectrum[BINS];
+    uint32_t timestamp, frames = 0;
+    bool levels = true;
+    while (reader.readSpectrum(spectrum, BINS, timestamp)) {
+        if (timestamp != frames * 12) levels = false;
+        for (uint16_t b = 0; b < BINS; b++) {
+            if (spectrum[b] != levelAt(frames, b)) levels = false;
+        }
+        frames++;
+    }
+    if (closed) CHECK(frames == FRAMES);
+    else CHECK(frames > FRAMES - 10 && frames < FRAMES);
+    CHECK(levels);
+
+    if (closed) {
+        CHECK(reader.seekTime(1500));
+        CHECK(reader.getChunkTimestamp() <= 1500);
+        CHECK(reader.readSpectrum(spectrum, BINS, timestamp));
+        CHECK(timestamp <= 1500 + 12 && timestamp + RECORDING_INDEX_INTERVAL >= 1500);
+    }
+}
+
+int main() {
+    const bool modes[] = {true, false};
+    for (bool closed : modes) {
+        FILE* f = tmpfile();
+        CHECK(f != nullptr);
+        if (!f) break;
+        writeRecording(f, closed);
+        readBack(f, closed);
+        fclose(f);
+    }
+
+    // Anything that is not a recording is refused
+    FILE* junk = tmpfile();
+    fwrite("not a recording, just text", 1, 26, junk);
+    HostFileStream stream(junk);
+    RecordingReader reader;
+    CHECK(!reader.open(&stream));
+    fclose(junk);
+
+    return testSummary("test_recording_format");
+}
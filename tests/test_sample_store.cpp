@@ -0,0 +1,169 @@
+// ========================================
+// test_sample_store - Checks EntropySampleStore's fused metrics kernel
+// against separate per-metric passes (the functions it replaced, in
+// double) on random, biased and correlated input, across ring wrap
+// Build on the host (or run tests/run_host_tests.sh):
+//   g++ -O2 -Itests -Iapps/EntropyBeacon -o test_sample_store
+//       tests/test_sample_store.cpp apps/EntropyBeacon/EntropySampleStore.cpp
+// ========================================
+
+#include "test_support.h"
+#include "EntropySampleStore.h"
+#include <math.h>
+#include <string.h>
+
+#define CAPACITY    256
+
+static uint32_t rngState = 1;
+static uint32_t nextRandom() {
+    rngState = rngState * 1664525u + 1013904223u;
+    return rngState >> 8;
+}
+
+// ===== SEPARATE REFERENCE PASSES =====
+
+static double referenceMean(const uint16_t* data, uint16_t length) {
+    double sum = 0;
+    for (uint16_t i = 0; i < length; i++) sum += data[i];
+    return sum / length;
+}
+
+static double referenceVariance(const uint16_t* data, uint16_t length) {
+    double mean = referenceMean(data, length);
+    double sum = 0;
+    for (uint16_t i = 0; i < length; i++) sum += (data[i] - mean) * (data[i] - mean);
+    return sum / length;
+}
+
+static double referenceChiSquare(const uint16_t* data, uint16_t length) {
+    uint16_t freq[SAMPLE_STORE_BINS] = {0};
+    for (uint16_t i = 0; i < length; i++) freq[data[i] >> 4]++;
+
+    double expected = (double)length / SAMPLE_STORE_BINS;
+    double chiSquare = 0;
+    for (uint16_t i = 0; i < SAMPLE_STORE_BINS; i++) {
+        double diff = freq[i] - expected;
+        chiSquare += diff * diff / expected;
+    }
+    return chiSquare;
+}
+
+// Pearson correlation of a[0, length) with b[0, length)
+static double referenceCorrelation(const uint16_t* a, const uint16_t* b, uint16_t length) {
+    double meanA = referenceMean(a, length), meanB = referenceMean(b, length);
+    double ab = 0, aa = 0, bb = 0;
+    for (uint16_t i = 0; i < length; i++) {
+        ab += (a[i] - meanA) * (b[i] - meanB);
+        aa += (a[i] - meanA) * (a[i] - meanA);
+        bb += (b[i] - meanB) * (b[i] - meanB);
+    }
+    double d = sqrt(aa * bb);
+    return d > 0 ? ab / d : 0.0;
+}
+
+static double referenceSerialCorrelation(const uint16_t* data, uint16_t length, uint8_t lag) {
+    if (lag >= length) return 0.0;
+    return referenceCorrelation(data, data + lag, length - lag);
+}
+
+// ===== COMPARISON =====
+
+static void compareWindow(const EntropySampleStore& store, uint16_t count, const uint16_t* other) {
+    uint16_t window[CAPACITY];
+    CHECK(store.copyRecent(window, count) == count);
+    for (uint16_t i = 0; i < count; i++) {
+        if (window[i] != store.value(count - 1 - i)) {
+            CHECK(false);
+            break;
+        }
+    }
+
+    WindowMetrics m;
+    CHECK(store.computeMetrics(count, m, other));
+    CHECK(m.count == count);
+    CHECK_NEAR(m.mean, referenceMean(window, count), 1e-3);
+    CHECK_NEAR(m.variance, referenceVariance(window, count), referenceVariance(window, count) * 1e-5 + 1e-3);
+    CHECK_NEAR(m.chiSquare, referenceChiSquare(window, count), 1e-2);
+
+    double worst = 0;
+    for (uint8_t lag = 1; lag <= SAMPLE_STORE_MAX_LAG; lag++) {
+        double error = fabs(m.serialCorrelation[lag - 1] - referenceSerialCorrelation(window, count, lag));
+        if (error > worst) worst = error;
+    }
+    CHECK(worst < 1e-5);
+
+    uint16_t freq[SAMPLE_STORE_BINS] = {0};
+    for (uint16_t i = 0; i < count; i++) freq[window[i] >> 4]++;
+    CHECK(memcmp(freq, m.histogram, sizeof(freq)) == 0);
+
+    if (other) {
+        CHECK_NEAR(m.crossCorrelation, referenceCorrelation(window, other, count), 1e-5);
+    } else {
+        CHECK(m.crossCorrelation == 0.0f);
+    }
+}
+
+static void fillAndCompare(const char* name, uint16_t (*source)(uint32_t)) {
+    EntropySampleStore store;
+    CHECK(store.allocate(CAPACITY));
+
+    // Part-filled first, then wrapped several times
+    for (uint32_t i = 0; i < 100; i++) store.push(source(i), i, 0, 0.0f, 0.0f);
+    CHECK(!store.isFull() && store.size() == 100);
+    compareWindow(store, 100, nullptr);
+    compareWindow(store, 64, nullptr);
+
+    for (uint32_t i = 100; i < 1000; i++) store.push(source(i), i, 0, 0.0f, 0.0f);
+    CHECK(store.isFull() && store.size() == CAPACITY);
+
+    uint16_t other[CAPACITY];
+    for (uint16_t i = 0; i < CAPACITY; i++) other[i] = (uint16_t)(source(5000 + i) / 2 + (i * 8 & 0x7FF));
+    static const uint16_t counts[] = {CAPACITY, 64, 11, 2};
+    for (uint8_t i = 0; i < 4; i++) {
+        compareWindow(store, counts[i], nullptr);
+        compareWindow(store, counts[i], other);
+    }
+    printf("  %-10s fused kernel checked against separate passes\n", name);
+}
+
+static uint16_t randomSource(uint32_t) {
+    return (uint16_t)(nextRandom() & 0x0FFF);
+}
+
+static uint16_t biasedSource(uint32_t) {
+    // Mostly high, occasionally anywhere: a skewed histogram
+    return (nextRandom() % 8) ? (uint16_t)(3800 + nextRandom() % 296) : (uint16_t)(nextRandom() & 0x0FFF);
+}
+
+static uint16_t correlatedSource(uint32_t i) {
+    // Random walk plus a slow sine: strong serial correlation
+    static int32_t walk = 2048;
+    walk += (int32_t)(nextRandom() % 65) - 32;
+    if (walk < 200) walk = 200;
+    if (walk > 3400) walk = 3400;
+    return (uint16_t)(walk + 500 * sin(i * 0.05));
+}
+
+int main() {
+    rngState = 3;
+    fillAndCompare("random", randomSource);
+    fillAndCompare("biased", biasedSource);
+    fillAndCompare("correlated", correlatedSource);
+
+    // Degenerate windows and capacities are refused
+    EntropySampleStore store;
+    CHECK(!store.allocate(100));
+    CHECK(!store.allocate(2 * SAMPLE_STORE_MAX_CAPACITY));
+    CHECK(store.allocate(16));
+    WindowMetrics m;
+    store.push(1000, 0, 0, 0.0f, 0.0f);
+    CHECK(!store.computeMetrics(16, m));
+
+    // Constant input: no variance and no correlation, not NaN
+    for (uint16_t i = 0; i < 16; i++) store.push(1234, i, 0, 0.0f, 0.0f);
+    CHECK(store.computeMetrics(16, m));
+    CHECK(m.variance == 0.0f && m.serialCorrelation[0] == 0.0f);
+    CHECK_NEAR(m.chiSquare, 16.0 * 255, 1e-3);
+
+    return testSummary("test_sample_store");
+}
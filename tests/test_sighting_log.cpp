@@ -0,0 +1,532 @@
+// ========================================
+// test_sighting_log - Writes sighting logs into in-memory ByteStreams and
+// reads them back: records and dictionary texts round-trip, a time gap
+// past 16 bits or a clock that runs backwards closes the block early,
+// damaged blocks are skipped, a resumed dictionary keeps its ids, each
+// batch flushes the dictionary before the blocks that name its texts,
+// and the JSON and CSV exports parse back to the same records
+// Build on the host (or run tests/run_host_tests.sh):
+//   g++ -O2 -Itests -Iapps/BLEScanner -o test_sighting_log
+//       tests/test_sighting_log.cpp apps/BLEScanner/SightingLog.cpp
+//       apps/BLEScanner/BLEDeviceTable.cpp
+// ========================================
+
+#include "test_support.h"
+#include "SightingLog.h"
+#include "BLEDeviceTable.h"
+#include <stdlib.h>
+#include <string.h>
+#include <map>
+#include <string>
+#include <vector>
+
+#define ROUND_TRIP_RECORDS  2000
+
+static uint32_t rngState = 50;
+static uint32_t nextRandom() {
+    rngState = rngState * 1664525u + 1013904223u;
+    return rngState >> 8;
+}
+
+// Entries in a dictionary file so far
+static uint16_t dictionaryEntries(const std::vector<uint8_t>& bytes) {
+    uint16_t entries = 0;
+    size_t position = sizeof(SightingDictHeader);
+    while (position + 5 <= bytes.size()) {
+        position += 5 + bytes[position + 3] + bytes[position + 4];
+        if (position <= bytes.size()) entries++;
+    }
+    return entries;
+}
+
+// An SD file opened for append: writes go to the end, reads and seeks
+// move a read position. A log stream given its dictionary checks each
+// write only names texts already written, and that each flush follows
+// one of the dictionary.
+class MemoryStream : public ByteStream {
+public:
+    std::vector<uint8_t> bytes;
+    uint32_t position;
+    uint32_t flushes;
+    MemoryStream* names;
+    bool outOfOrder;
+
+    MemoryStream() : position(0), flushes(0), names(nullptr), outOfOrder(false) {}
+
+    size_t write(const uint8_t* data, size_t length) override {
+        if (names) {
+            uint16_t known = dictionaryEntries(names->bytes);
+            for (size_t b = 0; b + SIGHTING_LOG_BLOCK_SIZE <= length; b += SIGHTING_LOG_BLOCK_SIZE) {
+                for (uint8_t r = 0; r < SIGHTING_LOG_BLOCK_RECORDS; r++) {
+                    SightingLogRecord record;
+                    memcpy(&record, data + b + sizeof(SightingLogBlock) + r * sizeof(record), sizeof(record));
+                    if (record.textId > known) outOfOrder = true;
+                }
+            }
+        }
+        bytes.insert(bytes.end(), data, data + length);
+        return length;
+    }
+    size_t read(uint8_t* data, size_t length) override {
+        size_t n = position < bytes.size() ? bytes.size() - position : 0;
+        if (n > length) n = length;
+        memcpy(data, bytes.data() + position, n);
+        position += n;
+        return n;
+    }
+    bool seek(uint32_t to) override {
+        if (to > bytes.size()) return false;
+        position = to;
+        return true;
+    }
+    uint32_t size() override { return (uint32_t)bytes.size(); }
+    bool flush() override {
+        if (names && names->flushes != flushes + 1) outOfOrder = true;
+        flushes++;
+        return true;
+    }
+};
+
+// ===== TEXTS =====
+
+struct Text {
+    uint8_t kind;
+    std::string name;
+    std::string label;
+};
+
+// Quotes, separators, escapes and a name past SIGHTING_TEXT_MAX
+static std::vector<Text> textPool() {
+    std::vector<Text> texts;
+    const char* names[] = {"Tile", "Band \"7\"", "a,b", "back\\slash", "tab\there",
+                           "Kitchen speaker with a name far longer than the log keeps", ""};
+    const char* labels[] = {"", "home", "desk, left", "\"mine\""};
+    for (const char* name : names) {
+        for (const char* label : labels) {
+            if (name[0] || label[0]) texts.push_back({SIGHTING_TEXT_DEVICE, name, label});
+        }
+    }
+    texts.push_back({SIGHTING_TEXT_NOTE, "Possible signal spoofing (too stable)", ""});
+    texts.push_back({SIGHTING_TEXT_NOTE, "Rapid appearing/disappearing pattern", ""});
+    return texts;
+}
+
+static std::string cut(const std::string& text) {
+    return text.substr(0, SIGHTING_TEXT_MAX);
+}
+
+static SightingLogEntry randomEntry(uint32_t timestamp) {
+    SightingLogEntry entry;
+    entry.timestamp = timestamp;
+    entry.mac = (((uint64_t)nextRandom() << 24) ^ nextRandom()) & 0xFFFFFFFFFFFFull;
+    entry.rssi = (int8_t)(-30 - (int)(nextRandom() % 70));
+    entry.event = (uint8_t)(nextRandom() % SIGHTING_EVENT_COUNT);
+    entry.flags = (uint8_t)nextRandom();
+    entry.level = (uint8_t)nextRandom();
+    entry.anomalies = (uint16_t)nextRandom();
+    entry.textId = 0;
+    return entry;
+}
+
+static bool sameEntry(const SightingLogEntry& a, const SightingLogEntry& b) {
+    return a.timestamp == b.timestamp && a.mac == b.mac && a.rssi == b.rssi && a.event == b.event &&
+           a.flags == b.flags && a.level == b.level && a.anomalies == b.anomalies && a.textId == b.textId;
+}
+
+struct Written {
+    std::vector<SightingLogEntry> entries;
+    std::map<uint16_t, Text> texts;   // By id, as the writer numbered them
+};
+
+// Writes count records a few ms to a few s apart with texts from the pool
+static Written writeLog(SightingLogWriter& writer, uint32_t count, uint32_t startTime) {
+    Written written;
+    std::vector<Text> pool = textPool();
+    uint32_t time = startTime;
+    for (uint32_t i = 0; i < count; i++) {
+        time += (nextRandom() % 8 == 0) ? 1000 + nextRandom() % 5000 : nextRandom() % 200;
+        SightingLogEntry entry = randomEntry(time);
+        if (nextRandom() % 3) {
+            const Text& t = pool[nextRandom() % pool.size()];
+            entry.textId = writer.textId(t.kind, t.name.c_str(),
+                                         t.label.empty() ? nullptr : t.label.c_str());
+            if (entry.textId) written.texts[entry.textId] = {t.kind, cut(t.name), cut(t.label)};
+        }
+        writer.append(entry);
+        written.entries.push_back(entry);
+    }
+    return written;
+}
+
+static std::vector<SightingLogEntry> readAll(SightingLogReader& reader) {
+    std::vector<SightingLogEntry> entries;
+    SightingLogEntry entry;
+    while (reader.next(entry)) entries.push_back(entry);
+    return entries;
+}
+
+static bool sameEntries(const std::vector<SightingLogEntry>& a, const std::vector<SightingLogEntry>& b) {
+    if (a.size() != b.size()) return false;
+    for (size_t i = 0; i < a.size(); i++) {
+        if (!sameEntry(a[i], b[i])) return false;
+    }
+    return true;
+}
+
+static bool textsMatch(SightingLogReader& reader, const std::map<uint16_t, Text>& texts) {
+    for (const auto& entry : texts) {
+        const SightingText* text = reader.text(entry.first);
+        if (!text || text->kind != entry.second.kind || entry.second.name != text->name ||
+            entry.second.label != text->label) return false;
+    }
+    return true;
+}
+
+// ===== TESTS =====
+
+static void testRoundTrip() {
+    MemoryStream log, dict;
+    log.names = &dict;
+    SightingLogWriter writer;
+    CHECK(writer.allocate());
+    CHECK(writer.begin(&log, &dict));
+    Written written = writeLog(writer, ROUND_TRIP_RECORDS, 1000);
+    CHECK(writer.end());
+
+    const SightingLogStats& stats = writer.getStats();
+    CHECK(stats.records == ROUND_TRIP_RECORDS);
+    CHECK(log.bytes.size() == stats.blocks * SIGHTING_LOG_BLOCK_SIZE);
+    CHECK(stats.dataBytes == log.bytes.size() && stats.dictionaryBytes == dict.bytes.size());
+    CHECK(stats.texts == written.texts.size());
+    // One flush of each stream per batch, the dictionary's first
+    CHECK(log.flushes == stats.flushes && dict.flushes == stats.flushes);
+    CHECK(stats.flushes >= stats.blocks / SIGHTING_LOG_BATCH_BLOCKS);
+    CHECK(!log.outOfOrder);
+
+    SightingLogReader reader;
+    CHECK(reader.open(&log, &dict));
+    CHECK(reader.getBlockCount() == stats.blocks);
+    CHECK(reader.getTextCount() == stats.texts);
+    CHECK(sameEntries(readAll(reader), written.entries));
+    CHECK(reader.getSkippedBlocks() == 0);
+    CHECK(textsMatch(reader, written.texts));
+    CHECK(reader.text(0) == nullptr && reader.text(stats.texts + 1) == nullptr);
+
+    // Seeking to a block starts at its first record
+    CHECK(reader.seekBlock(3));
+    SightingLogEntry entry;
+    CHECK(reader.next(entry) && sameEntry(entry, written.entries[3 * SIGHTING_LOG_BLOCK_RECORDS]));
+
+    // Without a dictionary the records still read, with no texts
+    SightingLogReader bare;
+    CHECK(bare.open(&log, nullptr));
+    CHECK(sameEntries(readAll(bare), written.entries));
+    CHECK(bare.text(1) == nullptr);
+
+    printf("  %u records in %u blocks (%u closed early), %u texts, %u flushes; %.1f bytes per record\n",
+           (unsigned)stats.records, (unsigned)stats.blocks, (unsigned)stats.blocksClosedEarly,
+           (unsigned)stats.texts, (unsigned)stats.flushes,
+           (double)(log.bytes.size() + dict.bytes.size()) / stats.records);
+}
+
+static void testEarlyClose() {
+    MemoryStream log, dict;
+    SightingLogWriter writer;
+    writer.allocate();
+    writer.begin(&log, &dict);
+
+    // The largest delta fits; one more ms does not; then the clock goes back
+    std::vector<SightingLogEntry> entries;
+    const uint32_t times[] = {5000, 5000 + 0xFFFF, 5000 + 0xFFFF + 0x10000, 100, 150};
+    for (uint32_t t : times) {
+        entries.push_back(randomEntry(t));
+        CHECK(writer.append(entries.back()));
+    }
+    CHECK(writer.getStats().blocksClosedEarly == 2);
+    CHECK(writer.end());
+    CHECK(writer.getStats().blocks == 3);
+
+    SightingLogReader reader;
+    reader.open(&log, &dict);
+    CHECK(reader.getBlockCount() == 3);
+    CHECK(sameEntries(readAll(reader), entries));
+
+    // Block by block: two records, one, then the two after the clock reset
+    SightingLogBlock header;
+    const uint8_t counts[] = {2, 1, 2};
+    const uint32_t bases[] = {5000, 5000 + 0xFFFF + 0x10000, 100};
+    for (uint8_t b = 0; b < 3; b++) {
+        memcpy(&header, &log.bytes[b * SIGHTING_LOG_BLOCK_SIZE], sizeof(header));
+        CHECK(header.count == counts[b] && header.baseTime == bases[b] && header.sequence == b);
+    }
+}
+
+static void testCorruptBlocks() {
+    MemoryStream log, dict;
+    SightingLogWriter writer;
+    writer.allocate();
+    writer.begin(&log, &dict);
+    Written written = writeLog(writer, 10 * SIGHTING_LOG_BLOCK_RECORDS, 0);
+    writer.end();
+    CHECK(log.bytes.size() == 10 * SIGHTING_LOG_BLOCK_SIZE);
+
+    // Block 3 loses its magic, block 6 claims too many records, and a
+    // torn write leaves half a block at the end
+    log.bytes[3 * SIGHTING_LOG_BLOCK_SIZE] ^= 0xFF;
+    log.bytes[6 * SIGHTING_LOG_BLOCK_SIZE + offsetof(SightingLogBlock, count)] = SIGHTING_LOG_BLOCK_RECORDS + 1;
+    log.bytes.resize(log.bytes.size() + SIGHTING_LOG_BLOCK_SIZE / 2, 0xA5);
+
+    std::vector<SightingLogEntry> expected;
+    for (uint32_t i = 0; i < written.entries.size(); i++) {
+        uint32_t block = i / SIGHTING_LOG_BLOCK_RECORDS;
+        if (block != 3 && block != 6) expected.push_back(written.entries[i]);
+    }
+    SightingLogReader reader;
+    CHECK(reader.open(&log, &dict));
+    CHECK(reader.getBlockCount() == 10);
+    CHECK(sameEntries(readAll(reader), expected));
+    CHECK(reader.getSkippedBlocks() == 2);
+    CHECK(textsMatch(reader, written.texts));
+}
+
+static void testDictionaryResume() {
+    MemoryStream log, dict;
+    SightingLogWriter first;
+    first.allocate();
+    first.begin(&log, &dict);
+    Written before = writeLog(first, 300, 0);
+    first.end();
+    uint16_t textsBefore = first.getStats().texts;
+
+    // A new session loads the dictionary and appends to both files
+    SightingLogWriter second;
+    second.allocate();
+    CHECK(second.loadDictionary(&dict));
+    CHECK(second.getStats().texts == textsBefore);
+    CHECK(second.begin(&log, &dict));
+    for (const auto& entry : before.texts) {
+        const Text& t = entry.second;
+        CHECK(second.textId(t.kind, t.name.c_str(), t.label.c_str()) == entry.first);
+    }
+    uint16_t fresh = second.textId(SIGHTING_TEXT_DEVICE, "New since resume", "lab");
+    CHECK(fresh == textsBefore + 1);
+    Written after = writeLog(second, 300, before.entries.back().timestamp + 10);
+    after.texts[fresh] = {SIGHTING_TEXT_DEVICE, "New since resume", "lab"};
+    second.end();
+
+    std::vector<SightingLogEntry> all = before.entries;
+    all.insert(all.end(), after.entries.begin(), after.entries.end());
+    SightingLogReader reader;
+    CHECK(reader.open(&log, &dict));
+    CHECK(sameEntries(readAll(reader), all));
+    CHECK(textsMatch(reader, before.texts));
+    CHECK(textsMatch(reader, after.texts));
+    CHECK(reader.getTextCount() == textsBefore + 1);
+
+    // A dictionary cut inside its last entry is refused as a whole
+    MemoryStream cutDict;
+    cutDict.bytes.assign(dict.bytes.begin(), dict.bytes.end() - 3);
+    SightingLogWriter third;
+    third.allocate();
+    CHECK(!third.loadDictionary(&cutDict));
+    CHECK(third.getStats().texts == 0);
+}
+
+// ===== EXPORT =====
+
+// The exporter's JSON: an array of flat objects of strings, numbers and
+// booleans. Values come back as text, strings unescaped.
+static bool parseJson(const std::string& text, std::vector<std::map<std::string, std::string>>& objects) {
+    size_t i = 0;
+    auto skip = [&]() { while (i < text.size() && isspace((unsigned char)text[i])) i++; };
+    auto parseString = [&](std::string& out) {
+        if (text[i++] != '"') return false;
+        out.clear();
+        while (i < text.size() && text[i] != '"') {
+            char c = text[i++];
+            if (c == '\\') {
+                char e = text[i++];
+                if (e == 'u') {
+                    out += (char)strtol(text.substr(i, 4).c_str(), nullptr, 16);
+                    i += 4;
+                } else {
+                    out += e;
+                }
+            } else {
+                out += c;
+            }
+        }
+        return i++ < text.size();
+    };
+
+    skip();
+    if (text[i++] != '[') return false;
+    skip();
+    while (i < text.size() && text[i] == '{') {
+        i++;
+        std::map<std::string, std::string> object;
+        while (true) {
+            skip();
+            std::string key, value;
+            if (!parseString(key)) return false;
+            skip();
+            if (text[i++] != ':') return false;
+            skip();
+            if (text[i] == '"') {
+                if (!parseString(value)) return false;
+            } else {
+                while (i < text.size() && text[i] != ',' && text[i] != '}') value += text[i++];
+            }
+            object[key] = value;
+            skip();
+            if (text[i] == ',') { i++; continue; }
+            if (text[i++] != '}') return false;
+            break;
+        }
+        objects.push_back(object);
+        skip();
+        if (text[i] == ',') { i++; skip(); }
+    }
+    if (text[i++] != ']') return false;
+    skip();
+    return i == text.size();
+}
+
+// RFC 4180 rows: quoted fields with doubled quotes
+static std::vector<std::vector<std::string>> parseCsv(const std::string& text) {
+    std::vector<std::vector<std::string>> rows;
+    std::vector<std::string> row;
+    std::string field;
+    bool quoted = false;
+    for (size_t i = 0; i < text.size(); i++) {
+        char c = text[i];
+        if (quoted) {
+            if (c == '"' && i + 1 < text.size() && text[i + 1] == '"') { field += '"'; i++; }
+            else if (c == '"') quoted = false;
+            else field += c;
+        } else if (c == '"') {
+            quoted = true;
+        } else if (c == ',') {
+            row.push_back(field);
+            field.clear();
+        } else if (c == '\n') {
+            row.push_back(field);
+            field.clear();
+            rows.push_back(row);
+            row.clear();
+        } else {
+            field += c;
+        }
+    }
+    return rows;
+}
+
+static std::string exportLog(MemoryStream& log, MemoryStream& dict, uint8_t format, uint32_t& records) {
+    SightingLogReader reader;
+    reader.open(&log, &dict);
+    MemoryStream out;
+    SightingLogExporter exporter;
+    CHECK(exporter.begin(&reader, &out, format));
+    while (exporter.next()) {}
+    CHECK(exporter.end());
+    CHECK(exporter.getBytes() == out.bytes.size());
+    records = exporter.getRecords();
+    return std::string(out.bytes.begin(), out.bytes.end());
+}
+
+// The fields every export row carries, as the exporter should print them
+struct Expected {
+    std::string timestamp, mac, event, rssi, flags, anomalies, level;
+    bool randomized, anomaly;
+    std::string name, label, note;
+};
+
+static Expected expectedFields(const SightingLogEntry& entry, const std::map<uint16_t, Text>& texts) {
+    Expected e;
+    char mac[BLE_MAC_STRING_LENGTH], level[16];
+    BLEDeviceTable::formatMac(entry.mac, mac);
+    snprintf(level, sizeof(level), "%.3f", SightingLogReader::fromLevel(entry.level));
+    e.timestamp = std::to_string(entry.timestamp);
+    e.mac = mac;
+    e.event = SightingLogReader::eventName(entry.event);
+    e.rssi = std::to_string(entry.rssi);
+    e.flags = std::to_string(entry.flags & SIGHTING_FLAG_STATUS_MASK);
+    e.anomalies = std::to_string(entry.anomalies);
+    e.level = level;
+    e.randomized = (entry.flags & SIGHTING_FLAG_RANDOMIZED) != 0;
+    e.anomaly = entry.event == SIGHTING_EVENT_ANOMALY;
+    auto text = texts.find(entry.textId);
+    if (text != texts.end()) {
+        if (text->second.kind == SIGHTING_TEXT_DEVICE) {
+            e.name = text->second.name;
+            e.label = text->second.label;
+        } else {
+            e.note = text->second.name;
+        }
+    }
+    return e;
+}
+
+static void testExport() {
+    MemoryStream log, dict;
+    SightingLogWriter writer;
+    writer.allocate();
+    writer.begin(&log, &dict);
+    Written written = writeLog(writer, 500, 0);
+    writer.end();
+
+    uint32_t records = 0;
+    std::string json = exportLog(log, dict, SIGHTING_EXPORT_JSON, records);
+    CHECK(records == written.entries.size());
+    std::vector<std::map<std::string, std::string>> objects;
+    CHECK(parseJson(json, objects));
+    CHECK(objects.size() == written.entries.size());
+    uint32_t jsonMismatches = 0;
+    for (size_t i = 0; i < objects.size() && i < written.entries.size(); i++) {
+        std::map<std::string, std::string>& o = objects[i];
+        Expected e = expectedFields(written.entries[i], written.texts);
+        bool ok = o["timestamp"] == e.timestamp && o["mac"] == e.mac && o["event"] == e.event &&
+                  o["rssi"] == e.rssi && o["flags"] == e.flags && o["anomalies"] == e.anomalies &&
+                  o["randomized"] == (e.randomized ? "true" : "false") &&
+                  o[e.anomaly ? "severity" : "entropy"] == e.level &&
+                  o.count(e.anomaly ? "entropy" : "severity") == 0 &&
+                  o["name"] == e.name && o["label"] == e.label && o["note"] == e.note;
+        if (!ok) jsonMismatches++;
+    }
+    CHECK(jsonMismatches == 0);
+
+    std::string csv = exportLog(log, dict, SIGHTING_EXPORT_CSV, records);
+    std::vector<std::vector<std::string>> rows = parseCsv(csv);
+    CHECK(rows.size() == written.entries.size() + 1);
+    CHECK(!rows.empty() && rows[0].size() == 12 && rows[0][0] == "timestamp" && rows[0][11] == "note");
+    uint32_t csvMismatches = 0;
+    for (size_t i = 1; i < rows.size() && i <= written.entries.size(); i++) {
+        const std::vector<std::string>& r = rows[i];
+        Expected e = expectedFields(written.entries[i - 1], written.texts);
+        bool ok = r.size() == 12 && r[0] == e.timestamp && r[1] == e.mac && r[2] == e.event &&
+                  r[3] == e.rssi && r[4] == e.flags && r[5] == (e.randomized ? "1" : "0") &&
+                  r[6] == e.anomalies && r[7] == (e.anomaly ? "" : e.level) &&
+                  r[8] == (e.anomaly ? e.level : "") && r[9] == e.name && r[10] == e.label &&
+                  r[11] == e.note;
+        if (!ok) csvMismatches++;
+    }
+    CHECK(csvMismatches == 0);
+    printf("  export of %u records: %u bytes JSON, %u bytes CSV\n", (unsigned)records,
+           (unsigned)json.size(), (unsigned)csv.size());
+
+    // An empty log is an empty array and a header line
+    MemoryStream emptyLog;
+    std::string emptyJson = exportLog(emptyLog, dict, SIGHTING_EXPORT_JSON, records);
+    objects.clear();
+    CHECK(parseJson(emptyJson, objects) && objects.empty() && records == 0);
+    CHECK(parseCsv(exportLog(emptyLog, dict, SIGHTING_EXPORT_CSV, records)).size() == 1);
+}
+
+int main() {
+    testRoundTrip();
+    testEarlyClose();
+    testCorruptBlocks();
+    testDictionaryResume();
+    testExport();
+    return testSummary("test_sighting_log");
+}
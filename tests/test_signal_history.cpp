@@ -0,0 +1,181 @@
+// ========================================
+// test_signal_history - Checks RSSIHistory's monotonic-queue min/max and
+// integer-sum mean and variance, and AppearanceHistory's sums and gap
+// histogram, against a brute-force pass over the same window after every
+// reading, including a long run where float running sums would drift
+// Build on the host (or run tests/run_host_tests.sh):
+//   g++ -O2 -Itests -Iapps/BLEScanner -o test_signal_history
+//       tests/test_signal_history.cpp apps/BLEScanner/SignalHistory.cpp
+// ========================================
+
+#include "test_support.h"
+#include "SignalHistory.h"
+#include <math.h>
+#include <deque>
+
+static uint32_t rngState = 5;
+static uint32_t nextRandom() {
+    rngState = rngState * 1664525u + 1013904223u;
+    return rngState >> 8;
+}
+
+// ===== RSSI =====
+
+// Readings with runs that stress the queues: rising and falling ramps
+// (every reading evicts or keeps every other), repeats and noise
+static int8_t nextRssi(uint32_t i) {
+    static int8_t ramp = -60;
+    switch ((i / 37) % 4) {
+        case 0:  return (int8_t)(-100 + (int)(nextRandom() % 71));
+        case 1:  ramp = ramp < -30 ? ramp + 1 : -100; return ramp;
+        case 2:  ramp = ramp > -100 ? ramp - 1 : -30; return ramp;
+        default: return (nextRandom() % 4) ? -72 : (int8_t)(-100 + (int)(nextRandom() % 71));
+    }
+}
+
+static uint32_t compareRssi(const RSSIHistory& history, const std::deque<int8_t>& window) {
+    uint32_t errors = 0;
+    if (history.size() != window.size()) errors++;
+
+    double sum = 0;
+    int8_t lo = window.front(), hi = window.front();
+    for (size_t i = 0; i < window.size(); i++) {
+        sum += window[i];
+        if (window[i] < lo) lo = window[i];
+        if (window[i] > hi) hi = window[i];
+        if (history.get((uint8_t)i) != window[i]) errors++;
+    }
+    double mean = sum / window.size();
+    double variance = 0;
+    for (int8_t v : window) variance += (v - mean) * (v - mean);
+    variance /= window.size();
+
+    if (history.min != lo || history.max != hi) errors++;
+    if (fabs(history.mean - mean) > 1e-4) errors++;
+    if (fabs(history.variance - variance) > variance * 1e-6 + 1e-6) errors++;
+    return errors;
+}
+
+static void testRssi() {
+    RSSIHistory history;
+    std::deque<int8_t> window;
+    uint32_t errors = 0;
+
+    for (uint32_t i = 0; i < 20000; i++) {
+        int8_t rssi = nextRssi(i);
+        history.addValue(rssi, i);
+        window.push_back(rssi);
+        if (window.size() > RSSI_HISTORY_SIZE) window.pop_front();
+        errors += compareRssi(history, window);
+    }
+    CHECK(errors == 0);
+    CHECK(history.lastUpdated == 19999);
+
+    // A constant window has exactly zero variance, not rounding noise
+    for (uint8_t i = 0; i < RSSI_HISTORY_SIZE; i++) history.addValue(-55, 0);
+    CHECK(history.variance == 0.0f && history.standardDeviation == 0.0f);
+    CHECK(history.min == -55 && history.max == -55);
+    CHECK(!history.isOutlier(-55));
+
+    // Outliers are judged against the window's mean and spread
+    history.reset();
+    CHECK(history.size() == 0);
+    for (uint8_t i = 0; i < RSSI_HISTORY_SIZE; i++) history.addValue(i % 2 ? -60 : -62, 0);
+    CHECK(history.isOutlier(-80) && !history.isOutlier(-61));
+}
+
+static void testRssiLongRun() {
+    // A million readings: the integer sums carry no history, so the last
+    // window matches a fresh brute-force pass exactly
+    RSSIHistory history;
+    std::deque<int8_t> window;
+    for (uint32_t i = 0; i < 1000000; i++) {
+        int8_t rssi = (int8_t)(-127 + (int)(nextRandom() % 128));
+        history.addValue(rssi, i);
+        window.push_back(rssi);
+        if (window.size() > RSSI_HISTORY_SIZE) window.pop_front();
+    }
+    CHECK(compareRssi(history, window) == 0);
+
+    int64_t sum = 0, sumSquares = 0;
+    for (int8_t v : window) {
+        sum += v;
+        sumSquares += (int64_t)v * v;
+    }
+    CHECK(history.sum == sum && history.sumSquares == sumSquares);
+}
+
+// ===== APPEARANCE =====
+
+static uint32_t compareAppearance(const AppearanceHistory& history, const std::deque<uint32_t>& gaps) {
+    uint32_t errors = 0;
+    if (history.size() != gaps.size()) errors++;
+    if (gaps.empty()) return errors;
+
+    double sum = 0;
+    for (uint32_t g : gaps) sum += g;
+    double mean = sum / gaps.size();
+    double variance = 0;
+    for (uint32_t g : gaps) variance += (g - mean) * (g - mean);
+    double deviation = sqrt(variance / gaps.size());
+
+    if (fabs(history.getMean() - mean) > mean * 1e-6) errors++;
+    if (fabs(history.getStandardDeviation() - deviation) > deviation * 1e-5 + 1e-3) errors++;
+
+    // countBelow rounds down to the bucket boundaries
+    static const uint32_t probes[] = {0, 100, 250, 499, 500, 1000, 3000, 8000, 16000, 32000, 100000};
+    for (uint32_t ms : probes) {
+        uint32_t boundary = 0;
+        for (uint32_t b = APPEARANCE_BUCKET_BASE_MS, k = 0; k < APPEARANCE_BUCKETS - 1 && b <= ms; b <<= 1, k++) {
+            boundary = b;
+        }
+        uint8_t expected = 0;
+        for (uint32_t g : gaps) {
+            if (g < boundary) expected++;
+        }
+        if (history.countBelow(ms) != expected) errors++;
+    }
+    return errors;
+}
+
+static void testAppearance() {
+    AppearanceHistory history;
+    std::deque<uint32_t> gaps;
+    unsigned long now = 1000;
+    uint32_t errors = 0;
+
+    // The first sighting only starts the clock
+    history.addAppearance(now);
+    CHECK(history.size() == 0 && history.getMean() == 0.0f);
+
+    for (uint32_t i = 0; i < 20000; i++) {
+        uint32_t gap;
+        switch (nextRandom() % 5) {
+            case 0:  gap = 100 + nextRandom() % 50; break;          // Fast beacon
+            case 1:  gap = 1000; break;                             // Regular
+            case 2:  gap = nextRandom() % 40000; break;             // Anything
+            case 3:  gap = APPEARANCE_MAX_INTERVAL_MS + nextRandom() % 100000; break;  // Clamped
+            default: gap = 250 << (nextRandom() % 8); break;        // On a boundary
+        }
+        now += gap;
+        history.addAppearance(now);
+        gaps.push_back(gap < APPEARANCE_MAX_INTERVAL_MS ? gap : APPEARANCE_MAX_INTERVAL_MS);
+        if (gaps.size() > APPEARANCE_INTERVALS) gaps.pop_front();
+        errors += compareAppearance(history, gaps);
+    }
+    CHECK(errors == 0);
+
+    // Buckets always account for every gap in the window
+    uint32_t total = 0;
+    for (uint8_t b = 0; b < APPEARANCE_BUCKETS; b++) total += history.buckets[b];
+    CHECK(total == history.size());
+    CHECK(AppearanceHistory::bucketFor(249) == 0 && AppearanceHistory::bucketFor(250) == 1);
+    CHECK(AppearanceHistory::bucketFor(APPEARANCE_MAX_INTERVAL_MS) == APPEARANCE_BUCKETS - 1);
+}
+
+int main() {
+    testRssi();
+    testRssiLongRun();
+    testAppearance();
+    return testSummary("test_signal_history");
+}
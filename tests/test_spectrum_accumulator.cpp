@@ -0,0 +1,170 @@
+// ========================================
+// test_spectrum_accumulator - Noise-floor bias of power-domain averaging
+// against the old dB EMA, block averaging, and max/min/peak-decay holds
+// Build on the host (or run tests/run_host_tests.sh):
+//   g++ -O2 -Itests -Iapps/PreqScanner -o test_spectrum_accumulator
+//       tests/test_spectrum_accumulator.cpp apps/PreqScanner/SpectrumAccumulator.cpp
+// ========================================
+
+#include "test_support.h"
+#include "SpectrumAccumulator.h"
+#include <math.h>
+
+#define BINS        256
+#define NOISE_POWER 1e-6f            // -60 dB per bin
+
+static uint32_t rngState = 12345;
+static float uniform() {
+    rngState = rngState * 1664525u + 1013904223u;
+    return ((rngState >> 8) + 0.5f) / 16777216.0f;
+}
+
+// |X|^2 of complex Gaussian noise is exponential with the noise power as mean
+static void noiseFrame(float* power) {
+    for (uint16_t i = 0; i < BINS; i++) power[i] = -logf(uniform()) * NOISE_POWER;
+}
+
+static float meanDb(const float* db) {
+    double sum = 0;
+    for (uint16_t i = 0; i < BINS; i++) sum += db[i];
+    return (float)(sum / BINS);
+}
+
+static void testNoiseFloor() {
+    const float truth = 10.0f * log10f(NOISE_POWER);
+    float power[BINS], db[BINS];
+    float oldEma[BINS];
+
+    SpectrumAccumulator ema;
+    CHECK(ema.allocate(BINS));
+    ema.setEmaAlpha(0.1f);
+
+    // The old path smoothed dB values: an average of logs, biased low
+    noiseFrame(power);
+    for (uint16_t i = 0; i < BINS; i++) oldEma[i] = 10.0f * log10f(power[i]);
+    ema.accumulate(power);
+
+    double emaSum = 0, oldSum = 0;
+    int measured = 0;
+    for (int frame = 1; frame < 2000; frame++) {
+        noiseFrame(power);
+        ema.accumulate(power);
+        for (uint16_t i = 0; i < BINS; i++) {
+            oldEma[i] += 0.1f * (10.0f * log10f(power[i]) - oldEma[i]);
+        }
+        if (frame >= 100) {
+            ema.toDb(db);
+            emaSum += meanDb(db);
+            oldSum += meanDb(oldEma);
+            measured++;
+        }
+    }
+    float emaFloor = (float)(emaSum / measured);
+    float oldFloor = (float)(oldSum / measured);
+
+    // Power EMA is unbiased in power; its dB reading of a still-noisy estimate
+    // sits a few tenths low. The dB EMA sits the full 2.5 dB low.
+    CHECK_NEAR(emaFloor, truth, 0.6);
+    CHECK_NEAR(oldFloor - truth, -2.51, 0.25);
+    CHECK(emaFloor > oldFloor + 1.5f);
+
+    // A 64-frame block average lands on the true floor
+    SpectrumAccumulator average;
+    CHECK(average.allocate(BINS));
+    average.setMode(SPECTRUM_AVERAGE);
+    average.setAverageFrames(64);
+    int outputs = 0;
+    for (int frame = 0; frame < 64; frame++) {
+        noiseFrame(power);
+        if (average.accumulate(power)) outputs++;
+    }
+    CHECK(outputs == 1);
+    CHECK(average.getFrameCount() == 0);
+    average.toDb(db);
+    CHECK_NEAR(meanDb(db), truth, 0.15);
+
+    printf("  noise floor: truth %.2f dB, power avg %.2f dB, power EMA %.2f dB, dB EMA %.2f dB\n",
+           truth, meanDb(db), emaFloor, oldFloor);
+}
+
+static void testBlockAverage() {
+    SpectrumAccumulator average;
+    CHECK(average.allocate(4));
+    average.setMode(SPECTRUM_AVERAGE);
+    average.setAverageFrames(4);
+
+    // Until the first block completes the output is the floor
+    float db[4];
+    average.toDb(db);
+    CHECK(db[0] == SPECTRUM_FLOOR_DB);
+
+    float frames[4][4] = {{1, 2, 0, 4}, {3, 2, 0, 4}, {1, 2, 0, 4}, {3, 2, 0, 4}};
+    CHECK(!average.accumulate(frames[0]));
+    CHECK(!average.accumulate(frames[1]));
+    CHECK(!average.accumulate(frames[2]));
+    CHECK(average.accumulate(frames[3]));
+    const float* p = average.getPower();
+    CHECK(p[0] == 2.0f && p[1] == 2.0f && p[3] == 4.0f);
+
+    // The offset rides along once per output, on floored power as well
+    average.setDbOffset(3.0f);
+    average.toDb(db);
+    CHECK_NEAR(db[2], SPECTRUM_FLOOR_DB + 3.0, 1e-4);
+    average.setDbOffset(-10.0f);
+    average.toDb(db);
+    CHECK(db[2] == SPECTRUM_FLOOR_DB);
+    average.setDbOffset(3.0f);
+    average.toDb(db);
+    CHECK_NEAR(db[3], 10.0 * log10(4.0) + 3.0, 1e-4);
+}
+
+static void testHolds() {
+    float frame[4];
+    float db[4];
+
+    SpectrumAccumulator hold;
+    CHECK(hold.allocate(4));
+    hold.setMode(SPECTRUM_MAX_HOLD);
+    float a[4] = {1, 5, 2, 0.5f}, b[4] = {3, 1, 2, 0.25f};
+    hold.accumulate(a);
+    hold.accumulate(b);
+    CHECK(hold.getPower()[0] == 3 && hold.getPower()[1] == 5 && hold.getPower()[3] == 0.5f);
+
+    hold.setMode(SPECTRUM_MIN_HOLD);       // A mode change starts over
+    hold.accumulate(a);
+    hold.accumulate(b);
+    CHECK(hold.getPower()[0] == 1 && hold.getPower()[1] == 1 && hold.getPower()[3] == 0.25f);
+
+    // Peak decay falls a fixed dB per frame until it meets the input
+    SpectrumAccumulator peak;
+    CHECK(peak.allocate(4));
+    peak.setMode(SPECTRUM_PEAK_DECAY);
+    peak.setPeakDecay(2.0f);
+    for (int i = 0; i < 4; i++) frame[i] = 1.0f;          // 0 dB spike
+    peak.accumulate(frame);
+    for (int i = 0; i < 4; i++) frame[i] = 1e-3f;         // -30 dB floor
+    bool linear = true;
+    for (int k = 1; k <= 10; k++) {
+        peak.accumulate(frame);
+        peak.toDb(db);
+        if (fabsf(db[0] - (-2.0f * k)) > 0.01f) linear = false;
+    }
+    CHECK(linear);
+    for (int k = 0; k < 20; k++) peak.accumulate(frame);
+    peak.toDb(db);
+    CHECK_NEAR(db[0], -30.0, 0.01);
+
+    // A new, stronger peak takes over at once
+    frame[1] = 10.0f;
+    peak.accumulate(frame);
+    peak.toDb(db);
+    CHECK_NEAR(db[1], 10.0, 0.01);
+    CHECK_NEAR(db[0], -30.0, 0.01);
+}
+
+int main() {
+    testNoiseFloor();
+    testBlockAverage();
+    testHolds();
+    return testSummary("test_spectrum_accumulator");
+}
@@ -0,0 +1,299 @@
+// ========================================
+// test_spoof_index - Runs the scanner's bucketed spoofing pass over
+// SpoofIndex on random device sets that come, go, rename and time out,
+// and checks every pass against the all-pairs scan it replaced: the same
+// pairs match, and each pair raises one event until either device times
+// out or leaves, then one more if they match again
+// Build on the host (or run tests/run_host_tests.sh):
+//   g++ -O2 -Itests -Iapps/BLEScanner -o test_spoof_index
+//       tests/test_spoof_index.cpp apps/BLEScanner/SpoofIndex.cpp
+// ========================================
+
+#include "test_support.h"
+#include "SpoofIndex.h"
+#include <stdlib.h>
+#include <string.h>
+#include <set>
+#include <utility>
+
+#define SLOTS       128
+#define PASSES      3000
+#define NAME_POOL   40
+#define VENDOR_POOL 30
+
+static uint32_t rngState = 13;
+static uint32_t nextRandom() {
+    rngState = rngState * 1664525u + 1013904223u;
+    return rngState >> 8;
+}
+
+typedef std::pair<uint16_t, uint16_t> SlotPair;
+typedef std::pair<uint64_t, uint64_t> MacPair;
+
+// What the scanner keeps per slot that the spoofing check reads
+struct Device {
+    bool present;
+    bool timedOut;
+    uint64_t mac;
+    char name[16];
+    uint8_t payload[8];
+    uint8_t payloadLength;
+    int8_t rssi;
+};
+
+struct Population {
+    SpoofIndex index;
+    Device devices[SLOTS];
+    uint64_t nextMac;
+
+    Population() : nextMac(1) {
+        memset(devices, 0, sizeof(devices));
+        index.begin(SLOTS);
+    }
+
+    uint64_t fingerprint(uint16_t slot) const {
+        return SpoofIndex::fingerprint(devices[slot].payload, devices[slot].payloadLength);
+    }
+
+    void rename(uint16_t slot) {
+        Device& d = devices[slot];
+        if (nextRandom() % 2) {
+            snprintf(d.name, sizeof(d.name), "dev-%u", (unsigned)(nextRandom() % NAME_POOL));
+        } else {
+            d.name[0] = '\0';
+        }
+        index.setKey(SPOOF_KEY_NAME, slot, SpoofIndex::hashName(d.name));
+    }
+
+    // Manufacturer data from a small vendor pool, or flags only
+    void readvertise(uint16_t slot) {
+        Device& d = devices[slot];
+        d.payload[0] = 2;
+        d.payload[1] = 0x01;
+        d.payload[2] = 0x06;
+        d.payloadLength = 3;
+        if (nextRandom() % 2) {
+            uint16_t vendor = (uint16_t)(nextRandom() % VENDOR_POOL);
+            d.payload[3] = 3;
+            d.payload[4] = 0xFF;
+            d.payload[5] = (uint8_t)vendor;
+            d.payload[6] = (uint8_t)(vendor >> 8);
+            d.payloadLength = 7;
+        }
+        // As the scanner does, a payload without the fields keeps the old key
+        uint64_t key = fingerprint(slot);
+        if (key != 0) index.setKey(SPOOF_KEY_PAYLOAD, slot, key);
+    }
+
+    void arrive(uint16_t slot) {
+        Device& d = devices[slot];
+        d = Device();
+        d.present = true;
+        d.mac = nextMac++;
+        d.rssi = (int8_t)(-70 + (int)(nextRandom() % 12));
+        rename(slot);
+        readvertise(slot);
+    }
+
+    void leave(uint16_t slot) {
+        devices[slot].present = false;
+        index.remove(slot);
+    }
+
+    void timeOut(uint16_t slot) {
+        if (!devices[slot].timedOut) index.forgetPairs(slot);
+        devices[slot].timedOut = true;
+    }
+};
+
+// ===== BUCKETED PASS =====
+
+// The scanner's detectSignalSpoofing() and checkSpoofPair()
+static void checkPair(Population& p, uint8_t kind, uint16_t a, uint16_t b,
+                      std::set<SlotPair>& matched, std::set<SlotPair>& events) {
+    const Device& d1 = p.devices[a];
+    const Device& d2 = p.devices[b];
+    if (d1.mac == d2.mac) return;
+    if (d1.timedOut || d2.timedOut) return;
+
+    bool sameName = d1.name[0] != '\0' && strcmp(d1.name, d2.name) == 0;
+    if (kind == SPOOF_KEY_NAME && !sameName) return;
+    if (kind == SPOOF_KEY_PAYLOAD && sameName) return;
+    if (abs(d1.rssi - d2.rssi) >= 3) return;
+
+    SlotPair pair(a < b ? a : b, a < b ? b : a);
+    matched.insert(pair);
+    if (p.index.markReported(a, b)) events.insert(pair);
+}
+
+static uint32_t bucketedPass(Population& p, std::set<SlotPair>& matched, std::set<SlotPair>& events) {
+    uint32_t comparisons = 0;
+    for (uint8_t kind = 0; kind < SPOOF_KEY_COUNT; kind++) {
+        for (uint16_t bucket = 0; bucket < p.index.getBucketCount(); bucket++) {
+            for (uint16_t a = p.index.first(kind, bucket); a != SPOOF_NO_SLOT; a = p.index.next(kind, a)) {
+                for (uint16_t b = p.index.next(kind, a); b != SPOOF_NO_SLOT; b = p.index.next(kind, b)) {
+                    if (p.index.getKey(kind, a) == p.index.getKey(kind, b)) {
+                        checkPair(p, kind, a, b, matched, events);
+                        comparisons++;
+                    }
+                }
+            }
+        }
+    }
+    return comparisons;
+}
+
+// ===== ALL-PAIRS REFERENCE =====
+
+// The old scan over every pair of devices, with the payload case the
+// index added, and a reported set of MAC pairs that drops a device's
+// pairs when it times out or leaves
+struct Reference {
+    std::set<MacPair> reported;
+
+    void forget(uint64_t mac) {
+        for (std::set<MacPair>::iterator it = reported.begin(); it != reported.end();) {
+            if (it->first == mac || it->second == mac) {
+                it = reported.erase(it);
+            } else {
+                ++it;
+            }
+        }
+    }
+
+    void pass(const Population& p, std::set<SlotPair>& matched, std::set<SlotPair>& events) {
+        for (uint16_t i = 0; i < SLOTS; i++) {
+            for (uint16_t j = i + 1; j < SLOTS; j++) {
+                const Device& d1 = p.devices[i];
+                const Device& d2 = p.devices[j];
+                if (!d1.present || !d2.present || d1.timedOut || d2.timedOut) continue;
+
+                bool sameName = d1.name[0] != '\0' && strcmp(d1.name, d2.name) == 0;
+                uint64_t fingerprint = p.index.getKey(SPOOF_KEY_PAYLOAD, i);
+                bool samePayload = fingerprint != 0 && fingerprint == p.index.getKey(SPOOF_KEY_PAYLOAD, j);
+                if (!sameName && !samePayload) continue;
+                if (abs(d1.rssi - d2.rssi) >= 3) continue;
+
+                matched.insert(SlotPair(i, j));
+                MacPair macs(d1.mac < d2.mac ? d1.mac : d2.mac, d1.mac < d2.mac ? d2.mac : d1.mac);
+                if (reported.insert(macs).second) events.insert(SlotPair(i, j));
+            }
+        }
+    }
+};
+
+// ===== TESTS =====
+
+static void testAgainstAllPairs() {
+    Population p;
+    Reference reference;
+    for (uint16_t slot = 0; slot < SLOTS; slot++) {
+        if (nextRandom() % 4) p.arrive(slot);
+    }
+
+    uint32_t matchMismatches = 0, eventMismatches = 0, repeats = 0;
+    uint64_t events = 0, comparisons = 0;
+    for (uint32_t pass = 0; pass < PASSES; pass++) {
+        // A few changes between passes, as between the scanner's checks
+        uint32_t changes = 1 + nextRandom() % 8;
+        for (uint32_t c = 0; c < changes; c++) {
+            uint16_t slot = (uint16_t)(nextRandom() % SLOTS);
+            Device& d = p.devices[slot];
+            if (!d.present) {
+                p.arrive(slot);
+                continue;
+            }
+            switch (nextRandom() % 6) {
+                case 0:
+                    reference.forget(d.mac);
+                    p.leave(slot);
+                    break;
+                case 1:
+                    if (!d.timedOut) reference.forget(d.mac);
+                    p.timeOut(slot);
+                    break;
+                case 2:
+                    d.timedOut = false;          // Seen again
+                    break;
+                case 3:
+                    p.rename(slot);
+                    break;
+                case 4:
+                    p.readvertise(slot);
+                    break;
+                default:
+                    d.rssi = (int8_t)(-70 + (int)(nextRandom() % 12));
+                    break;
+            }
+        }
+
+        std::set<SlotPair> matched, raised, expectedMatched, expectedRaised;
+        comparisons += bucketedPass(p, matched, raised);
+        reference.pass(p, expectedMatched, expectedRaised);
+        if (matched != expectedMatched) matchMismatches++;
+        if (raised != expectedRaised) eventMismatches++;
+        events += raised.size();
+
+        // Nothing changed, so a second pass raises nothing
+        std::set<SlotPair> again, none;
+        bucketedPass(p, again, none);
+        if (!none.empty()) repeats++;
+    }
+    CHECK(matchMismatches == 0);
+    CHECK(eventMismatches == 0);
+    CHECK(repeats == 0);
+
+    // Retired pairs were swept out rather than the whole set forgotten
+    const SpoofIndexStats& stats = p.index.getStats();
+    CHECK(stats.pairsExpired > 0);
+    CHECK(stats.reportedResets == 0);
+    printf("  %u passes: %u events, %u chain comparisons, %u pairs expired\n",
+           (unsigned)PASSES, (unsigned)events, (unsigned)comparisons, (unsigned)stats.pairsExpired);
+}
+
+static void testForgetAndReuse() {
+    SpoofIndex index;
+    CHECK(index.begin(8));
+    CHECK(index.markReported(1, 2));
+    CHECK(!index.markReported(2, 1));
+    CHECK(index.markReported(1, 3));
+
+    // Either side timing out retires the pair, others stay
+    index.forgetPairs(2);
+    CHECK(index.markReported(1, 2));
+    CHECK(!index.markReported(3, 1));
+
+    // A slot handed to a new device starts clean
+    index.remove(3);
+    CHECK(index.markReported(1, 3));
+    CHECK(!index.markReported(1, 2));
+}
+
+static void testSaturation() {
+    // Only live pairs that fill 3/4 of the set make it start over
+    SpoofIndex index;
+    CHECK(index.begin(8));                   // 16 entries, full at 12
+    for (uint16_t a = 0; a < 8; a++) {
+        for (uint16_t b = a + 1; b < 8; b++) index.markReported(a, b);
+    }
+    // 28 pairs: the 13th and 25th find it full
+    CHECK(index.getStats().reportedResets == 2);
+    CHECK(index.getStats().pairsReported == 28);
+
+    // With every slot forgotten in between, sweeping makes the room
+    SpoofIndex churned;
+    CHECK(churned.begin(8));
+    for (uint32_t round = 0; round < 100; round++) {
+        for (uint16_t b = 1; b < 5; b++) CHECK(churned.markReported(0, b));
+        for (uint16_t slot = 0; slot < 8; slot++) churned.forgetPairs(slot);
+    }
+    CHECK(churned.getStats().reportedResets == 0);
+    CHECK(churned.getStats().pairsExpired > 0);
+}
+
+int main() {
+    testAgainstAllPairs();
+    testForgetAndReuse();
+    testSaturation();
+    return testSummary("test_spoof_index");
+}
@@ -0,0 +1,39 @@
+#ifndef TEST_SUPPORT_H
+#define TEST_SUPPORT_H
+
+#include <stdio.h>
+#include <math.h>
+
+// ========================================
+// test_support - Minimal checks for the host tests in this directory
+// A failed check prints its location and the run continues, so one run
+// reports every failure; testSummary() turns them into the exit code.
+// ========================================
+
+static int testChecks = 0;
+static int testFailures = 0;
+
+#define CHECK(cond) do { \
+    testChecks++; \
+    if (!(cond)) { \
+        testFailures++; \
+        fprintf(stderr, "%s:%d: CHECK(%s) failed\n", __FILE__, __LINE__, #cond); \
+    } \
+} while (0)
+
+#define CHECK_NEAR(actual, expected, tolerance) do { \
+    testChecks++; \
+    double a_ = (double)(actual), e_ = (double)(expected); \
+    if (!(fabs(a_ - e_) <= (double)(tolerance))) { \
+        testFailures++; \
+        fprintf(stderr, "%s:%d: %s = %g, expected %g +/- %g\n", __FILE__, __LINE__, \
+                #actual, a_, e_, (double)(tolerance)); \
+    } \
+} while (0)
+
+static inline int testSummary(const char* name) {
+    printf("%-28s %d checks, %d failed\n", name, testChecks, testFailures);
+    return testFailures == 0 ? 0 : 1;
+}
+
+#endif // TEST_SUPPORT_H
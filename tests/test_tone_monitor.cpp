@@ -0,0 +1,122 @@
+// ========================================
+// test_tone_monitor - Goertzel level calibration against known-amplitude
+// sines and the on/off hysteresis and debounce event sequence
+// Build on the host (or run tests/run_host_tests.sh):
+//   g++ -O2 -Itests -Iapps/PreqScanner -o test_tone_monitor
+//       tests/test_tone_monitor.cpp apps/PreqScanner/ToneMonitor.cpp
+// ========================================
+
+#include "test_support.h"
+#include "ToneMonitor.h"
+#include <math.h>
+
+#define RATE        8000
+#define BLOCK       256          // 32 ms per block
+#define ADC_MID     2048         // Signals ride on the ADC midscale
+
+static uint32_t sampleClock = 0;
+
+// One block of a sine at dBFS (below -150: silence) on the ADC midscale
+static void feedBlock(ToneMonitor& monitor, float hz, float dbfs) {
+    int16_t block[BLOCK];
+    float amplitude = dbfs < -150.0f ? 0.0f : TONE_FULL_SCALE * powf(10.0f, dbfs / 20.0f);
+    for (uint16_t n = 0; n < BLOCK; n++, sampleClock++) {
+        float v = ADC_MID + amplitude * sinf(2.0f * M_PI * hz * sampleClock / RATE + 0.3f);
+        block[n] = (int16_t)lrintf(v);
+    }
+    // Odd pieces, so chunking and block edges do not line up
+    monitor.process(block, 100);
+    monitor.process(block + 100, 37);
+    monitor.process(block + 137, BLOCK - 137);
+}
+
+static void testCalibration() {
+    ToneMonitor monitor;
+    CHECK(monitor.configure(RATE, BLOCK));
+    sampleClock = 0;
+
+    // On a bin centre and between bins: detectors sit on the tone exactly
+    int8_t onBin = monitor.addDetector(1000.0f);
+    int8_t offBin = monitor.addDetector(1234.5f);
+    int8_t away = monitor.addDetector(1600.0f);
+    CHECK(onBin == 0 && offBin == 1 && away == 2);
+
+    const float levels[] = {-6.0f, -20.0f, -40.0f};
+    for (uint8_t i = 0; i < 3; i++) {
+        feedBlock(monitor, 1000.0f, levels[i]);
+        CHECK_NEAR(monitor.getDetector(onBin)->levelDb, levels[i], 0.15);
+        feedBlock(monitor, 1234.5f, levels[i]);
+        CHECK_NEAR(monitor.getDetector(offBin)->levelDb, levels[i], 0.15);
+    }
+
+    // 366 Hz (11.7 bins) off, a strong tone barely registers
+    feedBlock(monitor, 1234.5f, -6.0f);
+    CHECK(monitor.getDetector(away)->levelDb < -70.0f);
+
+    // Silence on the midscale reads as nothing once the DC tracker settles
+    feedBlock(monitor, 1000.0f, -200.0f);
+    CHECK(monitor.getDetector(onBin)->levelDb < -80.0f);
+
+    CHECK(monitor.addDetector(4000.0f) == -1);     // At Nyquist
+    CHECK(monitor.getBlocksProcessed() == 8);
+    CHECK_NEAR(monitor.getBlockDuration(), 0.032, 1e-6);
+}
+
+static void testEventSequence() {
+    ToneMonitor monitor;
+    CHECK(monitor.configure(RATE, BLOCK));
+    monitor.setDebounce(2);
+    sampleClock = 0;
+    int8_t d = monitor.addDetector(1000.0f, -40.0f, 6.0f);     // On -40, off -46
+
+    // Per block: a lone loud block is debounced away; five loud blocks turn
+    // it on; -43 sits in the hysteresis band; a lone quiet block is ignored
+    const float script[] = {
+        -200, -200, -200, -30, -200, -200,       //  0..5
+        -30, -30, -30, -30, -30,                 //  6..10  on at block 6
+        -43, -43, -60, -43,                      // 11..14  stays on
+        -60, -60, -60, -200                      // 15..18  off at block 15
+    };
+    for (uint8_t b = 0; b < sizeof(script) / sizeof(script[0]); b++) {
+        feedBlock(monitor, 1000.0f, script[b]);
+        if (b == 3) CHECK(!monitor.getDetector(d)->active);
+        if (b == 7) CHECK(monitor.getDetector(d)->active);
+        if (b == 13) CHECK(monitor.getDetector(d)->active);
+    }
+
+    ToneEvent e;
+    CHECK(monitor.pollEvent(e));
+    CHECK(e.type == TONE_EVENT_ON && e.detector == (uint8_t)d);
+    CHECK(e.timestamp == 6 * 32);          // Dated from the first loud block
+    CHECK(e.duration == 6 * 32);
+    CHECK_NEAR(e.levelDb, -30.0, 0.2);
+
+    CHECK(monitor.pollEvent(e));
+    CHECK(e.type == TONE_EVENT_OFF);
+    CHECK(e.timestamp == 15 * 32);
+    CHECK(e.duration == 9 * 32);
+    CHECK(!monitor.pollEvent(e));
+
+    const ToneDetector* det = monitor.getDetector(d);
+    CHECK(det->onCount == 1 && det->longestOnMs == 9 * 32 && det->totalOnMs == 9 * 32);
+
+    // With a debounce of one a single block is enough, both ways
+    monitor.setDebounce(1);
+    feedBlock(monitor, 1000.0f, -30.0f);
+    feedBlock(monitor, 1000.0f, -200.0f);
+    CHECK(monitor.pollEvent(e) && e.type == TONE_EVENT_ON && e.timestamp == 19 * 32);
+    CHECK(monitor.pollEvent(e) && e.type == TONE_EVENT_OFF && e.duration == 32);
+
+    // Removing a detector that is on still reports the off
+    feedBlock(monitor, 1000.0f, -30.0f);
+    CHECK(monitor.pollEvent(e) && e.type == TONE_EVENT_ON);
+    monitor.removeDetector((uint8_t)d);
+    CHECK(monitor.pollEvent(e) && e.type == TONE_EVENT_OFF);
+    CHECK(monitor.getDetectorCount() == 0);
+}
+
+int main() {
+    testCalibration();
+    testEventSequence();
+    return testSummary("test_tone_monitor");
+}
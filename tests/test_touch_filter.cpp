@@ -0,0 +1,225 @@
+// ========================================
+// test_touch_filter - Q16 affine calibration fit, outlier rejection,
+// drag smoothing and the EEPROM calibration record, plus a per-sample
+// cost benchmark of the filter pipeline
+// Build on the host (or run tests/run_host_tests.sh):
+//   g++ -O2 -Itests -Icore/TouchInterface -o test_touch_filter
+//       tests/test_touch_filter.cpp core/TouchInterface/TouchFilter.cpp
+// ========================================
+
+#include "test_support.h"
+#include "TouchFilter.h"
+#include <stdlib.h>
+#include <string.h>
+#include <chrono>
+#if defined(__x86_64__) || defined(__i386__)
+#include <x86intrin.h>
+#endif
+
+static uint32_t rngState = 1;
+static uint32_t nextRandom() {
+    rngState = rngState * 1664525u + 1013904223u;
+    return rngState >> 8;
+}
+
+// Screen from raw through a known rotated, skewed, offset panel
+static void panel(double rawX, double rawY, double& x, double& y) {
+    x = 0.0821 * rawX - 0.0042 * rawY - 18.5;
+    y = 0.0035 * rawX + 0.0652 * rawY - 12.25;
+}
+
+// Raw reading for a screen point (inverse of panel)
+static void rawFor(double x, double y, double& rawX, double& rawY) {
+    double a = 0.0821, b = -0.0042, c = -18.5, d = 0.0035, e = 0.0652, f = -12.25;
+    double det = a * e - b * d;
+    rawX = (e * (x - c) - b * (y - f)) / det;
+    rawY = (a * (y - f) - d * (x - c)) / det;
+}
+
+static void testAffineFit() {
+    static const int16_t targets[][2] = {
+        {20, 20}, {300, 20}, {160, 120}, {20, 220}, {300, 220}
+    };
+
+    // Exact for three points
+    CalibrationSample samples[5];
+    for (uint8_t i = 0; i < 5; i++) {
+        double rx, ry;
+        rawFor(targets[i][0], targets[i][1], rx, ry);
+        samples[i] = {targets[i][0], targets[i][1], (uint16_t)lround(rx), (uint16_t)lround(ry)};
+    }
+    AffineQ16 m;
+    CHECK(solveAffineCalibration(samples, 3, m));
+    CHECK(affineMaxError(m, samples, 3) <= 1);
+
+    // Least squares over five noisy points recovers the panel within a pixel
+    rngState = 7;
+    for (uint8_t i = 0; i < 5; i++) {
+        double rx, ry;
+        rawFor(targets[i][0], targets[i][1], rx, ry);
+        samples[i].rawX = (uint16_t)lround(rx + (int)(nextRandom() % 9) - 4);
+        samples[i].rawY = (uint16_t)lround(ry + (int)(nextRandom() % 9) - 4);
+    }
+    CHECK(solveAffineCalibration(samples, 5, m));
+    CHECK_NEAR(m.a / 65536.0, 0.0821, 0.002);
+    CHECK_NEAR(m.e / 65536.0, 0.0652, 0.002);
+    CHECK(affineMaxError(m, samples, 5) <= 2);
+
+    int32_t worst = 0;
+    for (uint16_t rawX = 500; rawX < 3800; rawX += 97) {
+        for (uint16_t rawY = 500; rawY < 3800; rawY += 89) {
+            double ex, ey;
+            panel(rawX, rawY, ex, ey);
+            int16_t x, y;
+            applyAffine(m, rawX, rawY, x, y);
+            int32_t d2 = touchDistanceSquared(x, y, (int16_t)lround(ex), (int16_t)lround(ey));
+            if (d2 > worst) worst = d2;
+        }
+    }
+    CHECK(worst <= 4);   // Within 2 px over the whole panel
+
+    // Degenerate and out-of-range inputs are refused
+    CalibrationSample collinear[3] = {{0, 0, 1000, 1000}, {50, 50, 2000, 2000}, {100, 100, 3000, 3000}};
+    CHECK(!solveAffineCalibration(collinear, 3, m));
+    CHECK(!solveAffineCalibration(samples, 2, m));
+    CalibrationSample steep[3] = {{0, 0, 100, 100}, {3000, 0, 110, 100}, {0, 3000, 100, 110}};
+    CHECK(!solveAffineCalibration(steep, 3, m));
+
+    // The uncalibrated range mapping hits the corners
+    AffineQ16 r = affineFromRanges(200, 3800, 300, 3700, 320, 240);
+    int16_t x, y;
+    applyAffine(r, 200, 300, x, y);
+    CHECK(x == 0 && y == 0);
+    applyAffine(r, 3800, 3700, x, y);
+    CHECK(x == 320 && y == 240);
+}
+
+static void testOutliers() {
+    uint16_t values[] = {30, 10, 20, 50, 40};
+    CHECK(medianOf(values, 5) == 30);
+    CHECK(medianOf(values, 0) == 0);
+
+    // One wild sample on either axis is dropped from the average
+    uint16_t rx[] = {2000, 2010, 1990, 3500};
+    uint16_t ry[] = {1500, 1510, 1490, 1500};
+    uint16_t ox, oy;
+    CHECK(rejectOutliers(rx, ry, 4, ox, oy) == 3);
+    CHECK(ox == 2000 && oy == 1500);
+
+    uint16_t ry2[] = {1500, 1510, 100, 1500};
+    uint16_t rx2[] = {2000, 2010, 1990, 2000};
+    CHECK(rejectOutliers(rx2, ry2, 4, ox, oy) == 3);
+    CHECK(oy == 1503);
+
+    // All disagreeing: fall back to the median
+    uint16_t sx[] = {100, 1000, 2000, 3000};
+    uint16_t sy[] = {100, 1000, 2000, 3000};
+    CHECK(rejectOutliers(sx, sy, 4, ox, oy) == 1);
+    CHECK(ox == medianOf(sx, 4) && oy == medianOf(sy, 4));
+}
+
+static void testSmoother() {
+    TouchSmoother smoother;
+    int16_t x = 100, y = 50;
+    smoother.apply(x, y);
+    CHECK(x == 100 && y == 50);         // First sample passes through
+
+    // A step settles to the target without stalling a pixel short
+    for (int i = 0; i < 40; i++) {
+        x = 140;
+        y = 50;
+        smoother.apply(x, y);
+    }
+    CHECK(x == 140 && y == 50);
+
+    // Slow one-pixel steps are not swallowed by truncation
+    int16_t last = x;
+    for (int i = 0; i < 20; i++) {
+        x = (int16_t)(141 + i);
+        y = 50;
+        smoother.apply(x, y);
+    }
+    CHECK(x > last + 10);
+}
+
+static void testCalibrationRecord() {
+    CHECK(sizeof(CalibrationRecord) == 30);
+
+    AffineQ16 m = {5381, -275, -1212416, 229, 4273, -802816};
+    CalibrationRecord record;
+    packCalibrationRecord(m, 5, record);
+
+    AffineQ16 back;
+    uint8_t points = 0;
+    CHECK(unpackCalibrationRecord(record, back, points));
+    CHECK(memcmp(&back, &m, sizeof(m)) == 0 && points == 5);
+
+    // Every single-bit flip in the record is caught
+    uint8_t* bytes = (uint8_t*)&record;
+    int missed = 0;
+    for (size_t i = 0; i < sizeof(record); i++) {
+        for (uint8_t bit = 0; bit < 8; bit++) {
+            bytes[i] ^= (uint8_t)(1 << bit);
+            if (unpackCalibrationRecord(record, back, points)) missed++;
+            bytes[i] ^= (uint8_t)(1 << bit);
+        }
+    }
+    CHECK(missed == 0);
+
+    // Fletcher sees order, which a plain sum would not
+    CalibrationRecord swapped = record;
+    int32_t t = swapped.matrix[0];
+    swapped.matrix[0] = swapped.matrix[1];
+    swapped.matrix[1] = t;
+    CHECK(calibrationChecksum(swapped) != record.checksum);
+
+    // Erased EEPROM (all 0xFF) is not a calibration
+    memset(&record, 0xFF, sizeof(record));
+    CHECK(!unpackCalibrationRecord(record, back, points));
+}
+
+static void benchmarkPipeline() {
+    // One screen sample: 4 raw reads -> outlier rejection -> affine -> smoother
+    const int samples = 2000000;
+    AffineQ16 m = {5381, -275, -1212416, 229, 4273, -802816};
+    TouchSmoother smoother;
+    uint16_t rx[4], ry[4];
+    int32_t sink = 0;
+    rngState = 3;
+
+    auto start = std::chrono::steady_clock::now();
+#if defined(__x86_64__) || defined(__i386__)
+    uint64_t cycles = __rdtsc();
+#endif
+    for (int i = 0; i < samples; i++) {
+        for (uint8_t k = 0; k < 4; k++) {
+            rx[k] = (uint16_t)(1000 + (i & 1023) + (nextRandom() & 15));
+            ry[k] = (uint16_t)(1500 + (nextRandom() & 15));
+        }
+        uint16_t ox, oy;
+        rejectOutliers(rx, ry, 4, ox, oy);
+        int16_t x, y;
+        applyAffine(m, ox, oy, x, y);
+        smoother.apply(x, y);
+        sink += x + y;
+    }
+#if defined(__x86_64__) || defined(__i386__)
+    cycles = __rdtsc() - cycles;
+#endif
+    double ns = std::chrono::duration<double, std::nano>(std::chrono::steady_clock::now() - start).count();
+
+    printf("  pipeline: %.1f ns/sample", ns / samples);
+#if defined(__x86_64__) || defined(__i386__)
+    printf(", %.0f TSC cycles/sample", (double)cycles / samples);
+#endif
+    printf(" (includes synthetic input; checksum %d)\n", sink & 0xFF);
+}
+
+int main() {
+    testAffineFit();
+    testOutliers();
+    testSmoother();
+    testCalibrationRecord();
+    benchmarkPipeline();
+    return testSummary("test_touch_filter");
+}
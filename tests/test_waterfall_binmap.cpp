@@ -0,0 +1,118 @@
+// ========================================
+// test_waterfall_binmap - Waterfall bin map and max/mean pooling at the
+// edges: fewer bins than columns, more bins than columns, zoom and pan
+// Build on the host (or run tests/run_host_tests.sh):
+//   g++ -O2 -Itests -Iapps/PreqScanner -o test_waterfall_binmap
+//       tests/test_waterfall_binmap.cpp apps/PreqScanner/WaterfallRing.cpp
+// ========================================
+
+#include "test_support.h"
+#include "WaterfallRing.h"
+
+#define WIDTH   320
+
+static uint16_t binStart[WIDTH + 1];
+static float spectrum[2048];
+
+// Map as FreqScanner builds it for a zoom factor and a start bin
+static void buildMap(uint16_t bins, float zoom, float firstBin) {
+    buildWaterfallBinMap(binStart, WIDTH, bins, firstBin, bins / zoom / WIDTH);
+}
+
+// Structural checks every map must pass
+static void checkMap(uint16_t bins) {
+    bool ordered = true;
+    bool inRange = true;
+    for (uint16_t x = 0; x < WIDTH; x++) {
+        if (binStart[x + 1] < binStart[x]) ordered = false;
+        if (binStart[x] >= bins) inRange = false;
+    }
+    CHECK(ordered);
+    CHECK(inRange);
+    CHECK(binStart[WIDTH] <= bins);
+}
+
+static void testFewerBinsThanColumns() {
+    // 64 bins over 320 columns: five columns per bin, each showing its bin
+    const uint16_t bins = 64;
+    for (uint16_t b = 0; b < bins; b++) spectrum[b] = (float)b;
+    buildMap(bins, 1.0f, 0.0f);
+    checkMap(bins);
+
+    bool exact = true;
+    for (uint16_t x = 0; x < WIDTH; x++) {
+        float expected = (float)(x * bins / WIDTH);
+        if (poolWaterfallPixel(spectrum, binStart, x, true) != expected) exact = false;
+        if (poolWaterfallPixel(spectrum, binStart, x, false) != expected) exact = false;
+    }
+    CHECK(exact);
+    CHECK(poolWaterfallPixel(spectrum, binStart, 0, true) == 0.0f);
+    CHECK(poolWaterfallPixel(spectrum, binStart, WIDTH - 1, true) == bins - 1);
+
+    // Zoomed far in at the top edge: the last column still reads a real bin
+    buildMap(bins, 64.0f, bins - 1.0f);
+    checkMap(bins);
+    CHECK(binStart[0] == bins - 1);
+    CHECK(poolWaterfallPixel(spectrum, binStart, WIDTH - 1, false) == bins - 1);
+}
+
+static void testMoreBinsThanColumns() {
+    // 1024 bins over 320 columns: 3.2 bins per column
+    const uint16_t bins = 1024;
+    for (uint16_t b = 0; b < bins; b++) spectrum[b] = (float)b;
+    buildMap(bins, 1.0f, 0.0f);
+    checkMap(bins);
+
+    // The full view covers every bin exactly once
+    CHECK(binStart[0] == 0 && binStart[WIDTH] == bins);
+    uint32_t covered = 0;
+    for (uint16_t x = 0; x < WIDTH; x++) covered += binStart[x + 1] - binStart[x];
+    CHECK(covered == bins);
+
+    // On a ramp the max is the last bin and the mean the middle one
+    bool maxOk = true;
+    bool meanOk = true;
+    for (uint16_t x = 0; x < WIDTH; x++) {
+        uint16_t first = binStart[x];
+        uint16_t last = binStart[x + 1];
+        if (poolWaterfallPixel(spectrum, binStart, x, true) != last - 1) maxOk = false;
+        float mean = (first + last - 1) / 2.0f;
+        float got = poolWaterfallPixel(spectrum, binStart, x, false);
+        if (got < mean - 0.01f || got > mean + 0.01f) meanOk = false;
+    }
+    CHECK(maxOk);
+    CHECK(meanOk);
+    CHECK(poolWaterfallPixel(spectrum, binStart, WIDTH - 1, true) == bins - 1);
+
+    // A narrow tone between column edges survives max pooling, not the mean
+    for (uint16_t b = 0; b < bins; b++) spectrum[b] = -100.0f;
+    spectrum[517] = -20.0f;
+    uint16_t column = 0;
+    while (binStart[column + 1] <= 517) column++;
+    CHECK(poolWaterfallPixel(spectrum, binStart, column, true) == -20.0f);
+    CHECK(poolWaterfallPixel(spectrum, binStart, column, false) < -60.0f);
+    float elsewhere = poolWaterfallPixel(spectrum, binStart, column + 1, true);
+    CHECK(elsewhere == -100.0f);
+}
+
+static void testPannedEdges() {
+    // 2x zoom panned to the top: the map ends exactly on the last bin
+    const uint16_t bins = 512;
+    for (uint16_t b = 0; b < bins; b++) spectrum[b] = (float)b;
+    buildMap(bins, 2.0f, bins / 2.0f);
+    checkMap(bins);
+    CHECK(binStart[0] == bins / 2 && binStart[WIDTH] == bins);
+    CHECK(poolWaterfallPixel(spectrum, binStart, WIDTH - 1, true) == bins - 1);
+
+    // Rounding past the end is clamped instead of reading beyond the spectrum
+    buildWaterfallBinMap(binStart, WIDTH, bins, bins / 2.0f + 0.9f, bins / 2.0f / WIDTH);
+    checkMap(bins);
+    CHECK(binStart[WIDTH - 1] == bins - 1);
+}
+
+int main() {
+    testFewerBinsThanColumns();
+    testMoreBinsThanColumns();
+    testPannedEdges();
+    return testSummary("test_waterfall_binmap");
+}
@@ -0,0 +1,176 @@
+// ========================================
+// test_waterfall_ring - Counts the rows and SPI bytes the waterfall sends
+// per new line, and per second at 20 and 60 lines/sec against redrawing
+// the whole area every frame, and checks the on-screen ring against the
+// history
+// Build on the host (or run tests/run_host_tests.sh):
+//   g++ -O2 -Itests -Iapps/PreqScanner -o test_waterfall_ring
+//       tests/test_waterfall_ring.cpp apps/PreqScanner/WaterfallRing.cpp
+// ========================================
+
+#include "test_support.h"
+#include "WaterfallRing.h"
+#include <string.h>
+#include <vector>
+
+#define WIDTH               320
+#define DEPTH               120
+#define AREA_ROWS           80
+#define ADDR_WINDOW_BYTES   11       // CASET/PASET/RAMWR, as DisplayManager counts them
+#define FRAME_MS            50       // TARGET_FRAME_TIME in remu_ii.ino
+#define RATE_SECONDS        10
+
+// Records each pushed row into a mock frame and counts the transfer
+class CountingSink : public WaterfallRowSink {
+public:
+    std::vector<uint16_t> frame;
+    uint32_t windows;
+    uint32_t bytes;
+    int16_t lastRow;
+
+    CountingSink() : frame((size_t)AREA_ROWS * WIDTH, 0xFFFF), windows(0), bytes(0), lastRow(-1) {}
+
+    void pushRow(uint16_t row, const uint16_t* pixels, uint16_t width) override {
+        CHECK(row < AREA_ROWS && width == WIDTH);
+        memcpy(&frame[(size_t)row * WIDTH], pixels, width * sizeof(uint16_t));
+        windows++;
+        bytes += ADDR_WINDOW_BYTES + width * 2;
+        lastRow = (int16_t)row;
+    }
+};
+
+static uint16_t palette[256];
+
+static void addLine(WaterfallRing& ring, uint8_t value) {
+    uint8_t* line = ring.beginLine();
+    for (uint16_t x = 0; x < WIDTH; x++) line[x] = (uint8_t)(value + x);
+}
+
+// Reading the area from the write row down wraps from oldest to newest
+static bool frameMatchesHistory(WaterfallRing& ring, const CountingSink& sink) {
+    for (uint16_t age = 0; age < AREA_ROWS; age++) {
+        uint16_t row = (ring.getWriteRow() + AREA_ROWS - 1 - age) % AREA_ROWS;
+        const uint8_t* line = ring.historyLine(age);
+        for (uint16_t x = 0; x < WIDTH; x++) {
+            if (sink.frame[(size_t)row * WIDTH + x] != palette[line[x]]) return false;
+        }
+    }
+    return true;
+}
+
+static void testBytesPerLine() {
+    WaterfallRing ring;
+    CHECK(ring.allocate(WIDTH, DEPTH, AREA_ROWS));
+    CountingSink sink;
+
+    // First showing paints the whole area once
+    CHECK(ring.render(sink, palette) == AREA_ROWS);
+    CHECK(sink.windows == AREA_ROWS);
+    CHECK(ring.render(sink, palette) == 0);
+
+    // Each new line afterwards costs one address window and one row
+    uint32_t worst = 0;
+    for (int i = 0; i < 500; i++) {
+        addLine(ring, (uint8_t)i);
+        ring.commitLine();
+
+        uint32_t windows = sink.windows;
+        uint32_t bytes = sink.bytes;
+        int16_t expectedRow = (int16_t)ring.getWriteRow();
+        CHECK(ring.render(sink, palette) == 1);
+        CHECK(sink.windows - windows == 1);
+        CHECK(sink.lastRow == expectedRow);
+        if (sink.bytes - bytes > worst) worst = sink.bytes - bytes;
+    }
+    CHECK(worst == ADDR_WINDOW_BYTES + WIDTH * 2);
+    CHECK(frameMatchesHistory(ring, sink));
+
+    uint32_t fullBlit = AREA_ROWS * (ADDR_WINDOW_BYTES + WIDTH * 2);
+    printf("  per line: %u bytes (full repaint %u bytes, %.0fx less)\n",
+           (unsigned)worst, (unsigned)fullBlit, (double)fullBlit / worst);
+}
+
+static void testLineRates() {
+    // Lines arrive on their own clock and render() runs once per frame
+    static const uint32_t lineRates[] = {20, 60};
+    const uint32_t frames = RATE_SECONDS * 1000 / FRAME_MS;
+    const uint32_t fullBlit = AREA_ROWS * (ADDR_WINDOW_BYTES + WIDTH * 2);
+
+    for (uint32_t linesPerSecond : lineRates) {
+        WaterfallRing ring;
+        CHECK(ring.allocate(WIDTH, DEPTH, AREA_ROWS));
+        CountingSink sink;
+        ring.render(sink, palette);
+
+        uint32_t bytesBefore = sink.bytes;
+        uint32_t lines = 0;
+        for (uint32_t frame = 1; frame <= frames; frame++) {
+            uint32_t due = frame * FRAME_MS * linesPerSecond / 1000;
+            for (; lines < due; lines++) {
+                addLine(ring, (uint8_t)lines);
+                ring.commitLine();
+            }
+            ring.render(sink, palette);
+        }
+        CHECK(ring.getPending() == 0);
+        CHECK(frameMatchesHistory(ring, sink));
+
+        uint32_t ringRate = (sink.bytes - bytesBefore) / RATE_SECONDS;
+        uint32_t fullRate = frames * fullBlit / RATE_SECONDS;
+        // One row per line, whatever the frames batched together
+        CHECK(ringRate == linesPerSecond * (ADDR_WINDOW_BYTES + WIDTH * 2));
+        printf("  %2u lines/s: %u bytes/s (full redraw each frame %u bytes/s, %.0fx less)\n",
+               (unsigned)linesPerSecond, (unsigned)ringRate, (unsigned)fullRate,
+               (double)fullRate / ringRate);
+    }
+}
+
+static void testBacklogAndRepaint() {
+    WaterfallRing ring;
+    CHECK(ring.allocate(WIDTH, DEPTH, AREA_ROWS));
+    CountingSink sink;
+    ring.render(sink, palette);
+
+    // Several lines between frames go out oldest first, still one row each
+    for (int i = 0; i < 5; i++) {
+        addLine(ring, (uint8_t)(7 * i));
+        ring.commitLine();
+    }
+    uint32_t windows = sink.windows;
+    CHECK(ring.render(sink, palette) == 5);
+    CHECK(sink.windows - windows == 5);
+    CHECK(frameMatchesHistory(ring, sink));
+
+    // A longer backlog than the area sends each row once
+    for (int i = 0; i < 100; i++) {
+        addLine(ring, (uint8_t)(3 * i));
+        ring.commitLine();
+    }
+    windows = sink.windows;
+    CHECK(ring.render(sink, palette) == AREA_ROWS);
+    CHECK(sink.windows - windows == AREA_ROWS);
+    CHECK(frameMatchesHistory(ring, sink));
+
+    // A palette change repaints from history without moving the ring
+    for (int i = 0; i < 256; i++) palette[i] = (uint16_t)(0xF800 | i);
+    uint16_t writeRow = ring.getWriteRow();
+    ring.invalidate();
+    CHECK(ring.render(sink, palette) == AREA_ROWS);
+    CHECK(ring.getWriteRow() == writeRow);
+    CHECK(frameMatchesHistory(ring, sink));
+
+    // An area taller than the history is clamped to it
+    WaterfallRing shallow;
+    CHECK(shallow.allocate(WIDTH, 40, AREA_ROWS));
+    CountingSink other;
+    CHECK(shallow.render(other, palette) == 40);
+    CHECK(!shallow.allocate(0, 40, AREA_ROWS));
+}
+
+int main() {
+    for (int i = 0; i < 256; i++) palette[i] = (uint16_t)(i * 257);
+    testBytesPerLine();
+    testLineRates();
+    testBacklogAndRepaint();
+    return testSummary("test_waterfall_ring");
+}
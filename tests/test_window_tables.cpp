@@ -0,0 +1,139 @@
+// ========================================
+// test_window_tables - Tabulated windows against their closed forms at
+// every size, the polynomial I0, and coherent-gain/ENBW corrections
+// Build on the host (or run tests/run_host_tests.sh):
+//   g++ -O2 -Itests -Iapps/PreqScanner -o test_window_tables
+//       tests/test_window_tables.cpp apps/PreqScanner/WindowTables.cpp
+// ========================================
+
+#include "test_support.h"
+#include "WindowTables.h"
+#include <math.h>
+
+static float window[WINDOW_TABLE_SIZE];
+
+// Power series, converged in double
+static double seriesI0(double x) {
+    double sum = 1.0, term = 1.0;
+    for (int k = 1; k < 200; k++) {
+        term *= (x / (2.0 * k)) * (x / (2.0 * k));
+        sum += term;
+        if (term < sum * 1e-17) break;
+    }
+    return sum;
+}
+
+// Periodic (DFT-even) windows, as the tables were generated
+static double closedForm(WindowShape shape, uint16_t n, uint16_t size, double beta) {
+    double x = 2.0 * M_PI * n / size;
+    switch (shape) {
+        case WINDOW_SHAPE_HAMMING:  return 0.54 - 0.46 * cos(x);
+        case WINDOW_SHAPE_BLACKMAN: return 0.42 - 0.5 * cos(x) + 0.08 * cos(2.0 * x);
+        case WINDOW_SHAPE_HANN:     return 0.5 - 0.5 * cos(x);
+        case WINDOW_SHAPE_KAISER: {
+            double r = 2.0 * n / size - 1.0;
+            return seriesI0(beta * sqrt(1.0 - r * r)) / seriesI0(beta);
+        }
+        default:                    return 1.0;
+    }
+}
+
+static void testShapes() {
+    const WindowShape shapes[] = {WINDOW_SHAPE_RECTANGULAR, WINDOW_SHAPE_HAMMING,
+                                  WINDOW_SHAPE_BLACKMAN, WINDOW_SHAPE_HANN, WINDOW_SHAPE_KAISER};
+    for (uint8_t s = 0; s < 5; s++) {
+        double worst = 0, worstGain = 0, worstEnbw = 0;
+        for (uint16_t size = 2; size <= WINDOW_TABLE_SIZE; size *= 2) {
+            WindowCorrection c;
+            CHECK(buildWindow(shapes[s], size, KAISER_DEFAULT_BETA, 1.0f, window, c));
+
+            double sum = 0, sumSquares = 0;
+            for (uint16_t n = 0; n < size; n++) {
+                double w = closedForm(shapes[s], n, size, KAISER_DEFAULT_BETA);
+                worst = fmax(worst, fabs(window[n] - w));
+                sum += w;
+                sumSquares += w * w;
+            }
+            worstGain = fmax(worstGain, fabs(c.coherentGain - sum / size));
+            worstEnbw = fmax(worstEnbw, fabs(c.enbw - size * sumSquares / (sum * sum)));
+        }
+        CHECK(worst < 2e-7);
+        CHECK(worstGain < 1e-6);
+        CHECK(worstEnbw < 1e-5);
+    }
+
+    // Textbook values for the large-N limit
+    struct { WindowShape shape; double gain, enbw; } known[] = {
+        {WINDOW_SHAPE_RECTANGULAR, 1.0,  1.0},
+        {WINDOW_SHAPE_HAMMING,     0.54, 1.3628},
+        {WINDOW_SHAPE_BLACKMAN,    0.42, 1.7268},
+        {WINDOW_SHAPE_HANN,        0.5,  1.5},
+    };
+    for (uint8_t k = 0; k < 4; k++) {
+        WindowCorrection c;
+        buildWindow(known[k].shape, 1024, 0, 1.0f, window, c);
+        CHECK_NEAR(c.coherentGain, known[k].gain, 1e-4);
+        CHECK_NEAR(c.enbw, known[k].enbw, 1e-3);
+    }
+
+    // Gain scales the samples, not the corrections
+    WindowCorrection plain, scaled;
+    buildWindow(WINDOW_SHAPE_HANN, 256, 0, 1.0f, window, plain);
+    float quarter = window[64];
+    buildWindow(WINDOW_SHAPE_HANN, 256, 0, 3.0f, window, scaled);
+    CHECK_NEAR(window[64], 3.0 * quarter, 1e-6);
+    CHECK(scaled.enbw == plain.enbw && scaled.coherentGain == plain.coherentGain);
+
+    WindowCorrection c;
+    CHECK(!buildWindow(WINDOW_SHAPE_HANN, 384, 0, 1.0f, window, c));
+    CHECK(!buildWindow(WINDOW_SHAPE_HANN, 2048, 0, 1.0f, window, c));
+    CHECK(!buildWindow(WINDOW_SHAPE_HANN, 1, 0, 1.0f, window, c));
+}
+
+static void testKaiser() {
+    // Polynomial I0 over the range the windows use
+    double worst = 0;
+    for (float x = 0.0f; x <= 20.0f; x += 0.01f) {
+        worst = fmax(worst, fabs(besselI0(x) / seriesI0(x) - 1.0));
+    }
+    CHECK(worst < 5e-6);
+    CHECK(besselI0(-2.5f) == besselI0(2.5f));
+
+    // Non-default betas are computed on the fly
+    const float betas[] = {0.0f, 3.0f, 5.0f, 12.0f};
+    for (uint8_t b = 0; b < 4; b++) {
+        WindowCorrection c;
+        CHECK(buildWindow(WINDOW_SHAPE_KAISER, 512, betas[b], 1.0f, window, c));
+        double err = 0;
+        for (uint16_t n = 0; n < 512; n++) {
+            err = fmax(err, fabs(window[n] - closedForm(WINDOW_SHAPE_KAISER, n, 512, betas[b])));
+        }
+        CHECK(err < 1e-5);
+    }
+}
+
+static void testToneCalibration() {
+    // A windowed sine of amplitude A on a bin centre: |X|^2 * toneScale = A^2
+    const WindowShape shapes[] = {WINDOW_SHAPE_RECTANGULAR, WINDOW_SHAPE_HAMMING,
+                                  WINDOW_SHAPE_BLACKMAN, WINDOW_SHAPE_HANN, WINDOW_SHAPE_KAISER};
+    const uint16_t size = 512, bin = 37;
+    const double amplitude = 0.75;
+    for (uint8_t s = 0; s < 5; s++) {
+        WindowCorrection c;
+        buildWindow(shapes[s], size, KAISER_DEFAULT_BETA, 1.0f, window, c);
+        double re = 0, im = 0;
+        for (uint16_t n = 0; n < size; n++) {
+            double x = amplitude * cos(2.0 * M_PI * bin * n / size + 0.4) * window[n];
+            re += x * cos(2.0 * M_PI * bin * n / size);
+            im -= x * sin(2.0 * M_PI * bin * n / size);
+        }
+        CHECK_NEAR((re * re + im * im) * c.toneScale, amplitude * amplitude, 1e-4);
+    }
+}
+
+int main() {
+    testShapes();
+    testKaiser();
+    testToneCalibration();
+    return testSummary("test_window_tables");
+}
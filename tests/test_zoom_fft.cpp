@@ -0,0 +1,128 @@
+// ========================================
+// test_zoom_fft - Tones through the ZoomFFT mixer/decimator land in the
+// right display bin at the decimated bin width; CIC droop correction
+// Build on the host (or run tests/run_host_tests.sh):
+//   g++ -O2 -Itests -Iapps/PreqScanner -o test_zoom_fft
+//       tests/test_zoom_fft.cpp apps/PreqScanner/ZoomFFT.cpp
+//       apps/PreqScanner/DDSGenerator.cpp
+// ========================================
+
+#include "test_support.h"
+#include "ZoomFFT.h"
+#include <math.h>
+#include <vector>
+
+#define RATE        22050
+#define FRAME       256
+
+// Plain DFT of interleaved I/Q, power per FFT index
+static void dftPower(const float* iq, uint16_t n, float* power) {
+    for (uint16_t k = 0; k < n; k++) {
+        double re = 0, im = 0;
+        for (uint16_t t = 0; t < n; t++) {
+            double a = -2.0 * M_PI * k * t / n;
+            double c = cos(a), s = sin(a);
+            re += iq[2 * t] * c - iq[2 * t + 1] * s;
+            im += iq[2 * t] * s + iq[2 * t + 1] * c;
+        }
+        power[k] = (float)(re * re + im * im);
+    }
+}
+
+// Feeds a tone until a fresh frame is ready, then returns display-bin powers
+static std::vector<float> analyse(ZoomFFT& zoom, float toneHz, float amplitude, bool correct) {
+    static float window[FRAME];
+    for (uint16_t n = 0; n < FRAME; n++) window[n] = 0.5f - 0.5f * cosf(2.0f * M_PI * n / FRAME);
+
+    zoom.reset();
+    std::vector<int16_t> input(4096);
+    uint32_t t = 0;
+    // Settle the filters for a frame, then collect a whole new one
+    for (int pass = 0; pass < 2; pass++) {
+        do {
+            for (size_t n = 0; n < input.size(); n++, t++) {
+                input[n] = (int16_t)lrintf(amplitude * sinf(2.0f * M_PI * toneHz * t / RATE));
+            }
+            zoom.process(input.data(), input.size());
+        } while (!zoom.frameReady(FRAME));
+        if (pass == 0) {
+            std::vector<float> discard(2 * FRAME);
+            zoom.readFrame(discard.data(), nullptr, 1.0f);
+        }
+    }
+
+    std::vector<float> iq(2 * FRAME), fft(FRAME);
+    zoom.readFrame(iq.data(), window, 1.0f);
+    dftPower(iq.data(), FRAME, fft.data());
+
+    std::vector<float> display(FRAME / 2);
+    for (uint16_t j = 0; j < FRAME / 2; j++) display[j] = fft[zoom.fftIndex(j)];
+    if (correct) zoom.correctDroop(display.data());
+    return display;
+}
+
+static uint16_t peakBin(const std::vector<float>& power) {
+    uint16_t best = 0;
+    for (uint16_t j = 1; j < power.size(); j++) {
+        if (power[j] > power[best]) best = j;
+    }
+    return best;
+}
+
+static void testBinPlacement() {
+    const uint8_t factors[] = {4, 16, 64};
+    for (uint8_t f = 0; f < 3; f++) {
+        ZoomFFT zoom;
+        CHECK(zoom.configure(RATE, 5000.0f, factors[f], FRAME));
+        CHECK_NEAR(zoom.getBinWidth(), (double)RATE / factors[f] / FRAME, 1e-3);
+        CHECK_NEAR(zoom.getStartFrequency(), 5000.0 - (double)RATE / factors[f] / 4.0, 1e-2);
+
+        // Tones across the displayed span, on bin centres
+        bool placed = true;
+        const int16_t offsets[] = {-60, -17, 0, 5, 33, 61};
+        for (uint8_t k = 0; k < 6; k++) {
+            uint16_t bin = (uint16_t)(FRAME / 4 + offsets[k]);
+            float hz = zoom.getStartFrequency() + bin * zoom.getBinWidth();
+            std::vector<float> p = analyse(zoom, hz, 1000.0f, true);
+            if (peakBin(p) != bin) {
+                placed = false;
+                fprintf(stderr, "  R=%u tone %.2f Hz: bin %u, expected %u\n",
+                        factors[f], hz, peakBin(p), bin);
+            }
+        }
+        CHECK(placed);
+    }
+
+    // Centre frequency is pulled in so the span stays inside 0..Nyquist
+    ZoomFFT zoom;
+    CHECK(zoom.configure(RATE, 10.0f, 4, FRAME));
+    CHECK(zoom.getStartFrequency() >= 0.0f);
+    CHECK(!zoom.configure(RATE, 5000.0f, 12, FRAME));
+    CHECK(!zoom.configure(RATE, 5000.0f, 4, 200));
+}
+
+static void testDroopCorrection() {
+    ZoomFFT zoom;
+    CHECK(zoom.configure(RATE, 5000.0f, 16, FRAME));
+    float centreHz = zoom.getStartFrequency() + (FRAME / 4) * zoom.getBinWidth();
+    float edgeHz = zoom.getStartFrequency() + 4 * zoom.getBinWidth();
+
+    float rawCentre = analyse(zoom, centreHz, 1000.0f, false)[FRAME / 4];
+    float rawEdge = analyse(zoom, edgeHz, 1000.0f, false)[4];
+    float fixedCentre = analyse(zoom, centreHz, 1000.0f, true)[FRAME / 4];
+    float fixedEdge = analyse(zoom, edgeHz, 1000.0f, true)[4];
+
+    double rawDb = 10.0 * log10(rawEdge / rawCentre);
+    double fixedDb = 10.0 * log10(fixedEdge / fixedCentre);
+
+    // CIC R=8, N=3 droops about 0.6 dB this far out; the table undoes it
+    CHECK(rawDb < -0.4);
+    CHECK_NEAR(fixedDb, 0.0, 0.15);
+    printf("  edge vs centre: %.2f dB raw, %.2f dB corrected\n", rawDb, fixedDb);
+}
+
+int main() {
+    testBinPlacement();
+    testDroopCorrection();
+    return testSummary("test_zoom_fft");
+}
@@ -0,0 +1,260 @@
+// ========================================
+// bsl_tool - Host utility for BLEScanner sighting logs (.bsl + .bsd)
+//   bsl_tool info   <log.bsl> [names.bsd]
+//   bsl_tool export <log.bsl> <names.bsd> json|csv [out]   stdout by default
+//   bsl_tool bench  <dir> [sightings] [devices]            synthetic survey
+// Build on the host:
+//   g++ -O2 -Iapps/BLEScanner -o bsl_tool tools/bsl_tool.cpp
+//       apps/BLEScanner/SightingLog.cpp apps/BLEScanner/BLEDeviceTable.cpp
+// ========================================
+
+#ifndef ARDUINO
+
+#include "SightingLog.h"
+#include "BLEDeviceTable.h"
+#include "../core/Streams/HostFileStream.h"
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <chrono>
+#include <string>
+
+static double seconds(std::chrono::steady_clock::time_point since) {
+    return std::chrono::duration<double>(std::chrono::steady_clock::now() - since).count();
+}
+
+static long fileSize(const char* path) {
+    FILE* f = fopen(path, "rb");
+    if (!f) return 0;
+    fseek(f, 0, SEEK_END);
+    long size = ftell(f);
+    fclose(f);
+    return size;
+}
+
+// ===== COMMANDS =====
+
+static int info(const char* logPath, const char* dictPath) {
+    FILE* f = fopen(logPath, "rb");
+    if (!f) { perror(logPath); return 1; }
+    FILE* d = dictPath ? fopen(dictPath, "rb") : nullptr;
+    if (dictPath && !d) { perror(dictPath); fclose(f); return 1; }
+
+    HostFileStream logStream(f);
+    HostFileStream dictStream(d);
+    SightingLogReader reader;
+    if (!reader.open(&logStream, d ? &dictStream : nullptr)) {
+        fprintf(stderr, "%s: cannot read\n", logPath);
+        fclose(f);
+        if (d) fclose(d);
+        return 1;
+    }
+
+    uint32_t records = 0;
+    uint32_t perEvent[SIGHTING_EVENT_COUNT + 1] = {0};
+    uint32_t first = 0, last = 0;
+    SightingLogEntry entry;
+    while (reader.next(entry)) {
+        if (records == 0) first = entry.timestamp;
+        last = entry.timestamp;
+        perEvent[entry.event < SIGHTING_EVENT_COUNT ? entry.event : (uint8_t)SIGHTING_EVENT_COUNT]++;
+        records++;
+    }
+
+    long bytes = fileSize(logPath) + (dictPath ? fileSize(dictPath) : 0);
+    printf("blocks         %u (%u unreadable)\n", reader.getBlockCount(), reader.getSkippedBlocks());
+    printf("records        %u, device clock %u..%u ms\n", records, first, last);
+    for (uint8_t e = 1; e <= SIGHTING_EVENT_COUNT; e++) {
+        if (perEvent[e]) printf("  %-13s %u\n", SightingLogReader::eventName(e), perEvent[e]);
+    }
+    printf("texts          %u\n", reader.getTextCount());
+    printf("bytes/sighting %.1f (log and dictionary)\n", records ? (double)bytes / records : 0.0);
+    fclose(f);
+    if (d) fclose(d);
+    return 0;
+}
+
+static int exportLog(const char* logPath, const char* dictPath, const char* formatName,
+                     const char* outPath) {
+    uint8_t format;
+    if (strcmp(formatName, "json") == 0) format = SIGHTING_EXPORT_JSON;
+    else if (strcmp(formatName, "csv") == 0) format = SIGHTING_EXPORT_CSV;
+    else { fprintf(stderr, "format must be json or csv\n"); return 1; }
+
+    FILE* f = fopen(logPath, "rb");
+    if (!f) { perror(logPath); return 1; }
+    FILE* d = fopen(dictPath, "rb");
+    if (!d) { perror(dictPath); fclose(f); return 1; }
+    FILE* o = outPath ? fopen(outPath, "wb") : stdout;
+    if (!o) { perror(outPath); fclose(f); fclose(d); return 1; }
+
+    HostFileStream logStream(f), dictStream(d), outStream(o);
+    SightingLogReader reader;
+    SightingLogExporter exporter;
+    bool ok = reader.open(&logStream, &dictStream) && exporter.begin(&reader, &outStream, format);
+    while (ok && exporter.next()) {}
+    ok = exporter.end() && ok;
+
+    fclose(f);
+    fclose(d);
+    if (o != stdout) fclose(o);
+    if (!ok) { fprintf(stderr, "%s: export failed\n", logPath); return 1; }
+    fprintf(stderr, "%u records, %u bytes\n", exporter.getRecords(), exporter.getBytes());
+    return 0;
+}
+
+// Deterministic survey: devices advertise in turn, a few share names, some
+// carry labels, and now and then one raises an anomaly
+struct Survey {
+    uint32_t state;
+    uint32_t devices;
+    uint32_t time;
+
+    Survey(uint32_t deviceCount) : state(12345), devices(deviceCount), time(100000) {}
+
+    uint32_t random() {
+        state = state * 1664525u + 1013904223u;
+        return state >> 8;
+    }
+
+    void sighting(uint32_t n, SightingLogEntry& entry, std::string& name, std::string& label) {
+        uint32_t device = random() % devices;
+        time += random() % 40;
+        entry.timestamp = time;
+        entry.mac = 0xC0FFEE000000ull | (uint64_t)device * 2654435761u % 0xFFFFFF;
+        entry.rssi = (int8_t)(-40 - (int)(random() % 55));
+        entry.event = (n < devices) ? SIGHTING_EVENT_NEW_DEVICE : SIGHTING_EVENT_ACTIVE;
+        entry.flags = (uint8_t)(1 | ((device % 3 == 0) ? SIGHTING_FLAG_RANDOMIZED : 0));
+        entry.level = (uint8_t)(device * 37);
+        entry.anomalies = 0;
+        name.clear();
+        label.clear();
+        if (device % 4 != 0) {
+            static const char* models[] = { "Tile", "Galaxy Buds", "JBL Flip 5", "Mi Band" };
+            name = (device % 4 == 1) ? models[device % 16 / 4] : "Device-" + std::to_string(device);
+        }
+        if (device % 10 == 0) label = "Desk " + std::to_string(device / 10);
+        if (random() % 50 == 0) {
+            entry.event = SIGHTING_EVENT_ANOMALY;
+            entry.anomalies = 2;
+            entry.level = 180;
+            name = "Sudden RSSI change";
+            label.clear();
+        }
+    }
+};
+
+static int bench(const char* dir, uint32_t sightings, uint32_t devices) {
+    std::string logPath = std::string(dir) + "/bench.bsl";
+    std::string dictPath = std::string(dir) + "/bench.bsd";
+    FILE* f = fopen(logPath.c_str(), "wb+");
+    FILE* d = fopen(dictPath.c_str(), "wb+");
+    if (!f || !d) { perror(dir); if (f) fclose(f); if (d) fclose(d); return 1; }
+    HostFileStream logStream(f), dictStream(d);
+
+    // Generating alone, timed so it can be taken off the write time; this
+    // pass also sizes the CSV lines the old text log would have appended
+    Survey survey(devices);
+    SightingLogEntry entry;
+    std::string name, label;
+    uint64_t csvBytes = 0;
+    auto start = std::chrono::steady_clock::now();
+    for (uint32_t n = 0; n < sightings; n++) {
+        survey.sighting(n, entry, name, label);
+        csvBytes += name.size() + label.size();
+    }
+    double generating = seconds(start);
+    survey = Survey(devices);
+    for (uint32_t n = 0; n < sightings; n++) {
+        survey.sighting(n, entry, name, label);
+        char mac[BLE_MAC_STRING_LENGTH];
+        BLEDeviceTable::formatMac(entry.mac, mac);
+        csvBytes += snprintf(nullptr, 0, "%u,%s,,,%d,%s,%u\n", entry.timestamp, mac, entry.rssi,
+                             SightingLogReader::eventName(entry.event), entry.anomalies);
+    }
+
+    SightingLogWriter writer;
+    if (!writer.allocate() || !writer.begin(&logStream, &dictStream)) return 1;
+    survey = Survey(devices);
+    start = std::chrono::steady_clock::now();
+    for (uint32_t n = 0; n < sightings; n++) {
+        survey.sighting(n, entry, name, label);
+        uint8_t kind = entry.event == SIGHTING_EVENT_ANOMALY ? SIGHTING_TEXT_NOTE : SIGHTING_TEXT_DEVICE;
+        entry.textId = writer.textId(kind, name.c_str(), label.c_str());
+        writer.append(entry);
+    }
+    writer.end();
+    double writeTime = seconds(start) - generating;
+    const SightingLogStats& stats = writer.getStats();
+
+    // Read back against a regenerated survey
+    SightingLogReader reader;
+    if (!reader.open(&logStream, &dictStream)) return 1;
+    Survey expected(devices);
+    uint32_t mismatches = 0, count = 0;
+    SightingLogEntry read;
+    while (reader.next(read)) {
+        expected.sighting(count, entry, name, label);
+        const SightingText* text = reader.text(read.textId);
+        bool same = read.timestamp == entry.timestamp && read.mac == entry.mac &&
+                    read.rssi == entry.rssi && read.event == entry.event &&
+                    read.flags == entry.flags && read.level == entry.level &&
+                    read.anomalies == entry.anomalies &&
+                    (text ? name == text->name && label == text->label : name.empty() && label.empty());
+        if (!same) mismatches++;
+        count++;
+    }
+
+    // Stream both exports through a null sink
+    FILE* sink = fopen("/dev/null", "wb");
+    HostFileStream sinkStream(sink);
+    double exportTime[2];
+    uint32_t exportBytes[2];
+    for (uint8_t format = 0; format < 2; format++) {
+        reader.seekBlock(0);
+        SightingLogExporter exporter;
+        auto began = std::chrono::steady_clock::now();
+        exporter.begin(&reader, &sinkStream, format);
+        while (exporter.next()) {}
+        exporter.end();
+        exportTime[format] = seconds(began);
+        exportBytes[format] = exporter.getBytes();
+    }
+    fclose(sink);
+    fclose(f);
+    fclose(d);
+
+    double binary = (double)stats.dataBytes + stats.dictionaryBytes;
+    printf("sightings      %u from %u devices, %u texts (%u dropped)\n",
+           stats.records, devices, stats.texts, stats.textsDropped);
+    printf("log            %u bytes in %u blocks (%u closed early), %u writes\n",
+           stats.dataBytes, stats.blocks, stats.blocksClosedEarly, stats.flushes);
+    printf("dictionary     %u bytes\n", stats.dictionaryBytes);
+    printf("bytes/sighting %.2f binary, %.2f as CSV text\n",
+           binary / stats.records, (double)csvBytes / stats.records);
+    printf("write          %.0f sightings/s\n", stats.records / writeTime);
+    printf("read back      %u records, %u mismatches\n", count, mismatches);
+    printf("export json    %.0f records/s, %.1f bytes/record\n",
+           count / exportTime[SIGHTING_EXPORT_JSON], (double)exportBytes[SIGHTING_EXPORT_JSON] / count);
+    printf("export csv     %.0f records/s, %.1f bytes/record\n",
+           count / exportTime[SIGHTING_EXPORT_CSV], (double)exportBytes[SIGHTING_EXPORT_CSV] / count);
+    return mismatches == 0 && count == stats.records ? 0 : 1;
+}
+
+int main(int argc, char** argv) {
+    if (argc >= 3 && strcmp(argv[1], "info") == 0) return info(argv[2], argc >= 4 ? argv[3] : nullptr);
+    if (argc >= 5 && strcmp(argv[1], "export") == 0) {
+        return exportLog(argv[2], argv[3], argv[4], argc >= 6 ? argv[5] : nullptr);
+    }
+    if (argc >= 3 && strcmp(argv[1], "bench") == 0) {
+        return bench(argv[2], argc >= 4 ? (uint32_t)atoi(argv[3]) : 1000000,
+                     argc >= 5 ? (uint32_t)atoi(argv[4]) : 500);
+    }
+
+    fprintf(stderr, "usage: %s info <log.bsl> [names.bsd]\n"
+                    "       %s export <log.bsl> <names.bsd> json|csv [out]\n"
+                    "       %s bench <dir> [sightings] [devices]\n", argv[0], argv[0], argv[0]);
+    return 2;
+}
+
+#endif // ARDUINO
@@ -0,0 +1,194 @@
+// ========================================
+// fsr_tool - Host utility for FreqScanner recordings (.fsr)
+//   fsr_tool info   <file.fsr>
+//   fsr_tool render <file.fsr> <out.pgm>    spectrogram, one row per frame
+//   fsr_tool bench  <out.fsr> [seconds]     writer throughput with synthetic data
+// Build on the host:
+//   g++ -O2 -Iapps/PreqScanner -o fsr_tool tools/fsr_tool.cpp
+//       apps/PreqScanner/RecordingFormat.cpp apps/PreqScanner/WindowTables.cpp
+// ========================================
+
+#ifndef ARDUINO
+
+#include "RecordingFormat.h"
+#include "WindowTables.h"
+#include "../core/Streams/HostFileStream.h"
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <math.h>
+#include <chrono>
+#include <complex>
+#include <vector>
+
+// ===== FFT =====
+
+static void fft(std::vector<std::complex<float>>& x) {
+    size_t n = x.size();
+    for (size_t i = 1, j = 0; i < n; i++) {
+        size_t bit = n >> 1;
+        for (; j & bit; bit >>= 1) j ^= bit;
+        j ^= bit;
+        if (i < j) std::swap(x[i], x[j]);
+    }
+    for (size_t len = 2; len <= n; len <<= 1) {
+        float angle = -2.0f * (float)M_PI / len;
+        std::complex<float> step(cosf(angle), sinf(angle));
+        for (size_t i = 0; i < n; i += len) {
+            std::complex<float> w(1, 0);
+            for (size_t k = 0; k < len / 2; k++) {
+                std::complex<float> u = x[i + k], v = x[i + k + len / 2] * w;
+                x[i + k] = u + v;
+                x[i + k + len / 2] = u - v;
+                w *= step;
+            }
+        }
+    }
+}
+
+// ===== COMMANDS =====
+
+static int info(const char* path) {
+    FILE* f = fopen(path, "rb");
+    if (!f) { perror(path); return 1; }
+    HostFileStream stream(f);
+    RecordingReader reader;
+    if (!reader.open(&stream)) { fprintf(stderr, "%s: not a recording\n", path); fclose(f); return 1; }
+
+    const RecordingHeader& h = reader.getHeader();
+    printf("version        %u\n", h.version);
+    printf("sample rate    %u Hz\n", h.sampleRate);
+    printf("fft size       %u (%u bins, %.3f Hz/bin from %.1f Hz)\n",
+           h.fftSize, h.spectrumBins, h.binWidth, h.startFrequency);
+    printf("contents       %s%s\n", (h.contents & RECORDING_HAS_TIME) ? "time " : "",
+           (h.contents & RECORDING_HAS_SPECTRUM) ? "spectrum" : "");
+    printf("zoom           %s\n", h.zoomDecimation ? "yes" : "no");
+    printf("duration       %u ms\n", h.durationMs);
+    printf("chunks         %u, %u samples\n", h.chunkCount, h.sampleCount);
+    printf("index          %s (%u entries)\n", reader.hasIndex() ? "yes" : "no, file not closed",
+           h.indexEntries);
+    fclose(f);
+    return 0;
+}
+
+static int render(const char* path, const char* outPath) {
+    FILE* f = fopen(path, "rb");
+    if (!f) { perror(path); return 1; }
+    HostFileStream stream(f);
+    RecordingReader reader;
+    if (!reader.open(&stream)) { fprintf(stderr, "%s: not a recording\n", path); fclose(f); return 1; }
+
+    const RecordingHeader& h = reader.getHeader();
+    uint16_t bins = h.spectrumBins ? h.spectrumBins : h.fftSize / 2;
+    std::vector<uint8_t> image;
+    std::vector<float> db(bins);
+    uint32_t rows = 0;
+
+    if (h.contents & RECORDING_HAS_SPECTRUM) {
+        uint32_t timestamp;
+        while (reader.readSpectrum(db.data(), bins, timestamp)) {
+            for (uint16_t i = 0; i < bins; i++) {
+                image.push_back(RecordingWriter::quantizeDb(db[i], h.dbMin, h.dbStep));
+            }
+            rows++;
+        }
+    } else {
+        // Time-only recording: Hann frames without overlap, levels in dB re 1 V peak
+        uint16_t n = h.fftSize;
+        std::vector<float> window(n);
+        std::vector<int16_t> samples(n);
+        std::vector<std::complex<float>> frame(n);
+        WindowCorrection correction;
+        if (!buildWindow(WINDOW_SHAPE_HANN, n, KAISER_DEFAULT_BETA, h.voltsPerCount, window.data(), correction)) {
+            fprintf(stderr, "unsupported fft size %u\n", n);
+            fclose(f);
+            return 1;
+        }
+        float offset = 10.0f * log10f(correction.toneScale);
+        while (reader.readSamples(samples.data(), n) == n) {
+            for (uint16_t i = 0; i < n; i++) frame[i] = std::complex<float>(samples[i] * window[i], 0);
+            fft(frame);
+            for (uint16_t i = 0; i < bins; i++) {
+                float power = std::norm(frame[i]);
+                float level = power > 0 ? 10.0f * log10f(power) + offset : h.dbMin;
+                image.push_back(RecordingWriter::quantizeDb(level, h.dbMin, h.dbStep));
+            }
+            rows++;
+        }
+    }
+    fclose(f);
+
+    if (rows == 0) { fprintf(stderr, "%s: nothing to render\n", path); return 1; }
+    FILE* out = fopen(outPath, "wb");
+    if (!out) { perror(outPath); return 1; }
+    fprintf(out, "P5\n%u %u\n255\n", bins, rows);
+    fwrite(image.data(), 1, image.size(), out);
+    fclose(out);
+    printf("%s: %u x %u, %.1f to %.1f dB\n", outPath, bins, rows, h.dbMin, h.dbMin + 255 * h.dbStep);
+    return 0;
+}
+
+static int bench(const char* path, float seconds) {
+    FILE* f = fopen(path, "wb+");
+    if (!f) { perror(path); return 1; }
+    HostFileStream stream(f);
+    RecordingWriter writer;
+    if (!writer.allocate()) { fprintf(stderr, "allocation failed\n"); fclose(f); return 1; }
+
+    // Same shape as a device recording: 512-point frames with 50% overlap
+    const uint32_t rate = 22050;
+    const uint16_t size = 512, hop = 256, bins = size / 2;
+    RecordingHeader header = RecordingWriter::defaultHeader();
+    header.sampleRate = rate;
+    header.fftSize = size;
+    header.contents = RECORDING_HAS_TIME | RECORDING_HAS_SPECTRUM;
+    header.binWidth = (float)rate / size;
+    header.voltsPerCount = 3.3f / 4095.0f;
+    header.spectrumBins = bins;
+
+    std::vector<int16_t> samples(hop);
+    std::vector<float> spectrum(bins);
+    uint32_t frames = (uint32_t)(seconds * rate / hop);
+    uint32_t seed = 1;
+    double phase = 0;
+
+    auto start = std::chrono::steady_clock::now();
+    writer.begin(&stream, header);
+    for (uint32_t frame = 0; frame < frames; frame++) {
+        for (uint16_t i = 0; i < hop; i++) {
+            seed = seed * 1664525u + 1013904223u;
+            phase += 2 * M_PI * 1000.0 / rate;
+            samples[i] = (int16_t)(800 * sin(phase)) + (int16_t)((seed >> 24) - 128);
+        }
+        for (uint16_t i = 0; i < bins; i++) spectrum[i] = -90.0f + (i == 23 ? 70.0f : (float)(seed >> (i & 15) & 7));
+        uint32_t timestamp = (uint32_t)((uint64_t)frame * hop * 1000 / rate);
+        writer.writeTime(samples.data(), hop, timestamp);
+        writer.writeSpectrum(spectrum.data(), bins, timestamp);
+    }
+    bool ok = writer.end();
+    fflush(f);
+    double elapsed = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+    fclose(f);
+
+    if (!ok) { fprintf(stderr, "write failed\n"); return 1; }
+    double mb = writer.getBytesWritten() / 1048576.0;
+    double recorded = (double)frames * hop / rate;
+    printf("%u frames, %.1f s of signal, %.2f MB in %u writes\n",
+           frames, recorded, mb, writer.getFlushCount());
+    printf("%.3f s: %.1f MB/s, %.0fx real time (stream needs %.1f KB/s)\n",
+           elapsed, mb / elapsed, recorded / elapsed, mb * 1024 / recorded);
+    return 0;
+}
+
+int main(int argc, char** argv) {
+    if (argc >= 3 && strcmp(argv[1], "info") == 0) return info(argv[2]);
+    if (argc >= 4 && strcmp(argv[1], "render") == 0) return render(argv[2], argv[3]);
+    if (argc >= 3 && strcmp(argv[1], "bench") == 0) return bench(argv[2], argc >= 4 ? (float)atof(argv[3]) : 60.0f);
+
+    fprintf(stderr, "usage: %s info <file.fsr>\n"
+                    "       %s render <file.fsr> <out.pgm>\n"
+                    "       %s bench <out.fsr> [seconds]\n", argv[0], argv[0], argv[0]);
+    return 2;
+}
+
+#endif // ARDUINO